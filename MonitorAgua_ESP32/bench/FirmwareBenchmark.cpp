@@ -0,0 +1,292 @@
+/**
+ * @file FirmwareBenchmark.cpp
+ * @brief Casos de microbenchmark de los kernels calientes del firmware.
+ * @details Los usan bench/main.cpp (JSON para bench_compare.py y perf_budget.py) y
+ *          las pruebas de presupuesto de test/ (test_perf_budgets), que compilan
+ *          este archivo dentro de la suite: un caso nuevo queda presupuestable en
+ *          ambos lados con solo registrarlo aquí.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <Arduino.h>
+#include "FirmwareBenchmark.h"
+#include "Benchmark.h"
+#include "RTCMemory.h"
+#include "WifiManager.h"
+#include "CalibrationManager.h"
+#include "pH.h"
+#include "TDS.h"
+#include "Turbidez.h"
+#include "RingBuffer.h"
+#include "SpscQueue.h"
+
+// Kernels internos de los sensores (definidos en sus .cpp, sin declaración pública)
+namespace pHSensor {
+    double averageArray(int* arr, int number);
+}
+namespace TDSSensor {
+    float compensateTemperature(float voltage, float temperature);
+    float calculateECRaw(float compensatedVoltage);
+}
+
+// ——— Datos de entrada ———
+
+#define BENCH_INPUTS 64  // Potencia de 2: el índice se enmascara
+
+static float voltages[BENCH_INPUTS];       ///< 0.05-2.4 V, pseudoaleatorios
+static float temperatures[BENCH_INPUTS];   ///< 15-30 °C
+static int phRaw[PH_ARRAY_LENGTH];         ///< Muestras crudas de 12 bits
+
+static RTCMemoryManager rtcMemory(false);
+static WiFiManager wifiManager(false);
+static CalibrationManager calibrationManager(false);
+static RTCMemoryManager::SensorReading recentBuffer[RTCMemoryManager::MAX_READINGS];
+
+static RingBuffer<uint32_t, 160> ring160;  ///< Capacidad de RTCMemory: envoltura por resta
+static RingBuffer<uint32_t, 128> ring128;  ///< Potencia de 2: envoltura por máscara
+static SpscQueue<uint32_t, 64> spscQueue;
+
+static const char CMD_GET[] = "{\"action\":\"get_calibration\"}";
+static const char CMD_CALIBRATE[] =
+    "{\"action\":\"calibrate\",\"ph_offset\":1.33,\"ph_slope\":3.5,\"tds_kvalue\":1.6}";
+
+/**
+ * @brief Generador congruencial para entradas reproducibles
+ */
+static uint32_t lcg(uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static void prepareInputs() {
+    uint32_t seed = 0x5EED1234u;
+    for (int i = 0; i < BENCH_INPUTS; i++) {
+        voltages[i] = 0.05f + (lcg(seed) % 2350) / 1000.0f;
+        temperatures[i] = 15.0f + (lcg(seed) % 1500) / 100.0f;
+    }
+    for (int i = 0; i < PH_ARRAY_LENGTH; i++) {
+        phRaw[i] = 1800 + (int)(lcg(seed) % 200);
+    }
+}
+
+/**
+ * @class FirmwareBenchmark
+ * @brief Casos de la suite; amigo de los gestores para medir sus kernels privados
+ */
+class FirmwareBenchmark {
+public:
+    static void registerAll() {
+        Benchmark::add("rtcmem/storeReading", storeReading);
+        Benchmark::add("rtcmem/validateIntegrity", validateIntegrity);
+        Benchmark::add("rtcmem/getRecentReadings/10", getRecent10);
+        Benchmark::add("rtcmem/getRecentReadings/160", getRecentAll);
+        Benchmark::add("rtcmem/calculateCRC32/store", crcStore);
+        Benchmark::add("wifi/createDataJSON", createDataJSON);
+        Benchmark::add("ph/averageArray", averageArray);
+        Benchmark::add("turb/voltageToNTU/segmented", ntuSegmented);
+        Benchmark::add("turb/voltageToNTU/cubic", ntuCubic);
+        Benchmark::add("tds/compensateTemperature", tdsCompensate);
+        Benchmark::add("tds/calculateECRaw", tdsCubic);
+        Benchmark::add("tds/baseTDSFromVoltage", tdsBase);
+        Benchmark::add("calib/processCommand/get_calibration", calibGet);
+        Benchmark::add("calib/processCommand/calibrate_unchanged", calibCalibrate);
+        Benchmark::add("containers/RingBuffer/push/160", ringPush160);
+        Benchmark::add("containers/RingBuffer/push/128", ringPush128);
+        Benchmark::add("containers/RingBuffer/recent/160", ringRecent160);
+        Benchmark::add("containers/SpscQueue/push_pop", spscPushPop);
+    }
+
+    /**
+     * @brief Memoria RTC llena: los casos miden el estado estacionario del anillo
+     */
+    static void setup() {
+        prepareInputs();
+        rtcMemory.begin();
+        rtcMemory.initialize();
+        for (int i = 0; i < RTCMemoryManager::MAX_READINGS; i++) {
+            rtcMemory.storeReading(reading(i));
+        }
+        calibrationManager.begin();
+        ring160.clear();
+        ring128.clear();
+        for (uint32_t i = 0; i < 160; i++) {
+            ring160.push(i);
+            ring128.push(i);
+        }
+    }
+
+private:
+    static RTCMemoryManager::SensorReading reading(uint32_t i) {
+        uint32_t k = i & (BENCH_INPUTS - 1);
+        return rtcMemory.createFullReading(temperatures[k], 7.0f + voltages[k] / 10.0f,
+                                           voltages[k] * 100.0f, voltages[k] * 400.0f,
+                                           voltages[k] * 800.0f, 0);
+    }
+
+    // ——— RTCMemory ———
+
+    static void storeReading(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            Benchmark::doNotOptimize(rtcMemory.storeReading(reading(i)));
+        }
+    }
+
+    static void validateIntegrity(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            Benchmark::doNotOptimize(rtcMemory.validateIntegrity());
+        }
+    }
+
+    static void getRecent10(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            Benchmark::doNotOptimize(rtcMemory.getRecentReadings(recentBuffer, 10));
+            Benchmark::clobberMemory();
+        }
+    }
+
+    static void getRecentAll(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            Benchmark::doNotOptimize(rtcMemory.getRecentReadings(recentBuffer, RTCMemoryManager::MAX_READINGS));
+            Benchmark::clobberMemory();
+        }
+    }
+
+    static void crcStore(uint32_t n) {
+        extern RTCMemoryManager::RTCDataStructure rtc_data;
+        for (uint32_t i = 0; i < n; i++) {
+            Benchmark::doNotOptimize(rtcMemory.calculateCRC32(&rtc_data, sizeof(rtc_data)));
+        }
+    }
+
+    // ——— WiFiManager ———
+
+    static void createDataJSON(uint32_t n) {
+        RTCMemoryManager::SensorReading r = reading(7);
+        r.rtc_timestamp = 1759320000u;  // Con fecha: incluye el formateo de rtc_datetime
+        char json[WIFI_TX_BUFFER_LEN];
+        for (uint32_t i = 0; i < n; i++) {
+            Benchmark::doNotOptimize(wifiManager.createDataJSON(r, json, sizeof(json)));
+        }
+    }
+
+    // ——— Sensores ———
+
+    static void averageArray(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            Benchmark::doNotOptimize(pHSensor::averageArray(phRaw, PH_ARRAY_LENGTH));
+            Benchmark::clobberMemory();
+        }
+    }
+
+    static void ntuSegmented(uint32_t n) {
+        TurbiditySensor::setPolynomialModel(false);
+        for (uint32_t i = 0; i < n; i++) {
+            Benchmark::doNotOptimize(TurbiditySensor::voltageToNTU(voltages[i & (BENCH_INPUTS - 1)]));
+        }
+    }
+
+    static void ntuCubic(uint32_t n) {
+        TurbiditySensor::setPolynomialModel(true);
+        for (uint32_t i = 0; i < n; i++) {
+            Benchmark::doNotOptimize(TurbiditySensor::voltageToNTU(voltages[i & (BENCH_INPUTS - 1)]));
+        }
+        TurbiditySensor::setPolynomialModel(false);
+    }
+
+    static void tdsCompensate(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t k = i & (BENCH_INPUTS - 1);
+            Benchmark::doNotOptimize(TDSSensor::compensateTemperature(voltages[k], temperatures[k]));
+        }
+    }
+
+    static void tdsCubic(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            Benchmark::doNotOptimize(TDSSensor::calculateECRaw(voltages[i & (BENCH_INPUTS - 1)]));
+        }
+    }
+
+    static void tdsBase(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t k = i & (BENCH_INPUTS - 1);
+            Benchmark::doNotOptimize(TDSSensor::baseTDSFromVoltage(voltages[k], 0.0f, temperatures[k]));
+        }
+    }
+
+    // ——— CalibrationManager ———
+
+    /**
+     * @brief processCalibrationCommand() analiza en el buffer: se restaura en cada iteración
+     * @note Incluye la copia del comando (memcpy de < 100 bytes).
+     */
+    static void runCommand(const char* command, size_t length, uint32_t n) {
+        char buffer[128];
+        for (uint32_t i = 0; i < n; i++) {
+            memcpy(buffer, command, length + 1);
+            Benchmark::doNotOptimize(calibrationManager.processCalibrationCommand(buffer, length));
+        }
+    }
+
+    static void calibGet(uint32_t n) {
+        runCommand(CMD_GET, sizeof(CMD_GET) - 1, n);
+    }
+
+    static void calibCalibrate(uint32_t n) {
+        runCommand(CMD_CALIBRATE, sizeof(CMD_CALIBRATE) - 1, n);
+    }
+
+    // ——— Containers ———
+
+    static void ringPush160(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            ring160.push(i);
+            Benchmark::clobberMemory();
+        }
+    }
+
+    static void ringPush128(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            ring128.push(i);
+            Benchmark::clobberMemory();
+        }
+    }
+
+    /**
+     * @brief Recorrido de las 160 posiciones del más reciente al más antiguo
+     */
+    static void ringRecent160(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t sum = 0;
+            for (size_t k = 0; k < ring160.size(); k++) sum += ring160.recent(k);
+            Benchmark::doNotOptimize(sum);
+        }
+    }
+
+    /**
+     * @brief Un elemento de ida y vuelta por iteración (un solo hilo: sin contención)
+     */
+    static void spscPushPop(uint32_t n) {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            spscQueue.push(i);
+            spscQueue.pop(value);
+            Benchmark::doNotOptimize(value);
+        }
+    }
+};
+
+// ——— Interfaz ———
+
+namespace FirmwareBench {
+
+    void setup() {
+        FirmwareBenchmark::setup();
+    }
+
+    void registerAll() {
+        FirmwareBenchmark::registerAll();
+    }
+
+} // namespace FirmwareBench
@@ -0,0 +1,27 @@
+/**
+ * @file FirmwareBenchmark.h
+ * @brief Registro de los casos de microbenchmark del firmware (FirmwareBenchmark.cpp).
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef FIRMWARE_BENCHMARK_H
+#define FIRMWARE_BENCHMARK_H
+
+namespace FirmwareBench {
+
+    /**
+     * @brief Prepara entradas reproducibles y el estado estacionario de los gestores
+     * @details Memoria RTC llena, calibración cargada y anillos de Containers llenos.
+     */
+    void setup();
+
+    /**
+     * @brief Registra todos los casos en Benchmark
+     */
+    void registerAll();
+
+} // namespace FirmwareBench
+
+#endif // FIRMWARE_BENCHMARK_H
@@ -0,0 +1,50 @@
+/**
+ * @file main.cpp
+ * @brief Suite de microbenchmarks de los kernels calientes del firmware.
+ * @details Reemplaza a src/main.cpp en los entornos `bench` (ESP32-S2, ciclos de
+ *          CPU) y `native_bench` (Linux, ns reales). Escribe un JSON con el
+ *          esquema de Google Benchmark; guardar la salida de cada commit y
+ *          compararlas con tools/bench_compare.py:
+ *
+ *              pio run -e native_bench
+ *              .pio/build/native_bench/program > bench_base.json
+ *              (cambiar el código, repetir en bench_new.json)
+ *              python tools/bench_compare.py bench_base.json bench_new.json
+ *
+ *          En el equipo el JSON sale por el puerto serie tras el arranque.
+ *          Un argumento (native) filtra casos por subcadena del nombre.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <Arduino.h>
+#include "Benchmark.h"
+#include "FirmwareBenchmark.h"
+
+// ——— Punto de entrada ———
+
+#ifdef HAL_NATIVE
+
+int main(int argc, char** argv) {
+    FirmwareBench::setup();
+    FirmwareBench::registerAll();
+    return Benchmark::runAll(argc > 1 ? argv[1] : nullptr) > 0 ? 0 : 1;
+}
+
+#else
+
+void setup() {
+    Serial.begin(115200);
+    delay(2000);  // Tiempo para abrir el monitor serie
+
+    FirmwareBench::setup();
+    FirmwareBench::registerAll();
+    Benchmark::runAll();
+}
+
+void loop() {
+    delay(1000);
+}
+
+#endif
@@ -0,0 +1,507 @@
+/**
+ * @file main.cpp
+ * @brief Decodificador en el anfitrión de volcados de RTC Memory y trazas subidas.
+ * @details Se compila con los mismos encabezados que el firmware, así que las
+ *          estructuras (RTCDataStructure, ErrorEntry, CalibrationData, registros de
+ *          Trace.h) nunca se desincronizan del código que las escribe.
+ *
+ *          Entradas (se detectan por contenido, se pueden mezclar):
+ *          - Volcado de la RAM persistente. En el equipo, la RTC slow memory del
+ *            ESP32-S2 leída por el bootloader de ROM:
+ *                esptool.py --chip esp32s2 --before default_reset --after no_reset \
+ *                    dump_mem 0x50000000 8192 rtc.bin
+ *            Con --symbols (salida de `nm` del mismo firmware.elf) cada estructura se
+ *            lee en su dirección; sin símbolos se buscan RTCDataStructure por sus
+ *            marcas mágicas y CalibrationData por su CRC, y el resto se omite.
+ *          - Trazas de sensores (traces/<equipo>.trace de servidor.py, ver Trace.h).
+ *
+ *          Salida: una tabla CSV por tipo de registro en --out (cabecera fija, un
+ *          valor escalar por columna; se carga directo en pandas, DuckDB o pyarrow
+ *          para pasarla a Parquet). blocks.csv informa la validación de cada bloque
+ *          (marcas, CRC, índices) y las tablas solo reciben bloques que la pasan,
+ *          salvo con --keep-invalid.
+ *
+ *              pio run -e decoder
+ *              xtensa-esp32s2-elf-nm .pio/build/esp32-s2-kaluga-1/firmware.elf > nm.txt
+ *              .pio/build/decoder/program --symbols nm.txt --out volcado/ rtc.bin
+ *              .pio/build/decoder/program --out trazas/ traces/ESP32_WaterMonitor.trace
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <Arduino.h>
+#include "RTCMemory.h"
+#include "WatchDogManager.h"
+#include "CalibrationManager.h"
+#include "Trace.h"
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <map>
+
+// ——— Configuración ———
+
+#define DECODER_DEFAULT_BASE   0x50000000UL  // RTC slow memory del ESP32-S2 (RTC_DATA_ATTR)
+#define DECODER_IO_BUFFER      (1 << 20)     // Búfer de cada tabla de salida
+
+typedef RTCMemoryManager::RTCDataStructure RTCData;
+typedef RTCMemoryManager::SensorReading SensorReading;
+typedef WatchdogManager::ErrorEntry ErrorEntry;
+typedef CalibrationManager::CalibrationData CalibrationData;
+typedef StaticVector<CalibrationManager::CalibrationPoint, CalibrationManager::MAX_CALIBRATION_POINTS> PointList;
+
+// ——— Tablas de salida ———
+
+/**
+ * @brief Archivo CSV que se crea con su cabecera al escribir la primera fila
+ */
+class Table {
+public:
+    Table(const char* name, const char* header) : _name(name), _header(header) {}
+
+    ~Table() {
+        if (_file) fclose(_file);
+    }
+
+    FILE* row() {
+        if (!_file) {
+            std::string path = outputDir + "/" + _name + ".csv";
+            _file = fopen(path.c_str(), "w");
+            if (!_file) {
+                perror(path.c_str());
+                exit(1);
+            }
+            setvbuf(_file, nullptr, _IOFBF, DECODER_IO_BUFFER);
+            fprintf(_file, "%s\n", _header);
+        }
+        _rows++;
+        return _file;
+    }
+
+    unsigned long rows() const { return _rows; }
+    const char* name() const { return _name; }
+
+    static std::string outputDir;
+
+private:
+    const char* _name;
+    const char* _header;
+    FILE* _file = nullptr;
+    unsigned long _rows = 0;
+};
+
+std::string Table::outputDir = ".";
+
+static Table blocks("blocks", "source,block,offset,size,status,stored_crc,computed_crc");
+static Table state("state", "source,sequence_number,boot_timestamp,total_readings,health_score,"
+                            "consecutive_failures,last_successful_operation,total_errors");
+static Table readings("readings", "source,slot,reading_number,timestamp_ms,rtc_timestamp,temperature,"
+                                  "ph,turbidity,tds,ec,sensor_status,valid,alarms");
+static Table errors("errors", "source,table,slot,error_code,error_name,severity,timestamp_min,context");
+static Table calibration("calibration", "source,offset,ph_offset,ph_slope,tds_kvalue,tds_voffset,turb_a,"
+                                        "turb_b,turb_c,turb_d,turb_model,last_update,update_count");
+static Table points("calibration_points", "source,sensor,index,voltage,reference,temperature");
+static Table samples("samples", "source,tag,record,type,channel,mark,value");
+
+static Table* const TABLES[] = {&blocks, &state, &readings, &errors, &calibration, &points, &samples};
+
+static bool keepInvalid = false;
+static unsigned long blocksFailed = 0;
+
+// ——— Utilidades ———
+
+static uint32_t crc32(const void* data, size_t length) {
+    return HAL::crc32(0xFFFFFFFF, (const uint8_t*)data, length) ^ 0xFFFFFFFF;
+}
+
+/**
+ * @brief Anota la validación de un bloque
+ * @return true si el bloque debe decodificarse
+ */
+static bool reportBlock(const char* source, const char* block, size_t offset, size_t size,
+                        const char* status, bool hasCrc = false, uint32_t stored = 0, uint32_t computed = 0) {
+    FILE* f = blocks.row();
+    fprintf(f, "%s,%s,%zu,%zu,%s,", source, block, offset, size, status);
+    if (hasCrc) fprintf(f, "0x%08X,0x%08X\n", (unsigned)stored, (unsigned)computed);
+    else fprintf(f, ",\n");
+
+    bool ok = strcmp(status, "ok") == 0;
+    if (!ok) blocksFailed++;
+    return ok || keepInvalid;
+}
+
+static const char* errorName(uint8_t code) {
+    switch ((WatchdogManager::error_code_t)code) {
+        case WatchdogManager::ERROR_NONE:                   return "NONE";
+        case WatchdogManager::ERROR_SENSOR_TIMEOUT:         return "SENSOR_TIMEOUT";
+        case WatchdogManager::ERROR_SENSOR_INVALID_READING: return "SENSOR_INVALID_READING";
+        case WatchdogManager::ERROR_RTC_CORRUPTION:         return "RTC_CORRUPTION";
+        case WatchdogManager::ERROR_RTC_WRITE_FAIL:         return "RTC_WRITE_FAIL";
+        case WatchdogManager::ERROR_MEMORY_FULL:            return "MEMORY_FULL";
+        case WatchdogManager::ERROR_WDT_TIMEOUT:            return "WDT_TIMEOUT";
+        case WatchdogManager::ERROR_SYSTEM_PANIC:           return "SYSTEM_PANIC";
+        case WatchdogManager::ERROR_CRC_MISMATCH:           return "CRC_MISMATCH";
+        case WatchdogManager::ERROR_WIFI_FAIL:              return "WIFI_FAIL";
+        case WatchdogManager::ERROR_SENSOR_INIT_FAIL:       return "SENSOR_INIT_FAIL";
+        case WatchdogManager::ERROR_MEMORY_LOW:             return "MEMORY_LOW";
+        case WatchdogManager::ERROR_TIMING_ISSUE:           return "TIMING_ISSUE";
+    }
+    return "UNKNOWN";
+}
+
+static bool readFile(const char* path, std::vector<uint8_t>& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    out.resize(size > 0 ? (size_t)size : 0);
+    bool ok = out.empty() || fread(out.data(), out.size(), 1, f) == 1;
+    fclose(f);
+    if (!ok) fprintf(stderr, "%s: error de lectura\n", path);
+    return ok;
+}
+
+// ——— Símbolos ———
+
+/**
+ * @brief Direcciones de las variables persistentes (salida de nm)
+ */
+class SymbolMap {
+public:
+    bool load(const char* path) {
+        FILE* f = fopen(path, "r");
+        if (!f) {
+            perror(path);
+            return false;
+        }
+        char line[512];
+        while (fgets(line, sizeof(line), f)) {
+            // "<dirección> [<tamaño>] <tipo> <nombre>"
+            char* end = nullptr;
+            unsigned long long address = strtoull(line, &end, 16);
+            if (end == line) continue;
+            char* name = strrchr(line, ' ');
+            if (!name) continue;
+            name++;
+            name[strcspn(name, "\r\n")] = '\0';
+            _symbols[name] = address;
+        }
+        fclose(f);
+        return true;
+    }
+
+    bool empty() const { return _symbols.empty(); }
+
+    bool find(const char* name, unsigned long long& address) const {
+        auto it = _symbols.find(name);
+        if (it == _symbols.end()) return false;
+        address = it->second;
+        return true;
+    }
+
+private:
+    std::map<std::string, unsigned long long> _symbols;
+};
+
+static SymbolMap symbols;
+static unsigned long long baseAddress = 0;
+static bool baseGiven = false;
+
+/**
+ * @brief Copia una variable del volcado por su símbolo
+ * @return false si el símbolo no existe o queda fuera del volcado (se anota)
+ */
+template <typename T>
+static bool locate(const char* source, const std::vector<uint8_t>& dump, const char* symbol,
+                   T& out, size_t& offset) {
+    unsigned long long address;
+    if (!symbols.find(symbol, address)) return false;
+    if (address < baseAddress || address - baseAddress + sizeof(T) > dump.size()) {
+        reportBlock(source, symbol, (size_t)(address - baseAddress), sizeof(T), "fuera_del_volcado");
+        return false;
+    }
+    offset = (size_t)(address - baseAddress);
+    memcpy((void*)&out, dump.data() + offset, sizeof(T));
+    return true;
+}
+
+// ——— Volcado de RAM persistente ———
+
+static void decodeRTCData(const char* source, const RTCData& data, size_t offset) {
+    bool magicOk = data.magic_start == 0x12345678UL && data.magic_end == 0x87654321UL;
+    uint32_t headerCrc = crc32((const uint8_t*)&data + offsetof(RTCData, sequence_number), sizeof(uint32_t) * 2);
+    uint32_t dataCrc = crc32((const uint8_t*)&data + offsetof(RTCData, readings), sizeof(data.readings));
+
+    reportBlock(source, "rtc_data.header", offset, offsetof(RTCData, readings),
+                !magicOk ? "magic" : (headerCrc != data.header_crc ? "crc" : "ok"),
+                true, data.header_crc, headerCrc);
+    bool decode = reportBlock(source, "rtc_data.readings", offset + offsetof(RTCData, readings),
+                              sizeof(data.readings),
+                              !data.readings.isValid() ? "rango" : (dataCrc != data.data_crc ? "crc" : "ok"),
+                              true, data.data_crc, dataCrc);
+    if (!decode) return;
+
+    size_t count = data.readings.isValid() ? data.readings.size() : 0;
+    for (size_t i = 0; i < count; i++) {
+        const SensorReading& r = data.readings[i];
+        fprintf(readings.row(), "%s,%zu,%u,%u,%u,%.9g,%.9g,%.9g,%.9g,%.9g,%u,%d,%u\n", source, i,
+                (unsigned)r.reading_number, (unsigned)r.timestamp, (unsigned)r.rtc_timestamp,
+                r.temperature, r.ph, r.turbidity, r.tds, r.ec, (unsigned)r.sensor_status, r.valid ? 1 : 0,
+                (unsigned)r.alarms);
+    }
+}
+
+/**
+ * @brief Mismos rangos que CalibrationManager::validateIntegrity()
+ */
+static bool plausibleCalibration(const CalibrationData& c) {
+    float ph_offset = c.ph_offset, ph_slope = c.ph_slope;
+    float kvalue = c.tds_kvalue, voffset = c.tds_voffset;
+    float coeffs[4] = {c.turb_coeff_a, c.turb_coeff_b, c.turb_coeff_c, c.turb_coeff_d};
+    if (c.turb_model > 1) return false;
+    if (!(ph_offset >= -5.0f && ph_offset <= 5.0f)) return false;
+    if (!(ph_slope >= -10.0f && ph_slope <= 10.0f) || fabsf(ph_slope) < 0.1f) return false;
+    if (!(kvalue >= 0.1f && kvalue <= 5.0f) || !(voffset >= -1.0f && voffset <= 1.0f)) return false;
+    for (float k : coeffs) {
+        if (!(fabsf(k) <= 100000.0f)) return false;  // También NaN e Inf
+    }
+    return true;
+}
+
+static void decodeCalibration(const char* source, const CalibrationData& c, size_t offset) {
+    uint32_t computed = crc32((const void*)&c, sizeof(CalibrationData) - sizeof(uint32_t));
+    bool decode = reportBlock(source, "rtc_calibration_data", offset, sizeof(CalibrationData),
+                              computed != c.crc ? "crc" : (plausibleCalibration(c) ? "ok" : "rango"),
+                              true, c.crc, computed);
+    if (!decode) return;
+
+    fprintf(calibration.row(), "%s,%zu,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%u,%u,%u\n", source, offset,
+            c.ph_offset, c.ph_slope, c.tds_kvalue, c.tds_voffset, c.turb_coeff_a, c.turb_coeff_b,
+            c.turb_coeff_c, c.turb_coeff_d, (unsigned)c.turb_model, (unsigned)c.last_update,
+            (unsigned)c.update_count);
+}
+
+template <typename Buffer>
+static void decodeErrors(const char* source, const char* table, const Buffer& buffer, size_t offset) {
+    // Sin CRC en el firmware: solo se validan los índices
+    if (!reportBlock(source, table, offset, sizeof(Buffer), buffer.isValid() ? "ok" : "rango")) return;
+
+    size_t count = buffer.isValid() ? buffer.size() : 0;
+    for (size_t i = 0; i < count; i++) {
+        const ErrorEntry& e = buffer[i];
+        uint32_t context = ((uint32_t)e.context[0] << 24) | ((uint32_t)e.context[1] << 16) |
+                           ((uint32_t)e.context[2] << 8) | e.context[3];  // Como en logError()
+        fprintf(errors.row(), "%s,%s,%zu,%u,%s,%u,%u,0x%08X\n", source, table, i, (unsigned)e.error_code,
+                errorName(e.error_code), (unsigned)e.severity, (unsigned)e.timestamp_min, (unsigned)context);
+    }
+}
+
+/**
+ * @brief Decodificación con símbolos: cada variable en su dirección
+ */
+static void decodeWithSymbols(const char* source, const std::vector<uint8_t>& dump) {
+    size_t offset;
+
+    RTCData data;
+    bool hasData = locate(source, dump, "rtc_data", data, offset);
+    if (hasData) decodeRTCData(source, data, offset);
+
+    CalibrationData calib;
+    if (locate(source, dump, "rtc_calibration_data", calib, offset)) decodeCalibration(source, calib, offset);
+
+    PointList pointLists[CalibrationManager::SENSOR_COUNT];
+    if (locate(source, dump, "rtc_calibration_points", pointLists, offset) &&
+        reportBlock(source, "rtc_calibration_points", offset, sizeof(pointLists),
+                    pointLists[0].isValid() && pointLists[1].isValid() && pointLists[2].isValid() ? "ok" : "rango")) {
+        for (int s = 0; s < CalibrationManager::SENSOR_COUNT; s++) {
+            const PointList& list = pointLists[s];
+            size_t count = list.isValid() ? list.size() : 0;
+            for (size_t i = 0; i < count; i++) {
+                fprintf(points.row(), "%s,%s,%zu,%.9g,%.9g,%.9g\n", source,
+                        CalibrationManager::sensorName((CalibrationManager::CalibrationSensor)s), i,
+                        list[i].voltage, list[i].reference, list[i].temperature);
+            }
+        }
+    }
+
+    RingBuffer<ErrorEntry, WatchdogManager::MAX_CRITICAL_ERRORS> critical;
+    RingBuffer<ErrorEntry, WatchdogManager::MAX_WARNING_ERRORS> warning;
+    StaticVector<ErrorEntry, WatchdogManager::MAX_INFO_ERRORS> info;
+    if (locate(source, dump, "wdt_critical_errors", critical, offset)) decodeErrors(source, "critical", critical, offset);
+    if (locate(source, dump, "wdt_warning_errors", warning, offset)) decodeErrors(source, "warning", warning, offset);
+    if (locate(source, dump, "wdt_info_errors", info, offset)) decodeErrors(source, "info", info, offset);
+
+    // Escalares: vacíos si el símbolo no está
+    uint16_t totalReadings = 0, totalErrors = 0;
+    uint32_t health = 0, failures = 0, lastOk = 0;
+    bool hasTotal = locate(source, dump, "totalReadings", totalReadings, offset);
+    bool hasHealth = locate(source, dump, "wdt_system_health_score", health, offset);
+    bool hasFailures = locate(source, dump, "wdt_consecutive_failures", failures, offset);
+    bool hasLastOk = locate(source, dump, "wdt_last_successful_operation", lastOk, offset);
+    bool hasErrors = locate(source, dump, "wdt_total_errors", totalErrors, offset);
+
+    FILE* f = state.row();
+    fprintf(f, "%s,", source);
+    if (hasData) fprintf(f, "%u,%u,", (unsigned)data.sequence_number, (unsigned)data.boot_timestamp);
+    else fprintf(f, ",,");
+    if (hasTotal) fprintf(f, "%u", (unsigned)totalReadings);
+    fputc(',', f);
+    if (hasHealth) fprintf(f, "%u", (unsigned)health);
+    fputc(',', f);
+    if (hasFailures) fprintf(f, "%u", (unsigned)failures);
+    fputc(',', f);
+    if (hasLastOk) fprintf(f, "%u", (unsigned)lastOk);
+    fputc(',', f);
+    if (hasErrors) fprintf(f, "%u", (unsigned)totalErrors);
+    fputc('\n', f);
+}
+
+/**
+ * @brief Decodificación sin símbolos: búsqueda por marcas y CRC
+ */
+static void decodeByScan(const char* source, const std::vector<uint8_t>& dump) {
+    unsigned found = 0;
+    for (size_t off = 0; off + sizeof(RTCData) <= dump.size(); off += 4) {
+        uint32_t start, end;
+        memcpy(&start, dump.data() + off, 4);
+        if (start != 0x12345678UL) continue;
+        memcpy(&end, dump.data() + off + sizeof(RTCData) - 4, 4);
+        if (end != 0x87654321UL) continue;
+        RTCData data;
+        memcpy((void*)&data, dump.data() + off, sizeof(RTCData));
+        decodeRTCData(source, data, off);
+        found++;
+    }
+    if (!found) reportBlock(source, "rtc_data", 0, sizeof(RTCData), "ausente");
+
+    // CalibrationData no tiene marcas: un CRC que coincide la identifica
+    found = 0;
+    for (size_t off = 0; off + sizeof(CalibrationData) <= dump.size(); off++) {
+        CalibrationData c;
+        memcpy((void*)&c, dump.data() + off, sizeof(CalibrationData));
+        uint32_t stored = c.crc;
+        if (stored != crc32((const void*)&c, sizeof(CalibrationData) - sizeof(uint32_t))) continue;
+        if (!plausibleCalibration(c)) continue;  // Una zona en cero también tiene CRC válido
+        decodeCalibration(source, c, off);
+        found++;
+    }
+    if (!found) reportBlock(source, "rtc_calibration_data", 0, sizeof(CalibrationData), "ausente");
+}
+
+static void decodeDump(const char* source, const std::vector<uint8_t>& dump) {
+    if (symbols.empty()) decodeByScan(source, dump);
+    else decodeWithSymbols(source, dump);
+}
+
+// ——— Trazas de sensores ———
+
+static void decodeTraces(const char* source, const std::vector<uint8_t>& file) {
+    size_t pos = 0;
+    HAL::Trace::FileHeader header;
+    while (pos + sizeof(header) <= file.size()) {
+        memcpy(&header, file.data() + pos, sizeof(header));
+        if (header.magic != HAL_TRACE_FILE_MAGIC) {
+            reportBlock(source, "trace", pos, file.size() - pos, "magic");
+            return;
+        }
+        size_t body = pos + sizeof(header);
+        if (body + header.length > file.size()) {
+            reportBlock(source, "trace", pos, file.size() - pos, "truncado");
+            return;
+        }
+
+        const uint8_t* data = file.data() + body;
+        size_t p = 0, consumed = 0;
+        HAL::Trace::Record r;
+        while (HAL::Trace::nextRecord(data, header.length, p, r)) consumed = p;
+        bool decode = reportBlock(source, "trace", pos, sizeof(header) + header.length,
+                                  consumed == header.length ? "ok" : "truncado");
+
+        p = 0;
+        for (unsigned index = 0; decode && HAL::Trace::nextRecord(data, header.length, p, r); index++) {
+            uint8_t type = r.type & ~HAL_TRACE_MARK;
+            bool mark = (r.type & HAL_TRACE_MARK) != 0;
+            FILE* f = samples.row();
+            fprintf(f, "%s,%u,%u,%s,%u,%d,", source, (unsigned)header.tag, index,
+                    type == (uint8_t)HAL::Trace::Source::ADC ? "adc" :
+                    type == (uint8_t)HAL::Trace::Source::ONEWIRE ? "onewire" :
+                    type == (uint8_t)HAL::Trace::Source::I2C ? "i2c" : "unknown",
+                    (unsigned)r.channel, mark ? 1 : 0);
+            if (mark) {
+                // Marca de ráfaga: sin valor
+            } else if (type == (uint8_t)HAL::Trace::Source::ADC && r.length == 2) {
+                fprintf(f, "%u", (unsigned)(r.data[0] | (r.data[1] << 8)));
+            } else if (type == (uint8_t)HAL::Trace::Source::ONEWIRE && r.length == 2) {
+                fprintf(f, "%.7g", (int16_t)(r.data[0] | (r.data[1] << 8)) * 0.0078125f);
+            } else {
+                for (uint8_t i = 0; i < r.length; i++) fprintf(f, "%02X", r.data[i]);
+            }
+            fputc('\n', f);
+        }
+        pos = body + header.length;
+    }
+    if (pos < file.size()) reportBlock(source, "trace", pos, file.size() - pos, "truncado");
+}
+
+// ——— Punto de entrada ———
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "Uso: %s [--symbols nm.txt] [--base 0xDIRECCION] [--out DIR] [--keep-invalid] ARCHIVO...\n"
+            "  ARCHIVO: volcado de RTC Memory o traza de sensores (.trace)\n",
+            program);
+}
+
+int main(int argc, char** argv) {
+    std::vector<const char*> inputs;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--symbols") == 0 && i + 1 < argc) {
+            if (!symbols.load(argv[++i])) return 1;
+        } else if (strcmp(argv[i], "--base") == 0 && i + 1 < argc) {
+            baseAddress = strtoull(argv[++i], nullptr, 0);
+            baseGiven = true;
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            Table::outputDir = argv[++i];
+        } else if (strcmp(argv[i], "--keep-invalid") == 0) {
+            keepInvalid = true;
+        } else if (argv[i][0] != '-') {
+            inputs.push_back(argv[i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (inputs.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // En el anfitrión la sección persistente empieza en __start_hal_persistent
+    if (!baseGiven && !symbols.find("__start_hal_persistent", baseAddress)) {
+        baseAddress = DECODER_DEFAULT_BASE;
+    }
+    mkdir(Table::outputDir.c_str(), 0755);
+
+    std::vector<uint8_t> file;
+    size_t bytes = 0;
+    for (const char* path : inputs) {
+        if (!readFile(path, file)) continue;
+        bytes += file.size();
+        uint32_t magic = 0;
+        if (file.size() >= 4) memcpy(&magic, file.data(), 4);
+        if (magic == HAL_TRACE_FILE_MAGIC) decodeTraces(path, file);
+        else decodeDump(path, file);
+    }
+
+    fprintf(stderr, "%zu archivos, %zu bytes → %s/\n", inputs.size(), bytes, Table::outputDir.c_str());
+    for (Table* t : TABLES) {
+        if (t->rows()) fprintf(stderr, "  %-20s %10lu filas\n", t->name(), t->rows());
+    }
+    if (blocksFailed) fprintf(stderr, "Aviso: %lu bloques no pasaron la validación (ver blocks.csv)\n", blocksFailed);
+    return blocksFailed ? 1 : 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file AnomalyDetector.cpp
+ * @brief Implementación de los detectores de anomalías por sensor
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+#include "AnomalyDetector.h"
+#include "Logger.h"
+#include <math.h>
+
+static const char TAG[] = "ANOMALY"; ///< Etiqueta de log del módulo
+
+static const uint8_t STATISTICAL = ANOMALY_KIND_EWMA | ANOMALY_KIND_CUSUM; ///< Detectores contra la línea base
+
+// ——— Variables persistentes ———
+HAL_PERSISTENT AnomalyDetector::DetectorState anomaly_state[SensorBreaker::SENSOR_COUNT];
+
+namespace AnomalyDetector {
+
+    /**
+     * @brief Umbrales fijos activos (sin límites hasta begin())
+     */
+    limits_t active_limits[SensorBreaker::SENSOR_COUNT] = {
+        {NAN, NAN, 0.0f, 0.0f}, {NAN, NAN, 0.0f, 0.0f}, {NAN, NAN, 0.0f, 0.0f}, {NAN, NAN, 0.0f, 0.0f}};
+
+    /**
+     * @brief Tendencia máxima por ciclo de cada sensor (max_rate convertido en begin())
+     */
+    float max_trend[SensorBreaker::SENSOR_COUNT] = {0.0f, 0.0f, 0.0f, 0.0f};
+
+    /**
+     * @brief Máscara del ciclo en curso (no persistente)
+     */
+    uint8_t cycle_mask = 0;
+
+    /**
+     * @brief Sensores con alarma nueva en el ciclo en curso (no persistente)
+     */
+    uint8_t new_mask = 0;
+
+    /**
+     * @brief Sensores en alarma aún no aceptada como nuevo nivel (no persistente)
+     */
+    uint8_t follow_mask = 0;
+
+    void begin(const limits_t limits[SensorBreaker::SENSOR_COUNT], uint32_t cycleSeconds, bool reset)
+    {
+        for (uint8_t i = 0; i < SensorBreaker::SENSOR_COUNT; i++) {
+            active_limits[i] = limits[i];
+            max_trend[i] = limits[i].max_rate * cycleSeconds / 3600.0f;
+
+            // Estado no finito = RTC Memory no confiable: reaprender
+            DetectorState &s = anomaly_state[i];
+            if (reset || !isfinite(s.level) || !isfinite(s.trend) || !isfinite(s.variance) ||
+                s.variance < 0.0f || !isfinite(s.ewma) || !isfinite(s.cusum_high) || !isfinite(s.cusum_low)) {
+                s = DetectorState{};
+            }
+        }
+        cycle_mask = 0;
+        new_mask = 0;
+        follow_mask = 0;
+    }
+
+    uint8_t update(SensorBreaker::Sensor sensor, float value, bool valid)
+    {
+        if (sensor >= SensorBreaker::SENSOR_COUNT || !valid || !isfinite(value)) return 0;
+
+        DetectorState &s = anomaly_state[sensor];
+        const limits_t &limits = active_limits[sensor];
+        uint8_t kinds = 0;
+
+        if ((!isnan(limits.min) && value < limits.min) || (!isnan(limits.max) && value > limits.max)) {
+            kinds |= ANOMALY_KIND_THRESHOLD;
+        }
+
+        if (s.samples < ANOMALY_WARMUP_SAMPLES) {
+            // Calentamiento: recta de mínimos cuadrados (Welford) sobre el índice del valor
+            float n = s.samples;
+            float alpha = 1.0f / (n + 1.0f);
+            float deviation = value - s.level;
+            s.level += alpha * deviation;
+            s.variance = (1.0f - alpha) * (s.variance + alpha * deviation * deviation);
+            s.cusum_high += (n - (n - 1.0f) * 0.5f) * (value - s.level);
+
+            if (s.samples == ANOMALY_WARMUP_SAMPLES - 1) {
+                // Nivel en el último valor, tendencia = pendiente, varianza alrededor de la recta
+                const float N = ANOMALY_WARMUP_SAMPLES;
+                float slope = s.cusum_high * 12.0f / (N * (N * N - 1.0f));
+                slope = fmaxf(-max_trend[sensor], fminf(max_trend[sensor], slope));
+                s.level += slope * (N - 1.0f) * 0.5f;
+                s.trend = slope;
+                s.variance = fmaxf(0.0f, s.variance - slope * slope * (N * N - 1.0f) / 12.0f);
+                s.cusum_high = 0.0f;
+            }
+        } else {
+            float sigma = sqrtf(s.variance);
+            if (sigma < limits.min_sigma) sigma = limits.min_sigma;
+
+            float predicted = s.level + s.trend;
+            float residual = value - predicted;
+
+            s.ewma = ANOMALY_EWMA_LAMBDA * residual + (1.0f - ANOMALY_EWMA_LAMBDA) * s.ewma;
+            float ewmaLimit = ANOMALY_EWMA_L * sigma * sqrtf(ANOMALY_EWMA_LAMBDA / (2.0f - ANOMALY_EWMA_LAMBDA));
+            if (fabsf(s.ewma) > ewmaLimit) {
+                kinds |= ANOMALY_KIND_EWMA;
+            }
+
+            s.cusum_high = fmaxf(0.0f, s.cusum_high + residual - ANOMALY_CUSUM_K * sigma);
+            s.cusum_low = fmaxf(0.0f, s.cusum_low - residual - ANOMALY_CUSUM_K * sigma);
+            if (s.cusum_high > ANOMALY_CUSUM_H * sigma || s.cusum_low > ANOMALY_CUSUM_H * sigma) {
+                kinds |= ANOMALY_KIND_CUSUM;
+            }
+
+            // La predicción avanza siempre; solo se corrige con valores bajo control
+            // estadístico (un umbral fijo superado no dice nada de la línea base)
+            s.level = predicted;
+            if (!(kinds & STATISTICAL)) {
+                s.level += ANOMALY_BASELINE_ALPHA * residual;
+                s.trend += ANOMALY_BASELINE_ALPHA * ANOMALY_TREND_BETA * residual;
+                s.trend = fmaxf(-max_trend[sensor], fminf(max_trend[sensor], s.trend));
+                float clipped = fminf(residual * residual, ANOMALY_HUBER_C * ANOMALY_HUBER_C * sigma * sigma);
+                s.variance += ANOMALY_BASELINE_ALPHA * (clipped / ANOMALY_HUBER_KAPPA - s.variance);
+            }
+        }
+        if (s.samples < 0xFFFF) s.samples++;
+
+        if (kinds) {
+            cycle_mask |= (1 << sensor) | kinds;
+
+            // Nueva si se enciende el umbral o la parte estadística (aunque la otra siga activa)
+            bool raised = ((kinds & ANOMALY_KIND_THRESHOLD) && !(s.alarms & ANOMALY_KIND_THRESHOLD)) ||
+                          ((kinds & STATISTICAL) && !(s.alarms & STATISTICAL));
+            if (raised) {
+                new_mask |= (1 << sensor);
+                s.alarm_cycles = 0; // Se vuelve a seguir de cerca, aunque hubiera una alarma aceptada
+                LOG_W(TAG, " %s: alarma %s%s%s (valor %.3f, base %.3f)", SensorBreaker::name(sensor),
+                      (kinds & ANOMALY_KIND_THRESHOLD) ? "umbral " : "",
+                      (kinds & ANOMALY_KIND_EWMA) ? "EWMA " : "",
+                      (kinds & ANOMALY_KIND_CUSUM) ? "CUSUM" : "", value, s.level);
+            }
+            if (s.alarm_cycles < 255) s.alarm_cycles++;
+            if (s.alarm_cycles < ANOMALY_REBASE_CYCLES) {
+                follow_mask |= (1 << sensor);
+            } else if (s.alarm_cycles == ANOMALY_REBASE_CYCLES) {
+                // Excursión sostenida: es el nuevo nivel, no una anomalía
+                LOG_I(TAG, " %s: %u ciclos en alarma - se reaprende la línea base",
+                      SensorBreaker::name(sensor), s.alarm_cycles);
+                s = DetectorState{};
+                s.alarm_cycles = ANOMALY_REBASE_CYCLES;    // Aceptada: ya no acorta el ciclo
+                s.alarms = kinds & ANOMALY_KIND_THRESHOLD; // Un umbral fijo sigue activo, pero no es nuevo
+                return kinds;
+            }
+        } else if (s.alarms) {
+            LOG_I(TAG, " %s: de vuelta bajo control", SensorBreaker::name(sensor));
+            s.alarm_cycles = 0;
+        }
+        s.alarms = kinds;
+        return kinds;
+    }
+
+    uint8_t cycleMask()
+    {
+        return cycle_mask;
+    }
+
+    uint8_t newAlarms()
+    {
+        return new_mask;
+    }
+
+    uint8_t followMask()
+    {
+        return follow_mask;
+    }
+
+    const DetectorState& state(SensorBreaker::Sensor sensor)
+    {
+        return anomaly_state[sensor < SensorBreaker::SENSOR_COUNT ? sensor : 0];
+    }
+}
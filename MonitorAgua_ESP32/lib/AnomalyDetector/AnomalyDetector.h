@@ -0,0 +1,146 @@
+/**
+ * @file AnomalyDetector.h
+ * @brief Detección de anomalías en línea por sensor (umbral fijo, EWMA y CUSUM)
+ * @details Se evalúa una vez por ciclo con los valores del ciclo. Cada sensor tiene
+ *          tres detectores con estado O(1) en RTC Memory:
+ *          - Umbral fijo: valor fuera de [min, max] configurado.
+ *          - EWMA: estadístico z = λ·e + (1-λ)·z del residuo e = x - predicción,
+ *            fuera de ± L·σ·√(λ/(2-λ)). Detecta saltos y picos en el mismo ciclo.
+ *          - CUSUM bilateral: acumula e - k·σ; alarma al pasar h·σ.
+ *            Detecta derivas lentas que el EWMA absorbe.
+ *
+ *          La predicción es nivel + tendencia (Holt): el ciclo diario de la
+ *          temperatura es normal y una media simple lo seguiría con retraso. La
+ *          tendencia se limita a max_rate, así que una deriva más rápida que la
+ *          plausible aparece en el residuo. Nivel, tendencia y varianza solo se
+ *          corrigen con valores bajo control, para que una excursión no se convierta
+ *          en la nueva normalidad; la varianza usa el residuo recortado (Huber) para
+ *          que un salto que todavía no dispara no ensanche los límites. Durante los
+ *          primeros ANOMALY_WARMUP_SAMPLES valores solo aplica el umbral fijo y se
+ *          ajusta una recta (nivel y tendencia iniciales). Si un sensor pasa
+ *          ANOMALY_REBASE_CYCLES ciclos seguidos en alarma se acepta el nuevo nivel y
+ *          se reaprende la base.
+ *
+ *          Con un valor por ciclo (~1000 al día) los límites son anchos (L=4, h=10)
+ *          para que las falsas alarmas queden en pocas por mes y por sensor; un salto
+ *          de 3σ se detecta en pocos ciclos.
+ *
+ *          Una alarma nueva (ver newAlarms()) dispara en main.cpp un
+ *          envío de alerta fuera de programa; mientras haya alarmas sin aceptar el
+ *          ciclo de sueño se acorta y cada lectura almacenada lleva la máscara en "alarms".
+ *
+ * @note Índice de sensor = SensorBreaker::Sensor (bit i = sensor i, como "breakers").
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef ANOMALY_DETECTOR_H
+#define ANOMALY_DETECTOR_H
+
+#include <Arduino.h>
+#include "HAL.h"
+#include "SensorBreaker.h"
+
+// ——— Configuración ———
+#define ANOMALY_WARMUP_SAMPLES   30      // Valores para ajustar nivel y tendencia antes de EWMA/CUSUM
+#define ANOMALY_BASELINE_ALPHA   0.05f   // Corrección del nivel y la varianza (≈ 20 ciclos de memoria)
+#define ANOMALY_TREND_BETA       0.1f    // Corrección de la tendencia (relativa a ANOMALY_BASELINE_ALPHA)
+#define ANOMALY_HUBER_C          2.0f    // Residuo recortado a ±c·σ al actualizar la varianza
+#define ANOMALY_HUBER_KAPPA      0.9205f // E[min(z², c²)] con z normal: corrige el sesgo del recorte
+#define ANOMALY_EWMA_LAMBDA      0.3f    // Peso del estadístico EWMA
+#define ANOMALY_EWMA_L           4.0f    // Ancho de los límites de control (en σ del estadístico)
+#define ANOMALY_CUSUM_K          0.5f    // Holgura del CUSUM (en σ)
+#define ANOMALY_CUSUM_H          10.0f   // Umbral de decisión del CUSUM (en σ)
+#define ANOMALY_REBASE_CYCLES    30      // Ciclos seguidos en alarma tras los que se reaprende la base
+
+// ——— Máscara de alarmas (SensorReading::alarms) ———
+#define ANOMALY_SENSOR_MASK      0x0F    // Bits 0-3: sensores en alarma (bit i = sensor i)
+#define ANOMALY_KIND_THRESHOLD   0x10    // Bit 4: algún umbral fijo superado
+#define ANOMALY_KIND_EWMA        0x20    // Bit 5: algún EWMA fuera de control
+#define ANOMALY_KIND_CUSUM       0x40    // Bit 6: algún CUSUM superó h
+
+/**
+ * @namespace AnomalyDetector
+ * @brief Detectores por sensor y alarmas del ciclo
+ */
+namespace AnomalyDetector {
+
+    /**
+     * @struct limits_t
+     * @brief Umbrales fijos y σ mínima de un sensor
+     */
+    typedef struct {
+        float min;         ///< Alarma por debajo (NAN = sin límite inferior)
+        float max;         ///< Alarma por encima (NAN = sin límite superior)
+        float min_sigma;   ///< Piso de σ: evita alarmas por ruido en agua muy estable
+        float max_rate;    ///< Tendencia máxima aceptada como normal, en unidades por hora
+    } limits_t;
+
+    /**
+     * @struct DetectorState
+     * @brief Estado persistente de un sensor (28 bytes en RTC Memory)
+     */
+    typedef struct __attribute__((packed)) {
+        float level;         ///< Nivel de la línea base
+        float trend;         ///< Tendencia por ciclo de la línea base
+        float variance;      ///< Varianza del residuo (EWMA lenta)
+        float ewma;          ///< Estadístico EWMA del residuo
+        float cusum_high;    ///< CUSUM hacia arriba (en calentamiento: comomento índice-valor)
+        float cusum_low;     ///< CUSUM hacia abajo (en unidades del sensor)
+        uint16_t samples;    ///< Valores vistos (satura en 65535)
+        uint8_t alarms;      ///< Detectores en alarma en el último ciclo (ANOMALY_KIND_*)
+        uint8_t alarm_cycles; ///< Ciclos seguidos en alarma (satura en 255; ≥ REBASE = aceptada)
+    } DetectorState;
+
+    /**
+     * @brief Fija los umbrales (una vez en setup())
+     * @param limits Un elemento por sensor, en orden SensorBreaker::Sensor
+     * @param cycleSeconds Periodo nominal del ciclo (convierte max_rate a tendencia por ciclo)
+     * @param reset true tras reinicializar la RTC Memory (se descarta la línea base)
+     */
+    void begin(const limits_t limits[SensorBreaker::SENSOR_COUNT], uint32_t cycleSeconds, bool reset = false);
+
+    /**
+     * @brief Evalúa un valor del ciclo
+     * @param sensor Sensor
+     * @param value Valor del ciclo
+     * @param valid false si no hubo lectura válida (el estado no cambia)
+     * @return Detectores en alarma (ANOMALY_KIND_*), 0 si bajo control
+     */
+    uint8_t update(SensorBreaker::Sensor sensor, float value, bool valid);
+
+    /**
+     * @brief Máscara del ciclo para SensorReading::alarms
+     */
+    uint8_t cycleMask();
+
+    /**
+     * @brief Sensores que entraron en alarma en este ciclo
+     * @details El umbral fijo o la parte estadística (EWMA/CUSUM) se encendió y no lo
+     *          estaba en el ciclo anterior: una excursión sobre un umbral aceptado
+     *          también es nueva.
+     */
+    uint8_t newAlarms();
+
+    /**
+     * @brief Sensores en alarma desde hace menos de ANOMALY_REBASE_CYCLES ciclos
+     * @details Son los que justifican acortar el ciclo. Una alarma aceptada (umbral
+     *          fijo superado de forma sostenida) sigue en cycleMask() pero no aquí.
+     */
+    uint8_t followMask();
+
+    /**
+     * @brief Estado de un sensor (solo lectura)
+     */
+    const DetectorState& state(SensorBreaker::Sensor sensor);
+}
+
+/**
+ * @var anomaly_state
+ * @brief Estado de los detectores en RTC Memory
+ * @note Variable HAL_PERSISTENT declarada en .cpp, solo declaración extern aquí.
+ */
+extern HAL_PERSISTENT AnomalyDetector::DetectorState anomaly_state[SensorBreaker::SENSOR_COUNT];
+
+#endif // ANOMALY_DETECTOR_H
@@ -0,0 +1,189 @@
+/**
+ * @file Benchmark.cpp
+ * @brief Implementación del arnés de microbenchmarks.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include "Benchmark.h"
+#include "HAL.h"
+
+#ifdef HAL_NATIVE
+#include <chrono>
+#else
+#include "esp_idf_version.h"
+#include "esp_cpu.h"
+#endif
+
+namespace Benchmark {
+
+    /**
+     * @brief Caso registrado
+     */
+    typedef struct {
+        const char* name;
+        CaseFn fn;
+    } Case;
+
+    static Case cases[BENCH_MAX_CASES];
+    static int case_count = 0;
+
+    // ——— Reloj ———
+
+#ifdef HAL_NATIVE
+    static const char BENCH_PLATFORM[] = "native";
+
+    static uint64_t ticks() {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static uint64_t elapsed(uint64_t start) {
+        return ticks() - start;
+    }
+
+    static uint32_t cpuMhz() {
+        return 0;  // Tiempo en ns; sin contador de ciclos portable
+    }
+
+    static double ticksToNs(uint64_t t) {
+        return (double)t;
+    }
+#else
+    static const char BENCH_PLATFORM[] = CONFIG_IDF_TARGET;
+
+    static uint64_t ticks() {
+#if ESP_IDF_VERSION_MAJOR >= 5
+        return esp_cpu_get_cycle_count();
+#else
+        return esp_cpu_get_ccount();
+#endif
+    }
+
+    static uint64_t elapsed(uint64_t start) {
+        return (uint32_t)((uint32_t)ticks() - (uint32_t)start);  // Contador de 32 bits
+    }
+
+    static uint32_t cpuMhz() {
+        return getCpuFrequencyMhz();
+    }
+
+    static double ticksToNs(uint64_t t) {
+        return (double)t * 1000.0 / cpuMhz();
+    }
+#endif
+
+    /**
+     * @brief Duración de un lote de `iterations`
+     */
+    static uint64_t measure(CaseFn fn, uint32_t iterations) {
+        uint64_t start = ticks();
+        fn(iterations);
+        return elapsed(start);
+    }
+
+    /**
+     * @brief Iteraciones necesarias para que un lote dure BENCH_MIN_BATCH_US
+     */
+    static uint32_t calibrate(CaseFn fn) {
+        const double target = BENCH_MIN_BATCH_US * 1000.0;
+        uint32_t iterations = 1;
+        for (;;) {
+            double ns = ticksToNs(measure(fn, iterations));
+            if (ns >= target || iterations >= BENCH_MAX_ITERATIONS) return iterations;
+
+            // Estimación con margen; al menos duplica y a lo sumo ×10 por paso
+            double scale = (ns > 0.0) ? target * 1.2 / ns : 10.0;
+            if (scale < 2.0) scale = 2.0;
+            if (scale > 10.0) scale = 10.0;
+            double next = iterations * scale;
+            iterations = (next >= BENCH_MAX_ITERATIONS) ? BENCH_MAX_ITERATIONS : (uint32_t)next;
+            delay(1);  // Deja correr la tarea idle (task watchdog)
+        }
+    }
+
+    // ——— Implementación de funciones ———
+
+    bool add(const char* name, CaseFn fn) {
+        if (case_count >= BENCH_MAX_CASES) return false;
+        cases[case_count].name = name;
+        cases[case_count].fn = fn;
+        case_count++;
+        return true;
+    }
+
+    CaseFn find(const char* name) {
+        for (int i = 0; i < case_count; i++) {
+            if (strcmp(cases[i].name, name) == 0) return cases[i].fn;
+        }
+        return nullptr;
+    }
+
+    int count() {
+        return case_count;
+    }
+
+    const char* name(int index) {
+        return (index >= 0 && index < case_count) ? cases[index].name : nullptr;
+    }
+
+    void run(CaseFn fn, Result& result) {
+        fn(1);  // Calentamiento (cachés, inicialización perezosa)
+        uint32_t iterations = calibrate(fn);
+
+        double perIteration[BENCH_REPETITIONS];
+        uint32_t allocationsBefore = HAL::heapAllocations();
+        for (int r = 0; r < BENCH_REPETITIONS; r++) {
+            perIteration[r] = ticksToNs(measure(fn, iterations)) / iterations;
+            delay(1);
+        }
+        result.allocs = (double)(HAL::heapAllocations() - allocationsBefore) /
+                        ((double)iterations * BENCH_REPETITIONS);
+        // Orden por inserción (5 elementos)
+        for (int a = 1; a < BENCH_REPETITIONS; a++) {
+            double v = perIteration[a];
+            int b = a - 1;
+            while (b >= 0 && perIteration[b] > v) {
+                perIteration[b + 1] = perIteration[b];
+                b--;
+            }
+            perIteration[b + 1] = v;
+        }
+        result.iterations = iterations;
+        result.median_ns = perIteration[BENCH_REPETITIONS / 2];
+        result.min_ns = perIteration[0];
+        result.cycles = result.median_ns * cpuMhz() / 1000.0;
+    }
+
+    int runAll(const char* filter) {
+        Serial.printf("{\n  \"context\": {\"platform\": \"%s\", \"cpu_mhz\": %u, "
+                      "\"repetitions\": %d, \"min_batch_us\": %d},\n  \"benchmarks\": [",
+                      BENCH_PLATFORM, (unsigned)cpuMhz(), BENCH_REPETITIONS, BENCH_MIN_BATCH_US);
+
+        int executed = 0;
+        for (int i = 0; i < case_count; i++) {
+            const Case& c = cases[i];
+            if (filter && !strstr(c.name, filter)) continue;
+
+            Result r;
+            run(c.fn, r);
+
+            Serial.printf("%s\n    {\"name\": \"%s\", \"run_type\": \"iteration\", \"iterations\": %u, "
+                          "\"real_time\": %.3f, \"cpu_time\": %.3f, \"min_time\": %.3f, "
+                          "\"cycles_per_iteration\": %.1f, \"time_unit\": \"ns\"",
+                          executed ? "," : "", c.name, (unsigned)r.iterations, r.median_ns, r.median_ns,
+                          r.min_ns, r.cycles);
+            if (HAL::heapAllocationsCounted()) {
+                Serial.printf(", \"allocs_per_iteration\": %.3f", r.allocs);
+            }
+            Serial.printf("}");
+            executed++;
+        }
+
+        Serial.printf("\n  ]\n}\n");
+        Serial.flush();
+        return executed;
+    }
+
+} // namespace Benchmark
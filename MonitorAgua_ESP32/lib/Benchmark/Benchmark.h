@@ -0,0 +1,114 @@
+/**
+ * @file Benchmark.h
+ * @brief Arnés mínimo de microbenchmarks para los kernels del firmware.
+ * @details Cada caso recibe el número de iteraciones y las ejecuta en su propio
+ *          bucle. El arnés duplica las iteraciones hasta que un lote dura al menos
+ *          BENCH_MIN_BATCH_US, repite el lote BENCH_REPETITIONS veces y reporta la
+ *          mediana y el mínimo por iteración.
+ *
+ *          Reloj:
+ *          - ESP32: contador de ciclos del CPU (esp_cpu_get_ccount / _cycle_count).
+ *          - Linux (HAL_NATIVE): reloj monotónico real del anfitrión; el reloj
+ *            virtual de la HAL no sirve para medir.
+ *
+ *          La salida es JSON con el esquema de Google Benchmark (campos
+ *          "real_time"/"cpu_time" en ns), de modo que dos corridas se comparan con
+ *          tools/bench_compare.py o con compare.py de Google Benchmark. Si la HAL
+ *          cuenta asignaciones de heap se agrega "allocs_per_iteration" (promedio de
+ *          los lotes medidos), que tools/perf_budget.py compara con perf_budgets.ini.
+ *
+ *          run() mide un caso sin escribir nada: lo usan runAll() y las pruebas de
+ *          presupuesto de test/ (test_perf_budgets), que comparan el resultado con
+ *          los límites sin pasar por el JSON.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+// ——— Configuración ———
+#define BENCH_MAX_CASES     32        // Casos registrables
+#define BENCH_REPETITIONS   5         // Lotes medidos por caso
+#define BENCH_MIN_BATCH_US  20000     // Duración mínima de un lote
+#define BENCH_MAX_ITERATIONS 0x1000000u  // Tope de iteraciones por lote
+
+namespace Benchmark {
+
+    /**
+     * @brief Cuerpo de un caso: ejecuta la operación `iterations` veces
+     */
+    typedef void (*CaseFn)(uint32_t iterations);
+
+    /**
+     * @brief Medición de un caso
+     */
+    typedef struct {
+        uint32_t iterations;   ///< Iteraciones por lote
+        double median_ns;      ///< Mediana por iteración
+        double min_ns;         ///< Mínimo por iteración
+        double cycles;         ///< Ciclos de CPU por iteración (0 en native)
+        double allocs;         ///< Asignaciones de heap por iteración (si se cuentan)
+    } Result;
+
+    /**
+     * @brief Registra un caso
+     * @param name Nombre "grupo/kernel[/parámetro]" (literal: no se copia)
+     * @param fn Cuerpo del caso
+     * @return false si no quedan entradas libres
+     */
+    bool add(const char* name, CaseFn fn);
+
+    /**
+     * @brief Busca un caso registrado
+     * @param name Nombre exacto
+     * @return Cuerpo del caso o nullptr
+     */
+    CaseFn find(const char* name);
+
+    /**
+     * @brief Casos registrados
+     */
+    int count();
+
+    /**
+     * @brief Nombre del i-ésimo caso registrado (nullptr fuera de rango)
+     */
+    const char* name(int index);
+
+    /**
+     * @brief Mide un caso: calentamiento, calibración y BENCH_REPETITIONS lotes
+     * @param fn Cuerpo del caso
+     * @param[out] result Mediana, mínimo, ciclos y asignaciones por iteración
+     */
+    void run(CaseFn fn, Result& result);
+
+    /**
+     * @brief Ejecuta los casos registrados y escribe el JSON por Serial
+     * @param filter Subcadena que deben contener los nombres (nullptr: todos)
+     * @return Casos ejecutados
+     */
+    int runAll(const char* filter = nullptr);
+
+    /**
+     * @brief Impide que el compilador descarte un resultado
+     */
+    template <typename T>
+    inline void doNotOptimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * @brief Barrera: obliga a materializar las escrituras pendientes a memoria
+     */
+    inline void clobberMemory() {
+        asm volatile("" : : : "memory");
+    }
+
+} // namespace Benchmark
+
+#endif // BENCHMARK_H
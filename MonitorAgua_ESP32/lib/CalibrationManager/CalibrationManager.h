@@ -9,10 +9,16 @@
  * La calibración es fundamental para asegurar la precisión del sistema de medición. Esta clase ofrece:
  *
  * - Almacenamiento persistente de parámetros mediante estructura empaquetada y CRC.
+ * - Copia maestra en NVS (flash) con versión y CRC; la copia en RTC memory actúa como
+ *   caché y solo se recarga desde flash si su CRC falla (batería, brownout).
  * - Validación individual para cada sensor, evitando configuraciones corruptas o fuera de rango.
  * - Funciones seguras de actualización con retorno detallado de errores.
+ * - Actualizaciones transaccionales: los cambios se preparan sobre una copia, se validan
+ *   juntos y se confirman con una sola actualización de CRC, aplicación y escritura.
  * - Serialización a JSON para exportación remota o diagnóstico.
  * - Aplicación automática de parámetros a los controladores de sensores correspondientes.
+ * - Calibración multipunto en campo: registro de pares (voltaje, valor patrón) y ajuste
+ *   por mínimos cuadrados (lineal para pH/TDS, cúbico para turbidez) con residuos y R².
  * - Sistema interno de logging configurable por Serial o callback externo.
  *
  * Esta clase actúa como **fuente única de verdad (single source of truth)** para todo el proceso
@@ -30,7 +36,9 @@
 #define CALIBRATION_MANAGER_H
 
 #include <Arduino.h>
-#include "esp_crc.h"
+#include "HAL.h"
+#include <ArduinoJson.h>
+#include "LeastSquares.h"
 
 /**
  * @class CalibrationManager
@@ -71,6 +79,7 @@ public:
         float turb_coeff_b; /**< Coeficiente B del polinomio de turbidez */
         float turb_coeff_c; /**< Coeficiente C del polinomio de turbidez */
         float turb_coeff_d; /**< Coeficiente D del polinomio de turbidez */
+        uint8_t turb_model; /**< 0 = algoritmo segmentado, 1 = polinomio ajustado en campo */
         
         // Metadata
         uint32_t last_update; /**< Timestamp de la última calibración */
@@ -99,7 +108,47 @@ public:
         CALIB_ERROR_OUT_OF_RANGE, /**< Valores fuera de rangos permitidos */
         CALIB_ERROR_CRC_MISMATCH, /**< Fallo de integridad por CRC incorrecto */
         CALIB_ERROR_WRITE_FAILED, /**< Error al intentar escribir valores */
-        CALIB_ERROR_NOT_INITIALIZED /**< El sistema no ha sido inicializado */
+        CALIB_ERROR_NOT_INITIALIZED, /**< El sistema no ha sido inicializado */
+        CALIB_ERROR_INSUFFICIENT_POINTS, /**< Menos puntos que parámetros del modelo */
+        CALIB_ERROR_ILL_CONDITIONED /**< Puntos sin variación suficiente de voltaje */
+    };
+
+    /**
+     * @enum CalibrationSensor
+     * @brief Sensor al que pertenece un punto o ajuste de calibración.
+     */
+    enum CalibrationSensor {
+        SENSOR_PH = 0, /**< pH = slope·V + offset */
+        SENSOR_TDS, /**< TDS = k·TDS_base(V - voffset, T) */
+        SENSOR_TURBIDITY, /**< NTU = a·V³ + b·V² + c·V + d */
+        SENSOR_COUNT /**< Número de sensores (o "todos" en clearCalibrationPoints) */
+    };
+
+    static constexpr uint8_t MAX_CALIBRATION_POINTS = 8; /**< Puntos por sensor */
+
+    /**
+     * @struct CalibrationPoint
+     * @brief Par medido en una solución patrón.
+     */
+    struct CalibrationPoint {
+        float voltage; /**< Voltaje del sensor (V); crudo sin offset en TDS */
+        float reference; /**< Valor patrón: pH, ppm o NTU */
+        float temperature; /**< Temperatura de la solución (°C), usada en TDS */
+    };
+
+    /**
+     * @struct FitReport
+     * @brief Resultado del último ajuste multipunto.
+     * @details coeffs en orden ascendente: pH {offset, slope}, TDS {k},
+     *          turbidez {d, c, b, a}. residuals[i] = patrón - modelo del punto i.
+     */
+    struct FitReport {
+        uint8_t sensor; /**< CalibrationSensor ajustado */
+        uint8_t result; /**< CalibrationResult del ajuste */
+        bool applied; /**< true si los coeficientes quedaron guardados */
+        float coeffs[LSQ_MAX_TERMS]; /**< Coeficientes ajustados */
+        LeastSquares::FitStats stats; /**< n, RMSE, residuo máximo y R² */
+        float residuals[MAX_CALIBRATION_POINTS]; /**< Residuo por punto */
     };
 
     /**
@@ -114,6 +163,9 @@ private:
     bool _initialized; /**< Indica si el módulo ha sido inicializado */
     LogCallback _logCallback; /**< Callback personalizado para registro */
     static CalibrationData* _calibData; /**< Puntero a la estructura global de calibración */
+    FitReport _lastFit; /**< Último ajuste multipunto realizado */
+    bool _flashDirty; /**< Hay cambios de calibración aún no escritos en NVS */
+    bool _responseIncludesFit; /**< El último comando fue "calib_fit" */
 
 public:
 
@@ -137,8 +189,41 @@ public:
 
     /**
      * @brief Restaura todos los valores de calibración a sus valores por defecto.
+     * @note No escribe en flash; el comando "restore_defaults" sí lo hace.
      */
     void restoreDefaults();
+
+    /**
+     * @brief Escribe la calibración en NVS si hubo cambios desde la última escritura.
+     * @details commitCalibration() lo invoca al confirmar; es público para reintentar
+     * tras un CALIB_ERROR_WRITE_FAILED.
+     * @return true si la flash quedó al día (incluye el caso sin cambios).
+     */
+    bool saveToFlash();
+
+    // Transacciones
+
+    /**
+     * @brief Copia de la calibración vigente, para preparar cambios sobre ella.
+     * @return Copia de la estructura (incluye metadatos y CRC actuales).
+     */
+    CalibrationData getCalibrationData();
+
+    /**
+     * @brief Confirma de forma atómica una calibración preparada.
+     * @details Valida todos los grupos (pH, TDS, turbidez) antes de tocar nada: si
+     * alguno falla no se modifica ningún parámetro. Si todo es válido y hubo cambios,
+     * copia los parámetros, actualiza metadatos y CRC una sola vez, aplica a los
+     * sensores y escribe en flash.
+     * @param staged Calibración completa deseada (metadatos y CRC se ignoran).
+     * @return CALIB_SUCCESS, CALIB_ERROR_OUT_OF_RANGE o CALIB_ERROR_WRITE_FAILED.
+     */
+    CalibrationResult commitCalibration(const CalibrationData& staged);
+
+    /**
+     * @brief Indica si hay cambios pendientes de escribir en flash.
+     */
+    bool isFlashDirty();
     
     // Getters/Setters pH
 
@@ -203,17 +288,88 @@ public:
     // Procesamiento de comandos
 
     /**
-     * @brief Procesa un comando JSON con parámetros de calibración.
-     * @param jsonCommand Cadena JSON recibida.
-     * @return Resultado de la asignación.
+     * @brief Procesa un comando JSON de calibración directamente sobre su buffer.
+     * @details El buffer se analiza sin copiarlo (las cadenas del documento apuntan a
+     * él), por lo que su contenido queda modificado. Un comando "calibrate" con varios
+     * sensores se confirma como una única transacción.
+     * @param json Buffer con el JSON (p. ej. el payload del WebSocket).
+     * @param length Longitud del JSON en bytes.
+     * @return Resultado del comando.
+     */
+    CalibrationResult processCalibrationCommand(char* json, size_t length);
+
+    /**
+     * @brief Escribe la respuesta a un comando: estado y calibración vigente en un solo JSON.
+     * @details {"status":"success"|"error","code":n,"message":"...","calibration":{...}}
+     * y, tras "calib_fit", el informe del ajuste en "fit".
+     * @param result Resultado devuelto por processCalibrationCommand().
+     * @param buffer Destino.
+     * @param size Tamaño del destino en bytes.
+     * @return Longitud que tendría el texto completo (semántica de snprintf).
+     */
+    size_t getResponseJSON(CalibrationResult result, char* buffer, size_t size);
+
+    /**
+     * @brief Descripción corta de un resultado de calibración.
      */
-    CalibrationResult processCalibrationCommand(const String& jsonCommand);
+    static const char* resultMessage(CalibrationResult result);
     
+    // Calibración multipunto
+
+    /**
+     * @brief Registra un punto (voltaje, valor patrón) para el ajuste de un sensor.
+     * @param sensor Sensor al que pertenece el punto.
+     * @param reference Valor de la solución patrón (pH, ppm o NTU).
+     * @param voltage Voltaje medido; NAN para medirlo ahora con el sensor.
+     * @param temperature Temperatura de la solución en °C (solo TDS).
+     * @return CALIB_SUCCESS o CALIB_ERROR_WRITE_FAILED si ya no caben puntos.
+     */
+    CalibrationResult addCalibrationPoint(CalibrationSensor sensor, float reference,
+                                          float voltage = NAN, float temperature = 25.0f);
+
     /**
-     * @brief Genera un JSON con toda la información de calibración actual.
-     * @return Cadena JSON con parámetros y metadatos.
+     * @brief Ajusta el modelo del sensor con los puntos registrados.
+     * @param sensor Sensor a ajustar.
+     * @param apply true para guardar y aplicar los coeficientes si son válidos.
+     * @return Resultado del ajuste; el detalle queda en getLastFit().
      */
-    String getCalibrationJSON();
+    CalibrationResult fitCalibration(CalibrationSensor sensor, bool apply = true);
+
+    /**
+     * @brief Descarta los puntos registrados de un sensor (SENSOR_COUNT = todos).
+     */
+    void clearCalibrationPoints(CalibrationSensor sensor);
+
+    /**
+     * @brief Número de puntos registrados para un sensor.
+     */
+    uint8_t getCalibrationPointCount(CalibrationSensor sensor);
+
+    /**
+     * @brief Último ajuste multipunto (coeficientes, residuos y métricas).
+     */
+    const FitReport& getLastFit();
+
+    /**
+     * @brief Escribe el último ajuste como JSON en un buffer del llamador.
+     * @param buffer Destino.
+     * @param size Tamaño del destino en bytes.
+     * @return Longitud que tendría el texto completo (semántica de snprintf).
+     */
+    size_t getFitReportJSON(char* buffer, size_t size);
+
+    /**
+     * @brief Nombre corto de un sensor de calibración ("ph", "tds", "turb").
+     */
+    static const char* sensorName(CalibrationSensor sensor);
+
+    /**
+     * @brief Escribe un JSON con toda la información de calibración actual.
+     * @param buffer Destino.
+     * @param size Tamaño del destino en bytes.
+     * @return Longitud que tendría el texto completo (semántica de snprintf).
+     */
+    size_t getCalibrationJSON(char* buffer, size_t size);
     
     // Información
 
@@ -250,6 +406,33 @@ private:
      */
     void updateCRC();
 
+    /**
+     * @brief Carga los valores por defecto en una estructura (sin metadatos).
+     */
+    static void loadDefaults(CalibrationData& data);
+
+    /**
+     * @brief Agrega los parámetros y metadatos de calibración a un objeto JSON.
+     */
+    void fillCalibrationJSON(JsonObject obj);
+
+    /**
+     * @brief Agrega el último ajuste multipunto a un objeto JSON.
+     */
+    void fillFitJSON(JsonObject obj);
+
+    /**
+     * @brief Copia a RTC memory el registro de calibración guardado en NVS.
+     * @return true si existía un registro con versión, tamaño, CRC y rangos válidos.
+     */
+    bool loadFromFlash();
+
+    /**
+     * @brief Interpreta el campo "sensor" de un comando ("ph", "tds", "turb").
+     * @return Sensor o SENSOR_COUNT si no se reconoce.
+     */
+    static CalibrationSensor parseSensor(const char* name);
+
     /**
      * @brief Calcula un CRC32 sobre una región de memoria.
      * @param data Puntero a los datos.
@@ -259,17 +442,12 @@ private:
     uint32_t calculateCRC32(const void* data, size_t length);
 
     /**
-     * @brief Envía un mensaje de log al callback o Serial.
-     * @param message Texto del mensaje.
-     */
-    void log(const char* message);
-
-    /**
-     * @brief Envía un mensaje de log formateado.
-     * @param format Cadena de formato estilo printf.
-     * @param ... Argumentos variables.
+     * @brief Envía mensaje de log con formato al backend común (usar macros MLOG_*)
+     * @param level Nivel LOG_LEVEL_* del mensaje
+     * @param format String de formato estilo printf
+     * @param ... Argumentos variables
      */
-    void logf(const char* format, ...);
+    void logf(uint8_t level, const char* format, ...) __attribute__((format(printf, 3, 4)));
 };
 
 #endif
\ No newline at end of file
@@ -7,34 +7,61 @@
  * Este módulo centraliza la lógica para mantener una única fuente de verdad (single source of truth)
  * de calibraciones en el dispositivo. Almacena la estructura en RTC memory (persistente entre deep-sleeps),
  * valida integridad mediante CRC32, permite restaurar valores por defecto, procesar comandos JSON
- * de calibración, exportar la configuración a JSON y aplicar los parámetros a los controladores
+ * de calibración como transacciones atómicas, exportar la configuración a JSON y aplicar los parámetros a los controladores
  * de sensor del sistema (pHSensor, TDSSensor, TurbiditySensor).
  *
  * Características principales:
- *  - Uso de estructura empaquetada en RTC_DATA_ATTR para persistencia.
- *  - CRC32 (esp_crc32_le) para protección frente a corrupción de datos.
+ *  - Uso de estructura empaquetada en RTC_DATA_ATTR como caché de arranque rápido.
+ *  - Registro versionado en NVS (Preferences) que sobrevive a la pérdida de energía;
+ *    se lee solo si el CRC de RTC falla y se escribe solo cuando la calibración cambia.
+ *  - CRC32 (HAL::crc32, esp_crc32_le en el equipo) para protección frente a corrupción de datos.
  *  - Validación de rangos por sensor para evitar configuraciones inválidas.
  *  - API pública para obtener/establecer parámetros y serializar a JSON.
  *  - Logging flexible: Serial o callback externo.
+ *  - Calibración multipunto: puntos en RTC memory y ajuste QR (ver LeastSquares.h).
  *
  * @see CalibrationManager.h
  * @author Daniel Acosta - Santiago Erazo
  * @date 2025-11-18
  */
 #include "CalibrationManager.h"
+#include "Logger.h"
 #include <ArduinoJson.h>
+#include <Preferences.h>
 #include <stdarg.h>
+#include <string.h>
+#include "StaticVector.h"
 #include "pH.h"
 #include "TDS.h"
 #include "Turbidez.h"
 
+static const char TAG[] = "CALIB"; ///< Etiqueta de log del módulo
+
+// ——— Registro en NVS ———
+static const char NVS_NAMESPACE[] = "calib";   ///< Espacio de nombres en NVS
+static const char NVS_KEY[] = "record";        ///< Clave del blob de calibración
+static const uint16_t STORE_MAGIC = 0xCA1B;    ///< Identifica un registro de calibración
+static const uint16_t STORE_VERSION = 1;       ///< Incrementar al cambiar CalibrationData
+
+/**
+ * @brief Registro de calibración guardado en flash.
+ * @details El CRC de `data` cubre los parámetros; magic, versión y tamaño permiten
+ * descartar registros de firmwares con otra disposición de CalibrationData.
+ */
+typedef struct __attribute__((packed)) {
+    uint16_t magic;                             ///< STORE_MAGIC
+    uint16_t version;                           ///< STORE_VERSION
+    uint16_t size;                              ///< sizeof(CalibrationData)
+    CalibrationManager::CalibrationData data;   ///< Copia de la calibración (incluye CRC)
+} StoredCalibration;
+
 // Variable en RTC Memory
 
 /**
  * @brief Estructura de calibración persistente en RTC memory.
  * @details Declarada con RTC_DATA_ATTR para que sobreviva a ciclos de deep sleep/reboot parcial.
  */
-RTC_DATA_ATTR CalibrationManager::CalibrationData rtc_calibration_data;
+HAL_PERSISTENT CalibrationManager::CalibrationData rtc_calibration_data;
 
 /**
  * @brief Puntero a la estructura de calibración utilizada por la clase.
@@ -43,20 +70,42 @@ RTC_DATA_ATTR CalibrationManager::CalibrationData rtc_calibration_data;
  */
 CalibrationManager::CalibrationData* CalibrationManager::_calibData = &rtc_calibration_data;
 
+/**
+ * @brief CRC de la última calibración confirmada igual al registro en NVS.
+ * @details Si difiere del CRC de la copia RTC válida (unidad calibrada antes de existir el
+ * registro en flash, o escritura fallida), begin() la sincroniza una vez con saveToFlash().
+ */
+HAL_PERSISTENT uint32_t rtc_calibration_synced_crc;
+
+/**
+ * @brief Puntos de calibración multipunto registrados por sensor.
+ * @details En RTC memory para que el procedimiento de campo (enjuagar la sonda entre
+ * soluciones patrón) sobreviva a los ciclos de deep sleep intermedios.
+ */
+HAL_PERSISTENT StaticVector<CalibrationManager::CalibrationPoint,
+                           CalibrationManager::MAX_CALIBRATION_POINTS>
+    rtc_calibration_points[CalibrationManager::SENSOR_COUNT];
+
 /**
  * @brief Constructor.
  * @param enableSerial Habilita la salida por Serial (true por defecto).
  */
 CalibrationManager::CalibrationManager(bool enableSerial)
-    : _enableSerialOutput(enableSerial), _initialized(false), _logCallback(nullptr) {
+    : _enableSerialOutput(enableSerial), _initialized(false), _logCallback(nullptr), _lastFit(),
+      _flashDirty(false), _responseIncludesFit(false) {
+    _lastFit.sensor = SENSOR_COUNT;
 }
 
 /**
  * @brief Inicializa el módulo de calibración.
  * @details
  * - Arranca Serial si está habilitado.
- * - Valida integridad de los datos en RTC (CRC + validación de rangos).
- * - Si los datos son inválidos restaura valores por defecto.
+ * - Valida integridad de los datos en RTC (CRC + validación de rangos). En el caso
+ *   común (despertar de deep sleep) no se accede a flash.
+ * - Si los datos RTC son inválidos los recarga desde NVS y, si tampoco hay un registro
+ *   válido, restaura valores por defecto.
+ * - Si son válidos pero nunca se confirmaron contra NVS (rtc_calibration_synced_crc),
+ *   los escribe una vez: una calibración hecha solo en RTC sobrevive al próximo corte.
  * - Aplica la calibración vigente a los sensores inicializados.
  *
  * @return true si el proceso de inicialización terminó (siempre devuelve true en la implementación actual).
@@ -67,15 +116,31 @@ bool CalibrationManager::begin() {
         delay(100);
     }
     
-    log("=== Calibration Manager Inicializado ===");
+    MLOG_I("=== Calibration Manager Inicializado ===");
     
     if (!validateIntegrity()) {
-        log("⚠ Datos inválidos - Restaurando valores por defecto");
-        restoreDefaults();
+        if (loadFromFlash()) {
+            MLOG_W("⚠ Datos RTC inválidos - Calibración recuperada desde flash");
+            MLOG_I("  Actualizaciones: %u", _calibData->update_count);
+        } else {
+            MLOG_W("⚠ Datos inválidos y sin registro en flash - Restaurando valores por defecto");
+            restoreDefaults();
+            rtc_calibration_synced_crc = _calibData->crc; // Nada que persistir
+        }
     } else {
-        log("✓ Datos de calibración válidos");
-        logf("  Última actualización: %u", _calibData->last_update);
-        logf("  Actualizaciones: %u", _calibData->update_count);
+        MLOG_I("✓ Datos de calibración válidos");
+        MLOG_I("  Última actualización: %u", _calibData->last_update);
+        MLOG_I("  Actualizaciones: %u", _calibData->update_count);
+
+        if (rtc_calibration_synced_crc != _calibData->crc) {
+            MLOG_I("  Calibración sin confirmar en flash - sincronizando");
+            _flashDirty = true;
+            saveToFlash(); // Si falla se reintenta en el próximo arranque
+        }
+    }
+    
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        if (!rtc_calibration_points[i].isValid()) rtc_calibration_points[i].clear();
     }
     
     _initialized = true;
@@ -101,7 +166,8 @@ bool CalibrationManager::validateIntegrity() {
         return false;
     }
     
-    return validatePHValues(_calibData->ph_offset, _calibData->ph_slope) &&
+    return _calibData->turb_model <= 1 &&
+        validatePHValues(_calibData->ph_offset, _calibData->ph_slope) &&
         validateTDSValues(_calibData->tds_kvalue, _calibData->tds_voffset) &&
         validateTurbidityValues(_calibData->turb_coeff_a, _calibData->turb_coeff_b,
                                 _calibData->turb_coeff_c, _calibData->turb_coeff_d);
@@ -112,19 +178,121 @@ bool CalibrationManager::validateIntegrity() {
  * @details Actualiza timestamp, contador de actualizaciones y recalcula CRC.
  */
 void CalibrationManager::restoreDefaults() {
-    _calibData->ph_offset = DEFAULT_PH_OFFSET;
-    _calibData->ph_slope = DEFAULT_PH_SLOPE;
-    _calibData->tds_kvalue = DEFAULT_TDS_KVALUE;
-    _calibData->tds_voffset = DEFAULT_TDS_VOFFSET;
-    _calibData->turb_coeff_a = DEFAULT_TURB_A;
-    _calibData->turb_coeff_b = DEFAULT_TURB_B;
-    _calibData->turb_coeff_c = DEFAULT_TURB_C;
-    _calibData->turb_coeff_d = DEFAULT_TURB_D;
+    loadDefaults(*_calibData);
     _calibData->last_update = millis();
     _calibData->update_count = 0;
     updateCRC();
 }
 
+/**
+ * @brief Escribe los parámetros por defecto en una estructura.
+ * @param[out] data Estructura destino; metadatos y CRC no se modifican.
+ */
+void CalibrationManager::loadDefaults(CalibrationData& data) {
+    data.ph_offset = DEFAULT_PH_OFFSET;
+    data.ph_slope = DEFAULT_PH_SLOPE;
+    data.tds_kvalue = DEFAULT_TDS_KVALUE;
+    data.tds_voffset = DEFAULT_TDS_VOFFSET;
+    data.turb_coeff_a = DEFAULT_TURB_A;
+    data.turb_coeff_b = DEFAULT_TURB_B;
+    data.turb_coeff_c = DEFAULT_TURB_C;
+    data.turb_coeff_d = DEFAULT_TURB_D;
+    data.turb_model = 0;
+}
+
+// Persistencia en flash
+
+/**
+ * @brief Recupera la calibración desde NVS hacia RTC memory.
+ * @details Solo se invoca cuando la copia RTC no supera validateIntegrity(). Si el
+ * registro es válido la caché RTC queda idéntica a la flash (mismo CRC).
+ * @return true si se cargó un registro válido.
+ */
+bool CalibrationManager::loadFromFlash() {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, true)) return false;
+    
+    StoredCalibration record;
+    size_t length = prefs.getBytesLength(NVS_KEY);
+    bool ok = (length == sizeof(record)) &&
+              (prefs.getBytes(NVS_KEY, &record, sizeof(record)) == sizeof(record));
+    prefs.end();
+    
+    if (!ok) return false;
+    if (record.magic != STORE_MAGIC || record.version != STORE_VERSION ||
+        record.size != sizeof(CalibrationData)) {
+        MLOG_W("⚠ Registro de calibración en flash de otra versión (v%u) - ignorado",
+               record.version);
+        return false;
+    }
+    
+    CalibrationData backup = *_calibData;
+    *_calibData = record.data;
+    if (!validateIntegrity()) {
+        *_calibData = backup;
+        MLOG_E("⚠ Registro de calibración en flash corrupto (CRC)");
+        return false;
+    }
+    
+    _flashDirty = false;
+    rtc_calibration_synced_crc = _calibData->crc;
+    return true;
+}
+
+/**
+ * @brief Escribe la calibración en NVS solo si cambió.
+ * @details Además de la bandera de cambios, compara los parámetros con el registro
+ * existente para no gastar ciclos de borrado cuando el valor nuevo es igual al guardado
+ * (p. ej. reenviar la misma calibración).
+ * @return true si la flash quedó al día.
+ */
+bool CalibrationManager::saveToFlash() {
+    if (!_flashDirty) return true;
+    
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        MLOG_E("⚠ No se pudo abrir NVS para guardar calibración");
+        return false;
+    }
+    
+    StoredCalibration record;
+    record.magic = STORE_MAGIC;
+    record.version = STORE_VERSION;
+    record.size = sizeof(CalibrationData);
+    record.data = *_calibData;
+    
+    // Solo parámetros: last_update y update_count cambian en cada set*
+    StoredCalibration current;
+    size_t paramsLength = offsetof(CalibrationData, last_update);
+    bool unchanged = prefs.getBytesLength(NVS_KEY) == sizeof(current) &&
+                     prefs.getBytes(NVS_KEY, &current, sizeof(current)) == sizeof(current) &&
+                     current.magic == STORE_MAGIC && current.version == STORE_VERSION &&
+                     memcmp(&current.data, &record.data, paramsLength) == 0;
+    
+    bool ok = unchanged || prefs.putBytes(NVS_KEY, &record, sizeof(record)) == sizeof(record);
+    prefs.end();
+    
+    if (!ok) {
+        MLOG_E("⚠ Error escribiendo calibración en flash");
+        return false;
+    }
+    
+    _flashDirty = false;
+    rtc_calibration_synced_crc = _calibData->crc;
+    if (unchanged) {
+        MLOG_D("Calibración igual a la guardada en flash - sin escritura");
+    } else {
+        MLOG_I("✓ Calibración guardada en flash");
+    }
+    return true;
+}
+
+/**
+ * @brief Consulta si hay cambios de calibración sin escribir en flash.
+ * @return true si la copia RTC difiere de la última escrita.
+ */
+bool CalibrationManager::isFlashDirty() { return _flashDirty; }
+
 // Implementar getters
 
 /**
@@ -165,53 +333,98 @@ void CalibrationManager::getTurbidityCoefficients(float& a, float& b, float& c,
     d = _calibData->turb_coeff_d;
 }
 
-// Setters con validación
+// Transacciones
 
 /**
- * @brief Establece parámetros de calibración para el sensor pH.
- * @details Valida estado inicializado, validez de los parámetros y actualiza CRC.
+ * @brief Devuelve una copia de la calibración vigente.
+ * @return Copia sobre la que preparar cambios para commitCalibration().
+ */
+CalibrationManager::CalibrationData CalibrationManager::getCalibrationData() {
+    return *_calibData;
+}
+
+/**
+ * @brief Confirma una calibración preparada como una sola transacción.
+ * @details
+ * 1. Valida pH, TDS, turbidez y modelo de turbidez sobre la copia; ante cualquier
+ *    fallo no se modifica nada (sin estados mezclados).
+ * 2. Si los parámetros no cambian, termina sin tocar metadatos ni flash.
+ * 3. Copia parámetros, actualiza timestamp/contador y recalcula el CRC una vez.
+ * 4. Aplica a los sensores y escribe en flash una vez.
  *
- * @param offset Nuevo offset de pH.
- * @param slope Nueva pendiente del pH.
- * @return CalibrationResult indicando éxito o tipo de error.
+ * @param staged Calibración deseada.
+ * @return CALIB_SUCCESS, CALIB_ERROR_NOT_INITIALIZED, CALIB_ERROR_OUT_OF_RANGE o
+ * CALIB_ERROR_WRITE_FAILED (aplicada en RTC y sensores, pero no en flash).
  */
-CalibrationManager::CalibrationResult CalibrationManager::setPHCalibration(float offset, float slope) {
+CalibrationManager::CalibrationResult CalibrationManager::commitCalibration(
+    const CalibrationData& staged) {
+    
     if (!_initialized) return CALIB_ERROR_NOT_INITIALIZED;
-    if (!validatePHValues(offset, slope)) return CALIB_ERROR_OUT_OF_RANGE;
     
-    _calibData->ph_offset = offset;
-    _calibData->ph_slope = slope;
+    bool phOk = validatePHValues(staged.ph_offset, staged.ph_slope);
+    bool tdsOk = validateTDSValues(staged.tds_kvalue, staged.tds_voffset);
+    bool turbOk = staged.turb_model <= 1 &&
+                  validateTurbidityValues(staged.turb_coeff_a, staged.turb_coeff_b,
+                                          staged.turb_coeff_c, staged.turb_coeff_d);
+    if (!phOk || !tdsOk || !turbOk) {
+        MLOG_E("⚠ Calibración rechazada (pH:%s TDS:%s Turb:%s) - sin cambios",
+               phOk ? "ok" : "inválido", tdsOk ? "ok" : "inválido", turbOk ? "ok" : "inválido");
+        return CALIB_ERROR_OUT_OF_RANGE;
+    }
+    
+    size_t paramsLength = offsetof(CalibrationData, last_update);
+    if (memcmp(&staged, _calibData, paramsLength) == 0) {
+        MLOG_I("✓ Calibración sin cambios");
+        return CALIB_SUCCESS;
+    }
+    
+    memcpy(_calibData, &staged, paramsLength);
     _calibData->last_update = millis();
     _calibData->update_count++;
     updateCRC();
+    _flashDirty = true;
     
-    logf("✓ pH calibrado: offset=%.2f, slope=%.2f", offset, slope);
-    return CALIB_SUCCESS;
+    MLOG_I("✓ Calibración confirmada (actualización #%u)", _calibData->update_count);
+    applyToSensors();
+    return saveToFlash() ? CALIB_SUCCESS : CALIB_ERROR_WRITE_FAILED;
+}
+
+// Setters con validación
+
+/**
+ * @brief Establece parámetros de calibración para el sensor pH.
+ * @details Transacción de un solo grupo sobre commitCalibration().
+ *
+ * @param offset Nuevo offset de pH.
+ * @param slope Nueva pendiente del pH.
+ * @return CalibrationResult indicando éxito o tipo de error.
+ */
+CalibrationManager::CalibrationResult CalibrationManager::setPHCalibration(float offset, float slope) {
+    CalibrationData staged = *_calibData;
+    staged.ph_offset = offset;
+    staged.ph_slope = slope;
+    return commitCalibration(staged);
 }
 
 
 /**
  * @brief Establece parámetros de calibración para el sensor TDS.
+ * @details Transacción de un solo grupo sobre commitCalibration().
  * @param kvalue Nuevo valor K.
  * @param voffset Nuevo offset de voltaje.
  * @return CalibrationResult indicando resultado.
  */
 CalibrationManager::CalibrationResult CalibrationManager::setTDSCalibration(float kvalue, float voffset) {
-    if (!_initialized) return CALIB_ERROR_NOT_INITIALIZED;
-    if (!validateTDSValues(kvalue, voffset)) return CALIB_ERROR_OUT_OF_RANGE;
-    
-    _calibData->tds_kvalue = kvalue;
-    _calibData->tds_voffset = voffset;
-    _calibData->last_update = millis();
-    _calibData->update_count++;
-    updateCRC();
-    
-    logf("✓ TDS calibrado: k=%.6f, v=%.6f", kvalue, voffset);
-    return CALIB_SUCCESS;
+    CalibrationData staged = *_calibData;
+    staged.tds_kvalue = kvalue;
+    staged.tds_voffset = voffset;
+    return commitCalibration(staged);
 }
 
 /**
  * @brief Establece los coeficientes del modelo polinomial para turbidez.
+ * @details Transacción de un solo grupo sobre commitCalibration(); conserva el
+ * modelo (segmentado/polinomio) vigente.
  * @param a Coeficiente A.
  * @param b Coeficiente B.
  * @param c Coeficiente C.
@@ -221,19 +434,12 @@ CalibrationManager::CalibrationResult CalibrationManager::setTDSCalibration(floa
 CalibrationManager::CalibrationResult CalibrationManager::setTurbidityCoefficients(
     float a, float b, float c, float d) {
     
-    if (!_initialized) return CALIB_ERROR_NOT_INITIALIZED;
-    if (!validateTurbidityValues(a, b, c, d)) return CALIB_ERROR_OUT_OF_RANGE;
-    
-    _calibData->turb_coeff_a = a;
-    _calibData->turb_coeff_b = b;
-    _calibData->turb_coeff_c = c;
-    _calibData->turb_coeff_d = d;
-    _calibData->last_update = millis();
-    _calibData->update_count++;
-    updateCRC();
-    
-    logf("✓ Turbidez calibrada: a=%.1f, b=%.1f, c=%.1f, d=%.1f", a, b, c, d);
-    return CALIB_SUCCESS;
+    CalibrationData staged = *_calibData;
+    staged.turb_coeff_a = a;
+    staged.turb_coeff_b = b;
+    staged.turb_coeff_c = c;
+    staged.turb_coeff_d = d;
+    return commitCalibration(staged);
 }
 
 // Validaciones
@@ -289,7 +495,7 @@ bool CalibrationManager::validateTurbidityValues(float a, float b, float c, floa
 // Procesamiento de comandos JSON
 
 /**
- * @brief Procesa un comando JSON para calibración.
+ * @brief Procesa un comando JSON para calibración, analizándolo en su propio buffer.
  *
  * @details JSON esperado (ejemplo):
  * {
@@ -306,116 +512,409 @@ bool CalibrationManager::validateTurbidityValues(float a, float b, float c, floa
  * }
  *
  * - Los campos son opcionales; si faltan se mantienen los valores actuales.
- * - Si se envía "restore_defaults": true, se restauran los valores por defecto.
+ * - Todos los campos se preparan sobre una copia y se confirman juntos: si un grupo
+ *   es inválido no se aplica ninguno.
+ * - Si se envía "restore_defaults": true, se restauran los valores por defecto
+ *   (tiene prioridad sobre los demás campos).
+ * - {"action": "get_calibration"} no modifica nada; la respuesta lleva la calibración.
  *
- * @param jsonCommand Cadena JSON con la instrucción.
+ * Calibración multipunto ("sensor": "ph" | "tds" | "turb"):
+ * - {"action": "calib_point", "sensor": "ph", "reference": 7.0, "voltage": 1.62}
+ *   registra un punto; sin "voltage" se mide con el sensor. "temperature" (°C) aplica a TDS.
+ * - {"action": "calib_fit", "sensor": "ph", "apply": true} ajusta el modelo y, si
+ *   "apply" (por defecto true), guarda los coeficientes. Ver getFitReportJSON().
+ * - {"action": "calib_clear", "sensor": "ph"} descarta los puntos (sin "sensor": todos).
+ *
+ * @param json Buffer con el JSON; se modifica durante el análisis (modo sin copia).
+ * @param length Longitud del JSON.
  * @return CalibrationResult indicando éxito o tipo de error.
+ * @see getResponseJSON() para construir la respuesta.
  */
 CalibrationManager::CalibrationResult CalibrationManager::processCalibrationCommand(
-    const String& jsonCommand) {
+    char* json, size_t length) {
+    
+    _responseIncludesFit = false;
     
     StaticJsonDocument<512> doc;
-    DeserializationError error = deserializeJson(doc, jsonCommand);
+    DeserializationError error = deserializeJson(doc, json, length);
     
     if (error) {
-        logf("⚠ Error JSON: %s", error.c_str());
+        MLOG_E("⚠ Error JSON: %s", error.c_str());
         return CALIB_ERROR_INVALID_VALUE;
     }
     
-    if (!doc.containsKey("action") || doc["action"] != "calibrate") {
+    const char* action = doc["action"] | "";
+    
+    if (strcmp(action, "get_calibration") == 0) {
+        return _initialized ? CALIB_SUCCESS : CALIB_ERROR_NOT_INITIALIZED;
+    }
+    
+    // Calibración multipunto
+    if (strncmp(action, "calib_", 6) == 0) {
+        CalibrationSensor sensor = doc.containsKey("sensor") ?
+                    parseSensor(doc["sensor"] | "") : SENSOR_COUNT;
+        
+        if (strcmp(action, "calib_clear") == 0) {
+            if (doc.containsKey("sensor") && sensor == SENSOR_COUNT) return CALIB_ERROR_INVALID_VALUE;
+            clearCalibrationPoints(sensor);
+            return CALIB_SUCCESS;
+        }
+        if (sensor == SENSOR_COUNT) {
+            MLOG_E("⚠ Sensor de calibración no reconocido");
+            return CALIB_ERROR_INVALID_VALUE;
+        }
+        if (strcmp(action, "calib_point") == 0) {
+            return addCalibrationPoint(sensor, doc["reference"] | NAN,
+                                       doc["voltage"] | NAN, doc["temperature"] | 25.0f);
+        }
+        if (strcmp(action, "calib_fit") == 0) {
+            _responseIncludesFit = true;
+            return fitCalibration(sensor, doc["apply"] | true);
+        }
         return CALIB_ERROR_INVALID_VALUE;
     }
     
-    log("📝 Procesando calibración...");
+    if (strcmp(action, "calibrate") != 0) {
+        return CALIB_ERROR_INVALID_VALUE;
+    }
     
-    CalibrationResult result = CALIB_SUCCESS;
-    bool anyUpdated = false;
+    MLOG_I("📝 Procesando calibración...");
     
-    // pH
-    if (doc.containsKey("ph_offset") || doc.containsKey("ph_slope")) {
-        float offset = doc.containsKey("ph_offset") ? 
-                    doc["ph_offset"].as<float>() : _calibData->ph_offset;
-        float slope = doc.containsKey("ph_slope") ? 
-                    doc["ph_slope"].as<float>() : _calibData->ph_slope;
-        
-        result = setPHCalibration(offset, slope);
-        if (result == CALIB_SUCCESS) {
-            anyUpdated = true;
-            pHSensor::setCalibration(offset, slope);
-        }
+    CalibrationData staged = *_calibData;
+    
+    if (doc["restore_defaults"] | false) {
+        loadDefaults(staged);
+    } else {
+        staged.ph_offset = doc["ph_offset"] | staged.ph_offset;
+        staged.ph_slope = doc["ph_slope"] | staged.ph_slope;
+        staged.tds_kvalue = doc["tds_kvalue"] | staged.tds_kvalue;
+        staged.tds_voffset = doc["tds_voffset"] | staged.tds_voffset;
+        staged.turb_coeff_a = doc["turb_coeff_a"] | staged.turb_coeff_a;
+        staged.turb_coeff_b = doc["turb_coeff_b"] | staged.turb_coeff_b;
+        staged.turb_coeff_c = doc["turb_coeff_c"] | staged.turb_coeff_c;
+        staged.turb_coeff_d = doc["turb_coeff_d"] | staged.turb_coeff_d;
     }
     
-    // TDS
-    if (doc.containsKey("tds_kvalue") || doc.containsKey("tds_voffset")) {
-        float kvalue = doc.containsKey("tds_kvalue") ? 
-                    doc["tds_kvalue"].as<float>() : _calibData->tds_kvalue;
-        float voffset = doc.containsKey("tds_voffset") ? 
-                    doc["tds_voffset"].as<float>() : _calibData->tds_voffset;
-        
-        result = setTDSCalibration(kvalue, voffset);
-        if (result == CALIB_SUCCESS) {
-            anyUpdated = true;
-            TDSSensor::setCalibration(kvalue, voffset);
-        }
+    uint16_t previousCount = _calibData->update_count;
+    CalibrationResult result = commitCalibration(staged);
+    
+    if (_calibData->update_count != previousCount) {
+        printCalibrationInfo();
     }
     
-    // Turbidez
-    if (doc.containsKey("turb_coeff_a") || doc.containsKey("turb_coeff_b") ||
-        doc.containsKey("turb_coeff_c") || doc.containsKey("turb_coeff_d")) {
-        
-        float a = doc.containsKey("turb_coeff_a") ? 
-                doc["turb_coeff_a"].as<float>() : _calibData->turb_coeff_a;
-        float b = doc.containsKey("turb_coeff_b") ? 
-                doc["turb_coeff_b"].as<float>() : _calibData->turb_coeff_b;
-        float c = doc.containsKey("turb_coeff_c") ? 
-                doc["turb_coeff_c"].as<float>() : _calibData->turb_coeff_c;
-        float d = doc.containsKey("turb_coeff_d") ? 
-                doc["turb_coeff_d"].as<float>() : _calibData->turb_coeff_d;
-        
-        result = setTurbidityCoefficients(a, b, c, d);
-        if (result == CALIB_SUCCESS) {
-            anyUpdated = true;
-            TurbiditySensor::setCalibrationCoefficients(a, b, c, d);
+    return result;
+}
+
+/**
+ * @brief Construye la respuesta a un comando en un único JSON.
+ * @details La calibración vigente siempre se incluye (también ante errores, para que
+ * la interfaz muestre el estado real). Tras "calib_fit" se agrega "fit".
+ *
+ * @param result Resultado del comando.
+ * @param buffer Destino.
+ * @param size Tamaño del destino.
+ * @return Longitud completa del JSON (semántica de snprintf).
+ */
+size_t CalibrationManager::getResponseJSON(CalibrationResult result, char* buffer, size_t size) {
+    StaticJsonDocument<1024> doc;
+    
+    doc["status"] = (result == CALIB_SUCCESS) ? "success" : "error";
+    doc["code"] = (int)result;
+    doc["message"] = resultMessage(result);
+    fillCalibrationJSON(doc.createNestedObject("calibration"));
+    
+    if (_responseIncludesFit) {
+        fillFitJSON(doc.createNestedObject("fit"));
+    }
+    
+    serializeJson(doc, buffer, size);
+    return measureJson(doc);
+}
+
+/**
+ * @brief Descripción corta de un resultado.
+ * @param result Resultado de calibración.
+ * @return Literal estático.
+ */
+const char* CalibrationManager::resultMessage(CalibrationResult result) {
+    static const char* const MESSAGES[] = {
+        "Calibración aplicada",
+        "Valor o comando inválido",
+        "Valores fuera de rango",
+        "Error de integridad (CRC)",
+        "Error escribiendo en flash",
+        "Calibración no inicializada",
+        "Puntos insuficientes",
+        "Puntos mal condicionados"
+    };
+    return ((unsigned)result < sizeof(MESSAGES) / sizeof(MESSAGES[0])) ? MESSAGES[result] : "Error";
+}
+
+// Calibración multipunto
+
+/**
+ * @brief Registra un punto de calibración para un sensor.
+ * @details Si voltage es NAN se mide en este momento con el sensor (bloqueante:
+ * ~10 s en pH). Para TDS se guarda el voltaje crudo, sin restar voffset.
+ *
+ * @param sensor Sensor al que pertenece el punto.
+ * @param reference Valor de la solución patrón.
+ * @param voltage Voltaje medido o NAN.
+ * @param temperature Temperatura de la solución (°C).
+ * @return CALIB_SUCCESS, CALIB_ERROR_INVALID_VALUE o CALIB_ERROR_WRITE_FAILED si no caben más puntos.
+ */
+CalibrationManager::CalibrationResult CalibrationManager::addCalibrationPoint(
+    CalibrationSensor sensor, float reference, float voltage, float temperature) {
+    
+    if (!_initialized) return CALIB_ERROR_NOT_INITIALIZED;
+    if (sensor >= SENSOR_COUNT) return CALIB_ERROR_INVALID_VALUE;
+    
+    if (isnan(voltage)) {
+        switch (sensor) {
+            case SENSOR_PH:        voltage = pHSensor::measureVoltage(); break;
+            case SENSOR_TDS:       voltage = TDSSensor::measureVoltage(); break;
+            case SENSOR_TURBIDITY: voltage = TurbiditySensor::measureVoltage(); break;
+            default: break;
         }
     }
     
-    // Restaurar defaults
-    if (doc.containsKey("restore_defaults") && doc["restore_defaults"].as<bool>()) {
-        restoreDefaults();
-        applyToSensors();
-        anyUpdated = true;
+    if (!isfinite(voltage) || !isfinite(reference) || !isfinite(temperature)) {
+        MLOG_E("⚠ Punto %s inválido (¿sensor sin inicializar o falta \"reference\"?)",
+               sensorName(sensor));
+        return CALIB_ERROR_INVALID_VALUE;
+    }
+    
+    CalibrationPoint point = { voltage, reference, temperature };
+    if (!rtc_calibration_points[sensor].push_back(point)) {
+        MLOG_W("⚠ Máximo de %u puntos %s alcanzado", MAX_CALIBRATION_POINTS, sensorName(sensor));
+        return CALIB_ERROR_WRITE_FAILED;
     }
     
-    if (anyUpdated) {
-        log("✓ Calibración actualizada");
-        printCalibrationInfo();
+    MLOG_I("✓ Punto %s #%u: V=%.4f, ref=%.3f, T=%.1f", sensorName(sensor),
+           (unsigned)rtc_calibration_points[sensor].size(), voltage, reference, temperature);
+    return CALIB_SUCCESS;
+}
+
+/**
+ * @brief Ajusta el modelo de un sensor con sus puntos registrados.
+ * @details
+ * - pH: recta pH = slope·V + offset (≥ 2 puntos).
+ * - TDS: factor k con el voffset vigente, TDS = k·TDS_base(V, T) (≥ 1 punto).
+ * - Turbidez: cúbica NTU = a·V³ + b·V² + c·V + d (≥ 4 puntos) que sustituye al
+ *   algoritmo segmentado.
+ *
+ * Los residuos y métricas se calculan con los coeficientes en float finales. Con
+ * apply, los coeficientes se confirman con commitCalibration() (misma validación de
+ * rangos que un comando "calibrate").
+ *
+ * @param sensor Sensor a ajustar.
+ * @param apply true para guardar los coeficientes.
+ * @return Resultado del ajuste o de la validación.
+ */
+CalibrationManager::CalibrationResult CalibrationManager::fitCalibration(
+    CalibrationSensor sensor, bool apply) {
+    
+    if (!_initialized) return CALIB_ERROR_NOT_INITIALIZED;
+    if (sensor >= SENSOR_COUNT) return CALIB_ERROR_INVALID_VALUE;
+    
+    memset(&_lastFit, 0, sizeof(_lastFit));
+    _lastFit.sensor = sensor;
+    
+    const auto& points = rtc_calibration_points[sensor];
+    size_t n = points.size();
+    float x[MAX_CALIBRATION_POINTS];
+    float y[MAX_CALIBRATION_POINTS];
+    for (size_t i = 0; i < n; i++) {
+        x[i] = (sensor == SENSOR_TDS)
+            ? TDSSensor::baseTDSFromVoltage(points[i].voltage, _calibData->tds_voffset,
+                                            points[i].temperature)
+            : points[i].voltage;
+        y[i] = points[i].reference;
+    }
+    
+    LeastSquares::Status status;
+    if (sensor == SENSOR_TDS) {
+        status = LeastSquares::fitScale(x, y, n, &_lastFit.coeffs[0],
+                                        _lastFit.residuals, &_lastFit.stats);
+    } else {
+        uint8_t degree = (sensor == SENSOR_PH) ? 1 : 3;
+        status = LeastSquares::fitPolynomial(x, y, n, degree, _lastFit.coeffs,
+                                             _lastFit.residuals, &_lastFit.stats);
+    }
+    
+    CalibrationResult result;
+    switch (status) {
+        case LeastSquares::LSQ_OK:                  result = CALIB_SUCCESS; break;
+        case LeastSquares::LSQ_INSUFFICIENT_POINTS: result = CALIB_ERROR_INSUFFICIENT_POINTS; break;
+        case LeastSquares::LSQ_ILL_CONDITIONED:     result = CALIB_ERROR_ILL_CONDITIONED; break;
+        default:                                    result = CALIB_ERROR_INVALID_VALUE; break;
     }
+    _lastFit.result = result;
     
+    if (result != CALIB_SUCCESS) {
+        MLOG_E("⚠ Ajuste %s falló (%s) con %u puntos", sensorName(sensor),
+               LeastSquares::statusName(status), (unsigned)n);
+        return result;
+    }
+    
+    MLOG_I("✓ Ajuste %s: n=%u, RMSE=%.4f, max|r|=%.4f, R²=%.5f", sensorName(sensor),
+           _lastFit.stats.n, _lastFit.stats.rmse, _lastFit.stats.maxAbsResidual, _lastFit.stats.r2);
+    if (_lastFit.stats.n == _lastFit.stats.terms) {
+        MLOG_W("  Ajuste exacto: sin puntos sobrantes para evaluar residuos");
+    }
+    for (size_t i = 0; i < n; i++) {
+        MLOG_D("  #%u V=%.4f ref=%.3f r=%+.4f", (unsigned)(i + 1), points[i].voltage,
+               points[i].reference, _lastFit.residuals[i]);
+    }
+    
+    if (!apply) return CALIB_SUCCESS;
+    
+    const float* c = _lastFit.coeffs;
+    CalibrationData staged = *_calibData;
+    switch (sensor) {
+        case SENSOR_PH:
+            staged.ph_offset = c[0];
+            staged.ph_slope = c[1];
+            break;
+        case SENSOR_TDS:
+            staged.tds_kvalue = c[0];
+            break;
+        default:
+            staged.turb_coeff_a = c[3];
+            staged.turb_coeff_b = c[2];
+            staged.turb_coeff_c = c[1];
+            staged.turb_coeff_d = c[0];
+            staged.turb_model = 1;
+            break;
+    }
+    
+    result = commitCalibration(staged);
+    _lastFit.result = result;
+    _lastFit.applied = (result == CALIB_SUCCESS || result == CALIB_ERROR_WRITE_FAILED);
+    
+    if (!_lastFit.applied) {
+        MLOG_E("⚠ Coeficientes %s fuera de rango: no se aplican", sensorName(sensor));
+    }
     return result;
 }
 
 /**
- * @brief Serializa la configuración de calibración a JSON.
- * @return String conteniendo JSON con todos los parámetros y metadatos.
+ * @brief Descarta los puntos registrados.
+ * @param sensor Sensor a limpiar, o SENSOR_COUNT para todos.
  */
-String CalibrationManager::getCalibrationJSON() {
+void CalibrationManager::clearCalibrationPoints(CalibrationSensor sensor) {
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        if (sensor == SENSOR_COUNT || sensor == i) rtc_calibration_points[i].clear();
+    }
+    MLOG_I("✓ Puntos de calibración descartados (%s)",
+           sensor == SENSOR_COUNT ? "todos" : sensorName(sensor));
+}
+
+/**
+ * @brief Número de puntos registrados para un sensor.
+ * @param sensor Sensor consultado.
+ * @return Cantidad de puntos (0 si el sensor no es válido).
+ */
+uint8_t CalibrationManager::getCalibrationPointCount(CalibrationSensor sensor) {
+    return (sensor < SENSOR_COUNT) ? (uint8_t)rtc_calibration_points[sensor].size() : 0;
+}
+
+/**
+ * @brief Devuelve el último ajuste multipunto.
+ * @return Referencia al informe; sensor == SENSOR_COUNT si aún no hubo ajuste.
+ */
+const CalibrationManager::FitReport& CalibrationManager::getLastFit() { return _lastFit; }
+
+/**
+ * @brief Serializa el último ajuste a JSON en un buffer del llamador.
+ * @details Ejemplo: {"sensor":"ph","result":0,"applied":true,"n":3,
+ * "coeffs":[1.33,3.5],"rmse":0.01,"max_residual":0.02,"r2":0.9998,"residuals":[...]}
+ *
+ * @param buffer Destino.
+ * @param size Tamaño del destino.
+ * @return Longitud completa del JSON (semántica de snprintf).
+ */
+size_t CalibrationManager::getFitReportJSON(char* buffer, size_t size) {
     StaticJsonDocument<512> doc;
+    fillFitJSON(doc.to<JsonObject>());
+    serializeJson(doc, buffer, size);
+    return measureJson(doc);
+}
+
+/**
+ * @brief Agrega el último ajuste a un objeto JSON.
+ * @param obj Objeto destino (raíz del informe o "fit" de la respuesta).
+ */
+void CalibrationManager::fillFitJSON(JsonObject obj) {
+    const FitReport& r = _lastFit;
     
-    doc["ph_offset"] = _calibData->ph_offset;
-    doc["ph_slope"] = _calibData->ph_slope;
-    doc["tds_kvalue"] = _calibData->tds_kvalue;
-    doc["tds_voffset"] = _calibData->tds_voffset;
-    doc["turb_coeff_a"] = _calibData->turb_coeff_a;
-    doc["turb_coeff_b"] = _calibData->turb_coeff_b;
-    doc["turb_coeff_c"] = _calibData->turb_coeff_c;
-    doc["turb_coeff_d"] = _calibData->turb_coeff_d;
-    doc["last_update"] = _calibData->last_update;
-    doc["update_count"] = _calibData->update_count;
-    doc["crc"] = _calibData->crc;
+    obj["sensor"] = (r.sensor < SENSOR_COUNT) ? sensorName((CalibrationSensor)r.sensor) : "none";
+    if (r.sensor >= SENSOR_COUNT) return;
     
-    String output;
-    serializeJson(doc, output);
-    return output;
+    obj["result"] = r.result;
+    obj["applied"] = r.applied;
+    obj["n"] = r.stats.n;
+    JsonArray coeffs = obj.createNestedArray("coeffs");
+    for (uint8_t i = 0; i < r.stats.terms; i++) coeffs.add(r.coeffs[i]);
+    obj["rmse"] = r.stats.rmse;
+    obj["max_residual"] = r.stats.maxAbsResidual;
+    obj["r2"] = r.stats.r2;
+    JsonArray residuals = obj.createNestedArray("residuals");
+    for (uint8_t i = 0; i < r.stats.n; i++) residuals.add(r.residuals[i]);
+}
+
+/**
+ * @brief Nombre corto de un sensor de calibración.
+ * @param sensor Sensor.
+ * @return "ph", "tds", "turb" o "?".
+ */
+const char* CalibrationManager::sensorName(CalibrationSensor sensor) {
+    static const char* const NAMES[SENSOR_COUNT] = { "ph", "tds", "turb" };
+    return (sensor < SENSOR_COUNT) ? NAMES[sensor] : "?";
+}
+
+/**
+ * @brief Interpreta el nombre de sensor recibido en un comando.
+ * @param name "ph", "tds" o "turb".
+ * @return Sensor correspondiente o SENSOR_COUNT si no se reconoce.
+ */
+CalibrationManager::CalibrationSensor CalibrationManager::parseSensor(const char* name) {
+    for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+        if (strcmp(name, sensorName((CalibrationSensor)i)) == 0) return (CalibrationSensor)i;
+    }
+    return SENSOR_COUNT;
+}
+
+/**
+ * @brief Agrega parámetros y metadatos de calibración a un objeto JSON.
+ * @param obj Objeto destino (p. ej. "calibration" de la respuesta).
+ */
+void CalibrationManager::fillCalibrationJSON(JsonObject obj) {
+    obj["ph_offset"] = _calibData->ph_offset;
+    obj["ph_slope"] = _calibData->ph_slope;
+    obj["tds_kvalue"] = _calibData->tds_kvalue;
+    obj["tds_voffset"] = _calibData->tds_voffset;
+    obj["turb_coeff_a"] = _calibData->turb_coeff_a;
+    obj["turb_coeff_b"] = _calibData->turb_coeff_b;
+    obj["turb_coeff_c"] = _calibData->turb_coeff_c;
+    obj["turb_coeff_d"] = _calibData->turb_coeff_d;
+    obj["turb_model"] = _calibData->turb_model;
+    obj["last_update"] = _calibData->last_update;
+    obj["update_count"] = _calibData->update_count;
+    obj["crc"] = _calibData->crc;
+}
+
+/**
+ * @brief Serializa la configuración de calibración a JSON en un buffer del llamador.
+ * @param buffer Destino.
+ * @param size Tamaño del destino.
+ * @return Longitud completa del JSON (semántica de snprintf).
+ */
+size_t CalibrationManager::getCalibrationJSON(char* buffer, size_t size) {
+    StaticJsonDocument<512> doc;
+    fillCalibrationJSON(doc.to<JsonObject>());
+    serializeJson(doc, buffer, size);
+    return measureJson(doc);
 }
 
 /**
@@ -423,14 +922,15 @@ String CalibrationManager::getCalibrationJSON() {
  * @details Incluye parámetros por sensor, contador de actualizaciones y CRC.
  */
 void CalibrationManager::printCalibrationInfo() {
-    log("\n=== VALORES DE CALIBRACIÓN ===");
-    logf("pH: offset=%.2f, slope=%.2f", _calibData->ph_offset, _calibData->ph_slope);
-    logf("TDS: k=%.6f, v=%.6f", _calibData->tds_kvalue, _calibData->tds_voffset);
-    logf("Turb: a=%.1f, b=%.1f, c=%.1f, d=%.1f", 
+    MLOG_I("\n=== VALORES DE CALIBRACIÓN ===");
+    MLOG_I("pH: offset=%.2f, slope=%.2f", _calibData->ph_offset, _calibData->ph_slope);
+    MLOG_I("TDS: k=%.6f, v=%.6f", _calibData->tds_kvalue, _calibData->tds_voffset);
+    MLOG_I("Turb: a=%.1f, b=%.1f, c=%.1f, d=%.1f (%s)", 
         _calibData->turb_coeff_a, _calibData->turb_coeff_b,
-        _calibData->turb_coeff_c, _calibData->turb_coeff_d);
-    logf("Updates: %u, CRC: 0x%08X", _calibData->update_count, _calibData->crc);
-    log("==============================\n");
+        _calibData->turb_coeff_c, _calibData->turb_coeff_d,
+        _calibData->turb_model ? "polinomio" : "segmentado");
+    MLOG_I("Updates: %u, CRC: 0x%08X", _calibData->update_count, _calibData->crc);
+    MLOG_I("==============================\n");
 }
 
 
@@ -452,7 +952,7 @@ uint16_t CalibrationManager::getUpdateCount() { return _calibData->update_count;
  * @details Usa las APIs públicas de pHSensor, TDSSensor y TurbiditySensor.
  */
 void CalibrationManager::applyToSensors() {
-    log("🔧 Aplicando calibración a sensores...");
+    MLOG_I("🔧 Aplicando calibración a sensores...");
     
     if (pHSensor::isInitialized()) {
         pHSensor::setCalibration(_calibData->ph_offset, _calibData->ph_slope);
@@ -467,9 +967,10 @@ void CalibrationManager::applyToSensors() {
             _calibData->turb_coeff_a, _calibData->turb_coeff_b,
             _calibData->turb_coeff_c, _calibData->turb_coeff_d
         );
+        TurbiditySensor::setPolynomialModel(_calibData->turb_model != 0);
     }
     
-    log("✓ Calibración aplicada");
+    MLOG_I("✓ Calibración aplicada");
 }
 
 
@@ -507,32 +1008,30 @@ void CalibrationManager::updateCRC() {
  * @return CRC32 calculado.
  */
 uint32_t CalibrationManager::calculateCRC32(const void* data, size_t length) {
-    return esp_crc32_le(0xFFFFFFFF, (const uint8_t*)data, length) ^ 0xFFFFFFFF;
+    return HAL::crc32(0xFFFFFFFF, (const uint8_t*)data, length) ^ 0xFFFFFFFF;
 }
 
 
+// Métodos privados de logging
 /**
- * @brief Entrega un mensaje de log ya sea al callback registrado o a Serial si está habilitado.
- * @param message Texto plano a emitir.
+ * @brief Envía un mensaje de log con formato estilo printf.
+ * @param level Nivel LOG_LEVEL_* del mensaje.
+ * @param format Cadena de formato printf.
+ * @param ... Argumentos variables para format.
+ * @note Si hay callback registrado se formatea aquí y se le entrega la línea;
+ *       en caso contrario se delega en Logger (modo texto o binario).
+ * @note Se invoca a través de las macros MLOG_*, que eliminan en compilación
+ *       los niveles por encima de LOG_LEVEL.
  */
-void CalibrationManager::log(const char* message) {
-    if (_logCallback) {
-        _logCallback(message);
-    } else if (_enableSerialOutput && Serial) {
-        Serial.println(message);
-    }
-}
-
-/**
- * @brief Formatea y envía un log tipo printf.
- * @param format Formato estilo printf.
- * @param ... Argumentos variables.
- */
-void CalibrationManager::logf(const char* format, ...) {
-    char buffer[256];
+void CalibrationManager::logf(uint8_t level, const char* format, ...) {
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    if (_logCallback) {
+        char buffer[LOG_LINE_MAX];
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        _logCallback(buffer);
+    } else if (_enableSerialOutput) {
+        Logger::vwrite(level, TAG, format, args);
+    }
     va_end(args);
-    log(buffer);
-}
\ No newline at end of file
+}
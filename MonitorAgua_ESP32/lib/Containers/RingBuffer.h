@@ -0,0 +1,121 @@
+/**
+ * @file RingBuffer.h
+ * @brief Buffer circular de capacidad fija, apto para RTC Memory.
+ * @details Plantilla sin constructores ni memoria dinámica: es un agregado trivial,
+ *          por lo que una variable RTC_DATA_ATTR conserva su contenido al despertar
+ *          de deep sleep (no se ejecuta inicialización dinámica) y puede protegerse
+ *          con CRC como un bloque de bytes.
+ *
+ *          Si N es potencia de 2 el índice se envuelve con máscara; en otro caso con
+ *          una resta condicional (nunca con división), de modo que capacidades como
+ *          160 lecturas no obligan a reservar 256 posiciones en los 8 KB de RTC.
+ *
+ *          push() sobrescribe el elemento más antiguo cuando el buffer está lleno.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+/**
+ * @brief Buffer circular de N elementos de tipo T.
+ * @tparam T Tipo trivialmente copiable (structs empaquetados incluidos)
+ * @tparam N Capacidad (1..65535)
+ * @note Los miembros son públicos para mantener el tipo como agregado; usar
+ *       siempre los métodos. Llamar clear() en la primera ejecución.
+ */
+template <typename T, size_t N>
+struct RingBuffer {
+    static_assert(N > 0 && N <= 0xFFFF, "RingBuffer: capacidad fuera de rango");
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "RingBuffer: T debe ser trivialmente copiable (RTC Memory / memcpy)");
+
+    T items[N];      ///< Almacenamiento
+    uint16_t head;   ///< Próxima posición de escritura
+    uint16_t count;  ///< Elementos válidos (≤ N)
+
+    // ——— Capacidad ———
+    static constexpr size_t capacity() { return N; }
+    static constexpr bool isPowerOfTwo() { return (N & (N - 1)) == 0; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == N; }
+
+    /**
+     * @brief Vacía el buffer (no borra el almacenamiento).
+     */
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    /**
+     * @brief Verifica que los índices sean coherentes (p. ej. tras despertar).
+     * @return false si head o count están fuera de rango
+     */
+    bool isValid() const { return head < N && count <= N; }
+
+    // ——— Escritura ———
+
+    /**
+     * @brief Posición que ocupará el próximo elemento.
+     * @details Permite escribir y verificar en sitio antes de confirmar con commit().
+     */
+    T& slot() { return items[head]; }
+
+    /**
+     * @brief Confirma el elemento escrito en slot().
+     */
+    void commit() {
+        head = (uint16_t)wrap((size_t)head + 1);
+        if (count < N) count++;
+    }
+
+    /**
+     * @brief Inserta un elemento, sobrescribiendo el más antiguo si está lleno.
+     */
+    void push(const T& value) {
+        memcpy((void*)&items[head], (const void*)&value, sizeof(T));
+        commit();
+    }
+
+    // ——— Lectura ———
+
+    /**
+     * @brief Índice físico del i-ésimo elemento más reciente (0 = último).
+     * @pre i < size()
+     */
+    size_t recentIndex(size_t i) const { return wrap((size_t)head + N - 1 - i); }
+
+    /**
+     * @brief i-ésimo elemento más reciente (0 = último insertado).
+     * @pre i < size()
+     */
+    const T& recent(size_t i) const { return items[recentIndex(i)]; }
+    T& recent(size_t i) { return items[recentIndex(i)]; }
+
+    /**
+     * @brief i-ésimo elemento en orden cronológico (0 = más antiguo).
+     * @pre i < size()
+     */
+    const T& operator[](size_t i) const { return items[wrap((size_t)head + N - count + i)]; }
+    T& operator[](size_t i) { return items[wrap((size_t)head + N - count + i)]; }
+
+    /**
+     * @brief Envuelve un índice en [0, N).
+     * @pre i < 2N (siempre se cumple desde los métodos públicos)
+     */
+    static size_t wrap(size_t i) {
+        return isPowerOfTwo() ? (i & (N - 1)) : (i >= N ? i - N : i);
+    }
+};
+
+#endif // RING_BUFFER_H
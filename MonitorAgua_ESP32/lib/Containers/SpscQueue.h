@@ -0,0 +1,79 @@
+/**
+ * @file SpscQueue.h
+ * @brief Cola sin bloqueo de un productor y un consumidor.
+ * @details Pensada para pasar datos de una ISR o tarea a otra tarea sin mutex.
+ *          Los contadores de lectura y escritura avanzan libremente y se enmascaran
+ *          al indexar, por lo que N debe ser potencia de 2 y caben exactamente N
+ *          elementos. Cada índice lo modifica un solo lado: el productor publica con
+ *          release y el consumidor observa con acquire.
+ *
+ *          Con más de un productor usar un mecanismo de exclusión (ver Logger.cpp).
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <type_traits>
+
+/**
+ * @brief Cola SPSC de N elementos de tipo T.
+ * @tparam T Tipo trivialmente copiable
+ * @tparam N Capacidad, potencia de 2
+ * @note Declarar como variable global/estática (queda en cero, es decir vacía).
+ */
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue: N debe ser potencia de 2");
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SpscQueue: T debe ser trivialmente copiable");
+
+public:
+    static constexpr size_t capacity() { return N; }
+
+    /**
+     * @brief Encola un elemento (solo productor).
+     * @return false si la cola está llena
+     */
+    bool push(const T& value) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= N) return false;
+        _items[head & (N - 1)] = value;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Desencola un elemento (solo consumidor).
+     * @param value Destino del elemento extraído
+     * @return false si la cola está vacía
+     */
+    bool pop(T& value) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) return false;
+        value = _items[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Elementos pendientes (aproximado si el otro lado está activo).
+     */
+    size_t size() const {
+        return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+private:
+    T _items[N];
+    std::atomic<uint32_t> _head{0};  ///< Escrito solo por el productor
+    std::atomic<uint32_t> _tail{0};  ///< Escrito solo por el consumidor
+};
+
+#endif // SPSC_QUEUE_H
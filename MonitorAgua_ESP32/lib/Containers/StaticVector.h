@@ -0,0 +1,82 @@
+/**
+ * @file StaticVector.h
+ * @brief Vector de capacidad fija sin memoria dinámica.
+ * @details Sustituye a los arreglos con índice manual y a los new[] temporales.
+ *          Es un agregado trivial (sin constructores), por lo que también puede
+ *          declararse RTC_DATA_ATTR. push_back() rechaza elementos cuando está lleno.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef STATIC_VECTOR_H
+#define STATIC_VECTOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+/**
+ * @brief Vector de hasta N elementos de tipo T.
+ * @tparam T Tipo trivialmente copiable
+ * @tparam N Capacidad (1..65535)
+ * @note Llamar clear() antes del primer uso si la variable no es global/estática.
+ */
+template <typename T, size_t N>
+struct StaticVector {
+    static_assert(N > 0 && N <= 0xFFFF, "StaticVector: capacidad fuera de rango");
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "StaticVector: T debe ser trivialmente copiable");
+
+    T items[N];      ///< Almacenamiento
+    uint16_t count;  ///< Elementos válidos (≤ N)
+
+    // ——— Capacidad ———
+    static constexpr size_t capacity() { return N; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == N; }
+    void clear() { count = 0; }
+
+    /**
+     * @brief Verifica que el contador sea coherente (p. ej. tras despertar).
+     */
+    bool isValid() const { return count <= N; }
+
+    // ——— Modificación ———
+
+    /**
+     * @brief Agrega un elemento al final.
+     * @return false si el vector está lleno (el elemento se descarta)
+     */
+    bool push_back(const T& value) {
+        if (count >= N) return false;
+        memcpy((void*)&items[count], (const void*)&value, sizeof(T));
+        count++;
+        return true;
+    }
+
+    /**
+     * @brief Elimina el último elemento (sin efecto si está vacío).
+     */
+    void pop_back() {
+        if (count > 0) count--;
+    }
+
+    // ——— Acceso ———
+    T& operator[](size_t i) { return items[i]; }
+    const T& operator[](size_t i) const { return items[i]; }
+    T& back() { return items[count - 1]; }
+    const T& back() const { return items[count - 1]; }
+
+    T* data() { return items; }
+    const T* data() const { return items; }
+    T* begin() { return items; }
+    T* end() { return items + count; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+};
+
+#endif // STATIC_VECTOR_H
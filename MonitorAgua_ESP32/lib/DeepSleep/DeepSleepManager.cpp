@@ -13,7 +13,11 @@
  */
 
 #include "DeepSleepManager.h"
+#include "Logger.h"
+#include "HAL.h"
 #include <stdarg.h>
+
+static const char TAG[] = "SLEEP"; ///< Etiqueta de log del módulo
 /**
  * @brief Constructor de la clase DeepSleepManager.
  * @param sleepInterval Intervalo total de ciclo (segundos).
@@ -66,13 +70,13 @@ void DeepSleepManager::setActiveTime(uint64_t seconds) {
 }
 
 /**
- * @brief Obtiene la causa del despertar en formato legible (string).
- * @return Cadena con la causa del despertar.
+ * @brief Obtiene la causa del despertar en formato legible.
+ * @return Literal estático con la causa del despertar.
  */
 
-// Obtener razón del despertar como string
-String DeepSleepManager::getWakeupReason() {
-    esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
+// Obtener razón del despertar como texto
+const char* DeepSleepManager::getWakeupReason() {
+    esp_sleep_wakeup_cause_t wakeup_reason = HAL::wakeupCause();
     
     switch(wakeup_reason) {
         case ESP_SLEEP_WAKEUP_TIMER:
@@ -101,7 +105,7 @@ String DeepSleepManager::getWakeupReason() {
 
 // Obtener causa del despertar como enum
 esp_sleep_wakeup_cause_t DeepSleepManager::getWakeupCause() {
-    return esp_sleep_get_wakeup_cause();
+    return HAL::wakeupCause();
 }
 
 /**
@@ -110,32 +114,32 @@ esp_sleep_wakeup_cause_t DeepSleepManager::getWakeupCause() {
 
 // Imprimir razón del despertar
 void DeepSleepManager::printWakeupReason() {
-    esp_sleep_wakeup_cause_t wakeup_reason = esp_sleep_get_wakeup_cause();
+    esp_sleep_wakeup_cause_t wakeup_reason = HAL::wakeupCause();
     
     switch(wakeup_reason) {
         case ESP_SLEEP_WAKEUP_TIMER:
-            log(" Desperté por temporizador RTC");
+            MLOG_I(" Desperté por temporizador RTC");
             break;
         case ESP_SLEEP_WAKEUP_EXT0:
-            log(" Desperté por señal externa RTC_IO");
+            MLOG_I(" Desperté por señal externa RTC_IO");
             break;
         case ESP_SLEEP_WAKEUP_EXT1:
-            log(" Desperté por señal externa RTC_CNTL");
+            MLOG_I(" Desperté por señal externa RTC_CNTL");
             break;
         case ESP_SLEEP_WAKEUP_TOUCHPAD:
-            log(" Desperté por touchpad");
+            MLOG_I(" Desperté por touchpad");
             break;
         case ESP_SLEEP_WAKEUP_ULP:
-            log(" Desperté por programa ULP");
+            MLOG_I(" Desperté por programa ULP");
             break;
         case ESP_SLEEP_WAKEUP_GPIO:
-            log(" Desperté por GPIO");
+            MLOG_I(" Desperté por GPIO");
             break;
         case ESP_SLEEP_WAKEUP_UART:
-            log(" Desperté por UART");
+            MLOG_I(" Desperté por UART");
             break;
         default:
-            log(" Arranque normal (reset/programación)");
+            MLOG_I(" Arranque normal (reset/programación)");
             break;
     }
 }
@@ -148,8 +152,8 @@ void DeepSleepManager::printWakeupReason() {
 // Habilitar despertar por temporizador
 void DeepSleepManager::enableTimerWakeup(uint64_t seconds) {
     uint64_t sleepTime = (seconds == 0) ? calculateSleepTime() : seconds;
-    esp_sleep_enable_timer_wakeup(sleepTime * US_TO_S_FACTOR);
-    logf(" Timer wakeup configurado: %llu segundos", sleepTime);
+    HAL::sleepEnableTimer(sleepTime * US_TO_S_FACTOR);
+    MLOG_I(" Timer wakeup configurado: %llu segundos", sleepTime);
 }
 
 /**
@@ -160,8 +164,8 @@ void DeepSleepManager::enableTimerWakeup(uint64_t seconds) {
 
 // Habilitar despertar por pin externo
 void DeepSleepManager::enableExternalWakeup(int pin, int level) {
-    esp_sleep_enable_ext0_wakeup((gpio_num_t)pin, level);
-    logf(" External wakeup configurado: GPIO%d, nivel %d", pin, level);
+    HAL::sleepEnableExt0(pin, level);
+    MLOG_I(" External wakeup configurado: GPIO%d, nivel %d", pin, level);
 }
 
 /**
@@ -174,19 +178,59 @@ void DeepSleepManager::goToSleep(bool showCountdown) {
     uint64_t sleepTime = calculateSleepTime();
     
     // Configurar timer wakeup
-    esp_sleep_enable_timer_wakeup(sleepTime * US_TO_S_FACTOR);
+    HAL::sleepEnableTimer(sleepTime * US_TO_S_FACTOR);
     
     if (showCountdown) {
-        logf(" Entrando en Deep Sleep por %llu segundos...", sleepTime);
-        logf("Ciclo: %llu min total (%llu min activo + %llu min sleep)", 
+        MLOG_I(" Entrando en Deep Sleep por %llu segundos...", sleepTime);
+        MLOG_I("Ciclo: %llu min total (%llu min activo + %llu min sleep)", 
             _sleepInterval/60, _activeTime/60, sleepTime/60);
         
-        log("==========================================");
-        delay(100);  // Dar tiempo para que se envíe el mensaje
+        MLOG_I("==========================================");
     }
     
+    Logger::flush();  // Transmitir log pendiente (con plazo máximo)
+    
     // Entrar en Deep Sleep
-    esp_deep_sleep_start(); ///< Inicia el modo Deep Sleep
+    HAL::deepSleep(); ///< Inicia el modo Deep Sleep
+}
+
+/**
+ * @brief Entra en Deep Sleep esperando la alarma del RTC externo, con temporizador de respaldo.
+ * @param pin GPIO RTC conectado a INT/SQW.
+ * @param seconds Segundos esperados hasta la alarma.
+ * @param showCountdown Mostrar información antes de dormir.
+ */
+
+// Entrar en Deep Sleep hasta la alarma externa
+void DeepSleepManager::goToSleepUntilAlarm(int pin, uint64_t seconds, bool showCountdown) {
+    uint64_t backstop = seconds + DEEPSLEEP_ALARM_MARGIN_S + seconds / DEEPSLEEP_ALARM_MARGIN_DIV;
+
+    // INT es colector abierto: el pull-up del dominio RTC la mantiene en alto durante el sueño
+    HAL::sleepEnableExt1(1ULL << pin, false, true);
+    HAL::sleepEnableTimer(backstop * US_TO_S_FACTOR);
+
+    if (showCountdown) {
+        MLOG_I(" Entrando en Deep Sleep hasta alarma RTC (GPIO%d) en %llu segundos...", pin, seconds);
+        MLOG_I("Temporizador de respaldo: %llu segundos", backstop);
+        MLOG_I("==========================================");
+    }
+
+    Logger::flush();
+    HAL::deepSleep();
+}
+
+/**
+ * @brief Indica si el despertar se debió a la alarma del RTC externo.
+ * @param pin GPIO conectado a INT/SQW.
+ * @return true si la causa es ext1 en ese pin.
+ */
+
+// Verificar despertar por alarma externa
+bool DeepSleepManager::isAlarmWakeup(int pin) {
+    if (HAL::wakeupCause() != ESP_SLEEP_WAKEUP_EXT1) {
+        return false;
+    }
+    return (HAL::wakeupExt1Status() & (1ULL << pin)) != 0;
 }
 
 /**
@@ -197,14 +241,14 @@ void DeepSleepManager::goToSleep(bool showCountdown) {
 
 // Entrar en Deep Sleep por tiempo específico
 void DeepSleepManager::goToSleepFor(uint64_t seconds, bool showCountdown) {
-    esp_sleep_enable_timer_wakeup(seconds * US_TO_S_FACTOR);
+    HAL::sleepEnableTimer(seconds * US_TO_S_FACTOR);
     
     if (showCountdown) {
-        logf(" Entrando en Deep Sleep por %llu segundos...", seconds);
-        delay(100);
+        MLOG_I(" Entrando en Deep Sleep por %llu segundos...", seconds);
     }
     
-    esp_deep_sleep_start();
+    Logger::flush();
+    HAL::deepSleep();
 }
 
 /**
@@ -215,7 +259,7 @@ void DeepSleepManager::goToSleepFor(uint64_t seconds, bool showCountdown) {
 // Calcular tiempo de sleep restante
 uint64_t DeepSleepManager::calculateSleepTime() {
     if (_sleepInterval <= _activeTime) {
-        log(" Warning: Tiempo activo >= intervalo total");
+        MLOG_W(" Warning: Tiempo activo >= intervalo total");
         return 10;  // Mínimo 10 segundos de sleep de seguridad
     }
     return _sleepInterval - _activeTime;
@@ -242,7 +286,7 @@ void DeepSleepManager::getCycleInfo(uint64_t &totalCycle, uint64_t &activeTime,
 
 // Verificar si es primera ejecución
 bool DeepSleepManager::isFirstBoot() {
-    return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_UNDEFINED;
+    return HAL::wakeupCause() == ESP_SLEEP_WAKEUP_UNDEFINED;
 }
 
 /**
@@ -272,65 +316,66 @@ void DeepSleepManager::setLogCallback(LogCallback callback) {
 
 // Sleep de emergencia
 void DeepSleepManager::emergencySleep(uint64_t emergencySeconds) {
-    log(" MODO EMERGENCIA - Sleep reducido");
-    logf("Durmiendo %llu segundos...", emergencySeconds);
+    MLOG_W(" MODO EMERGENCIA - Sleep reducido");
+    MLOG_I("Durmiendo %llu segundos...", emergencySeconds);
     
-    esp_sleep_enable_timer_wakeup(emergencySeconds * US_TO_S_FACTOR);
-    delay(1000);
-    esp_deep_sleep_start();
+    HAL::sleepEnableTimer(emergencySeconds * US_TO_S_FACTOR);
+    Logger::flush();
+    HAL::deepSleep();
 }
 
 /**
- * @brief Devuelve una cadena con el estado actual del gestor de Deep Sleep.
- * @return Cadena con la información de estado.
+ * @brief Escribe el estado actual del gestor de Deep Sleep en el buffer del llamador.
+ * @param buffer Destino del texto.
+ * @param size Tamaño del buffer.
+ * @return Longitud del texto completo (semántica de snprintf).
  */
 
 // Obtener estado actual
-String DeepSleepManager::getStatus() {
-    String status = "=== Deep Sleep Manager Status ===\n";
-    status += "Intervalo total: " + String(_sleepInterval) + "s (" + String(_sleepInterval/60) + "min)\n";
-    status += "Tiempo activo: " + String(_activeTime) + "s (" + String(_activeTime/60) + "min)\n";
-    status += "Tiempo sleep: " + String(calculateSleepTime()) + "s (" + String(calculateSleepTime()/60) + "min)\n";
-    status += "Duty cycle: " + String((_activeTime * 100.0) / _sleepInterval, 1) + "%\n";
-    status += "Última causa despertar: " + getWakeupReason() + "\n";
-    status += "Primera ejecución: " + String(isFirstBoot() ? "Sí" : "No") + "\n";
-    status += "Serial habilitado: " + String(_enableSerialOutput ? "Sí" : "No") + "\n";
-    status += "================================";
+size_t DeepSleepManager::getStatus(char* buffer, size_t size) {
+    uint64_t sleepTime = calculateSleepTime();
+    
+    int n = snprintf(buffer, size,
+                     "=== Deep Sleep Manager Status ===\n"
+                     "Intervalo total: %llus (%llumin)\n"
+                     "Tiempo activo: %llus (%llumin)\n"
+                     "Tiempo sleep: %llus (%llumin)\n"
+                     "Duty cycle: %.1f%%\n"
+                     "Última causa despertar: %s\n"
+                     "Primera ejecución: %s\n"
+                     "Serial habilitado: %s\n"
+                     "================================",
+                     _sleepInterval, _sleepInterval / 60,
+                     _activeTime, _activeTime / 60,
+                     sleepTime, sleepTime / 60,
+                     (_activeTime * 100.0) / _sleepInterval,
+                     getWakeupReason(),
+                     isFirstBoot() ? "Sí" : "No",
+                     _enableSerialOutput ? "Sí" : "No");
     
-    return status;
+    return (n > 0) ? (size_t)n : 0;
 }
 
-/**
- * @brief Log simple de mensajes.
- * @param message Cadena a imprimir o enviar a callback.
- *
- * Si se ha registrado un callback con setLogCallback(), se invoca; en caso contrario
- * se imprime por Serial si está habilitado.
- */
-
 // Métodos privados de logging
-void DeepSleepManager::log(const char* message) {
-    if (_logCallback) {
-        _logCallback(message);
-    } else if (_enableSerialOutput && Serial) {
-        Serial.println(message);
-    }
-}
-
 /**
- * @brief Log con formato (tipo printf).
- * @param format Cadena de formato.
- * @param ... Argumentos variables.
- *
- * Construye un buffer interno (256 bytes) y delega el resultado a log().
+ * @brief Envía un mensaje de log con formato estilo printf.
+ * @param level Nivel LOG_LEVEL_* del mensaje.
+ * @param format Cadena de formato printf.
+ * @param ... Argumentos variables para format.
+ * @note Si hay callback registrado se formatea aquí y se le entrega la línea;
+ *       en caso contrario se delega en Logger (modo texto o binario).
+ * @note Se invoca a través de las macros MLOG_*, que eliminan en compilación
+ *       los niveles por encima de LOG_LEVEL.
  */
-
-void DeepSleepManager::logf(const char* format, ...) {
-    char buffer[256];
+void DeepSleepManager::logf(uint8_t level, const char* format, ...) {
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    if (_logCallback) {
+        char buffer[LOG_LINE_MAX];
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        _logCallback(buffer);
+    } else if (_enableSerialOutput) {
+        Logger::vwrite(level, TAG, format, args);
+    }
     va_end(args);
-    
-    log(buffer);
-}
\ No newline at end of file
+}
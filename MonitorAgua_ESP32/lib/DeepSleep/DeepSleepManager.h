@@ -17,6 +17,10 @@
 #include <Arduino.h>
 #include "esp_sleep.h"
 
+// ——— Despertar por alarma externa ———
+#define DEEPSLEEP_ALARM_MARGIN_S    5   // Margen fijo del temporizador de respaldo
+#define DEEPSLEEP_ALARM_MARGIN_DIV  20  // Margen proporcional (1/20 = 5 %, deriva del oscilador lento)
+
 /**
  * @class DeepSleepManager
  * @brief Clase para manejo de Deep Sleep en ESP32
@@ -70,9 +74,9 @@ public:
     
     /**
      * @brief Obtener la razón del último despertar
-     * @return Causa del despertar como string descriptivo
+     * @return Causa del despertar como literal estático descriptivo
      */
-    String getWakeupReason();
+    const char* getWakeupReason();
     
     /**
      * @brief Obtener la razón del despertar como enum
@@ -98,6 +102,25 @@ public:
      */
     void enableExternalWakeup(int pin, int level);
     
+    /**
+     * @brief Entrar en Deep Sleep hasta que la alarma del RTC externo baje la línea INT
+     * @details Usa ext1 (activo en bajo) para no interferir con ext0, reservado al
+     *          botón. El temporizador interno queda armado solo como respaldo, con un
+     *          margen de DEEPSLEEP_ALARM_MARGIN_S más 1/DEEPSLEEP_ALARM_MARGIN_DIV del
+     *          tiempo esperado, por si la alarma no llega.
+     * @param pin GPIO RTC conectado a INT/SQW (colector abierto)
+     * @param seconds Segundos esperados hasta la alarma
+     * @param showCountdown Mostrar información antes de dormir
+     */
+    void goToSleepUntilAlarm(int pin, uint64_t seconds, bool showCountdown = true);
+
+    /**
+     * @brief Verificar si el despertar se debió a la alarma del RTC externo
+     * @param pin GPIO conectado a INT/SQW
+     * @return true si la causa es ext1 y el pin está entre los que despertaron
+     */
+    bool isAlarmWakeup(int pin);
+
     /**
      * @brief Entrar en modo Deep Sleep
      * @param showCountdown Mostrar cuenta regresiva antes de dormir
@@ -150,24 +173,21 @@ public:
     void emergencySleep(uint64_t emergencySeconds = 30);
     
     /**
-     * @brief Obtener estadísticas de sleep
-     * @return String con información de configuración actual
+     * @brief Escribir estadísticas de sleep en un buffer del llamador
+     * @param buffer Destino del texto
+     * @param size Tamaño del buffer
+     * @return Longitud del texto completo (semántica de snprintf; ≥ size si se truncó)
      */
-    String getStatus();
+    size_t getStatus(char* buffer, size_t size);
 
 private:
     /**
-     * @brief Enviar mensaje de log
-     * @param message Mensaje a enviar
-     */
-    void log(const char* message);
-    
-    /**
-     * @brief Enviar mensaje de log con formato
+     * @brief Envía mensaje de log con formato al backend común (usar macros MLOG_*)
+     * @param level Nivel LOG_LEVEL_* del mensaje
      * @param format String de formato estilo printf
      * @param ... Argumentos variables
      */
-    void logf(const char* format, ...);
+    void logf(uint8_t level, const char* format, ...) __attribute__((format(printf, 3, 4)));
 };
 
 #endif // DEEPSLEEP_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,86 @@
+/**
+ * @file DeltaReport.cpp
+ * @brief Implementación del modo de reporte por banda muerta
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+#include "DeltaReport.h"
+#include "Logger.h"
+#include <math.h>
+
+static const char TAG[] = "DELTA"; ///< Etiqueta de log del módulo
+
+// ——— Variables persistentes ———
+HAL_PERSISTENT uint16_t delta_silent_cycles = 0;
+
+namespace DeltaReport {
+
+    /**
+     * @brief Configuración activa (por defecto desactivado)
+     */
+    config_t active = {false, 0.0f, 0.0f, 0.0f, 0.0f, 0, 0};
+
+    void begin(const config_t &config, bool reset)
+    {
+        active = config;
+        if (reset || delta_silent_cycles > active.max_silent_cycles) {
+            delta_silent_cycles = 0;
+        }
+    }
+
+    const config_t& config()
+    {
+        return active;
+    }
+
+    bool shouldStore(const RTCMemoryManager::SensorReading &candidate, RTCMemoryManager &memory)
+    {
+        if (!active.enabled) return true;
+
+        RTCMemoryManager::SensorReading last;
+        const char *reason = nullptr;
+
+        if (!memory.getLastReading(last)) {
+            reason = "sin lectura previa";
+        } else if (candidate.alarms != last.alarms) {
+            reason = "cambio de alarmas de anomalía";
+        } else if (candidate.sensor_status != last.sensor_status) {
+            reason = "cambio de estado de sensor";
+        } else if (fabsf(candidate.temperature - last.temperature) > active.temperature ||
+                   fabsf(candidate.ph - last.ph) > active.ph ||
+                   fabsf(candidate.turbidity - last.turbidity) > active.turbidity ||
+                   fabsf(candidate.tds - last.tds) > active.tds) {
+            reason = "fuera de banda muerta";
+        } else if (delta_silent_cycles + 1 >= active.max_silent_cycles) {
+            reason = "silencio máximo";
+        }
+
+        if (reason) {
+            LOG_D(TAG, " Lectura almacenada (%s, %u ciclos omitidos)", reason, delta_silent_cycles);
+            delta_silent_cycles = 0;
+            return true;
+        }
+
+        delta_silent_cycles++;
+        LOG_I(TAG, " Sin cambios dentro de la banda muerta - lectura omitida (%u/%u)",
+              delta_silent_cycles, active.max_silent_cycles);
+        return false;
+    }
+
+    uint16_t silentCycles()
+    {
+        return delta_silent_cycles;
+    }
+
+    int describe(char *buffer, size_t size)
+    {
+        if (!active.enabled || size == 0) return 0;
+        int n = snprintf(buffer, size,
+                         "{\"mode\":\"delta\",\"cycle_s\":%u,\"max_silent_cycles\":%u,"
+                         "\"deadband\":{\"temperature\":%.3g,\"ph\":%.3g,\"turbidity\":%.3g,\"tds\":%.3g}}",
+                         active.cycle_seconds, active.max_silent_cycles,
+                         active.temperature, active.ph, active.turbidity, active.tds);
+        return (n > 0 && (size_t)n < size) ? n : 0;
+    }
+}
@@ -0,0 +1,91 @@
+/**
+ * @file DeltaReport.h
+ * @brief Modo de reporte por banda muerta (send-on-delta)
+ * @details Con agua estable casi todas las lecturas repiten la anterior. En este modo
+ *          una lectura solo se almacena (y por lo tanto se transmite) si algún
+ *          parámetro se movió más que su banda muerta respecto a la última lectura
+ *          almacenada, si cambió el estado de algún sensor o la máscara de alarmas
+ *          de anomalía, o si la última almacenada ya tiene max_silent_cycles ciclos
+ *          de antigüedad.
+ *
+ *          El servidor reconstruye la serie escalonada: entre dos lecturas recibidas
+ *          los valores se mantienen en la primera. La configuración viaja en el
+ *          mensaje "sending_data" (ver WiFiManager::sendStoredData), así que el
+ *          servidor conoce la banda muerta y el silencio máximo: un hueco mayor que
+ *          max_silent_cycles · cycle_seconds es una pérdida, no un valor sostenido.
+ *
+ * @note Desactivado por defecto (DELTA_REPORTING en main.cpp).
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef DELTA_REPORT_H
+#define DELTA_REPORT_H
+
+#include <Arduino.h>
+#include "HAL.h"
+#include "RTCMemory.h"
+
+/**
+ * @namespace DeltaReport
+ * @brief Decide si la lectura del ciclo se almacena o se omite
+ */
+namespace DeltaReport {
+
+    /**
+     * @struct config_t
+     * @brief Bandas muertas por parámetro y silencio máximo
+     */
+    typedef struct {
+        bool enabled;                 ///< false = se almacena cada ciclo (modo original)
+        float temperature;            ///< Banda muerta de temperatura en °C
+        float ph;                     ///< Banda muerta de pH
+        float turbidity;              ///< Banda muerta de turbidez en NTU
+        float tds;                    ///< Banda muerta de TDS en ppm
+        uint16_t max_silent_cycles;   ///< Máximo de ciclos entre dos lecturas almacenadas
+        uint16_t cycle_seconds;       ///< Periodo nominal del ciclo (metadato para el servidor)
+    } config_t;
+
+    /**
+     * @brief Fija la configuración (una vez en setup())
+     * @param reset true tras reinicializar la RTC Memory (reinicia el contador de silencio)
+     */
+    void begin(const config_t &config, bool reset = false);
+
+    /**
+     * @brief Configuración activa
+     */
+    const config_t& config();
+
+    /**
+     * @brief Indica si la lectura candidata debe almacenarse
+     * @param candidate Lectura del ciclo (aún no almacenada)
+     * @param memory Gestor de RTC Memory (para la última lectura almacenada)
+     * @return true si el modo está desactivado o la lectura supera la banda muerta
+     * @note Actualiza el contador de silencio: llamar una sola vez por ciclo.
+     */
+    bool shouldStore(const RTCMemoryManager::SensorReading &candidate, RTCMemoryManager &memory);
+
+    /**
+     * @brief Ciclos seguidos sin almacenar lectura
+     */
+    uint16_t silentCycles();
+
+    /**
+     * @brief Escribe la configuración como objeto JSON ("mode", "deadband", ...)
+     * @param buffer Destino
+     * @param size Tamaño del destino
+     * @return Caracteres escritos (0 si el modo está desactivado o no cabe)
+     */
+    int describe(char *buffer, size_t size);
+}
+
+/**
+ * @var delta_silent_cycles
+ * @brief Ciclos omitidos desde la última lectura almacenada
+ * @note Variable HAL_PERSISTENT declarada en .cpp, solo declaración extern aquí.
+ */
+extern HAL_PERSISTENT uint16_t delta_silent_cycles;
+
+#endif // DELTA_REPORT_H
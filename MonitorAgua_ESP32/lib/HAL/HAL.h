@@ -0,0 +1,206 @@
+/**
+ * @file HAL.h
+ * @brief Capa de abstracción de hardware (HAL) del firmware.
+ * @details Reúne en un solo punto las llamadas específicas del ESP32 que usan las
+ *          librerías, para que compilen tanto en el equipo como en Linux (entorno
+ *          `native` de PlatformIO, -D HAL_NATIVE):
+ *
+ *          | Área              | API                        | ESP32                     | Linux (HAL_Native.cpp)          |
+ *          |-------------------|----------------------------|---------------------------|---------------------------------|
+ *          | Tiempo            | HAL::rtcTimeUs(), *TimeOfDay | esp_rtc_get_time_us()   | Reloj virtual determinista      |
+ *          | ADC               | HAL::adc*()                | analogRead + esp_adc_cal  | Voltajes inyectados por pin     |
+ *          | CRC               | HAL::crc32()               | esp_crc32_le (ROM)        | CRC-32 por tabla                |
+ *          | Heap              | HAL::heapAllocations()     | --wrap=malloc (opcional)  | malloc interpuesto              |
+ *          | Sleep / reinicio  | HAL::sleep*(), deepSleep() | esp_sleep_*               | Fin del proceso del ciclo       |
+ *          | RAM persistente   | HAL_PERSISTENT             | RTC_DATA_ATTR             | Sección "hal_persistent"        |
+ *          | I2C               | Wire (TwoWire)             | Arduino-ESP32             | native/Wire.h + modelos         |
+ *          | OneWire           | OneWire, DallasTemperature | Librerías de PaulStoffregen/milesburton | native/ + temperatura inyectada |
+ *          | Socket de red     | WiFi, WebSocketsClient     | Arduino-ESP32 + links2004 | native/ sobre sockets POSIX     |
+ *          | NVS               | Preferences                | Arduino-ESP32             | native/ en memoria compartida   |
+ *          | Trazas            | HAL::Trace (Trace.h)       | Grabación con -D HAL_TRACE | Reproducción bit a bit         |
+ *
+ *          Las áreas de periféricos con clase (I2C, OneWire, red, NVS) conservan la
+ *          interfaz de Arduino: en el ESP32 la implementan las librerías originales y
+ *          en Linux las cabeceras de lib/HAL/native, que solo entran en la ruta de
+ *          inclusión del entorno `native`.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/time.h>
+#include "esp_sleep.h"
+
+#ifndef HAL_NATIVE
+#include <esp_adc_cal.h>
+#endif
+
+// ——— RAM persistente ———
+
+/**
+ * @def HAL_PERSISTENT
+ * @brief Ubica una variable en la memoria que sobrevive al deep sleep.
+ * @details En el ESP32 es la RTC slow memory (se pierde solo al cortar la
+ *          alimentación). En Linux es una sección propia que el ejecutor nativo
+ *          conserva entre ciclos simulados.
+ */
+#ifdef HAL_NATIVE
+#define HAL_PERSISTENT __attribute__((section("hal_persistent")))
+#else
+#define HAL_PERSISTENT RTC_DATA_ATTR
+#endif
+
+namespace HAL {
+
+    // ——— Tiempo ———
+
+    /**
+     * @brief Temporizador RTC (sigue contando durante el deep sleep)
+     * @return Microsegundos desde el último reset del dominio RTC
+     */
+    uint64_t rtcTimeUs();
+
+    /**
+     * @brief Hora del sistema (la que ajustan SNTP y setTimeOfDay)
+     * @param tv Destino
+     */
+    void getTimeOfDay(struct timeval* tv);
+
+    /**
+     * @brief Ajusta la hora del sistema
+     * @param tv Hora Unix
+     */
+    void setTimeOfDay(const struct timeval* tv);
+
+    // ——— ADC ———
+
+    /**
+     * @enum AdcAtten
+     * @brief Atenuación de entrada del ADC (define el rango de voltaje)
+     */
+    enum class AdcAtten : uint8_t {
+        DB_0,    ///< ~0-750 mV en ESP32-S2
+        DB_2_5,  ///< ~0-1050 mV
+        DB_6,    ///< ~0-1300 mV
+        DB_12    ///< ~0-2500 mV (ADC_11db en Arduino)
+    };
+
+#ifdef HAL_NATIVE
+    /**
+     * @brief Caracterización del ADC en el modelo nativo
+     */
+    typedef struct {
+        AdcAtten atten;    ///< Atenuación caracterizada
+        uint8_t bits;      ///< Ancho de palabra caracterizado
+        uint32_t vref_mv;  ///< Referencia nominal
+    } AdcCalibration;
+#else
+    typedef esp_adc_cal_characteristics_t AdcCalibration;
+#endif
+
+    /**
+     * @brief Configura resolución de lectura y atenuación de un pin
+     * @param pin GPIO con ADC
+     * @param bits Resolución de analogRead()
+     * @param atten Atenuación del pin
+     */
+    void adcConfigure(uint8_t pin, uint8_t bits, AdcAtten atten);
+
+    /**
+     * @brief Caracteriza el ADC1 para convertir lecturas crudas a mV
+     * @param cal Destino de la caracterización
+     * @param atten Atenuación a caracterizar
+     * @param bits Ancho de palabra a caracterizar
+     * @param vrefMv Referencia nominal (mV)
+     */
+    void adcCalibrate(AdcCalibration* cal, AdcAtten atten, uint8_t bits, uint32_t vrefMv);
+
+    /**
+     * @brief Lectura cruda del ADC
+     * @param pin GPIO configurado con adcConfigure()
+     * @return Valor en la resolución configurada
+     */
+    uint16_t adcRead(uint8_t pin);
+
+    /**
+     * @brief Convierte una lectura cruda a mV con la caracterización
+     */
+    uint32_t adcToMilliVolts(uint32_t raw, const AdcCalibration* cal);
+
+    // ——— CRC ———
+
+    /**
+     * @brief CRC-32 (polinomio 0xEDB88320) con la semántica de esp_crc32_le()
+     * @param crc Valor inicial
+     * @param data Datos
+     * @param length Longitud en bytes
+     * @return CRC acumulado
+     */
+    uint32_t crc32(uint32_t crc, const uint8_t* data, size_t length);
+
+    // ——— Heap ———
+
+    /**
+     * @brief Asignaciones de heap (malloc, calloc, realloc) desde el arranque
+     * @details Para presupuestos de "cero asignaciones" (bench/, perf_budgets.ini).
+     *          En el equipo solo cuenta si se compila con -D HAL_COUNT_ALLOCATIONS
+     *          y -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc (env:bench).
+     * @return Contador acumulado (0 si no se cuenta)
+     */
+    uint32_t heapAllocations();
+
+    /**
+     * @brief true si heapAllocations() cuenta en esta compilación
+     */
+    bool heapAllocationsCounted();
+
+    // ——— Sleep y reinicio ———
+
+    /**
+     * @brief Causa del último despertar
+     */
+    esp_sleep_wakeup_cause_t wakeupCause();
+
+    /**
+     * @brief Máscara de pines que provocaron un despertar ext1
+     */
+    uint64_t wakeupExt1Status();
+
+    /**
+     * @brief Arma el despertar por temporizador
+     * @param us Microsegundos hasta despertar
+     */
+    void sleepEnableTimer(uint64_t us);
+
+    /**
+     * @brief Arma el despertar por un pin RTC (ext0)
+     */
+    void sleepEnableExt0(int pin, int level);
+
+    /**
+     * @brief Arma el despertar por una máscara de pines RTC (ext1)
+     * @param mask Máscara de GPIO
+     * @param anyHigh true: cualquiera en alto; false: todos en bajo
+     * @param pullup Mantener el pull-up interno de los pines durante el sueño
+     */
+    void sleepEnableExt1(uint64_t mask, bool anyHigh, bool pullup);
+
+    /**
+     * @brief Entra en deep sleep (no retorna)
+     */
+    [[noreturn]] void deepSleep();
+
+    /**
+     * @brief Reinicio por software, conservando la RAM persistente (no retorna)
+     */
+    [[noreturn]] void restart();
+
+} // namespace HAL
+
+#endif // HAL_H
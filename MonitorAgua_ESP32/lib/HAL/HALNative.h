@@ -0,0 +1,339 @@
+/**
+ * @file HALNative.h
+ * @brief Control del backend Linux de la HAL: reloj virtual, estímulos y ejecutor de ciclos.
+ * @details Solo existe con -D HAL_NATIVE. El ejecutor reproduce el ciclo del
+ *          equipo: cada despertar corre setup() en un proceso hijo (fork), de modo
+ *          que las variables globales arrancan limpias como tras un deep sleep real,
+ *          y solo la sección HAL_PERSISTENT, el reloj y la NVS pasan al siguiente.
+ *
+ *          El tiempo es virtual: delay() y el deep sleep lo adelantan sin esperar,
+ *          y cada lectura del reloj lo adelanta HAL_NATIVE_CLOCK_READ_US para que los
+ *          bucles de sondeo terminen. El resultado es determinista.
+ *
+ *          Todo lo que un ciclo modifica y debe ver el siguiente (modelos I2C,
+ *          estímulos cambiados desde el firmware) debe vivir en memoria compartida:
+ *          usar sharedNew() en lugar de new.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_NATIVE_H
+#define HAL_NATIVE_H
+
+#ifdef HAL_NATIVE
+
+#include "HAL.h"
+#include <new>
+
+// ——— Configuración ———
+#define HAL_NATIVE_PINS            48        // GPIO modelados (ESP32-S2: 0..46)
+#define HAL_NATIVE_CLOCK_READ_US   1         // Avance del reloj por cada lectura
+#define HAL_NATIVE_SHARED_ARENA    65536     // Bytes para sharedAlloc()
+#define HAL_NATIVE_NVS_ENTRIES     16        // Claves NVS simultáneas
+#define HAL_NATIVE_NVS_VALUE_MAX   2048      // Tamaño máximo de un valor NVS
+#define HAL_NATIVE_WIFI_ASSOC_MS   1500      // Tiempo virtual de asociación WiFi
+#define HAL_NATIVE_DEFAULT_EPOCH   1759276800UL  // 2025-10-01 00:00:00 UTC
+
+namespace HAL {
+namespace Native {
+
+    /**
+     * @class I2CDevice
+     * @brief Modelo de un esclavo I2C en el bus nativo.
+     * @details Debe crearse con sharedNew() para que su estado persista entre ciclos.
+     */
+    class I2CDevice {
+    public:
+        virtual ~I2CDevice() {}
+
+        /**
+         * @brief Transacción de escritura (primer byte: registro, si aplica)
+         * @return false para responder NACK
+         */
+        virtual bool write(const uint8_t* data, size_t length) = 0;
+
+        /**
+         * @brief Transacción de lectura
+         * @return Bytes entregados
+         */
+        virtual size_t read(uint8_t* data, size_t length) = 0;
+    };
+
+    /**
+     * @brief Motivo por el que terminó un ciclo
+     */
+    enum CycleEnd : uint8_t {
+        CYCLE_RUNNING = 0,   ///< El ciclo no terminó (proceso abortado)
+        CYCLE_DEEP_SLEEP,    ///< HAL::deepSleep()
+        CYCLE_RESTART,       ///< HAL::restart()
+        CYCLE_BROWNOUT,      ///< Corte programado con scheduleBrownout()
+        CYCLE_CRASH          ///< Señal o salida inesperada
+    };
+
+    /**
+     * @brief Resultado de un ciclo ejecutado con runCycle()
+     */
+    typedef struct {
+        CycleEnd end;            ///< Motivo de fin
+        uint64_t awake_us;       ///< Tiempo virtual despierto
+        uint64_t sleep_us;       ///< Temporizador armado (0 = ninguno)
+        int ext0_pin;            ///< Pin ext0 armado (-1 = ninguno)
+        uint64_t ext1_mask;      ///< Máscara ext1 armada
+        bool ext1_any_high;      ///< Modo ext1: algún pin en alto (false: todos en bajo)
+        uint64_t radio_on_us;    ///< Tiempo con la radio WiFi encendida
+        uint32_t bytes_sent;     ///< Bytes enviados por la red (tramas WebSocket incluidas)
+        uint32_t bytes_received; ///< Bytes recibidos por la red
+    } CycleResult;
+
+    // ——— Reloj virtual ———
+
+    /**
+     * @brief Adelanta el reloj virtual
+     */
+    void advanceUs(uint64_t us);
+
+    /**
+     * @brief Hora Unix "verdadera" (la que daría NTP) en el instante actual
+     */
+    uint64_t trueEpochUs();
+
+    /**
+     * @brief Solicitudes SNTP (configTime()) hechas en este proceso
+     */
+    uint32_t sntpRequests();
+
+    /**
+     * @brief Fija la hora Unix verdadera correspondiente al encendido (rtcTimeUs() = 0)
+     */
+    void setStartEpoch(uint32_t epoch);
+
+    /**
+     * @brief Microsegundos desde el arranque del ciclo actual (base de millis/micros)
+     */
+    uint64_t uptimeUs();
+
+    // ——— Estímulos ———
+
+    /**
+     * @brief Voltaje presente en un pin analógico
+     */
+    void setAnalogMilliVolts(uint8_t pin, float mv);
+
+    /**
+     * @brief Ruido del ADC: cada muestra se desvía hasta ±lsb cuentas (0 = ideal)
+     * @note Con entrada constante los promedios que descartan extremos (pH) no
+     *       tienen muestras que promediar; el ADC real siempre tiene algunas LSB.
+     */
+    void setAnalogNoise(float lsb);
+
+    /**
+     * @brief Temperatura del DS18B20 en un bus OneWire (NAN = sin sensor)
+     */
+    void setOneWireTemperature(uint8_t pin, float celsius);
+
+    /**
+     * @brief Temperatura del DS18B20 en un pin (NAN si no hay sensor)
+     */
+    float getOneWireTemperature(uint8_t pin);
+
+    /**
+     * @brief Disponibilidad de la red WiFi y RSSI reportado
+     */
+    void setWiFi(bool available, int8_t rssi = -60);
+
+    /**
+     * @brief Indica si la red WiFi simulada está disponible
+     */
+    bool wifiAvailable();
+
+    /**
+     * @brief RSSI simulado
+     */
+    int8_t wifiRssi();
+
+    // ——— Radio ———
+
+    /**
+     * @brief Enciende o apaga la radio WiFi (contabiliza el tiempo encendida)
+     */
+    void setRadio(bool on);
+
+    /**
+     * @brief Suma tráfico de red al ciclo actual
+     */
+    void countTraffic(size_t sent, size_t received);
+
+    /**
+     * @brief Redirige las conexiones WebSocket a otro servidor (p. ej. servidor.py local)
+     * @param host Host o nullptr para respetar el configurado en el firmware
+     */
+    void setServerOverride(const char* host, uint16_t port);
+
+    /**
+     * @brief Servidor efectivo para una conexión
+     */
+    void resolveServer(const char*& host, uint16_t& port);
+
+    // ——— Servidor WebSocket simulado ———
+
+    /**
+     * @class WebSocketPeer
+     * @brief Servidor WebSocket dentro del proceso, sin sockets ni tiempo real.
+     * @details Mientras hay uno conectado, el cliente nativo no abre sockets: le
+     *          entrega cada mensaje del firmware y en cada loop() le pide el
+     *          siguiente para el firmware. Todo ocurre en tiempo virtual, así que
+     *          el resultado es determinista. Debe crearse con sharedNew().
+     */
+    class WebSocketPeer {
+    public:
+        virtual ~WebSocketPeer() {}
+
+        /**
+         * @brief Handshake de una sesión nueva
+         * @return false para rechazarla (el cliente reintenta)
+         */
+        virtual bool onOpen() = 0;
+
+        /**
+         * @brief Mensaje de texto del firmware
+         */
+        virtual void onText(const char* payload, size_t length) = 0;
+
+        /**
+         * @brief Siguiente mensaje para el firmware
+         * @return Longitud copiada en buffer (0 = nada pendiente)
+         */
+        virtual size_t poll(char* buffer, size_t capacity) = 0;
+
+        /**
+         * @brief Fin de la sesión (cierre del firmware o caída de la red)
+         */
+        virtual void onClose() {}
+    };
+
+    /**
+     * @brief Conecta el servidor simulado (nullptr vuelve a los sockets reales)
+     */
+    void attachWebSocketPeer(WebSocketPeer* peer);
+
+    /**
+     * @brief Servidor simulado conectado (nullptr si no hay)
+     */
+    WebSocketPeer* webSocketPeer();
+
+    // ——— Modelo del ADC ———
+
+    /**
+     * @brief Lectura cruda que produciría el pin con su configuración
+     */
+    uint16_t adcSample(uint8_t pin);
+
+    // ——— Dispositivos I2C ———
+
+    /**
+     * @brief Conecta un modelo al bus I2C
+     * @param address Dirección de 7 bits
+     * @param device Modelo creado con sharedNew() (nullptr lo desconecta)
+     */
+    void attachI2CDevice(uint8_t address, I2CDevice* device);
+
+    /**
+     * @brief Modelo conectado en una dirección (nullptr si no hay)
+     */
+    I2CDevice* i2cDevice(uint8_t address);
+
+    // ——— NVS ———
+
+    /**
+     * @brief Busca un valor NVS
+     * @return Puntero al valor o nullptr
+     */
+    const uint8_t* nvsGet(const char* ns, const char* key, size_t& length);
+
+    /**
+     * @brief Guarda un valor NVS
+     * @return Bytes escritos (0 si no cabe)
+     */
+    size_t nvsPut(const char* ns, const char* key, const void* data, size_t length);
+
+    /**
+     * @brief Borra un valor NVS
+     */
+    bool nvsRemove(const char* ns, const char* key);
+
+    /**
+     * @brief Borra todas las claves de un namespace
+     */
+    void nvsClear(const char* ns);
+
+    // ——— Memoria compartida entre ciclos ———
+
+    /**
+     * @brief Reserva memoria que conservan todos los ciclos (no se libera)
+     */
+    void* sharedAlloc(size_t size);
+
+    /**
+     * @brief Construye un objeto en memoria compartida
+     */
+    template <typename T, typename... Args>
+    T* sharedNew(Args&&... args) {
+        void* p = sharedAlloc(sizeof(T));
+        return p ? new (p) T(static_cast<Args&&>(args)...) : nullptr;
+    }
+
+    // ——— Ejecutor ———
+
+    /**
+     * @brief Prepara el estado compartido (llamar una vez, antes de todo lo demás)
+     */
+    void init();
+
+    /**
+     * @brief Ejecuta un despertar completo: setup() y loop() hasta dormir o reiniciar
+     * @return Resultado del ciclo; el reloj queda en el instante de dormir
+     */
+    CycleResult runCycle();
+
+    /**
+     * @brief Duerme hasta el siguiente despertar y fija su causa
+     * @param afterUs Tiempo dormido
+     * @param cause Causa del despertar
+     * @param ext1Status Pines ext1 que despertaron
+     */
+    void wake(uint64_t afterUs, esp_sleep_wakeup_cause_t cause, uint64_t ext1Status = 0);
+
+    /**
+     * @brief Corte de alimentación: pierde la RAM persistente y reinicia el temporizador RTC
+     */
+    void powerCycle();
+
+    /**
+     * @brief Programa un corte de alimentación a mitad del próximo ciclo
+     * @param afterUs Tiempo virtual desde el arranque del ciclo; el ciclo termina
+     *        con CYCLE_BROWNOUT sin guardar la RAM persistente. Se descarta si el
+     *        ciclo duerme antes. Después llamar a powerCycle().
+     */
+    void scheduleBrownout(uint64_t afterUs);
+
+    /**
+     * @brief Copia en el proceso actual la RAM persistente del último ciclo
+     * @details Permite al ejecutor inspeccionar el estado del firmware (p. ej.
+     *          contadores de RTCMemory) con sus propias clases.
+     * @return false si no hay RAM persistente válida
+     */
+    bool loadPersistent();
+
+    /**
+     * @brief Ejecutor por defecto: --cycles N, --epoch E, --server host:port, --no-wifi
+     * @return Código de salida del proceso
+     */
+    int run(int argc, char** argv);
+
+} // namespace Native
+} // namespace HAL
+
+#endif // HAL_NATIVE
+
+#endif // HAL_NATIVE_H
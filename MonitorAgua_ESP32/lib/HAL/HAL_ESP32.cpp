@@ -0,0 +1,174 @@
+/**
+ * @file HAL_ESP32.cpp
+ * @brief Implementación de la HAL sobre Arduino-ESP32 / ESP-IDF.
+ * @details Cada función delega en la llamada del IDF que antes hacían las
+ *          librerías directamente; no añade estado ni lógica propia.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_NATIVE
+
+#include "HAL.h"
+#include "Trace.h"
+#include "esp_crc.h"
+#include "driver/rtc_io.h"
+
+#if __has_include("esp_rtc_time.h")
+#include "esp_rtc_time.h"
+#elif defined(CONFIG_IDF_TARGET_ESP32S2)
+#include "esp32s2/rtc.h"
+#else
+#include "esp32/rtc.h"
+#endif
+
+namespace HAL {
+
+    // ——— Tiempo ———
+
+    uint64_t rtcTimeUs() {
+        return esp_rtc_get_time_us();
+    }
+
+    void getTimeOfDay(struct timeval* tv) {
+        gettimeofday(tv, nullptr);
+    }
+
+    void setTimeOfDay(const struct timeval* tv) {
+        settimeofday(tv, nullptr);
+    }
+
+    // ——— ADC ———
+
+    /**
+     * @brief Atenuación de pin de Arduino equivalente
+     */
+    static adc_attenuation_t pinAttenuation(AdcAtten atten) {
+        switch (atten) {
+            case AdcAtten::DB_0:   return ADC_0db;
+            case AdcAtten::DB_2_5: return ADC_2_5db;
+            case AdcAtten::DB_6:   return ADC_6db;
+            default:               return ADC_11db;
+        }
+    }
+
+    /**
+     * @brief Atenuación del IDF equivalente
+     */
+    static adc_atten_t idfAttenuation(AdcAtten atten) {
+        switch (atten) {
+            case AdcAtten::DB_0:   return ADC_ATTEN_DB_0;
+            case AdcAtten::DB_2_5: return ADC_ATTEN_DB_2_5;
+            case AdcAtten::DB_6:   return ADC_ATTEN_DB_6;
+            default:               return ADC_ATTEN_DB_12;
+        }
+    }
+
+    void adcConfigure(uint8_t pin, uint8_t bits, AdcAtten atten) {
+        analogReadResolution(bits);
+        analogSetPinAttenuation(pin, pinAttenuation(atten));
+    }
+
+    void adcCalibrate(AdcCalibration* cal, AdcAtten atten, uint8_t bits, uint32_t vrefMv) {
+        adc_bits_width_t width = (bits >= 13) ? ADC_WIDTH_BIT_13 : ADC_WIDTH_BIT_12;
+        esp_adc_cal_characterize(ADC_UNIT_1, idfAttenuation(atten), width, vrefMv, cal);
+    }
+
+    uint16_t adcRead(uint8_t pin) {
+        uint16_t raw = analogRead(pin);
+        Trace::recordAdc(pin, raw);  // Vacía salvo con -D HAL_TRACE
+        return raw;
+    }
+
+    uint32_t adcToMilliVolts(uint32_t raw, const AdcCalibration* cal) {
+        return esp_adc_cal_raw_to_voltage(raw, cal);
+    }
+
+    // ——— CRC ———
+
+    uint32_t crc32(uint32_t crc, const uint8_t* data, size_t length) {
+        return esp_crc32_le(crc, data, length);
+    }
+
+    // ——— Heap ———
+
+#ifdef HAL_COUNT_ALLOCATIONS
+    static volatile uint32_t heap_allocations = 0;
+
+    uint32_t heapAllocations() { return heap_allocations; }
+    bool heapAllocationsCounted() { return true; }
+#else
+    uint32_t heapAllocations() { return 0; }
+    bool heapAllocationsCounted() { return false; }
+#endif
+
+    // ——— Sleep y reinicio ———
+
+    esp_sleep_wakeup_cause_t wakeupCause() {
+        return esp_sleep_get_wakeup_cause();
+    }
+
+    uint64_t wakeupExt1Status() {
+        return esp_sleep_get_ext1_wakeup_status();
+    }
+
+    void sleepEnableTimer(uint64_t us) {
+        esp_sleep_enable_timer_wakeup(us);
+    }
+
+    void sleepEnableExt0(int pin, int level) {
+        esp_sleep_enable_ext0_wakeup((gpio_num_t)pin, level);
+    }
+
+    void sleepEnableExt1(uint64_t mask, bool anyHigh, bool pullup) {
+        if (pullup) {
+            // Pull-ups del dominio RTC: requieren mantener encendidos sus periféricos
+            for (int pin = 0; pin < 64; pin++) {
+                if (mask & (1ULL << pin)) {
+                    rtc_gpio_pullup_en((gpio_num_t)pin);
+                    rtc_gpio_pulldown_dis((gpio_num_t)pin);
+                }
+            }
+            esp_sleep_pd_config(ESP_PD_DOMAIN_RTC_PERIPH, ESP_PD_OPTION_ON);
+        }
+        esp_sleep_enable_ext1_wakeup(mask, anyHigh ? ESP_EXT1_WAKEUP_ANY_HIGH : ESP_EXT1_WAKEUP_ALL_LOW);
+    }
+
+    void deepSleep() {
+        esp_deep_sleep_start();
+    }
+
+    void restart() {
+        ESP.restart();
+        for (;;) {}
+    }
+
+} // namespace HAL
+
+#ifdef HAL_COUNT_ALLOCATIONS
+// Enlazado con -Wl,--wrap=...: cada llamada a malloc del firmware (String, new,
+// ArduinoJson, librerías) pasa por aquí antes del asignador de ESP-IDF
+extern "C" {
+    void* __real_malloc(size_t size);
+    void* __real_calloc(size_t count, size_t size);
+    void* __real_realloc(void* ptr, size_t size);
+
+    void* __wrap_malloc(size_t size) {
+        HAL::heap_allocations++;
+        return __real_malloc(size);
+    }
+
+    void* __wrap_calloc(size_t count, size_t size) {
+        HAL::heap_allocations++;
+        return __real_calloc(count, size);
+    }
+
+    void* __wrap_realloc(void* ptr, size_t size) {
+        HAL::heap_allocations++;
+        return __real_realloc(ptr, size);
+    }
+}
+#endif
+
+#endif // HAL_NATIVE
@@ -0,0 +1,650 @@
+/**
+ * @file HAL_Native.cpp
+ * @brief Implementación Linux de la HAL: reloj virtual, modelos y ejecutor de ciclos.
+ * @details El estado que debe sobrevivir de un ciclo al siguiente (reloj, NVS,
+ *          modelos, copia de la sección HAL_PERSISTENT) vive en una región
+ *          MAP_SHARED creada por init() antes del primer fork(). Cada ciclo corre
+ *          en un proceso hijo que arranca desde la imagen limpia del padre, igual
+ *          que la RAM del ESP32 tras un deep sleep.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifdef HAL_NATIVE
+
+#include "HALNative.h"
+#include "Trace.h"
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Puntos de entrada del firmware (débiles: otros ejecutables enlazan la HAL sin setup())
+void setup() __attribute__((weak));
+void loop() __attribute__((weak));
+
+// Límites de la sección HAL_PERSISTENT (los define el enlazador GNU)
+extern "C" uint8_t __start_hal_persistent[] __attribute__((weak));
+extern "C" uint8_t __stop_hal_persistent[] __attribute__((weak));
+
+namespace HAL {
+namespace Native {
+
+    // ——— Estado compartido ———
+
+    /**
+     * @brief Valor NVS
+     */
+    typedef struct {
+        bool used;
+        char ns[16];
+        char key[16];
+        uint16_t length;
+        uint8_t value[HAL_NATIVE_NVS_VALUE_MAX];
+    } NvsEntry;
+
+    /**
+     * @brief Estado que comparten el ejecutor y los ciclos
+     */
+    typedef struct {
+        // Reloj
+        uint64_t true_us;            ///< Tiempo desde el inicio de la simulación
+        uint64_t rtc_us;             ///< Temporizador RTC (se reinicia al cortar la alimentación)
+        uint64_t boot_us;            ///< rtc_us al arrancar el ciclo actual
+        uint32_t start_epoch;        ///< Hora Unix verdadera en true_us = 0
+        int64_t sys_offset_us;       ///< Hora del sistema = rtc_us + sys_offset_us
+
+        // Despertar y fin de ciclo
+        esp_sleep_wakeup_cause_t wake_cause;
+        uint64_t ext1_status;
+        CycleEnd cycle_end;
+        uint64_t sleep_timer_us;
+        int ext0_pin;
+        int ext0_level;
+        uint64_t ext1_mask;
+        bool ext1_any_high;
+        uint64_t brownout_at_us;     ///< true_us del corte programado (0 = ninguno)
+
+        // Radio y tráfico del ciclo actual
+        bool radio_on;
+        uint64_t radio_since_us;
+        uint64_t radio_on_us;
+        uint32_t bytes_sent;
+        uint32_t bytes_received;
+
+        // Estímulos y configuración de pines
+        float analog_mv[HAL_NATIVE_PINS];
+        uint8_t adc_atten[HAL_NATIVE_PINS];
+        uint8_t adc_bits;
+        float adc_noise_lsb;
+        uint32_t adc_rng;
+        float onewire_c[HAL_NATIVE_PINS];
+        bool wifi_available;
+        int8_t wifi_rssi;
+        char server_host[64];
+        uint16_t server_port;
+        WebSocketPeer* ws_peer;
+
+        // Periféricos con estado
+        I2CDevice* i2c[128];
+        NvsEntry nvs[HAL_NATIVE_NVS_ENTRIES];
+
+        // RAM persistente
+        bool persistent_valid;
+        size_t persistent_size;
+
+        // Memoria para modelos
+        size_t arena_used;
+        alignas(16) uint8_t arena[HAL_NATIVE_SHARED_ARENA];
+    } SharedState;
+
+    static SharedState* state = nullptr;
+    static uint8_t* persistent_copy = nullptr;  ///< Sigue a state en la misma región
+    static uint8_t* persistent_image = nullptr; ///< Valores iniciales (arranque en frío)
+    static bool in_cycle = false;               ///< true en el proceso hijo de un ciclo
+
+    static size_t persistentSize() {
+        if (!__start_hal_persistent || !__stop_hal_persistent) return 0;
+        return (size_t)(__stop_hal_persistent - __start_hal_persistent);
+    }
+
+    /**
+     * @brief Estado compartido, creado en el primer uso
+     */
+    static SharedState* shared() {
+        if (!state) init();
+        return state;
+    }
+
+    void init() {
+        if (state) return;
+
+        size_t persistent = persistentSize();
+        size_t total = sizeof(SharedState) + 2 * persistent;
+        void* region = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED) {
+            perror("HAL nativo: mmap");
+            abort();
+        }
+
+        state = (SharedState*)region;  // mmap entrega ceros
+        persistent_copy = (uint8_t*)region + sizeof(SharedState);
+        persistent_image = persistent_copy + persistent;
+        if (persistent > 0) memcpy(persistent_image, __start_hal_persistent, persistent);
+        state->persistent_size = persistent;
+        state->start_epoch = HAL_NATIVE_DEFAULT_EPOCH;
+        state->wake_cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+        state->ext0_pin = -1;
+        state->adc_bits = 12;
+        state->wifi_available = true;
+        state->wifi_rssi = -60;
+        for (int i = 0; i < HAL_NATIVE_PINS; i++) {
+            state->analog_mv[i] = 0.0f;
+            state->adc_atten[i] = (uint8_t)AdcAtten::DB_12;
+            state->onewire_c[i] = NAN;
+        }
+    }
+
+    [[noreturn]] static void brownout();
+
+    // ——— Reloj virtual ———
+
+    void advanceUs(uint64_t us) {
+        SharedState* s = shared();
+        s->true_us += us;
+        s->rtc_us += us;
+        if (in_cycle && s->brownout_at_us != 0 && s->true_us >= s->brownout_at_us) brownout();
+    }
+
+    /**
+     * @brief Lectura del reloj: avanza un cuanto para que los sondeos progresen
+     */
+    static uint64_t readClock() {
+        advanceUs(HAL_NATIVE_CLOCK_READ_US);
+        return state->rtc_us;
+    }
+
+    uint64_t trueEpochUs() {
+        SharedState* s = shared();
+        return (uint64_t)s->start_epoch * 1000000ULL + s->true_us;
+    }
+
+    void setStartEpoch(uint32_t epoch) {
+        shared()->start_epoch = epoch;
+    }
+
+    /**
+     * @brief Microsegundos desde el arranque del ciclo (base de millis/micros)
+     */
+    uint64_t uptimeUs() {
+        uint64_t now = readClock();
+        return now - state->boot_us;
+    }
+
+    // ——— Estímulos ———
+
+    void setAnalogMilliVolts(uint8_t pin, float mv) {
+        if (pin < HAL_NATIVE_PINS) shared()->analog_mv[pin] = mv;
+    }
+
+    void setAnalogNoise(float lsb) {
+        shared()->adc_noise_lsb = lsb;
+    }
+
+    void setOneWireTemperature(uint8_t pin, float celsius) {
+        if (pin < HAL_NATIVE_PINS) shared()->onewire_c[pin] = celsius;
+    }
+
+    float getOneWireTemperature(uint8_t pin) {
+        return (pin < HAL_NATIVE_PINS) ? shared()->onewire_c[pin] : NAN;
+    }
+
+    void setWiFi(bool available, int8_t rssi) {
+        SharedState* s = shared();
+        s->wifi_available = available;
+        s->wifi_rssi = rssi;
+    }
+
+    bool wifiAvailable() {
+        return shared()->wifi_available;
+    }
+
+    int8_t wifiRssi() {
+        return shared()->wifi_rssi;
+    }
+
+    // ——— Radio ———
+
+    void setRadio(bool on) {
+        SharedState* s = shared();
+        if (on && !s->radio_on) {
+            s->radio_since_us = s->true_us;
+        } else if (!on && s->radio_on) {
+            s->radio_on_us += s->true_us - s->radio_since_us;
+        }
+        s->radio_on = on;
+    }
+
+    void countTraffic(size_t sent, size_t received) {
+        SharedState* s = shared();
+        s->bytes_sent += (uint32_t)sent;
+        s->bytes_received += (uint32_t)received;
+    }
+
+    void attachWebSocketPeer(WebSocketPeer* peer) {
+        shared()->ws_peer = peer;
+    }
+
+    WebSocketPeer* webSocketPeer() {
+        return shared()->ws_peer;
+    }
+
+    void setServerOverride(const char* host, uint16_t port) {
+        SharedState* s = shared();
+        if (host == nullptr) {
+            s->server_host[0] = '\0';
+            s->server_port = 0;
+            return;
+        }
+        snprintf(s->server_host, sizeof(s->server_host), "%s", host);
+        s->server_port = port;
+    }
+
+    void resolveServer(const char*& host, uint16_t& port) {
+        SharedState* s = shared();
+        if (s->server_host[0] != '\0') {
+            host = s->server_host;
+            port = s->server_port;
+        }
+    }
+
+    // ——— Modelo del ADC ———
+
+    /**
+     * @brief Fondo de escala (mV) por atenuación, rangos del ESP32-S2
+     */
+    static float fullScaleMv(AdcAtten atten) {
+        switch (atten) {
+            case AdcAtten::DB_0:   return 750.0f;
+            case AdcAtten::DB_2_5: return 1050.0f;
+            case AdcAtten::DB_6:   return 1300.0f;
+            default:               return 2500.0f;
+        }
+    }
+
+    uint16_t adcSample(uint8_t pin) {
+        SharedState* s = shared();
+        if (pin >= HAL_NATIVE_PINS) return 0;
+        float maxRaw = (float)((1u << s->adc_bits) - 1);
+        float raw = s->analog_mv[pin] / fullScaleMv((AdcAtten)s->adc_atten[pin]) * maxRaw;
+        if (s->adc_noise_lsb > 0.0f) {
+            s->adc_rng = s->adc_rng * 1664525u + 1013904223u;  // LCG: determinista entre corridas
+            raw += s->adc_noise_lsb * (2.0f * (s->adc_rng >> 8) / 16777216.0f - 1.0f);
+        }
+        if (raw < 0.0f) raw = 0.0f;
+        if (raw > maxRaw) raw = maxRaw;
+        return (uint16_t)lroundf(raw);
+    }
+
+    // ——— Dispositivos I2C ———
+
+    void attachI2CDevice(uint8_t address, I2CDevice* device) {
+        if (address < 128) shared()->i2c[address] = device;
+    }
+
+    I2CDevice* i2cDevice(uint8_t address) {
+        return (address < 128) ? shared()->i2c[address] : nullptr;
+    }
+
+    // ——— NVS ———
+
+    static NvsEntry* nvsFind(const char* ns, const char* key) {
+        SharedState* s = shared();
+        for (int i = 0; i < HAL_NATIVE_NVS_ENTRIES; i++) {
+            NvsEntry* e = &s->nvs[i];
+            if (e->used && strcmp(e->ns, ns) == 0 && strcmp(e->key, key) == 0) return e;
+        }
+        return nullptr;
+    }
+
+    const uint8_t* nvsGet(const char* ns, const char* key, size_t& length) {
+        NvsEntry* e = nvsFind(ns, key);
+        length = e ? e->length : 0;
+        return e ? e->value : nullptr;
+    }
+
+    size_t nvsPut(const char* ns, const char* key, const void* data, size_t length) {
+        if (length > HAL_NATIVE_NVS_VALUE_MAX || strlen(ns) >= 16 || strlen(key) >= 16) return 0;
+
+        NvsEntry* e = nvsFind(ns, key);
+        for (int i = 0; !e && i < HAL_NATIVE_NVS_ENTRIES; i++) {
+            if (!state->nvs[i].used) e = &state->nvs[i];
+        }
+        if (!e) return 0;
+
+        e->used = true;
+        snprintf(e->ns, sizeof(e->ns), "%s", ns);
+        snprintf(e->key, sizeof(e->key), "%s", key);
+        e->length = (uint16_t)length;
+        memcpy(e->value, data, length);
+        return length;
+    }
+
+    bool nvsRemove(const char* ns, const char* key) {
+        NvsEntry* e = nvsFind(ns, key);
+        if (!e) return false;
+        e->used = false;
+        return true;
+    }
+
+    void nvsClear(const char* ns) {
+        SharedState* s = shared();
+        for (int i = 0; i < HAL_NATIVE_NVS_ENTRIES; i++) {
+            if (s->nvs[i].used && strcmp(s->nvs[i].ns, ns) == 0) s->nvs[i].used = false;
+        }
+    }
+
+    // ——— Memoria compartida ———
+
+    void* sharedAlloc(size_t size) {
+        SharedState* s = shared();
+        size_t aligned = (size + 15) & ~(size_t)15;
+        if (s->arena_used + aligned > sizeof(s->arena)) return nullptr;
+        void* p = s->arena + s->arena_used;
+        s->arena_used += aligned;
+        return p;
+    }
+
+    // ——— Ejecutor ———
+
+    /**
+     * @brief Termina el ciclo del proceso hijo guardando la RAM persistente
+     */
+    [[noreturn]] static void finishCycle(CycleEnd end) {
+        if (state->persistent_size > 0) {
+            memcpy(persistent_copy, __start_hal_persistent, state->persistent_size);
+            state->persistent_valid = true;
+        }
+        setRadio(false);
+        state->cycle_end = end;
+        fflush(stdout);
+        _exit(0);
+    }
+
+    /**
+     * @brief Corte de alimentación: el ciclo muere sin guardar la RAM persistente
+     */
+    [[noreturn]] static void brownout() {
+        setRadio(false);
+        state->cycle_end = CYCLE_BROWNOUT;
+        fflush(stdout);
+        _exit(0);
+    }
+
+    CycleResult runCycle() {
+        SharedState* s = shared();
+        s->boot_us = s->rtc_us;
+        s->cycle_end = CYCLE_RUNNING;
+        s->sleep_timer_us = 0;
+        s->ext0_pin = -1;
+        s->ext1_mask = 0;
+        s->radio_on = false;
+        s->radio_on_us = 0;
+        s->bytes_sent = 0;
+        s->bytes_received = 0;
+
+        CycleResult result = {CYCLE_CRASH, 0, 0, -1, 0, false, 0, 0, 0};
+        fflush(stdout);
+        fflush(stderr);
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("HAL nativo: fork");
+            return result;
+        }
+        if (pid == 0) {
+            // Arranque: RAM limpia salvo la sección persistente, zona horaria UTC
+            in_cycle = true;
+            setenv("TZ", "UTC0", 1);
+            tzset();
+            if (s->persistent_size > 0) {
+                memcpy(__start_hal_persistent, s->persistent_valid ? persistent_copy : persistent_image,
+                       s->persistent_size);
+            }
+            if (setup) setup();
+            for (;;) {
+                if (loop) loop();
+                else HAL::deepSleep();
+            }
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+
+        result.end = (WIFEXITED(status) && s->cycle_end != CYCLE_RUNNING) ? s->cycle_end : CYCLE_CRASH;
+        result.awake_us = s->rtc_us - s->boot_us;
+        result.sleep_us = s->sleep_timer_us;
+        result.ext0_pin = s->ext0_pin;
+        result.ext1_mask = s->ext1_mask;
+        result.ext1_any_high = s->ext1_any_high;
+        result.radio_on_us = s->radio_on_us;
+        result.bytes_sent = s->bytes_sent;
+        result.bytes_received = s->bytes_received;
+        s->brownout_at_us = 0;
+        return result;
+    }
+
+    void wake(uint64_t afterUs, esp_sleep_wakeup_cause_t cause, uint64_t ext1Status) {
+        advanceUs(afterUs);
+        state->wake_cause = cause;
+        state->ext1_status = ext1Status;
+    }
+
+    void powerCycle() {
+        SharedState* s = shared();
+        s->persistent_valid = false;
+        s->rtc_us = 0;
+        s->sys_offset_us = 0;
+        s->wake_cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+        s->ext1_status = 0;
+    }
+
+    void scheduleBrownout(uint64_t afterUs) {
+        SharedState* s = shared();
+        s->brownout_at_us = s->true_us + (afterUs ? afterUs : 1);
+    }
+
+    bool loadPersistent() {
+        SharedState* s = shared();
+        if (!s->persistent_valid || s->persistent_size == 0) return false;
+        memcpy(__start_hal_persistent, persistent_copy, s->persistent_size);
+        return true;
+    }
+
+    int run(int argc, char** argv) {
+        init();
+
+        unsigned long cycles = 3;
+        for (int i = 1; i < argc; i++) {
+            if (strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+                cycles = strtoul(argv[++i], nullptr, 10);
+            } else if (strcmp(argv[i], "--epoch") == 0 && i + 1 < argc) {
+                setStartEpoch((uint32_t)strtoul(argv[++i], nullptr, 10));
+            } else if (strcmp(argv[i], "--server") == 0 && i + 1 < argc) {
+                char host[64];
+                snprintf(host, sizeof(host), "%s", argv[++i]);
+                char* colon = strrchr(host, ':');
+                uint16_t port = 8765;
+                if (colon) {
+                    *colon = '\0';
+                    port = (uint16_t)atoi(colon + 1);
+                }
+                setServerOverride(host, port);
+            } else if (strcmp(argv[i], "--no-wifi") == 0) {
+                setWiFi(false);
+            } else {
+                fprintf(stderr, "Uso: %s [--cycles N] [--epoch E] [--server host:puerto] [--no-wifi]\n", argv[0]);
+                return 2;
+            }
+        }
+
+        for (unsigned long i = 0; i < cycles; i++) {
+            CycleResult r = runCycle();
+            fprintf(stderr, "[HAL] ciclo %lu: despierto %.3f s", i + 1, r.awake_us / 1e6);
+            if (r.radio_on_us > 0) {
+                fprintf(stderr, ", radio %.3f s (%u B enviados, %u B recibidos)",
+                        r.radio_on_us / 1e6, (unsigned)r.bytes_sent, (unsigned)r.bytes_received);
+            }
+
+            switch (r.end) {
+                case CYCLE_DEEP_SLEEP:
+                    if (r.sleep_us == 0) {
+                        fprintf(stderr, ", deep sleep sin temporizador - fin\n");
+                        return 1;
+                    }
+                    fprintf(stderr, ", duerme %.1f s\n", r.sleep_us / 1e6);
+                    wake(r.sleep_us, ESP_SLEEP_WAKEUP_TIMER);
+                    break;
+                case CYCLE_RESTART:
+                    fprintf(stderr, ", reinicio por software\n");
+                    wake(0, ESP_SLEEP_WAKEUP_UNDEFINED);
+                    break;
+                default:
+                    fprintf(stderr, ", terminó de forma inesperada\n");
+                    return 1;
+            }
+        }
+        return 0;
+    }
+
+} // namespace Native
+
+    // ——— API de la HAL ———
+
+    uint64_t rtcTimeUs() {
+        Native::shared();
+        return Native::readClock();
+    }
+
+    void getTimeOfDay(struct timeval* tv) {
+        Native::SharedState* s = Native::shared();
+        int64_t us = (int64_t)Native::readClock() + s->sys_offset_us;
+        tv->tv_sec = (time_t)(us / 1000000LL);
+        tv->tv_usec = (suseconds_t)(us % 1000000LL);
+    }
+
+    void setTimeOfDay(const struct timeval* tv) {
+        Native::SharedState* s = Native::shared();
+        int64_t us = (int64_t)tv->tv_sec * 1000000LL + tv->tv_usec;
+        s->sys_offset_us = us - (int64_t)s->rtc_us;
+    }
+
+    void adcConfigure(uint8_t pin, uint8_t bits, AdcAtten atten) {
+        Native::SharedState* s = Native::shared();
+        s->adc_bits = bits;
+        if (pin < HAL_NATIVE_PINS) s->adc_atten[pin] = (uint8_t)atten;
+    }
+
+    void adcCalibrate(AdcCalibration* cal, AdcAtten atten, uint8_t bits, uint32_t vrefMv) {
+        cal->atten = atten;
+        cal->bits = bits;
+        cal->vref_mv = vrefMv;
+    }
+
+    uint16_t adcRead(uint8_t pin) {
+        Native::advanceUs(20);  // Conversión SAR
+        uint16_t raw;
+        if (!Trace::replayAdc(pin, raw)) raw = Native::adcSample(pin);
+        Trace::recordAdc(pin, raw);
+        return raw;
+    }
+
+    uint32_t adcToMilliVolts(uint32_t raw, const AdcCalibration* cal) {
+        // Como esp_adc_cal: interpreta raw con el ancho caracterizado
+        float maxRaw = (float)((1u << cal->bits) - 1);
+        return (uint32_t)lroundf((float)raw * Native::fullScaleMv(cal->atten) / maxRaw);
+    }
+
+    uint32_t crc32(uint32_t crc, const uint8_t* data, size_t length) {
+        static uint32_t table[256];
+        if (table[1] == 0) {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+                table[i] = c;
+            }
+        }
+        // Igual que crc32_le de la ROM: complemento a la entrada y a la salida
+        crc = ~crc;
+        for (size_t i = 0; i < length; i++) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    // ——— Heap ———
+
+    static uint32_t heap_allocations = 0;  ///< Del proceso (un ciclo hereda el valor del padre)
+
+    uint32_t heapAllocations() { return heap_allocations; }
+    bool heapAllocationsCounted() { return true; }
+
+    esp_sleep_wakeup_cause_t wakeupCause() {
+        return Native::shared()->wake_cause;
+    }
+
+    uint64_t wakeupExt1Status() {
+        return Native::shared()->ext1_status;
+    }
+
+    void sleepEnableTimer(uint64_t us) {
+        Native::shared()->sleep_timer_us = us;
+    }
+
+    void sleepEnableExt0(int pin, int level) {
+        Native::SharedState* s = Native::shared();
+        s->ext0_pin = pin;
+        s->ext0_level = level;
+    }
+
+    void sleepEnableExt1(uint64_t mask, bool anyHigh, bool pullup) {
+        (void)pullup;
+        Native::SharedState* s = Native::shared();
+        s->ext1_mask = mask;
+        s->ext1_any_high = anyHigh;
+    }
+
+    void deepSleep() {
+        Native::finishCycle(Native::CYCLE_DEEP_SLEEP);
+    }
+
+    void restart() {
+        Native::finishCycle(Native::CYCLE_RESTART);
+    }
+
+} // namespace HAL
+
+// Interposición de glibc: malloc, calloc y realloc del programa (String, new,
+// ArduinoJson, la libc) pasan por aquí y siguen en el asignador original
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+
+    void* malloc(size_t size) {
+        HAL::heap_allocations++;
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) {
+        HAL::heap_allocations++;
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, size_t size) {
+        HAL::heap_allocations++;
+        return __libc_realloc(ptr, size);
+    }
+}
+
+#endif // HAL_NATIVE
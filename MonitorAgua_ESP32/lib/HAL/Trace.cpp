@@ -0,0 +1,219 @@
+/**
+ * @file Trace.cpp
+ * @brief Implementación de la grabación y reproducción de muestras crudas.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include "Trace.h"
+#include <string.h>
+#include <math.h>
+
+namespace HAL {
+namespace Trace {
+
+    bool nextRecord(const uint8_t* data, size_t length, size_t& pos, Record& record) {
+        if (pos + 3 > length) return false;
+        record.type = data[pos];
+        record.channel = data[pos + 1];
+        record.length = data[pos + 2];
+        if (pos + 3 + record.length > length) return false;
+        record.data = data + pos + 3;
+        pos += 3 + record.length;
+        return true;
+    }
+
+#if HAL_TRACE_ENABLED
+
+    // ——— Grabación ———
+
+    static uint8_t buffer[HAL_TRACE_BUFFER_BYTES];
+    static size_t used = 0;
+    static uint32_t trace_tag = 0;
+    static bool recording = false;
+    static bool full = false;
+
+    /**
+     * @brief Cursor de reproducción de un canal
+     */
+    typedef struct {
+        uint8_t type;
+        uint8_t channel;
+        size_t pos;        ///< Próximo registro a examinar
+    } Cursor;
+
+    static const uint8_t* replay_data = nullptr;
+    static size_t replay_length = 0;
+    static Cursor cursors[HAL_TRACE_MAX_CURSORS];
+    static size_t cursor_count = 0;
+    static uint32_t miss_count = 0;
+
+    static void append(uint8_t type, uint8_t channel, const uint8_t* payload, size_t length) {
+        if (!recording || full) return;
+        if (used + 3 + length > sizeof(buffer)) {
+            full = true;  // Truncada: lo grabado hasta aquí sigue siendo coherente
+            return;
+        }
+        buffer[used++] = type;
+        buffer[used++] = channel;
+        buffer[used++] = (uint8_t)length;
+        if (length) memcpy(buffer + used, payload, length);
+        used += length;
+    }
+
+    void start(uint32_t tag) {
+        used = 0;
+        trace_tag = tag;
+        full = false;
+        recording = (replay_data == nullptr);
+    }
+
+    void stop() {
+        recording = false;
+    }
+
+    void recordAdc(uint8_t pin, uint16_t raw) {
+        uint8_t payload[2] = {(uint8_t)raw, (uint8_t)(raw >> 8)};
+        append((uint8_t)Source::ADC, pin, payload, sizeof(payload));
+    }
+
+    void recordOneWire(uint8_t pin, float celsius) {
+        // getTempC() devuelve raw * 0.0078125: el crudo se recupera sin pérdida
+        int16_t raw = (int16_t)lroundf(celsius * 128.0f);
+        uint8_t payload[2] = {(uint8_t)raw, (uint8_t)((uint16_t)raw >> 8)};
+        append((uint8_t)Source::ONEWIRE, pin, payload, sizeof(payload));
+    }
+
+    void recordI2C(uint8_t address, const uint8_t* data, size_t length) {
+        if (length > 0xFF) length = 0xFF;
+        append((uint8_t)Source::I2C, address, data, length);
+    }
+
+    const uint8_t* data() { return buffer; }
+    size_t size() { return used; }
+    uint32_t tag() { return trace_tag; }
+    bool overflowed() { return full; }
+
+    size_t encodeBase64(char* out, size_t capacity) {
+        static const char ALPHABET[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        size_t needed = ((used + 2) / 3) * 4;
+        if (needed + 1 > capacity) return 0;
+
+        size_t o = 0;
+        for (size_t i = 0; i < used; i += 3) {
+            uint32_t chunk = (uint32_t)buffer[i] << 16;
+            if (i + 1 < used) chunk |= (uint32_t)buffer[i + 1] << 8;
+            if (i + 2 < used) chunk |= buffer[i + 2];
+            out[o++] = ALPHABET[(chunk >> 18) & 0x3F];
+            out[o++] = ALPHABET[(chunk >> 12) & 0x3F];
+            out[o++] = (i + 1 < used) ? ALPHABET[(chunk >> 6) & 0x3F] : '=';
+            out[o++] = (i + 2 < used) ? ALPHABET[chunk & 0x3F] : '=';
+        }
+        out[o] = '\0';
+        return o;
+    }
+
+    // ——— Reproducción ———
+
+    void replay(const uint8_t* data, size_t length) {
+        replay_data = data;
+        replay_length = length;
+        cursor_count = 0;
+        miss_count = 0;
+        recording = false;
+    }
+
+    void endReplay() {
+        replay_data = nullptr;
+        replay_length = 0;
+        cursor_count = 0;
+    }
+
+    bool replaying() {
+        return replay_data != nullptr;
+    }
+
+    uint32_t misses() {
+        return miss_count;
+    }
+
+    static Cursor* cursorFor(Source source, uint8_t channel) {
+        for (size_t i = 0; i < cursor_count; i++) {
+            if (cursors[i].type == (uint8_t)source && cursors[i].channel == channel) return &cursors[i];
+        }
+        if (cursor_count >= HAL_TRACE_MAX_CURSORS) return nullptr;
+        Cursor* c = &cursors[cursor_count++];
+        c->type = (uint8_t)source;
+        c->channel = channel;
+        c->pos = 0;
+        return c;
+    }
+
+    void beginBurst(Source source, uint8_t channel) {
+        if (!replay_data) {
+            append((uint8_t)source | HAL_TRACE_MARK, channel, nullptr, 0);
+            return;
+        }
+
+        Cursor* c = cursorFor(source, channel);
+        if (!c) return;
+        Record r;
+        size_t pos = c->pos;
+        while (nextRecord(replay_data, replay_length, pos, r)) {
+            if (r.type == ((uint8_t)source | HAL_TRACE_MARK) && r.channel == channel) {
+                c->pos = pos;
+                return;
+            }
+        }
+        c->pos = replay_length;  // Sin más ráfagas: lo que pida esta lectura son fallos
+    }
+
+    /**
+     * @brief Próxima muestra del canal sin cruzar la marca de la ráfaga siguiente
+     */
+    static bool nextSample(Source source, uint8_t channel, Record& out) {
+        Cursor* c = replay_data ? cursorFor(source, channel) : nullptr;
+        if (!c) return false;
+
+        Record r;
+        size_t pos = c->pos;
+        while (nextRecord(replay_data, replay_length, pos, r)) {
+            if (r.channel != channel || (r.type & ~HAL_TRACE_MARK) != (uint8_t)source) continue;
+            if (r.type & HAL_TRACE_MARK) break;
+            c->pos = pos;
+            out = r;
+            return true;
+        }
+        miss_count++;
+        return false;
+    }
+
+    bool replayAdc(uint8_t pin, uint16_t& raw) {
+        Record r;
+        if (!nextSample(Source::ADC, pin, r) || r.length != 2) return false;
+        raw = (uint16_t)(r.data[0] | (r.data[1] << 8));
+        return true;
+    }
+
+    bool replayOneWire(uint8_t pin, float& celsius) {
+        Record r;
+        if (!nextSample(Source::ONEWIRE, pin, r) || r.length != 2) return false;
+        celsius = (int16_t)(r.data[0] | (r.data[1] << 8)) * 0.0078125f;
+        return true;
+    }
+
+    bool replayI2C(uint8_t address, uint8_t* out, size_t length) {
+        Record r;
+        if (!nextSample(Source::I2C, address, r)) return false;
+        size_t n = (r.length < length) ? r.length : length;
+        memcpy(out, r.data, n);
+        memset(out + n, 0xFF, length - n);  // Bus sin respuesta para lo que no se grabó
+        return true;
+    }
+
+#endif // HAL_TRACE_ENABLED
+
+} // namespace Trace
+} // namespace HAL
@@ -0,0 +1,165 @@
+/**
+ * @file Trace.h
+ * @brief Grabación y reproducción de las muestras crudas de los sensores.
+ * @details Las llamadas de la HAL que traen datos del mundo (HAL::adcRead(), la
+ *          temperatura del DS18B20 y las lecturas I2C del RTC) pasan por aquí:
+ *
+ *          - En el equipo, compilado con -D HAL_TRACE, cada muestra se anota en un
+ *            búfer de RAM que WiFiManager sube al servidor al final de la descarga
+ *            ({"action":"sensor_trace"}). servidor.py la guarda en traces/.
+ *          - En Linux (HAL_NATIVE) replay() sustituye el modelo de la HAL por las
+ *            muestras grabadas: el mismo código de TDSSensor, TurbiditySensor,
+ *            pHSensor y TemperatureSensor recibe bit a bit lo que vio en campo
+ *            (replay/main.cpp).
+ *
+ *          Cada lectura de un sensor empieza con beginBurst(): en la grabación es
+ *          una marca y en la reproducción salta a la ráfaga siguiente de ese canal.
+ *          Si un cambio de filtro o de parada temprana consume menos (o más)
+ *          muestras, las lecturas siguientes siguen alineadas; las muestras que
+ *          falten cuentan como fallos (misses()) y las entrega el modelo.
+ *
+ *          Formato: registros [tipo][canal][longitud][datos], little-endian.
+ *          Sin HAL_TRACE (firmware normal) todas las funciones son inline vacías.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_TRACE_H
+#define HAL_TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(HAL_TRACE) || defined(HAL_NATIVE)
+#define HAL_TRACE_ENABLED 1
+#else
+#define HAL_TRACE_ENABLED 0
+#endif
+
+#define HAL_TRACE_BUFFER_BYTES  4096        // Un ciclo: ~400 muestras ADC + marcas
+#define HAL_TRACE_FILE_MAGIC    0x31545157UL // "WQT1": cabecera de cada traza en archivo
+#define HAL_TRACE_MAX_CURSORS   16          // Canales distintos en una reproducción
+#define HAL_TRACE_MARK          0x80        // Bit de tipo de las marcas de ráfaga
+
+namespace HAL {
+namespace Trace {
+
+    /**
+     * @enum Source
+     * @brief Origen de una muestra (el canal es el pin o la dirección I2C)
+     */
+    enum class Source : uint8_t {
+        ADC = 1,      ///< uint16: valor crudo de HAL::adcRead()
+        ONEWIRE = 2,  ///< int16: temperatura del DS18B20 en 1/128 °C (su formato crudo)
+        I2C = 3       ///< Bytes leídos de la dirección
+    };
+
+    /**
+     * @brief Registro decodificado
+     */
+    typedef struct {
+        uint8_t type;          ///< Source, con HAL_TRACE_MARK en las marcas
+        uint8_t channel;
+        uint8_t length;
+        const uint8_t* data;
+    } Record;
+
+    /**
+     * @brief Cabecera de cada traza en un archivo (la escribe servidor.py)
+     */
+    typedef struct __attribute__((packed)) {
+        uint32_t magic;        ///< HAL_TRACE_FILE_MAGIC
+        uint32_t tag;          ///< Número de lectura del ciclo grabado
+        uint32_t length;       ///< Bytes de registros que siguen
+    } FileHeader;
+
+    /**
+     * @brief Decodifica el registro en pos y avanza
+     * @return false al final o si el registro está truncado
+     */
+    bool nextRecord(const uint8_t* data, size_t length, size_t& pos, Record& record);
+
+#if HAL_TRACE_ENABLED
+
+    // ——— Grabación ———
+
+    /**
+     * @brief Empieza una traza nueva (descarta la anterior)
+     * @param tag Identificador del ciclo (número de lectura)
+     */
+    void start(uint32_t tag);
+
+    /**
+     * @brief Deja de grabar (la traza sigue disponible)
+     */
+    void stop();
+
+    /**
+     * @brief Comienzo de una lectura del sensor en ese canal
+     */
+    void beginBurst(Source source, uint8_t channel);
+
+    void recordAdc(uint8_t pin, uint16_t raw);
+    void recordOneWire(uint8_t pin, float celsius);
+    void recordI2C(uint8_t address, const uint8_t* data, size_t length);
+
+    const uint8_t* data();
+    size_t size();
+    uint32_t tag();
+    bool overflowed();  ///< El búfer se llenó: la traza está truncada
+
+    /**
+     * @brief Codifica la traza en base64 (para el mensaje JSON)
+     * @return Caracteres escritos (0 si no cabe)
+     */
+    size_t encodeBase64(char* out, size_t capacity);
+
+    // ——— Reproducción ———
+
+    /**
+     * @brief Reproduce una traza en lugar de los modelos (solo HAL_NATIVE)
+     * @param data Registros (deben seguir vivos mientras dure la reproducción)
+     */
+    void replay(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Termina la reproducción (vuelven los modelos)
+     */
+    void endReplay();
+
+    bool replaying();
+
+    /**
+     * @brief Próxima muestra de la ráfaga actual del canal
+     * @return false si no hay reproducción o la ráfaga se agotó (cuenta un fallo)
+     */
+    bool replayAdc(uint8_t pin, uint16_t& raw);
+    bool replayOneWire(uint8_t pin, float& celsius);
+    bool replayI2C(uint8_t address, uint8_t* out, size_t length);
+
+    /**
+     * @brief Muestras pedidas que la traza no tenía desde replay()
+     */
+    uint32_t misses();
+
+#else
+
+    inline void start(uint32_t) {}
+    inline void stop() {}
+    inline void beginBurst(Source, uint8_t) {}
+    inline void recordAdc(uint8_t, uint16_t) {}
+    inline void recordOneWire(uint8_t, float) {}
+    inline void recordI2C(uint8_t, const uint8_t*, size_t) {}
+    inline const uint8_t* data() { return nullptr; }
+    inline size_t size() { return 0; }
+    inline uint32_t tag() { return 0; }
+    inline bool overflowed() { return false; }
+    inline size_t encodeBase64(char*, size_t) { return 0; }
+
+#endif
+
+} // namespace Trace
+} // namespace HAL
+
+#endif // HAL_TRACE_H
@@ -0,0 +1,206 @@
+/**
+ * @file Arduino.h
+ * @brief Subconjunto del núcleo Arduino-ESP32 para el entorno `native` de la HAL.
+ * @details Cubre solo lo que usan las librerías y main.cpp: tiempo (sobre el
+ *          reloj virtual), pines, Serial (stdout), String, ESP, SNTP y las
+ *          primitivas de FreeRTOS del Logger. xTaskCreate() falla a propósito:
+ *          sin tareas el Logger escribe de forma síncrona y la salida es
+ *          determinista.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_NATIVE_ARDUINO_H
+#define HAL_NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+#include <algorithm>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+/**
+ * @def RTC_DATA_ATTR
+ * @brief Equivalente nativo de la RTC slow memory (ver HAL_PERSISTENT)
+ */
+#define RTC_DATA_ATTR __attribute__((section("hal_persistent")))
+#define IRAM_ATTR
+
+using std::min;
+using std::max;
+
+// ——— Tiempo (reloj virtual) ———
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+// ——— Pines ———
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+// ——— SNTP ———
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
+bool getLocalTime(struct tm* info, uint32_t ms = 5000);
+
+// ——— FreeRTOS (sin planificador) ———
+typedef void* TaskHandle_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void (*TaskFunction_t)(void*);
+#define pdPASS            1
+#define pdFAIL            0
+#define pdTRUE            1
+#define pdFALSE           0
+#define portMAX_DELAY     0xFFFFFFFFu
+#define tskIDLE_PRIORITY  0
+#define portTICK_PERIOD_MS 1
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name, uint32_t stack,
+                       void* arg, UBaseType_t priority, TaskHandle_t* handle);
+void xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait);
+void vTaskDelay(TickType_t ticks);
+
+// ——— String ———
+
+/**
+ * @class String
+ * @brief String dinámico con la interfaz que usa el firmware (y ArduinoJson).
+ */
+class String {
+public:
+    String(const char* text = "");
+    String(const String& other);
+    String(String&& other) noexcept;
+    explicit String(char c);
+    explicit String(int value);
+    explicit String(unsigned int value);
+    explicit String(long value);
+    explicit String(unsigned long value);
+    explicit String(float value, unsigned int decimals = 2);
+    explicit String(double value, unsigned int decimals = 2);
+    ~String();
+
+    String& operator=(const String& other);
+    String& operator=(String&& other) noexcept;
+    String& operator=(const char* text);
+
+    String& operator+=(const String& other);
+    String& operator+=(const char* text);
+    String& operator+=(char c);
+
+    bool concat(const char* text);
+    bool concat(const char* text, unsigned int length);
+    bool concat(const String& other);
+    bool concat(char c);
+    bool reserve(unsigned int size);
+
+    const char* c_str() const { return _buffer ? _buffer : ""; }
+    unsigned int length() const { return _length; }
+    bool isEmpty() const { return _length == 0; }
+    char operator[](unsigned int index) const { return index < _length ? _buffer[index] : 0; }
+
+    int indexOf(const char* text, unsigned int from = 0) const;
+    int indexOf(char c, unsigned int from = 0) const;
+    bool startsWith(const char* prefix) const;
+    bool equals(const char* text) const;
+    bool operator==(const char* text) const { return equals(text); }
+    bool operator==(const String& other) const { return equals(other.c_str()); }
+    bool operator!=(const char* text) const { return !equals(text); }
+    String substring(unsigned int from, unsigned int to = 0xFFFFFFFFu) const;
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return (float)atof(c_str()); }
+
+private:
+    char* _buffer;
+    unsigned int _length;
+    unsigned int _capacity;
+};
+
+/**
+ * @class StringSumHelper
+ * @brief Resultado de las concatenaciones (ArduinoJson lo reconoce como String)
+ */
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+    StringSumHelper(const char* p) : String(p) {}
+};
+
+StringSumHelper operator+(const String& a, const String& b);
+StringSumHelper operator+(const String& a, const char* b);
+StringSumHelper operator+(const char* a, const String& b);
+
+// ——— Serial ———
+
+/**
+ * @class HardwareSerial
+ * @brief UART0 redirigida a stdout; sin entrada.
+ */
+class HardwareSerial {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+    explicit operator bool() const { return true; }
+    int available() { return 0; }
+    int read() { return -1; }
+    void flush() { fflush(stdout); }
+    size_t write(uint8_t c) { return fwrite(&c, 1, 1, stdout); }
+    size_t write(const uint8_t* data, size_t length) { return fwrite(data, 1, length, stdout); }
+    size_t write(const char* text) { return fputs(text, stdout) >= 0 ? strlen(text) : 0; }
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    size_t print(const char* text) { return write(text); }
+    size_t print(const String& text) { return write(text.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value) { return printf("%d", value); }
+    size_t print(unsigned int value) { return printf("%u", value); }
+    size_t print(long value) { return printf("%ld", value); }
+    size_t print(unsigned long value) { return printf("%lu", value); }
+    size_t print(double value, int decimals = 2) { return printf("%.*f", decimals, value); }
+    size_t println() { return write("\n"); }
+    size_t println(const char* text) { return write(text) + write("\n"); }
+    size_t println(const String& text) { return println(text.c_str()); }
+    size_t println(int value) { return printf("%d\n", value); }
+    size_t println(unsigned int value) { return printf("%u\n", value); }
+    size_t println(long value) { return printf("%ld\n", value); }
+    size_t println(unsigned long value) { return printf("%lu\n", value); }
+    size_t println(double value, int decimals = 2) { return printf("%.*f\n", decimals, value); }
+};
+
+extern HardwareSerial Serial;
+
+// ——— ESP ———
+
+/**
+ * @class EspClass
+ * @brief Consultas del sistema
+ */
+class EspClass {
+public:
+    uint32_t getFreeHeap();
+    [[noreturn]] void restart();
+};
+
+extern EspClass ESP;
+
+#endif // HAL_NATIVE_ARDUINO_H
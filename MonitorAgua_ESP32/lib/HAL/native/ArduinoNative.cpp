@@ -0,0 +1,341 @@
+/**
+ * @file ArduinoNative.cpp
+ * @brief Núcleo Arduino del entorno `native` sobre el reloj virtual de la HAL.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifdef HAL_NATIVE
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "HALNative.h"
+
+#define NATIVE_SNTP_RESPONSE_MS  120     // Tiempo virtual de una respuesta NTP
+#define NATIVE_FREE_HEAP         180000  // Heap libre reportado (típico tras el arranque)
+#define NATIVE_YIELD_US          1000    // delay(0)/yield(): un tick de FreeRTOS
+
+HardwareSerial Serial;
+EspClass ESP;
+
+// ——— Tiempo ———
+
+unsigned long millis() {
+    return (unsigned long)(uint32_t)(HAL::Native::uptimeUs() / 1000ULL);
+}
+
+unsigned long micros() {
+    return (unsigned long)(uint32_t)HAL::Native::uptimeUs();
+}
+
+/**
+ * @note delay(0) cede la CPU: se adelanta un tick completo para que los sondeos
+ *       con millis() avancen de a 1 ms (misma cadencia observable, sin millones
+ *       de iteraciones por segundo virtual).
+ */
+void delay(uint32_t ms) {
+    HAL::Native::advanceUs(ms ? (uint64_t)ms * 1000ULL : NATIVE_YIELD_US);
+}
+
+void delayMicroseconds(uint32_t us) {
+    HAL::Native::advanceUs(us);
+}
+
+void yield() {
+    HAL::Native::advanceUs(NATIVE_YIELD_US);
+}
+
+// ——— Pines ———
+
+static uint8_t pin_mode[HAL_NATIVE_PINS];
+static uint8_t pin_level[HAL_NATIVE_PINS];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= HAL_NATIVE_PINS) return;
+    pin_mode[pin] = mode;
+    if (mode == INPUT_PULLUP) pin_level[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin < HAL_NATIVE_PINS) pin_level[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return (pin < HAL_NATIVE_PINS) ? pin_level[pin] : LOW;
+}
+
+// ——— SNTP ———
+
+static bool sntp_pending = false;
+static uint32_t sntp_requests = 0;
+
+uint32_t HAL::Native::sntpRequests() {
+    return sntp_requests;
+}
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2, const char* server3) {
+    (void)server1;
+    (void)server2;
+    (void)server3;
+
+    // Misma zona POSIX que arma Arduino-ESP32 (signo invertido)
+    long offset = gmtOffsetSec + daylightOffsetSec;
+    long absOffset = labs(offset);
+    char tz[24];
+    snprintf(tz, sizeof(tz), "UTC%c%ld:%02ld", offset < 0 ? '+' : '-',
+             absOffset / 3600, (absOffset % 3600) / 60);
+    setenv("TZ", tz, 1);
+    tzset();
+
+    sntp_pending = true;
+    sntp_requests++;
+}
+
+bool getLocalTime(struct tm* info, uint32_t ms) {
+    uint32_t start = millis();
+    for (;;) {
+        if (sntp_pending && WiFi.isConnected()) {
+            delay(NATIVE_SNTP_RESPONSE_MS);
+            uint64_t now = HAL::Native::trueEpochUs();
+            struct timeval tv = {(time_t)(now / 1000000ULL), (suseconds_t)(now % 1000000ULL)};
+            HAL::setTimeOfDay(&tv);
+            sntp_pending = false;
+        }
+
+        struct timeval tv;
+        HAL::getTimeOfDay(&tv);
+        time_t now = tv.tv_sec;
+        localtime_r(&now, info);
+        if (info->tm_year > (2016 - 1900)) return true;
+
+        if (millis() - start >= ms) return false;
+        delay(10);
+    }
+}
+
+// ——— FreeRTOS ———
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name, uint32_t stack,
+                       void* arg, UBaseType_t priority, TaskHandle_t* handle) {
+    (void)task;
+    (void)name;
+    (void)stack;
+    (void)arg;
+    (void)priority;
+    if (handle) *handle = nullptr;
+    return pdFAIL;
+}
+
+void xTaskNotifyGive(TaskHandle_t task) {
+    (void)task;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait) {
+    (void)clear;
+    (void)wait;
+    return 0;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    delay(ticks * portTICK_PERIOD_MS);
+}
+
+// ——— String ———
+
+String::String(const char* text) : _buffer(nullptr), _length(0), _capacity(0) {
+    concat(text ? text : "");
+}
+
+String::String(const String& other) : _buffer(nullptr), _length(0), _capacity(0) {
+    concat(other.c_str(), other._length);
+}
+
+String::String(String&& other) noexcept
+    : _buffer(other._buffer), _length(other._length), _capacity(other._capacity) {
+    other._buffer = nullptr;
+    other._length = 0;
+    other._capacity = 0;
+}
+
+String::String(char c) : _buffer(nullptr), _length(0), _capacity(0) {
+    concat(c);
+}
+
+String::String(int value) : _buffer(nullptr), _length(0), _capacity(0) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%d", value);
+    concat(buf);
+}
+
+String::String(unsigned int value) : _buffer(nullptr), _length(0), _capacity(0) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u", value);
+    concat(buf);
+}
+
+String::String(long value) : _buffer(nullptr), _length(0), _capacity(0) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%ld", value);
+    concat(buf);
+}
+
+String::String(unsigned long value) : _buffer(nullptr), _length(0), _capacity(0) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%lu", value);
+    concat(buf);
+}
+
+String::String(float value, unsigned int decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned int decimals) : _buffer(nullptr), _length(0), _capacity(0) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimals, value);
+    concat(buf);
+}
+
+String::~String() {
+    free(_buffer);
+}
+
+String& String::operator=(const String& other) {
+    if (this != &other) {
+        _length = 0;
+        concat(other.c_str(), other._length);
+    }
+    return *this;
+}
+
+String& String::operator=(String&& other) noexcept {
+    if (this != &other) {
+        free(_buffer);
+        _buffer = other._buffer;
+        _length = other._length;
+        _capacity = other._capacity;
+        other._buffer = nullptr;
+        other._length = 0;
+        other._capacity = 0;
+    }
+    return *this;
+}
+
+String& String::operator=(const char* text) {
+    _length = 0;
+    concat(text ? text : "");
+    return *this;
+}
+
+String& String::operator+=(const String& other) {
+    concat(other);
+    return *this;
+}
+
+String& String::operator+=(const char* text) {
+    concat(text);
+    return *this;
+}
+
+String& String::operator+=(char c) {
+    concat(c);
+    return *this;
+}
+
+bool String::reserve(unsigned int size) {
+    if (_buffer && _capacity >= size) return true;
+    char* grown = (char*)realloc(_buffer, size + 1);
+    if (!grown) return false;
+    if (!_buffer) grown[0] = '\0';
+    _buffer = grown;
+    _capacity = size;
+    return true;
+}
+
+bool String::concat(const char* text, unsigned int length) {
+    if (!text) return false;
+    if (!reserve(_length + length)) return false;
+    memmove(_buffer + _length, text, length);
+    _length += length;
+    _buffer[_length] = '\0';
+    return true;
+}
+
+bool String::concat(const char* text) {
+    return text ? concat(text, (unsigned int)strlen(text)) : false;
+}
+
+bool String::concat(const String& other) {
+    return concat(other.c_str(), other._length);
+}
+
+bool String::concat(char c) {
+    return concat(&c, 1);
+}
+
+int String::indexOf(const char* text, unsigned int from) const {
+    if (from >= _length || !text) return -1;
+    const char* found = strstr(c_str() + from, text);
+    return found ? (int)(found - c_str()) : -1;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    if (from >= _length) return -1;
+    const char* found = strchr(c_str() + from, c);
+    return found ? (int)(found - c_str()) : -1;
+}
+
+bool String::startsWith(const char* prefix) const {
+    return strncmp(c_str(), prefix, strlen(prefix)) == 0;
+}
+
+bool String::equals(const char* text) const {
+    return strcmp(c_str(), text ? text : "") == 0;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (to > _length) to = _length;
+    if (from >= to) return String();
+    String out;
+    out.concat(c_str() + from, to - from);
+    return out;
+}
+
+StringSumHelper operator+(const String& a, const String& b) {
+    StringSumHelper out(a);
+    out += b;
+    return out;
+}
+
+StringSumHelper operator+(const String& a, const char* b) {
+    StringSumHelper out(a);
+    out += b;
+    return out;
+}
+
+StringSumHelper operator+(const char* a, const String& b) {
+    StringSumHelper out(a);
+    out += b;
+    return out;
+}
+
+// ——— Serial ———
+
+size_t HardwareSerial::printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int n = vfprintf(stdout, format, args);
+    va_end(args);
+    return (n > 0) ? (size_t)n : 0;
+}
+
+// ——— ESP ———
+
+uint32_t EspClass::getFreeHeap() {
+    return NATIVE_FREE_HEAP;
+}
+
+void EspClass::restart() {
+    HAL::restart();
+}
+
+#endif // HAL_NATIVE
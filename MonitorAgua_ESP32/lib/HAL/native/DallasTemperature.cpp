@@ -0,0 +1,48 @@
+/**
+ * @file DallasTemperature.cpp
+ * @brief DS18B20 del entorno `native`.
+ * @details Como la librería original con waitForConversion activo (su valor por
+ *          defecto), requestTemperatures() bloquea durante la conversión.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifdef HAL_NATIVE
+
+#include <DallasTemperature.h>
+#include "HALNative.h"
+#include "Trace.h"
+
+DallasTemperature::DallasTemperature(OneWire* bus)
+    : _bus(bus), _requestMs(0), _pending(false) {}
+
+void DallasTemperature::begin() {
+    _pending = false;
+}
+
+uint8_t DallasTemperature::getDeviceCount() {
+    return isnan(HAL::Native::getOneWireTemperature(_bus->pin())) ? 0 : 1;
+}
+
+void DallasTemperature::requestTemperatures() {
+    _requestMs = millis();
+    _pending = true;
+    delay(DS18B20_CONVERSION_MS);
+}
+
+bool DallasTemperature::isConversionComplete() {
+    if (_pending && millis() - _requestMs >= DS18B20_CONVERSION_MS) _pending = false;
+    return !_pending;
+}
+
+float DallasTemperature::getTempCByIndex(uint8_t index) {
+    float celsius;
+    if (index == 0 && HAL::Trace::replayOneWire(_bus->pin(), celsius)) return celsius;  // Ya en 1/128 °C
+
+    celsius = HAL::Native::getOneWireTemperature(_bus->pin());
+    if (index != 0 || isnan(celsius)) return DEVICE_DISCONNECTED_C;
+    return roundf(celsius * 16.0f) / 16.0f;  // Resolución de 12 bits
+}
+
+#endif // HAL_NATIVE
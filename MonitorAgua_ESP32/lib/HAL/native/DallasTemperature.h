@@ -0,0 +1,38 @@
+/**
+ * @file DallasTemperature.h
+ * @brief DS18B20 del entorno `native` con los tiempos de conversión del sensor real.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_NATIVE_DALLAS_TEMPERATURE_H
+#define HAL_NATIVE_DALLAS_TEMPERATURE_H
+
+#include <Arduino.h>
+#include <OneWire.h>
+
+#define DEVICE_DISCONNECTED_C -127
+#define DS18B20_CONVERSION_MS 750   // Conversión a 12 bits
+
+/**
+ * @class DallasTemperature
+ * @brief Un DS18B20 por bus; desconectado si la temperatura inyectada es NAN
+ */
+class DallasTemperature {
+public:
+    explicit DallasTemperature(OneWire* bus);
+
+    void begin();
+    uint8_t getDeviceCount();
+    void requestTemperatures();
+    bool isConversionComplete();
+    float getTempCByIndex(uint8_t index);
+
+private:
+    OneWire* _bus;
+    unsigned long _requestMs;
+    bool _pending;
+};
+
+#endif // HAL_NATIVE_DALLAS_TEMPERATURE_H
@@ -0,0 +1,18 @@
+/**
+ * @file NativeMain.cpp
+ * @brief Punto de entrada del ejecutable `native`.
+ * @details Débil: un ejecutable con su propio main() (simulador, pruebas) lo reemplaza.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifdef HAL_NATIVE
+
+#include "HALNative.h"
+
+__attribute__((weak)) int main(int argc, char** argv) {
+    return HAL::Native::run(argc, argv);
+}
+
+#endif // HAL_NATIVE
@@ -0,0 +1,28 @@
+/**
+ * @file OneWire.h
+ * @brief Bus 1-Wire del entorno `native`: solo identifica el pin.
+ * @details La temperatura del DS18B20 la fija HAL::Native::setOneWireTemperature().
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_NATIVE_ONEWIRE_H
+#define HAL_NATIVE_ONEWIRE_H
+
+#include <Arduino.h>
+
+/**
+ * @class OneWire
+ * @brief Bus 1-Wire en un pin
+ */
+class OneWire {
+public:
+    explicit OneWire(uint8_t pin) : _pin(pin) {}
+    uint8_t pin() const { return _pin; }
+
+private:
+    uint8_t _pin;
+};
+
+#endif // HAL_NATIVE_ONEWIRE_H
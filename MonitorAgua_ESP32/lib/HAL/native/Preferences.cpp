@@ -0,0 +1,63 @@
+/**
+ * @file Preferences.cpp
+ * @brief NVS del entorno `native`.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifdef HAL_NATIVE
+
+#include <Preferences.h>
+#include "HALNative.h"
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    if (_open || !name || strlen(name) >= sizeof(_namespace)) return false;
+    snprintf(_namespace, sizeof(_namespace), "%s", name);
+    _readOnly = readOnly;
+    _open = true;
+    return true;
+}
+
+void Preferences::end() {
+    _open = false;
+}
+
+bool Preferences::clear() {
+    if (!_open || _readOnly) return false;
+    HAL::Native::nvsClear(_namespace);
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!_open || _readOnly) return false;
+    return HAL::Native::nvsRemove(_namespace, key);
+}
+
+bool Preferences::isKey(const char* key) {
+    size_t length = 0;
+    return _open && HAL::Native::nvsGet(_namespace, key, length) != nullptr;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+    if (!_open || _readOnly || !value || length == 0) return 0;
+    return HAL::Native::nvsPut(_namespace, key, value, length);
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    size_t length = 0;
+    if (!_open) return 0;
+    HAL::Native::nvsGet(_namespace, key, length);
+    return length;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength) {
+    size_t length = 0;
+    if (!_open) return 0;
+    const uint8_t* value = HAL::Native::nvsGet(_namespace, key, length);
+    if (!value || length > maxLength) return 0;  // Como Arduino-ESP32: sin lecturas parciales
+    memcpy(buffer, value, length);
+    return length;
+}
+
+#endif // HAL_NATIVE
@@ -0,0 +1,40 @@
+/**
+ * @file Preferences.h
+ * @brief NVS del entorno `native`, en memoria compartida entre ciclos.
+ * @details Se conserva a través de deep sleep, reinicios y cortes de alimentación
+ *          simulados, como la flash del equipo; se pierde al terminar el proceso.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_NATIVE_PREFERENCES_H
+#define HAL_NATIVE_PREFERENCES_H
+
+#include <Arduino.h>
+
+/**
+ * @class Preferences
+ * @brief Subconjunto de la API de Preferences (valores binarios)
+ */
+class Preferences {
+public:
+    Preferences() : _open(false), _readOnly(false) { _namespace[0] = '\0'; }
+
+    bool begin(const char* name, bool readOnly = false);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putBytes(const char* key, const void* value, size_t length);
+    size_t getBytesLength(const char* key);
+    size_t getBytes(const char* key, void* buffer, size_t maxLength);
+
+private:
+    char _namespace[16];
+    bool _open;
+    bool _readOnly;
+};
+
+#endif // HAL_NATIVE_PREFERENCES_H
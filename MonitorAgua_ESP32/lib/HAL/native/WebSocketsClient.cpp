@@ -0,0 +1,407 @@
+/**
+ * @file WebSocketsClient.cpp
+ * @brief Cliente WebSocket del entorno `native` (RFC 6455 sobre sockets POSIX).
+ * @details No verifica Sec-WebSocket-Accept: basta con la respuesta 101 del
+ *          servidor. Las tramas del cliente van enmascaradas como exige el RFC.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifdef HAL_NATIVE
+
+#include <WebSocketsClient.h>
+#include <WiFi.h>
+#include "HALNative.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define WS_NATIVE_CONNECT_TIMEOUT_MS 5000   // Plazo virtual para TCP + handshake
+#define WS_NATIVE_RX_CAPACITY        (WS_NATIVE_MAX_MESSAGE + 14)
+#define WS_NATIVE_UPGRADE_RESPONSE   129    // Bytes de la respuesta "101 Switching Protocols"
+
+// Clave del ejemplo del RFC 6455: válida y determinista
+static const char WS_NATIVE_KEY[] = "dGhlIHNhbXBsZSBub25jZQ==";
+
+// Opcodes
+#define WS_OP_CONTINUATION 0x0
+#define WS_OP_TEXT         0x1
+#define WS_OP_BINARY       0x2
+#define WS_OP_CLOSE        0x8
+#define WS_OP_PING         0x9
+#define WS_OP_PONG         0xA
+
+WebSocketsClient::WebSocketsClient()
+    : _state(STATE_IDLE), _fd(-1), _port(0), _reconnectMs(500), _lastAttemptMs(0),
+      _begun(false), _peer(nullptr), _rxLength(0), _messageLength(0) {
+    _host[0] = '\0';
+    _url[0] = '\0';
+    _rx = (uint8_t*)malloc(WS_NATIVE_RX_CAPACITY);
+    _message = (uint8_t*)malloc(WS_NATIVE_MAX_MESSAGE + 1);
+}
+
+WebSocketsClient::~WebSocketsClient() {
+    closeSocket(false);
+    free(_rx);
+    free(_message);
+}
+
+void WebSocketsClient::begin(const char* host, uint16_t port, const char* url, const char* protocol) {
+    (void)protocol;
+    _peer = HAL::Native::webSocketPeer();
+    HAL::Native::resolveServer(host, port);
+    snprintf(_host, sizeof(_host), "%s", host);
+    snprintf(_url, sizeof(_url), "%s", url);
+    _port = port;
+    _begun = true;
+    _lastAttemptMs = millis() - _reconnectMs;  // Primer intento en el próximo loop()
+}
+
+void WebSocketsClient::disconnect() {
+    if (_state == STATE_OPEN) sendFrame(WS_OP_CLOSE, nullptr, 0);
+    closeSocket(true);
+    _begun = false;
+}
+
+void WebSocketsClient::loop() {
+    if (!_begun) return;
+
+    if (!WiFi.isConnected()) {
+        closeSocket(true);
+        return;
+    }
+
+    if (_peer) {
+        loopPeer();
+        return;
+    }
+
+    if ((_state == STATE_CONNECTING || _state == STATE_HANDSHAKE) &&
+        millis() - _lastAttemptMs >= WS_NATIVE_CONNECT_TIMEOUT_MS) {
+        closeSocket(false);
+    }
+
+    switch (_state) {
+        case STATE_IDLE:
+            if (millis() - _lastAttemptMs >= _reconnectMs) startConnect();
+            break;
+
+        case STATE_CONNECTING: {
+            if (!waitSocket(POLLOUT)) break;
+            int error = 0;
+            socklen_t len = sizeof(error);
+            getsockopt(_fd, SOL_SOCKET, SO_ERROR, &error, &len);
+            if (error != 0) {
+                closeSocket(false);
+                break;
+            }
+            char request[256];
+            int n = buildHandshake(request, sizeof(request));
+            if (send(_fd, request, n, MSG_NOSIGNAL) != n) {
+                closeSocket(false);
+                break;
+            }
+            HAL::Native::countTraffic((size_t)n, 0);
+            _state = STATE_HANDSHAKE;
+            break;
+        }
+
+        case STATE_HANDSHAKE:
+            if (waitSocket(POLLIN)) handleHandshake();
+            break;
+
+        case STATE_OPEN:
+            if (waitSocket(POLLIN)) handleFrames();
+            break;
+    }
+}
+
+/**
+ * @brief Sesión con el servidor simulado: handshake y recepción en tiempo virtual
+ */
+void WebSocketsClient::loopPeer() {
+    if (_state != STATE_OPEN) {
+        if (millis() - _lastAttemptMs < _reconnectMs) return;
+        _lastAttemptMs = millis();
+
+        delay(2 * WS_NATIVE_PEER_RTT_MS);  // SYN/SYN-ACK y upgrade HTTP
+        if (!_peer->onOpen()) return;
+
+        char request[256];
+        HAL::Native::countTraffic((size_t)buildHandshake(request, sizeof(request)), WS_NATIVE_UPGRADE_RESPONSE);
+        _state = STATE_OPEN;
+        emit(WStype_CONNECTED, (uint8_t*)_url, strlen(_url));
+        return;
+    }
+
+    size_t length = _peer->poll((char*)_message, WS_NATIVE_MAX_MESSAGE);
+    if (length == 0) return;
+
+    // Trama del servidor: sin máscara
+    size_t header = (length < 126) ? 2 : (length <= 0xFFFF ? 4 : 10);
+    HAL::Native::countTraffic(0, header + length);
+    _message[length] = '\0';
+    emit(WStype_TEXT, _message, length);
+}
+
+/**
+ * @brief Petición HTTP de upgrade
+ * @return Longitud escrita
+ */
+int WebSocketsClient::buildHandshake(char* request, size_t size) {
+    int n = snprintf(request, size,
+                     "GET %s HTTP/1.1\r\nHost: %s:%u\r\nUpgrade: websocket\r\n"
+                     "Connection: Upgrade\r\nSec-WebSocket-Key: %s\r\n"
+                     "Sec-WebSocket-Version: 13\r\n\r\n",
+                     _url, _host, _port, WS_NATIVE_KEY);
+    return (n < (int)size) ? n : (int)size - 1;
+}
+
+/**
+ * @brief Abre el socket TCP no bloqueante hacia el servidor
+ */
+void WebSocketsClient::startConnect() {
+    _lastAttemptMs = millis();
+    _rxLength = 0;
+    _messageLength = 0;
+
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* result = nullptr;
+    char port[8];
+    snprintf(port, sizeof(port), "%u", _port);
+    if (getaddrinfo(_host, port, &hints, &result) != 0 || !result) return;
+
+    _fd = socket(result->ai_family, SOCK_STREAM, 0);
+    if (_fd >= 0) {
+        fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL, 0) | O_NONBLOCK);
+        if (connect(_fd, result->ai_addr, result->ai_addrlen) == 0 || errno == EINPROGRESS) {
+            _state = STATE_CONNECTING;
+        } else {
+            close(_fd);
+            _fd = -1;
+        }
+    }
+    freeaddrinfo(result);
+}
+
+/**
+ * @brief Espera (tiempo real acotado) a que el socket esté listo
+ */
+bool WebSocketsClient::waitSocket(short events) {
+    struct pollfd p = {_fd, events, 0};
+    if (poll(&p, 1, WS_NATIVE_POLL_MS) <= 0) return false;
+    return (p.revents & (events | POLLERR | POLLHUP)) != 0;
+}
+
+/**
+ * @brief Lee la respuesta HTTP del upgrade
+ */
+void WebSocketsClient::handleHandshake() {
+    ssize_t n = recv(_fd, _rx + _rxLength, WS_NATIVE_RX_CAPACITY - _rxLength, 0);
+    if (n <= 0) {
+        closeSocket(false);
+        return;
+    }
+    HAL::Native::countTraffic(0, (size_t)n);
+    _rxLength += (size_t)n;
+
+    uint8_t* end = (uint8_t*)memmem(_rx, _rxLength, "\r\n\r\n", 4);
+    if (!end) {
+        if (_rxLength == WS_NATIVE_RX_CAPACITY) closeSocket(false);
+        return;
+    }
+
+    size_t headerLength = (size_t)(end - _rx) + 4;
+    if (!memmem(_rx, headerLength, " 101 ", 5)) {
+        closeSocket(false);
+        return;
+    }
+
+    _rxLength -= headerLength;
+    memmove(_rx, _rx + headerLength, _rxLength);
+    _state = STATE_OPEN;
+    emit(WStype_CONNECTED, (uint8_t*)_url, strlen(_url));
+
+    if (_rxLength > 0) handleFrames();
+}
+
+/**
+ * @brief Lee del socket y procesa las tramas completas
+ */
+void WebSocketsClient::handleFrames() {
+    if (_rxLength < WS_NATIVE_RX_CAPACITY) {
+        ssize_t n = recv(_fd, _rx + _rxLength, WS_NATIVE_RX_CAPACITY - _rxLength, MSG_DONTWAIT);
+        if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+            closeSocket(true);
+            return;
+        }
+        if (n > 0) {
+            HAL::Native::countTraffic(0, (size_t)n);
+            _rxLength += (size_t)n;
+        }
+    }
+
+    while (_state == STATE_OPEN && _rxLength >= 2) {
+        bool fin = (_rx[0] & 0x80) != 0;
+        uint8_t opcode = _rx[0] & 0x0F;
+        bool masked = (_rx[1] & 0x80) != 0;
+        uint64_t length = _rx[1] & 0x7F;
+        size_t header = 2;
+
+        if (length == 126) {
+            if (_rxLength < 4) return;
+            length = ((uint64_t)_rx[2] << 8) | _rx[3];
+            header = 4;
+        } else if (length == 127) {
+            if (_rxLength < 10) return;
+            length = 0;
+            for (int i = 0; i < 8; i++) length = (length << 8) | _rx[2 + i];
+            header = 10;
+        }
+        if (length > WS_NATIVE_MAX_MESSAGE) {
+            closeSocket(true);
+            return;
+        }
+
+        uint8_t mask[4] = {0, 0, 0, 0};
+        if (masked) {
+            if (_rxLength < header + 4) return;
+            memcpy(mask, _rx + header, 4);
+            header += 4;
+        }
+        if (_rxLength < header + length) return;
+
+        uint8_t* payload = _rx + header;
+        if (masked) {
+            for (uint64_t i = 0; i < length; i++) payload[i] ^= mask[i & 3];
+        }
+
+        switch (opcode) {
+            case WS_OP_TEXT:
+            case WS_OP_BINARY:
+            case WS_OP_CONTINUATION:
+                if (opcode != WS_OP_CONTINUATION) _messageLength = 0;
+                if (_messageLength + length > WS_NATIVE_MAX_MESSAGE) {
+                    closeSocket(true);
+                    return;
+                }
+                memcpy(_message + _messageLength, payload, length);
+                _messageLength += length;
+                if (fin) {
+                    _message[_messageLength] = '\0';  // Como la librería: terminado en nulo
+                    emit(opcode == WS_OP_BINARY ? WStype_BIN : WStype_TEXT, _message, _messageLength);
+                    _messageLength = 0;
+                }
+                break;
+            case WS_OP_PING:
+                sendFrame(WS_OP_PONG, payload, length);
+                emit(WStype_PING, payload, length);
+                break;
+            case WS_OP_PONG:
+                emit(WStype_PONG, payload, length);
+                break;
+            case WS_OP_CLOSE:
+                sendFrame(WS_OP_CLOSE, payload, length);
+                closeSocket(true);
+                return;
+            default:
+                break;
+        }
+
+        size_t consumed = header + length;
+        _rxLength -= consumed;
+        memmove(_rx, _rx + consumed, _rxLength);
+    }
+}
+
+bool WebSocketsClient::sendTXT(const char* payload, size_t length) {
+    if (_state != STATE_OPEN || !payload) return false;
+    if (length == 0) length = strlen(payload);
+    return sendFrame(WS_OP_TEXT, (const uint8_t*)payload, length);
+}
+
+/**
+ * @brief Envía una trama completa enmascarada
+ */
+bool WebSocketsClient::sendFrame(uint8_t opcode, const uint8_t* payload, size_t length) {
+    if (_fd < 0 && !_peer) return false;
+
+    uint8_t header[14];
+    size_t headerLength = 2;
+    header[0] = 0x80 | opcode;
+    if (length < 126) {
+        header[1] = 0x80 | (uint8_t)length;
+    } else if (length <= 0xFFFF) {
+        header[1] = 0x80 | 126;
+        header[2] = (uint8_t)(length >> 8);
+        header[3] = (uint8_t)length;
+        headerLength = 4;
+    } else {
+        header[1] = 0x80 | 127;
+        for (int i = 0; i < 8; i++) header[2 + i] = (uint8_t)((uint64_t)length >> (56 - 8 * i));
+        headerLength = 10;
+    }
+    const uint8_t mask[4] = {0x37, 0xFA, 0x21, 0x3D};
+    memcpy(header + headerLength, mask, 4);
+    headerLength += 4;
+
+    if (_peer) {
+        HAL::Native::countTraffic(headerLength + length, 0);
+        if (opcode == WS_OP_TEXT) _peer->onText((const char*)payload, length);
+        return true;
+    }
+
+    uint8_t* frame = (uint8_t*)malloc(headerLength + length);
+    if (!frame) return false;
+    memcpy(frame, header, headerLength);
+    for (size_t i = 0; i < length; i++) frame[headerLength + i] = payload[i] ^ mask[i & 3];
+
+    size_t total = headerLength + length;
+    size_t sent = 0;
+    while (sent < total) {
+        ssize_t n = send(_fd, frame + sent, total - sent, MSG_NOSIGNAL);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct pollfd p = {_fd, POLLOUT, 0};
+            poll(&p, 1, WS_NATIVE_POLL_MS);
+            continue;
+        }
+        if (n <= 0) break;
+        sent += (size_t)n;
+    }
+    free(frame);
+
+    HAL::Native::countTraffic(sent, 0);
+    if (sent < total) {
+        closeSocket(true);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Cierra el socket; notifica DISCONNECTED si la sesión estaba abierta
+ */
+void WebSocketsClient::closeSocket(bool notify) {
+    bool wasOpen = (_state == STATE_OPEN);
+    if (_fd >= 0) {
+        close(_fd);
+        _fd = -1;
+    }
+    _state = STATE_IDLE;
+    _rxLength = 0;
+    _messageLength = 0;
+    if (_peer && wasOpen) _peer->onClose();
+    if (notify && wasOpen) emit(WStype_DISCONNECTED, nullptr, 0);
+}
+
+void WebSocketsClient::emit(WStype_t type, uint8_t* payload, size_t length) {
+    if (_callback) _callback(type, payload, length);
+}
+
+#endif // HAL_NATIVE
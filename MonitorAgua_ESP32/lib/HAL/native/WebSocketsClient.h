@@ -0,0 +1,94 @@
+/**
+ * @file WebSocketsClient.h
+ * @brief Cliente WebSocket (RFC 6455, solo texto) del entorno `native` sobre TCP.
+ * @details Misma interfaz que links2004/WebSockets en lo que usa WiFiManager.
+ *          Los sockets son reales y no bloqueantes; mientras hay una conexión o un
+ *          handshake pendiente, loop() espera hasta WS_NATIVE_POLL_MS de tiempo real
+ *          para que el servidor (p. ej. servidor.py) alcance a responder dentro de
+ *          los plazos virtuales del firmware.
+ *
+ *          Con un HAL::Native::WebSocketPeer conectado no se usan sockets: la
+ *          sesión transcurre solo en tiempo virtual (simulador de ciclos).
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_NATIVE_WEBSOCKETS_CLIENT_H
+#define HAL_NATIVE_WEBSOCKETS_CLIENT_H
+
+#include <Arduino.h>
+#include <functional>
+#include "HALNative.h"
+
+#define WS_NATIVE_POLL_MS     10      // Espera real máxima por llamada a loop()
+#define WS_NATIVE_MAX_MESSAGE 16384   // Tamaño máximo de mensaje recibido
+#define WS_NATIVE_PEER_RTT_MS 20      // Ida y vuelta hasta el servidor simulado
+
+typedef enum {
+    WStype_ERROR,
+    WStype_DISCONNECTED,
+    WStype_CONNECTED,
+    WStype_TEXT,
+    WStype_BIN,
+    WStype_FRAGMENT_TEXT_START,
+    WStype_FRAGMENT_BIN_START,
+    WStype_FRAGMENT,
+    WStype_FRAGMENT_FIN,
+    WStype_PING,
+    WStype_PONG,
+} WStype_t;
+
+/**
+ * @class WebSocketsClient
+ * @brief Cliente con reconexión automática
+ */
+class WebSocketsClient {
+public:
+    typedef std::function<void(WStype_t type, uint8_t* payload, size_t length)> WebSocketClientEvent;
+
+    WebSocketsClient();
+    ~WebSocketsClient();
+
+    void begin(const char* host, uint16_t port, const char* url = "/", const char* protocol = "arduino");
+    void onEvent(WebSocketClientEvent callback) { _callback = callback; }
+    void setReconnectInterval(unsigned long ms) { _reconnectMs = ms; }
+    void loop();
+    void disconnect();
+    bool isConnected() const { return _state == STATE_OPEN; }
+
+    bool sendTXT(const char* payload, size_t length = 0);
+    bool sendTXT(const uint8_t* payload, size_t length) { return sendTXT((const char*)payload, length); }
+    bool sendTXT(String& payload) { return sendTXT(payload.c_str(), payload.length()); }
+
+private:
+    enum State { STATE_IDLE, STATE_CONNECTING, STATE_HANDSHAKE, STATE_OPEN };
+
+    WebSocketClientEvent _callback;
+    State _state;
+    int _fd;
+    char _host[64];
+    char _url[64];
+    uint16_t _port;
+    unsigned long _reconnectMs;
+    unsigned long _lastAttemptMs;
+    bool _begun;
+    HAL::Native::WebSocketPeer* _peer;  ///< Servidor simulado (nullptr: sockets reales)
+
+    uint8_t* _rx;                 ///< Bytes recibidos sin procesar
+    size_t _rxLength;
+    uint8_t* _message;            ///< Mensaje fragmentado en curso
+    size_t _messageLength;
+
+    void startConnect();
+    void loopPeer();
+    int buildHandshake(char* request, size_t size);
+    bool waitSocket(short events);
+    void handleHandshake();
+    void handleFrames();
+    bool sendFrame(uint8_t opcode, const uint8_t* payload, size_t length);
+    void closeSocket(bool notify);
+    void emit(WStype_t type, uint8_t* payload, size_t length);
+};
+
+#endif // HAL_NATIVE_WEBSOCKETS_CLIENT_H
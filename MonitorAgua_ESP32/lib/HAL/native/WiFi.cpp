@@ -0,0 +1,68 @@
+/**
+ * @file WiFi.cpp
+ * @brief Radio WiFi del entorno `native`.
+ * @details El estado se calcula en cada consulta, así que una caída de la red
+ *          simulada a mitad del ciclo se ve como una desconexión. La radio cuenta
+ *          como encendida desde begin() o un modo distinto de WIFI_OFF hasta
+ *          volver a WIFI_OFF (o dormir).
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifdef HAL_NATIVE
+
+#include <WiFi.h>
+#include "HALNative.h"
+
+WiFiClass WiFi;
+
+String IPAddress::toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _octets[0], _octets[1], _octets[2], _octets[3]);
+    return String(buf);
+}
+
+bool WiFiClass::mode(wifi_mode_t mode) {
+    _mode = mode;
+    if (mode == WIFI_OFF) _connecting = false;
+    HAL::Native::setRadio(mode != WIFI_OFF);
+    return true;
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* password) {
+    (void)ssid;
+    (void)password;
+    if (_mode == WIFI_OFF) _mode = WIFI_STA;
+    HAL::Native::setRadio(true);
+    _connecting = true;
+    _beginMs = millis();
+    return WL_DISCONNECTED;
+}
+
+wl_status_t WiFiClass::status() {
+    if (!_connecting || _mode == WIFI_OFF) return WL_DISCONNECTED;
+    bool associated = millis() - _beginMs >= HAL_NATIVE_WIFI_ASSOC_MS;
+    if (!HAL::Native::wifiAvailable()) return associated ? WL_NO_SSID_AVAIL : WL_DISCONNECTED;
+    return associated ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+bool WiFiClass::disconnect(bool wifiOff, bool eraseAp) {
+    (void)eraseAp;
+    _connecting = false;
+    if (wifiOff) {
+        _mode = WIFI_OFF;
+        HAL::Native::setRadio(false);
+    }
+    return true;
+}
+
+int8_t WiFiClass::RSSI() {
+    return isConnected() ? HAL::Native::wifiRssi() : 0;
+}
+
+IPAddress WiFiClass::localIP() {
+    return isConnected() ? IPAddress(192, 168, 1, 50) : IPAddress();
+}
+
+#endif // HAL_NATIVE
@@ -0,0 +1,71 @@
+/**
+ * @file WiFi.h
+ * @brief Radio WiFi del entorno `native`.
+ * @details La red existe o no según HAL::Native::setWiFi(); la asociación tarda
+ *          HAL_NATIVE_WIFI_ASSOC_MS de tiempo virtual. Los sockets son los del
+ *          equipo anfitrión (ver WebSocketsClient.h).
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_NATIVE_WIFI_H
+#define HAL_NATIVE_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} wifi_mode_t;
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+/**
+ * @class IPAddress
+ * @brief Dirección IPv4
+ */
+class IPAddress {
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : _octets{a, b, c, d} {}
+    String toString() const;
+    uint8_t operator[](int index) const { return _octets[index & 3]; }
+
+private:
+    uint8_t _octets[4];
+};
+
+/**
+ * @class WiFiClass
+ * @brief Estación WiFi simulada
+ */
+class WiFiClass {
+public:
+    WiFiClass() : _mode(WIFI_OFF), _connecting(false), _beginMs(0) {}
+
+    bool mode(wifi_mode_t mode);
+    wifi_mode_t getMode() const { return _mode; }
+    wl_status_t begin(const char* ssid, const char* password = nullptr);
+    wl_status_t status();
+    bool isConnected() { return status() == WL_CONNECTED; }
+    bool disconnect(bool wifiOff = false, bool eraseAp = false);
+    int8_t RSSI();
+    IPAddress localIP();
+
+private:
+    wifi_mode_t _mode;
+    bool _connecting;
+    unsigned long _beginMs;
+};
+
+extern WiFiClass WiFi;
+
+#endif // HAL_NATIVE_WIFI_H
@@ -0,0 +1,109 @@
+/**
+ * @file Wire.cpp
+ * @brief Bus I2C del entorno `native`.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifdef HAL_NATIVE
+
+#include <Wire.h>
+#include "HALNative.h"
+#include "Trace.h"
+
+#define NATIVE_I2C_DEFAULT_HZ   100000  // Frecuencia tras begin() sin argumento
+#define NATIVE_I2C_FRAME_BITS   9       // 8 bits de datos + ACK
+#define NATIVE_I2C_OVERHEAD_BITS 20     // START, dirección y STOP
+
+TwoWire Wire;
+
+TwoWire::TwoWire()
+    : _started(false), _frequency(NATIVE_I2C_DEFAULT_HZ), _txAddress(0),
+      _txLength(0), _rxLength(0), _rxIndex(0) {}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    (void)sda;
+    (void)scl;
+    _started = true;
+    if (frequency) _frequency = frequency;
+    return true;
+}
+
+bool TwoWire::end() {
+    _started = false;
+    return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+    if (frequency == 0) return false;
+    _frequency = frequency;
+    return true;
+}
+
+/**
+ * @brief Adelanta el reloj virtual lo que tarda la transacción en el bus
+ */
+void TwoWire::chargeBusTime(size_t bytes) {
+    uint64_t bits = NATIVE_I2C_OVERHEAD_BITS + (uint64_t)bytes * NATIVE_I2C_FRAME_BITS;
+    HAL::Native::advanceUs((bits * 1000000ULL + _frequency - 1) / _frequency);
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    _txAddress = address;
+    _txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t value) {
+    if (_txLength >= I2C_BUFFER_LENGTH) return 0;
+    _txBuffer[_txLength++] = value;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length) {
+    size_t n = 0;
+    while (n < length && write(data[n])) n++;
+    return n;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    if (!_started) return 4;
+
+    chargeBusTime(_txLength);
+    HAL::Native::I2CDevice* device = HAL::Native::i2cDevice(_txAddress);
+    if (!device) return 2;
+    return device->write(_txBuffer, _txLength) ? 0 : 3;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool sendStop) {
+    (void)sendStop;
+    _rxLength = 0;
+    _rxIndex = 0;
+    if (!_started) return 0;
+    if (quantity > I2C_BUFFER_LENGTH) quantity = I2C_BUFFER_LENGTH;
+
+    chargeBusTime(quantity);
+    if (HAL::Trace::replayI2C(address, _rxBuffer, quantity)) {
+        _rxLength = quantity;
+        return quantity;
+    }
+    HAL::Native::I2CDevice* device = HAL::Native::i2cDevice(address);
+    if (!device) return 0;
+    _rxLength = device->read(_rxBuffer, quantity);
+    return (uint8_t)_rxLength;
+}
+
+int TwoWire::available() {
+    return (int)(_rxLength - _rxIndex);
+}
+
+int TwoWire::read() {
+    return (_rxIndex < _rxLength) ? _rxBuffer[_rxIndex++] : -1;
+}
+
+int TwoWire::peek() {
+    return (_rxIndex < _rxLength) ? _rxBuffer[_rxIndex] : -1;
+}
+
+#endif // HAL_NATIVE
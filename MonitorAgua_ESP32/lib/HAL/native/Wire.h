@@ -0,0 +1,57 @@
+/**
+ * @file Wire.h
+ * @brief Bus I2C del entorno `native`: reenvía las transacciones a los modelos
+ *        conectados con HAL::Native::attachI2CDevice().
+ * @details Códigos de endTransmission() como en Arduino-ESP32: 0 = OK,
+ *          2 = NACK de dirección (no hay modelo), 3 = NACK de datos.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_NATIVE_WIRE_H
+#define HAL_NATIVE_WIRE_H
+
+#include <Arduino.h>
+
+#define I2C_BUFFER_LENGTH 128
+
+/**
+ * @class TwoWire
+ * @brief Maestro I2C sobre el bus simulado
+ */
+class TwoWire {
+public:
+    TwoWire();
+
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool end();
+    bool setClock(uint32_t frequency);
+    uint32_t getClock() const { return _frequency; }
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t value);
+    size_t write(const uint8_t* data, size_t length);
+    uint8_t endTransmission(bool sendStop = true);
+
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+    int available();
+    int read();
+    int peek();
+
+private:
+    bool _started;
+    uint32_t _frequency;
+    uint8_t _txAddress;
+    uint8_t _txBuffer[I2C_BUFFER_LENGTH];
+    size_t _txLength;
+    uint8_t _rxBuffer[I2C_BUFFER_LENGTH];
+    size_t _rxLength;
+    size_t _rxIndex;
+
+    void chargeBusTime(size_t bytes);
+};
+
+extern TwoWire Wire;
+
+#endif // HAL_NATIVE_WIRE_H
@@ -0,0 +1,25 @@
+/**
+ * @file esp_sleep.h
+ * @brief Tipos de esp_sleep del ESP-IDF para el entorno `native`.
+ * @details Solo tipos: las funciones de sleep se usan a través de HAL.h.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_NATIVE_ESP_SLEEP_H
+#define HAL_NATIVE_ESP_SLEEP_H
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED,
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER,
+    ESP_SLEEP_WAKEUP_TOUCHPAD,
+    ESP_SLEEP_WAKEUP_ULP,
+    ESP_SLEEP_WAKEUP_GPIO,
+    ESP_SLEEP_WAKEUP_UART,
+} esp_sleep_wakeup_cause_t;
+
+#endif // HAL_NATIVE_ESP_SLEEP_H
@@ -0,0 +1,21 @@
+/**
+ * @file esp_system.h
+ * @brief Tipos de error del ESP-IDF para el entorno `native`.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_NATIVE_ESP_SYSTEM_H
+#define HAL_NATIVE_ESP_SYSTEM_H
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK                0
+#define ESP_FAIL              -1
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_NOT_FOUND     0x105
+
+#endif // HAL_NATIVE_ESP_SYSTEM_H
@@ -0,0 +1,20 @@
+/**
+ * @file esp_task_wdt.h
+ * @brief Task watchdog del ESP-IDF para el entorno `native` (sin efecto).
+ * @details El tiempo es virtual: un ciclo nativo nunca supera el plazo real.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef HAL_NATIVE_ESP_TASK_WDT_H
+#define HAL_NATIVE_ESP_TASK_WDT_H
+
+#include "esp_system.h"
+
+inline esp_err_t esp_task_wdt_init(uint32_t timeoutS, bool panic) { (void)timeoutS; (void)panic; return ESP_OK; }
+inline esp_err_t esp_task_wdt_deinit() { return ESP_OK; }
+inline esp_err_t esp_task_wdt_add(void* task) { (void)task; return ESP_OK; }
+inline esp_err_t esp_task_wdt_reset() { return ESP_OK; }
+
+#endif // HAL_NATIVE_ESP_TASK_WDT_H
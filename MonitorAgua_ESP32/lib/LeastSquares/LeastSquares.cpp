@@ -0,0 +1,214 @@
+/**
+ * @file LeastSquares.cpp
+ * @brief Implementación del solucionador QR de Householder y de los ajustes.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include "LeastSquares.h"
+#include <math.h>
+
+namespace LeastSquares {
+
+    // ——— Constantes internas ———
+
+    /**
+     * @brief Cociente mínimo |R_jj| / max|R_ii| aceptado.
+     * @details Por debajo de este valor la matriz se considera de rango deficiente
+     *          (p. ej. dos soluciones patrón con el mismo voltaje en un ajuste lineal).
+     */
+    static const double RCOND_MIN = 1e-9;
+
+    /**
+     * @brief Verifica que todos los valores sean finitos.
+     */
+    static bool allFinite(const float* v, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            if (!isfinite(v[i])) return false;
+        }
+        return true;
+    }
+
+    // ——— Solucionador ———
+
+    Status solve(double* A, double* b, size_t rows, size_t cols, double* x) {
+        if (cols == 0 || cols > LSQ_MAX_TERMS || rows > LSQ_MAX_POINTS) return LSQ_INVALID_INPUT;
+        if (rows < cols) return LSQ_INSUFFICIENT_POINTS;
+
+        double v[LSQ_MAX_POINTS];
+
+        for (size_t j = 0; j < cols; j++) {
+            // Reflexión que anula la columna j bajo la diagonal
+            double norm = 0.0;
+            for (size_t i = j; i < rows; i++) norm += A[i * cols + j] * A[i * cols + j];
+            norm = sqrt(norm);
+            if (norm == 0.0) return LSQ_ILL_CONDITIONED;
+
+            // Signo opuesto al pivote para evitar cancelación
+            double alpha = (A[j * cols + j] > 0.0) ? -norm : norm;
+
+            double vnorm2 = 0.0;
+            for (size_t i = j; i < rows; i++) {
+                v[i] = A[i * cols + j];
+                if (i == j) v[i] -= alpha;
+                vnorm2 += v[i] * v[i];
+            }
+            if (vnorm2 == 0.0) continue; // Columna ya triangular
+
+            for (size_t k = j; k < cols; k++) {
+                double s = 0.0;
+                for (size_t i = j; i < rows; i++) s += v[i] * A[i * cols + k];
+                s = 2.0 * s / vnorm2;
+                for (size_t i = j; i < rows; i++) A[i * cols + k] -= s * v[i];
+            }
+
+            double s = 0.0;
+            for (size_t i = j; i < rows; i++) s += v[i] * b[i];
+            s = 2.0 * s / vnorm2;
+            for (size_t i = j; i < rows; i++) b[i] -= s * v[i];
+        }
+
+        // Condicionamiento a partir de la diagonal de R
+        double maxDiag = 0.0;
+        double minDiag = INFINITY;
+        for (size_t j = 0; j < cols; j++) {
+            double d = fabs(A[j * cols + j]);
+            if (d > maxDiag) maxDiag = d;
+            if (d < minDiag) minDiag = d;
+        }
+        if (maxDiag == 0.0 || minDiag / maxDiag < RCOND_MIN) return LSQ_ILL_CONDITIONED;
+
+        // Sustitución hacia atrás: R·x = Qᵀb
+        for (size_t jj = cols; jj-- > 0;) {
+            double s = b[jj];
+            for (size_t k = jj + 1; k < cols; k++) s -= A[jj * cols + k] * x[k];
+            x[jj] = s / A[jj * cols + jj];
+        }
+
+        return LSQ_OK;
+    }
+
+    // ——— Ajustes ———
+
+    Status fitPolynomial(const float* x, const float* y, size_t n, uint8_t degree,
+                         float* coeffs, float* residuals, FitStats* stats) {
+        size_t terms = (size_t)degree + 1;
+        if (degree == 0 || terms > LSQ_MAX_TERMS || n > LSQ_MAX_POINTS) return LSQ_INVALID_INPUT;
+        if (n < terms) return LSQ_INSUFFICIENT_POINTS;
+        if (!allFinite(x, n) || !allFinite(y, n)) return LSQ_INVALID_INPUT;
+
+        // Centrado y escalado: t = (x - m) / s con t en [-1, 1]
+        double m = 0.0;
+        for (size_t i = 0; i < n; i++) m += x[i];
+        m /= (double)n;
+        double s = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            double d = fabs((double)x[i] - m);
+            if (d > s) s = d;
+        }
+        if (s == 0.0) return LSQ_ILL_CONDITIONED;
+
+        double A[LSQ_MAX_POINTS * LSQ_MAX_TERMS];
+        double b[LSQ_MAX_POINTS];
+        for (size_t i = 0; i < n; i++) {
+            double t = ((double)x[i] - m) / s;
+            double p = 1.0;
+            for (size_t j = 0; j < terms; j++) {
+                A[i * terms + j] = p;
+                p *= t;
+            }
+            b[i] = y[i];
+        }
+
+        double a[LSQ_MAX_TERMS];
+        Status status = solve(A, b, n, terms, a);
+        if (status != LSQ_OK) return status;
+
+        // Regreso a base monomial en x: Horner sobre polinomios, p ← p·(x - m)/s + a_j
+        double c[LSQ_MAX_TERMS] = {0.0};
+        c[0] = a[terms - 1];
+        for (size_t j = terms - 1; j-- > 0;) {
+            for (size_t i = terms - 1; i > 0; i--) c[i] = (c[i - 1] - m * c[i]) / s;
+            c[0] = (-m * c[0]) / s + a[j];
+        }
+
+        float yhat[LSQ_MAX_POINTS];
+        for (size_t j = 0; j < terms; j++) {
+            coeffs[j] = (float)c[j];
+            if (!isfinite(coeffs[j])) return LSQ_ILL_CONDITIONED;
+        }
+        // Métricas con los coeficientes en float que realmente se aplicarán
+        for (size_t i = 0; i < n; i++) {
+            double p = coeffs[terms - 1];
+            for (size_t j = terms - 1; j-- > 0;) p = p * x[i] + coeffs[j];
+            yhat[i] = (float)p;
+        }
+
+        FitStats local;
+        computeStats(y, yhat, n, (uint8_t)terms, residuals, stats ? stats : &local);
+        return LSQ_OK;
+    }
+
+    Status fitScale(const float* f, const float* y, size_t n,
+                    float* k, float* residuals, FitStats* stats) {
+        if (n > LSQ_MAX_POINTS) return LSQ_INVALID_INPUT;
+        if (n == 0) return LSQ_INSUFFICIENT_POINTS;
+        if (!allFinite(f, n) || !allFinite(y, n)) return LSQ_INVALID_INPUT;
+
+        double A[LSQ_MAX_POINTS];
+        double b[LSQ_MAX_POINTS];
+        for (size_t i = 0; i < n; i++) {
+            A[i] = f[i];
+            b[i] = y[i];
+        }
+
+        double x;
+        Status status = solve(A, b, n, 1, &x);
+        if (status != LSQ_OK) return status;
+
+        *k = (float)x;
+        if (!isfinite(*k)) return LSQ_ILL_CONDITIONED;
+
+        float yhat[LSQ_MAX_POINTS];
+        for (size_t i = 0; i < n; i++) yhat[i] = *k * f[i];
+
+        FitStats local;
+        computeStats(y, yhat, n, 1, residuals, stats ? stats : &local);
+        return LSQ_OK;
+    }
+
+    void computeStats(const float* y, const float* yhat, size_t n, uint8_t terms,
+                      float* residuals, FitStats* stats) {
+        double mean = 0.0;
+        for (size_t i = 0; i < n; i++) mean += y[i];
+        if (n > 0) mean /= (double)n;
+
+        double ssRes = 0.0;
+        double ssTot = 0.0;
+        double maxAbs = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            double r = (double)y[i] - (double)yhat[i];
+            if (residuals) residuals[i] = (float)r;
+            ssRes += r * r;
+            ssTot += ((double)y[i] - mean) * ((double)y[i] - mean);
+            if (fabs(r) > maxAbs) maxAbs = fabs(r);
+        }
+
+        stats->n = (uint8_t)n;
+        stats->terms = terms;
+        stats->rmse = (n > 0) ? (float)sqrt(ssRes / (double)n) : 0.0f;
+        stats->maxAbsResidual = (float)maxAbs;
+        // Con todas las referencias iguales R² no está definido: 1 solo si el ajuste es exacto
+        if (ssTot > 0.0) stats->r2 = (float)(1.0 - ssRes / ssTot);
+        else stats->r2 = (ssRes == 0.0) ? 1.0f : 0.0f;
+    }
+
+    const char* statusName(Status status) {
+        static const char* const NAMES[] = {
+            "ok", "invalid_input", "insufficient_points", "ill_conditioned"
+        };
+        return ((unsigned)status < sizeof(NAMES) / sizeof(NAMES[0])) ? NAMES[status] : "unknown";
+    }
+
+} // namespace LeastSquares
@@ -0,0 +1,113 @@
+/**
+ * @file LeastSquares.h
+ * @brief Ajuste por mínimos cuadrados para calibración de sensores en el dispositivo.
+ * @details Resuelve min ||A·x - b|| mediante factorización QR con reflexiones de
+ *          Householder en doble precisión, sin formar las ecuaciones normales AᵀA
+ *          (que elevan al cuadrado el número de condición). Para polinomios la
+ *          variable independiente se centra y escala a [-1, 1] antes de construir
+ *          la matriz de Vandermonde y los coeficientes se devuelven en la base
+ *          monomial original (c0 + c1·x + c2·x² + ...).
+ *
+ *          No usa memoria dinámica: los tamaños están acotados por
+ *          LSQ_MAX_POINTS y LSQ_MAX_TERMS.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef LEAST_SQUARES_H
+#define LEAST_SQUARES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LSQ_MAX_POINTS  16   ///< Máximo de puntos por ajuste
+#define LSQ_MAX_TERMS   4    ///< Máximo de incógnitas (polinomio cúbico)
+
+/**
+ * @namespace LeastSquares
+ * @brief Solucionador QR y utilidades de ajuste con métricas de bondad.
+ */
+namespace LeastSquares {
+
+    /**
+     * @enum Status
+     * @brief Resultado de un ajuste.
+     */
+    enum Status {
+        LSQ_OK = 0,                ///< Ajuste calculado
+        LSQ_INVALID_INPUT,         ///< Dimensiones fuera de límites o valores NaN/Inf
+        LSQ_INSUFFICIENT_POINTS,   ///< Menos puntos que incógnitas
+        LSQ_ILL_CONDITIONED        ///< Columnas (casi) linealmente dependientes
+    };
+
+    /**
+     * @struct FitStats
+     * @brief Métricas de bondad del ajuste, calculadas con los coeficientes finales.
+     */
+    struct FitStats {
+        uint8_t n;              ///< Puntos usados
+        uint8_t terms;          ///< Parámetros ajustados
+        float rmse;             ///< Raíz del error cuadrático medio
+        float maxAbsResidual;   ///< Mayor residuo en valor absoluto
+        float r2;               ///< Coeficiente de determinación R²
+    };
+
+    /**
+     * @brief Resuelve min ||A·x - b|| por QR de Householder (en sitio).
+     * @param A Matriz fila-mayor de rows×cols; se sobrescribe con R
+     * @param b Vector de rows elementos; se sobrescribe con Qᵀb
+     * @param rows Número de ecuaciones (≤ LSQ_MAX_POINTS)
+     * @param cols Número de incógnitas (≤ LSQ_MAX_TERMS, ≤ rows)
+     * @param[out] x Solución de cols elementos
+     * @return LSQ_OK o el motivo del fallo
+     */
+    Status solve(double* A, double* b, size_t rows, size_t cols, double* x);
+
+    /**
+     * @brief Ajusta y = c0 + c1·x + ... + cd·x^d.
+     * @param x Variable independiente (p. ej. voltaje)
+     * @param y Valores de referencia
+     * @param n Número de puntos
+     * @param degree Grado del polinomio (1..LSQ_MAX_TERMS-1)
+     * @param[out] coeffs degree+1 coeficientes en orden ascendente
+     * @param[out] residuals n residuos y - ŷ (puede ser nullptr)
+     * @param[out] stats Métricas del ajuste (puede ser nullptr)
+     * @return LSQ_OK o el motivo del fallo
+     */
+    Status fitPolynomial(const float* x, const float* y, size_t n, uint8_t degree,
+                         float* coeffs, float* residuals, FitStats* stats);
+
+    /**
+     * @brief Ajusta un factor de escala sin término independiente: y = k·f.
+     * @param f Respuesta del modelo base en cada punto
+     * @param y Valores de referencia
+     * @param n Número de puntos
+     * @param[out] k Factor ajustado
+     * @param[out] residuals n residuos (puede ser nullptr)
+     * @param[out] stats Métricas del ajuste (puede ser nullptr)
+     * @return LSQ_OK o el motivo del fallo
+     */
+    Status fitScale(const float* f, const float* y, size_t n,
+                    float* k, float* residuals, FitStats* stats);
+
+    /**
+     * @brief Calcula residuos y métricas a partir de las predicciones ŷ.
+     * @param y Valores de referencia
+     * @param yhat Valores predichos por el modelo
+     * @param n Número de puntos
+     * @param terms Parámetros del modelo
+     * @param[out] residuals n residuos (puede ser nullptr)
+     * @param[out] stats Métricas resultantes
+     */
+    void computeStats(const float* y, const float* yhat, size_t n, uint8_t terms,
+                      float* residuals, FitStats* stats);
+
+    /**
+     * @brief Nombre corto del estado (para logs y respuestas JSON).
+     */
+    const char* statusName(Status status);
+
+} // namespace LeastSquares
+
+#endif // LEAST_SQUARES_H
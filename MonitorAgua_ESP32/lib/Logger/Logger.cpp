@@ -0,0 +1,352 @@
+/**
+ * @file Logger.cpp
+ * @brief Implementación del backend de logging en modo texto y binario diferido.
+ * @details Los productores nunca escriben en Serial: formatean (modo texto) o
+ *          serializan (modo binario) en la pila y copian el resultado a un buffer
+ *          circular sin bloqueo. Una tarea de baja prioridad lo drena hacia la UART,
+ *          de modo que la temporización del muestreo no depende de la cantidad
+ *          de log del build. Si el buffer está lleno el mensaje se descarta y se
+ *          incrementa un contador.
+ *
+ *          Registro binario (LOG_MODE_BINARY):
+ *
+ *          | sync 0xA5 | nivel | len | t_ms (u32) | tag (u32) | fmt (u32) | args[len] | suma |
+ *
+ *          tag y fmt son las direcciones de los literales en flash; el decodificador
+ *          del host (tools/log_decoder.py) las resuelve con el ELF.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include "Logger.h"
+#include <string.h>
+#include <atomic>
+
+namespace Logger {
+
+    static_assert((LOG_SINK_RING_SIZE & (LOG_SINK_RING_SIZE - 1)) == 0,
+                  "LOG_SINK_RING_SIZE debe ser potencia de 2");
+
+    // ——— Variables internas del módulo ———
+
+    /**
+     * @brief Callback de líneas de texto (nullptr = buffer circular → Serial).
+     */
+    static LineCallback line_callback = nullptr;
+
+    /**
+     * @brief Buffer circular de salida compartido por ambos modos.
+     * @details head solo lo avanza el productor que tiene producer_busy y tail solo
+     *          la tarea de drenado; los índices son monótonos y se enmascaran al usar.
+     */
+    static uint8_t ring[LOG_SINK_RING_SIZE];
+    static std::atomic<uint32_t> ring_head(0);
+    static std::atomic<uint32_t> ring_tail(0);
+
+    /**
+     * @brief Exclusión no bloqueante entre productores.
+     * @details Un productor que encuentra la bandera tomada (p. ej. un callback
+     *          de WiFi que interrumpe al loop) descarta su mensaje en vez de esperar.
+     */
+    static std::atomic_flag producer_busy = ATOMIC_FLAG_INIT;
+
+    /**
+     * @brief Mensajes descartados por buffer lleno o contención.
+     */
+    static std::atomic<uint32_t> dropped_count(0);
+
+#ifndef LOG_MODE_BINARY
+    /**
+     * @brief Descartes ya notificados por la tarea de drenado.
+     */
+    static uint32_t dropped_reported = 0;
+#endif
+
+    /**
+     * @brief Tarea de drenado (nullptr = salida síncrona, antes de begin()).
+     */
+    static TaskHandle_t drain_task = nullptr;
+
+    // ——— Buffer circular ———
+
+    /**
+     * @brief Copia un bloque completo al buffer circular sin bloquear.
+     * @return false si el bloque se descartó
+     */
+    static bool sinkPush(const uint8_t* data, size_t len) {
+        if (producer_busy.test_and_set(std::memory_order_acquire)) {
+            dropped_count.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        uint32_t head = ring_head.load(std::memory_order_relaxed);
+        uint32_t tail = ring_tail.load(std::memory_order_acquire);
+        if (LOG_SINK_RING_SIZE - (head - tail) < len) {
+            producer_busy.clear(std::memory_order_release);
+            dropped_count.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        uint32_t start = head & (LOG_SINK_RING_SIZE - 1);
+        size_t first = LOG_SINK_RING_SIZE - start;
+        if (first > len) first = len;
+        memcpy(ring + start, data, first);
+        memcpy(ring, data + first, len - first);
+
+        ring_head.store(head + len, std::memory_order_release);
+        producer_busy.clear(std::memory_order_release);
+
+        if (drain_task) {
+            xTaskNotifyGive(drain_task);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Escribe en Serial lo pendiente del buffer (solo la tarea de drenado
+     *        o el llamador de flush() cuando no hay tarea).
+     */
+    static void sinkDrain() {
+        uint32_t tail = ring_tail.load(std::memory_order_relaxed);
+        uint32_t head = ring_head.load(std::memory_order_acquire);
+
+        while (tail != head) {
+            uint32_t start = tail & (LOG_SINK_RING_SIZE - 1);
+            uint32_t chunk = LOG_SINK_RING_SIZE - start;
+            if (chunk > head - tail) chunk = head - tail;
+            Serial.write(ring + start, chunk);
+            tail += chunk;
+            ring_tail.store(tail, std::memory_order_release);
+            head = ring_head.load(std::memory_order_acquire);
+        }
+
+#ifndef LOG_MODE_BINARY
+        uint32_t dropped = dropped_count.load(std::memory_order_relaxed);
+        if (dropped != dropped_reported) {
+            Serial.printf("[W][LOG] %u mensajes descartados (buffer lleno)\n",
+                          (unsigned)(dropped - dropped_reported));
+            dropped_reported = dropped;
+        }
+#endif
+    }
+
+    /**
+     * @brief Cuerpo de la tarea de drenado: duerme hasta que haya datos.
+     */
+    static void drainTask(void* arg) {
+        (void)arg;
+        for (;;) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            sinkDrain();
+        }
+    }
+
+#ifdef LOG_MODE_BINARY
+
+    static const size_t RECORD_HEADER = 15;   ///< sync + nivel + len + t_ms + tag + fmt
+    static const size_t MAX_PAYLOAD = 255;    ///< Máximo de bytes de argumentos
+
+    /**
+     * @brief Copia un entero little-endian en el buffer de registro.
+     */
+    static size_t putU32(uint8_t* dst, uint32_t value) {
+        dst[0] = value & 0xFF;
+        dst[1] = (value >> 8) & 0xFF;
+        dst[2] = (value >> 16) & 0xFF;
+        dst[3] = (value >> 24) & 0xFF;
+        return 4;
+    }
+
+    /**
+     * @brief Serializa los argumentos según los especificadores del formato.
+     * @details Enteros y punteros ocupan 4 bytes, %ll 8 bytes, flotantes se
+     *          guardan como float de 4 bytes y %s como longitud (u8) + bytes.
+     *          El decodificador aplica exactamente las mismas reglas.
+     * @return Bytes escritos en payload
+     */
+    static size_t encodeArgs(uint8_t* payload, const char* format, va_list args) {
+        size_t n = 0;
+        const char* p = format;
+
+        while (*p) {
+            if (*p++ != '%') continue;
+            if (*p == '%') { p++; continue; }
+
+            // Flags, ancho y precisión ('*' consume un int)
+            while (*p && strchr("-+ #0", *p)) p++;
+            if (*p == '*') {
+                int w = va_arg(args, int);
+                if (n + 4 <= MAX_PAYLOAD) n += putU32(payload + n, (uint32_t)w);
+                p++;
+            }
+            while (*p >= '0' && *p <= '9') p++;
+            if (*p == '.') {
+                p++;
+                if (*p == '*') {
+                    int w = va_arg(args, int);
+                    if (n + 4 <= MAX_PAYLOAD) n += putU32(payload + n, (uint32_t)w);
+                    p++;
+                }
+                while (*p >= '0' && *p <= '9') p++;
+            }
+
+            // Modificadores de longitud
+            bool is64 = false;
+            if (*p == 'l' && *(p + 1) == 'l') { is64 = true; p += 2; }
+            else if (*p == 'j') { is64 = true; p++; }
+            else { while (*p && strchr("hlzt", *p)) p++; }
+
+            char conv = *p;
+            if (conv == '\0') break;
+            p++;
+
+            switch (conv) {
+                case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+                    if (is64) {
+                        uint64_t v = va_arg(args, uint64_t);
+                        if (n + 8 <= MAX_PAYLOAD) {
+                            n += putU32(payload + n, (uint32_t)(v & 0xFFFFFFFF));
+                            n += putU32(payload + n, (uint32_t)(v >> 32));
+                        }
+                    } else {
+                        uint32_t v = va_arg(args, uint32_t);
+                        if (n + 4 <= MAX_PAYLOAD) n += putU32(payload + n, v);
+                    }
+                    break;
+                case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                    float f = (float)va_arg(args, double);
+                    uint32_t bits;
+                    memcpy(&bits, &f, sizeof(bits));
+                    if (n + 4 <= MAX_PAYLOAD) n += putU32(payload + n, bits);
+                    break;
+                }
+                case 'p': {
+                    uint32_t v = (uint32_t)(uintptr_t)va_arg(args, void*);
+                    if (n + 4 <= MAX_PAYLOAD) n += putU32(payload + n, v);
+                    break;
+                }
+                case 's': {
+                    const char* s = va_arg(args, const char*);
+                    if (!s) s = "(null)";
+                    size_t len = strnlen(s, LOG_BINARY_MAX_STR);
+                    if (n + 1 + len > MAX_PAYLOAD) len = (MAX_PAYLOAD > n + 1) ? MAX_PAYLOAD - n - 1 : 0;
+                    if (n + 1 <= MAX_PAYLOAD) {
+                        payload[n++] = (uint8_t)len;
+                        memcpy(payload + n, s, len);
+                        n += len;
+                    }
+                    break;
+                }
+                default:
+                    break;  // Especificador desconocido: no consume argumento
+            }
+        }
+        return n;
+    }
+
+#endif // LOG_MODE_BINARY
+
+    // ——— Implementación de funciones ———
+
+    bool begin(UBaseType_t priority) {
+        if (drain_task) return true;
+        BaseType_t ok = xTaskCreate(drainTask, "log_drain", LOG_SINK_TASK_STACK,
+                                    nullptr, priority, &drain_task);
+        if (ok != pdPASS) {
+            drain_task = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    char levelChar(uint8_t level) {
+        switch (level) {
+            case LOG_LEVEL_ERROR: return 'E';
+            case LOG_LEVEL_WARN:  return 'W';
+            case LOG_LEVEL_INFO:  return 'I';
+            case LOG_LEVEL_DEBUG: return 'D';
+            default:              return '?';
+        }
+    }
+
+    void write(uint8_t level, const char* tag, const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        vwrite(level, tag, format, args);
+        va_end(args);
+    }
+
+    void vwrite(uint8_t level, const char* tag, const char* format, va_list args) {
+#ifdef LOG_MODE_BINARY
+        if (!line_callback) {
+            uint8_t record[RECORD_HEADER + MAX_PAYLOAD + 1];
+            size_t payload_len = encodeArgs(record + RECORD_HEADER, format, args);
+
+            record[0] = LOG_BINARY_SYNC;
+            record[1] = level;
+            record[2] = (uint8_t)payload_len;
+            putU32(record + 3, millis());
+            putU32(record + 7, (uint32_t)(uintptr_t)tag);
+            putU32(record + 11, (uint32_t)(uintptr_t)format);
+
+            uint8_t sum = 0;
+            for (size_t i = 1; i < RECORD_HEADER + payload_len; i++) sum += record[i];
+            record[RECORD_HEADER + payload_len] = sum;
+
+            sinkPush(record, RECORD_HEADER + payload_len + 1);
+            if (!drain_task) sinkDrain();
+            return;
+        }
+#endif
+        char buffer[LOG_LINE_MAX];
+
+        if (line_callback) {
+            vsnprintf(buffer, sizeof(buffer), format, args);
+            line_callback(level, tag, buffer);
+            return;
+        }
+
+        int prefix = snprintf(buffer, sizeof(buffer), "[%c][%s]", levelChar(level), tag);
+        if (prefix < 0 || prefix >= (int)sizeof(buffer) - 1) return;
+        int body = vsnprintf(buffer + prefix, sizeof(buffer) - prefix - 1, format, args);
+        if (body < 0) return;
+        size_t len = prefix + body;
+        if (len > sizeof(buffer) - 2) len = sizeof(buffer) - 2;  // Línea truncada
+        buffer[len++] = '\n';
+
+        sinkPush((const uint8_t*)buffer, len);
+        if (!drain_task) sinkDrain();
+    }
+
+    void setCallback(LineCallback callback) {
+        line_callback = callback;
+    }
+
+    bool flush(uint32_t deadline_ms) {
+        if (!drain_task) {
+            sinkDrain();
+            Serial.flush();
+            return true;
+        }
+
+        uint32_t target = ring_head.load(std::memory_order_acquire);
+        uint32_t start = millis();
+        xTaskNotifyGive(drain_task);
+
+        // Esperar a que la tarea de drenado alcance lo escrito hasta ahora
+        while ((int32_t)(target - ring_tail.load(std::memory_order_acquire)) > 0) {
+            if (millis() - start >= deadline_ms) {
+                return false;
+            }
+            vTaskDelay(1);
+        }
+        Serial.flush();  // FIFO de la UART: acotado por su tamaño
+        return true;
+    }
+
+    uint32_t getDroppedCount() {
+        return dropped_count.load(std::memory_order_relaxed);
+    }
+
+} // namespace Logger
@@ -0,0 +1,161 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+/**
+ * @file Logger.h
+ * @brief Capa unificada de logging con filtrado de nivel en compilación.
+ * @details Reemplaza los métodos log()/logf() propios de cada gestor y los
+ *          Serial.printf() directos de los sensores. Ofrece dos modos:
+ *          - Texto (por defecto): formatea con vsnprintf y encola la línea.
+ *          - Binario diferido (-D LOG_MODE_BINARY): guarda en un buffer circular
+ *            el identificador del formato (dirección del literal en flash) y los
+ *            argumentos crudos; el formateo lo realiza en el host
+ *            tools/log_decoder.py usando el ELF del firmware.
+ *
+ *          En ambos modos la salida pasa por un buffer circular no bloqueante
+ *          que drena una tarea de baja prioridad (ver begin() y flush()).
+ *
+ *          Los niveles por encima de LOG_LEVEL se descartan en compilación: las
+ *          macros expanden a un `if` con condición constante falsa, por lo que el
+ *          compilador elimina la llamada, sus argumentos y el literal de formato.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+// ——— Niveles de log ———
+#define LOG_LEVEL_NONE    0   ///< Sin salida
+#define LOG_LEVEL_ERROR   1   ///< Errores que afectan la operación
+#define LOG_LEVEL_WARN    2   ///< Situaciones anómalas recuperables
+#define LOG_LEVEL_INFO    3   ///< Eventos normales del ciclo
+#define LOG_LEVEL_DEBUG   4   ///< Trazas detalladas de depuración
+
+/**
+ * @brief Nivel máximo compilado. Definir con -D LOG_LEVEL=n en platformio.ini.
+ */
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+/**
+ * @brief Tamaño del buffer de formateo en modo texto (bytes).
+ */
+#ifndef LOG_LINE_MAX
+#define LOG_LINE_MAX 256
+#endif
+
+/**
+ * @brief Tamaño del buffer circular de salida (potencia de 2).
+ */
+#ifndef LOG_SINK_RING_SIZE
+#define LOG_SINK_RING_SIZE 4096
+#endif
+
+/**
+ * @brief Pila (bytes) de la tarea que drena el buffer hacia Serial.
+ */
+#ifndef LOG_SINK_TASK_STACK
+#define LOG_SINK_TASK_STACK 2048
+#endif
+
+/**
+ * @brief Tiempo máximo que flush() espera antes de dormir (ms).
+ */
+#ifndef LOG_FLUSH_DEADLINE_MS
+#define LOG_FLUSH_DEADLINE_MS 50
+#endif
+
+/**
+ * @brief Longitud máxima copiada por cada argumento %s en modo binario.
+ */
+#ifndef LOG_BINARY_MAX_STR
+#define LOG_BINARY_MAX_STR 32
+#endif
+
+#define LOG_BINARY_SYNC 0xA5  ///< Byte de sincronización de cada registro binario
+
+/**
+ * @brief true si el nivel indicado se compila en este build.
+ */
+#define LOG_ENABLED(level) ((level) <= LOG_LEVEL)
+
+/**
+ * @brief Emite `expr` solo si el nivel está habilitado en compilación.
+ */
+#define LOG_IF(level, expr) do { if (LOG_ENABLED(level)) { expr; } } while (0)
+
+// ——— Macros para módulos (namespaces y main) ———
+#define LOG_E(tag, ...) LOG_IF(LOG_LEVEL_ERROR, Logger::write(LOG_LEVEL_ERROR, tag, __VA_ARGS__))
+#define LOG_W(tag, ...) LOG_IF(LOG_LEVEL_WARN,  Logger::write(LOG_LEVEL_WARN,  tag, __VA_ARGS__))
+#define LOG_I(tag, ...) LOG_IF(LOG_LEVEL_INFO,  Logger::write(LOG_LEVEL_INFO,  tag, __VA_ARGS__))
+#define LOG_D(tag, ...) LOG_IF(LOG_LEVEL_DEBUG, Logger::write(LOG_LEVEL_DEBUG, tag, __VA_ARGS__))
+
+// ——— Macros para clases gestoras (usan su método privado logf(nivel, ...)) ———
+#define MLOG_E(...) LOG_IF(LOG_LEVEL_ERROR, logf(LOG_LEVEL_ERROR, __VA_ARGS__))
+#define MLOG_W(...) LOG_IF(LOG_LEVEL_WARN,  logf(LOG_LEVEL_WARN,  __VA_ARGS__))
+#define MLOG_I(...) LOG_IF(LOG_LEVEL_INFO,  logf(LOG_LEVEL_INFO,  __VA_ARGS__))
+#define MLOG_D(...) LOG_IF(LOG_LEVEL_DEBUG, logf(LOG_LEVEL_DEBUG, __VA_ARGS__))
+
+/**
+ * @namespace Logger
+ * @brief Backend común de logging para gestores, sensores y programa principal.
+ */
+namespace Logger {
+
+    /**
+     * @brief Callback opcional que recibe cada línea ya formateada (modo texto).
+     */
+    typedef void (*LineCallback)(uint8_t level, const char* tag, const char* line);
+
+    /**
+     * @brief Arranca la tarea de drenado del buffer de salida.
+     * @param priority Prioridad FreeRTOS de la tarea (por defecto la mínima útil)
+     * @return true si la tarea quedó creada
+     * @note Llamar después de Serial.begin(). Antes de begin() la salida es síncrona.
+     */
+    bool begin(UBaseType_t priority = tskIDLE_PRIORITY + 1);
+
+    /**
+     * @brief Registra una línea de log con formato printf.
+     * @param level Nivel LOG_LEVEL_*
+     * @param tag Etiqueta del módulo (literal estático)
+     * @param format Cadena de formato (literal estático)
+     */
+    void write(uint8_t level, const char* tag, const char* format, ...)
+        __attribute__((format(printf, 3, 4)));
+
+    /**
+     * @brief Variante con va_list, usada por los logf() de los gestores.
+     */
+    void vwrite(uint8_t level, const char* tag, const char* format, va_list args);
+
+    /**
+     * @brief Redirige las líneas de texto a un callback en lugar de Serial.
+     * @param callback Función destino o nullptr para volver a Serial
+     */
+    void setCallback(LineCallback callback);
+
+    /**
+     * @brief Espera a que se transmita lo encolado, con plazo máximo.
+     * @param deadline_ms Tiempo máximo de espera en ms
+     * @return true si todo se transmitió, false si venció el plazo
+     * @note Pensado para llamarse justo antes de entrar en deep sleep.
+     */
+    bool flush(uint32_t deadline_ms = LOG_FLUSH_DEADLINE_MS);
+
+    /**
+     * @brief Mensajes descartados por buffer lleno desde el arranque.
+     */
+    uint32_t getDroppedCount();
+
+    /**
+     * @brief Letra asociada a un nivel ('E', 'W', 'I', 'D').
+     */
+    char levelChar(uint8_t level);
+
+} // namespace Logger
+
+#endif // LOGGER_H
@@ -1,4 +1,3 @@
-<<<<<<< HEAD
 /**
  * @file RTC.cpp
  * @brief Implementación de la clase MAX31328RTC para manejo del RTC mediante I2C.
@@ -13,6 +12,40 @@
  */
 
 #include "RTC.h"
+#include "Logger.h"
+#include "HAL.h"
+#include "Trace.h"
+
+static const char TAG[] = "RTC"; ///< Etiqueta de log del módulo
+
+/**
+ * @brief Marca de RTC ya configurado (oscilador activo y hora válida).
+ * @details Sobrevive al deep sleep; permite que begin() tome la ruta rápida sin
+ *          reiniciar el bus ni esperar. Se borra ante cualquier fallo de lectura.
+ */
+#define MAX31328_WARM_MAGIC 0x31328A5Au
+static HAL_PERSISTENT uint32_t rtc_warm_marker = 0;
+
+/**
+ * @brief Describe en el log un código de error de Wire.endTransmission().
+ * @param error Código devuelto por Wire.
+ */
+static void logI2CError(uint8_t error) {
+    switch (error) { // Evalúa el tipo de error según el valor devuelto
+        case 2: // Error código 2
+            LOG_E(TAG, "MAX31328: NACK en dirección - dispositivo no responde"); // No hubo ACK en la dirección
+            break;
+        case 4: // Error código 4
+            LOG_E(TAG, "MAX31328: Error desconocido en I2C"); // Se detectó un error no identificado
+            break;
+        case 5: // Error código 5
+            LOG_W(TAG, "MAX31328: Timeout en I2C"); // Tiempo de espera agotado en la comunicación
+            break;
+        default: // Cualquier otro error no documentado
+            LOG_E(TAG, "MAX31328: Error I2C no documentado: %d", error); // Muestra el error tal cual
+            break;
+    }
+}
 
 /**
  * @brief Constructor de la clase MAX31328RTC.
@@ -22,19 +55,19 @@
 MAX31328RTC::MAX31328RTC() {
     i2c_address = MAX31328_I2C_ADDRESS;
     initialized = false;
-=======
-#include "RTC.h" // Incluye el archivo de cabecera.
-
-MAX31328RTC::MAX31328RTC() { // Constructor de la clase MAX31328RTC. Se ejecuta al crear un objeto de este tipo.
-    i2c_address = MAX31328_I2C_ADDRESS; // Asigna la dirección I2C por defecto del chip RTC (definida en RTC.h).
-    initialized = false; // Inicializa el estado del dispositivo como no inicializado.
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
+    snapshot_valid = false;
+    snapshot_millis = 0;
+    snapshot_epoch = 0;
+    memset(snapshot, 0, sizeof(snapshot));
 }
 
 /**
  * @brief Inicializa el dispositivo RTC en el bus I2C.
  * 
- * Configura los pines, velocidad I2C y verifica presencia y oscilador.
+ * Configura los pines y la velocidad I2C y carga la instantánea de registros.
+ * En arranque en frío reinicia el bus y arranca el oscilador si está detenido;
+ * en arranque en caliente (RTC ya configurado en un ciclo anterior) no hay
+ * reinicio del bus ni pausas fijas.
  * 
  * @param sda_pin Pin SDA.
  * @param scl_pin Pin SCL.
@@ -45,171 +78,170 @@ MAX31328RTC::MAX31328RTC() { // Constructor de la clase MAX31328RTC. Se ejecuta
 bool MAX31328RTC::begin(int sda_pin, int scl_pin, uint8_t address) {
     // Función de inicio: configura la comunicación I2C y valida la presencia del RTC.
     i2c_address = address; // Se guarda la dirección I2C indicada por el usuario o por defecto.
+    initialized = false;
+    invalidateCache();
+
+    bool warm = (rtc_warm_marker == MAX31328_WARM_MAGIC);
     
-    //Serial.printf("MAX31328: Inicializando I2C (SDA=%d, SCL=%d, Addr=0x%02X)\n", 
-                  //sda_pin, scl_pin, i2c_address);
-    
-    // Inicializar I2C con pines específicos
-    Wire.end(); // Terminar sesión previa si existe (// Finaliza cualquier comunicación I2C previa para reiniciar la conexión limpia.)
-    delay(100); // Pequeña pausa para estabilizar el bus I2C después de cerrarlo.
+    if (!warm) {
+        Wire.end(); // Arranque en frío: finaliza cualquier sesión I2C previa para partir de un bus limpio
+    }
     
     if (!Wire.begin(sda_pin, scl_pin)) { // Intenta iniciar la comunicación I2C en los pines especificados.
-        Serial.println("MAX31328: Error inicializando I2C"); // Muestra error si no logra inicializar.
+        LOG_E(TAG, "MAX31328: Error inicializando I2C"); // Muestra error si no logra inicializar.
+        rtc_warm_marker = 0;
         return false; // Devuelve falso para indicar que no se pudo inicializar.
     }
     
-    // Configurar velocidad I2C (100kHz para mayor compatibilidad)
-    Wire.setClock(MAX31328_I2C_SPEED); // Configura la velocidad de transmisión I2C (ejemplo: 100kHz para mayor compatibilidad).
-    delay(200); // Dar tiempo para estabilización
+    Wire.setClock(MAX31328_I2C_SPEED); // Fast-mode 400kHz
     
-    // Verificar presencia del dispositivo
+    // Una sola lectura en ráfaga confirma presencia y trae tiempo, control y status
     if (!isPresent()) { // Verifica si el dispositivo está presente en el bus I2C.
-        Serial.println("MAX31328: Dispositivo no detectado en I2C"); // Si no se encuentra, muestra error.
+        LOG_E(TAG, "MAX31328: Dispositivo no detectado en I2C"); // Si no se encuentra, muestra error.
+        rtc_warm_marker = 0;
         return false; // Retorna falso porque el RTC no está conectado o no responde.
     }
+
+    bool oscillatorOk = !(snapshot[MAX31328_REG_STATUS] & MAX31328_STAT_OSF) &&
+                        !(snapshot[MAX31328_REG_CONTROL] & MAX31328_CTRL_EOSC);
+
+    if (warm && oscillatorOk) { // Ruta rápida: nada que configurar
+        initialized = true;
+        LOG_D(TAG, "MAX31328: Arranque en caliente");
+        return true;
+    }
     
-    Serial.println("MAX31328: Dispositivo detectado correctamente"); // Mensaje indicando que el RTC respondió bien.
+    LOG_I(TAG, "MAX31328: Dispositivo detectado correctamente"); // Mensaje indicando que el RTC respondió bien.
     
     // Verificar si el oscilador está funcionando
-    if (!isRunning()) { // Verifica si el oscilador interno del RTC está funcionando.
-        //Serial.println("MAX31328: Oscilador detenido - Iniciando...");
+    if (!oscillatorOk) { // El oscilador se detuvo o está deshabilitado
         if (!startOscillator()) { // Intenta iniciar el oscilador si estaba apagado.
-            Serial.println("MAX31328: Error iniciando oscilador"); // Si falla, muestra mensaje de error.
+            LOG_E(TAG, "MAX31328: Error iniciando oscilador"); // Si falla, muestra mensaje de error.
+            rtc_warm_marker = 0;
             return false; // Retorna falso indicando que no se pudo iniciar el oscilador.
         }
         
     }
     
     initialized = true; // Marca el dispositivo como inicializado exitosamente.
-    Serial.println("MAX31328: Inicialización completada"); // Mensaje de éxito en la inicialización.
+    rtc_warm_marker = MAX31328_WARM_MAGIC;
+    LOG_I(TAG, "MAX31328: Inicialización completada"); // Mensaje de éxito en la inicialización.
     
     return true; // Devuelve verdadero, indicando que el RTC está listo para usarse.
 }
 
-<<<<<<< HEAD
 /**
  * @brief Verifica si el dispositivo está presente en el bus I2C.
+ * @details Si la instantánea del ciclo ya está cargada no se accede al bus.
  * @return true si responde en la dirección I2C.
  * @return false si no responde o hay error.
  */
 
 bool MAX31328RTC::isPresent() {
-    Wire.beginTransmission(i2c_address);
-    uint8_t error = Wire.endTransmission();
-=======
-bool MAX31328RTC::isPresent() { // Función que verifica si el dispositivo RTC está presente en el bus I2C
-    Wire.beginTransmission(i2c_address); // Inicia la comunicación I2C con la dirección configurada
-    uint8_t error = Wire.endTransmission(); // Finaliza la transmisión y obtiene el código de error
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
-    
-    if (error == 0) { // Si no hubo error, significa que el dispositivo respondió correctamente
-        // Intentar leer el registro de estado para confirmar
-        uint8_t status = readRegister(MAX31328_REG_STATUS); // Lee el registro de estado del RTC
-        
-        if (status == 0xFF) { // 0xFF indica una lectura inválida (error de comunicación o sin datos)
-            Serial.println("MAX31328: Registro de estado inválido (0xFF)"); // Mensaje de error por puerto serie
-            return false; // El dispositivo no respondió correctamente
-        }
-        
-        Serial.printf("MAX31328: Dispositivo presente - Status: 0x%02X\n", status); // Imprime el estado leído  
-        return true; // Retorna que el dispositivo está presente
+    if (snapshot_valid) {
+        return true;
     }
-    
-    Serial.printf("MAX31328: Error I2C: %d\n", error); // Si hubo error en la comunicación I2C, imprime el código
-    switch (error) { // Evalúa el tipo de error según el valor devuelto
-        case 2: // Error código 2
-            Serial.println("MAX31328: NACK en dirección - dispositivo no responde"); // No hubo ACK en la dirección
-            break;
-        case 4: // Error código 4
-            Serial.println("MAX31328: Error desconocido en I2C"); // Se detectó un error no identificado
-            break;
-        case 5: // Error código 5
-            Serial.println("MAX31328: Timeout en I2C"); // Tiempo de espera agotado en la comunicación
-            break;
-        default: // Cualquier otro error no documentado
-            Serial.printf("MAX31328: Error I2C no documentado: %d\n", error); // Muestra el error tal cual
-            break;
+
+    if (!readSnapshot()) {
+        return false; // El detalle del error ya quedó en el log
     }
-    
-    return false; // Si llegamos aquí, el dispositivo no está presente o no respondió bien
+
+    LOG_D(TAG, "MAX31328: Dispositivo presente - Status: 0x%02X", snapshot[MAX31328_REG_STATUS]); // Imprime el estado leído  
+    return true; // Retorna que el dispositivo está presente
+}
+
+/**
+ * @brief Vuelve a leer todos los registros en una sola transacción.
+ * @return true si la lectura fue exitosa.
+ */
+
+bool MAX31328RTC::refresh() {
+    invalidateCache();
+    return readSnapshot();
+}
+
+/**
+ * @brief Descarta la instantánea; la siguiente consulta vuelve a leer el RTC.
+ */
+
+void MAX31328RTC::invalidateCache() {
+    snapshot_valid = false;
 }
 
-<<<<<<< HEAD
 /**
  * @brief Verifica si el oscilador está en funcionamiento.
  * @return true si está corriendo, false si está detenido.
  */
 
 bool MAX31328RTC::isRunning() {
-    if (!initialized && !isPresent()) {
+    if (!ensureSnapshot()) {
         return false;
-=======
-bool MAX31328RTC::isRunning() { // Función que verifica si el oscilador interno del RTC está funcionando
-    if (!initialized && !isPresent()) { // Si no está inicializado y tampoco se detecta el dispositivo
-        return false; // No está funcionando
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     }
     
-    uint8_t status = readRegister(MAX31328_REG_STATUS); // Lee el registro de estado del RTC
+    uint8_t status = snapshot[MAX31328_REG_STATUS]; // Registro de estado de la instantánea
     
     // El bit OSF (bit 7) indica si el oscilador se detuvo
     bool running = !(status & MAX31328_STAT_OSF); // running será true si el bit OSF está en 0 (oscilador activo)
     
-    Serial.printf("MAX31328: Oscilador %s (Status: 0x%02X)\n", 
-<<<<<<< HEAD
+    LOG_D(TAG, "MAX31328: Oscilador %s (Status: 0x%02X)", 
                 running ? "funcionando" : "detenido", status);
-=======
-                  running ? "funcionando" : "detenido", status); // Imprime si está activo o detenido
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     
     return running; // Retorna el estado del oscilador
 }
 
-<<<<<<< HEAD
 /**
  * @brief Inicia el oscilador del RTC.
+ * @details En lugar de una pausa fija, sondea el registro de segundos hasta que
+ *          avanza (oscilador confirmado) o vence MAX31328_OSC_TIMEOUT_MS.
  * @return true si se inició correctamente.
  */
 
 bool MAX31328RTC::startOscillator() {
-    Serial.println("MAX31328: Iniciando oscilador...");
-=======
-bool MAX31328RTC::startOscillator() { // Función que inicia el oscilador del RTC si estaba detenido
-    Serial.println("MAX31328: Iniciando oscilador..."); // Mensaje informativo
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
+    LOG_I(TAG, "MAX31328: Iniciando oscilador...");
     
     // Leer registro de control
     uint8_t control = readRegister(MAX31328_REG_CONTROL); // Se obtiene el valor actual del registro de control
-    Serial.printf("MAX31328: Control actual: 0x%02X\n", control); // Se imprime el valor leído
+    LOG_D(TAG, "MAX31328: Control actual: 0x%02X", control); // Se imprime el valor leído
     
     // Habilitar oscilador (EOSC = 0). Se limpia el bit de apagado del oscilador
     control &= ~MAX31328_CTRL_EOSC; // Apaga el bit EOSC para activar el oscilador
     
     if (!writeRegister(MAX31328_REG_CONTROL, control)) { // Escribe el nuevo valor en el registro de control
-        Serial.println("MAX31328: Error escribiendo registro de control"); // Si falla, muestra error
+        LOG_E(TAG, "MAX31328: Error escribiendo registro de control"); // Si falla, muestra error
         return false; // Y retorna false
     }
     
     // Limpiar flag OSF
     if (!clearLostTimeFlag()) { // Se intenta borrar el flag que indica pérdida de tiempo
-        Serial.println("MAX31328: Error limpiando flag OSF"); // Error al limpiar el flag
+        LOG_E(TAG, "MAX31328: Error limpiando flag OSF"); // Error al limpiar el flag
         return false; // Retorna falso si no pudo
     }
     
-    delay(1000); // Dar tiempo para que se estabilice. Se espera 1 segundo para que el oscilador se estabilice
+    // Esperar a que el segundero avance: confirma que el cristal oscila
+    uint8_t firstSeconds = readRegister(MAX31328_REG_SECONDS);
+    uint32_t start = millis();
+    while ((uint32_t)(millis() - start) < MAX31328_OSC_TIMEOUT_MS) {
+        delay(10);
+        uint8_t seconds = readRegister(MAX31328_REG_SECONDS);
+        if (seconds != firstSeconds && seconds != 0xFF) {
+            return refresh() && isRunning(); // Recarga la instantánea con el oscilador ya activo
+        }
+    }
     
-    return isRunning(); // Se comprueba y retorna si el oscilador ya está corriendo
+    LOG_W(TAG, "MAX31328: El oscilador no avanzó en %d ms", MAX31328_OSC_TIMEOUT_MS);
+    return false;
 }
 
-<<<<<<< HEAD
 /**
  * @brief Indica si el RTC perdió el tiempo (flag OSF activo).
  * @return true si perdió el tiempo.
  */
 
 bool MAX31328RTC::hasLostTime() {
-    uint8_t status = readRegister(MAX31328_REG_STATUS);
-    return (status & MAX31328_STAT_OSF) != 0;
+    if (!ensureSnapshot()) {
+        return true; // Sin lectura no se puede confiar en la hora
+    }
+    return (snapshot[MAX31328_REG_STATUS] & MAX31328_STAT_OSF) != 0;
 }
 
 /**
@@ -221,17 +253,6 @@ bool MAX31328RTC::clearLostTimeFlag() {
     uint8_t status = readRegister(MAX31328_REG_STATUS);
     status &= ~MAX31328_STAT_OSF; // Limpiar bit OSF
     return writeRegister(MAX31328_REG_STATUS, status);
-=======
-bool MAX31328RTC::hasLostTime() { // Indica si el RTC ha marcado que perdió tiempo (OSF)
-    uint8_t status = readRegister(MAX31328_REG_STATUS); // Lee el registro STATUS
-    return (status & MAX31328_STAT_OSF) != 0; // Retorna true si el bit OSF está activo
-}
-
-bool MAX31328RTC::clearLostTimeFlag() { // Limpia el flag de pérdida de tiempo (OSF)
-    uint8_t status = readRegister(MAX31328_REG_STATUS); // Lee STATUS
-    status &= ~MAX31328_STAT_OSF; // Limpiar bit OSF. - Borra el bit OSF para indicar que se reseteó la condición
-    return writeRegister(MAX31328_REG_STATUS, status); // Escribe nuevamente STATUS y retorna si tuvo éxito
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
 }
 
 /**
@@ -246,31 +267,22 @@ bool MAX31328RTC::clearLostTimeFlag() { // Limpia el flag de pérdida de tiempo
  */
 
 bool MAX31328RTC::setDateTime(uint16_t year, uint8_t month, uint8_t day, 
-<<<<<<< HEAD
                             uint8_t hour, uint8_t minute, uint8_t second) {
-=======
-                              uint8_t hour, uint8_t minute, uint8_t second) { // Configura fecha y hora en el RTC
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     
     if (!initialized && !isPresent()) { // Verifica que el dispositivo esté inicializado o presente
-        Serial.println("MAX31328: RTC no inicializado"); // Mensaje de error si no lo está
+        LOG_W(TAG, "MAX31328: RTC no inicializado"); // Mensaje de error si no lo está
         return false; // No continuar si no está listo
     }
     
     // Validar rangos
     if (year < 2000 || year > 2099 || month < 1 || month > 12 || 
         day < 1 || day > 31 || hour > 23 || minute > 59 || second > 59) { // Comprueba límites razonables
-        Serial.println("MAX31328: Fecha/hora fuera de rango"); // Log si alguno está fuera de rango
+        LOG_W(TAG, "MAX31328: Fecha/hora fuera de rango"); // Log si alguno está fuera de rango
         return false; // Rechaza configuración inválida
     }
     
-<<<<<<< HEAD
-    Serial.printf("MAX31328: Configurando %04d-%02d-%02d %02d:%02d:%02d\n",
+    LOG_I(TAG, "MAX31328: Configurando %04d-%02d-%02d %02d:%02d:%02d",
                 year, month, day, hour, minute, second);
-=======
-    Serial.printf("MAX31328: Configurando %04d-%02d-%02d %02d:%02d:%02d\n", 
-                  year, month, day, hour, minute, second); // Muestra la fecha/hora que se va a programar
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     
     // Preparar datos en formato BCD
     uint8_t timeRegs[7]; // Buffer con los 7 registros (seg, min, hora, diaSem, dia, mes, año)
@@ -284,14 +296,14 @@ bool MAX31328RTC::setDateTime(uint16_t year, uint8_t month, uint8_t day,
     
     // Escribir todos los registros de tiempo
     if (!writeMultipleRegisters(MAX31328_REG_SECONDS, timeRegs, 7)) { // Escribe desde registro SECONDS los 7 bytes
-        Serial.println("MAX31328: Error escribiendo fecha/hora"); // Error si falla escritura
+        LOG_E(TAG, "MAX31328: Error escribiendo fecha/hora"); // Error si falla escritura
         return false; // Indica fallo
     }
     
     // Limpiar flag OSF
     clearLostTimeFlag(); // Limpia el flag de pérdida de tiempo después de configurar fecha/hora
     
-    Serial.println("MAX31328: Fecha/hora configurada correctamente"); // Confirmación
+    LOG_I(TAG, "MAX31328: Fecha/hora configurada correctamente"); // Confirmación
     return true; // Operación exitosa
 }
 
@@ -309,60 +321,105 @@ bool MAX31328RTC::setDateTime(uint16_t year, uint8_t month, uint8_t day,
 bool MAX31328RTC::getDateTime(uint16_t& year, uint8_t& month, uint8_t& day,
                             uint8_t& hour, uint8_t& minute, uint8_t& second) {
     
-    if (!initialized && !isPresent()) {
+    if (!ensureSnapshot()) {
         return false;
     }
-    
-    // Leer registros de tiempo
-    uint8_t timeRegs[7];
-    if (!readMultipleRegisters(MAX31328_REG_SECONDS, timeRegs, 7)) { // Leer varios registros desde SECONDS
-        Serial.println("MAX31328: Error leyendo fecha/hora"); // Error de lectura
-        return false; // Retorna fallo
+
+    uint32_t elapsed = (uint32_t)millis() - snapshot_millis;
+    if (elapsed >= 1000) { // Instantánea de un segundo o más: extrapolar con millis()
+        time_t now = (time_t)(snapshot_epoch + elapsed / 1000);
+        struct tm timeinfo;
+        gmtime_r(&now, &timeinfo); // Inverso de toEpoch()
+        year = timeinfo.tm_year + 1900;
+        month = timeinfo.tm_mon + 1;
+        day = timeinfo.tm_mday;
+        hour = timeinfo.tm_hour;
+        minute = timeinfo.tm_min;
+        second = timeinfo.tm_sec;
+        return true;
     }
     
     // Convertir de BCD a decimal
-    second = bcdToDec(timeRegs[0] & 0x7F);  // Segundos: mask 0x7F para limpiar flag de reloj
-    minute = bcdToDec(timeRegs[1] & 0x7F);  // Minutos
-    hour = bcdToDec(timeRegs[2] & 0x3F);    // Hora: mask 0x3F para manejar formato 24h/12h
-    day = bcdToDec(timeRegs[4] & 0x3F);     // Día del mes
-    month = bcdToDec(timeRegs[5] & 0x1F);   // Mes: mask 0x1F por si hay flags en los bits superiores
-    year = 2000 + bcdToDec(timeRegs[6]);    // Año: se suma 2000 al BCD almacenado (offset)
+    second = bcdToDec(snapshot[0] & 0x7F);  // Segundos: mask 0x7F para limpiar flag de reloj
+    minute = bcdToDec(snapshot[1] & 0x7F);  // Minutos
+    hour = bcdToDec(snapshot[2] & 0x3F);    // Hora: mask 0x3F para manejar formato 24h/12h
+    day = bcdToDec(snapshot[4] & 0x3F);     // Día del mes
+    month = bcdToDec(snapshot[5] & 0x1F);   // Mes: mask 0x1F por si hay flags en los bits superiores
+    year = 2000 + bcdToDec(snapshot[6]);    // Año: se suma 2000 al BCD almacenado (offset)
     
     return true;
 }
 
-<<<<<<< HEAD
 /**
  * @brief Obtiene el timestamp Unix (UTC) desde RTC.
+ * @details Se calcula desde la instantánea más el tiempo transcurrido según millis().
  * @return timestamp Unix (segundos) o 0 en caso de error.
  */
 
 uint32_t MAX31328RTC::getUnixTimestamp() {
-=======
-uint32_t MAX31328RTC::getUnixTimestamp() { // Devuelve timestamp Unix (segundos desde 1970)
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
-    uint16_t year;
-    uint8_t month, day, hour, minute, second; // Variables locales para recibir fecha/hora del RTC
-    
-    if (!getDateTime(year, month, day, hour, minute, second)) { // Llama a getDateTime; si falla...
+    if (!ensureSnapshot()) {
         return 0; // Retorna 0 para indicar error
     }
-    
-    // Convertir a timestamp Unix
-    struct tm timeinfo = {0};       // Estructura tm inicializada a cero
-    timeinfo.tm_year = year - 1900; // tm_year espera años desde 1900
-    timeinfo.tm_mon = month - 1;    // tm_mon es 0-11
-    timeinfo.tm_mday = day;         // Día del mes 1-31
-    timeinfo.tm_hour = hour;        // Hora 0-23
-    timeinfo.tm_min = minute;       // Minutos 0-59
-    timeinfo.tm_sec = second;       // Segundos 0-59
-    timeinfo.tm_isdst = -1;         // Desconoce info de DST (dejar que mktime lo determine)
+    return snapshot_epoch + ((uint32_t)millis() - snapshot_millis) / 1000;
+}
+
+/**
+ * @brief Lee en una sola transacción los registros 0x00..0x12 hacia la instantánea.
+ * @return true si la lectura fue exitosa.
+ */
+
+bool MAX31328RTC::readSnapshot() {
+    snapshot_valid = false;
+
+    if (!readMultipleRegisters(MAX31328_REG_SECONDS, snapshot, MAX31328_SNAPSHOT_LEN)) {
+        LOG_E(TAG, "MAX31328: Error leyendo registros");
+        return false;
+    }
+
+    if (snapshot[MAX31328_REG_STATUS] == 0xFF) { // 0xFF indica una lectura inválida (bus flotante)
+        LOG_W(TAG, "MAX31328: Registro de estado inválido (0xFF)");
+        return false;
+    }
+
+    snapshot_millis = (uint32_t)millis();
+    snapshot_epoch = toEpoch(2000 + bcdToDec(snapshot[6]),    // Año con offset 2000
+                             bcdToDec(snapshot[5] & 0x1F),     // Mes
+                             bcdToDec(snapshot[4] & 0x3F),     // Día del mes
+                             bcdToDec(snapshot[2] & 0x3F),     // Hora 0-23
+                             bcdToDec(snapshot[1] & 0x7F),     // Minutos
+                             bcdToDec(snapshot[0] & 0x7F));    // Segundos
+    snapshot_valid = true;
+    return true;
+}
+
+/**
+ * @brief Garantiza que haya una instantánea válida, leyéndola si hace falta.
+ * @return true si hay instantánea disponible.
+ */
+
+bool MAX31328RTC::ensureSnapshot() {
+    return snapshot_valid || readSnapshot();
+}
+
+/**
+ * @brief Convierte fecha/hora de pared a segundos desde 1970 (algoritmo days-from-civil).
+ * @details No usa mktime(): su resultado depende de TZ, que RTCDriftEstimator::syncWithNTP() modifica
+ *          solo en algunos ciclos.
+ * @return Timestamp en segundos.
+ */
+
+uint32_t MAX31328RTC::toEpoch(uint16_t year, uint8_t month, uint8_t day,
+                              uint8_t hour, uint8_t minute, uint8_t second) {
+    int32_t y = (int32_t)year - (month <= 2 ? 1 : 0);       // Año que empieza en marzo
+    int32_t era = y / 400;                                   // Ciclos de 400 años (y ≥ 0)
+    uint32_t yoe = (uint32_t)(y - era * 400);                // Año dentro del ciclo [0, 399]
+    uint32_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1; // Día del año desde 1-mar
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;    // Día dentro del ciclo
+    int32_t days = era * 146097 + (int32_t)doe - 719468;     // Días desde 1970-01-01
 
-    time_t timestamp = mktime(&timeinfo); // Convierte tm a time_t (segundos desde 1970)
-    return (uint32_t)timestamp;           // Retorna resultado como uint32_t
+    return (uint32_t)days * 86400UL + hour * 3600UL + minute * 60UL + second;
 }
 
-<<<<<<< HEAD
 /**
  * @brief Configura la fecha/hora del RTC usando un timestamp Unix.
  * @param timestamp Timestamp Unix (segundos).
@@ -371,12 +428,8 @@ uint32_t MAX31328RTC::getUnixTimestamp() { // Devuelve timestamp Unix (segundos
 
 bool MAX31328RTC::setUnixTimestamp(uint32_t timestamp) {
     time_t rawtime = timestamp;
-    struct tm* timeinfo = localtime(&rawtime);
-=======
-bool MAX31328RTC::setUnixTimestamp(uint32_t timestamp) { // Establece fecha/hora a partir de timestamp Unix
-    time_t rawtime = timestamp; // Convierte a tipo time_t
-    struct tm* timeinfo = localtime(&rawtime); // Obtiene estructura tm local desde timestamp
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
+    struct tm tmbuf;
+    struct tm* timeinfo = gmtime_r(&rawtime, &tmbuf); // Inverso de toEpoch()
     
     return setDateTime( // Llama a setDateTime con los campos extraídos de timeinfo
         timeinfo->tm_year + 1900, 
@@ -388,25 +441,19 @@ bool MAX31328RTC::setUnixTimestamp(uint32_t timestamp) { // Establece fecha/hora
     );
 }
 
-<<<<<<< HEAD
 /**
  * @brief Lee la temperatura interna del RTC (si el chip la provee).
  * @return Temperatura en °C o -999.0f en caso de error.
  */
 
 float MAX31328RTC::getTemperature() {
-    if (!initialized && !isPresent()) {
+    if (!ensureSnapshot()) {
         return -999.0f;
-=======
-float MAX31328RTC::getTemperature() { // Lee temperatura interna del RTC y la convierte a grados C
-    if (!initialized && !isPresent()) { // Si no está listo o no responde...
-        return -999.0f; // Retorna valor sentinela que indica error de lectura
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     }
     
-    // Leer registros de temperatura
-    uint8_t tempMSB = readRegister(MAX31328_REG_TEMP_MSB); // Lee el byte MSB de temperatura
-    uint8_t tempLSB = readRegister(MAX31328_REG_TEMP_LSB); // Lee el byte LSB de temperatura
+    // Registros de temperatura (el chip los actualiza cada 64 s; la instantánea basta)
+    uint8_t tempMSB = snapshot[MAX31328_REG_TEMP_MSB]; // Byte MSB de temperatura
+    uint8_t tempLSB = snapshot[MAX31328_REG_TEMP_LSB]; // Byte LSB de temperatura
     
     // Convertir a temperatura 
     int16_t tempRaw = (tempMSB << 8) | tempLSB; // Combina MSB y LSB en un entero de 16 bits
@@ -417,136 +464,234 @@ float MAX31328RTC::getTemperature() { // Lee temperatura interna del RTC y la co
     return temperature; // Retorna temperatura en °C
 }
 
-<<<<<<< HEAD
 /**
- * @brief Devuelve la fecha/hora formateada como string "YYYY-MM-DD HH:MM:SS".
- * @return String con fecha y hora o mensaje de error si falla lectura.
+ * @brief Escribe la fecha/hora formateada "YYYY-MM-DD HH:MM:SS" en el buffer del llamador.
+ * @param buffer Destino (al menos RTC_DATETIME_LEN bytes).
+ * @param size Tamaño del buffer.
+ * @return true si se leyó el RTC; false deja un mensaje de error en el buffer.
  */
 
-String MAX31328RTC::getFormattedDateTime() {
-=======
-String MAX31328RTC::getFormattedDateTime() { // Devuelve una cadena formateada "YYYY-MM-DD HH:MM:SS"
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
+bool MAX31328RTC::getFormattedDateTime(char* buffer, size_t size) {
+    if (buffer == nullptr || size == 0) return false;
+
     uint16_t year;
     uint8_t month, day, hour, minute, second; // Variables locales para recibir la fecha
     
     if (!getDateTime(year, month, day, hour, minute, second)) { // Si falla la lectura...
-        return "Error leyendo RTC"; // Retorna mensaje de error
+        snprintf(buffer, size, "Error leyendo RTC"); // Deja mensaje de error
+        return false;
     }
     
-<<<<<<< HEAD
-    char buffer[20];
-    snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d",
+    snprintf(buffer, size, "%04d-%02d-%02d %02d:%02d:%02d",
             year, month, day, hour, minute, second);
-=======
-    char buffer[20]; // Buffer para formato de fecha/hora (suficiente para "YYYY-MM-DD HH:MM:SS")
-    snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d", 
-             year, month, day, hour, minute, second); // Formatea la fecha en el buffer
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     
-    return String(buffer); // Convierte el buffer C a String de Arduino y lo retorna
+    return true;
 }
 
-<<<<<<< HEAD
 /**
- * @brief Sincroniza el RTC con un servidor NTP usando la conexión WiFi del ESP.
- * @param ntpServer Host del servidor NTP (ej. "pool.ntp.org").
- * @param gmtOffset Offset horario en horas (ej. -5 para UTC-5).
- * @return true si la sincronización y actualización del RTC fue exitosa.
+ * @brief Lee el registro de aging offset.
+ * @param value Destino del valor con signo.
+ * @return true si la lectura fue exitosa.
  */
 
-bool MAX31328RTC::syncWithNTP(const char* ntpServer, int gmtOffset) {
-    Serial.println("MAX31328: Sincronizando con NTP...");
-=======
-bool MAX31328RTC::syncWithNTP(const char* ntpServer, int gmtOffset) { // Sincroniza el RTC usando NTP
-    Serial.println("MAX31328: Sincronizando con NTP..."); // Mensaje indicativo
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
-    
-    configTime(gmtOffset * 3600, 0, ntpServer); // Configura la librería de tiempo del sistema para NTP (offset en segundos)
-    
-    struct tm timeinfo; // Estructura para recibir la hora local del sistema
-    if (!getLocalTime(&timeinfo, 10000)) {  // 10 segundos timeout -  10 segundos timeout para obtener tiempo NTP
-        Serial.println("MAX31328: Error obteniendo tiempo NTP"); // Error si no llega respuesta NTP
-        return false; // Retorna fallo si no hay respuesta
+bool MAX31328RTC::getAgingOffset(int8_t& value) {
+    if (!ensureSnapshot()) {
+        return false;
     }
-    
-    // Actualizar RTC con tiempo NTP
-    bool result = setDateTime( // Actualiza RTC con la hora NTP obtenida
-        timeinfo.tm_year + 1900,
-        timeinfo.tm_mon + 1,
-        timeinfo.tm_mday,
-        timeinfo.tm_hour,
-        timeinfo.tm_min,
-        timeinfo.tm_sec
-    );
-    
-    if (result) { // Si la actualización fue exitosa...
-        Serial.println("MAX31328: Sincronizado con NTP exitosamente"); // Mensaje
+    value = (int8_t)snapshot[MAX31328_REG_AGING];
+    return true;
+}
+
+/**
+ * @brief Escribe el aging offset y fuerza una conversión TCXO para aplicarlo.
+ * @details Sin la conversión forzada el valor se aplicaría en la siguiente
+ *          compensación automática (cada 64 s). Si hay una conversión en curso
+ *          (BSY) el nuevo valor se toma en esa.
+ * @param value Valor con signo.
+ * @return true si se escribió correctamente.
+ */
+
+bool MAX31328RTC::setAgingOffset(int8_t value) {
+    if (!writeRegister(MAX31328_REG_AGING, (uint8_t)value)) {
+        return false;
     }
-    
-    return result; // Retorna true/false según resultado
+
+    uint8_t status = readRegister(MAX31328_REG_STATUS);
+    if (status != 0xFF && !(status & MAX31328_STAT_BSY)) {
+        uint8_t control = readRegister(MAX31328_REG_CONTROL);
+        if (control != 0xFF) {
+            writeRegister(MAX31328_REG_CONTROL, control | MAX31328_CTRL_CONV);
+        }
+    }
+
+    LOG_I(TAG, "MAX31328: Aging offset = %d", value);
+    return true;
+}
+
+/**
+ * @brief Sondea el registro de segundos hasta que cambia.
+ * @details Cada lectura a 400 kHz tarda ~0.1 ms, por lo que el flanco se
+ *          detecta con esa resolución. Deja recargada la instantánea.
+ * @param timeoutMs Espera máxima en ms.
+ * @return true si se detectó el flanco.
+ */
+
+bool MAX31328RTC::waitForSecondEdge(uint32_t timeoutMs) {
+    uint8_t first = readRegister(MAX31328_REG_SECONDS);
+    if (first == 0xFF) {
+        return false;
+    }
+
+    uint32_t start = millis();
+    while ((uint32_t)(millis() - start) < timeoutMs) {
+        uint8_t seconds = readRegister(MAX31328_REG_SECONDS);
+        if (seconds != first && seconds != 0xFF) {
+            return refresh();
+        }
+    }
+
+    LOG_W(TAG, "MAX31328: Sin flanco de segundo en %u ms", timeoutMs);
+    return false;
+}
+
+/**
+ * @brief Programa la alarma 1 o 2 en modo "coincidencia de fecha" y habilita INT.
+ * @param alarm 1 o 2.
+ * @param wallEpoch Instante en la escala de getUnixTimestamp().
+ * @return true si se programó correctamente.
+ */
+
+bool MAX31328RTC::setAlarm(uint8_t alarm, uint32_t wallEpoch) {
+    if (alarm != 1 && alarm != 2) {
+        return false;
+    }
+
+    time_t t = (time_t)wallEpoch;
+    struct tm timeinfo;
+    gmtime_r(&t, &timeinfo); // Inverso de toEpoch()
+
+    // A1M/A2M = 0 y DY/DT = 0: comparar día del mes, hora, minuto (y segundo)
+    uint8_t regs[4];
+    uint8_t length = 0;
+    if (alarm == 1) {
+        regs[length++] = decToBcd(timeinfo.tm_sec);
+    }
+    regs[length++] = decToBcd(timeinfo.tm_min);
+    regs[length++] = decToBcd(timeinfo.tm_hour);
+    regs[length++] = decToBcd(timeinfo.tm_mday);
+
+    uint8_t startReg = (alarm == 1) ? MAX31328_REG_ALARM1 : MAX31328_REG_ALARM2;
+    if (!writeMultipleRegisters(startReg, regs, length)) {
+        LOG_E(TAG, "MAX31328: Error escribiendo alarma %u", alarm);
+        return false;
+    }
+
+    uint8_t flag = (alarm == 1) ? MAX31328_STAT_A1F : MAX31328_STAT_A2F;
+    uint8_t enable = (alarm == 1) ? MAX31328_CTRL_A1IE : MAX31328_CTRL_A2IE;
+
+    uint8_t status = readRegister(MAX31328_REG_STATUS);
+    uint8_t control = readRegister(MAX31328_REG_CONTROL);
+    if (status == 0xFF || control == 0xFF) {
+        return false;
+    }
+
+    // Limpiar la bandera antes de habilitar: con la bandera activa INT seguiría en bajo
+    if (!writeRegister(MAX31328_REG_STATUS, status & ~flag)) {
+        return false;
+    }
+    control = (control | MAX31328_CTRL_INTCN | enable) & ~MAX31328_CTRL_EOSC;
+    if (!writeRegister(MAX31328_REG_CONTROL, control)) {
+        return false;
+    }
+
+    LOG_D(TAG, "MAX31328: Alarma %u programada %02d %02d:%02d:%02d", alarm,
+          timeinfo.tm_mday, timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+    return true;
+}
+
+/**
+ * @brief Deshabilita ambas alarmas y limpia sus banderas.
+ * @return true si se escribió correctamente.
+ */
+
+bool MAX31328RTC::disableAlarms() {
+    uint8_t control = readRegister(MAX31328_REG_CONTROL);
+    uint8_t status = readRegister(MAX31328_REG_STATUS);
+    if (control == 0xFF || status == 0xFF) {
+        return false;
+    }
+
+    control &= ~(MAX31328_CTRL_A1IE | MAX31328_CTRL_A2IE);
+    status &= ~(MAX31328_STAT_A1F | MAX31328_STAT_A2F);
+    return writeRegister(MAX31328_REG_CONTROL, control) &&
+           writeRegister(MAX31328_REG_STATUS, status);
+}
+
+/**
+ * @brief Lee las banderas de alarma desde la instantánea.
+ * @param flags Destino de la máscara A1F/A2F.
+ * @return true si la lectura fue exitosa.
+ */
+
+bool MAX31328RTC::getAlarmFlags(uint8_t& flags) {
+    if (!ensureSnapshot()) {
+        return false;
+    }
+    flags = snapshot[MAX31328_REG_STATUS] & (MAX31328_STAT_A1F | MAX31328_STAT_A2F);
+    return true;
 }
 
-<<<<<<< HEAD
 /**
  * @brief Imprime información de depuración en Serial (estado, valores y registros).
  */
 
 void MAX31328RTC::printDebugInfo() {
-    Serial.println("=== MAX31328 DEBUG INFO ===");
-    Serial.printf("Inicializado: %s\n", initialized ? "Sí" : "No");
-    Serial.printf("Dirección I2C: 0x%02X\n", i2c_address);
-    Serial.printf("Presente: %s\n", isPresent() ? "Sí" : "No");
-    Serial.printf("Funcionando: %s\n", isRunning() ? "Sí" : "No");
-    Serial.printf("Tiempo perdido: %s\n", hasLostTime() ? "Sí" : "No");
-=======
-void MAX31328RTC::printDebugInfo() { // Imprime información de diagnóstico del RTC
-    Serial.println("=== MAX31328 DEBUG INFO ==="); 
-    Serial.printf("Inicializado: %s\n", initialized ? "Sí" : "No"); // Imprime si objeto fue inicializado
-    Serial.printf("Dirección I2C: 0x%02X\n", i2c_address); // Imprime dirección I2C
-    Serial.printf("Presente: %s\n", isPresent() ? "Sí" : "No"); // Indica si el dispositivo responde
-    Serial.printf("Funcionando: %s\n", isRunning() ? "Sí" : "No"); // Indica si oscilador corre
-    Serial.printf("Tiempo perdido: %s\n", hasLostTime() ? "Sí" : "No"); // Indica bandera OSF
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
+    LOG_I(TAG, "=== MAX31328 DEBUG INFO ===");
+    LOG_I(TAG, "Inicializado: %s", initialized ? "Sí" : "No");
+    LOG_I(TAG, "Dirección I2C: 0x%02X", i2c_address);
+    LOG_I(TAG, "Presente: %s", isPresent() ? "Sí" : "No");
+    LOG_I(TAG, "Funcionando: %s", isRunning() ? "Sí" : "No");
+    LOG_I(TAG, "Tiempo perdido: %s", hasLostTime() ? "Sí" : "No");
     
     if (isPresent()) { // Si el dispositivo responde...
-        Serial.printf("Fecha/Hora: %s\n", getFormattedDateTime().c_str()); // Imprime fecha formateada
-        Serial.printf("Unix timestamp: %u\n", getUnixTimestamp()); // Imprime timestamp
-        Serial.printf("Temperatura: %.2f°C\n", getTemperature()); // Imprime temperatura interna
+        char datetime[RTC_DATETIME_LEN];
+        getFormattedDateTime(datetime, sizeof(datetime));
+        LOG_I(TAG, "Fecha/Hora: %s", datetime); // Imprime fecha formateada
+        LOG_I(TAG, "Unix timestamp: %u", getUnixTimestamp()); // Imprime timestamp
+        LOG_I(TAG, "Temperatura: %.2f°C", getTemperature()); // Imprime temperatura interna
         
         printRegisters(); // Imprime registros para depuración
     }
     
-    Serial.println("==========================");
+    LOG_I(TAG, "==========================");
 }
 
-<<<<<<< HEAD
 /**
  * @brief Imprime registros principales del RTC (tiempo, control y status).
  */
 
 void MAX31328RTC::printRegisters() {
-=======
-void MAX31328RTC::printRegisters() { // Lee e imprime registros principales del RTC
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
-    Serial.println("Registros principales:");
+    LOG_I(TAG, "Registros principales:");
     
+    if (!ensureSnapshot()) {
+        return;
+    }
+
     // Registros de tiempo
     for (uint8_t i = 0; i <= 6; i++) { // Itera primeros 7 registros (segundos..año)
-        uint8_t value = readRegister(i); // Lee registro i
-        Serial.printf("  0x%02X: 0x%02X (%d BCD)\n", i, value, bcdToDec(value & 0x7F)); // Imprime valor y su conversión BCD
+        uint8_t value = snapshot[i]; // Registro i de la instantánea
+        LOG_I(TAG, "  0x%02X: 0x%02X (%d BCD)", i, value, bcdToDec(value & 0x7F)); // Imprime valor y su conversión BCD
     }
     
     // Registros de control
-    uint8_t control = readRegister(MAX31328_REG_CONTROL);   // Lee registro de control
-    uint8_t status = readRegister(MAX31328_REG_STATUS);     // Lee registro de status
-    Serial.printf("  Control (0x0E): 0x%02X\n", control);   // Imprime control
-    Serial.printf("  Status (0x0F): 0x%02X\n", status);     // Imprime status
+    uint8_t control = snapshot[MAX31328_REG_CONTROL];   // Registro de control
+    uint8_t status = snapshot[MAX31328_REG_STATUS];     // Registro de status
+    LOG_I(TAG, "  Control (0x0E): 0x%02X", control);   // Imprime control
+    LOG_I(TAG, "  Status (0x0F): 0x%02X", status);     // Imprime status
 }
 
 // ——— FUNCIONES AUXILIARES ———
 
-<<<<<<< HEAD
 /**
  * @brief Convierte un valor decimal (0..99) a BCD (binary coded decimal).
  * @param val Valor decimal.
@@ -579,31 +724,16 @@ bool MAX31328RTC::writeRegister(uint8_t reg, uint8_t value) {
     Wire.write(reg);
     Wire.write(value);
     uint8_t error = Wire.endTransmission();
-=======
-uint8_t MAX31328RTC::decToBcd(uint8_t val) { // Convierte decimal a BCD 
-    return ((val / 10) << 4) + (val % 10); // Decenas en nibble alto, unidades en nibble bajo
-}
-
-uint8_t MAX31328RTC::bcdToDec(uint8_t val) { // Convierte BCD a decimal
-    return ((val >> 4) * 10) + (val & 0x0F); // Combina nibble alto y bajo en valor decimal
-}
-
-bool MAX31328RTC::writeRegister(uint8_t reg, uint8_t value) { // Escribe un único registro por I2C
-    Wire.beginTransmission(i2c_address); // Inicia transmisión I2C
-    Wire.write(reg); // Apunta al registro destino
-    Wire.write(value); // Envía el valor
-    uint8_t error = Wire.endTransmission(); // Finaliza transmisión y captura código de error
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
+    invalidateCache(); // Cualquier escritura deja obsoleta la instantánea
     
     if (error != 0) { // Si hubo error...
-        Serial.printf("MAX31328: Error escribiendo reg 0x%02X: %d\n", reg, error); // Imprime detalle
+        LOG_E(TAG, "MAX31328: Error escribiendo reg 0x%02X: %d", reg, error); // Imprime detalle
         return false; // Retorna false en fallo
     }
     
     return true; // Retorna true si escribe sin errores
 }
 
-<<<<<<< HEAD
 /**
  * @brief Lee un único registro del RTC vía I2C.
  * @param reg Dirección del registro.
@@ -614,28 +744,23 @@ uint8_t MAX31328RTC::readRegister(uint8_t reg) {
     Wire.beginTransmission(i2c_address);
     Wire.write(reg);
     uint8_t error = Wire.endTransmission();
-=======
-uint8_t MAX31328RTC::readRegister(uint8_t reg) { // Lee un único registro por I2C
-    Wire.beginTransmission(i2c_address); // Inicia transmisión para seleccionar registro
-    Wire.write(reg); // Indica registro a leer
-    uint8_t error = Wire.endTransmission(); // Finaliza selección y obtiene error
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     
     if (error != 0) { // Si hay error...
-        Serial.printf("MAX31328: Error en transmisión reg 0x%02X: %d\n", reg, error); // Mensaje de error
+        LOG_E(TAG, "MAX31328: Error en transmisión reg 0x%02X: %d", reg, error); // Mensaje de error
         return 0xFF; // Retorna 0xFF como indicador de fallo
     }
     
     Wire.requestFrom(i2c_address, (uint8_t)1); // Solicita 1 byte
     if (Wire.available()) { // Si hay datos disponibles...
-        return Wire.read(); // Retorna el byte leído
+        uint8_t value = Wire.read();
+        HAL::Trace::recordI2C(i2c_address, &value, 1); // Anota el byte en la traza (vacío sin HAL_TRACE)
+        return value; // Retorna el byte leído
     }
     
-    Serial.printf("MAX31328: Sin datos disponibles reg 0x%02X\n", reg); // Mensaje si no hay datos
+    LOG_W(TAG, "MAX31328: Sin datos disponibles reg 0x%02X", reg); // Mensaje si no hay datos
     return 0xFF; // Retorna 0xFF indicando fallo
 }
 
-<<<<<<< HEAD
 /**
  * @brief Escribe múltiples registros consecutivos comenzando en startReg.
  * @param startReg Registro inicial.
@@ -647,33 +772,23 @@ uint8_t MAX31328RTC::readRegister(uint8_t reg) { // Lee un único registro por I
 bool MAX31328RTC::writeMultipleRegisters(uint8_t startReg, uint8_t* buffer, uint8_t length) {
     Wire.beginTransmission(i2c_address);
     Wire.write(startReg);
-=======
-bool MAX31328RTC::writeMultipleRegisters(uint8_t startReg, uint8_t* buffer, uint8_t length) { // Escribe múltiples registros
-    Wire.beginTransmission(i2c_address); // Inicia transmisión I2C
-    Wire.write(startReg); // Escribe registro inicial
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     
     for (uint8_t i = 0; i < length; i++) { // Escribe cada byte del buffer
         Wire.write(buffer[i]); // Envía byte
     }
     
     uint8_t error = Wire.endTransmission(); // Finaliza y obtiene código de error
+    invalidateCache(); // Cualquier escritura deja obsoleta la instantánea
     
     if (error != 0) { // En caso de error...
-        Serial.printf("MAX31328: Error escribiendo múltiples registros desde 0x%02X: %d\n", 
-<<<<<<< HEAD
+        LOG_E(TAG, "MAX31328: Error escribiendo múltiples registros desde 0x%02X: %d", 
                     startReg, error);
         return false;
-=======
-                      startReg, error); // Imprime detalle
-        return false; // Retorna false
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     }
     
     return true; // Retorna true si OK
 }
 
-<<<<<<< HEAD
 /**
  * @brief Lee múltiples registros consecutivos comenzando en startReg.
  * @param startReg Registro inicial.
@@ -686,22 +801,12 @@ bool MAX31328RTC::readMultipleRegisters(uint8_t startReg, uint8_t* buffer, uint8
     Wire.beginTransmission(i2c_address);
     Wire.write(startReg);
     uint8_t error = Wire.endTransmission();
-=======
-bool MAX31328RTC::readMultipleRegisters(uint8_t startReg, uint8_t* buffer, uint8_t length) { // Lee múltiples registros
-    Wire.beginTransmission(i2c_address); // Inicia transmisión para indicar registro inicial
-    Wire.write(startReg); // Escribe registro inicial
-    uint8_t error = Wire.endTransmission(); // Finaliza selección y captura error
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     
     if (error != 0) { // Si hubo error, entonces...
-        Serial.printf("MAX31328: Error en transmisión múltiple reg 0x%02X: %d\n", 
-<<<<<<< HEAD
+        LOG_E(TAG, "MAX31328: Error en transmisión múltiple reg 0x%02X: %d", 
                     startReg, error);
+        logI2CError(error);
         return false;
-=======
-                      startReg, error); // Mensaje de error
-        return false; // Retorna false
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     }
     
     Wire.requestFrom(i2c_address, length); // Solicita 'length' bytes
@@ -710,10 +815,11 @@ bool MAX31328RTC::readMultipleRegisters(uint8_t startReg, uint8_t* buffer, uint8
         if (Wire.available()) { // Si hay datos...
             buffer[i] = Wire.read(); // Almacena en buffer
         } else { // Si no hay suficientes datos...
-            Serial.printf("MAX31328: Datos insuficientes en lectura múltiple\n"); // Mensaje
+            LOG_W(TAG, "MAX31328: Datos insuficientes en lectura múltiple"); // Mensaje
             return false; // Retorna false
         }
     }
+    HAL::Trace::recordI2C(i2c_address, buffer, length); // Anota la lectura en la traza (vacío sin HAL_TRACE)
     
     return true; // Retorna true si todo fue leído correctamente
 }
\ No newline at end of file
@@ -20,7 +20,10 @@
 
 // ——— Configuración del MAX31328 ———
 #define MAX31328_I2C_ADDRESS    0x68    // Dirección I2C estándar
-#define MAX31328_I2C_SPEED      100000  // 100kHz para mayor compatibilidad
+#define MAX31328_I2C_SPEED      400000  // Fast-mode (el MAX31328 soporta hasta 400kHz)
+#define RTC_DATETIME_LEN        20      // "YYYY-MM-DD HH:MM:SS" + terminador
+#define MAX31328_SNAPSHOT_LEN   0x13    // Registros 0x00..0x12 (tiempo, control, status, temperatura)
+#define MAX31328_OSC_TIMEOUT_MS 1500    // Espera máxima a que avance el segundero tras arrancar el oscilador
 
 // ——— Registros del MAX31328 ———
 #define MAX31328_REG_SECONDS    0x00
@@ -30,14 +33,25 @@
 #define MAX31328_REG_DAY        0x04
 #define MAX31328_REG_MONTH      0x05
 #define MAX31328_REG_YEAR       0x06
+#define MAX31328_REG_ALARM1     0x07    // Alarma 1: segundos, minutos, hora, día (0x07..0x0A)
+#define MAX31328_REG_ALARM2     0x0B    // Alarma 2: minutos, hora, día (0x0B..0x0D)
 #define MAX31328_REG_CONTROL    0x0E
 #define MAX31328_REG_STATUS     0x0F
+#define MAX31328_REG_AGING      0x10    // Aging offset (complemento a 2, ~0.1 ppm/LSB a 25 °C)
 #define MAX31328_REG_TEMP_MSB   0x11
 #define MAX31328_REG_TEMP_LSB   0x12
 
 // ——— Bits de control importantes ———
 #define MAX31328_CTRL_EOSC      0x80    // Enable Oscillator 
+#define MAX31328_CTRL_CONV      0x20    // Forzar conversión de temperatura (aplica el aging offset)
+#define MAX31328_CTRL_INTCN     0x04    // INT/SQW como salida de interrupción de alarma
+#define MAX31328_CTRL_A2IE      0x02    // Habilita interrupción de alarma 2
+#define MAX31328_CTRL_A1IE      0x01    // Habilita interrupción de alarma 1
 #define MAX31328_STAT_OSF       0x80    // Oscillator Stop Flag
+#define MAX31328_STAT_BSY       0x04    // Conversión TCXO en curso
+#define MAX31328_STAT_A2F       0x02    // Alarma 2 disparada (mantiene INT en bajo)
+#define MAX31328_STAT_A1F       0x01    // Alarma 1 disparada (mantiene INT en bajo)
+#define MAX31328_ALARM_MASK     0x80    // Bit AxMy: el campo no participa en la comparación
 
 /**
  * @brief Clase simplificada para MAX31328 RTC compatible con ESP32
@@ -49,6 +63,16 @@ class MAX31328RTC {
 private:
     uint8_t i2c_address;
     bool initialized;
+
+    // Instantánea de registros leída en una sola transacción y válida durante el ciclo
+    uint8_t snapshot[MAX31328_SNAPSHOT_LEN];
+    bool snapshot_valid;
+    uint32_t snapshot_millis;   ///< millis() al momento de la lectura
+    uint32_t snapshot_epoch;    ///< Timestamp Unix correspondiente a la instantánea
+    
+    // Lectura en ráfaga de todos los registros hacia la instantánea
+    bool readSnapshot();
+    bool ensureSnapshot();
     
     // Funciones auxiliares para conversión BCD
     uint8_t decToBcd(uint8_t val);
@@ -68,6 +92,9 @@ public:
     
     /**
      * @brief Inicializar el RTC con pines I2C específicos
+     * @details Si en un ciclo anterior el RTC quedó configurado (marca en memoria RTC),
+     *          se omite el reinicio del bus y la verificación detallada: basta una
+     *          lectura en ráfaga que además deja cargada la instantánea del ciclo.
      * @param sda_pin Pin SDA para I2C
      * @param scl_pin Pin SCL para I2C
      * @param address Dirección I2C (default: 0x68)
@@ -77,9 +104,21 @@ public:
     
     /**
      * @brief Verificar si el RTC está presente y funcionando
+     * @details Con la instantánea del ciclo ya cargada no genera tráfico I2C.
      * @return true si el RTC responde correctamente
      */
     bool isPresent();
+
+    /**
+     * @brief Volver a leer todos los registros en una sola transacción
+     * @return true si la lectura fue exitosa
+     */
+    bool refresh();
+
+    /**
+     * @brief Descartar la instantánea (la siguiente consulta vuelve a leer el RTC)
+     */
+    void invalidateCache();
     
     /**
      * @brief Verificar si el RTC está funcionando (oscilador activo)
@@ -115,10 +154,20 @@ public:
     
     /**
      * @brief Obtener timestamp Unix
+     * @details Se extrapola desde la instantánea con millis(), sin nueva lectura I2C.
      * @return Timestamp Unix (segundos desde 1970) o 0 si hay error
      */
     uint32_t getUnixTimestamp();
     
+    /**
+     * @brief Convertir fecha/hora de pared a timestamp (sin depender de la zona horaria)
+     * @details El RTC guarda hora local; el timestamp resultante es esa hora tratada
+     *          como UTC, igual en todos los ciclos aunque configTime() cambie TZ.
+     * @return Segundos desde 1970-01-01 00:00:00
+     */
+    static uint32_t toEpoch(uint16_t year, uint8_t month, uint8_t day,
+                            uint8_t hour, uint8_t minute, uint8_t second);
+
     /**
      * @brief Configurar fecha/hora desde timestamp Unix
      * @param timestamp Timestamp Unix
@@ -133,10 +182,12 @@ public:
     float getTemperature();
     
     /**
-     * @brief Obtener fecha/hora como string formateado
-     * @return String con formato "YYYY-MM-DD HH:MM:SS"
+     * @brief Escribir fecha/hora formateada en un buffer del llamador
+     * @param buffer Destino (al menos RTC_DATETIME_LEN bytes)
+     * @param size Tamaño del buffer
+     * @return true si se leyó el RTC; false deja "Error leyendo RTC" en el buffer
      */
-    String getFormattedDateTime();
+    bool getFormattedDateTime(char* buffer, size_t size);
     
     /**
      * @brief Iniciar el oscilador si está detenido
@@ -157,13 +208,52 @@ public:
     bool clearLostTimeFlag();
     
     /**
-     * @brief Sincronizar con NTP (requiere WiFi activo)
-     * @param ntpServer Servidor NTP
-     * @param gmtOffset Offset GMT en horas
-     * @return true si se sincronizó correctamente
+     * @brief Leer el registro de aging offset
+     * @param value Valor con signo (positivo reduce la frecuencia)
+     * @return true si la lectura fue exitosa
      */
-    bool syncWithNTP(const char* ntpServer = "pool.ntp.org", int gmtOffset = -5);
-    
+    bool getAgingOffset(int8_t& value);
+
+    /**
+     * @brief Escribir el aging offset y forzar una conversión para aplicarlo
+     * @param value Valor con signo (~0.1 ppm por LSB; positivo reduce la frecuencia)
+     * @return true si se escribió correctamente
+     */
+    bool setAgingOffset(int8_t value);
+
+    /**
+     * @brief Esperar el cambio del registro de segundos (flanco de segundo)
+     * @details Permite fechar el RTC con resolución de ~1 ms contra una referencia.
+     * @param timeoutMs Espera máxima
+     * @return true si se detectó el flanco
+     */
+    bool waitForSecondEdge(uint32_t timeoutMs = 1100);
+
+    /**
+     * @brief Programar una alarma para un instante de pared y habilitar INT/SQW
+     * @details La alarma compara día del mes, hora, minuto y (alarma 1) segundo, por
+     *          lo que dispara una sola vez dentro del mes siguiente. La alarma 2 no
+     *          tiene segundos: dispara en el segundo 0 del minuto indicado. Al
+     *          reprogramar se limpia la bandera, lo que libera la línea INT.
+     * @param alarm 1 o 2
+     * @param wallEpoch Instante en la misma escala que getUnixTimestamp()
+     * @return true si se programó correctamente
+     */
+    bool setAlarm(uint8_t alarm, uint32_t wallEpoch);
+
+    /**
+     * @brief Deshabilitar ambas alarmas y limpiar sus banderas (INT queda en alto)
+     * @return true si se escribió correctamente
+     */
+    bool disableAlarms();
+
+    /**
+     * @brief Leer las banderas de alarma
+     * @param flags Máscara MAX31328_STAT_A1F | MAX31328_STAT_A2F
+     * @return true si la lectura fue exitosa
+     */
+    bool getAlarmFlags(uint8_t& flags);
+
     /**
      * @brief Mostrar información de debug por Serial
      */
@@ -0,0 +1,321 @@
+/**
+ * @file RTCDrift.cpp
+ * @brief Implementación del estimador de deriva y ajuste de aging del MAX31328.
+ *
+ * Medición: se espera el flanco del registro de segundos y en ese instante se lee
+ * el reloj del sistema (µs). El desfase RTC - referencia dividido entre el tiempo
+ * desde el último ajuste da la deriva en ppm. Tras medir, el RTC se reescribe
+ * exactamente en un cambio de segundo de la referencia: escribir los segundos
+ * reinicia la cadena de división del MAX31328, de modo que la fase queda alineada
+ * y la siguiente medición parte de un desfase ~0.
+ *
+ * @version 1.0
+ * @date 2025-10-01
+ * @author Daniel Acosta - Santiago Erazo
+ */
+
+#include "RTCDrift.h"
+#include "Logger.h"
+#include <Preferences.h>
+#include "HAL.h"
+#include <stdarg.h>
+#include <math.h>
+
+static const char TAG[] = "DRIFT"; ///< Etiqueta de log del módulo
+
+// ——— Registro en NVS ———
+static const char NVS_NAMESPACE[] = "rtcdrift"; ///< Espacio de nombres en NVS
+static const char NVS_KEY[] = "record";         ///< Clave del blob de deriva
+static const uint16_t STORE_MAGIC = 0xD81F;     ///< Identifica un registro de deriva
+static const uint16_t STORE_VERSION = 1;        ///< Incrementar al cambiar DriftRecord
+
+/**
+ * @brief Constructor de RTCDriftEstimator.
+ * @param enableSerial Habilita o deshabilita la salida por Serial.
+ */
+RTCDriftEstimator::RTCDriftEstimator(bool enableSerial)
+    : _loaded(false), _enableSerialOutput(enableSerial), _logCallback(nullptr) {
+    memset(&_record, 0, sizeof(_record));
+}
+
+/**
+ * @brief Carga la estimación y restaura el aging offset si el registro del RTC difiere.
+ * @details El aging offset vive en la zona respaldada por batería; si la batería
+ *          se agotó o se cambió, vuelve a 0 y se reescribe el valor aprendido.
+ * @param rtc RTC ya inicializado.
+ */
+void RTCDriftEstimator::begin(MAX31328RTC& rtc) {
+    load();
+
+    int8_t current;
+    if (_record.aging != 0 && rtc.getAgingOffset(current) && current != _record.aging) {
+        MLOG_W("Aging offset del RTC (%d) distinto al aprendido (%d) - restaurando",
+               current, _record.aging);
+        rtc.setAgingOffset(_record.aging);
+    }
+}
+
+/**
+ * @brief Indica si conviene una nueva referencia externa.
+ * @param now Hora actual (timestamp de pared).
+ * @return true si nunca se ajustó o ya pasó el intervalo de sincronización.
+ */
+bool RTCDriftEstimator::isSyncDue(uint32_t now) {
+    load();
+    if (_record.ref_epoch == 0 || now < _record.ref_epoch) {
+        return true;
+    }
+    return (now - _record.ref_epoch) >= getSyncIntervalS();
+}
+
+/**
+ * @brief Intervalo entre referencias según la deriva residual y su incertidumbre.
+ * @return Segundos acotados a [RTCDRIFT_MIN_SYNC_S, RTCDRIFT_MAX_SYNC_S].
+ */
+uint32_t RTCDriftEstimator::getSyncIntervalS() {
+    load();
+    float ppm = fabsf(_record.residual_ppm) + _record.uncertainty_ppm;
+    if (ppm <= 0.0f) {
+        return RTCDRIFT_MAX_SYNC_S;
+    }
+    // error_ms = ppm · 1e-6 · t_s · 1000  →  t_s = max_ms · 1000 / ppm
+    float seconds = RTCDRIFT_MAX_ERROR_MS * 1000.0f / ppm;
+    if (seconds < RTCDRIFT_MIN_SYNC_S) return RTCDRIFT_MIN_SYNC_S;
+    if (seconds > RTCDRIFT_MAX_SYNC_S) return RTCDRIFT_MAX_SYNC_S;
+    return (uint32_t)seconds;
+}
+
+/**
+ * @brief Descuenta la deriva residual acumulada desde el último ajuste.
+ * @param rtcEpoch Timestamp leído del RTC.
+ * @return Timestamp corregido.
+ */
+uint32_t RTCDriftEstimator::correct(uint32_t rtcEpoch) {
+    load();
+    if (_record.ref_epoch == 0 || rtcEpoch <= _record.ref_epoch) {
+        return rtcEpoch;
+    }
+    float driftS = _record.residual_ppm * 1e-6f * (float)(rtcEpoch - _record.ref_epoch);
+    return rtcEpoch - (int32_t)lroundf(driftS);
+}
+
+/**
+ * @brief Sincroniza el reloj del sistema por NTP y luego mide y ajusta el RTC.
+ * @param rtc RTC ya inicializado.
+ * @param ntpServer Host del servidor NTP.
+ * @param gmtOffset Offset horario en horas.
+ * @return true si el RTC quedó ajustado.
+ */
+bool RTCDriftEstimator::syncWithNTP(MAX31328RTC& rtc, const char* ntpServer, int gmtOffset) {
+    MLOG_I("Sincronizando con NTP...");
+
+    configTime(gmtOffset * 3600, 0, ntpServer);
+
+    struct tm timeinfo;
+    if (!getLocalTime(&timeinfo, 10000)) { // 10 segundos de timeout para la respuesta NTP
+        MLOG_E("Error obteniendo tiempo NTP");
+        return false;
+    }
+
+    return syncWithSystemTime(rtc, gmtOffset);
+}
+
+/**
+ * @brief Mide el desfase en el flanco de segundo y reescribe el RTC alineado.
+ * @param rtc RTC ya inicializado.
+ * @param gmtOffset Offset horario en horas.
+ * @return true si el RTC quedó ajustado.
+ */
+bool RTCDriftEstimator::syncWithSystemTime(MAX31328RTC& rtc, int gmtOffset) {
+    load();
+    int64_t zoneMs = (int64_t)gmtOffset * 3600000LL;
+    struct timeval tv;
+
+    // 1. Medir (solo si el RTC conserva la hora desde el último ajuste)
+    if (_record.ref_epoch != 0 && !rtc.hasLostTime() && rtc.waitForSecondEdge()) {
+        HAL::getTimeOfDay(&tv);
+        int64_t refMs = (int64_t)tv.tv_sec * 1000LL + tv.tv_usec / 1000 + zoneMs;
+        int64_t rtcMs = (int64_t)rtc.getUnixTimestamp() * 1000LL; // Recién cambiado: fase 0
+        int32_t offsetMs = (int32_t)(rtcMs - refMs);
+        uint32_t elapsedS = (uint32_t)(refMs / 1000) - _record.ref_epoch;
+
+        if (elapsedS >= RTCDRIFT_MIN_BASELINE_S) {
+            update(rtc, offsetMs, elapsedS);
+        } else {
+            MLOG_I("Desfase %ld ms tras %lu s - intervalo corto para estimar deriva",
+                   (long)offsetMs, (unsigned long)elapsedS);
+        }
+    }
+
+    // 2. Ajustar el RTC justo en el cambio de segundo de la referencia
+    HAL::getTimeOfDay(&tv);
+    time_t target = tv.tv_sec + 1;
+    do {
+        HAL::getTimeOfDay(&tv);
+        if (tv.tv_sec < target && tv.tv_usec < 998000) delay(1); // Cede la CPU salvo en los últimos 2 ms
+    } while (tv.tv_sec < target);
+
+    uint32_t wallEpoch = (uint32_t)((int64_t)target + zoneMs / 1000);
+    if (!rtc.setUnixTimestamp(wallEpoch)) {
+        MLOG_E("No se pudo ajustar el RTC");
+        return false;
+    }
+
+    _record.ref_epoch = wallEpoch;
+    save();
+    MLOG_I("RTC ajustado (aging %d, deriva residual %.2f ppm, próxima referencia en %lu h)",
+           _record.aging, _record.residual_ppm, (unsigned long)(getSyncIntervalS() / 3600));
+    return true;
+}
+
+/**
+ * @brief Deriva residual estimada en ppm.
+ */
+float RTCDriftEstimator::getResidualPpm() {
+    load();
+    return _record.residual_ppm;
+}
+
+/**
+ * @brief Aging offset aplicado.
+ */
+int8_t RTCDriftEstimator::getAgingOffset() {
+    load();
+    return _record.aging;
+}
+
+/**
+ * @brief Escribe el estado del estimador en el buffer del llamador.
+ * @param buffer Destino del texto.
+ * @param size Tamaño del buffer.
+ * @return Longitud del texto completo (semántica de snprintf).
+ */
+size_t RTCDriftEstimator::getStatus(char* buffer, size_t size) {
+    load();
+    int n = snprintf(buffer, size,
+                     "Aging offset: %d (%u ajustes)\n"
+                     "Deriva residual: %.2f ± %.2f ppm (%u mediciones)\n"
+                     "Último ajuste: %lu\n"
+                     "Intervalo de referencia: %lu h",
+                     _record.aging, _record.trims,
+                     _record.residual_ppm, _record.uncertainty_ppm, _record.measurements,
+                     (unsigned long)_record.ref_epoch,
+                     (unsigned long)(getSyncIntervalS() / 3600));
+    return (n > 0) ? (size_t)n : 0;
+}
+
+/**
+ * @brief Habilita o deshabilita la salida por Serial.
+ */
+void RTCDriftEstimator::enableSerial(bool enable) {
+    _enableSerialOutput = enable;
+}
+
+/**
+ * @brief Configura un callback externo para logging.
+ */
+void RTCDriftEstimator::setLogCallback(LogCallback callback) {
+    _logCallback = callback;
+}
+
+// ——— FUNCIONES AUXILIARES ———
+
+/**
+ * @brief Actualiza la estimación con una medición y recorta el aging si procede.
+ * @details Solo se cambia el aging cuando la deriva medida supera su propia
+ *          incertidumbre y equivale al menos a un LSB. Lo no corregible (fracción
+ *          de LSB) queda como deriva residual para correct().
+ * @param rtc RTC donde escribir el aging.
+ * @param offsetMs Desfase RTC - referencia (positivo: el RTC adelanta).
+ * @param elapsedS Tiempo desde el último ajuste.
+ */
+void RTCDriftEstimator::update(MAX31328RTC& rtc, int32_t offsetMs, uint32_t elapsedS) {
+    // ms/s · 1000 = ppm
+    float measured = (float)offsetMs * 1000.0f / (float)elapsedS;
+    float uncertainty = RTCDRIFT_EDGE_ERROR_MS * 1000.0f / (float)elapsedS;
+
+    _record.residual_ppm = measured;
+    _record.uncertainty_ppm = uncertainty;
+    if (_record.measurements < 0xFFFF) _record.measurements++;
+
+    long steps = lroundf(measured / RTCDRIFT_PPM_PER_LSB);
+    if (steps != 0 && fabsf(measured) > uncertainty) {
+        long target = _record.aging + steps; // Positivo reduce la frecuencia
+        if (target > 127) target = 127;
+        if (target < -128) target = -128;
+
+        if (target != _record.aging && rtc.setAgingOffset((int8_t)target)) {
+            _record.residual_ppm = measured - (float)(target - _record.aging) * RTCDRIFT_PPM_PER_LSB;
+            // La sensibilidad real por LSB varía con la temperatura: medio LSB de margen
+            _record.uncertainty_ppm = uncertainty + 0.5f * RTCDRIFT_PPM_PER_LSB;
+            _record.aging = (int8_t)target;
+            if (_record.trims < 0xFFFF) _record.trims++;
+        }
+    }
+
+    MLOG_I("Deriva medida: %ld ms en %lu s = %.2f ppm → aging %d, residual %.2f ppm",
+           (long)offsetMs, (unsigned long)elapsedS, measured,
+           _record.aging, _record.residual_ppm);
+}
+
+/**
+ * @brief Lee el registro de NVS una vez por ciclo.
+ * @details Sin registro válido arranca con la incertidumbre nominal del TCXO.
+ */
+void RTCDriftEstimator::load() {
+    if (_loaded) return;
+    _loaded = true;
+
+    Preferences prefs;
+    bool ok = false;
+    if (prefs.begin(NVS_NAMESPACE, true)) {
+        ok = prefs.getBytesLength(NVS_KEY) == sizeof(_record) &&
+             prefs.getBytes(NVS_KEY, &_record, sizeof(_record)) == sizeof(_record);
+        prefs.end();
+    }
+
+    if (!ok || _record.magic != STORE_MAGIC || _record.version != STORE_VERSION) {
+        memset(&_record, 0, sizeof(_record));
+        _record.magic = STORE_MAGIC;
+        _record.version = STORE_VERSION;
+        _record.uncertainty_ppm = RTCDRIFT_INITIAL_PPM;
+    }
+}
+
+/**
+ * @brief Guarda la estimación en NVS.
+ * @return true si se escribió.
+ */
+bool RTCDriftEstimator::save() {
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        MLOG_E("No se pudo abrir NVS para guardar la deriva");
+        return false;
+    }
+    bool ok = prefs.putBytes(NVS_KEY, &_record, sizeof(_record)) == sizeof(_record);
+    prefs.end();
+
+    if (!ok) {
+        MLOG_E("Error escribiendo la deriva en NVS");
+    }
+    return ok;
+}
+
+/**
+ * @brief Envía un mensaje de log con formato estilo printf.
+ * @param level Nivel LOG_LEVEL_* del mensaje.
+ * @param format Cadena de formato printf.
+ * @param ... Argumentos variables para format.
+ */
+void RTCDriftEstimator::logf(uint8_t level, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    if (_logCallback) {
+        char buffer[LOG_LINE_MAX];
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        _logCallback(buffer);
+    } else if (_enableSerialOutput) {
+        Logger::vwrite(level, TAG, format, args);
+    }
+    va_end(args);
+}
@@ -0,0 +1,146 @@
+/**
+ * @file RTCDrift.h
+ * @brief Estimación de deriva del cristal del MAX31328 y ajuste del aging offset.
+ *
+ * En cada referencia externa (NTP o la hora del servidor cargada en el reloj del
+ * sistema) se mide el desfase del RTC en el flanco de segundo, con resolución de
+ * ~1 ms, y se divide entre el tiempo desde el último ajuste para obtener el error
+ * de frecuencia en ppm. La parte múltiplo de 0.1 ppm se corrige escribiendo el
+ * registro de aging offset; la deriva residual se guarda en NVS y se usa para
+ * corregir las lecturas del RTC y para decidir cuándo hace falta otra referencia.
+ *
+ * @author Daniel Acosta - Santiago Erazo
+ * @version 1.0
+ * @date 2025-10-01
+ */
+
+#ifndef RTC_DRIFT_H
+#define RTC_DRIFT_H
+
+#include <Arduino.h>
+#include "RTC.h"
+
+// ——— Configuración ———
+#define RTCDRIFT_PPM_PER_LSB      0.1f      // Sensibilidad típica del aging offset a 25 °C
+#define RTCDRIFT_INITIAL_PPM      2.0f      // Incertidumbre del TCXO antes de la primera medición
+#define RTCDRIFT_EDGE_ERROR_MS    2.0f      // Error de fechado del flanco (sondeo I2C + latencia)
+#define RTCDRIFT_MIN_BASELINE_S   21600UL   // 6 h: por debajo la medición es demasiado ruidosa
+#define RTCDRIFT_MAX_ERROR_MS     1000UL    // Error admitido antes de exigir otra referencia
+#define RTCDRIFT_MIN_SYNC_S       86400UL   // Intervalo mínimo entre referencias (1 día)
+#define RTCDRIFT_MAX_SYNC_S       2592000UL // Intervalo máximo entre referencias (30 días)
+
+/**
+ * @class RTCDriftEstimator
+ * @brief Mide la deriva del MAX31328 contra referencias externas y la recorta con el aging offset.
+ */
+class RTCDriftEstimator {
+public:
+    /**
+     * @brief Constructor
+     * @param enableSerial Habilitar mensajes por Serial
+     */
+    RTCDriftEstimator(bool enableSerial = true);
+
+    /**
+     * @brief Carga la estimación de NVS y restaura el aging offset si el RTC lo perdió
+     * @param rtc RTC ya inicializado
+     */
+    void begin(MAX31328RTC& rtc);
+
+    /**
+     * @brief Indica si conviene obtener una referencia externa
+     * @param now Hora actual (timestamp de pared)
+     * @return true si nunca se ajustó o el error acumulado estimado supera RTCDRIFT_MAX_ERROR_MS
+     */
+    bool isSyncDue(uint32_t now);
+
+    /**
+     * @brief Intervalo entre referencias que mantiene el error bajo RTCDRIFT_MAX_ERROR_MS
+     * @return Segundos, acotado a [RTCDRIFT_MIN_SYNC_S, RTCDRIFT_MAX_SYNC_S]
+     */
+    uint32_t getSyncIntervalS();
+
+    /**
+     * @brief Corrige un timestamp del RTC con la deriva residual acumulada desde el último ajuste
+     * @param rtcEpoch Timestamp leído del RTC
+     * @return Timestamp corregido
+     */
+    uint32_t correct(uint32_t rtcEpoch);
+
+    /**
+     * @brief Obtiene hora NTP, mide la deriva y ajusta el RTC
+     * @param rtc RTC ya inicializado
+     * @param ntpServer Servidor NTP
+     * @param gmtOffset Offset GMT en horas
+     * @return true si el RTC quedó ajustado
+     */
+    bool syncWithNTP(MAX31328RTC& rtc, const char* ntpServer = "pool.ntp.org", int gmtOffset = -5);
+
+    /**
+     * @brief Mide la deriva contra el reloj del sistema y ajusta el RTC alineado al segundo
+     * @details El reloj del sistema debe tener una referencia válida (SNTP o settimeofday()
+     *          con la hora del servidor).
+     * @param rtc RTC ya inicializado
+     * @param gmtOffset Offset GMT en horas (el RTC guarda hora local)
+     * @return true si el RTC quedó ajustado
+     */
+    bool syncWithSystemTime(MAX31328RTC& rtc, int gmtOffset);
+
+    /**
+     * @brief Deriva residual estimada con el aging actual (positivo: el RTC adelanta)
+     */
+    float getResidualPpm();
+
+    /**
+     * @brief Aging offset aplicado
+     */
+    int8_t getAgingOffset();
+
+    /**
+     * @brief Escribir estado en un buffer del llamador
+     * @param buffer Destino del texto
+     * @param size Tamaño del buffer
+     * @return Longitud del texto completo (semántica de snprintf)
+     */
+    size_t getStatus(char* buffer, size_t size);
+
+    /**
+     * @brief Habilitar/deshabilitar salida por Serial
+     */
+    void enableSerial(bool enable);
+
+    /**
+     * @brief Configurar callback para logging personalizado
+     */
+    typedef void (*LogCallback)(const char* message);
+    void setLogCallback(LogCallback callback);
+
+    /**
+     * @struct DriftRecord
+     * @brief Estimación persistida en NVS.
+     */
+    typedef struct __attribute__((packed)) {
+        uint16_t magic;          ///< Identifica el registro
+        uint16_t version;        ///< Versión de la disposición
+        int8_t aging;            ///< Aging offset escrito en el RTC
+        float residual_ppm;      ///< Deriva estimada con ese aging (positivo: adelanta)
+        float uncertainty_ppm;   ///< Incertidumbre de residual_ppm
+        uint32_t ref_epoch;      ///< Hora de pared del último ajuste del RTC (0 = nunca)
+        uint16_t measurements;   ///< Mediciones aceptadas
+        uint16_t trims;          ///< Cambios de aging realizados
+    } DriftRecord;
+
+private:
+    DriftRecord _record;        ///< Estimación vigente
+    bool _loaded;               ///< _record ya se leyó de NVS en este ciclo
+    bool _enableSerialOutput;   ///< Habilitar salida por Serial
+    LogCallback _logCallback;   ///< Callback opcional de log
+
+    void load();
+    bool save();
+    void update(MAX31328RTC& rtc, int32_t offsetMs, uint32_t elapsedS);
+
+    void logf(uint8_t level, const char* format, ...) __attribute__((format(printf, 3, 4)));
+};
+
+#endif // RTC_DRIFT_H
@@ -9,7 +9,7 @@
  *
  * Dependencias:
  *   - Arduino Core para ESP32
- *   - Funciones de CRC hardware (esp_crc32_le)
+ *   - Funciones de CRC hardware (esp_crc32_le, vía HAL::crc32)
  *   - Librerías estándar de C para manejo de memoria y strings
  *
  * Funcionalidades principales:
@@ -26,12 +26,14 @@
  */
 
 #include "RTCMemory.h"
+#include "Logger.h"
 #include <stdarg.h>
 
+static const char TAG[] = "RTCMEM"; ///< Etiqueta de log del módulo
+
 // ——— Variables en RTC Memory ———
-RTC_DATA_ATTR RTCMemoryManager::RTCDataStructure rtc_data; /**< Estructura principal almacenada en memoria RTC */
-RTC_DATA_ATTR int currentIndex = 0; /**< Estructura principal almacenada en memoria RTC */
-RTC_DATA_ATTR uint16_t totalReadings = 0; /**< Total de lecturas almacenadas */
+HAL_PERSISTENT RTCMemoryManager::RTCDataStructure rtc_data; /**< Estructura principal almacenada en memoria RTC */
+HAL_PERSISTENT uint16_t totalReadings = 0; /**< Total de lecturas almacenadas */
 
 /**
  * @brief Constructor de la clase.
@@ -114,11 +116,10 @@ void RTCMemoryManager::initialize() {
     // Calcular CRCs iniciales
     updateCRCs();
     
-    // Resetear contadores
-    currentIndex = 0;
+    // Resetear contadores (los índices del buffer quedaron en cero con el memset)
     totalReadings = 0;
     
-    log(" RTC Memory inicializada correctamente");
+    MLOG_I(" RTC Memory inicializada correctamente");
 }
 
 /**
@@ -129,51 +130,51 @@ void RTCMemoryManager::initialize() {
 // Almacenar lectura de sensores con validación
 bool RTCMemoryManager::storeReading(const SensorReading &reading) {
     if (!reading.valid) {
-        log(" No se almacena lectura inválida");
+        MLOG_W(" No se almacena lectura inválida");
         return false;
     }
     
     // Intentar escribir con verificación
     uint32_t start_time = millis();
+    SensorReading* slot = &rtc_data.readings.slot();
+    uint16_t position = rtc_data.readings.head;
     
     // Copia de seguridad antes de escribir
     SensorReading backup;
-    memcpy(&backup, (void*)&rtc_data.readings[currentIndex], sizeof(SensorReading));
+    memcpy(&backup, (void*)slot, sizeof(SensorReading));
     
     // Escribir datos
-    memcpy((void*)&rtc_data.readings[currentIndex], &reading, sizeof(SensorReading));
+    memcpy((void*)slot, &reading, sizeof(SensorReading));
     
     // Verificar escritura inmediatamente
     SensorReading verification;
-    memcpy(&verification, (void*)&rtc_data.readings[currentIndex], sizeof(SensorReading));
+    memcpy(&verification, (void*)slot, sizeof(SensorReading));
     
     // Verificar timeout de escritura
     if (millis() - start_time > 100) {  // 100ms timeout para escritura
-        logf(" Escritura RTC lenta: %u ms", millis() - start_time);
+        MLOG_W(" Escritura RTC lenta: %lu ms", (unsigned long)(millis() - start_time));
         // Nota: Error reporting manejado por WatchdogManager
     }
     
     // Verificar integridad de la escritura
     if (memcmp(&reading, &verification, sizeof(SensorReading)) != 0) {
-        log(" Fallo en verificación de escritura RTC");
+        MLOG_E(" Fallo en verificación de escritura RTC");
         // Restaurar backup
-        memcpy((void*)&rtc_data.readings[currentIndex], &backup, sizeof(SensorReading));
+        memcpy((void*)slot, &backup, sizeof(SensorReading));
         // Nota: Error reporting manejado por WatchdogManager
         return false;
     }
     
-    // Actualizar metadatos
+    // Confirmar posición en el buffer circular y actualizar metadatos
+    rtc_data.readings.commit();
     rtc_data.sequence_number++;
     totalReadings++;
     
-    // Actualizar CRCs
+    // Actualizar CRCs (cubren también los índices del buffer)
     updateCRCs();
     
-    logf(" Lectura #%d almacenada en posición %d", 
-        reading.reading_number, currentIndex);
-    
-    // Actualizar índice (buffer circular)
-    currentIndex = (currentIndex + 1) % MAX_READINGS;
+    MLOG_D(" Lectura #%d almacenada en posición %d", 
+        reading.reading_number, position);
     
     return true;
 }
@@ -219,7 +220,7 @@ RTCMemoryManager::SensorReading RTCMemoryManager::createFullReading(float temper
 uint16_t RTCMemoryManager::getTotalReadings() { return totalReadings; }
 
 /** @brief Obtiene el índice actual del buffer circular. */
-int RTCMemoryManager::getCurrentIndex() { return currentIndex; }
+int RTCMemoryManager::getCurrentIndex() { return rtc_data.readings.head; }
 
 /** @brief Obtiene el número de secuencia actual. */
 uint32_t RTCMemoryManager::getSequenceNumber() { return rtc_data.sequence_number; }
@@ -242,7 +243,7 @@ bool RTCMemoryManager::shouldSendData(int readingsThreshold) {
 void RTCMemoryManager::markDataSent() {
     rtc_data.sequence_number++;
     updateCRCs();
-    log(" Datos marcados como enviados");
+    MLOG_I(" Datos marcados como enviados");
 }
 
 /**
@@ -251,12 +252,11 @@ void RTCMemoryManager::markDataSent() {
  * @return true si existe lectura válida, false en caso contrario.
  */
 bool RTCMemoryManager::getLastReading(SensorReading &reading) {
-    if (totalReadings == 0) {
+    if (rtc_data.readings.empty()) {
         return false;
     }
     
-    int lastIndex = (currentIndex - 1 + MAX_READINGS) % MAX_READINGS;
-    memcpy(&reading, (void*)&rtc_data.readings[lastIndex], sizeof(SensorReading));
+    memcpy(&reading, (void*)&rtc_data.readings.recent(0), sizeof(SensorReading));
     
     return reading.valid;
 }
@@ -271,40 +271,23 @@ bool RTCMemoryManager::getLastReading(SensorReading &reading) {
  */
 int RTCMemoryManager::getRecentReadings(SensorReading readings[], int maxReadings) {
     int count = 0;
-    int totalAvailable = (totalReadings < MAX_READINGS) ? totalReadings : MAX_READINGS;
+    int totalAvailable = (int)rtc_data.readings.size();
     int toRetrieve = (maxReadings < totalAvailable) ? maxReadings : totalAvailable;
     
-    logf(" getRecentReadings: Solicitados=%d, Disponibles=%d, ARecuperar=%d", 
+    MLOG_D(" getRecentReadings: Solicitados=%d, Disponibles=%d, ARecuperar=%d", 
         maxReadings, totalAvailable, toRetrieve);
     
-    // Crear array dinámico del tamaño correcto
-    SensorReading* tempBuffer = new SensorReading[toRetrieve];
-    int tempCount = 0;
-    
-    // Recopilar lecturas válidas desde la más reciente hacia atrás
-    for (int i = 0; i < toRetrieve && tempCount < toRetrieve; i++) {
-        int index = (currentIndex - 1 - i + MAX_READINGS) % MAX_READINGS;
-        SensorReading temp;
-        memcpy(&temp, (void*)&rtc_data.readings[index], sizeof(SensorReading));
+    // Copiar en orden cronológico: de la más antigua de la ventana a la más reciente
+    for (int i = toRetrieve - 1; i >= 0; i--) {
+        const SensorReading& temp = rtc_data.readings.recent(i);
         
         if (temp.valid && temp.reading_number > 0) {
-            tempBuffer[tempCount] = temp;
-            tempCount++;
+            memcpy(&readings[count], (const void*)&temp, sizeof(SensorReading));
+            count++;
         }
     }
     
-    logf(" Lecturas válidas recuperadas: %d de %d solicitadas", tempCount, toRetrieve);
-    
-    // Copiar en orden cronológico (reversa del buffer)
-    for (int i = tempCount - 1; i >= 0; i--) {
-        readings[count] = tempBuffer[i];
-        count++;
-    }
-    
-    // Liberar memoria
-    delete[] tempBuffer;
-    
-    logf(" getRecentReadings completado: %d lecturas retornadas", count);
+    MLOG_D(" getRecentReadings completado: %d válidas de %d solicitadas", count, toRetrieve);
     return count;
 }
 
@@ -315,21 +298,21 @@ int RTCMemoryManager::getRecentReadings(SensorReading readings[], int maxReading
  * @param numReadings Cantidad de lecturas a mostrar.
  */
 void RTCMemoryManager::displayStoredReadings(int numReadings) {
-    log("\n --- DATOS ALMACENADOS EN RTC MEMORY ---");
-    logf("Total lecturas: %d | Posición actual: %d", 
-        totalReadings, currentIndex);
+    MLOG_I("\n --- DATOS ALMACENADOS EN RTC MEMORY ---");
+    MLOG_I("Total lecturas: %d | Posición actual: %d", 
+        totalReadings, rtc_data.readings.head);
     
     // Mostrar últimas N lecturas válidas
     int shown = 0;
-    log("Últimas lecturas:");
+    MLOG_I("Últimas lecturas:");
     
-    for (int i = 0; i < MAX_READINGS && shown < numReadings; i++) {
-        int index = (currentIndex - 1 - i + MAX_READINGS) % MAX_READINGS;
+    for (size_t i = 0; i < rtc_data.readings.size() && shown < numReadings; i++) {
+        int index = (int)rtc_data.readings.recentIndex(i);
         SensorReading temp;
-        memcpy(&temp, (void*)&rtc_data.readings[index], sizeof(SensorReading));
+        memcpy(&temp, (void*)&rtc_data.readings.items[index], sizeof(SensorReading));
         
         if (temp.valid && temp.reading_number > 0) {
-            logf("  [%d] #%d: T:%.1f°C pH:%.1f Turb:%.1f TDS:%.0f EC:%.1f | Status:0x%02X | %ums",
+            MLOG_I("  [%d] #%d: T:%.1f°C pH:%.1f Turb:%.1f TDS:%.0f EC:%.1f | Status:0x%02X | %ums",
                 index, temp.reading_number, temp.temperature, temp.ph, 
                 temp.turbidity, temp.tds, temp.ec, temp.sensor_status, temp.timestamp);
             shown++;
@@ -337,10 +320,10 @@ void RTCMemoryManager::displayStoredReadings(int numReadings) {
     }
     
     if (shown == 0) {
-        log("   No hay lecturas válidas");
+        MLOG_I("   No hay lecturas válidas");
     }
     
-    log("---------------------------------------");
+    MLOG_I("---------------------------------------");
 }
 
 // Reset completo
@@ -348,56 +331,68 @@ void RTCMemoryManager::displayStoredReadings(int numReadings) {
  * @brief Fuerza un reinicio completo de la memoria RTC eliminando todo su contenido.
  */
 void RTCMemoryManager::forceCompleteReset() {
-    log(" FORZANDO RESET COMPLETO DEL SISTEMA...");
-    log(" Todos los datos RTC serán eliminados");
+    MLOG_W(" FORZANDO RESET COMPLETO DEL SISTEMA...");
+    MLOG_W(" Todos los datos RTC serán eliminados");
     
     // Limpiar completamente toda la estructura RTC
     memset(&rtc_data, 0, sizeof(RTCDataStructure));
-    currentIndex = 0;
     totalReadings = 0;
     
-    log(" Reset completo realizado");
-    log("El sistema se reiniciará como primera ejecución");
+    MLOG_I(" Reset completo realizado");
+    MLOG_I("El sistema se reiniciará como primera ejecución");
 }
 
 // Obtener estado
 /**
- * @brief Devuelve un resumen del estado del administrador de memoria RTC.
+ * @brief Escribe un resumen del estado del administrador de memoria RTC.
  * 
- * @return String Estado formateado en texto.
+ * @param buffer Destino del texto.
+ * @param size Tamaño del buffer.
+ * @return size_t Longitud del texto completo (semántica de snprintf).
  */
-String RTCMemoryManager::getStatus() {
-    String status = "=== RTC Memory Manager Status ===\n";
-    status += "Total lecturas: " + String(totalReadings) + "\n";
-    status += "Índice actual: " + String(currentIndex) + "\n";
-    status += "Secuencia: " + String(rtc_data.sequence_number) + "\n";
-    status += "Inicializado: " + String(isInitialized() ? "Sí" : "No") + "\n";
-    status += "Tamaño estructura: " + String(sizeof(RTCDataStructure)) + " bytes\n";
-    status += "SOLO DATOS - Sin logging de errores\n";
-    status += "================================";
-    
-    return status;
+size_t RTCMemoryManager::getStatus(char* buffer, size_t size) {
+    int n = snprintf(buffer, size,
+                     "=== RTC Memory Manager Status ===\n"
+                     "Total lecturas: %lu\n"
+                     "Índice actual: %lu\n"
+                     "Secuencia: %lu\n"
+                     "Inicializado: %s\n"
+                     "Tamaño estructura: %u bytes\n"
+                     "SOLO DATOS - Sin logging de errores\n"
+                     "================================",
+                     (unsigned long)totalReadings,
+                     (unsigned long)rtc_data.readings.head,
+                     (unsigned long)rtc_data.sequence_number,
+                     isInitialized() ? "Sí" : "No",
+                     (unsigned)sizeof(RTCDataStructure));
+    
+    return (n > 0) ? (size_t)n : 0;
 }
 
 // Obtener uso de memoria
 /**
- * @brief Devuelve información sobre el uso actual de la memoria RTC.
+ * @brief Escribe información sobre el uso actual de la memoria RTC.
  * 
- * @return String Informe de uso de memoria.
+ * @param buffer Destino del texto.
+ * @param size Tamaño del buffer.
+ * @return size_t Longitud del texto completo (semántica de snprintf).
  */
-String RTCMemoryManager::getMemoryUsage() {
-    String usage = "=== Memory Usage ===\n";
-    usage += "Estructura RTC: " + String(sizeof(RTCDataStructure)) + " bytes\n";
-    usage += "Buffer lecturas: " + String(sizeof(rtc_data.readings)) + " bytes\n";
-    usage += "Solo datos de sensores - sin buffers de errores\n";
-    
+size_t RTCMemoryManager::getMemoryUsage(char* buffer, size_t size) {
     // Calcular uso actual de buffer de lecturas
-    int usedReadings = (totalReadings < MAX_READINGS) ? totalReadings : MAX_READINGS;
-    
-    usage += "Lecturas usadas: " + String(usedReadings) + "/" + String(MAX_READINGS) + "\n";
-    usage += "===================";
-    
-    return usage;
+    int usedReadings = (int)rtc_data.readings.size();
+    
+    int n = snprintf(buffer, size,
+                     "=== Memory Usage ===\n"
+                     "Estructura RTC: %u bytes\n"
+                     "Buffer lecturas: %u bytes\n"
+                     "Solo datos de sensores - sin buffers de errores\n"
+                     "Lecturas usadas: %d/%d\n"
+                     "===================",
+                     (unsigned)sizeof(RTCDataStructure),
+                     (unsigned)sizeof(rtc_data.readings),
+                     usedReadings, (int)MAX_READINGS);
+    
+    return (n > 0) ? (size_t)n : 0;
 }
 
 // Habilitar/deshabilitar Serial
@@ -441,7 +436,7 @@ bool RTCMemoryManager::isInitialized() {
  * @return uint32_t Valor del CRC32 calculado.
  */
 uint32_t RTCMemoryManager::calculateCRC32(const void* data, size_t length) {
-    return esp_crc32_le(0xFFFFFFFF, (const uint8_t*)data, length) ^ 0xFFFFFFFF;
+    return HAL::crc32(0xFFFFFFFF, (const uint8_t*)data, length) ^ 0xFFFFFFFF;
 }
 
 /**
@@ -459,13 +454,14 @@ void RTCMemoryManager::updateCRCs() {
  * @return false Si se detecta alguna inconsistencia.
  */
 bool RTCMemoryManager::validateLogicalRanges() {
-    if (currentIndex < 0 || currentIndex >= MAX_READINGS) {
-        logf(" currentIndex fuera de rango: %d", currentIndex);
+    if (!rtc_data.readings.isValid()) {
+        MLOG_W(" Índices del buffer fuera de rango: head=%u count=%u",
+               rtc_data.readings.head, rtc_data.readings.count);
         return false;
     }
     
     if (totalReadings > MAX_TOTAL_READINGS) {
-        logf(" totalReadings sospechoso: %d", totalReadings);
+        MLOG_W(" totalReadings sospechoso: %d", totalReadings);
         return false;
     }
     
@@ -474,30 +470,24 @@ bool RTCMemoryManager::validateLogicalRanges() {
 
 // Métodos privados de logging
 /**
- * @brief Envía un mensaje de log simple ya sea por callback o por Serial.
- * 
- * @param message Cadena de texto a mostrar.
+ * @brief Envía un mensaje de log con formato estilo printf.
+ * @param level Nivel LOG_LEVEL_* del mensaje.
+ * @param format Cadena de formato printf.
+ * @param ... Argumentos variables para format.
+ * @note Si hay callback registrado se formatea aquí y se le entrega la línea;
+ *       en caso contrario se delega en Logger (modo texto o binario).
+ * @note Se invoca a través de las macros MLOG_*, que eliminan en compilación
+ *       los niveles por encima de LOG_LEVEL.
  */
-void RTCMemoryManager::log(const char* message) {
-    if (_logCallback) {
-        _logCallback(message);
-    } else if (_enableSerialOutput && Serial) {
-        Serial.println(message);
-    }
-}
-
-/**
- * @brief Envía un mensaje de log formateado usando printf-style.
- * 
- * @param format Cadena de formato (similar a printf).
- * @param ... Argumentos variables para completar el formato.
- */
-void RTCMemoryManager::logf(const char* format, ...) {
-    char buffer[256];
+void RTCMemoryManager::logf(uint8_t level, const char* format, ...) {
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    if (_logCallback) {
+        char buffer[LOG_LINE_MAX];
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        _logCallback(buffer);
+    } else if (_enableSerialOutput) {
+        Logger::vwrite(level, TAG, format, args);
+    }
     va_end(args);
-    
-    log(buffer);
-}
\ No newline at end of file
+}
@@ -2,8 +2,9 @@
 #define RTCMEMORY_MANAGER_H
 
 #include <Arduino.h>
-#include "esp_crc.h"
+#include "HAL.h"
 #include <string.h>
+#include "RingBuffer.h"
 
 /**
  * @file RTCMemory.h
@@ -28,6 +29,11 @@
 class RTCMemoryManager {
 public:
 
+    /**
+     * @brief Capacidad del buffer circular de lecturas.
+     */
+    static const int MAX_READINGS = 160;
+
     /**
      * @brief Estructura que representa una lectura de sensores.
      */
@@ -42,6 +48,7 @@ public:
         uint16_t reading_number;    // Número de lectura
         uint8_t sensor_status;      // Estado de los sensores (flags)
         bool valid;                 // Indica si la lectura es válida
+        uint8_t alarms;             // Alarmas de anomalía del ciclo (ver AnomalyDetector.h)
     } SensorReading;
 
     /**
@@ -52,7 +59,7 @@ public:
         uint32_t sequence_number;   // Número de secuencia
         uint32_t boot_timestamp;    // Timestamp del último boot
         uint32_t header_crc;        // CRC del header
-        SensorReading readings[160]; // Lecturas de sensores (buffer circular)
+        RingBuffer<SensorReading, MAX_READINGS> readings; // Lecturas + índices del buffer circular
         uint32_t data_crc;          // CRC de todos los datos
         uint32_t magic_end;         // 0x87654321
     } RTCDataStructure;
@@ -60,7 +67,6 @@ public:
 private:
     static const uint32_t MAGIC_START = 0x12345678;
     static const uint32_t MAGIC_END = 0x87654321;
-    static const int MAX_READINGS = 160;
     static const uint32_t MAX_TOTAL_READINGS = 10000;  // Valor máximo lógico
     
     bool _enableSerialOutput;
@@ -172,16 +178,20 @@ public:
     void forceCompleteReset();
     
     /**
-     * @brief Obtener estadísticas del sistema RTC
-     * @return String con información del almacenamiento RTC
+     * @brief Escribir estadísticas del sistema RTC en un buffer del llamador
+     * @param buffer Destino del texto
+     * @param size Tamaño del buffer
+     * @return Longitud del texto completo (semántica de snprintf; ≥ size si se truncó)
      */
-    String getStatus();
+    size_t getStatus(char* buffer, size_t size);
     
     /**
-     * @brief Obtener información de uso de memoria
-     * @return String con estadísticas de uso de buffers
+     * @brief Escribir información de uso de memoria en un buffer del llamador
+     * @param buffer Destino del texto
+     * @param size Tamaño del buffer
+     * @return Longitud del texto completo (semántica de snprintf; ≥ size si se truncó)
      */
-    String getMemoryUsage();
+    size_t getMemoryUsage(char* buffer, size_t size);
     
     /**
      * @brief Habilitar/deshabilitar salida por Serial
@@ -201,6 +211,9 @@ public:
      */
     bool isInitialized();
 
+    /// La suite de microbenchmarks (bench/) mide kernels privados
+    friend class FirmwareBenchmark;
+
 private:
     /**
      * @brief Calcular CRC32 de un bloque de datos
@@ -222,17 +235,12 @@ private:
     bool validateLogicalRanges();
     
     /**
-     * @brief Enviar mensaje de log
-     * @param message Mensaje a enviar
-     */
-    void log(const char* message);
-    
-    /**
-     * @brief Enviar mensaje de log con formato
+     * @brief Envía mensaje de log con formato al backend común (usar macros MLOG_*)
+     * @param level Nivel LOG_LEVEL_* del mensaje
      * @param format String de formato estilo printf
      * @param ... Argumentos variables
      */
-    void logf(const char* format, ...);
+    void logf(uint8_t level, const char* format, ...) __attribute__((format(printf, 3, 4)));
 };
 
 #endif // RTCMEMORY_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,139 @@
+/**
+ * @file SensorBreaker.cpp
+ * @brief Implementación del interruptor de circuito por sensor
+ * @details Máquina de estados por sensor: cerrado → (THRESHOLD fallas) → abierto →
+ *          (espera) → prueba → cerrado si hay lectura válida, abierto con el doble
+ *          de espera si no. Solo se toca al despertar y al final del muestreo.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+#include "SensorBreaker.h"
+#include "Logger.h"
+
+static const char TAG[] = "BREAKER"; ///< Etiqueta de log del módulo
+
+// ——— Variables persistentes ———
+HAL_PERSISTENT SensorBreaker::BreakerEntry sensor_breakers[SensorBreaker::SENSOR_COUNT];
+
+namespace SensorBreaker {
+
+    /**
+     * @brief Sensores habilitados en el ciclo actual (decidido en beginCycle())
+     * @details No persistente: por defecto todos activos si beginCycle() no se llamó.
+     */
+    bool active[SENSOR_COUNT] = {true, true, true, true};
+
+    /**
+     * @brief Espera en despertares para un exponente de backoff
+     */
+    static uint16_t backoffWakes(uint8_t exponent)
+    {
+        if (exponent > SENSOR_BREAKER_MAX_EXPONENT) exponent = SENSOR_BREAKER_MAX_EXPONENT;
+        return (uint16_t)(SENSOR_BREAKER_BASE_WAKES << exponent);
+    }
+
+    void beginCycle(bool reset)
+    {
+        for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+            BreakerEntry &b = sensor_breakers[i];
+
+            // Estado fuera de rango = RTC Memory no confiable: cerrar
+            if (reset || b.open > 1 || b.backoff_exponent > SENSOR_BREAKER_MAX_EXPONENT ||
+                b.wakes_until_probe > backoffWakes(SENSOR_BREAKER_MAX_EXPONENT)) {
+                b = BreakerEntry{};
+            }
+
+            if (b.open && b.wakes_until_probe > 0) {
+                b.wakes_until_probe--;
+                active[i] = false;
+                LOG_I(TAG, " %s omitido (interruptor abierto, prueba en %u despertares)",
+                      name((Sensor)i), b.wakes_until_probe + 1);
+            } else {
+                active[i] = true;
+                if (b.open) {
+                    LOG_I(TAG, " %s: ciclo de prueba", name((Sensor)i));
+                }
+            }
+        }
+    }
+
+    bool isActive(Sensor sensor)
+    {
+        return sensor < SENSOR_COUNT && active[sensor];
+    }
+
+    bool recordResult(Sensor sensor, bool ok)
+    {
+        if (sensor >= SENSOR_COUNT || !active[sensor]) return false;
+        BreakerEntry &b = sensor_breakers[sensor];
+
+        if (ok) {
+            if (b.open) {
+                LOG_I(TAG, " %s responde de nuevo - interruptor cerrado", name(sensor));
+            }
+            b.consecutive_failures = 0;
+            b.backoff_exponent = 0;
+            b.wakes_until_probe = 0;
+            b.open = 0;
+            return false;
+        }
+
+        if (b.consecutive_failures < 255) b.consecutive_failures++;
+
+        if (b.open) {
+            // Prueba fallida: duplicar la espera
+            if (b.backoff_exponent < SENSOR_BREAKER_MAX_EXPONENT) b.backoff_exponent++;
+            b.wakes_until_probe = backoffWakes(b.backoff_exponent);
+            LOG_W(TAG, " %s sigue sin responder - próxima prueba en %u despertares",
+                  name(sensor), b.wakes_until_probe);
+            return false;
+        }
+
+        if (b.consecutive_failures >= SENSOR_BREAKER_THRESHOLD) {
+            b.open = 1;
+            b.backoff_exponent = 0;
+            b.wakes_until_probe = backoffWakes(0);
+            if (b.trips < 255) b.trips++;
+            LOG_W(TAG, " %s: %u ciclos sin lectura válida - interruptor abierto",
+                  name(sensor), b.consecutive_failures);
+            return true;
+        }
+        return false;
+    }
+
+    uint8_t markSkipped(uint8_t packedStatus)
+    {
+        for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+            if (!active[i]) {
+                packedStatus |= (SENSOR_FIELD_SKIPPED << (2 * i));
+            }
+        }
+        return packedStatus;
+    }
+
+    uint8_t openMask()
+    {
+        uint8_t mask = 0;
+        for (uint8_t i = 0; i < SENSOR_COUNT; i++) {
+            if (sensor_breakers[i].open) mask |= (1 << i);
+        }
+        return mask;
+    }
+
+    const BreakerEntry& entry(Sensor sensor)
+    {
+        return sensor_breakers[sensor < SENSOR_COUNT ? sensor : 0];
+    }
+
+    const char* name(Sensor sensor)
+    {
+        switch (sensor) {
+            case SENSOR_TEMPERATURE: return "temp";
+            case SENSOR_TDS:         return "tds";
+            case SENSOR_TURBIDITY:   return "turb";
+            case SENSOR_PH:          return "ph";
+            default:                 return "?";
+        }
+    }
+}
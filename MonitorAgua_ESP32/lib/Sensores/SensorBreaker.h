@@ -0,0 +1,138 @@
+/**
+ * @file SensorBreaker.h
+ * @brief Interruptor de circuito (circuit breaker) por sensor en RTC Memory
+ * @details Una sonda muerta repite en cada despertar su inicialización fallida, sus
+ *          timeouts y sus errores en el watchdog. Tras SENSOR_BREAKER_THRESHOLD ciclos
+ *          seguidos sin lectura válida, el interruptor del sensor se abre: el sensor no
+ *          se inicializa ni se muestrea. Cada cierto número de despertares se deja un
+ *          ciclo de prueba; si vuelve a fallar, la espera se duplica (hasta
+ *          SENSOR_BREAKER_MAX_EXPONENT), y con la primera lectura válida se cierra.
+ *
+ *          Uso por ciclo (ver main.cpp):
+ *          1. beginCycle() una vez al despertar.
+ *          2. Inicializar y muestrear solo los sensores con isActive().
+ *          3. recordResult() de cada sensor activo al terminar el muestreo.
+ *          4. markSkipped() sobre sensor_status antes de almacenar la lectura.
+ *
+ * @note El estado vive en HAL_PERSISTENT: sobrevive al deep sleep, se pierde al
+ *       cortar la alimentación (todos los interruptores vuelven a cerrarse).
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef SENSOR_BREAKER_H
+#define SENSOR_BREAKER_H
+
+#include <Arduino.h>
+#include "HAL.h"
+
+// ——— Configuración ———
+
+/**
+ * @def SENSOR_BREAKER_THRESHOLD
+ * @brief Ciclos consecutivos sin lectura válida que abren el interruptor
+ */
+#define SENSOR_BREAKER_THRESHOLD    3
+
+/**
+ * @def SENSOR_BREAKER_BASE_WAKES
+ * @brief Despertares omitidos antes del primer ciclo de prueba
+ * @note Con ciclos de 80 s: 2 despertares ≈ 3 minutos.
+ */
+#define SENSOR_BREAKER_BASE_WAKES   2
+
+/**
+ * @def SENSOR_BREAKER_MAX_EXPONENT
+ * @brief Tope del backoff exponencial (BASE << 6 = 128 despertares ≈ 2.8 h)
+ */
+#define SENSOR_BREAKER_MAX_EXPONENT 6
+
+/**
+ * @def SENSOR_FIELD_SKIPPED
+ * @brief Valor del campo de 2 bits de un sensor en sensor_status cuando se omitió
+ * @details TIMEOUT | INVALID_READING a la vez: un sensor muestreado no los reporta
+ *          juntos, así que el servidor puede distinguir "omitido por el interruptor".
+ */
+#define SENSOR_FIELD_SKIPPED        0x03
+
+/**
+ * @namespace SensorBreaker
+ * @brief Estado y decisiones del interruptor de cada sensor
+ */
+namespace SensorBreaker {
+
+    /**
+     * @enum Sensor
+     * @brief Índice de cada sensor; coincide con su campo en sensor_status (bits 2·i)
+     */
+    typedef enum : uint8_t {
+        SENSOR_TEMPERATURE = 0,
+        SENSOR_TDS = 1,
+        SENSOR_TURBIDITY = 2,
+        SENSOR_PH = 3,
+        SENSOR_COUNT = 4
+    } Sensor;
+
+    /**
+     * @struct BreakerEntry
+     * @brief Estado persistente de un interruptor (6 bytes en RTC Memory)
+     */
+    typedef struct __attribute__((packed)) {
+        uint8_t consecutive_failures;   ///< Ciclos seguidos sin lectura válida
+        uint8_t backoff_exponent;       ///< Espera actual = SENSOR_BREAKER_BASE_WAKES << exponente
+        uint16_t wakes_until_probe;     ///< Despertares restantes hasta el ciclo de prueba
+        uint8_t open;                   ///< 1 si el interruptor está abierto
+        uint8_t trips;                  ///< Veces que se abrió desde el encendido (satura en 255)
+    } BreakerEntry;
+
+    /**
+     * @brief Prepara el ciclo: descuenta la espera y decide qué sensores corren
+     * @param reset true tras reinicializar la RTC Memory (estado no confiable)
+     */
+    void beginCycle(bool reset = false);
+
+    /**
+     * @brief Indica si el sensor debe inicializarse y muestrearse en este ciclo
+     * @return true si el interruptor está cerrado o toca ciclo de prueba
+     */
+    bool isActive(Sensor sensor);
+
+    /**
+     * @brief Registra el resultado del ciclo de un sensor activo
+     * @param ok true si hubo al menos una lectura válida
+     * @return true si este resultado abrió el interruptor
+     */
+    bool recordResult(Sensor sensor, bool ok);
+
+    /**
+     * @brief Marca con SENSOR_FIELD_SKIPPED los campos de los sensores omitidos
+     * @param packedStatus sensor_status empaquetado (2 bits por sensor)
+     * @return sensor_status con los sensores inactivos marcados
+     */
+    uint8_t markSkipped(uint8_t packedStatus);
+
+    /**
+     * @brief Máscara de interruptores abiertos (bit i = Sensor i) para telemetría
+     */
+    uint8_t openMask();
+
+    /**
+     * @brief Estado persistente de un interruptor (solo lectura)
+     */
+    const BreakerEntry& entry(Sensor sensor);
+
+    /**
+     * @brief Nombre corto del sensor para logs ("temp", "tds", "turb", "ph")
+     */
+    const char* name(Sensor sensor);
+}
+
+/**
+ * @var sensor_breakers
+ * @brief Interruptores de los sensores en RTC Memory
+ * @note Variable HAL_PERSISTENT declarada en .cpp, solo declaración extern aquí.
+ */
+extern HAL_PERSISTENT SensorBreaker::BreakerEntry sensor_breakers[SensorBreaker::SENSOR_COUNT];
+
+#endif // SENSOR_BREAKER_H
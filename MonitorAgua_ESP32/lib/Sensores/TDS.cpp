@@ -11,6 +11,10 @@
  */
 
 #include "TDS.h"
+#include "Logger.h"
+#include "Trace.h"
+
+static const char TAG[] = "TDS"; ///< Etiqueta de log del módulo
 
 /**
  * @namespace TDSSensor
@@ -58,7 +62,7 @@ namespace TDSSensor {
      * @details Estructura que almacena los parámetros de calibración específicos del
      *          chip para convertir valores crudos ADC a voltajes reales (mV).
      */
-    esp_adc_cal_characteristics_t adc_chars;
+    HAL::AdcCalibration adc_chars;
     
     // Variables de calibración 
 
@@ -181,9 +185,10 @@ namespace TDSSensor {
     float readCalibratedVoltage() {
         long sum = 0;
         int validSamples = 0;
+        HAL::Trace::beginBurst(HAL::Trace::Source::ADC, sensor_pin);
         
         for (int i = 0; i < SAMPLES; i++) {
-            int rawValue = analogRead(sensor_pin);  
+            int rawValue = HAL::adcRead(sensor_pin);  
             if (rawValue >= 0 && rawValue <= ADC_MAX_VALUE) {
                 sum += rawValue;
                 validSamples++;
@@ -194,7 +199,7 @@ namespace TDSSensor {
         if (validSamples == 0) return 0.0f;
         
         float avgRaw = (float)sum / validSamples;
-        uint32_t voltage_mv = esp_adc_cal_raw_to_voltage((uint32_t)avgRaw, &adc_chars);
+        uint32_t voltage_mv = HAL::adcToMilliVolts((uint32_t)avgRaw, &adc_chars);
         
         // Aplicar offset calibrado directamente
         float voltage_v = (voltage_mv / 1000.0f) - voltageOffset;
@@ -299,17 +304,10 @@ namespace TDSSensor {
         // Configurar ADC con calibración ESP32
         //resolución de 12bits
         //atenuación de 6db para medir hasta 2.2V (el sensor puede entregar hasta 2.0V)
-        analogReadResolution(ADC_BITS);
-        analogSetPinAttenuation(sensor_pin, ADC_6db); 
+        HAL::adcConfigure(sensor_pin, ADC_BITS, HAL::AdcAtten::DB_6);
         
         // Calibrar ADC específico para ESP32
-        esp_adc_cal_value_t val_type = esp_adc_cal_characterize(
-            ADC_UNIT_1,
-            ADC_ATTEN_DB_6,
-            ADC_WIDTH_BIT_13,
-            ADC_VREF,
-            &adc_chars
-        );
+        HAL::adcCalibrate(&adc_chars, HAL::AdcAtten::DB_6, 13, ADC_VREF);
         
         initialized = true;
         last_reading_time = millis();
@@ -362,7 +360,7 @@ namespace TDSSensor {
         TDSReading reading = {0};
         
         if (!initialized) {
-            Serial.println(" Sensor TDS no inicializado");
+            LOG_W(TAG, " Sensor TDS no inicializado");
             reading.valid = false;
             reading.sensor_status = TDS_STATUS_INVALID_READING;
             return reading;
@@ -385,7 +383,7 @@ namespace TDSSensor {
         
         // Verificar timeout
         if (millis() - start_time > TDS_OPERATION_TIMEOUT) {
-            Serial.println(" Timeout en lectura de sensor TDS");
+            LOG_W(TAG, " Timeout en lectura de sensor TDS");
             
             if (error_logger) {
                 error_logger(1, 1, millis() - start_time); // ERROR_SENSOR_TIMEOUT, SEVERITY_WARNING
@@ -406,10 +404,10 @@ namespace TDSSensor {
         if (!isVoltageInRange(voltage)) {
             if (voltage < MIN_VALID_VOLTAGE) {
                 reading.sensor_status = TDS_STATUS_VOLTAGE_LOW;
-                Serial.printf(" Voltaje TDS muy bajo: %.3fV\n", voltage);
+                LOG_W(TAG, " Voltaje TDS muy bajo: %.3fV", voltage);
             } else {
                 reading.sensor_status = TDS_STATUS_VOLTAGE_HIGH;
-                Serial.printf(" Voltaje TDS muy alto: %.3fV\n", voltage);
+                LOG_W(TAG, " Voltaje TDS muy alto: %.3fV", voltage);
             }
             
             reading.valid = false;
@@ -444,8 +442,8 @@ namespace TDSSensor {
             
             last_reading_time = millis();
             
-            Serial.printf(" TDS: %.1f ppm | EC: %.1f µS/cm | V: %.3fV | T: %.1f°C (%.0f ms)\n", 
-                         tds, ec, voltage + voltageOffset, temperature, millis() - start_time);
+            LOG_I(TAG, " TDS: %.1f ppm | EC: %.1f µS/cm | V: %.3fV | T: %.1f°C (%lu ms)", 
+                         tds, ec, voltage + voltageOffset, temperature, (unsigned long)(millis() - start_time));
         } else {
             reading.tds_value = 0.0;
             reading.ec_value = 0.0;
@@ -460,7 +458,7 @@ namespace TDSSensor {
                 (*total_readings_counter)--;
             }
             
-            Serial.printf(" Lectura TDS inválida: %.1f ppm (EC: %.1f µS/cm)\n", tds, ec);
+            LOG_W(TAG, " Lectura TDS inválida: %.1f ppm (EC: %.1f µS/cm)", tds, ec);
         }
         
         last_reading = reading;
@@ -481,30 +479,30 @@ namespace TDSSensor {
     void debugVoltageReading() {
     if (!initialized) return;
     
-    Serial.println(" === DEBUG VOLTAJE TDS ===");
+    LOG_I(TAG, " === DEBUG VOLTAJE TDS ===");
     
     // Leer voltaje crudo (SIN offset)
     long sum = 0;
     for (int i = 0; i < SAMPLES; i++) {
-        sum += analogRead(sensor_pin);
+        sum += HAL::adcRead(sensor_pin);
         delayMicroseconds(1000);
     }
     
     float avgRaw = (float)sum / SAMPLES;
-    uint32_t voltage_mv = esp_adc_cal_raw_to_voltage((uint32_t)avgRaw, &adc_chars);
+    uint32_t voltage_mv = HAL::adcToMilliVolts((uint32_t)avgRaw, &adc_chars);
     float voltajeCrudo = voltage_mv / 1000.0f;
     
-    Serial.printf("Voltaje crudo (sin offset): %.6fV\n", voltajeCrudo);
-    Serial.printf("Offset actual: %.6fV\n", voltageOffset);
-    Serial.printf("Voltaje final: %.6fV\n", voltajeCrudo - voltageOffset);
+    LOG_I(TAG, "Voltaje crudo (sin offset): %.6fV", voltajeCrudo);
+    LOG_I(TAG, "Offset actual: %.6fV", voltageOffset);
+    LOG_I(TAG, "Voltaje final: %.6fV", voltajeCrudo - voltageOffset);
     
     if (voltajeCrudo - voltageOffset < 0) {
-        Serial.println(" PROBLEMA: Offset demasiado alto!");
+        LOG_W(TAG, " PROBLEMA: Offset demasiado alto!");
         float offsetSugerido = voltajeCrudo * 0.8f;  
-        Serial.printf("   Offset sugerido: %.6fV\n", offsetSugerido);
+        LOG_I(TAG, "   Offset sugerido: %.6fV", offsetSugerido);
     }
     
-    Serial.println("==============================");
+    LOG_I(TAG, "==============================");
 }
     // ——— FUNCIONES DE CALIBRACIÓN  ———
     
@@ -519,7 +517,7 @@ namespace TDSSensor {
     void setCalibration(float kVal, float vOffset) {
         kValue = kVal;
         voltageOffset = vOffset;
-        Serial.printf(" Calibración TDS actualizada: k=%.6f, offset=%.6fV\n", kValue, voltageOffset);
+        LOG_I(TAG, " Calibración TDS actualizada: k=%.6f, offset=%.6fV", kValue, voltageOffset);
     }
     
     /**
@@ -546,10 +544,28 @@ namespace TDSSensor {
     void resetToDefaultCalibration() {
         kValue = TDS_CALIBRATED_KVALUE;
         voltageOffset = TDS_CALIBRATED_VOFFSET;
-        Serial.printf(" Calibración restaurada a valores por defecto: k=%.6f, offset=%.6fV\n", 
+        LOG_I(TAG, " Calibración restaurada a valores por defecto: k=%.6f, offset=%.6fV", 
                      kValue, voltageOffset);
     }
     
+    /**
+     * @brief Mide el voltaje crudo para un punto de calibración
+     * @return Voltaje crudo en V, o NAN si el sensor no está inicializado
+     */
+    float measureVoltage() {
+        if (!initialized) return NAN;
+        return readCalibratedVoltage() + voltageOffset;
+    }
+    
+    /**
+     * @brief TDS con kValue = 1 para un voltaje crudo, offset y temperatura dados
+     * @return TDS base en ppm
+     */
+    float baseTDSFromVoltage(float rawVoltage, float vOffset, float temperature) {
+        float compensated = compensateTemperature(rawVoltage - vOffset, temperature);
+        return calculateECRaw(compensated) * TDS_FACTOR;
+    }
+    
     // ——— FUNCIONES DE ESTADO ———
     
     /**
@@ -610,20 +626,20 @@ namespace TDSSensor {
      */
     void printLastReading() {
         if (last_reading.reading_number == 0) {
-            Serial.println("📊 No hay lecturas TDS previas");
+            LOG_I(TAG, "📊 No hay lecturas TDS previas");
             return;
         }
         
-        Serial.println("📊 --- ÚLTIMA LECTURA TDS ---");
-        Serial.printf("Lectura #%d\n", last_reading.reading_number);
-        Serial.printf("TDS: %.1f ppm\n", last_reading.tds_value);
-        Serial.printf("EC: %.1f µS/cm\n", last_reading.ec_value);
-        Serial.printf("Temperatura: %.1f °C\n", last_reading.temperature);
-        Serial.printf("Timestamp: %u ms\n", last_reading.timestamp);
-        Serial.printf("Estado: 0x%02X (%s)\n", 
+        LOG_I(TAG, "📊 --- ÚLTIMA LECTURA TDS ---");
+        LOG_I(TAG, "Lectura #%d", last_reading.reading_number);
+        LOG_I(TAG, "TDS: %.1f ppm", last_reading.tds_value);
+        LOG_I(TAG, "EC: %.1f µS/cm", last_reading.ec_value);
+        LOG_I(TAG, "Temperatura: %.1f °C", last_reading.temperature);
+        LOG_I(TAG, "Timestamp: %u ms", last_reading.timestamp);
+        LOG_I(TAG, "Estado: 0x%02X (%s)", 
                      last_reading.sensor_status,
                      last_reading.valid ? "VÁLIDA" : "INVÁLIDA");
-        Serial.println("---------------------------");
+        LOG_I(TAG, "---------------------------");
     }
     
     /**
@@ -653,10 +669,38 @@ namespace TDSSensor {
         return (voltage >= MIN_VALID_VOLTAGE && voltage <= MAX_VALID_VOLTAGE && !isnan(voltage));
     }
     
+    /// Nombres indexados por WaterQuality
+    static const char* const WATER_QUALITY_NAMES[] = {
+        "Muy pura", "Excelente", "Buena", "Aceptable", "Pobre", "Muy pobre"
+    };
+
+    /**
+     * @brief Clasifica el TDS en una clase de calidad (sin asignar memoria)
+     * @param tds Valor TDS en ppm
+     * @return Clase de calidad WaterQuality
+     */
+    WaterQuality classifyWaterQuality(float tds) {
+        if (tds < 50) return QUALITY_VERY_PURE;
+        else if (tds < 150) return QUALITY_EXCELLENT;
+        else if (tds < 300) return QUALITY_GOOD;
+        else if (tds < 500) return QUALITY_ACCEPTABLE;
+        else if (tds < 900) return QUALITY_POOR;
+        else return QUALITY_VERY_POOR;
+    }
+
+    /**
+     * @brief Nombre legible de una clase de calidad
+     * @param quality Clase devuelta por classifyWaterQuality()
+     * @return Literal estático (no liberar)
+     */
+    const char* waterQualityName(WaterQuality quality) {
+        return quality <= QUALITY_VERY_POOR ? WATER_QUALITY_NAMES[quality] : "Desconocida";
+    }
+
     /**
      * @brief Clasifica la calidad del agua según su TDS
      * @param tds Valor TDS a clasificar en ppm
-     * @return String descriptivo de la calidad del agua:
+     * @return Literal estático descriptivo de la calidad del agua:
      *         - "Muy pura" (TDS < 50 ppm) - Agua destilada/osmosis inversa
      *         - "Excelente" (50 ≤ TDS < 150 ppm) - Agua embotellada premium
      *         - "Buena" (150 ≤ TDS < 300 ppm) - Agua potable de calidad
@@ -665,13 +709,8 @@ namespace TDSSensor {
      *         - "Muy pobre" (TDS ≥ 900 ppm) - No recomendada para consumo
      * @note Clasificación según estándares EPA y OMS para agua potable.
      */
-    String getWaterQuality(float tds) {
-        if (tds < 50) return "Muy pura";
-        else if (tds < 150) return "Excelente";
-        else if (tds < 300) return "Buena";
-        else if (tds < 500) return "Aceptable";
-        else if (tds < 900) return "Pobre";
-        else return "Muy pobre";
+    const char* getWaterQuality(float tds) {
+        return waterQualityName(classifyWaterQuality(tds));
     }
     
     // ——— FUNCIONES DE INTEGRACIÓN ———
@@ -718,22 +757,22 @@ namespace TDSSensor {
      * @note Útil para verificación rápida de configuración y diagnóstico de problemas.
      */
     void showCalibrationInfo() {
-        Serial.println(" === INFORMACIÓN DE CALIBRACIÓN TDS ===");
-        Serial.printf("Estado: %s\n", initialized ? "Inicializado" : "No inicializado");
-        Serial.printf("Pin ADC: %d\n", sensor_pin);
-        Serial.printf("kValue: %.6f (valor calibrado fijo)\n", kValue);
-        Serial.printf("Offset voltaje: %.6fV (valor calibrado fijo)\n", voltageOffset);
-        Serial.printf("TDS Factor: %.1f (EC/%.0f)\n", TDS_FACTOR, 1.0f/TDS_FACTOR);
-        Serial.printf("Coeficientes: A3=%.2f, A2=%.2f, A1=%.2f\n", COEFF_A3, COEFF_A2, COEFF_A1);
+        LOG_I(TAG, " === INFORMACIÓN DE CALIBRACIÓN TDS ===");
+        LOG_I(TAG, "Estado: %s", initialized ? "Inicializado" : "No inicializado");
+        LOG_I(TAG, "Pin ADC: %d", sensor_pin);
+        LOG_I(TAG, "kValue: %.6f (valor calibrado fijo)", kValue);
+        LOG_I(TAG, "Offset voltaje: %.6fV (valor calibrado fijo)", voltageOffset);
+        LOG_I(TAG, "TDS Factor: %.1f (EC/%.0f)", TDS_FACTOR, 1.0f/TDS_FACTOR);
+        LOG_I(TAG, "Coeficientes: A3=%.2f, A2=%.2f, A1=%.2f", COEFF_A3, COEFF_A2, COEFF_A1);
         
         if (last_reading.valid) {
-            Serial.printf("Última lectura: %.1f ppm (%.1f µS/cm) - %s\n", 
+            LOG_I(TAG, "Última lectura: %.1f ppm (%.1f µS/cm) - %s", 
                          last_reading.tds_value, last_reading.ec_value,
-                         getWaterQuality(last_reading.tds_value).c_str());
+                         getWaterQuality(last_reading.tds_value));
         } else {
-            Serial.println("Sin lecturas válidas recientes");
+            LOG_I(TAG, "Sin lecturas válidas recientes");
         }
-        Serial.println("=========================================");
+        LOG_I(TAG, "=========================================");
     }
     
     /**
@@ -746,31 +785,31 @@ namespace TDSSensor {
      */
     void testReading() {
         if (!initialized) {
-            Serial.println(" Sensor no inicializado");
+            LOG_W(TAG, " Sensor no inicializado");
             return;
         }
         
-        Serial.println(" === TEST LECTURA TDS ===");
+        LOG_I(TAG, " === TEST LECTURA TDS ===");
         
         float voltage = readCalibratedVoltage();
-        Serial.printf("Voltaje calibrado: %.6fV\n", voltage);
-        Serial.printf("Voltaje crudo estimado: %.6fV\n", voltage + voltageOffset);
+        LOG_I(TAG, "Voltaje calibrado: %.6fV", voltage);
+        LOG_I(TAG, "Voltaje crudo estimado: %.6fV", voltage + voltageOffset);
         
         if (isVoltageInRange(voltage)) {
             float compensated = compensateTemperature(voltage, 25.0f);
             float ec = calculateEC(compensated);
             float tds = calculateTDS(ec);
             
-            Serial.printf("Voltaje compensado: %.6fV\n", compensated);
-            Serial.printf("EC calculado: %.1f µS/cm\n", ec);
-            Serial.printf("TDS calculado: %.1f ppm\n", tds);
-            Serial.printf("Calidad: %s\n", getWaterQuality(tds).c_str());
+            LOG_I(TAG, "Voltaje compensado: %.6fV", compensated);
+            LOG_I(TAG, "EC calculado: %.1f µS/cm", ec);
+            LOG_I(TAG, "TDS calculado: %.1f ppm", tds);
+            LOG_I(TAG, "Calidad: %s", getWaterQuality(tds));
         } else {
-            Serial.printf(" Voltaje fuera de rango válido (%.3f-%.3fV)\n", 
+            LOG_W(TAG, " Voltaje fuera de rango válido (%.3f-%.3fV)", 
                          MIN_VALID_VOLTAGE, MAX_VALID_VOLTAGE);
         }
         
-        Serial.println("========================");
+        LOG_I(TAG, "========================");
     }
     
 } // namespace TDSSensor
\ No newline at end of file
@@ -14,7 +14,7 @@
 #define TDS_SENSOR_H
 
 #include <Arduino.h>
-#include <esp_adc_cal.h>
+#include "HAL.h"
 
 // ——— Configuración del sensor TDS ———
 
@@ -283,6 +283,27 @@ namespace TDSSensor {
      * @note Imprime confirmación en Serial.
      */
     void resetToDefaultCalibration();
+
+    /**
+     * @brief Mide el voltaje crudo del sensor (sin restar voltageOffset)
+     * @details Registra la entrada de un punto de calibración independiente del offset
+     *          vigente, de modo que el ajuste pueda reevaluarse con otro offset.
+     * @return Voltaje crudo en V, o NAN si el sensor no está inicializado
+     * @warning Función bloqueante por ~30ms.
+     */
+    float measureVoltage();
+
+    /**
+     * @brief TDS que produciría kValue = 1 para un voltaje crudo dado
+     * @details Aplica el mismo modelo que takeReading(): resta de offset,
+     *          compensación de temperatura, polinomio GravityTDS y factor EC→TDS.
+     *          Como TDS = kValue × tdsBase, sirve de regresor para ajustar kValue.
+     * @param rawVoltage Voltaje crudo medido (V)
+     * @param vOffset Offset de voltaje a aplicar (V)
+     * @param temperature Temperatura de la solución (°C)
+     * @return TDS base en ppm
+     */
+    float baseTDSFromVoltage(float rawVoltage, float vOffset, float temperature);
     
     // ——— Funciones de estado ———
 
@@ -353,10 +374,37 @@ namespace TDSSensor {
      */
     bool isVoltageInRange(float voltage);
 
+    /**
+     * @enum WaterQuality
+     * @brief Clases de calidad del agua según TDS (ver getWaterQuality())
+     */
+    enum WaterQuality : uint8_t {
+        QUALITY_VERY_PURE = 0, ///< TDS < 50 ppm
+        QUALITY_EXCELLENT,     ///< 50 ≤ TDS < 150 ppm
+        QUALITY_GOOD,          ///< 150 ≤ TDS < 300 ppm
+        QUALITY_ACCEPTABLE,    ///< 300 ≤ TDS < 500 ppm
+        QUALITY_POOR,          ///< 500 ≤ TDS < 900 ppm
+        QUALITY_VERY_POOR      ///< TDS ≥ 900 ppm
+    };
+
+    /**
+     * @brief Clasifica el TDS en una clase de calidad (sin asignar memoria)
+     * @param tds Valor TDS en ppm
+     * @return Clase de calidad WaterQuality
+     */
+    WaterQuality classifyWaterQuality(float tds);
+
+    /**
+     * @brief Nombre legible de una clase de calidad
+     * @param quality Clase devuelta por classifyWaterQuality()
+     * @return Literal estático (no liberar)
+     */
+    const char* waterQualityName(WaterQuality quality);
+
     /**
      * @brief Clasifica la calidad del agua según su TDS
      * @param tds Valor TDS a clasificar en ppm
-     * @return String descriptivo de la calidad del agua:
+     * @return Literal estático descriptivo de la calidad del agua:
      *         - "Muy pura" (TDS < 50 ppm) - Agua destilada/osmosis inversa
      *         - "Excelente" (50 ≤ TDS < 150 ppm) - Agua embotellada premium
      *         - "Buena" (150 ≤ TDS < 300 ppm) - Agua potable de calidad
@@ -365,7 +413,7 @@ namespace TDSSensor {
      *         - "Muy pobre" (TDS ≥ 900 ppm) - No recomendada para consumo
      * @note Clasificación según estándares EPA y OMS para agua potable.
      */
-    String getWaterQuality(float tds);
+    const char* getWaterQuality(float tds);
     
     // ——— Funciones para integración con sistema principal ———
 
@@ -437,9 +485,9 @@ namespace TDSSensor {
      * @brief Características de calibración del ADC del ESP32
      * @details Estructura que almacena parámetros de calibración específicos del chip
      *          para conversión precisa de valores crudos ADC a voltajes reales (mV).
-     *          Inicializada en initialize() con esp_adc_cal_characterize().
+     *          Inicializada en initialize() con HAL::adcCalibrate().
      */
-    extern esp_adc_cal_characteristics_t adc_chars;
+    extern HAL::AdcCalibration adc_chars;
     
     // ——— Configuración de muestreo ———
 
@@ -3,16 +3,20 @@
  * @brief Implementación del sensor de temperatura DS18B20 para ESP32
  * @details Este archivo contiene la lógica completa para inicialización, lectura
  *          y validación del sensor digital de temperatura DS18B20 usando protocolo
- *          OneWire. Implementa control de timeout, validación de rangos y gestión
- *          dinámica de memoria para los objetos de comunicación.
+ *          OneWire. Implementa control de timeout, validación de rangos y
+ *          almacenamiento estático (sin heap) para los objetos de comunicación.
  * @author Daniel Acosta - Santiago Erazo
  * @date 01/10/2025
  * @version 1.0
  */
 
 #include "Temperatura.h"
+#include "Logger.h"
+#include "Trace.h"
+#include <new>
+
+static const char TAG[] = "TEMP"; ///< Etiqueta de log del módulo
 
-<<<<<<< HEAD
 
 
 /**
@@ -26,10 +30,18 @@ namespace TemperatureSensor {
 
     // ——— Variables internas del módulo ———
     
+    /**
+     * @brief Almacenamiento estático de los objetos del bus (sin heap)
+     * @details initialize() construye los objetos aquí con placement new y cleanup()
+     *          los destruye, de modo que el ciclo no fragmenta el heap.
+     */
+    alignas(OneWire) static uint8_t oneWireStorage[sizeof(OneWire)];
+    alignas(DallasTemperature) static uint8_t sensorsStorage[sizeof(DallasTemperature)];
+
     /**
      * @brief Puntero al objeto OneWire para comunicación con el bus 1-Wire
      * @details Gestiona el protocolo de comunicación de bajo nivel con el sensor DS18B20.
-     *          Se crea dinámicamente en initialize() y se libera en cleanup().
+     *          Se construye en oneWireStorage en initialize() y se destruye en cleanup().
      * @note nullptr cuando no está inicializado. Verificar antes de usar.
      */ 
     OneWire* oneWire = nullptr;
@@ -37,7 +49,7 @@ namespace TemperatureSensor {
     /**
      * @brief Puntero al objeto DallasTemperature para gestión del sensor DS18B20
      * @details Proporciona API de alto nivel para solicitar y leer temperaturas del
-     *          sensor DS18B20. Se crea dinámicamente en initialize() sobre oneWire.
+     *          sensor DS18B20. Se construye en sensorsStorage sobre oneWire.
      * @note nullptr cuando no está inicializado. Verificar antes de usar.
      */
     DallasTemperature* sensors = nullptr;
@@ -49,6 +61,12 @@ namespace TemperatureSensor {
      */
     bool initialized = false;
 
+    /**
+     * @brief Pin GPIO del bus OneWire
+     * @details Identifica el canal del sensor en las trazas de HAL::Trace.
+     */
+    uint8_t sensor_pin = 0;
+
     /**
      * @brief Timestamp de la última lectura válida realizada
      * @details Almacena millis() del momento en que se completó exitosamente una
@@ -78,21 +96,6 @@ namespace TemperatureSensor {
      *          sistema principal. nullptr si no está configurado.
      */
     void (*error_logger)(int code, int severity, uint32_t context) = nullptr;
-=======
-// ——— Variables internas del módulo ———
-namespace TemperatureSensor { // Abre el namespace 'TemperatureSensor' que encapsula todas las variables y funciones del módulo.
-    
-    // Variables del sensor 
-    OneWire* oneWire = nullptr; // Puntero al objeto OneWire que maneja la comunicación 1-Wire con el sensor DS18B20. Inicialmente nulo.
-    DallasTemperature* sensors = nullptr; // Puntero al objeto DallasTemperature (wrapper de OneWire) para operaciones del sensor.
-    bool initialized = false; // Bandera que indica si el sensor ya fue inicializado (true) o no (false).
-    uint32_t last_reading_time = 0; // Marca de tiempo (ms) de la última lectura válida registrada.
-    TemperatureReading last_reading = {0}; // Estructura que guarda la última lectura (timestamp, temperatura, flags, etc.), inicializada a cero.
-    
-    // Punteros a funciones externas
-    uint16_t* total_readings_counter = nullptr; // Puntero opcional a un contador global de lecturas (gestionado por el sistema principal).
-    void (*error_logger)(int code, int severity, uint32_t context) = nullptr; // Puntero a función para registrar errores en el Watchdog/Logger.
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     
     
     
@@ -100,13 +103,12 @@ namespace TemperatureSensor { // Abre el namespace 'TemperatureSensor' que encap
     
     /**
      * @brief Inicializa el sensor de temperatura DS18B20 en el pin especificado
-     * @details Crea dinámicamente objetos OneWire y DallasTemperature, configura el
-     *          bus 1-Wire y prepara el sensor para lecturas. Es seguro llamar múltiples
-     *          veces (verifica si ya está inicializado). Gestiona memoria dinámicamente.
+     * @details Construye los objetos OneWire y DallasTemperature en almacenamiento
+     *          estático, configura el bus 1-Wire y prepara el sensor para lecturas. Es
+     *          seguro llamar múltiples veces (verifica si ya está inicializado).
      * @param pin Pin GPIO del ESP32 para comunicación OneWire (por defecto TEMP_SENSOR_PIN)
      * @return true si inicialización exitosa o ya estaba inicializado, false si error
      * @note Requiere llamarse una vez en setup() antes de usar otras funciones.
-     * @warning Si falla la creación de objetos, libera memoria automáticamente y retorna false.
      * @note El sensor DS18B20 requiere resistencia pull-up de 4.7kΩ en el bus OneWire.
      */
     bool initialize(uint8_t pin) { // Función pública que inicializa los objetos OneWire y DallasTemperature usando el pin indicado.
@@ -118,20 +120,10 @@ namespace TemperatureSensor { // Abre el namespace 'TemperatureSensor' que encap
         
         //Serial.printf(" Inicializando sensor temperatura (pin %d)...\n", pin);
         
-        // Crear objetos 
-        oneWire = new OneWire(pin); // Reserva dinámicamente un objeto OneWire asociado al pin pasado.
-        if (!oneWire) { // Si la asignación falló (puntero nulo)...
-            Serial.println(" Error creando OneWire"); // Informar por consola.
-            return false; // Retornar false para indicar fallo en inicialización.
-        }
-        
-        sensors = new DallasTemperature(oneWire); // Crea el wrapper DallasTemperature que usa el bus OneWire.
-        if (!sensors) { // Si no se pudo crear el wrapper...
-            Serial.println(" Error creando DallasTemperature"); // Imprime error.
-            delete oneWire;  // Libera el objeto OneWire para evitar fuga de memoria.
-            oneWire = nullptr; // Establece puntero a nulo por seguridad.
-            return false; // Retorna false por falla.
-        }
+        // Crear objetos en almacenamiento estático
+        sensor_pin = pin; // Guarda el pin para identificar el canal en las trazas.
+        oneWire = new (oneWireStorage) OneWire(pin); // Construye el objeto OneWire asociado al pin pasado.
+        sensors = new (sensorsStorage) DallasTemperature(oneWire); // Crea el wrapper DallasTemperature que usa el bus OneWire.
         
         // Inicializar sensor
         sensors->begin(); // Inicializa internamente la librería DallasTemperature (detecta dispositivos, prepara bus).
@@ -145,22 +137,22 @@ namespace TemperatureSensor { // Abre el namespace 'TemperatureSensor' que encap
     
     /**
      * @brief Limpia y libera recursos del sensor de temperatura
-     * @details Elimina dinámicamente los objetos DallasTemperature y OneWire,
-     *          liberando memoria heap. Marca el sensor como no inicializado.
+     * @details Destruye los objetos DallasTemperature y OneWire construidos en
+     *          almacenamiento estático. Marca el sensor como no inicializado.
      * @note Es seguro llamar aunque no esté inicializado (verifica punteros).
      * @note Útil para reset de sistema o cambio de configuración.
      */
     void cleanup() { // Función para liberar recursos y poner el módulo en estado limpio/no inicializado.
         if (sensors) { // Si existe objeto DallasTemperature...
-            delete sensors; // Libera el objeto.
+            sensors->~DallasTemperature(); // Destruye el objeto (el almacenamiento es estático).
             sensors = nullptr; // Evita dangling pointer (puntero colgante).
         }
         if (oneWire) {  // Si existe objeto OneWire...
-            delete oneWire; // Libera el objeto.
+            oneWire->~OneWire(); // Destruye el objeto.
             oneWire = nullptr; // Evita puntero colgante.
         }
         initialized = false; // Marca el módulo como no inicializado.
-        Serial.println(" Sensor temperatura limpiado"); // Imprime mensaje informativo.
+        LOG_I(TAG, " Sensor temperatura limpiado"); // Imprime mensaje informativo.
     }
     
     /**
@@ -198,7 +190,7 @@ namespace TemperatureSensor { // Abre el namespace 'TemperatureSensor' que encap
         TemperatureReading reading = {0}; // Inicializa la estructura de lectura a ceros (timestamp, temperatura, flags...).
         
         if (!initialized || !sensors) { // Comprueba que el módulo esté correctamente inicializado y los objetos existan.
-            Serial.println(" Sensor temperatura no inicializado"); // Mensaje de error si no está listo.
+            LOG_W(TAG, " Sensor temperatura no inicializado"); // Mensaje de error si no está listo.
             reading.valid = false; // Marca la lectura como inválida.
             reading.sensor_status = TEMP_STATUS_INVALID_READING; // Establece el código de estado indicando error.
             return reading; // Retorna la estructura con invalid flag.
@@ -215,12 +207,13 @@ namespace TemperatureSensor { // Abre el namespace 'TemperatureSensor' que encap
         // Timeout para operación del sensor 
         uint32_t start_time = millis(); // Marca el tiempo de inicio para comprobar timeout luego.
         
+        HAL::Trace::beginBurst(HAL::Trace::Source::ONEWIRE, sensor_pin); // Marca la lectura en la traza (vacío sin HAL_TRACE).
         sensors->requestTemperatures(); // Instruye al sensor a iniciar la conversión de temperatura (inicio de conversión).
         
         // Verificar timeout 
         while (!sensors->isConversionComplete()) { // Espera activa hasta que la conversión finalice o exceda el timeout.
             if (millis() - start_time > TEMP_OPERATION_TIMEOUT) { // Si el tiempo transcurrido supera el timeout permitido...
-                Serial.println(" Timeout en lectura de sensor"); // Imprime mensaje de timeout.
+                LOG_W(TAG, " Timeout en lectura de sensor"); // Imprime mensaje de timeout.
                 
                 if (error_logger) { // Si hay función registrada para logging de errores...
                     error_logger(1, 1, millis() - start_time); // ERROR_SENSOR_TIMEOUT, SEVERITY_WARNING
@@ -243,6 +236,7 @@ namespace TemperatureSensor { // Abre el namespace 'TemperatureSensor' que encap
         }
         
         float tempC = sensors->getTempCByIndex(0); // Obtiene la temperatura del primer sensor en el bus (índice 0).
+        HAL::Trace::recordOneWire(sensor_pin, tempC); // Anota el valor crudo en la traza (vacío sin HAL_TRACE).
         
         // Validar lectura
         if (tempC != DEVICE_DISCONNECTED_C && tempC > MIN_VALID_TEMP && tempC < MAX_VALID_TEMP) {
@@ -252,7 +246,7 @@ namespace TemperatureSensor { // Abre el namespace 'TemperatureSensor' que encap
             reading.sensor_status = TEMP_STATUS_OK; // Estado OK.
             
             last_reading_time = millis(); // Actualiza la marca de tiempo del último dato válido.
-            Serial.printf(" Temperatura: %.2f °C (%.0f ms)\n", tempC, millis() - start_time);
+            LOG_I(TAG, " Temperatura: %.2f °C (%lu ms)", tempC, (unsigned long)(millis() - start_time));
             // Imprime la temperatura con 2 decimales y el tiempo que tardó la operación.
         } else {
             reading.temperature = 0.0; // En caso de lectura inválida, pone temperatura a 0.0 para indicar fallo.
@@ -269,7 +263,7 @@ namespace TemperatureSensor { // Abre el namespace 'TemperatureSensor' que encap
                 (*total_readings_counter)--; // Revierte el incremento porque la lectura no es válida.
             }
             
-            Serial.printf(" Lectura inválida: %.2f °C\n", tempC); // Imprime por consola la lectura inválida para diagnóstico.
+            LOG_W(TAG, " Lectura inválida: %.2f °C", tempC); // Imprime por consola la lectura inválida para diagnóstico.
         }
         
         // Guardar última lectura
@@ -327,24 +321,18 @@ namespace TemperatureSensor { // Abre el namespace 'TemperatureSensor' que encap
      */
     void printLastReading() { // Función utilitaria para imprimir por consola los detalles de la última lectura.
         if (last_reading.reading_number == 0) { // Función utilitaria para imprimir por consola los detalles de la última lectura.
-            Serial.println(" No hay lecturas previas");
+            LOG_I(TAG, " No hay lecturas previas");
             return; // Sale de la función.
         }
         
-        Serial.println(" --- ÚLTIMA LECTURA TEMPERATURA ---");
-        Serial.printf("Lectura #%d\n", last_reading.reading_number); // Imprime el número de lectura.
-        Serial.printf("Temperatura: %.2f °C\n", last_reading.temperature); // Imprime temperatura
-        Serial.printf("Timestamp: %u ms\n", last_reading.timestamp); // Imprime el timestamp (ms).
-        Serial.printf("Estado: 0x%02X (%s)\n", 
-<<<<<<< HEAD
+        LOG_I(TAG, " --- ÚLTIMA LECTURA TEMPERATURA ---");
+        LOG_I(TAG, "Lectura #%d", last_reading.reading_number); // Imprime el número de lectura.
+        LOG_I(TAG, "Temperatura: %.2f °C", last_reading.temperature); // Imprime temperatura
+        LOG_I(TAG, "Timestamp: %u ms", last_reading.timestamp); // Imprime el timestamp (ms).
+        LOG_I(TAG, "Estado: 0x%02X (%s)", 
                         last_reading.sensor_status,
                         last_reading.valid ? "VÁLIDA" : "INVÁLIDA");
-=======
-                     last_reading.sensor_status,
-                     last_reading.valid ? "VÁLIDA" : "INVÁLIDA");
-                     // Imprime el estado en hex y su interpretación (VÁLIDA o INVÁLIDA).
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
-        Serial.println("---------------------------------------");
+        LOG_I(TAG, "---------------------------------------");
     }
     
     /**
@@ -160,13 +160,12 @@ namespace TemperatureSensor {
 
     /**
      * @brief Inicializa el sensor de temperatura DS18B20 en el pin especificado
-     * @details Crea dinámicamente objetos OneWire y DallasTemperature, configura el bus
-     *          1-Wire y prepara el sensor para lecturas. Es seguro llamar múltiples veces
-     *          (verifica si ya está inicializado). Gestiona memoria dinámicamente.
+     * @details Construye los objetos OneWire y DallasTemperature en almacenamiento estático
+     *          (sin heap), configura el bus 1-Wire y prepara el sensor para lecturas. Es
+     *          seguro llamar múltiples veces (verifica si ya está inicializado).
      * @param pin Pin GPIO del ESP32 para comunicación OneWire (por defecto TEMP_SENSOR_PIN)
      * @return true si inicialización exitosa o ya estaba inicializado, false si error
      * @note Requiere llamarse una vez en setup() antes de usar otras funciones.
-     * @warning Si falla la creación de objetos, libera memoria automáticamente y retorna false.
      * @note El sensor DS18B20 requiere resistencia pull-up externa de 4.7kΩ en el bus OneWire.
      *       Sin pull-up, el sensor no funcionará correctamente (lecturas erróneas o timeouts).
      */
@@ -174,8 +173,8 @@ namespace TemperatureSensor {
 
     /**
      * @brief Limpia y libera recursos del sensor de temperatura
-     * @details Elimina dinámicamente los objetos DallasTemperature y OneWire, liberando
-     *          memoria heap. Marca el sensor como no inicializado.
+     * @details Destruye los objetos DallasTemperature y OneWire (el almacenamiento es
+     *          estático, no se libera heap). Marca el sensor como no inicializado.
      * @note Es seguro llamar aunque no esté inicializado (verifica punteros antes de liberar).
      * @note Útil para reset de sistema, cambio de configuración o liberación de recursos.
      */
@@ -298,7 +297,7 @@ namespace TemperatureSensor {
     /**
      * @brief Puntero al objeto OneWire para comunicación con el bus 1-Wire
      * @details Gestiona el protocolo de comunicación de bajo nivel con el sensor DS18B20.
-     *          Se crea dinámicamente en initialize() y se libera en cleanup().
+     *          Se construye en almacenamiento estático en initialize() y se destruye en cleanup().
      * @note nullptr cuando no está inicializado. Verificar antes de usar.
      */
     extern OneWire* oneWire;
@@ -306,7 +305,7 @@ namespace TemperatureSensor {
     /**
      * @brief Puntero al objeto DallasTemperature para gestión del sensor DS18B20
      * @details Proporciona API de alto nivel para solicitar y leer temperaturas del sensor.
-     *          Se crea dinámicamente en initialize() sobre oneWire.
+     *          Se construye en almacenamiento estático en initialize() sobre oneWire.
      * @note nullptr cuando no está inicializado. Verificar antes de usar.
      */
     extern DallasTemperature* sensors;
@@ -1,4 +1,3 @@
-<<<<<<< HEAD
 /**
  * @file Turbidez.cpp
  * @brief Implementación del sensor de turbidez para ESP32
@@ -12,6 +11,10 @@
  */
 
 #include "Turbidez.h"
+#include "Logger.h"
+#include "Trace.h"
+
+static const char TAG[] = "TURB"; ///< Etiqueta de log del módulo
 
 /**
  * @namespace TurbiditySensor
@@ -59,7 +62,7 @@ namespace TurbiditySensor {
      * @details Estructura que almacena los parámetros de calibración específicos del
      *          chip para convertir valores crudos ADC a voltajes reales (mV).
      */
-    esp_adc_cal_characteristics_t adc_chars;
+    HAL::AdcCalibration adc_chars;
     
     // Coeficientes de calibración
     
@@ -94,6 +97,14 @@ namespace TurbiditySensor {
      * @note Inicializado con CALIB_COEFF_D del header.
      */
     float calib_d = CALIB_COEFF_D;
+
+    /**
+     * @brief Selecciona el modelo de conversión voltaje → NTU
+     * @details false: algoritmo segmentado empírico (por defecto).
+     *          true: polinomio cúbico calib_a..d, activado cuando la curva se ajusta
+     *          en el dispositivo con soluciones patrón (ver CalibrationManager).
+     */
+    bool polynomial_model = false;
     
     // Configuración ADC
 
@@ -152,49 +163,10 @@ namespace TurbiditySensor {
     float readCalibratedVoltage() {
         long sum = 0;
         int validSamples = 0;
-=======
-#include "Turbidez.h" // Incluye el archivo de cabecera asociado (Turbidez.h), 
-                      // donde se definen las estructuras, constantes, prototipos de funciones 
-                      // y macros que este archivo .cpp necesita para compilarse correctamente.
-
-// ——— Variables internas del módulo ———
-namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado TurbiditySensor
-                              // Esto sirve para encapsular todas las variables y funciones del sensor
-                              // evitando conflictos de nombres con otros módulos.
-    
-    // Variables del sensor
-    bool initialized = false;  // Bandera que indica si el sensor ya fue inicializado (true) o no (false).
-    uint8_t sensor_pin = TURBIDITY_SENSOR_PIN; // Pin de entrada analógica donde está conectado el sensor de turbidez.
-    uint32_t last_reading_time = 0; // Almacena el tiempo (en ms) de la última lectura válida del sensor.
-    TurbidityReading last_reading = {0}; // Estructura que guarda la última lectura realizada (se inicializa en 0).
-    esp_adc_cal_characteristics_t adc_chars; // Estructura especial para manejar la calibración del ADC en el ESP32
-    
-    // Coeficientes de calibración 
-    float calib_a = CALIB_COEFF_A; // Coeficiente "a" para la ecuación polinómica de calibración del sensor.
-    float calib_b = CALIB_COEFF_B; // Coeficiente "b".
-    float calib_c = CALIB_COEFF_C; // Coeficiente "c".
-    float calib_d = CALIB_COEFF_D; // Coeficiente "d".
-    
-    // Configuración ADC
-    const int ADC_BITS = 12; // Resolución del ADC en bits (12 bits → valores entre 0 y 4095).
-    const int ADC_MAX_VALUE = 4095; // Valor máximo que puede devolver el ADC de 12 bits.
-    const int ADC_VREF = 1100; // Voltaje de referencia del ADC (en milivoltios). Por defecto ~1100 mV en ESP32.
-    
-    // Variables de integración con sistema principal
-    uint16_t* total_readings_counter = nullptr; // Puntero a un contador global de lecturas (se usa si se conecta al sistema).
-    void (*error_logger)(int code, int severity, uint32_t context) = nullptr; 
-    // Puntero a función para registrar errores en el sistema principal. Recibe: código, severidad y contexto.
-
-    
-    // ——— FUNCIONES INTERNAS ———
-    
-    float readCalibratedVoltage() { // Función interna para leer el voltaje promedio del sensor ya calibrado.
-        long sum = 0; // Acumulador de todas las muestras del ADC.
-        int validSamples = 0; // Contador de cuántas muestras fueron válidas.
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
+        HAL::Trace::beginBurst(HAL::Trace::Source::ADC, sensor_pin);
         
         for (int i = 0; i < SAMPLES; i++) { // Bucle que toma varias muestras para mejorar estabilidad.
-            int rawValue = analogRead(sensor_pin); // Lee el valor crudo (sin calibración) del ADC en el pin del sensor.
+            int rawValue = HAL::adcRead(sensor_pin); // Lee el valor crudo (sin calibración) del ADC en el pin del sensor.
             if (rawValue >= 0 && rawValue <= ADC_MAX_VALUE) { // Verifica que la lectura esté dentro del rango válido.
                 sum += rawValue; // Acumula el valor válido.
                 validSamples++; // Aumenta el número de muestras válidas.
@@ -205,7 +177,7 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
         if (validSamples == 0) return 0.0f; // Si no hubo ninguna muestra válida, retorna 0.0 (error en lectura).
         
         float avgRaw = (float)sum / validSamples; // Calcula el valor promedio de las lecturas válidas.
-        uint32_t voltage_mv = esp_adc_cal_raw_to_voltage((uint32_t)avgRaw, &adc_chars);
+        uint32_t voltage_mv = HAL::adcToMilliVolts((uint32_t)avgRaw, &adc_chars);
         // Convierte el valor promedio del ADC a milivoltios usando la calibración propia del ESP32.
         
         // Convertir a voltios
@@ -216,7 +188,6 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
     
     // ——— IMPLEMENTACIÓN DE FUNCIONES PÚBLICAS ———
     
-<<<<<<< HEAD
     /**
      * @brief Inicializa el sensor de turbidez en el pin ADC especificado
      * @details Configura el ADC con:
@@ -233,11 +204,6 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
      */
     bool initialize(uint8_t pin) {
         if (initialized) {
-=======
-    bool initialize(uint8_t pin) { // Función para inicializar el sensor en el pin especificado.
-        if (initialized) {// Si el sensor ya estaba inicializado previamente...
-        //Serial.println(" Sensor turbidez ya inicializado"); // Mensaje opcional de depuración.
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
             //Serial.println(" Sensor turbidez ya inicializado");
             return true;
         }
@@ -248,18 +214,12 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
 
         
         // Configurar ADC con calibración ESP32
-        analogReadResolution(ADC_BITS); // Se establece la resolución de lectura del ADC (12 bits en este caso).
-        analogSetPinAttenuation(sensor_pin, ADC_11db); 
-        // Se configura la atenuación del pin analógico (ADC_11db → rango aprox. 0 - 3.6V en ESP32).
+        HAL::adcConfigure(sensor_pin, ADC_BITS, HAL::AdcAtten::DB_12);
+        // Se fija la resolución de lectura (12 bits) y la atenuación del pin (ADC_11db → rango aprox. 0 - 3.6V en ESP32).
   
         // Calibrar ADC específico para ESP32
-        esp_adc_cal_value_t val_type = esp_adc_cal_characterize(
-            ADC_UNIT_1, // Se usa la unidad ADC #1 del ESP32.
-            ADC_ATTEN_DB_12, // Se establece la atenuación en 12 dB (permite hasta ~3.6V).
-            ADC_WIDTH_BIT_13, // Se fija el ancho en 13 bits para caracterización (aunque resol. es 12 bits).
-            ADC_VREF, // Se usa el valor de referencia definido (1100 mV).
-            &adc_chars // Se pasa la estructura para guardar los parámetros calibrados.
-        );
+        HAL::adcCalibrate(&adc_chars, HAL::AdcAtten::DB_12, 13, ADC_VREF);
+        // Unidad ADC #1, atenuación de 12 dB y 13 bits de caracterización (aunque la resolución es 12 bits), Vref de 1100 mV.
         
         initialized = true; // Marca el sensor como inicializado.
         last_reading_time = millis(); // Registra el tiempo de inicialización como último tiempo de lectura.
@@ -268,7 +228,6 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
         return true; // Retorna true indicando que la inicialización fue exitosa.
     }
     
-<<<<<<< HEAD
     /**
      * @brief Limpia y deshabilita el sensor de turbidez
      * @details Marca el sensor como no inicializado, permitiendo reinicialización.
@@ -313,22 +272,9 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
      */
     TurbidityReading takeReadingWithTimeout() {
         TurbidityReading reading = {0};
-=======
-    void cleanup() { // Función para "limpiar" el estado del sensor
-        initialized = false; // Marca el sensor como no inicializado.
-        //Serial.println(" Sensor turbidez limpiado");
-    }
-    
-    TurbidityReading takeReading() { // Función para tomar una lectura simple del sensor.   
-        return takeReadingWithTimeout(); // En realidad llama a la función más completa que incluye timeout.
-    }
-    
-    TurbidityReading takeReadingWithTimeout() { // Función principal que realiza la lectura del sensor con validaciones. 
-        TurbidityReading reading = {0}; // Se crea una nueva estructura de lectura y se inicializa en cero.
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
         
         if (!initialized) { // Si el sensor no está inicializado...     
-            Serial.println(" Sensor turbidez no inicializado");
+            LOG_W(TAG, " Sensor turbidez no inicializado");
             reading.valid = false; // Marca la lectura como inválida.
             reading.sensor_status = TURBIDITY_STATUS_INVALID_READING; // Estado de lectura inválida
             return reading; // Retorna de inmediato la lectura inválida
@@ -350,7 +296,7 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
         
         // Verificar timeout
         if (millis() - start_time > TURBIDITY_OPERATION_TIMEOUT) { // Si el tiempo de lectura supera el límite permitido...
-            Serial.println(" Timeout en lectura de sensor turbidez");
+            LOG_W(TAG, " Timeout en lectura de sensor turbidez");
             
             if (error_logger) { // Si existe un logger de errores definido...
                 error_logger(1, 1, millis() - start_time); // ERROR_SENSOR_TIMEOUT, SEVERITY_WARNING. (Se reporta un error (código 1, severidad 1, con el tiempo excedido como contexto).)
@@ -371,10 +317,10 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
         if (!isVoltageInRange(voltage)) { // Si el voltaje medido no está dentro del rango válido...
             if (voltage < MIN_VALID_VOLTAGE) { // Si es demasiado bajo...
                 reading.sensor_status = TURBIDITY_STATUS_VOLTAGE_LOW; // Estado: voltaje bajo.
-                Serial.printf(" Voltaje turbidez muy bajo: %.3fV\n", voltage);
+                LOG_W(TAG, " Voltaje turbidez muy bajo: %.3fV", voltage);
             } else { // Si es demasiado alto...
                 reading.sensor_status = TURBIDITY_STATUS_VOLTAGE_HIGH; // Estado: voltaje alto.
-                Serial.printf(" Voltaje turbidez muy alto: %.3fV\n", voltage);
+                LOG_W(TAG, " Voltaje turbidez muy alto: %.3fV", voltage);
             }
             
             reading.valid = false; // Lectura inválida.
@@ -407,30 +353,20 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
             
             last_reading_time = millis(); // Actualiza la variable con el tiempo (ms) en que se tomó la lectura
             
-<<<<<<< HEAD
-            Serial.printf(" Turbidez: %.1f NTU | V: %.3fV | %s (%.3f ms)\n", 
-                        ntu, voltage, getWaterQuality(ntu).c_str(), millis() - start_time);
+            LOG_I(TAG, " Turbidez: %.1f NTU | V: %.3fV | %s (%lu ms)", 
+                        ntu, voltage, getWaterQuality(ntu), (unsigned long)(millis() - start_time));
         } else {
             reading.turbidity_ntu = 0.0;
             reading.voltage = voltage;
             reading.valid = false;
-=======
-            Serial.printf(" Turbidez: %.1f NTU | V: %.3fV | %s (%.0f ms)\n", 
-                         ntu, voltage, getWaterQuality(ntu).c_str(), millis() - start_time);
-            // Imprime en consola: el valor de NTU, el voltaje, la etiqueta de calidad y el tiempo que tomó la operación.
-        } else { // Rama ejecutada si la NTU calculada NO está dentro del rango válido
-            reading.turbidity_ntu = 0.0; // Para seguridad, asigna 0.0 al campo NTU (no confiar en el valor)
-            reading.voltage = voltage; // Sigue guardando el voltaje leído para diagnósticos posteriores
-            reading.valid = false; // Marca la lectura como inválida (no la consideraremos fiable)
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
             
             if (ntu > MAX_VALID_NTU) { // Si el valor calculado excede el límite máximo definido...
                 reading.sensor_status = TURBIDITY_STATUS_OVERFLOW; // Marca como desbordamiento/overflow
-                Serial.printf(" Turbidez fuera de rango: %.1f NTU (máximo: %.0f)\n", ntu, MAX_VALID_NTU);
+                LOG_W(TAG, " Turbidez fuera de rango: %.1f NTU (máximo: %.0f)", ntu, MAX_VALID_NTU);
                 // Imprime aviso indicando que la turbidez excede el máximo esperado.
             } else {
                 reading.sensor_status = TURBIDITY_STATUS_INVALID_READING; // Otro tipo de lectura inválida
-                Serial.printf(" Lectura turbidez inválida: %.1f NTU\n", ntu); // Imprime que la lectura es inválida 
+                LOG_W(TAG, " Lectura turbidez inválida: %.1f NTU", ntu); // Imprime que la lectura es inválida 
             }
             
             if (error_logger) {
@@ -450,7 +386,6 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
     }
     
     // ——— FUNCIONES DE CALIBRACIÓN ———
-<<<<<<< HEAD
 
     /**
      * @brief Convierte voltaje medido a turbidez en NTU usando algoritmo segmentado
@@ -463,8 +398,8 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
      * @return Turbidez en NTU (Nephelometric Turbidity Units). Mínimo 0 NTU.
      * @note El algoritmo segmentado mejora linealidad en rangos extremos donde
      *       el polinomio cúbico pierde precisión.
-     * @warning Los coeficientes del polinomio cúbico (calib_a/b/c/d) actualmente NO
-     *          se usan en esta implementación. Se conservan para compatibilidad futura.
+     * @note Si polynomial_model está activo se devuelve directamente el polinomio
+     *       cúbico calib_a..d (curva ajustada con soluciones patrón).
      */
     float voltageToNTU(float voltage) {
         
@@ -475,35 +410,18 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
                     calib_b * v * v + 
                     calib_c * v + 
                     calib_d;
-=======
-    
-    float voltageToNTU(float voltage) { // Función central que mapea voltaje (V) → turbidez (NTU)
-        
-        // Aplicar ecuación polinómica cúbica calibrada
-        // NTU = a*V³ + b*V² + c*V + d
-        float v = voltage; // Copia local: valor del voltaje para facilitar lectura
-        float ntu = calib_a * v * v * v +  // Evalúa el polinomio de grado 3 con coeficientes calibrados
-                   calib_b * v * v + 
-                   calib_c * v + 
-                   calib_d;
-        // Resultado inicial de la curva cúbica (puede ser corregido por secciones siguientes).           
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
         
         // Asegurar que NTU no sea negativo
         if (ntu < 0) ntu = 0; // Si por la curva polinómica sale negativo (no tiene sentido físico), lo corrige a 0
+        if (polynomial_model) return ntu; // Curva ajustada en campo: no aplicar segmentos empíricos
         
-<<<<<<< HEAD
         // Segmento 1: Agua muy clara (V > 2.15V → 0-10 NTU)
         if (voltage > 2.15f) {
-=======
-        if (voltage > 2.15f) { // Caso: voltaje alto (extremo superior) — regla empírica para saturación
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
             ntu = 3000.0f * (2.2f - voltage) / (2.2f - 0.65f);
             // Mapeo alternativo en tramo superior: evita resultados no físicos y aproxima comportamiento en saturación
             if (ntu < 0) ntu = 0; // Protege de valores negativos tras la transformación    
             if (ntu > 10) ntu = 10; // Limita el tramo superior a 10 NTU (ajuste empírico usado por el autor)
         }
-<<<<<<< HEAD
         // Segmento 2: Agua muy turbia (V < 0.7V → >1000 NTU)
         else if (voltage < 0.7f) {
             ntu = 1000.0f + (0.7f - voltage) * 2000.0f;
@@ -511,14 +429,6 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
         }
         // Segmento 3: Rango medio (0.7V ≤ V ≤ 2.15V → 10-1500 NTU)
         else {
-=======
-        else if (voltage < 0.7f) { // Caso: voltaje muy bajo (extremo inferior)
-            ntu = 1000.0f + (0.7f - voltage) * 2000.0f; 
-            // Si el voltaje cae por debajo de 0.7V, la función fuerza un incremento fuerte (valores grandes de NTU)
-            if (ntu > 3000) ntu = 3000;  // Límite superior absoluto en este tramo (corresponde al rango máximo del sensor)
-        }
-        else { // Caso intermedio (0.7V .. ~2.15V) — tramo "principal"
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
             ntu = 1500.0f * (2.18f - voltage) / (2.18f - 0.65f);
             // Mapeo intermedio lineal/afín ajustado empíricamente para este rango
             if (ntu < 0) ntu = 0; // Protección: nunca devolver NTU negativo
@@ -546,21 +456,16 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
      * @param c Coeficiente lineal
      * @param d Término independiente
      * @note Imprime confirmación de cambios en Serial.
-     * @warning NOTA IMPORTANTE: Los coeficientes actualizados NO se usan en voltageToNTU()
-     *          que implementa algoritmo segmentado. Conservados para compatibilidad futura.
+     * @warning Los coeficientes solo se usan en voltageToNTU() si el modelo polinómico
+     *          está activo (ver setPolynomialModel()).
      */
     void setCalibrationCoefficients(float a, float b, float c, float d) {
         calib_a = a; // Asigna coeficiente cúbico 'a' desde parámetros externos
         calib_b = b; // Asigna 'b'
         calib_c = c; // Asigna 'c'
         calib_d = d; // Asigna 'd'
-        Serial.printf(" Calibración turbidez actualizada: a=%.1f, b=%.1f, c=%.1f, d=%.1f\n", 
-<<<<<<< HEAD
+        LOG_I(TAG, " Calibración turbidez actualizada: a=%.1f, b=%.1f, c=%.1f, d=%.1f", 
                     calib_a, calib_b, calib_c, calib_d);
-=======
-                     calib_a, calib_b, calib_c, calib_d);
-        // Imprime los nuevos coeficientes para verificación. Útil tras cargar calibración desde PC/usuario.
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
     }
     
     /**
@@ -588,10 +493,35 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
         calib_b = CALIB_COEFF_B; // Restaura 'b'
         calib_c = CALIB_COEFF_C; // Restaura 'c'
         calib_d = CALIB_COEFF_D; // Restaura 'd'
-        Serial.printf(" Calibración turbidez restaurada a valores por defecto\n"); 
+        LOG_I(TAG, " Calibración turbidez restaurada a valores por defecto"); 
         // Mensaje para confirmar que se ha revertido la calibración a los parámetros de fábrica/proyecto.
     }
     
+    /**
+     * @brief Activa o desactiva el modelo polinómico en voltageToNTU()
+     * @param enabled true para usar calib_a..d, false para el algoritmo segmentado
+     */
+    void setPolynomialModel(bool enabled) {
+        polynomial_model = enabled;
+    }
+    
+    /**
+     * @brief Consulta el modelo de conversión activo
+     * @return true si voltageToNTU() usa el polinomio cúbico
+     */
+    bool isPolynomialModel() {
+        return polynomial_model;
+    }
+    
+    /**
+     * @brief Mide el voltaje promediado para un punto de calibración
+     * @return Voltaje en V, o NAN si el sensor no está inicializado
+     */
+    float measureVoltage() {
+        if (!initialized) return NAN;
+        return readCalibratedVoltage();
+    }
+    
     // ——— FUNCIONES DE ESTADO ———
     
     /**
@@ -653,29 +583,23 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
      */
     void printLastReading() {
         if (last_reading.reading_number == 0) {
-            Serial.println(" No hay lecturas turbidez previas"); // Mensaje si nunca se registró lectura
+            LOG_I(TAG, " No hay lecturas turbidez previas"); // Mensaje si nunca se registró lectura
             return;
         }
         
-        Serial.println(" --- ÚLTIMA LECTURA TURBIDEZ ---");
-        Serial.printf("Lectura #%d\n", last_reading.reading_number);
-        Serial.printf("Turbidez: %.1f NTU\n", last_reading.turbidity_ntu);
-        Serial.printf("Voltaje: %.3fV\n", last_reading.voltage);
-        Serial.printf("Timestamp: %u ms\n", last_reading.timestamp);
-        Serial.printf("Estado: 0x%02X (%s)\n", 
-<<<<<<< HEAD
+        LOG_I(TAG, " --- ÚLTIMA LECTURA TURBIDEZ ---");
+        LOG_I(TAG, "Lectura #%d", last_reading.reading_number);
+        LOG_I(TAG, "Turbidez: %.1f NTU", last_reading.turbidity_ntu);
+        LOG_I(TAG, "Voltaje: %.3fV", last_reading.voltage);
+        LOG_I(TAG, "Timestamp: %u ms", last_reading.timestamp);
+        LOG_I(TAG, "Estado: 0x%02X (%s)", 
                     last_reading.sensor_status,
                     last_reading.valid ? "VÁLIDA" : "INVÁLIDA");
-=======
-                     last_reading.sensor_status,
-                     last_reading.valid ? "VÁLIDA" : "INVÁLIDA");
-        // Muestra estado en hexadecimal y su interpretación (VÁLIDA/INVÁLIDA)
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
-        Serial.printf("Calidad: %s\n", getWaterQuality(last_reading.turbidity_ntu).c_str());
+        LOG_I(TAG, "Calidad: %s", getWaterQuality(last_reading.turbidity_ntu));
         // Muestra una etiqueta cualitativa de calidad basada en NTU 
-        Serial.printf("Categoría: %s\n", getTurbidityCategory(last_reading.turbidity_ntu).c_str());
+        LOG_I(TAG, "Categoría: %s", getTurbidityCategory(last_reading.turbidity_ntu));
         // Muestra una categoría más descriptiva
-        Serial.println("---------------------------");
+        LOG_I(TAG, "---------------------------");
     }
     
     /**
@@ -698,11 +622,68 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
          // Verifica que el voltaje leido esté dentro del rango seguro y esperable para el sensor
     }
     
-<<<<<<< HEAD
+    /// Nombres indexados por WaterQuality
+    static const char* const WATER_QUALITY_NAMES[] = {
+        "Excelente", "Muy buena", "Buena", "Aceptable", "Pobre", "Muy pobre"
+    };
+
+    /// Nombres indexados por TurbidityCategory
+    static const char* const TURBIDITY_CATEGORY_NAMES[] = {
+        "Agua muy clara", "Agua clara", "Ligeramente turbia", "Moderadamente turbia",
+        "Turbia", "Muy turbia", "Extremadamente turbia"
+    };
+
+    /**
+     * @brief Clasifica la turbidez en una clase de calidad (sin asignar memoria)
+     * @param ntu Valor de turbidez en NTU
+     * @return Clase de calidad WaterQuality
+     */
+    WaterQuality classifyWaterQuality(float ntu) {
+        if (ntu <= 1) return QUALITY_EXCELLENT;
+        else if (ntu <= 4) return QUALITY_VERY_GOOD;
+        else if (ntu <= 10) return QUALITY_GOOD;
+        else if (ntu <= 25) return QUALITY_ACCEPTABLE;
+        else if (ntu <= 100) return QUALITY_POOR;
+        else return QUALITY_VERY_POOR;
+    }
+
+    /**
+     * @brief Clasifica la turbidez en una categoría visual (sin asignar memoria)
+     * @param ntu Valor de turbidez en NTU
+     * @return Categoría TurbidityCategory
+     */
+    TurbidityCategory classifyTurbidity(float ntu) {
+        if (ntu <= 1) return CATEGORY_VERY_CLEAR;
+        else if (ntu <= 4) return CATEGORY_CLEAR;
+        else if (ntu <= 10) return CATEGORY_SLIGHTLY_TURBID;
+        else if (ntu <= 25) return CATEGORY_MODERATELY_TURBID;
+        else if (ntu <= 100) return CATEGORY_TURBID;
+        else if (ntu <= 400) return CATEGORY_VERY_TURBID;
+        else return CATEGORY_EXTREMELY_TURBID;
+    }
+
+    /**
+     * @brief Nombre legible de una clase de calidad
+     * @param quality Clase devuelta por classifyWaterQuality()
+     * @return Literal estático (no liberar)
+     */
+    const char* waterQualityName(WaterQuality quality) {
+        return quality <= QUALITY_VERY_POOR ? WATER_QUALITY_NAMES[quality] : "Desconocida";
+    }
+
+    /**
+     * @brief Nombre legible de una categoría visual
+     * @param category Categoría devuelta por classifyTurbidity()
+     * @return Literal estático (no liberar)
+     */
+    const char* turbidityCategoryName(TurbidityCategory category) {
+        return category <= CATEGORY_EXTREMELY_TURBID ? TURBIDITY_CATEGORY_NAMES[category] : "Desconocida";
+    }
+
     /**
      * @brief Clasifica la calidad del agua según su turbidez
      * @param ntu Valor de turbidez a clasificar en NTU
-     * @return String descriptivo de la calidad del agua:
+     * @return Literal estático descriptivo de la calidad del agua:
      *         - "Excelente" (NTU ≤ 1) - Agua cristalina
      *         - "Muy buena" (1 < NTU ≤ 4) - Agua muy clara
      *         - "Buena" (4 < NTU ≤ 10) - Agua clara
@@ -711,23 +692,14 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
      *         - "Muy pobre" (NTU > 100) - Agua muy turbia/no potable
      * @note Clasificación según estándares EPA y OMS para agua potable (límite 5 NTU).
      */
-    String getWaterQuality(float ntu) {
-=======
-    String getWaterQuality(float ntu) { // Etiquetado: NTU
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
-        if (ntu <= 1) return "Excelente";
-        else if (ntu <= 4) return "Muy buena";
-        else if (ntu <= 10) return "Buena";
-        else if (ntu <= 25) return "Aceptable";
-        else if (ntu <= 100) return "Pobre";
-        else return "Muy pobre";
+    const char* getWaterQuality(float ntu) {
+        return waterQualityName(classifyWaterQuality(ntu));
     }
     
-<<<<<<< HEAD
     /**
      * @brief Clasifica la categoría visual de turbidez del agua
      * @param ntu Valor de turbidez a clasificar en NTU
-     * @return String descriptivo de la apariencia visual:
+     * @return Literal estático descriptivo de la apariencia visual:
      *         - "Agua muy clara" (NTU ≤ 1)
      *         - "Agua clara" (1 < NTU ≤ 4)
      *         - "Ligeramente turbia" (4 < NTU ≤ 10)
@@ -737,17 +709,8 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
      *         - "Extremadamente turbia" (NTU > 400)
      * @note Útil para interpretación rápida de resultados y logs legibles.
      */
-    String getTurbidityCategory(float ntu) {
-=======
-    String getTurbidityCategory(float ntu) { // Categoría descriptiva más detallada
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
-        if (ntu <= 1) return "Agua muy clara";
-        else if (ntu <= 4) return "Agua clara";
-        else if (ntu <= 10) return "Ligeramente turbia";
-        else if (ntu <= 25) return "Moderadamente turbia";
-        else if (ntu <= 100) return "Turbia";
-        else if (ntu <= 400) return "Muy turbia";
-        else return "Extremadamente turbia";
+    const char* getTurbidityCategory(float ntu) {
+        return turbidityCategoryName(classifyTurbidity(ntu));
     }
     
     // ——— FUNCIONES DE INTEGRACIÓN ———
@@ -789,35 +752,22 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
      * @note Útil para verificación rápida de configuración y diagnóstico de problemas.
      */
     void showCalibrationInfo() {
-        Serial.println(" === INFORMACIÓN DE CALIBRACIÓN TURBIDEZ ===");
-        Serial.printf("Estado: %s\n", initialized ? "Inicializado" : "No inicializado");
-        Serial.printf("Pin ADC: %d\n", sensor_pin);
-        Serial.printf("Ecuación: NTU = %.1f*V³ + %.1f*V² + %.1f*V + %.1f\n", 
-<<<<<<< HEAD
+        LOG_I(TAG, " === INFORMACIÓN DE CALIBRACIÓN TURBIDEZ ===");
+        LOG_I(TAG, "Estado: %s", initialized ? "Inicializado" : "No inicializado");
+        LOG_I(TAG, "Pin ADC: %d", sensor_pin);
+        LOG_I(TAG, "Ecuación: NTU = %.1f*V³ + %.1f*V² + %.1f*V + %.1f", 
                     calib_a, calib_b, calib_c, calib_d);
-        Serial.printf("Rango válido: %.0f - %.0f NTU\n", MIN_VALID_NTU, MAX_VALID_NTU);
-        Serial.printf("Voltaje válido: %.1f - %.1fV\n", MIN_VALID_VOLTAGE, MAX_VALID_VOLTAGE);
+        LOG_I(TAG, "Rango válido: %.0f - %.0f NTU", MIN_VALID_NTU, MAX_VALID_NTU);
+        LOG_I(TAG, "Voltaje válido: %.1f - %.1fV", MIN_VALID_VOLTAGE, MAX_VALID_VOLTAGE);
         
         if (last_reading.valid) {
-            Serial.printf("Última lectura: %.1f NTU (%.3fV) - %s\n", 
+            LOG_I(TAG, "Última lectura: %.1f NTU (%.3fV) - %s", 
                         last_reading.turbidity_ntu, last_reading.voltage,
-                        getWaterQuality(last_reading.turbidity_ntu).c_str());
-=======
-                     calib_a, calib_b, calib_c, calib_d);
-        // Imprime la ecuación polinómica actual con los coeficientes usados para calibración
-        Serial.printf("Rango válido: %.0f - %.0f NTU\n", MIN_VALID_NTU, MAX_VALID_NTU); // Muestra el rango válido configurado en macros
-        Serial.printf("Voltaje válido: %.1f - %.1fV\n", MIN_VALID_VOLTAGE, MAX_VALID_VOLTAGE); // Muestra el rango de voltaje aceptado para la sonda/ADC
-        
-        if (last_reading.valid) {
-            Serial.printf("Última lectura: %.1f NTU (%.3fV) - %s\n", 
-                         last_reading.turbidity_ntu, last_reading.voltage,
-                         getWaterQuality(last_reading.turbidity_ntu).c_str());
-                         // Si existe una lectura válida, imprímela con una etiqueta de calidad
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
+                        getWaterQuality(last_reading.turbidity_ntu));
         } else {
-            Serial.println("Sin lecturas válidas recientes");
+            LOG_I(TAG, "Sin lecturas válidas recientes");
         }
-        Serial.println("=========================================");
+        LOG_I(TAG, "=========================================");
     }
     
     /**
@@ -829,32 +779,27 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
      */
     void testReading() {
         if (!initialized) {
-            Serial.println(" Sensor no inicializado");
+            LOG_W(TAG, " Sensor no inicializado");
             return;
         }
         
-        Serial.println(" === TEST LECTURA TURBIDEZ ===");
+        LOG_I(TAG, " === TEST LECTURA TURBIDEZ ===");
         
         float voltage = readCalibratedVoltage(); // Toma una medición de voltaje promedio/calibrado
-        Serial.printf("Voltaje medido: %.6fV\n", voltage); // Imprime el voltaje con alta resolución
+        LOG_I(TAG, "Voltaje medido: %.6fV", voltage); // Imprime el voltaje con alta resolución
         
         if (isVoltageInRange(voltage)) { // Si el voltaje está dentro del rango aceptable...
             float ntu = voltageToNTU(voltage); // Calcula la turbidez
             
-            Serial.printf("Turbidez calculada: %.1f NTU\n", ntu); // Imprime NTU
-            Serial.printf("Calidad del agua: %s\n", getWaterQuality(ntu).c_str()); // Imprime calidad
-            Serial.printf("Categoría: %s\n", getTurbidityCategory(ntu).c_str()); // Imprime categoría
+            LOG_I(TAG, "Turbidez calculada: %.1f NTU", ntu); // Imprime NTU
+            LOG_I(TAG, "Calidad del agua: %s", getWaterQuality(ntu)); // Imprime calidad
+            LOG_I(TAG, "Categoría: %s", getTurbidityCategory(ntu)); // Imprime categoría
         } else {
-            Serial.printf(" Voltaje fuera de rango válido (%.1f-%.1fV)\n", 
-<<<<<<< HEAD
+            LOG_W(TAG, " Voltaje fuera de rango válido (%.1f-%.1fV)", 
                         MIN_VALID_VOLTAGE, MAX_VALID_VOLTAGE);
-=======
-                         MIN_VALID_VOLTAGE, MAX_VALID_VOLTAGE);
-            // Si está fuera de rango, informa cuál es el rango válido configurado
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
         }
         
-        Serial.println("========================");
+        LOG_I(TAG, "========================");
     }
     
     /**
@@ -870,24 +815,24 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
     void debugVoltageReading() {
         if (!initialized) return; // Si no está inicializado, no hacer nada
         
-        Serial.println("🔬 === DEBUG VOLTAJE TURBIDEZ ===");
+        LOG_I(TAG, "🔬 === DEBUG VOLTAJE TURBIDEZ ===");
         
         // Leer voltaje crudo
         long sum = 0;
         for (int i = 0; i < SAMPLES; i++) {
-            sum += analogRead(sensor_pin); // Acumula lecturas crudas del ADC
+            sum += HAL::adcRead(sensor_pin); // Acumula lecturas crudas del ADC
             delayMicroseconds(1000); // Espacio entre lecturas para mitigar ruido/conmutación   
         }
         
         float avgRaw = (float)sum / SAMPLES; // Promedio de valores crudos del ADC
-        uint32_t voltage_mv = esp_adc_cal_raw_to_voltage((uint32_t)avgRaw, &adc_chars); // Convierte el promedio crudo en milivoltios considerando la calibración ADC del ESP32
+        uint32_t voltage_mv = HAL::adcToMilliVolts((uint32_t)avgRaw, &adc_chars); // Convierte el promedio crudo en milivoltios considerando la calibración ADC del ESP32
         float voltage = voltage_mv / 1000.0f; // Convierte de mV a V para presentarlo   
         
-        Serial.printf("Valor ADC promedio: %.1f\n", avgRaw); // Imprime la media del ADC (un número en 0..4095)
-        Serial.printf("Voltaje calculado: %.6fV\n", voltage); // Imprime voltaje con precisión
-        Serial.printf("Turbidez estimada: %.1f NTU\n", voltageToNTU(voltage)); // Muestra la NTU estimada
+        LOG_I(TAG, "Valor ADC promedio: %.1f", avgRaw); // Imprime la media del ADC (un número en 0..4095)
+        LOG_I(TAG, "Voltaje calculado: %.6fV", voltage); // Imprime voltaje con precisión
+        LOG_I(TAG, "Turbidez estimada: %.1f NTU", voltageToNTU(voltage)); // Muestra la NTU estimada
         
-        Serial.println("==============================");
+        LOG_I(TAG, "==============================");
     }
     
     /**
@@ -898,19 +843,14 @@ namespace TurbiditySensor { // Se abre un namespace (espacio de nombres) llamado
      * @note Usa el algoritmo segmentado actual implementado en voltageToNTU().
      */
     void printCalibrationCurve() {
-        Serial.println(" === CURVA DE CALIBRACIÓN TURBIDEZ CORREGIDA ===");
-        Serial.println("Voltaje (V) | Turbidez (NTU) | Calidad");
-        Serial.println("------------|---------------|----------");
+        LOG_I(TAG, " === CURVA DE CALIBRACIÓN TURBIDEZ CORREGIDA ===");
+        LOG_I(TAG, "Voltaje (V) | Turbidez (NTU) | Calidad");
+        LOG_I(TAG, "------------|---------------|----------");
         
         for (float v = 0.6; v <= 2.2; v += 0.1) { // Recorre voltajes típicos del sensor en pasos de 0.1V
             float ntu = voltageToNTU(v); // Calcula NTU para cada voltaje de la serie
-            Serial.printf("   %.2fV    |    %.1f NTU    | %s\n", 
-<<<<<<< HEAD
-                        v, ntu, getWaterQuality(ntu).c_str());
-=======
-                         v, ntu, getWaterQuality(ntu).c_str());
-            // Imprime la fila con voltaje, NTU y etiqueta de calidad para facilitar revisión visual
->>>>>>> 1f7d3cb75334566773cc6b7198c2ada524678eb5
+            LOG_I(TAG, "   %.2fV    |    %.1f NTU    | %s", 
+                        v, ntu, getWaterQuality(ntu));
         }
     }
     
@@ -14,7 +14,7 @@
 #define TURBIDITY_SENSOR_H
 
 #include <Arduino.h>
-#include <esp_adc_cal.h>
+#include "HAL.h"
 
 // ——— Configuración del sensor de turbidez ———
 
@@ -280,6 +280,8 @@ namespace TurbiditySensor {
      * @return Turbidez en NTU (Nephelometric Turbidity Units). Mínimo 0 NTU.
      * @note El algoritmo segmentado mejora linealidad en rangos extremos donde
      *       el polinomio cúbico pierde precisión.
+     * @note Con setPolynomialModel(true) se usa el polinomio cúbico a..d ajustado
+     *       con soluciones patrón en lugar de los segmentos.
      */
     float voltageToNTU(float voltage);
 
@@ -299,8 +301,8 @@ namespace TurbiditySensor {
      * @param c Coeficiente lineal
      * @param d Término independiente
      * @note Imprime confirmación de cambios en Serial.
-     * @warning Los coeficientes actualizados NO se usan en voltageToNTU() que implementa
-     *          algoritmo segmentado. Conservados para compatibilidad futura.
+     * @warning Los coeficientes solo se usan en voltageToNTU() si el modelo polinómico
+     *          está activo (ver setPolynomialModel()).
      */
     void setCalibrationCoefficients(float a, float b, float c, float d);
 
@@ -319,6 +321,25 @@ namespace TurbiditySensor {
      * @note Imprime confirmación en Serial.
      */
     void resetToDefaultCalibration();
+
+    /**
+     * @brief Selecciona el modelo de conversión de voltageToNTU()
+     * @param enabled true: polinomio cúbico a..d; false: algoritmo segmentado
+     */
+    void setPolynomialModel(bool enabled);
+
+    /**
+     * @brief Consulta si voltageToNTU() usa el polinomio cúbico
+     */
+    bool isPolynomialModel();
+
+    /**
+     * @brief Mide el voltaje promediado del sensor para un punto de calibración
+     * @details Mismo muestreo que takeReading(), sin conversión a NTU ni contadores.
+     * @return Voltaje en V, o NAN si el sensor no está inicializado
+     * @warning Función bloqueante por ~50ms.
+     */
+    float measureVoltage();
     
     // ——— Funciones de estado ———
 
@@ -382,10 +403,65 @@ namespace TurbiditySensor {
      */
     bool isVoltageInRange(float voltage);
 
+    /**
+     * @enum WaterQuality
+     * @brief Clases de calidad del agua según turbidez (ver getWaterQuality())
+     */
+    enum WaterQuality : uint8_t {
+        QUALITY_EXCELLENT = 0, ///< NTU ≤ 1
+        QUALITY_VERY_GOOD,     ///< 1 < NTU ≤ 4
+        QUALITY_GOOD,          ///< 4 < NTU ≤ 10
+        QUALITY_ACCEPTABLE,    ///< 10 < NTU ≤ 25
+        QUALITY_POOR,          ///< 25 < NTU ≤ 100
+        QUALITY_VERY_POOR      ///< NTU > 100
+    };
+
+    /**
+     * @enum TurbidityCategory
+     * @brief Categorías visuales de turbidez (ver getTurbidityCategory())
+     */
+    enum TurbidityCategory : uint8_t {
+        CATEGORY_VERY_CLEAR = 0,   ///< NTU ≤ 1
+        CATEGORY_CLEAR,            ///< 1 < NTU ≤ 4
+        CATEGORY_SLIGHTLY_TURBID,  ///< 4 < NTU ≤ 10
+        CATEGORY_MODERATELY_TURBID,///< 10 < NTU ≤ 25
+        CATEGORY_TURBID,           ///< 25 < NTU ≤ 100
+        CATEGORY_VERY_TURBID,      ///< 100 < NTU ≤ 400
+        CATEGORY_EXTREMELY_TURBID  ///< NTU > 400
+    };
+
+    /**
+     * @brief Clasifica la turbidez en una clase de calidad (sin asignar memoria)
+     * @param ntu Valor de turbidez en NTU
+     * @return Clase de calidad WaterQuality
+     */
+    WaterQuality classifyWaterQuality(float ntu);
+
+    /**
+     * @brief Clasifica la turbidez en una categoría visual (sin asignar memoria)
+     * @param ntu Valor de turbidez en NTU
+     * @return Categoría TurbidityCategory
+     */
+    TurbidityCategory classifyTurbidity(float ntu);
+
+    /**
+     * @brief Nombre legible de una clase de calidad
+     * @param quality Clase devuelta por classifyWaterQuality()
+     * @return Literal estático (no liberar)
+     */
+    const char* waterQualityName(WaterQuality quality);
+
+    /**
+     * @brief Nombre legible de una categoría visual
+     * @param category Categoría devuelta por classifyTurbidity()
+     * @return Literal estático (no liberar)
+     */
+    const char* turbidityCategoryName(TurbidityCategory category);
+
     /**
      * @brief Clasifica la calidad del agua según su turbidez
      * @param ntu Valor de turbidez a clasificar en NTU
-     * @return String descriptivo de la calidad del agua:
+     * @return Literal estático descriptivo de la calidad del agua:
      *         - "Excelente" (NTU ≤ 1) - Agua cristalina
      *         - "Muy buena" (1 < NTU ≤ 4) - Agua muy clara
      *         - "Buena" (4 < NTU ≤ 10) - Agua clara
@@ -394,12 +470,12 @@ namespace TurbiditySensor {
      *         - "Muy pobre" (NTU > 100) - Agua muy turbia/no potable
      * @note Clasificación según estándares EPA y OMS para agua potable (límite 5 NTU).
      */
-    String getWaterQuality(float ntu);
+    const char* getWaterQuality(float ntu);
 
     /**
      * @brief Clasifica la categoría visual de turbidez del agua
      * @param ntu Valor de turbidez a clasificar en NTU
-     * @return String descriptivo de la apariencia visual:
+     * @return Literal estático descriptivo de la apariencia visual:
      *         - "Agua muy clara" (NTU ≤ 1)
      *         - "Agua clara" (1 < NTU ≤ 4)
      *         - "Ligeramente turbia" (4 < NTU ≤ 10)
@@ -409,7 +485,7 @@ namespace TurbiditySensor {
      *         - "Extremadamente turbia" (NTU > 400)
      * @note Útil para interpretación rápida de resultados y logs legibles.
      */
-    String getTurbidityCategory(float ntu);
+    const char* getTurbidityCategory(float ntu);
     
     // ——— Funciones para integración con sistema principal ———
 
@@ -481,9 +557,9 @@ namespace TurbiditySensor {
      * @brief Características de calibración del ADC del ESP32
      * @details Estructura que almacena parámetros de calibración específicos del chip
      *          para conversión precisa de valores crudos ADC a voltajes reales (mV).
-     *          Inicializada en initialize() con esp_adc_cal_characterize().
+     *          Inicializada en initialize() con HAL::adcCalibrate().
      */
-    extern esp_adc_cal_characteristics_t adc_chars;
+    extern HAL::AdcCalibration adc_chars;
     
     // ——— Configuración de muestreo ———
 
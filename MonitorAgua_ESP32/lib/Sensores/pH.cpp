@@ -10,6 +10,10 @@
  * @version 1.0
  */
 #include "pH.h"
+#include "Logger.h"
+#include "Trace.h"
+
+static const char TAG[] = "PH"; ///< Etiqueta de log del módulo
 
 /**
  * @namespace pHSensor
@@ -62,7 +66,7 @@ namespace pHSensor {
      *          del chip para convertir valores crudos ADC a voltajes reales (mV).
      */
 
-    esp_adc_cal_characteristics_t adc_chars;
+    HAL::AdcCalibration adc_chars;
     
     // Variables de calibración
 
@@ -84,19 +88,12 @@ namespace pHSensor {
     
     // Buffer de muestras para promediado
     /**
-     * @brief Array circular de muestras crudas del ADC
+     * @brief Muestras crudas del ADC de la lectura en curso
      * @details Almacena lecturas consecutivas del ADC para posteriormente
      *          promediarlas y descartar valores extremos (filtrado estadístico).
+     *          Se vacía al inicio de cada lectura promediada.
      */
-    int phArray[PH_ARRAY_LENGTH];
-
-    /**
-     * @brief Índice actual en el array circular de muestras
-     * @details Apunta a la próxima posición disponible en phArray[] para
-     *          escribir una nueva muestra. Se reinicia en inicialización.
-     */
-
-    int phArrayIndex = 0;
+    StaticVector<int, PH_ARRAY_LENGTH> phSamples;
     
     // Configuración ADC
     /**
@@ -143,7 +140,7 @@ namespace pHSensor {
     /**
      * @brief Intervalo de muestreo configurable en milisegundos
      * @details Define el tiempo total durante el cual se distribuyen las muestras
-     *          múltiples del array phArray[]. Actualmente 10000 ms = 10 segundos.
+     *          de phSamples. Actualmente 10000 ms = 10 segundos.
      * @note LÍNEA CRÍTICA PARA MODIFICAR INTERVALO DE MUESTREO.
      *       Cambiar este valor según necesidades del proyecto (ej: 20000 para 20s).
      */
@@ -214,7 +211,7 @@ namespace pHSensor {
      *          respetando un spacing mínimo entre lecturas. No usa delay() bloqueante.
      *          Convierte el promedio crudo del ADC a voltaje usando calibración ESP32.
      * @return Voltaje promedio en voltios (float). Rango típico 0.0 - 3.3V.
-     * @note Utiliza esp_adc_cal_raw_to_voltage() para conversión calibrada.
+     * @note Utiliza HAL::adcToMilliVolts() para conversión calibrada.
      * @warning Existe discrepancia entre analogReadResolution(12) y ADC_WIDTH_BIT_13
      *          usado en esp_adc_cal_characterize(). Se mantiene 12 bits por consistencia.
      *          PENDIENTE: Verificar y unificar configuración ADC.
@@ -223,7 +220,8 @@ namespace pHSensor {
     float readAveragedVoltage() {
         // Tomar múltiples muestras con el intervalo configurado
         unsigned long startTime = millis();
-        int sampleCount = 0;
+        phSamples.clear();
+        HAL::Trace::beginBurst(HAL::Trace::Source::ADC, sensor_pin);
 
     // Distribuir las muestras durante PH_INTERVAL_MS evitando delay() bloqueante
     // Calcular intervalo por muestra; respetar spacing mínimo para evitar lecturas muy rápidas
@@ -232,11 +230,10 @@ namespace pHSensor {
     unsigned long lastSampleTime = 0;
         
         // Llenar el array de muestras
-        while (sampleCount < PH_ARRAY_LENGTH && (millis() - startTime) < PH_INTERVAL_MS) {
+        while (!phSamples.full() && (millis() - startTime) < PH_INTERVAL_MS) {
             unsigned long now = millis();
-            if (sampleCount == 0 || (now - lastSampleTime) >= perSampleInterval) {
-                phArray[sampleCount] = analogRead(sensor_pin);
-                sampleCount++;
+            if (phSamples.empty() || (now - lastSampleTime) >= perSampleInterval) {
+                phSamples.push_back(HAL::adcRead(sensor_pin));
                 lastSampleTime = now;
             } else {
                 // Ceder tiempo al scheduler para no bloquear (ESP32-friendly)
@@ -245,14 +242,14 @@ namespace pHSensor {
         }
         
         // Calcular promedio descartando extremos
-        double avgRaw = averageArray(phArray, sampleCount);
+        double avgRaw = averageArray(phSamples.data(), (int)phSamples.size());
         
         //Convertir a voltaje usando calibración ESP32
         //chat sugiere inconsistencias en la respecto a la resolución entre
         //analogReadResolution(12) pero el esp_adc_cal_characterize() se llamó con ADC_WIDTH_BIT_13
         //mantener 12 bits para evitar errores (pendiente por verificar)
         //ocurre misma discrepancia en initialize donde se usó adc_atten_db_11
-        uint32_t voltage_mv = esp_adc_cal_raw_to_voltage((uint32_t)avgRaw, &adc_chars);
+        uint32_t voltage_mv = HAL::adcToMilliVolts((uint32_t)avgRaw, &adc_chars);
         float voltage_v = voltage_mv / 1000.0f;
         
         return voltage_v;
@@ -286,21 +283,13 @@ namespace pHSensor {
         
         // Configurar ADC con calibración ESP32
         //Aquí es donde están las discrepancias en el nivel de atenuación y resolución del adc
-        analogReadResolution(ADC_BITS);
-        analogSetPinAttenuation(sensor_pin, ADC_11db); // Para voltajes hasta 3.3V
+        HAL::adcConfigure(sensor_pin, ADC_BITS, HAL::AdcAtten::DB_12); // Para voltajes hasta 3.3V
         
         // Calibrar ADC específico para ESP32
-        esp_adc_cal_value_t val_type = esp_adc_cal_characterize(
-            ADC_UNIT_1,
-            ADC_ATTEN_DB_12,
-            ADC_WIDTH_BIT_13,
-            ADC_VREF,
-            &adc_chars
-        );
+        HAL::adcCalibrate(&adc_chars, HAL::AdcAtten::DB_12, 13, ADC_VREF);
         
         // Limpiar array de muestras
-        memset(phArray, 0, sizeof(phArray));
-        phArrayIndex = 0;
+        phSamples.clear();
         
         initialized = true;
         last_reading_time = millis();
@@ -381,7 +370,7 @@ namespace pHSensor {
         
         // Verificar timeout
         if (millis() - start_time > PH_OPERATION_TIMEOUT) {
-            Serial.println(" Timeout en lectura de sensor pH");
+            LOG_W(TAG, " Timeout en lectura de sensor pH");
             
             if (error_logger) {
                 error_logger(1, 1, millis() - start_time); // ERROR_SENSOR_TIMEOUT
@@ -436,8 +425,8 @@ namespace pHSensor {
             
             last_reading_time = millis();
             
-            Serial.printf(" pH: %.2f | V: %.3fV | %s (%.0f ms)\n", 
-                            ph, voltage, getWaterType(ph).c_str(), millis() - start_time);
+            LOG_I(TAG, " pH: %.2f | V: %.3fV | %s (%lu ms)", 
+                            ph, voltage, getWaterType(ph), (unsigned long)(millis() - start_time));
         } else {
             reading.ph_value = 0.0;
             reading.voltage = voltage;
@@ -452,7 +441,7 @@ namespace pHSensor {
                 (*total_readings_counter)--;
             }
             
-            Serial.printf(" pH fuera de rango: %.2f\n", ph);
+            LOG_W(TAG, " pH fuera de rango: %.2f", ph);
         }
         
         last_reading = reading;
@@ -473,7 +462,7 @@ namespace pHSensor {
     void setCalibration(float offset, float slope) {
         phOffset = offset;
         phSlope = slope;
-        Serial.printf(" Calibración pH actualizada: offset=%.2f, pendiente=%.2f\n", 
+        LOG_I(TAG, " Calibración pH actualizada: offset=%.2f, pendiente=%.2f", 
                         phOffset, phSlope);
     }
     
@@ -499,7 +488,7 @@ namespace pHSensor {
     void resetToDefaultCalibration() {
         phOffset = PH_CALIBRATED_OFFSET;
         phSlope = PH_CALIBRATED_SLOPE;
-        Serial.printf(" Calibración pH restaurada a valores por defecto\n");
+        LOG_I(TAG, " Calibración pH restaurada a valores por defecto");
     }
     
     /**
@@ -522,15 +511,24 @@ namespace pHSensor {
         
         float newOffset = bufferPH - phSlope * measuredVoltage;
         
-        Serial.printf(" Calibración con buffer pH %.2f:\n", bufferPH);
-        Serial.printf("   Voltaje medido: %.3fV\n", measuredVoltage);
-        Serial.printf("   Nuevo offset: %.2f (anterior: %.2f)\n", newOffset, phOffset);
+        LOG_I(TAG, " Calibración con buffer pH %.2f:", bufferPH);
+        LOG_I(TAG, "   Voltaje medido: %.3fV", measuredVoltage);
+        LOG_I(TAG, "   Nuevo offset: %.2f (anterior: %.2f)", newOffset, phOffset);
         
         phOffset = newOffset;
         
         return true;
     }
     
+    /**
+     * @brief Mide el voltaje promediado para un punto de calibración
+     * @return Voltaje en V, o NAN si el sensor no está inicializado
+     */
+    float measureVoltage() {
+        if (!initialized) return NAN;
+        return readAveragedVoltage();
+    }
+    
     // ——— FUNCIONES DE ESTADO ———
     
     /**
@@ -596,19 +594,19 @@ namespace pHSensor {
 
     void printLastReading() {
         if (last_reading.reading_number == 0) {
-            Serial.println(" No hay lecturas pH previas");
+            LOG_I(TAG, " No hay lecturas pH previas");
             return;
         }
         
-        Serial.println(" --- ÚLTIMA LECTURA pH ---");
-        Serial.printf("Lectura #%d\n", last_reading.reading_number);
-        Serial.printf("pH: %.2f\n", last_reading.ph_value);
-        Serial.printf("Voltaje: %.3fV\n", last_reading.voltage);
-        Serial.printf("Timestamp: %u ms\n", last_reading.timestamp);
-        Serial.printf("Estado: 0x%02X (%s)\n", 
+        LOG_I(TAG, " --- ÚLTIMA LECTURA pH ---");
+        LOG_I(TAG, "Lectura #%d", last_reading.reading_number);
+        LOG_I(TAG, "pH: %.2f", last_reading.ph_value);
+        LOG_I(TAG, "Voltaje: %.3fV", last_reading.voltage);
+        LOG_I(TAG, "Timestamp: %u ms", last_reading.timestamp);
+        LOG_I(TAG, "Estado: 0x%02X (%s)", 
                         last_reading.sensor_status,
                         last_reading.valid ? "VÁLIDA" : "INVÁLIDA");
-        Serial.println("---------------------------");
+        LOG_I(TAG, "---------------------------");
     }
     
 
@@ -630,10 +628,40 @@ namespace pHSensor {
         return (voltage >= MIN_VALID_VOLTAGE && voltage <= MAX_VALID_VOLTAGE && !isnan(voltage));
     }
     
+    /// Nombres indexados por WaterType
+    static const char* const WATER_TYPE_NAMES[] = {
+        "Muy ácida", "Ácida", "Ligeramente ácida", "Neutra",
+        "Ligeramente alcalina", "Alcalina", "Muy alcalina"
+    };
+
+    /**
+     * @brief Clasifica el pH en un tipo de agua (sin asignar memoria)
+     * @param ph Valor de pH
+     * @return Tipo WaterType
+     */
+    WaterType classifyWaterType(float ph) {
+        if (ph < 6.0) return TYPE_VERY_ACIDIC;
+        else if (ph < 6.5) return TYPE_ACIDIC;
+        else if (ph < 7.0) return TYPE_SLIGHTLY_ACIDIC;
+        else if (ph == 7.0) return TYPE_NEUTRAL;
+        else if (ph < 7.5) return TYPE_SLIGHTLY_ALKALINE;
+        else if (ph < 8.5) return TYPE_ALKALINE;
+        else return TYPE_VERY_ALKALINE;
+    }
+
+    /**
+     * @brief Nombre legible de un tipo de agua
+     * @param type Tipo devuelto por classifyWaterType()
+     * @return Literal estático (no liberar)
+     */
+    const char* waterTypeName(WaterType type) {
+        return type <= TYPE_VERY_ALKALINE ? WATER_TYPE_NAMES[type] : "Desconocido";
+    }
+
     /**
      * @brief Clasifica el tipo de agua según su pH
      * @param ph Valor de pH a clasificar
-     * @return String descriptivo del tipo de agua:
+     * @return Literal estático descriptivo del tipo de agua:
      *         - "Muy ácida" (pH < 6.0)
      *         - "Ácida" (6.0 ≤ pH < 6.5)
      *         - "Ligeramente ácida" (6.5 ≤ pH < 7.0)
@@ -643,14 +671,8 @@ namespace pHSensor {
      *         - "Muy alcalina" (pH ≥ 8.5)
      * @note Útil para interpretación rápida de resultados y logs legibles.
      */
-    String getWaterType(float ph) {
-        if (ph < 6.0) return "Muy ácida";
-        else if (ph < 6.5) return "Ácida";
-        else if (ph < 7.0) return "Ligeramente ácida";
-        else if (ph == 7.0) return "Neutra";
-        else if (ph < 7.5) return "Ligeramente alcalina";
-        else if (ph < 8.5) return "Alcalina";
-        else return "Muy alcalina";
+    const char* getWaterType(float ph) {
+        return waterTypeName(classifyWaterType(ph));
     }
     
     // ——— FUNCIONES DE INTEGRACIÓN ———
@@ -689,21 +711,21 @@ namespace pHSensor {
      * @note Útil para verificación rápida de configuración y diagnóstico de problemas.
      */
     void showCalibrationInfo() {
-        Serial.println(" === INFORMACIÓN DE CALIBRACIÓN pH ===");
-        Serial.printf("Estado: %s\n", initialized ? "Inicializado" : "No inicializado");
-        Serial.printf("Pin ADC: %d\n", sensor_pin);
-        Serial.printf("Ecuación: pH = %.2f * V + %.2f\n", phSlope, phOffset);
-        Serial.printf("Rango válido pH: %.1f - %.1f\n", MIN_VALID_PH, MAX_VALID_PH);
-        Serial.printf("Voltaje válido: %.1f - %.1fV\n", MIN_VALID_VOLTAGE, MAX_VALID_VOLTAGE);
+        LOG_I(TAG, " === INFORMACIÓN DE CALIBRACIÓN pH ===");
+        LOG_I(TAG, "Estado: %s", initialized ? "Inicializado" : "No inicializado");
+        LOG_I(TAG, "Pin ADC: %d", sensor_pin);
+        LOG_I(TAG, "Ecuación: pH = %.2f * V + %.2f", phSlope, phOffset);
+        LOG_I(TAG, "Rango válido pH: %.1f - %.1f", MIN_VALID_PH, MAX_VALID_PH);
+        LOG_I(TAG, "Voltaje válido: %.1f - %.1fV", MIN_VALID_VOLTAGE, MAX_VALID_VOLTAGE);
         
         if (last_reading.valid) {
-            Serial.printf("Última lectura: pH %.2f (%.3fV) - %s\n", 
+            LOG_I(TAG, "Última lectura: pH %.2f (%.3fV) - %s", 
                             last_reading.ph_value, last_reading.voltage,
-                            getWaterType(last_reading.ph_value).c_str());
+                            getWaterType(last_reading.ph_value));
         } else {
-            Serial.println("Sin lecturas válidas recientes");
+            LOG_I(TAG, "Sin lecturas válidas recientes");
         }
-        Serial.println("=======================================");
+        LOG_I(TAG, "=======================================");
     }
     
     /**
@@ -715,26 +737,26 @@ namespace pHSensor {
      */
     void testReading() {
         if (!initialized) {
-            Serial.println(" Sensor no inicializado");
+            LOG_W(TAG, " Sensor no inicializado");
             return;
         }
         
-        Serial.println(" === TEST LECTURA pH ===");
+        LOG_I(TAG, " === TEST LECTURA pH ===");
         
         float voltage = readAveragedVoltage();
-        Serial.printf("Voltaje medido: %.6fV\n", voltage);
+        LOG_I(TAG, "Voltaje medido: %.6fV", voltage);
         
         if (isVoltageInRange(voltage)) {
             float ph = phSlope * voltage + phOffset;
             
-            Serial.printf("pH calculado: %.2f\n", ph);
-            Serial.printf("Estado: %s\n", isPHInRange(ph) ? "VÁLIDO" : "FUERA DE RANGO");
+            LOG_I(TAG, "pH calculado: %.2f", ph);
+            LOG_I(TAG, "Estado: %s", isPHInRange(ph) ? "VÁLIDO" : "FUERA DE RANGO");
         } else {
-            Serial.printf(" Voltaje fuera de rango válido (%.1f-%.1fV)\n", 
+            LOG_W(TAG, " Voltaje fuera de rango válido (%.1f-%.1fV)", 
                             MIN_VALID_VOLTAGE, MAX_VALID_VOLTAGE);
         }
         
-        Serial.println("========================");
+        LOG_I(TAG, "========================");
     }
     
     /**
@@ -753,16 +775,16 @@ namespace pHSensor {
      */
     void performCalibrationRoutine() {
         if (!initialized) {
-            Serial.println(" Sensor no inicializado");
+            LOG_W(TAG, " Sensor no inicializado");
             return;
         }
         
-        Serial.println("\n === RUTINA DE CALIBRACIÓN pH ===");
-        Serial.println("Necesitarás soluciones buffer de pH conocido");
-        Serial.println("Recomendado: pH 4.0, 7.0 y 10.0");
-        Serial.println("\n1. Sumerge el sensor en buffer pH 7.0");
-        Serial.println("2. Espera 30 segundos para estabilizar");
-        Serial.println("3. Presiona cualquier tecla para continuar...");
+        LOG_I(TAG, "\n === RUTINA DE CALIBRACIÓN pH ===");
+        LOG_I(TAG, "Necesitarás soluciones buffer de pH conocido");
+        LOG_I(TAG, "Recomendado: pH 4.0, 7.0 y 10.0");
+        LOG_I(TAG, "\n1. Sumerge el sensor en buffer pH 7.0");
+        LOG_I(TAG, "2. Espera 30 segundos para estabilizar");
+        LOG_I(TAG, "3. Presiona cualquier tecla para continuar...");
         
         // Esperar input del usuario
         while (!Serial.available()) {
@@ -770,24 +792,24 @@ namespace pHSensor {
         }
         Serial.read(); // Limpiar buffer
         
-        Serial.println("\nLeyendo voltaje en pH 7.0...");
+        LOG_I(TAG, "\nLeyendo voltaje en pH 7.0...");
         delay(2000);
         
         float voltage7 = readAveragedVoltage();
-        Serial.printf("Voltaje en pH 7.0: %.3fV\n", voltage7);
+        LOG_I(TAG, "Voltaje en pH 7.0: %.3fV", voltage7);
         
         // Calcular nuevo offset asumiendo la pendiente actual
         float newOffset = 7.0 - phSlope * voltage7;
         
-        Serial.printf("\nCalibración completada:");
-        Serial.printf("  Offset anterior: %.2f\n", phOffset);
-        Serial.printf("  Nuevo offset: %.2f\n", newOffset);
-        Serial.printf("  Pendiente: %.2f (sin cambios)\n", phSlope);
+        LOG_I(TAG, "\nCalibración completada:");
+        LOG_I(TAG, "  Offset anterior: %.2f", phOffset);
+        LOG_I(TAG, "  Nuevo offset: %.2f", newOffset);
+        LOG_I(TAG, "  Pendiente: %.2f (sin cambios)", phSlope);
         
         phOffset = newOffset;
         
-        Serial.println("\n Calibración actualizada");
-        Serial.println("=====================================");
+        LOG_I(TAG, "\n Calibración actualizada");
+        LOG_I(TAG, "=====================================");
     }
     
 } // namespace pHSensor
\ No newline at end of file
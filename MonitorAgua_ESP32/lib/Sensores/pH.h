@@ -14,7 +14,8 @@
 #define PH_SENSOR_H
 
 #include <Arduino.h>
-#include <esp_adc_cal.h>
+#include "HAL.h"
+#include "StaticVector.h"
 
 // ——— Configuración del sensor de pH  ———
 
@@ -332,6 +333,16 @@ namespace pHSensor {
      * @warning Asegurar que sensor esté estabilizado (≥30 segundos en buffer) antes de calibrar.
      */
     bool calibrateWithBuffer(float bufferPH, float measuredVoltage);
+
+    /**
+     * @brief Mide el voltaje promediado del sensor para un punto de calibración
+     * @details Usa el mismo promediado con descarte de extremos que takeReading(),
+     *          sin aplicar la ecuación de calibración ni actualizar contadores.
+     *          CalibrationManager lo usa para registrar pares (voltaje, pH patrón).
+     * @return Voltaje en V, o NAN si el sensor no está inicializado
+     * @warning Función bloqueante durante PH_INTERVAL_MS.
+     */
+    float measureVoltage();
     
     // ——— Funciones de estado ———
     /**
@@ -394,10 +405,38 @@ namespace pHSensor {
      */
     bool isVoltageInRange(float voltage);
 
+    /**
+     * @enum WaterType
+     * @brief Tipos de agua según pH (ver getWaterType())
+     */
+    enum WaterType : uint8_t {
+        TYPE_VERY_ACIDIC = 0,    ///< pH < 6.0
+        TYPE_ACIDIC,             ///< 6.0 ≤ pH < 6.5
+        TYPE_SLIGHTLY_ACIDIC,    ///< 6.5 ≤ pH < 7.0
+        TYPE_NEUTRAL,            ///< pH == 7.0
+        TYPE_SLIGHTLY_ALKALINE,  ///< 7.0 < pH < 7.5
+        TYPE_ALKALINE,           ///< 7.5 ≤ pH < 8.5
+        TYPE_VERY_ALKALINE       ///< pH ≥ 8.5
+    };
+
+    /**
+     * @brief Clasifica el pH en un tipo de agua (sin asignar memoria)
+     * @param ph Valor de pH
+     * @return Tipo WaterType
+     */
+    WaterType classifyWaterType(float ph);
+
+    /**
+     * @brief Nombre legible de un tipo de agua
+     * @param type Tipo devuelto por classifyWaterType()
+     * @return Literal estático (no liberar)
+     */
+    const char* waterTypeName(WaterType type);
+
     /**
      * @brief Clasifica el tipo de agua según su pH
      * @param ph Valor de pH a clasificar
-     * @return String descriptivo del tipo de agua:
+     * @return Literal estático descriptivo del tipo de agua:
      *         - "Muy ácida" (pH < 6.0)
      *         - "Ácida" (6.0 ≤ pH < 6.5)
      *         - "Ligeramente ácida" (6.5 ≤ pH < 7.0)
@@ -407,7 +446,7 @@ namespace pHSensor {
      *         - "Muy alcalina" (pH ≥ 8.5)
      * @note Útil para interpretación rápida de resultados y logs legibles.
      */
-    String getWaterType(float ph);
+    const char* getWaterType(float ph);
 
 
     
@@ -481,25 +520,18 @@ namespace pHSensor {
      * @brief Características de calibración del ADC del ESP32
      * @details Estructura que almacena parámetros de calibración específicos del chip
      *          para conversión precisa de valores crudos ADC a voltajes reales (mV).
-     *          Inicializada en initialize() con esp_adc_cal_characterize().
+     *          Inicializada en initialize() con HAL::adcCalibrate().
      */
-    extern esp_adc_cal_characteristics_t adc_chars;
+    extern HAL::AdcCalibration adc_chars;
     
     // ——— Buffer de muestras para promediado ———
 
     /**
-     * @brief Array circular de muestras crudas del ADC
-     * @details Almacena PH_ARRAY_LENGTH (40) lecturas consecutivas del ADC para
+     * @brief Muestras crudas del ADC de la lectura en curso
+     * @details Almacena hasta PH_ARRAY_LENGTH (40) lecturas consecutivas del ADC para
      *          promediado estadístico con descarte de extremos. Reduce ruido y outliers.
      */
-    extern int phArray[PH_ARRAY_LENGTH];
-
-    /**
-     * @brief Índice actual en el array circular de muestras
-     * @details Apunta a la próxima posición disponible en phArray[] para escribir.
-     *          Reiniciado a 0 en initialize().
-     */
-    extern int phArrayIndex;
+    extern StaticVector<int, PH_ARRAY_LENGTH> phSamples;
     
     // ——— Funciones adicionales para debugging ———
 
@@ -0,0 +1,315 @@
+/**
+ * @file TimeKeeper.cpp
+ * @brief Implementación de la base de tiempo sobre el temporizador RTC interno.
+ *
+ * La hora se calcula como:
+ *   epoch_us = t_rtc + offset - deriva · (t_rtc - ancla)
+ * donde t_rtc es el temporizador interno, offset se fija en cada disciplina y
+ * ancla es t_rtc en ese instante. La cota de error crece con el tiempo desde la
+ * última disciplina según la deriva residual estimada.
+ *
+ * @version 1.0
+ * @date 2025-10-01
+ * @author Daniel Acosta - Santiago Erazo
+ */
+
+#include "TimeKeeper.h"
+#include "Logger.h"
+#include <stdarg.h>
+#include <math.h>
+#include "HAL.h"
+
+static const char TAG[] = "TIME"; ///< Etiqueta de log del módulo
+
+#define TIMEKEEPER_MAGIC 0x54494D45u  ///< "TIME"
+
+/**
+ * @brief Estado de la base de tiempo persistido en RTC memory.
+ */
+typedef struct {
+    uint32_t magic;          ///< TIMEKEEPER_MAGIC si el desfase es válido
+    int64_t offset_us;       ///< epoch_us - t_rtc en la última disciplina
+    uint64_t anchor_us;      ///< t_rtc en la última disciplina
+    float drift_ppm;         ///< Deriva corregida (positivo: el contador interno adelanta)
+    float residual_ppm;      ///< Deriva residual usada para la cota de error
+    uint32_t resolution_ms;  ///< Resolución de la última referencia
+    int32_t last_error_ms;   ///< Error observado en la última disciplina
+    uint16_t wakes_since;    ///< Despertares desde la última disciplina
+    uint16_t disciplines;    ///< Disciplinas realizadas desde el arranque en frío
+} TimeKeeperState;
+
+static HAL_PERSISTENT TimeKeeperState tk_state; ///< Sobrevive al deep sleep
+
+/**
+ * @brief Constructor de TimeKeeper.
+ * @param resyncWakes Despertares máximos entre disciplinas.
+ * @param maxErrorMs Cota de error (ms) que fuerza disciplina.
+ * @param enableSerial Habilita o deshabilita la salida por Serial.
+ */
+TimeKeeper::TimeKeeper(uint16_t resyncWakes, uint32_t maxErrorMs, bool enableSerial)
+    : _resyncWakes(resyncWakes), _maxErrorMs(maxErrorMs),
+      _enableSerialOutput(enableSerial), _logCallback(nullptr), _driftEstimator(nullptr) {
+}
+
+/**
+ * @brief Valida el estado persistido y cuenta el despertar actual.
+ * @details Si el temporizador interno retrocedió (reset del dominio RTC) el
+ *          desfase deja de ser válido aunque la RTC memory conserve datos.
+ */
+void TimeKeeper::begin() {
+    if (tk_state.magic != TIMEKEEPER_MAGIC) {
+        return;
+    }
+
+    if (rtcTimeUs() < tk_state.anchor_us) {
+        MLOG_W("Temporizador RTC reiniciado - hora interna descartada");
+        tk_state.magic = 0;
+        return;
+    }
+
+    if (tk_state.wakes_since < 0xFFFF) {
+        tk_state.wakes_since++;
+    }
+}
+
+/**
+ * @brief Determina si este ciclo debe leer el RTC externo.
+ * @return true si no hay hora válida, se alcanzaron N despertares o la cota se excede.
+ */
+bool TimeKeeper::needsDiscipline() {
+    if (!isValid()) {
+        return true;
+    }
+    if (tk_state.wakes_since >= _resyncWakes) {
+        return true;
+    }
+    return getEstimatedErrorMs() > _maxErrorMs;
+}
+
+/**
+ * @brief Asocia el estimador de deriva del RTC externo.
+ * @param estimator Estimador o nullptr.
+ */
+void TimeKeeper::setDriftEstimator(RTCDriftEstimator* estimator) {
+    _driftEstimator = estimator;
+}
+
+/**
+ * @brief Disciplina con una lectura fresca del MAX31328.
+ * @param rtc RTC ya inicializado.
+ * @return true si se aceptó la referencia.
+ */
+bool TimeKeeper::discipline(MAX31328RTC& rtc) {
+    if (!rtc.refresh()) {
+        MLOG_W("RTC externo sin respuesta - se mantiene hora interna");
+        return false;
+    }
+    if (rtc.hasLostTime()) {
+        MLOG_W("RTC externo perdió la hora - no se usa como referencia");
+        return false;
+    }
+    uint32_t epoch = rtc.getUnixTimestamp();
+    if (_driftEstimator) {
+        epoch = _driftEstimator->correct(epoch);
+    }
+    return discipline(epoch, 1000);
+}
+
+/**
+ * @brief Disciplina con una hora de referencia.
+ * @details Si ya había hora válida y el intervalo es suficiente, el error
+ *          observado actualiza la estimación de deriva (ganancia 1/2) y la
+ *          deriva residual, acotada inferiormente por la resolución de la
+ *          referencia dividida entre el intervalo.
+ * @param epoch Timestamp Unix de referencia.
+ * @param resolutionMs Resolución de la referencia en ms.
+ * @return true si se aceptó la referencia.
+ */
+bool TimeKeeper::discipline(uint32_t epoch, uint32_t resolutionMs) {
+    if (epoch < TIMEKEEPER_MIN_EPOCH) {
+        MLOG_W("Referencia de tiempo inválida: %u", epoch);
+        return false;
+    }
+
+    uint64_t t = rtcTimeUs();
+    // La referencia trunca a su resolución: se toma el centro del intervalo
+    int64_t observed = (int64_t)epoch * 1000000LL + (int64_t)resolutionMs * 500LL;
+
+    if (isValid()) {
+        int64_t error = epochUs(t) - observed;
+        uint64_t elapsed = t - tk_state.anchor_us;
+        tk_state.last_error_ms = (int32_t)(error / 1000);
+
+        if (elapsed >= (uint64_t)TIMEKEEPER_MIN_LEARN_S * 1000000ULL) {
+            float measured = (float)((double)error * 1e6 / (double)elapsed);
+            float floorPpm = (float)(((double)tk_state.resolution_ms + resolutionMs) * 500.0 / ((double)elapsed / 1e6));
+            tk_state.drift_ppm += 0.5f * measured;
+            tk_state.residual_ppm = fmaxf(fabsf(measured), floorPpm);
+        }
+
+        MLOG_I("Disciplina: error %ld ms en %llu s, deriva %.0f ppm",
+               (long)tk_state.last_error_ms, (unsigned long long)(elapsed / 1000000ULL),
+               tk_state.drift_ppm);
+    } else {
+        tk_state.drift_ppm = 0.0f;
+        tk_state.residual_ppm = TIMEKEEPER_INITIAL_PPM;
+        tk_state.last_error_ms = 0;
+        tk_state.disciplines = 0;
+        MLOG_I("Hora interna establecida: %u", epoch);
+    }
+
+    tk_state.offset_us = observed - (int64_t)t;
+    tk_state.anchor_us = t;
+    tk_state.resolution_ms = resolutionMs;
+    tk_state.wakes_since = 0;
+    if (tk_state.disciplines < 0xFFFF) {
+        tk_state.disciplines++;
+    }
+    tk_state.magic = TIMEKEEPER_MAGIC;
+    return true;
+}
+
+/**
+ * @brief Hora actual a partir del temporizador interno.
+ * @return Timestamp Unix o 0 si no hay hora válida.
+ */
+uint32_t TimeKeeper::now() {
+    if (!isValid()) {
+        return 0;
+    }
+    return (uint32_t)(epochUs(rtcTimeUs()) / 1000000LL);
+}
+
+/**
+ * @brief Escribe la hora actual formateada en el buffer del llamador.
+ * @param buffer Destino (al menos RTC_DATETIME_LEN bytes).
+ * @param size Tamaño del buffer.
+ * @return true si hay hora válida.
+ */
+bool TimeKeeper::getFormattedDateTime(char* buffer, size_t size) {
+    if (buffer == nullptr || size == 0) return false;
+
+    if (!isValid()) {
+        snprintf(buffer, size, "No disponible");
+        return false;
+    }
+
+    time_t t = (time_t)now();
+    struct tm timeinfo;
+    gmtime_r(&t, &timeinfo); // Hora de pared, igual que MAX31328RTC::toEpoch()
+    strftime(buffer, size, "%Y-%m-%d %H:%M:%S", &timeinfo);
+    return true;
+}
+
+/**
+ * @brief Indica si hay un desfase válido.
+ */
+bool TimeKeeper::isValid() {
+    return tk_state.magic == TIMEKEEPER_MAGIC;
+}
+
+/**
+ * @brief Cota de error: media resolución de la referencia más la deriva residual acumulada.
+ * @return Milisegundos (0 si no hay hora válida).
+ */
+uint32_t TimeKeeper::getEstimatedErrorMs() {
+    if (!isValid()) {
+        return 0;
+    }
+    double elapsedS = (double)(rtcTimeUs() - tk_state.anchor_us) / 1e6;
+    double ppm = tk_state.residual_ppm + TIMEKEEPER_MARGIN_PPM;
+    return (uint32_t)(tk_state.resolution_ms / 2 + elapsedS * ppm / 1000.0);
+}
+
+/**
+ * @brief Deriva estimada del oscilador interno en ppm.
+ */
+float TimeKeeper::getDriftPpm() {
+    return isValid() ? tk_state.drift_ppm : 0.0f;
+}
+
+/**
+ * @brief Despertares desde la última disciplina.
+ */
+uint16_t TimeKeeper::getWakesSinceDiscipline() {
+    return isValid() ? tk_state.wakes_since : 0;
+}
+
+/**
+ * @brief Escribe el estado de la base de tiempo en el buffer del llamador.
+ * @param buffer Destino del texto.
+ * @param size Tamaño del buffer.
+ * @return Longitud del texto completo (semántica de snprintf).
+ */
+size_t TimeKeeper::getStatus(char* buffer, size_t size) {
+    char datetime[RTC_DATETIME_LEN];
+    getFormattedDateTime(datetime, sizeof(datetime));
+
+    int n = snprintf(buffer, size,
+                     "Hora interna: %s\n"
+                     "Válida: %s\n"
+                     "Error estimado: ±%u ms (máx %u)\n"
+                     "Deriva: %.0f ppm (residual %.0f)\n"
+                     "Despertares desde disciplina: %u/%u\n"
+                     "Último error observado: %ld ms",
+                     datetime,
+                     isValid() ? "Sí" : "No",
+                     getEstimatedErrorMs(), _maxErrorMs,
+                     getDriftPpm(), isValid() ? tk_state.residual_ppm : 0.0f,
+                     getWakesSinceDiscipline(), _resyncWakes,
+                     isValid() ? (long)tk_state.last_error_ms : 0L);
+
+    return (n > 0) ? (size_t)n : 0;
+}
+
+/**
+ * @brief Habilita o deshabilita la salida por Serial.
+ */
+void TimeKeeper::enableSerial(bool enable) {
+    _enableSerialOutput = enable;
+}
+
+/**
+ * @brief Configura un callback externo para logging.
+ */
+void TimeKeeper::setLogCallback(LogCallback callback) {
+    _logCallback = callback;
+}
+
+// ——— FUNCIONES AUXILIARES ———
+
+/**
+ * @brief Lee el temporizador RTC (sigue contando en deep sleep).
+ */
+uint64_t TimeKeeper::rtcTimeUs() {
+    return HAL::rtcTimeUs();
+}
+
+/**
+ * @brief Convierte una lectura del temporizador interno a hora Unix en µs.
+ * @param rtcUs Lectura del temporizador.
+ */
+int64_t TimeKeeper::epochUs(uint64_t rtcUs) {
+    double elapsed = (double)(rtcUs - tk_state.anchor_us);
+    int64_t correction = (int64_t)(elapsed * tk_state.drift_ppm / 1e6);
+    return (int64_t)rtcUs + tk_state.offset_us - correction;
+}
+
+/**
+ * @brief Envía un mensaje de log con formato estilo printf.
+ * @param level Nivel LOG_LEVEL_* del mensaje.
+ * @param format Cadena de formato printf.
+ * @param ... Argumentos variables para format.
+ */
+void TimeKeeper::logf(uint8_t level, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    if (_logCallback) {
+        char buffer[LOG_LINE_MAX];
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        _logCallback(buffer);
+    } else if (_enableSerialOutput) {
+        Logger::vwrite(level, TAG, format, args);
+    }
+    va_end(args);
+}
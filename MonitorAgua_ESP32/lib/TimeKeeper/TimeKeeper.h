@@ -0,0 +1,161 @@
+/**
+ * @file TimeKeeper.h
+ * @brief Base de tiempo del sistema sobre el temporizador RTC interno del ESP32.
+ *
+ * El temporizador RTC del ESP32 sigue contando durante el deep sleep. Esta clase
+ * guarda en RTC memory el desfase entre ese contador y la hora Unix, de modo que
+ * obtener un timestamp cuesta una lectura de registro en lugar de una transacción
+ * I2C con el MAX31328. El RTC externo (o NTP) solo se consulta para "disciplinar"
+ * el desfase cada N despertares, o antes si la cota de error estimada supera el
+ * máximo permitido.
+ *
+ * En cada disciplina se compara la hora predicha con la de referencia y se estima
+ * la deriva del oscilador lento (ppm), que se corrige en las lecturas siguientes.
+ *
+ * @author Daniel Acosta - Santiago Erazo
+ * @version 1.0
+ * @date 2025-10-01
+ */
+
+#ifndef TIME_KEEPER_H
+#define TIME_KEEPER_H
+
+#include <Arduino.h>
+#include "RTC.h"
+#include "RTCDrift.h"
+
+// ——— Configuración ———
+#define TIMEKEEPER_RESYNC_WAKES      45       // Despertares entre disciplinas (≈1 h con ciclos de 80 s)
+#define TIMEKEEPER_MAX_ERROR_MS      2000     // Cota de error que fuerza disciplina anticipada
+#define TIMEKEEPER_INITIAL_PPM       5000.0f  // Incertidumbre de deriva antes de la primera estimación
+#define TIMEKEEPER_MARGIN_PPM        50.0f    // Margen sumado a la deriva residual (temperatura)
+#define TIMEKEEPER_MIN_LEARN_S       120      // Intervalo mínimo para estimar deriva
+#define TIMEKEEPER_MIN_EPOCH         1609459200UL  // 2021-01-01: referencias anteriores se rechazan
+
+/**
+ * @class TimeKeeper
+ * @brief Reloj Unix mantenido por el temporizador RTC interno y disciplinado por el MAX31328.
+ */
+class TimeKeeper {
+public:
+    /**
+     * @brief Constructor
+     * @param resyncWakes Despertares máximos entre disciplinas
+     * @param maxErrorMs Cota de error estimado (ms) que fuerza disciplina
+     * @param enableSerial Habilitar mensajes por Serial
+     */
+    TimeKeeper(uint16_t resyncWakes = TIMEKEEPER_RESYNC_WAKES,
+               uint32_t maxErrorMs = TIMEKEEPER_MAX_ERROR_MS,
+               bool enableSerial = true);
+
+    /**
+     * @brief Valida el estado en RTC memory y cuenta el despertar (sin acceso I2C)
+     */
+    void begin();
+
+    /**
+     * @brief Indica si este ciclo debe leer el RTC externo
+     * @return true si no hay hora válida, se cumplieron N despertares o la cota de error se excede
+     */
+    bool needsDiscipline();
+
+    /**
+     * @brief Asociar el estimador de deriva del RTC externo
+     * @details Si está asociado, las lecturas del MAX31328 se corrigen con la deriva
+     *          residual acumulada desde su último ajuste.
+     * @param estimator Estimador (nullptr para no corregir)
+     */
+    void setDriftEstimator(RTCDriftEstimator* estimator);
+
+    /**
+     * @brief Disciplina con el RTC externo (lectura en ráfaga fresca)
+     * @param rtc RTC ya inicializado
+     * @return true si se aceptó la referencia
+     */
+    bool discipline(MAX31328RTC& rtc);
+
+    /**
+     * @brief Disciplina con una hora de referencia (p. ej. NTP o servidor)
+     * @param epoch Timestamp Unix de referencia
+     * @param resolutionMs Resolución de la referencia (ms); centra el desfase en el intervalo
+     * @return true si se aceptó la referencia
+     */
+    bool discipline(uint32_t epoch, uint32_t resolutionMs = 1000);
+
+    /**
+     * @brief Hora actual
+     * @return Timestamp Unix o 0 si no hay hora válida
+     */
+    uint32_t now();
+
+    /**
+     * @brief Escribe "YYYY-MM-DD HH:MM:SS" en el buffer del llamador
+     * @param buffer Destino (al menos RTC_DATETIME_LEN bytes)
+     * @param size Tamaño del buffer
+     * @return true si hay hora válida; false deja "No disponible"
+     */
+    bool getFormattedDateTime(char* buffer, size_t size);
+
+    /**
+     * @brief Indica si hay un desfase válido desde alguna disciplina previa
+     */
+    bool isValid();
+
+    /**
+     * @brief Cota de error estimada desde la última disciplina
+     * @return Milisegundos (0 si no hay hora válida)
+     */
+    uint32_t getEstimatedErrorMs();
+
+    /**
+     * @brief Deriva estimada del oscilador lento interno
+     * @return ppm (positivo: el contador interno adelanta)
+     */
+    float getDriftPpm();
+
+    /**
+     * @brief Despertares transcurridos desde la última disciplina
+     */
+    uint16_t getWakesSinceDiscipline();
+
+    /**
+     * @brief Escribir estado en un buffer del llamador
+     * @param buffer Destino del texto
+     * @param size Tamaño del buffer
+     * @return Longitud del texto completo (semántica de snprintf)
+     */
+    size_t getStatus(char* buffer, size_t size);
+
+    /**
+     * @brief Habilitar/deshabilitar salida por Serial
+     */
+    void enableSerial(bool enable);
+
+    /**
+     * @brief Configurar callback para logging personalizado
+     */
+    typedef void (*LogCallback)(const char* message);
+    void setLogCallback(LogCallback callback);
+
+private:
+    uint16_t _resyncWakes;      ///< Despertares máximos entre disciplinas
+    uint32_t _maxErrorMs;       ///< Cota de error que fuerza disciplina
+    bool _enableSerialOutput;   ///< Habilitar salida por Serial
+    LogCallback _logCallback;   ///< Callback opcional de log
+    RTCDriftEstimator* _driftEstimator; ///< Corrección de deriva del MAX31328 (opcional)
+
+    /**
+     * @brief Lee el temporizador RTC interno
+     * @return Microsegundos desde el último reset de dominio RTC
+     */
+    uint64_t rtcTimeUs();
+
+    /**
+     * @brief Hora Unix en µs para una lectura del temporizador interno, con corrección de deriva
+     */
+    int64_t epochUs(uint64_t rtcUs);
+
+    void logf(uint8_t level, const char* format, ...) __attribute__((format(printf, 3, 4)));
+};
+
+#endif // TIME_KEEPER_H
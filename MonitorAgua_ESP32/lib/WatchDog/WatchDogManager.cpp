@@ -11,8 +11,11 @@
  */
 
 #include "WatchDogManager.h"
+#include "Logger.h"
 #include <stdarg.h>
 
+static const char TAG[] = "WDT"; ///< Etiqueta de log del módulo
+
 // ——— Variables RTC persistentes al deep sleep ———
 
 /**
@@ -23,7 +26,7 @@
  *          para sobrevivir deep sleep y resets suaves.
  * @note Valor inicial: 100 (primera ejecución), 85 (después de reset parcial).
  */
-RTC_DATA_ATTR uint32_t wdt_system_health_score = 100;
+HAL_PERSISTENT uint32_t wdt_system_health_score = 100;
 
 /**
  * @var wdt_consecutive_failures
@@ -31,7 +34,7 @@ RTC_DATA_ATTR uint32_t wdt_system_health_score = 100;
  * @details Incrementa con cada recordFailure(), resetea a 0 con recordSuccess().
  *          Usado para detectar condiciones de pánico (≥10 fallos → emergencia).
  */
-RTC_DATA_ATTR uint32_t wdt_consecutive_failures = 0;
+HAL_PERSISTENT uint32_t wdt_consecutive_failures = 0;
 
 /**
  * @var wdt_last_successful_operation
@@ -39,7 +42,7 @@ RTC_DATA_ATTR uint32_t wdt_consecutive_failures = 0;
  * @details Usado para detectar deadlocks o cuelgues prolongados. Si han pasado >10 minutos
  *          sin éxito, se loguea warning de timing issue.
  */
-RTC_DATA_ATTR uint32_t wdt_last_successful_operation = 0;
+HAL_PERSISTENT uint32_t wdt_last_successful_operation = 0;
 
 /**
  * @var wdt_total_errors
@@ -47,23 +50,23 @@ RTC_DATA_ATTR uint32_t wdt_last_successful_operation = 0;
  * @details Incrementa monotónicamente con cada logError(). Útil para estadísticas
  *          a largo plazo sobre estabilidad del sistema.
  */
-RTC_DATA_ATTR uint16_t wdt_total_errors = 0;
+HAL_PERSISTENT uint16_t wdt_total_errors = 0;
 
 /**
  * @var wdt_critical_errors
  * @brief Buffer circular de errores críticos en RTC Memory
  * @details Almacena hasta MAX_CRITICAL_ERRORS (8) errores críticos. Cuando está lleno,
- *          sobrescribe el error más antiguo (posición 0). Sobrevive deep sleep.
+ *          sobrescribe el error más antiguo. Sobrevive deep sleep.
  */
-RTC_DATA_ATTR WatchdogManager::ErrorEntry wdt_critical_errors[WatchdogManager::MAX_CRITICAL_ERRORS];
+HAL_PERSISTENT RingBuffer<WatchdogManager::ErrorEntry, WatchdogManager::MAX_CRITICAL_ERRORS> wdt_critical_errors;
 
 /**
  * @var wdt_warning_errors
- * @brief Buffer FIFO de errores warning en RTC Memory
- * @details Almacena hasta MAX_WARNING_ERRORS (16) warnings. Cuando está lleno, hace
- *          shift FIFO descartando el más antiguo. Sobrevive deep sleep.
+ * @brief Buffer circular de errores warning en RTC Memory
+ * @details Almacena hasta MAX_WARNING_ERRORS (16) warnings. Cuando está lleno,
+ *          descarta el más antiguo. Sobrevive deep sleep.
  */
-RTC_DATA_ATTR WatchdogManager::ErrorEntry wdt_warning_errors[WatchdogManager::MAX_WARNING_ERRORS];
+HAL_PERSISTENT RingBuffer<WatchdogManager::ErrorEntry, WatchdogManager::MAX_WARNING_ERRORS> wdt_warning_errors;
 
 /**
  * @var wdt_info_errors
@@ -71,7 +74,7 @@ RTC_DATA_ATTR WatchdogManager::ErrorEntry wdt_warning_errors[WatchdogManager::MA
  * @details Almacena hasta MAX_INFO_ERRORS (32) errores info. Cuando está lleno,
  *          descarta nuevos errores info (no hace shift). Sobrevive deep sleep.
  */
-RTC_DATA_ATTR WatchdogManager::ErrorEntry wdt_info_errors[WatchdogManager::MAX_INFO_ERRORS];
+HAL_PERSISTENT StaticVector<WatchdogManager::ErrorEntry, WatchdogManager::MAX_INFO_ERRORS> wdt_info_errors;
 
 // Variable para detectar modo de watchdog
 
@@ -117,19 +120,19 @@ void WatchdogManager::begin() {
         delay(100);
     }
     
-    log("=== Watchdog Manager Inicializado ===");
+    MLOG_I("=== Watchdog Manager Inicializado ===");
     
     // Intentar inicializar watchdog
     if (initializeHardwareWatchdog()) {
         _watchdogInitialized = true;
         if (hardware_watchdog_available) {
-            log(" Hardware watchdog inicializado");
+            MLOG_I(" Hardware watchdog inicializado");
         } else {
-            log(" Watchdog en modo software inicializado");
+            MLOG_I(" Watchdog en modo software inicializado");
         }
     } else {
         _watchdogInitialized = false;
-        log(" Fallo en inicialización de watchdog");
+        MLOG_E(" Fallo en inicialización de watchdog");
     }
     
     // Inicializar timestamp si es primera ejecución
@@ -139,11 +142,16 @@ void WatchdogManager::begin() {
         //log(" Primera ejecución - inicializando variables de salud");
     }
     
+    // Descartar buffers de errores con índices corruptos (RTC Memory sin CRC)
+    if (!wdt_critical_errors.isValid()) wdt_critical_errors.clear();
+    if (!wdt_warning_errors.isValid()) wdt_warning_errors.clear();
+    if (!wdt_info_errors.isValid()) wdt_info_errors.clear();
+    
     _lastHealthCheck = millis();
     
-    logf(" Salud inicial del sistema: %d%%", wdt_system_health_score);
-    logf(" Fallos consecutivos: %d", wdt_consecutive_failures);
-    logf(" Modo watchdog: %s", hardware_watchdog_available ? "Hardware" : "Software");
+    MLOG_I(" Salud inicial del sistema: %d%%", wdt_system_health_score);
+    MLOG_I(" Fallos consecutivos: %d", wdt_consecutive_failures);
+    MLOG_I(" Modo watchdog: %s", hardware_watchdog_available ? "Hardware" : "Software");
 }
 
 // Alimentar watchdog
@@ -165,7 +173,7 @@ void WatchdogManager::feedWatchdog() {
         esp_err_t result = esp_task_wdt_reset();
         if (result != ESP_OK && result != ESP_ERR_NOT_FOUND) {
             hardware_watchdog_available = false;
-            log(" Watchdog hardware falló - cambiando a modo software");
+            MLOG_E(" Watchdog hardware falló - cambiando a modo software");
         }
     }
 }
@@ -178,7 +186,7 @@ void WatchdogManager::feedWatchdog() {
  *          1. Crea estructura ErrorEntry con código, severidad y contexto
  *          2. Almacena en buffer apropiado según severidad:
  *             - CRITICAL: Sobrescribe más antiguo si lleno
- *             - WARNING: Hace shift FIFO si lleno
+ *             - WARNING: Descarta el más antiguo si lleno (buffer circular)
  *             - INFO: Descarta si lleno
  *          3. Incrementa contador total de errores
  *          4. Llama callback de error si está configurado
@@ -194,7 +202,7 @@ void WatchdogManager::logError(error_code_t code, error_severity_t severity, uin
     //warning hace shift FIFO
     //Info simplemente descarta
     //aumenta contador de errores y llama al callback de error si fue configurado
-    logf(" Logging error: code=%d, severity=%d, context=%u", code, severity, context);
+    MLOG_I(" Logging error: code=%d, severity=%d, context=%u", code, severity, context);
     
     ErrorEntry error;
     error.error_code = code;
@@ -209,47 +217,22 @@ void WatchdogManager::logError(error_code_t code, error_severity_t severity, uin
     bool stored = false;
     switch (severity) {
         case SEVERITY_CRITICAL:
-            for (int i = 0; i < MAX_CRITICAL_ERRORS; i++) {
-                if (wdt_critical_errors[i].error_code == ERROR_NONE) {
-                    wdt_critical_errors[i] = error;
-                    stored = true;
-                    break;
-                }
-            }
-            if (!stored) {
-                wdt_critical_errors[0] = error;
-                stored = true;
-                log(" Buffer crítico lleno - sobrescribiendo error más antiguo");
+            if (wdt_critical_errors.full()) {
+                MLOG_W(" Buffer crítico lleno - sobrescribiendo error más antiguo");
             }
+            wdt_critical_errors.push(error);
+            stored = true;
             break;
             
         case SEVERITY_WARNING:
-            for (int i = 0; i < MAX_WARNING_ERRORS; i++) {
-                if (wdt_warning_errors[i].error_code == ERROR_NONE) {
-                    wdt_warning_errors[i] = error;
-                    stored = true;
-                    break;
-                }
-            }
-            if (!stored) {
-                for (int i = 0; i < MAX_WARNING_ERRORS - 1; i++) {
-                    wdt_warning_errors[i] = wdt_warning_errors[i + 1];
-                }
-                wdt_warning_errors[MAX_WARNING_ERRORS - 1] = error;
-                stored = true;
-            }
+            wdt_warning_errors.push(error);
+            stored = true;
             break;
             
         case SEVERITY_INFO:
-            for (int i = 0; i < MAX_INFO_ERRORS; i++) {
-                if (wdt_info_errors[i].error_code == ERROR_NONE) {
-                    wdt_info_errors[i] = error;
-                    stored = true;
-                    break;
-                }
-            }
+            stored = wdt_info_errors.push_back(error);
             if (!stored) {
-                log("ℹ Buffer de info lleno - error descartado");
+                MLOG_D("ℹ Buffer de info lleno - error descartado");
                 return;
             }
             break;
@@ -257,7 +240,7 @@ void WatchdogManager::logError(error_code_t code, error_severity_t severity, uin
     
     if (stored) {
         wdt_total_errors++;
-        log(" Error almacenado en RTC Memory");
+        MLOG_D(" Error almacenado en RTC Memory");
         
         if (_errorCallback) {
             _errorCallback(code, severity, context);
@@ -282,7 +265,7 @@ void WatchdogManager::logError(error_code_t code, error_severity_t severity, uin
  */
 bool WatchdogManager::performHealthCheck() {
     //verifica memoria, tiempos, cantidad de fallos consecutivos y suma o resta al puntaje de salud
-    log(" Verificando salud del sistema...");
+    MLOG_I(" Verificando salud del sistema...");
     
     bool system_ok = true;
     _lastHealthCheck = millis();
@@ -296,7 +279,7 @@ bool WatchdogManager::performHealthCheck() {
     }
     
     if (wdt_consecutive_failures >= 3) {
-        logf(" Fallos consecutivos: %d", wdt_consecutive_failures);
+        MLOG_W(" Fallos consecutivos: %d", wdt_consecutive_failures);
         system_ok = false;
     }
     
@@ -314,7 +297,7 @@ bool WatchdogManager::performHealthCheck() {
         }
     }
     
-    logf(" Salud del sistema: %d%%", wdt_system_health_score);
+    MLOG_I(" Salud del sistema: %d%%", wdt_system_health_score);
     
     return (wdt_system_health_score > 20 || wdt_consecutive_failures < 5);
 }
@@ -361,7 +344,7 @@ void WatchdogManager::recordFailure() {
         wdt_system_health_score = 0;
     }
     
-    logf(" Fallo registrado - Consecutivos: %d (Health: %d%%)", 
+    MLOG_W(" Fallo registrado - Consecutivos: %d (Health: %d%%)", 
             wdt_consecutive_failures, wdt_system_health_score);
 }
 
@@ -413,11 +396,11 @@ bool WatchdogManager::attemptRecovery() {
     //restea parcialmente el sistema
     //limpia info y warnings, reduce a la mitad los fallos consecutivos, fija la salud al 50%
     //actualiza el timestamp de la última operación exitosa
-    log(" Intentando recuperación del sistema...");
+    MLOG_I(" Intentando recuperación del sistema...");
     
     // Limpiar errores no críticos
-    memset(&wdt_warning_errors, 0, sizeof(wdt_warning_errors));
-    memset(&wdt_info_errors, 0, sizeof(wdt_info_errors));
+    wdt_warning_errors.clear();
+    wdt_info_errors.clear();
     
     // Reducir fallos consecutivos
     if (wdt_consecutive_failures > 2) {
@@ -428,7 +411,7 @@ bool WatchdogManager::attemptRecovery() {
     wdt_system_health_score = 50;
     wdt_last_successful_operation = millis();
     
-    logf(" Recovery completado - Health: %d%%, Fallos: %d", 
+    MLOG_I(" Recovery completado - Health: %d%%, Fallos: %d", 
             wdt_system_health_score, wdt_consecutive_failures);
     
     return true;
@@ -449,16 +432,16 @@ bool WatchdogManager::attemptRecovery() {
 void WatchdogManager::handleEmergency() {
     //se ejecuta cuando el sistema está en pánico, intenta recuperar el sistema
     //en caso de fallo notifica por callback y queda en modo emergencia 
-    log(" MANEJO DE EMERGENCIA DEL SISTEMA");
+    MLOG_W(" MANEJO DE EMERGENCIA DEL SISTEMA");
     
     logError(ERROR_SYSTEM_PANIC, SEVERITY_CRITICAL, wdt_consecutive_failures);
     
     if (attemptRecovery()) {
-        log(" Recovery de emergencia exitoso");
+        MLOG_I(" Recovery de emergencia exitoso");
         return;
     }
     
-    log(" Recovery falló - Sistema en modo de emergencia");
+    MLOG_E(" Recovery falló - Sistema en modo de emergencia");
     
     if (_errorCallback) {
         _errorCallback(ERROR_SYSTEM_PANIC, SEVERITY_CRITICAL, wdt_consecutive_failures);
@@ -479,16 +462,16 @@ void WatchdogManager::handleEmergency() {
  * @note Útil para debugging y monitoreo en desarrollo.
  */
 void WatchdogManager::displaySystemHealth() {
-    log("\n --- ESTADO DE SALUD DEL SISTEMA ---");
-    logf("Salud general: %d%%", wdt_system_health_score);
-    logf("Fallos consecutivos: %d", wdt_consecutive_failures);
-    logf("Última operación exitosa: %u ms", wdt_last_successful_operation);
-    logf("Total errores: %d", wdt_total_errors);
-    logf("Memoria libre: %d bytes", ESP.getFreeHeap());
-    logf("Watchdog: %s (%s)", 
+    MLOG_I("\n --- ESTADO DE SALUD DEL SISTEMA ---");
+    MLOG_I("Salud general: %d%%", wdt_system_health_score);
+    MLOG_I("Fallos consecutivos: %d", wdt_consecutive_failures);
+    MLOG_I("Última operación exitosa: %u ms", wdt_last_successful_operation);
+    MLOG_I("Total errores: %d", wdt_total_errors);
+    MLOG_I("Memoria libre: %d bytes", ESP.getFreeHeap());
+    MLOG_I("Watchdog: %s (%s)", 
             _watchdogInitialized ? "Funcionando" : "Inactivo",
             hardware_watchdog_available ? "Hardware" : "Software");
-    log("----------------------------------");
+    MLOG_I("----------------------------------");
 }
 
 // Mostrar log de errores
@@ -504,44 +487,46 @@ void WatchdogManager::displaySystemHealth() {
  * @note Reconstruye contexto de 32 bits desde 4 bytes almacenados.
  */
 void WatchdogManager::displayErrorLog(int maxErrors) {
-    log("\n --- LOG DE ERRORES ---");
-    logf("Total errores registrados: %d", wdt_total_errors);
+    MLOG_I("\n --- LOG DE ERRORES ---");
+    MLOG_I("Total errores registrados: %d", wdt_total_errors);
     
-    log("Errores CRÍTICOS:");
+    MLOG_I("Errores CRÍTICOS:");
     bool found_critical = false;
-    for (int i = 0; i < MAX_CRITICAL_ERRORS; i++) {
-        if (wdt_critical_errors[i].error_code != ERROR_NONE) {
-            uint32_t context = (wdt_critical_errors[i].context[0] << 24) |
-                                (wdt_critical_errors[i].context[1] << 16) |
-                                (wdt_critical_errors[i].context[2] << 8) |
-                                wdt_critical_errors[i].context[3];
-            logf("  🔴 Código:%d | Tiempo:%dm | Contexto:%u",
-                    wdt_critical_errors[i].error_code,
-                    wdt_critical_errors[i].timestamp_min,
+    for (size_t i = 0; i < wdt_critical_errors.size(); i++) {
+        const ErrorEntry& entry = wdt_critical_errors[i];
+        if (entry.error_code != ERROR_NONE) {
+            uint32_t context = (entry.context[0] << 24) |
+                                (entry.context[1] << 16) |
+                                (entry.context[2] << 8) |
+                                entry.context[3];
+            MLOG_I("  🔴 Código:%d | Tiempo:%dm | Contexto:%u",
+                    entry.error_code,
+                    entry.timestamp_min,
                     context);
             found_critical = true;
         }
     }
-    if (!found_critical) log("   Sin errores críticos");
+    if (!found_critical) MLOG_I("   Sin errores críticos");
     
-    logf("Errores WARNING (últimos %d):", maxErrors);
+    MLOG_I("Errores WARNING (últimos %d):", maxErrors);
     int warning_count = 0;
-    for (int i = MAX_WARNING_ERRORS - 1; i >= 0 && warning_count < maxErrors; i--) {
-        if (wdt_warning_errors[i].error_code != ERROR_NONE) {
-            uint32_t context = (wdt_warning_errors[i].context[0] << 24) |
-                                (wdt_warning_errors[i].context[1] << 16) |
-                                (wdt_warning_errors[i].context[2] << 8) |
-                                wdt_warning_errors[i].context[3];
-            logf("  🟡 Código:%d | Tiempo:%dm | Contexto:%u",
-                    wdt_warning_errors[i].error_code,
-                    wdt_warning_errors[i].timestamp_min,
+    for (size_t i = 0; i < wdt_warning_errors.size() && warning_count < maxErrors; i++) {
+        const ErrorEntry& entry = wdt_warning_errors.recent(i);
+        if (entry.error_code != ERROR_NONE) {
+            uint32_t context = (entry.context[0] << 24) |
+                                (entry.context[1] << 16) |
+                                (entry.context[2] << 8) |
+                                entry.context[3];
+            MLOG_I("  🟡 Código:%d | Tiempo:%dm | Contexto:%u",
+                    entry.error_code,
+                    entry.timestamp_min,
                     context);
             warning_count++;
         }
     }
-    if (warning_count == 0) log("   Sin warnings recientes");
+    if (warning_count == 0) MLOG_I("   Sin warnings recientes");
     
-    log("---------------------------");
+    MLOG_I("---------------------------");
 }
 
 // Configurar callbacks
@@ -606,7 +591,7 @@ bool WatchdogManager::isWatchdogHealthy() {
  */
 bool WatchdogManager::initializeHardwareWatchdog() {
     //intenta configurar el watchdog hardware por 15 segundos
-    log(" Inicializando Watchdog...");
+    MLOG_I(" Inicializando Watchdog...");
     
     hardware_watchdog_available = false;
     
@@ -616,7 +601,7 @@ bool WatchdogManager::initializeHardwareWatchdog() {
     esp_err_t result = esp_task_wdt_add(NULL);
     if (result == ESP_OK) {
         hardware_watchdog_available = true;
-        log(" Conectado a watchdog hardware existente");
+        MLOG_I(" Conectado a watchdog hardware existente");
         return true;
     }
     
@@ -626,13 +611,13 @@ bool WatchdogManager::initializeHardwareWatchdog() {
         result = esp_task_wdt_add(NULL);
         if (result == ESP_OK) {
             hardware_watchdog_available = true;
-            log(" Watchdog hardware inicializado (15s)");
+            MLOG_I(" Watchdog hardware inicializado (15s)");
             return true;
         }
     }
     
     // Fallback: Modo software
-    log("📱 Activando modo software");
+    MLOG_I("📱 Activando modo software");
     hardware_watchdog_available = false;
     return true;
 }
@@ -650,10 +635,10 @@ bool WatchdogManager::checkMemoryHealth() {
     size_t free_heap = ESP.getFreeHeap();
     if (free_heap < 10000) {
         logError(ERROR_MEMORY_LOW, SEVERITY_WARNING, free_heap);
-        logf(" Memoria baja: %d bytes libres", free_heap);
+        MLOG_W(" Memoria baja: %u bytes libres", (unsigned)free_heap);
         return false;
     } else {
-        logf(" Memoria disponible: %d bytes", free_heap);
+        MLOG_I(" Memoria disponible: %u bytes", (unsigned)free_heap);
         return true;
     }
 }
@@ -675,54 +660,46 @@ bool WatchdogManager::checkTimingHealth() {
         if (current_time >= wdt_last_successful_operation) {
             time_diff = current_time - wdt_last_successful_operation;
         } else {
-            log(" Overflow de millis() detectado - reiniciando contador");
+            MLOG_W(" Overflow de millis() detectado - reiniciando contador");
             wdt_last_successful_operation = current_time;
             time_diff = 0;
         }
         
         if (time_diff > 600000) {
-            logf(" Tiempo desde última operación exitosa: %u ms", time_diff);
+            MLOG_I(" Tiempo desde última operación exitosa: %u ms", time_diff);
             logError(ERROR_TIMING_ISSUE, SEVERITY_WARNING, time_diff);
             return false;
         } else {
-            logf(" Última operación exitosa hace: %u ms", time_diff);
+            MLOG_I(" Última operación exitosa hace: %u ms", time_diff);
             return true;
         }
     } else {
-        log("ℹ Primera ejecución - no hay operaciones previas");
+        MLOG_I("ℹ Primera ejecución - no hay operaciones previas");
         wdt_last_successful_operation = current_time;
         return true;
     }
 }
 
-// Métodos de logging
-
+// Métodos privados de logging
 /**
- * @brief Envía mensaje de log mediante callback o Serial
- * @param message Cadena de texto a imprimir
- * @note Si _logCallback está configurado, lo usa; de lo contrario usa Serial si habilitado.
+ * @brief Envía un mensaje de log con formato estilo printf.
+ * @param level Nivel LOG_LEVEL_* del mensaje.
+ * @param format Cadena de formato printf.
+ * @param ... Argumentos variables para format.
+ * @note Si hay callback registrado se formatea aquí y se le entrega la línea;
+ *       en caso contrario se delega en Logger (modo texto o binario).
+ * @note Se invoca a través de las macros MLOG_*, que eliminan en compilación
+ *       los niveles por encima de LOG_LEVEL.
  */
-void WatchdogManager::log(const char* message) {
-    if (_logCallback) {
-        _logCallback(message);
-    } else if (_enableSerialOutput && Serial) {
-        Serial.println(message);
-    }
-}
-
-/**
- * @brief Envía mensaje de log con formato estilo printf
- * @param format Cadena de formato printf
- * @param ... Argumentos variables para format
- * @note Buffer interno de 256 caracteres. Mensajes más largos se truncan.
- * @note Usa vsnprintf para seguridad (previene buffer overflow).
- */
-void WatchdogManager::logf(const char* format, ...) {
-    char buffer[256];
+void WatchdogManager::logf(uint8_t level, const char* format, ...) {
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    if (_logCallback) {
+        char buffer[LOG_LINE_MAX];
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        _logCallback(buffer);
+    } else if (_enableSerialOutput) {
+        Logger::vwrite(level, TAG, format, args);
+    }
     va_end(args);
-    
-    log(buffer);
-}
\ No newline at end of file
+}
@@ -17,7 +17,10 @@
 #include <Arduino.h>
 #include "esp_task_wdt.h"
 #include "esp_system.h"
+#include "HAL.h"
 #include <string.h>
+#include "RingBuffer.h"
+#include "StaticVector.h"
 
 /**
  * @class WatchdogManager
@@ -128,21 +131,21 @@ public:
     /**
      * @brief Número máximo de errores CRITICAL almacenables en RTC Memory
      * @details Buffer circular: cuando está lleno, sobrescribe el error más antiguo.
-     *          8 errores × 6 bytes = 48 bytes de RTC Memory.
+     *          8 errores × 8 bytes = 64 bytes de RTC Memory (+4 de índices).
      */
     static const int MAX_CRITICAL_ERRORS = 8;
 
     /**
      * @brief Número máximo de errores WARNING almacenables en RTC Memory
-     * @details Buffer FIFO: cuando está lleno, hace shift descartando el más antiguo.
-     *          16 errores × 6 bytes = 96 bytes de RTC Memory.
+     * @details Buffer circular: cuando está lleno, descarta el más antiguo en O(1).
+     *          16 errores × 8 bytes = 128 bytes de RTC Memory (+4 de índices).
      */
     static const int MAX_WARNING_ERRORS = 16;
 
     /**
      * @brief Número máximo de errores INFO almacenables en RTC Memory
-     * @details Buffer simple: cuando está lleno, descarta nuevos errores info.
-     *          32 errores × 6 bytes = 192 bytes de RTC Memory.
+     * @details Vector simple: cuando está lleno, descarta nuevos errores info.
+     *          32 errores × 8 bytes = 256 bytes de RTC Memory (+2 de contador).
      */
     static const int MAX_INFO_ERRORS = 32;
 
@@ -366,20 +369,12 @@ private:
     bool checkTimingHealth();
     
     /**
-     * @brief Envía mensaje de log mediante callback o Serial
-     * @param message Cadena de texto a imprimir
-     * @note Si _logCallback configurado, lo usa; de lo contrario usa Serial si habilitado.
+     * @brief Envía mensaje de log con formato al backend común (usar macros MLOG_*)
+     * @param level Nivel LOG_LEVEL_* del mensaje
+     * @param format String de formato estilo printf
+     * @param ... Argumentos variables
      */
-    void log(const char* message);
-    
-    /**
-     * @brief Envía mensaje de log con formato estilo printf
-     * @param format Cadena de formato printf
-     * @param ... Argumentos variables para format
-     * @note Buffer interno de 256 caracteres. Mensajes más largos se truncan.
-     * @note Usa vsnprintf para seguridad (previene buffer overflow).
-     */
-    void logf(const char* format, ...);
+    void logf(uint8_t level, const char* format, ...) __attribute__((format(printf, 3, 4)));
 };
 
 // ——— Variables RTC para persistencia ———
@@ -389,48 +384,48 @@ private:
  * @brief Puntuación de salud del sistema (0-100), externa para acceso desde main
  * @note Variable RTC_DATA_ATTR declarada en .cpp, solo declaración extern aquí.
  */
-extern RTC_DATA_ATTR uint32_t wdt_system_health_score;
+extern HAL_PERSISTENT uint32_t wdt_system_health_score;
 
 /**
  * @var wdt_consecutive_failures
  * @brief Contador de fallos consecutivos, externo para acceso desde main
  * @note Variable RTC_DATA_ATTR declarada en .cpp, solo declaración extern aquí.
  */
-extern RTC_DATA_ATTR uint32_t wdt_consecutive_failures;
+extern HAL_PERSISTENT uint32_t wdt_consecutive_failures;
 
 /**
  * @var wdt_last_successful_operation
  * @brief Timestamp de última operación exitosa, externo para acceso desde main
  * @note Variable RTC_DATA_ATTR declarada en .cpp, solo declaración extern aquí.
  */
-extern RTC_DATA_ATTR uint32_t wdt_last_successful_operation;
+extern HAL_PERSISTENT uint32_t wdt_last_successful_operation;
 
 /**
  * @var wdt_total_errors
  * @brief Contador total de errores, externo para acceso desde main
  * @note Variable RTC_DATA_ATTR declarada en .cpp, solo declaración extern aquí.
  */
-extern RTC_DATA_ATTR uint16_t wdt_total_errors;
+extern HAL_PERSISTENT uint16_t wdt_total_errors;
 
 /**
  * @var wdt_critical_errors
  * @brief Buffer de errores críticos, externo para acceso desde main
  * @note Array RTC_DATA_ATTR declarado en .cpp, solo declaración extern aquí.
  */
-extern RTC_DATA_ATTR WatchdogManager::ErrorEntry wdt_critical_errors[8];
+extern HAL_PERSISTENT RingBuffer<WatchdogManager::ErrorEntry, WatchdogManager::MAX_CRITICAL_ERRORS> wdt_critical_errors;
 
 /**
  * @var wdt_warning_errors
  * @brief Buffer de errores warning, externo para acceso desde main
  * @note Array RTC_DATA_ATTR declarado en .cpp, solo declaración extern aquí.
  */
-extern RTC_DATA_ATTR WatchdogManager::ErrorEntry wdt_warning_errors[16];
+extern HAL_PERSISTENT RingBuffer<WatchdogManager::ErrorEntry, WatchdogManager::MAX_WARNING_ERRORS> wdt_warning_errors;
 
 /**
  * @var wdt_info_errors
  * @brief Buffer de errores info, externo para acceso desde main
  * @note Array RTC_DATA_ATTR declarado en .cpp, solo declaración extern aquí.
  */
-extern RTC_DATA_ATTR WatchdogManager::ErrorEntry wdt_info_errors[32];
+extern HAL_PERSISTENT StaticVector<WatchdogManager::ErrorEntry, WatchdogManager::MAX_INFO_ERRORS> wdt_info_errors;
 
 #endif // WATCHDOG_MANAGER_H
\ No newline at end of file
@@ -12,10 +12,17 @@
  */
 
 #include "WifiManager.h"
+#include "Logger.h"
+#include "Trace.h"
+#include "SensorBreaker.h"
+#include "DeltaReport.h"
 #include <stdarg.h>
 #include <time.h>
 
-extern MAX31328RTC rtcExterno;
+static const char TAG[] = "WIFI"; ///< Etiqueta de log del módulo
+
+static const size_t CALIB_RESPONSE_MAX = 768; ///< Respuesta de calibración (estado + parámetros + ajuste)
+
 // Añadir variable para modo manual
 
 /**
@@ -48,7 +55,9 @@ WiFiManager::WiFiManager(bool enableSerial)
     _wifiInitialized(false), _websocketConnected(false), _connectionStartTime(0),
     _totalDataSent(0), _lastErrorCode(0), _logCallback(nullptr), 
     _errorCallback(nullptr), _statusCallback(nullptr), _rtcMemory(nullptr),
-    _watchdog(nullptr), _calibrationManager(nullptr), _dataTransmissionComplete(false) {
+    _watchdog(nullptr), _calibrationManager(nullptr), _dataTransmissionComplete(false),
+    _pendingAlert(), _alertPending(false) {
+    _lastServerResponse[0] = '\0';
     
     // Configurar instancia estática para callback
     _instance = this;
@@ -75,12 +84,12 @@ void WiFiManager::begin(const wifi_config_t &config) {
         delay(100);
     }
     
-    log("=== WiFi Manager Inicializado (Modo Manual) ===");
-    logf("SSID: %s", _config.ssid);
-    logf("Servidor: %s:%d", _config.server_ip, _config.server_port);
-    logf("Timeout WiFi: %u ms", _config.connect_timeout_ms);
-    logf("Timeout WebSocket: %u ms", _config.websocket_timeout_ms);
-    log(" Modo descarga: MANUAL (por solicitud)");
+    MLOG_I("=== WiFi Manager Inicializado (Modo Manual) ===");
+    MLOG_I("SSID: %s", _config.ssid);
+    MLOG_I("Servidor: %s:%d", _config.server_ip, _config.server_port);
+    MLOG_I("Timeout WiFi: %u ms", _config.connect_timeout_ms);
+    MLOG_I("Timeout WebSocket: %u ms", _config.websocket_timeout_ms);
+    MLOG_I(" Modo descarga: MANUAL (por solicitud)");
     
     // Configurar modo WiFi
     WiFi.mode(WIFI_STA);
@@ -106,12 +115,12 @@ void WiFiManager::setManagers(RTCMemoryManager* rtcMemory, WatchdogManager* watc
     //metodo para configurar referencias a otros managers dando acceso a rtc y al watchdog
     _rtcMemory = rtcMemory;
     _watchdog = watchdog;
-    log(" Referencias a managers configuradas");
+    MLOG_I(" Referencias a managers configuradas");
 }
 
 void WiFiManager::setCalibrationManager(CalibrationManager* calibManager) {
     _calibrationManager = calibManager;
-    log("✓ CalibrationManager configurado");
+    MLOG_I("✓ CalibrationManager configurado");
 }
 
 // Conectar WiFi
@@ -137,7 +146,7 @@ bool WiFiManager::connectWiFi() {
     }
     
     updateStatus(WIFI_CONNECTING, "Conectando a WiFi...");
-    log(" Conectando a WiFi...");
+    MLOG_I(" Conectando a WiFi...");
     
     _connectionStartTime = millis(); //guarda instante de conexión
     
@@ -153,7 +162,7 @@ bool WiFiManager::connectWiFi() {
         uint32_t elapsed = millis() - startTime;
         
         if (elapsed > _config.connect_timeout_ms) {
-            logf(" Timeout conectando WiFi (%u ms)", elapsed);
+            MLOG_W(" Timeout conectando WiFi (%u ms)", elapsed);
             updateStatus(WIFI_ERROR, "Timeout WiFi");
             reportError(WatchdogManager::ERROR_WIFI_FAIL, WatchdogManager::SEVERITY_WARNING, elapsed);
             return false;
@@ -169,31 +178,20 @@ bool WiFiManager::connectWiFi() {
         
         // Log de progreso cada 2 segundos
         if (elapsed % 2000 < 100) {
-            logf("⏳ Conectando WiFi... %u ms", elapsed);
+            MLOG_D("⏳ Conectando WiFi... %u ms", elapsed);
         }
     }
     
     uint32_t connectionTime = millis() - startTime;
-    logf(" WiFi conectado en %u ms", connectionTime);
-    logf(" IP: %s", WiFi.localIP().toString().c_str());
-    logf(" RSSI: %d dBm", WiFi.RSSI());
+    MLOG_I(" WiFi conectado en %u ms", connectionTime);
+    IPAddress ip = WiFi.localIP();
+    MLOG_I(" IP: %u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    MLOG_I(" RSSI: %d dBm", WiFi.RSSI());
     
     updateStatus(WIFI_CONNECTED, "WiFi conectado");
 
-    // 🕒 --- SINCRONIZAR RTC CON NTP ---
-    // Solo si el RTC está inicializado y el WiFi conectado
-    if (rtcExterno.isPresent() && rtcExterno.isRunning()) {
-        log("🌐 Sincronizando RTC con NTP (pool.ntp.org, UTC-5)...");
-        if (rtcExterno.syncWithNTP("pool.ntp.org", -5)) {  // UTC-5 = Colombia
-            log("✅ RTC sincronizado correctamente con NTP");
-        } else {
-            log("⚠ No se pudo sincronizar RTC con NTP");
-        }
-    } else {
-        log("⚠ RTC no disponible, no se intentó sincronizar");
-    }
-    // 🕒 --------------------------------
-    
+    // La referencia NTP del RTC la toma main.cpp con RTCDriftEstimator cuando
+    // isSyncDue() lo pide: aquí no se escribe el RTC (una alerta no espera NTP)
     return true;
 }
 
@@ -216,12 +214,12 @@ bool WiFiManager::connectWiFi() {
 bool WiFiManager::connectWebSocket() {
     if (!isWiFiConnected()) {
         //verificca conexión wifi activa
-        log(" WiFi no conectado");
+        MLOG_W(" WiFi no conectado");
         return false;
     }
     
     updateStatus(WEBSOCKET_CONNECTING, "Conectando WebSocket...");
-    log(" Conectando WebSocket...");
+    MLOG_I(" Conectando WebSocket...");
     
     // Configurar y conectar WebSocket
     _webSocket.begin(_config.server_ip, _config.server_port, "/");
@@ -238,7 +236,7 @@ bool WiFiManager::connectWebSocket() {
         uint32_t elapsed = millis() - startTime;
         
         if (elapsed > _config.websocket_timeout_ms) {
-            logf(" Timeout conectando WebSocket (%u ms)", elapsed);
+            MLOG_W(" Timeout conectando WebSocket (%u ms)", elapsed);
             updateStatus(WEBSOCKET_ERROR, "Timeout WebSocket");
             reportError(WatchdogManager::ERROR_WIFI_FAIL, WatchdogManager::SEVERITY_WARNING, elapsed);
             return false;
@@ -256,12 +254,12 @@ bool WiFiManager::connectWebSocket() {
         
         // Log de progreso cada 1 segundo
         if (elapsed % 1000 < 50) {
-            logf("⏳ Conectando WebSocket... %u ms", elapsed);
+            MLOG_D("⏳ Conectando WebSocket... %u ms", elapsed);
         }
     }
     //luego calcula el tiempo total hasta la conexión
     uint32_t connectionTime = millis() - startTime;
-    logf(" WebSocket conectado en %u ms", connectionTime);
+    MLOG_I(" WebSocket conectado en %u ms", connectionTime);
     
     updateStatus(WEBSOCKET_CONNECTED, "WebSocket conectado");
     
@@ -287,11 +285,11 @@ bool WiFiManager::connectWebSocket() {
 bool WiFiManager::waitForDataRequest(uint32_t timeout_ms) {
     if (!isWebSocketConnected()) {
         //confirma conexión websocket activa
-        log(" WebSocket no conectado");
+        MLOG_W(" WebSocket no conectado");
         return false;
     }
     
-    log(" Esperando solicitud de descarga del servidor...");
+    MLOG_I(" Esperando solicitud de descarga del servidor...");
     updateStatus(WEBSOCKET_CONNECTED, "Esperando solicitud");
     
     uint32_t startTime = millis();
@@ -303,10 +301,10 @@ bool WiFiManager::waitForDataRequest(uint32_t timeout_ms) {
         _webSocket.loop();
         
         // Verificar si recibimos solicitud
-        if (_lastServerResponse.indexOf("request_all_data") != -1) {
-            log(" ¡Solicitud de datos recibida!");
+        if (strstr(_lastServerResponse, "request_all_data")) {
+            MLOG_I(" ¡Solicitud de datos recibida!");
             requestReceived = true;
-            _lastServerResponse = ""; 
+            _lastServerResponse[0] = '\0';
             break;
         }
         
@@ -319,12 +317,12 @@ bool WiFiManager::waitForDataRequest(uint32_t timeout_ms) {
         
         // Status cada 5 segundos
         if ((millis() - startTime) % 5000 < 100) {
-            logf("⏳ Esperando solicitud... %u s", (millis() - startTime) / 1000);
+            MLOG_D("⏳ Esperando solicitud... %lu s", (unsigned long)((millis() - startTime) / 1000));
         }
     }
     
     if (!requestReceived) {
-        log(" Timeout esperando solicitud de datos");
+        MLOG_W(" Timeout esperando solicitud de datos");
         return false;
     }
     
@@ -353,42 +351,55 @@ bool WiFiManager::waitForDataRequest(uint32_t timeout_ms) {
  */
 bool WiFiManager::sendStoredData(int maxReadings) {
     if (!isWebSocketConnected()) {
-        log(" WebSocket no conectado");
+        MLOG_W(" WebSocket no conectado");
         return false;
     }
     
     if (!_rtcMemory) {
-        log(" RTCMemory no configurada");
+        MLOG_W(" RTCMemory no configurada");
         return false;
     }
     
     updateStatus(DATA_SENDING, "Enviando datos...");
-    log(" Iniciando envío de datos almacenados...");
+    MLOG_I(" Iniciando envío de datos almacenados...");
     
     // Notificar inicio de envío
-    String startMsg = "{\"action\":\"sending_data\",\"timestamp\":\"" + 
-                    String(millis()) + "\"}";
-    _webSocket.sendTXT(startMsg);
+    char message[256];
+    int n = snprintf(message, sizeof(message), "{\"action\":\"sending_data\",\"timestamp\":\"%lu\"",
+                     (unsigned long)millis());
+    char report[192];
+    if (DeltaReport::describe(report, sizeof(report)) > 0) {
+        // Metadatos del modo por banda muerta para reconstruir la serie en el servidor
+        n += snprintf(message + n, sizeof(message) - n, ",\"report\":%s", report);
+    }
+    if ((size_t)n + 1 < sizeof(message)) {
+        message[n++] = '}';
+        message[n] = '\0';
+        _webSocket.sendTXT(message, n);
+    } else {
+        MLOG_E(" Mensaje de inicio demasiado largo (%d bytes)", n);
+    }
     delay(100);
     
     // Obtener lecturas recientes
     //buffer local para 120 lecturas definidas aquí mismo, probar cambios para aumentar cantidad de muestras envíadas
     //trae las lecturas desde RTC Memory
     RTCMemoryManager::SensorReading readings[120]; // Aumentar capacidad
-    int count = _rtcMemory->getRecentReadings(readings, maxReadings);
+    const int capacity = sizeof(readings) / sizeof(readings[0]);
+    int count = _rtcMemory->getRecentReadings(readings, maxReadings < capacity ? maxReadings : capacity);
     
     if (count == 0) {
-        log(" No hay datos para enviar");
+        MLOG_I(" No hay datos para enviar");
         
         // Notificar que no hay datos
-        String noDataMsg = "{\"action\":\"data_complete\",\"total\":0}";
-        _webSocket.sendTXT(noDataMsg);
+        static const char NO_DATA_MSG[] = "{\"action\":\"data_complete\",\"total\":0}";
+        _webSocket.sendTXT(NO_DATA_MSG, sizeof(NO_DATA_MSG) - 1);
         
         updateStatus(DATA_SENT, "Sin datos para enviar");
         return true;
     }
     
-    logf(" Enviando %d lecturas...", count);
+    MLOG_I(" Enviando %d lecturas...", count);
     
 
     //NUCLEO DEL PROCESO DE ENVÍO DE DATOS
@@ -402,7 +413,7 @@ bool WiFiManager::sendStoredData(int maxReadings) {
         //alimenta el watchdog durante el envío de datos
         //cada 10 lecturas muestra progreso
         if (!sendReading(readings[i])) {
-            logf(" Error enviando lectura #%d", readings[i].reading_number);
+            MLOG_E(" Error enviando lectura #%d", readings[i].reading_number);
             allSent = false;
         } else {
             successCount++;
@@ -418,25 +429,28 @@ bool WiFiManager::sendStoredData(int maxReadings) {
         
         // Mostrar progreso
         if (i % 10 == 0 && i > 0) {
-            logf(" Progreso: %d/%d lecturas enviadas", i, count);
+            MLOG_D(" Progreso: %d/%d lecturas enviadas", i, count);
         }
         
         // Timeout general para todo el envío
         if (millis() - sendStartTime > (_config.websocket_timeout_ms * 3)) {
-            log(" Timeout general enviando datos");
+            MLOG_W(" Timeout general enviando datos");
             allSent = false;
             break;
         }
     }
     
     // Notificar fin de envío
-    String endMsg = "{\"action\":\"data_complete\",\"total\":" + 
-                    String(successCount) + "}";
-    _webSocket.sendTXT(endMsg);
+    n = snprintf(message, sizeof(message), "{\"action\":\"data_complete\",\"total\":%d}", successCount);
+    _webSocket.sendTXT(message, n);
     delay(100);
+
+#ifdef HAL_TRACE
+    sendSensorTrace();
+#endif
     
     if (allSent && successCount == count) {
-        logf(" Todos los datos enviados exitosamente (%u ms)", millis() - sendStartTime);
+        MLOG_I(" Todos los datos enviados exitosamente (%lu ms)", (unsigned long)(millis() - sendStartTime));
         updateStatus(DATA_SENT, "Datos enviados");
         _totalDataSent += count;
         
@@ -445,7 +459,7 @@ bool WiFiManager::sendStoredData(int maxReadings) {
         
         return true;
     } else {
-        logf(" Enviados %d de %d datos", successCount, count);
+        MLOG_W(" Enviados %d de %d datos", successCount, count);
         updateStatus(DATA_ERROR, "Envío parcial");
         
         if (successCount > 0) {
@@ -476,15 +490,20 @@ bool WiFiManager::sendReading(const RTCMemoryManager::SensorReading &reading) {
         return false;
     }
     
-    String jsonData = createDataJSON(reading);
+    size_t length = createDataJSON(reading, _txBuffer, sizeof(_txBuffer));
+    if (length == 0) {
+        MLOG_E(" Lectura #%u no cabe en %u bytes", (unsigned)reading.reading_number,
+               (unsigned)sizeof(_txBuffer));
+        return false;
+    }
     
     // No mostrar cada envío individual en modo manual
     if (!manual_download_mode) {
-        logf(" Enviando: %s", jsonData.c_str());
+        MLOG_D(" Enviando: %s", _txBuffer);
     }
     
     // Enviar datos
-    _webSocket.sendTXT(jsonData);
+    _webSocket.sendTXT(_txBuffer, length);
     
     // En modo manual, no esperar confirmación individual
     if (manual_download_mode) {
@@ -513,7 +532,9 @@ bool WiFiManager::sendReading(const RTCMemoryManager::SensorReading &reading) {
 /**
  * @brief Crea mensaje JSON con datos de lectura y metadata del sistema
  * @param reading Estructura SensorReading a serializar
- * @return String con JSON formateado
+ * @param buffer Destino del JSON
+ * @param size Tamaño del búfer
+ * @return Longitud del JSON, 0 si no cabe en el búfer
  * @details Campos incluidos en JSON:
  *          - device_id: Identificador del dispositivo
  *          - timestamp: millis() de la lectura
@@ -524,14 +545,23 @@ bool WiFiManager::sendReading(const RTCMemoryManager::SensorReading &reading) {
  *          - temperature, ph, turbidity, tds, ec: Datos de sensores
  *          - sensor_status, valid: Estado de sensores
  *          - health_score: Salud del sistema (watchdog)
+ *          - breakers: Interruptores de sensores abiertos (bit i = SensorBreaker::Sensor i)
+ *          - alarms: Alarmas de anomalía de la lectura (ver AnomalyDetector.h)
  *          - rssi: Intensidad señal WiFi
  *          - free_heap: Memoria libre
  * @note Buffer StaticJsonDocument<400> (400 bytes). Aumentar si JSON más grande.
  * @note Si rtc_timestamp inválido (<2021), muestra "No disponible".
+ * @note Sin heap: las fechas se asignan como const char* (el documento guarda el
+ *       puntero, sin copiarlas) y se serializa directo al búfer del llamador.
  */
-String WiFiManager::createDataJSON(const RTCMemoryManager::SensorReading &reading)
+size_t WiFiManager::createDataJSON(const RTCMemoryManager::SensorReading &reading, char* buffer, size_t size)
 {
     StaticJsonDocument<400> doc;
+
+    // Deben vivir hasta serializeJson(): el documento solo guarda los punteros
+    char datetime_buffer[20];
+    char date_buffer[11];
+    char time_buffer[9];
     
     // Información del dispositivo
     doc["device_id"] = "ESP32_WaterMonitor";
@@ -542,11 +572,8 @@ String WiFiManager::createDataJSON(const RTCMemoryManager::SensorReading &readin
     
     if (reading.rtc_timestamp > 1609459200) {
         time_t local_time = reading.rtc_timestamp;
-        struct tm* timeinfo = localtime(&local_time);
-        
-        char datetime_buffer[20];
-        char date_buffer[11];
-        char time_buffer[9];
+        struct tm local_tm;
+        struct tm* timeinfo = localtime_r(&local_time, &local_tm);  // localtime() de glibc asigna en cada llamada
         
         // Formatear fecha/hora completa
         snprintf(datetime_buffer, sizeof(datetime_buffer), "%04d-%02d-%02d %02d:%02d:%02d",
@@ -561,9 +588,9 @@ String WiFiManager::createDataJSON(const RTCMemoryManager::SensorReading &readin
         snprintf(time_buffer, sizeof(time_buffer), "%02d:%02d:%02d",
                 timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec);
         
-        doc["rtc_datetime"] = String(datetime_buffer);
-        doc["rtc_date"] = String(date_buffer);
-        doc["rtc_time"] = String(time_buffer);
+        doc["rtc_datetime"] = (const char*)datetime_buffer;
+        doc["rtc_date"] = (const char*)date_buffer;
+        doc["rtc_time"] = (const char*)time_buffer;
     } else
     {
         // Fallback: RTC o NTP no disponible -> dejar en "No disponible" o convertir timestamp relativo
@@ -591,16 +618,113 @@ String WiFiManager::createDataJSON(const RTCMemoryManager::SensorReading &readin
     doc["ec"] = reading.ec; 
     doc["sensor_status"] = reading.sensor_status;
     doc["valid"] = reading.valid;
+    doc["alarms"] = reading.alarms;
     
     // Información del sistema
     doc["health_score"] = _watchdog ? _watchdog->getHealthScore() : 100;
+    doc["breakers"] = SensorBreaker::openMask();
     doc["rssi"] = WiFi.RSSI();
     doc["free_heap"] = ESP.getFreeHeap();
     
-    String output;
-    serializeJson(doc, output);
-    
-    return output;
+    size_t length = serializeJson(doc, buffer, size);
+    if (length + 1 >= size) {
+        return 0;  // Truncado (o justo al límite): no se envía un JSON cortado
+    }
+    return length;
+}
+
+/**
+ * @brief Sube la traza de muestras crudas del ciclo
+ * @details El base64 ocupa 4/3 de la traza (hasta ~5.5 KB con HAL_TRACE_BUFFER_BYTES);
+ *          el búfer vive solo durante el envío.
+ */
+void WiFiManager::sendSensorTrace() {
+    size_t size = HAL::Trace::size();
+    if (size == 0 || !isWebSocketConnected()) return;
+
+    size_t capacity = ((size + 2) / 3) * 4 + 1;
+    char* encoded = (char*)malloc(capacity);
+    if (!encoded) {
+        MLOG_W(" Sin memoria para la traza (%u bytes)", (unsigned)capacity);
+        return;
+    }
+    HAL::Trace::encodeBase64(encoded, capacity);
+
+    String message;
+    message.reserve(capacity + 96);
+    message = "{\"action\":\"sensor_trace\",\"device_id\":\"ESP32_WaterMonitor\",\"tag\":";
+    message += String(HAL::Trace::tag());
+    message += ",\"truncated\":";
+    message += HAL::Trace::overflowed() ? "true" : "false";
+    message += ",\"data\":\"";
+    message += encoded;
+    message += "\"}";
+    free(encoded);
+
+    _webSocket.sendTXT(message);
+    MLOG_I(" Traza de sensores enviada (%u bytes)", (unsigned)size);
+}
+
+/**
+ * @brief Guarda la lectura con alarma para enviarla en la próxima conexión
+ */
+void WiFiManager::queueAlert(const RTCMemoryManager::SensorReading &reading) {
+    _pendingAlert = reading;
+    _alertPending = true;
+}
+
+/**
+ * @brief Envía la alerta pendiente en un solo mensaje corto
+ * @details Se da ~200 ms a _webSocket.loop() para que el mensaje salga antes de
+ *          seguir (o desconectar); el servidor no responde a las alertas.
+ */
+bool WiFiManager::flushAlert() {
+    if (!_alertPending) return true;
+    if (!isWebSocketConnected()) return false;
+
+    char message[224];
+    int n = snprintf(message, sizeof(message),
+                     "{\"action\":\"alert\",\"device_id\":\"ESP32_WaterMonitor\",\"rtc_timestamp\":%u,"
+                     "\"alarms\":%u,\"sensor_status\":%u,\"temperature\":%.2f,\"ph\":%.2f,"
+                     "\"turbidity\":%.1f,\"tds\":%.1f}",
+                     (unsigned)_pendingAlert.rtc_timestamp, (unsigned)_pendingAlert.alarms,
+                     (unsigned)_pendingAlert.sensor_status, _pendingAlert.temperature,
+                     _pendingAlert.ph, _pendingAlert.turbidity, _pendingAlert.tds);
+    if (n <= 0 || (size_t)n >= sizeof(message)) return false;
+
+    if (!_webSocket.sendTXT(message, n)) {
+        MLOG_W(" No se pudo enviar la alerta");
+        return false;
+    }
+    uint32_t start = millis();
+    while (millis() - start < 200) {
+        _webSocket.loop();
+        delay(10);
+    }
+    _alertPending = false;
+    MLOG_W(" Alerta enviada (alarmas 0x%02X)", (unsigned)_pendingAlert.alarms);
+    return true;
+}
+
+/**
+ * @brief Conexión mínima para una alerta fuera de programa
+ * @details Conecta WiFi y WebSocket, envía la alerta y desconecta. Las lecturas
+ *          almacenadas esperan a la verificación WiFi programada.
+ */
+bool WiFiManager::sendAlert() {
+    if (!_alertPending) return true;
+    MLOG_I("\n === ALERTA FUERA DE PROGRAMA ===");
+
+    uint32_t processStartTime = millis();
+    bool success = connectWiFi() && connectWebSocket() && flushAlert();
+    disconnect();
+
+    if (success) {
+        MLOG_I(" Alerta entregada en %lu ms", (unsigned long)(millis() - processStartTime));
+    } else {
+        MLOG_E(" No se pudo entregar la alerta (%lu ms)", (unsigned long)(millis() - processStartTime));
+    }
+    return success;
 }
 
 /**
@@ -614,7 +738,7 @@ String WiFiManager::createDataJSON(const RTCMemoryManager::SensorReading &readin
  * @note WiFi.mode(WIFI_OFF) reduce consumo significativamente.
  */
 void WiFiManager::disconnect() {
-    log("🔌 Desconectando WiFi...");
+    MLOG_I("🔌 Desconectando WiFi...");
     
     // Cerrar WebSocket
     if (_websocketConnected) {
@@ -631,7 +755,7 @@ void WiFiManager::disconnect() {
     WiFi.mode(WIFI_OFF);
     
     updateStatus(WIFI_DISCONNECTED, "Desconectado");
-    log(" WiFi desconectado completamente");
+    MLOG_I(" WiFi desconectado completamente");
 }
 
 // Proceso manual de transmisión
@@ -652,7 +776,7 @@ void WiFiManager::disconnect() {
  * @note Éxito si conecta aunque no haya solicitud (permite verificar conectividad).
  */
 bool WiFiManager::transmitDataManual(int maxReadings, uint32_t waitTimeout) {
-    log("\n === INICIANDO TRANSMISIÓN MANUAL ===");
+    MLOG_I("\n === INICIANDO TRANSMISIÓN MANUAL ===");
     
     uint32_t processStartTime = millis();
     bool success = false;
@@ -660,19 +784,20 @@ bool WiFiManager::transmitDataManual(int maxReadings, uint32_t waitTimeout) {
     do {
         // Conectar WiFi
         if (!connectWiFi()) {
-            log(" Falló conexión WiFi");
+            MLOG_E(" Falló conexión WiFi");
             break;
         }
         
         // Conectar WebSocket
         if (!connectWebSocket()) {
-            log(" Falló conexión WebSocket");
+            MLOG_E(" Falló conexión WebSocket");
             break;
         }
+        flushAlert(); // Alerta pendiente primero: es lo más urgente del ciclo
         
         // Esperar solicitud de descarga
         if (!waitForDataRequest(waitTimeout)) {
-            log(" No se recibió solicitud de descarga");
+            MLOG_I(" No se recibió solicitud de descarga");
             //  no había solicitud
             success = true; // Conexión exitosa aunque no se enviaron datos
             break;
@@ -680,7 +805,7 @@ bool WiFiManager::transmitDataManual(int maxReadings, uint32_t waitTimeout) {
         
         // Enviar datos
         if (!sendStoredData(maxReadings)) {
-            log(" Falló envío de datos");
+            MLOG_E(" Falló envío de datos");
             break;
         }
         
@@ -694,18 +819,18 @@ bool WiFiManager::transmitDataManual(int maxReadings, uint32_t waitTimeout) {
     uint32_t totalTime = millis() - processStartTime;
     
     if (success) {
-        logf(" Proceso completado en %u ms", totalTime);
+        MLOG_I(" Proceso completado en %u ms", totalTime);
         if (_watchdog) {
             _watchdog->recordSuccess();
         }
     } else {
-        logf(" Proceso falló en %u ms", totalTime);
+        MLOG_E(" Proceso falló en %u ms", totalTime);
         if (_watchdog) {
             _watchdog->recordFailure();
         }
     }
     
-    log("=== FIN TRANSMISIÓN MANUAL ===\n");
+    MLOG_I("=== FIN TRANSMISIÓN MANUAL ===\n");
     
     return success;
 }
@@ -731,7 +856,7 @@ bool WiFiManager::transmitData(int maxReadings) {
     bool previousMode = manual_download_mode;
     manual_download_mode = false;
     
-    log("\n === INICIANDO TRANSMISIÓN AUTOMÁTICA ===");
+    MLOG_I("\n === INICIANDO TRANSMISIÓN AUTOMÁTICA ===");
     
     uint32_t processStartTime = millis();
     bool success = false;
@@ -739,19 +864,20 @@ bool WiFiManager::transmitData(int maxReadings) {
     do {
         // Conectar WiFi
         if (!connectWiFi()) {
-            log(" Falló conexión WiFi");
+            MLOG_E(" Falló conexión WiFi");
             break;
         }
         
         // Conectar WebSocket
         if (!connectWebSocket()) {
-            log(" Falló conexión WebSocket");
+            MLOG_E(" Falló conexión WebSocket");
             break;
         }
+        flushAlert(); // Alerta pendiente primero: es lo más urgente del ciclo
         
         // Enviar datos inmediatamente
         if (!sendStoredData(maxReadings)) {
-            log(" Falló envío de datos");
+            MLOG_E(" Falló envío de datos");
             break;
         }
         
@@ -765,18 +891,18 @@ bool WiFiManager::transmitData(int maxReadings) {
     uint32_t totalTime = millis() - processStartTime;
     
     if (success) {
-        logf("Transmisión exitosa en %u ms", totalTime);
+        MLOG_I("Transmisión exitosa en %u ms", totalTime);
         if (_watchdog) {
             _watchdog->recordSuccess();
         }
     } else {
-        logf(" Transmisión falló en %u ms", totalTime);
+        MLOG_E(" Transmisión falló en %u ms", totalTime);
         if (_watchdog) {
             _watchdog->recordFailure();
         }
     }
     
-    log("=== FIN TRANSMISIÓN AUTOMÁTICA ===\n");
+    MLOG_I("=== FIN TRANSMISIÓN AUTOMÁTICA ===\n");
     
     // Restaurar modo
     manual_download_mode = previousMode;
@@ -801,44 +927,47 @@ bool WiFiManager::transmitData(int maxReadings) {
 void WiFiManager::webSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
     switch(type) {
         case WStype_DISCONNECTED:
-            log(" WebSocket desconectado");
+            MLOG_I(" WebSocket desconectado");
             _websocketConnected = false;
             updateStatus(WEBSOCKET_ERROR, "WebSocket desconectado");
             break;
             
         case WStype_CONNECTED:
-            logf(" WebSocket conectado a: %s", payload);
+            MLOG_I(" WebSocket conectado a: %s", payload);
             _websocketConnected = true;
             updateStatus(WEBSOCKET_CONNECTED, "WebSocket conectado");
             break;
             
         case WStype_TEXT:
-            _lastServerResponse = String((char*)payload);
+            // Comandos de calibración: se analizan sobre el payload, sin copia a String
+            if (handleCalibrationCommand(payload, length)) break;
+            
+            snprintf(_lastServerResponse, sizeof(_lastServerResponse), "%.*s", (int)length, (const char*)payload);
             
             // En modo manual, solo mostrar mensajes importantes
             if (manual_download_mode) {
-                if (_lastServerResponse.indexOf("request_all_data") != -1) {
-                    log(" Servidor solicita los datos");
-                } else if (_lastServerResponse.indexOf("success") != -1) {
+                if (strstr(_lastServerResponse, "request_all_data")) {
+                    MLOG_I(" Servidor solicita los datos");
+                } else if (strstr(_lastServerResponse, "success")) {
                     // No mostrar confirmaciones individuales
-                } else if (_lastServerResponse.indexOf("conectado") != -1) {
-                    log(" Servidor confirma conexión");
+                } else if (strstr(_lastServerResponse, "conectado")) {
+                    MLOG_I(" Servidor confirma conexión");
                 } else {
-                    logf(" Servidor: %s", _lastServerResponse.c_str());
+                    MLOG_I(" Servidor: %s", _lastServerResponse);
                 }
             } else {
-                logf(" Servidor responde: %s", _lastServerResponse.c_str());
+                MLOG_I(" Servidor responde: %s", _lastServerResponse);
             }
             
             // Verificar si es confirmación de recepción
-            if (_lastServerResponse.indexOf("success") != -1 || 
-                _lastServerResponse.indexOf("received") != -1) {
+            if (strstr(_lastServerResponse, "success") || 
+                strstr(_lastServerResponse, "received")) {
                 _dataTransmissionComplete = true;
             }
             break;
             
         case WStype_ERROR:
-            logf(" Error WebSocket: %s", payload);
+            MLOG_E(" Error WebSocket: %s", payload);
             updateStatus(WEBSOCKET_ERROR, "Error WebSocket");
             reportError(WatchdogManager::ERROR_WIFI_FAIL, WatchdogManager::SEVERITY_WARNING, 0);
             break;
@@ -848,6 +977,36 @@ void WiFiManager::webSocketEvent(WStype_t type, uint8_t* payload, size_t length)
     }
 }
 
+/**
+ * @brief Procesa un comando de calibración y envía la respuesta
+ * @details Filtra primero con búsquedas de texto (todas las acciones de calibración
+ *          contienen "calib") para no analizar confirmaciones de datos. La respuesta
+ *          incluye resultado y calibración vigente completa en un único frame.
+ * @param payload Texto recibido, terminado en '\0'
+ * @param length Longitud del texto
+ * @return true si el mensaje era un comando de calibración
+ */
+bool WiFiManager::handleCalibrationCommand(uint8_t* payload, size_t length) {
+    if (!_calibrationManager || payload == nullptr || length == 0) return false;
+    
+    const char* text = (const char*)payload;
+    if (strstr(text, "\"action\"") == nullptr || strstr(text, "calib") == nullptr) return false;
+    
+    CalibrationManager::CalibrationResult result =
+        _calibrationManager->processCalibrationCommand((char*)payload, length);
+    
+    char response[CALIB_RESPONSE_MAX];
+    size_t n = _calibrationManager->getResponseJSON(result, response, sizeof(response));
+    if (n >= sizeof(response)) {
+        MLOG_E(" Respuesta de calibración truncada (%u bytes)", (unsigned)n);
+        return true;
+    }
+    
+    _webSocket.sendTXT(response, n);
+    MLOG_I(" Calibración: %s", CalibrationManager::resultMessage(result));
+    return true;
+}
+
 // Configurar modo de operación
 /**
  * @brief Configura modo de operación (manual o automático)
@@ -856,7 +1015,7 @@ void WiFiManager::webSocketEvent(WStype_t type, uint8_t* payload, size_t length)
  */
 void WiFiManager::setManualMode(bool manual) {
     manual_download_mode = manual;
-    logf(" Modo descarga: %s", manual ? "MANUAL" : "AUTOMÁTICO");
+    MLOG_I(" Modo descarga: %s", manual ? "MANUAL" : "AUTOMÁTICO");
 }
 
 // Obtener modo actual
@@ -868,6 +1027,14 @@ bool WiFiManager::isManualMode() {
     return manual_download_mode;
 }
 
+/**
+ * @brief Obtiene lecturas enviadas al servidor desde el arranque
+ * @return Contador _totalDataSent
+ */
+uint32_t WiFiManager::getTotalDataSent() {
+    return _totalDataSent;
+}
+
 // Getters y utilidades (sin cambios)
 /**
  * @brief Verifica si WiFi está conectado actualmente
@@ -895,9 +1062,9 @@ WiFiManager::wifi_status_t WiFiManager::getStatus() {
 
 /**
  * @brief Obtiene descripción textual del estado actual
- * @return String con descripción legible del estado
+ * @return Literal estático con descripción legible del estado
  */
-String WiFiManager::getStatusString() {
+const char* WiFiManager::getStatusString() {
     switch(_currentStatus) {
         case WIFI_DISCONNECTED: return "Desconectado";
         case WIFI_CONNECTING: return "Conectando WiFi";
@@ -914,32 +1081,47 @@ String WiFiManager::getStatusString() {
 }
 
 /**
- * @brief Obtiene información detallada de conexión WiFi
- * @return String con IP, RSSI y SSID si conectado, "WiFi desconectado" si no
+ * @brief Escribe información detallada de conexión WiFi en el buffer del llamador
+ * @param buffer Destino del texto
+ * @param size Tamaño del buffer
+ * @return Longitud del texto completo (semántica de snprintf)
  */
-String WiFiManager::getConnectionInfo() {
+size_t WiFiManager::getConnectionInfo(char* buffer, size_t size) {
+    int n;
     if (isWiFiConnected()) {
-        String info = "IP: " + WiFi.localIP().toString();
-        info += " | RSSI: " + String(WiFi.RSSI()) + " dBm";
-        info += " | SSID: " + String(_config.ssid);
-        return info;
+        IPAddress ip = WiFi.localIP();
+        n = snprintf(buffer, size, "IP: %u.%u.%u.%u | RSSI: %d dBm | SSID: %s",
+                     ip[0], ip[1], ip[2], ip[3], (int)WiFi.RSSI(), _config.ssid);
+    } else {
+        n = snprintf(buffer, size, "WiFi desconectado");
     }
-    return "WiFi desconectado";
+    return (n > 0) ? (size_t)n : 0;
 }
 
 /**
- * @brief Obtiene estadísticas completas de transmisión
- * @return String formateado con estado, modo, datos enviados, errores y conexión
+ * @brief Escribe estadísticas completas de transmisión en el buffer del llamador
+ * @param buffer Destino del texto
+ * @param size Tamaño del buffer
+ * @return Longitud del texto completo (semántica de snprintf)
  */
-String WiFiManager::getTransmissionStats() {
-    String stats = "=== Estadísticas WiFi ===\n";
-    stats += "Estado: " + getStatusString() + "\n";
-    stats += "Modo: " + String(manual_download_mode ? "MANUAL" : "AUTOMÁTICO") + "\n";
-    stats += "Datos enviados: " + String(_totalDataSent) + " lecturas\n";
-    stats += "Último error: " + String(_lastErrorCode) + "\n";
-    stats += "Conexión: " + getConnectionInfo() + "\n";
-    stats += "========================";
-    return stats;
+size_t WiFiManager::getTransmissionStats(char* buffer, size_t size) {
+    char connection[96];
+    getConnectionInfo(connection, sizeof(connection));
+    
+    int n = snprintf(buffer, size,
+                     "=== Estadísticas WiFi ===\n"
+                     "Estado: %s\n"
+                     "Modo: %s\n"
+                     "Datos enviados: %lu lecturas\n"
+                     "Último error: %lu\n"
+                     "Conexión: %s\n"
+                     "========================",
+                     getStatusString(),
+                     manual_download_mode ? "MANUAL" : "AUTOMÁTICO",
+                     (unsigned long)_totalDataSent,
+                     (unsigned long)_lastErrorCode,
+                     connection);
+    return (n > 0) ? (size_t)n : 0;
 }
 
 // Configurar callbacks
@@ -991,7 +1173,7 @@ void WiFiManager::updateStatus(wifi_status_t status, const char* message) {
     }
     
     if (message) {
-        logf("📊 Estado: %s - %s", getStatusString().c_str(), message);
+        MLOG_I("📊 Estado: %s - %s", getStatusString(), message);
     }
 }
 
@@ -1014,30 +1196,26 @@ void WiFiManager::reportError(WatchdogManager::error_code_t code, WatchdogManage
     }
 }
 
+// Métodos privados de logging
 /**
- * @brief Envía mensaje de log mediante callback o Serial
- * @param message Cadena de texto a imprimir
+ * @brief Envía un mensaje de log con formato estilo printf.
+ * @param level Nivel LOG_LEVEL_* del mensaje.
+ * @param format Cadena de formato printf.
+ * @param ... Argumentos variables para format.
+ * @note Si hay callback registrado se formatea aquí y se le entrega la línea;
+ *       en caso contrario se delega en Logger (modo texto o binario).
+ * @note Se invoca a través de las macros MLOG_*, que eliminan en compilación
+ *       los niveles por encima de LOG_LEVEL.
  */
-void WiFiManager::log(const char* message) {
-    if (_logCallback) {
-        _logCallback(message);
-    } else if (_enableSerialOutput && Serial) {
-        Serial.println(message);
-    }
-}
-
-/**
- * @brief Envía mensaje de log con formato estilo printf
- * @param format Cadena de formato printf
- * @param ... Argumentos variables para format
- * @note Buffer interno de 256 caracteres. Mensajes más largos se truncan.
- */
-void WiFiManager::logf(const char* format, ...) {
-    char buffer[256];
+void WiFiManager::logf(uint8_t level, const char* format, ...) {
     va_list args;
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    if (_logCallback) {
+        char buffer[LOG_LINE_MAX];
+        vsnprintf(buffer, sizeof(buffer), format, args);
+        _logCallback(buffer);
+    } else if (_enableSerialOutput) {
+        Logger::vwrite(level, TAG, format, args);
+    }
     va_end(args);
-    
-    log(buffer);
-}
\ No newline at end of file
+}
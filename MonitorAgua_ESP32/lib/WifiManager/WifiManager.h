@@ -23,6 +23,9 @@
 #include "RTC.h"
 #include "CalibrationManager.h"
 
+#define WIFI_TX_BUFFER_LEN  512  // Lectura serializada (createDataJSON, ~430 B en el peor caso)
+#define WIFI_RESPONSE_LEN   128  // Última respuesta del servidor (se trunca)
+
 /**
  * @class WiFiManager
  * @brief Clase para manejo eficiente de WiFi y WebSocket en ESP32
@@ -217,9 +220,26 @@ private:
     bool _dataTransmissionComplete;
 
     /**
-     * @brief Última respuesta textual recibida del servidor
+     * @brief Última respuesta textual recibida del servidor (truncada a WIFI_RESPONSE_LEN)
      */
-    String _lastServerResponse;
+    char _lastServerResponse[WIFI_RESPONSE_LEN];
+
+    /**
+     * @brief Búfer de salida de las lecturas: el envío no usa heap
+     */
+    char _txBuffer[WIFI_TX_BUFFER_LEN];
+
+    // ——— Alerta fuera de programa ———
+
+    /**
+     * @brief Lectura con alarma pendiente de enviar (ver queueAlert())
+     */
+    RTCMemoryManager::SensorReading _pendingAlert;
+
+    /**
+     * @brief true si _pendingAlert aún no se envió
+     */
+    bool _alertPending;
 
 public:
     /**
@@ -294,9 +314,9 @@ public:
     
     /**
      * @brief Obtiene descripción textual del estado actual
-     * @return String con descripción legible del estado
+     * @return Literal estático con descripción legible del estado
      */
-    String getStatusString();
+    const char* getStatusString();
     
     /**
      * @brief Verifica si WiFi está conectado actualmente
@@ -317,10 +337,13 @@ public:
     bool isWebSocketConnected();
     
     /**
-     * @brief Obtiene información detallada de conexión WiFi
-     * @return String con IP, RSSI y SSID si conectado, "WiFi desconectado" si no
+     * @brief Escribe información detallada de conexión WiFi en un buffer del llamador
+     * @param buffer Destino del texto
+     * @param size Tamaño del buffer
+     * @return Longitud del texto completo (semántica de snprintf; ≥ size si se truncó)
+     * @note Escribe IP, RSSI y SSID si conectado, "WiFi desconectado" si no.
      */
-    String getConnectionInfo();
+    size_t getConnectionInfo(char* buffer, size_t size);
     
     /**
      * @brief Configura callback personalizado para logging
@@ -376,6 +399,21 @@ public:
      * @note Registra éxito/fallo en watchdog.
      */
     bool transmitDataManual(int maxReadings = 160, uint32_t waitTimeout = 60000);
+
+    /**
+     * @brief Deja una alerta pendiente para la próxima conexión
+     * @param reading Lectura con SensorReading::alarms distinto de 0
+     * @note transmitData() y transmitDataManual() la envían apenas conecta el WebSocket,
+     *       antes de esperar solicitud o enviar lecturas.
+     */
+    void queueAlert(const RTCMemoryManager::SensorReading &reading);
+
+    /**
+     * @brief Conexión mínima fuera de programa: conectar, enviar la alerta pendiente y desconectar
+     * @return true si la alerta llegó al servidor
+     * @note No espera solicitud de descarga ni envía lecturas almacenadas.
+     */
+    bool sendAlert();
     
     /**
      * @brief Configura modo de operación (manual o automático)
@@ -391,10 +429,22 @@ public:
     bool isManualMode();
     
     /**
-     * @brief Obtiene estadísticas completas de transmisión
-     * @return String formateado con estado, modo, datos enviados, errores y conexión
+     * @brief Obtiene lecturas enviadas al servidor desde el arranque
+     * @return Contador _totalDataSent
      */
-    String getTransmissionStats();
+    uint32_t getTotalDataSent();
+    
+    /**
+     * @brief Escribe estadísticas completas de transmisión en un buffer del llamador
+     * @param buffer Destino del texto (256 bytes bastan para el informe completo)
+     * @param size Tamaño del buffer
+     * @return Longitud del texto completo (semántica de snprintf; ≥ size si se truncó)
+     * @note Incluye estado, modo, datos enviados, último error y conexión.
+     */
+    size_t getTransmissionStats(char* buffer, size_t size);
+
+    /// La suite de microbenchmarks (bench/) mide kernels privados
+    friend class FirmwareBenchmark;
 
 private:
     /**
@@ -404,16 +454,46 @@ private:
      * @param length Longitud de payload
      * @note Maneja WStype_DISCONNECTED, WStype_CONNECTED, WStype_TEXT, WStype_ERROR.
      * @note En modo manual, filtra mensajes para mostrar solo importantes.
+     * @note Los comandos de calibración se delegan a handleCalibrationCommand().
      */
     void webSocketEvent(WStype_t type, uint8_t* payload, size_t length);
+
+    /**
+     * @brief Procesa un comando de calibración recibido y responde en un solo mensaje
+     * @param payload Texto recibido (terminado en '\0' por la librería WebSockets);
+     *                se analiza en sitio y queda modificado
+     * @param length Longitud del texto
+     * @return true si el mensaje era un comando de calibración (ya respondido)
+     * @note Sin CalibrationManager configurado no consume ningún mensaje.
+     */
+    bool handleCalibrationCommand(uint8_t* payload, size_t length);
     
     /**
      * @brief Crea mensaje JSON con datos de lectura y metadata del sistema
      * @param reading Estructura SensorReading a serializar
-     * @return String con JSON formateado (device_id, timestamp, sensores, sistema)
+     * @param buffer Destino del JSON (device_id, timestamp, sensores, sistema)
+     * @param size Tamaño del búfer
+     * @return Longitud del JSON, 0 si no cabe en el búfer
      * @note Buffer StaticJsonDocument<400>. Aumentar si JSON más grande.
      */
-    String createDataJSON(const RTCMemoryManager::SensorReading &reading);
+    size_t createDataJSON(const RTCMemoryManager::SensorReading &reading, char* buffer, size_t size);
+
+    /**
+     * @brief Sube la traza de muestras crudas del ciclo (HAL::Trace) en base64
+     * @details {"action":"sensor_trace","tag":N,"truncated":bool,"data":"..."}.
+     *          servidor.py la agrega a traces/<device_id>.trace para replay/main.cpp.
+     * @note Solo se llama en builds con -D HAL_TRACE.
+     */
+    void sendSensorTrace();
+
+    /**
+     * @brief Envía la alerta pendiente si hay WebSocket
+     * @details {"action":"alert","device_id":..,"rtc_timestamp":..,"alarms":..,<sensores>}.
+     *          Sin reading_number: no es una entrega de lectura (la lectura llega
+     *          con el resto en la próxima descarga).
+     * @return true si no quedó alerta pendiente
+     */
+    bool flushAlert();
     
     /**
      * @brief Actualiza estado interno y notifica mediante callback si configurado
@@ -431,17 +511,12 @@ private:
     void reportError(WatchdogManager::error_code_t code, WatchdogManager::error_severity_t severity, uint32_t context);
     
     /**
-     * @brief Envía mensaje de log mediante callback o Serial
-     * @param message Cadena de texto a imprimir
-     */
-    void log(const char* message);
-
-    /**
-     * @brief Envía mensaje de log con formato estilo printf
-     * @param format Cadena de formato printf
-     * @param ... Argumentos variables para format
+     * @brief Envía mensaje de log con formato al backend común (usar macros MLOG_*)
+     * @param level Nivel LOG_LEVEL_* del mensaje
+     * @param format String de formato estilo printf
+     * @param ... Argumentos variables
      */
-    void logf(const char* format, ...);
+    void logf(uint8_t level, const char* format, ...) __attribute__((format(printf, 3, 4)));
     
     /**
      * @brief Función estática para eventos WebSocket (requerida por librería)
@@ -0,0 +1,479 @@
+/**
+ * @file main.cpp
+ * @brief Reproduce trazas de sensores grabadas en campo a través del código real.
+ * @details Cada traza (un ciclo grabado con -D HAL_TRACE, ver lib/HAL/Trace.h) se
+ *          reproduce bit a bit: por cada lectura que hizo el firmware se llama al
+ *          mismo takeReadingWithTimeout() de TDSSensor, TurbiditySensor, pHSensor o
+ *          TemperatureSensor, que recibe las muestras crudas grabadas en lugar del
+ *          modelo de la HAL nativa. Por lectura se reporta el valor y el tiempo de
+ *          CPU del anfitrión, en CSV.
+ *
+ *              pio run -e replay
+ *              .pio/build/replay/program traces/ESP32_WaterMonitor.trace --csv base.csv
+ *              (cambiar filtro, LUT o parada temprana y volver a compilar)
+ *              .pio/build/replay/program traces/ESP32_WaterMonitor.trace --csv nuevo.csv
+ *              python tools/trace_compare.py base.csv nuevo.csv
+ *
+ *          Los registros de servidor.py (datos_calidad_agua.csv) sirven como fuente
+ *          gruesa: --import busca, con el propio código de cada sensor, la muestra
+ *          cruda que produce el valor registrado y arma una traza por fila (sin el
+ *          ruido real: cada ráfaga es ese valor con ±2 LSB de dither).
+ *
+ *              .pio/build/replay/program --import datos_calidad_agua.csv --out historico.trace
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <Arduino.h>
+#include "HALNative.h"
+#include "Trace.h"
+#include "Temperatura.h"
+#include "TDS.h"
+#include "Turbidez.h"
+#include "pH.h"
+#include <string>
+#include <vector>
+
+// ——— Configuración ———
+
+// Pines de src/main.cpp: son los canales de las trazas
+#define REPLAY_TEMPERATURE_PIN  17
+#define REPLAY_TDS_PIN          7
+#define REPLAY_TURBIDITY_PIN    5
+#define REPLAY_PH_PIN           1
+
+#define REPLAY_COMPENSATION_C   25.0f   // Temperatura que pasa src/main.cpp a TDS y pH
+#define REPLAY_BURST_SAMPLES    64      // Muestras por ráfaga importada (≥ la lectura más larga)
+#define REPLAY_ADC_MAX          4095    // Resolución de lectura de los sensores (12 bits)
+#define REPLAY_SCAN_STEP        128     // Paso del barrido grueso al importar
+#define REPLAY_DS18B20_OPEN     (-127 * 128)  // DEVICE_DISCONNECTED_C en crudo
+
+/**
+ * @brief Sensores reproducibles
+ */
+typedef enum : uint8_t {
+    SENSOR_TEMPERATURE,
+    SENSOR_TDS,
+    SENSOR_TURBIDITY,
+    SENSOR_PH,
+    SENSOR_COUNT
+} Sensor;
+
+static const char* const SENSOR_NAMES[SENSOR_COUNT] = {"temperature", "tds", "turbidity", "ph"};
+
+/**
+ * @brief Resultado de una lectura reproducida
+ */
+typedef struct {
+    bool valid;
+    float value;
+    uint8_t status;
+    double cpu_us;
+} Outcome;
+
+/**
+ * @brief Acumulado por sensor para el resumen
+ */
+typedef struct {
+    unsigned long readings;
+    unsigned long valid;
+    double value_sum;
+    double cpu_us_sum;
+} Totals;
+
+// ——— Lecturas ———
+
+static double cpuMicros() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/**
+ * @brief Sensor que corresponde a una marca de ráfaga
+ * @return SENSOR_COUNT si el canal no es de un sensor
+ */
+static Sensor sensorForMark(const HAL::Trace::Record& r) {
+    uint8_t source = r.type & ~HAL_TRACE_MARK;
+    if (source == (uint8_t)HAL::Trace::Source::ONEWIRE && r.channel == REPLAY_TEMPERATURE_PIN) {
+        return SENSOR_TEMPERATURE;
+    }
+    if (source != (uint8_t)HAL::Trace::Source::ADC) return SENSOR_COUNT;
+    switch (r.channel) {
+        case REPLAY_TDS_PIN:       return SENSOR_TDS;
+        case REPLAY_TURBIDITY_PIN: return SENSOR_TURBIDITY;
+        case REPLAY_PH_PIN:        return SENSOR_PH;
+        default:                   return SENSOR_COUNT;
+    }
+}
+
+/**
+ * @brief Una lectura completa, como la hace src/main.cpp
+ */
+static Outcome takeReading(Sensor sensor) {
+    Outcome o = {false, 0.0f, 0, 0.0};
+    double start = cpuMicros();
+    switch (sensor) {
+        case SENSOR_TEMPERATURE: {
+            TemperatureReading r = TemperatureSensor::takeReadingWithTimeout();
+            o = {r.valid, r.temperature, r.sensor_status, 0.0};
+            break;
+        }
+        case SENSOR_TDS: {
+            TDSReading r = TDSSensor::takeReadingWithTimeout(REPLAY_COMPENSATION_C);
+            o = {r.valid, r.tds_value, r.sensor_status, 0.0};
+            break;
+        }
+        case SENSOR_TURBIDITY: {
+            TurbidityReading r = TurbiditySensor::takeReadingWithTimeout();
+            o = {r.valid, r.turbidity_ntu, r.sensor_status, 0.0};
+            break;
+        }
+        default: {
+            pHReading r = pHSensor::takeReadingWithTimeout(REPLAY_COMPENSATION_C);
+            o = {r.valid, r.ph_value, r.sensor_status, 0.0};
+            break;
+        }
+    }
+    o.cpu_us = cpuMicros() - start;
+    return o;
+}
+
+static void initializeSensors() {
+    HAL::Native::init();
+    TemperatureSensor::initialize(REPLAY_TEMPERATURE_PIN);
+    TDSSensor::initialize(REPLAY_TDS_PIN);
+    TurbiditySensor::initialize(REPLAY_TURBIDITY_PIN);
+    pHSensor::initialize(REPLAY_PH_PIN);
+}
+
+// ——— Archivo de trazas ———
+
+/**
+ * @brief Traza leída de archivo
+ */
+typedef struct {
+    uint32_t tag;
+    std::vector<uint8_t> data;
+} TraceChunk;
+
+static bool loadTraces(const char* path, std::vector<TraceChunk>& out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    HAL::Trace::FileHeader header;
+    while (fread(&header, sizeof(header), 1, f) == 1) {
+        if (header.magic != HAL_TRACE_FILE_MAGIC) {
+            fprintf(stderr, "%s: cabecera inválida en el byte %ld\n", path, ftell(f) - (long)sizeof(header));
+            break;
+        }
+        TraceChunk chunk;
+        chunk.tag = header.tag;
+        chunk.data.resize(header.length);
+        if (header.length > 0 && fread(chunk.data.data(), header.length, 1, f) != 1) {
+            fprintf(stderr, "%s: traza #%u truncada\n", path, (unsigned)header.tag);
+            break;
+        }
+        out.push_back(std::move(chunk));
+    }
+    fclose(f);
+    return true;
+}
+
+static void writeTrace(FILE* f, uint32_t tag, const std::vector<uint8_t>& data) {
+    HAL::Trace::FileHeader header = {HAL_TRACE_FILE_MAGIC, tag, (uint32_t)data.size()};
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(data.data(), data.size(), 1, f);
+}
+
+// ——— Reproducción ———
+
+static int replayFile(const char* path, FILE* csv) {
+    std::vector<TraceChunk> traces;
+    if (!loadTraces(path, traces)) return 1;
+
+    initializeSensors();
+    Totals totals[SENSOR_COUNT] = {};
+    unsigned long misses = 0;
+
+    fprintf(csv, "tag,sensor,index,valid,value,status,cpu_us\n");
+    for (const TraceChunk& t : traces) {
+        HAL::Trace::replay(t.data.data(), t.data.size());
+        unsigned index[SENSOR_COUNT] = {};
+
+        // Mismas lecturas, en el mismo orden, que hizo el firmware
+        size_t pos = 0;
+        HAL::Trace::Record r;
+        while (HAL::Trace::nextRecord(t.data.data(), t.data.size(), pos, r)) {
+            if (!(r.type & HAL_TRACE_MARK)) continue;
+            Sensor sensor = sensorForMark(r);
+            if (sensor == SENSOR_COUNT) continue;
+
+            Outcome o = takeReading(sensor);
+            fprintf(csv, "%u,%s,%u,%d,%.6g,%u,%.2f\n", (unsigned)t.tag, SENSOR_NAMES[sensor],
+                    index[sensor]++, o.valid ? 1 : 0, o.value, o.status, o.cpu_us);
+
+            Totals& s = totals[sensor];
+            s.readings++;
+            s.cpu_us_sum += o.cpu_us;
+            if (o.valid) {
+                s.valid++;
+                s.value_sum += o.value;
+            }
+        }
+        misses += HAL::Trace::misses();
+        HAL::Trace::endReplay();
+    }
+
+    fprintf(stderr, "%zu trazas de %s\n", traces.size(), path);
+    fprintf(stderr, "%-12s %9s %9s %12s %12s\n", "sensor", "lecturas", "válidas", "media", "CPU µs");
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+        const Totals& s = totals[i];
+        fprintf(stderr, "%-12s %9lu %9lu %12.3f %12.1f\n", SENSOR_NAMES[i], s.readings, s.valid,
+                s.valid ? s.value_sum / s.valid : 0.0, s.readings ? s.cpu_us_sum / s.readings : 0.0);
+    }
+    if (misses > 0) {
+        fprintf(stderr, "Aviso: %lu muestras pedidas no estaban en la traza (las dio el modelo)\n", misses);
+    }
+    return 0;
+}
+
+// ——— Importación de datos_calidad_agua.csv ———
+
+static void appendRecord(std::vector<uint8_t>& out, uint8_t type, uint8_t channel,
+                         const uint8_t* data, uint8_t length) {
+    out.push_back(type);
+    out.push_back(channel);
+    out.push_back(length);
+    out.insert(out.end(), data, data + length);
+}
+
+/**
+ * @brief Ráfaga ADC de valor constante con dither de media cero (±2 LSB)
+ * @details El dither evita que el promedio de pH, que descarta todos los
+ *          valores iguales al mínimo y al máximo, se quede sin muestras.
+ */
+static void appendAdcBurst(std::vector<uint8_t>& out, uint8_t pin, int raw) {
+    static const int DITHER[8] = {0, 1, -1, 2, -2, 0, 1, -1};
+    appendRecord(out, (uint8_t)HAL::Trace::Source::ADC | HAL_TRACE_MARK, pin, nullptr, 0);
+    for (int i = 0; i < REPLAY_BURST_SAMPLES; i++) {
+        int v = raw + (raw > 0 ? DITHER[i % 8] : 0);
+        v = v < 0 ? 0 : (v > REPLAY_ADC_MAX ? REPLAY_ADC_MAX : v);
+        uint8_t sample[2] = {(uint8_t)v, (uint8_t)(v >> 8)};
+        appendRecord(out, (uint8_t)HAL::Trace::Source::ADC, pin, sample, 2);
+    }
+}
+
+static void appendTemperatureBurst(std::vector<uint8_t>& out, float celsius) {
+    int16_t raw = (celsius == 0.0f) ? (int16_t)REPLAY_DS18B20_OPEN : (int16_t)lroundf(celsius * 128.0f);
+    uint8_t sample[2] = {(uint8_t)raw, (uint8_t)((uint16_t)raw >> 8)};
+    appendRecord(out, (uint8_t)HAL::Trace::Source::ONEWIRE | HAL_TRACE_MARK, REPLAY_TEMPERATURE_PIN, nullptr, 0);
+    appendRecord(out, (uint8_t)HAL::Trace::Source::ONEWIRE, REPLAY_TEMPERATURE_PIN, sample, 2);
+}
+
+static uint8_t pinFor(Sensor sensor) {
+    switch (sensor) {
+        case SENSOR_TDS:       return REPLAY_TDS_PIN;
+        case SENSOR_TURBIDITY: return REPLAY_TURBIDITY_PIN;
+        default:               return REPLAY_PH_PIN;
+    }
+}
+
+/**
+ * @brief Valor que reporta el sensor para una entrada cruda constante (NAN si inválida)
+ */
+static float evaluate(Sensor sensor, int raw) {
+    std::vector<uint8_t> trace;
+    appendAdcBurst(trace, pinFor(sensor), raw);
+    HAL::Trace::replay(trace.data(), trace.size());
+    Outcome o = takeReading(sensor);
+    HAL::Trace::endReplay();
+    return o.valid ? o.value : NAN;
+}
+
+/**
+ * @brief Muestra cruda cuya lectura más se acerca al valor registrado
+ * @details Barrido grueso y bisección en el tramo que encierra el valor; no
+ *          supone el sentido de la curva (la turbidez baja al subir el voltaje).
+ * @param exact false si el valor queda fuera del alcance del sensor (se usa el más cercano)
+ * @return -1 si ninguna entrada produce una lectura válida
+ */
+static int invert(Sensor sensor, float target, bool& exact) {
+    exact = false;
+    int best = -1;
+    float bestError = INFINITY;
+    int prevRaw = -1;
+    float prevValue = NAN;
+
+    for (int raw = 0; raw <= REPLAY_ADC_MAX + REPLAY_SCAN_STEP - 1; raw += REPLAY_SCAN_STEP) {
+        int r = raw > REPLAY_ADC_MAX ? REPLAY_ADC_MAX : raw;
+        float v = evaluate(sensor, r);
+        if (!isnan(v) && fabsf(v - target) < bestError) {
+            best = r;
+            bestError = fabsf(v - target);
+        }
+
+        // Tramo que encierra el valor: bisección
+        if (!isnan(v) && !isnan(prevValue) && (prevValue - target) * (v - target) <= 0.0f) {
+            int lo = prevRaw, hi = r;
+            bool rising = v > prevValue;
+            while (hi - lo > 1) {
+                int mid = (lo + hi) / 2;
+                float m = evaluate(sensor, mid);
+                if (isnan(m)) break;
+                if (fabsf(m - target) < bestError) {
+                    best = mid;
+                    bestError = fabsf(m - target);
+                }
+                if ((m < target) == rising) lo = mid; else hi = mid;
+            }
+            exact = true;
+            return best;
+        }
+        prevRaw = r;
+        prevValue = v;
+    }
+    return best;
+}
+
+/**
+ * @brief Índice de una columna en la cabecera CSV
+ */
+static int column(const std::vector<std::string>& header, const char* name) {
+    for (size_t i = 0; i < header.size(); i++) {
+        if (header[i] == name) return (int)i;
+    }
+    return -1;
+}
+
+static std::vector<std::string> splitCsv(const char* line) {
+    std::vector<std::string> fields;
+    std::string field;
+    for (const char* p = line; *p && *p != '\n' && *p != '\r'; p++) {
+        if (*p == ',') {
+            fields.push_back(field);
+            field.clear();
+        } else if (*p != '"') {
+            field += *p;
+        }
+    }
+    fields.push_back(field);
+    return fields;
+}
+
+static int importCsv(const char* csvPath, const char* outPath) {
+    FILE* in = fopen(csvPath, "r");
+    if (!in) {
+        perror(csvPath);
+        return 1;
+    }
+    FILE* out = fopen(outPath, "wb");
+    if (!out) {
+        perror(outPath);
+        fclose(in);
+        return 1;
+    }
+
+    initializeSensors();
+    char line[1024];
+    if (!fgets(line, sizeof(line), in)) {
+        fclose(in);
+        fclose(out);
+        return 1;
+    }
+    std::vector<std::string> header = splitCsv(line);
+    int colNumber = column(header, "reading_number");
+    int cols[SENSOR_COUNT] = {column(header, "temperature"), column(header, "tds"),
+                              column(header, "turbidity"), column(header, "ph")};
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+        if (cols[i] < 0) {
+            fprintf(stderr, "%s: falta la columna %s\n", csvPath, SENSOR_NAMES[i]);
+            fclose(in);
+            fclose(out);
+            return 1;
+        }
+    }
+
+    unsigned long rows = 0, unreachable = 0, clamped = 0;
+    while (fgets(line, sizeof(line), in)) {
+        std::vector<std::string> f = splitCsv(line);
+        if (f.size() < header.size()) continue;
+
+        std::vector<uint8_t> trace;
+        appendTemperatureBurst(trace, strtof(f[cols[SENSOR_TEMPERATURE]].c_str(), nullptr));
+        for (int s = SENSOR_TDS; s < SENSOR_COUNT; s++) {
+            float target = strtof(f[cols[s]].c_str(), nullptr);
+            bool exact = true;
+            int raw = (target != 0.0f) ? invert((Sensor)s, target, exact) : 0;  // 0: el firmware envía 0 si es inválida
+            if (!exact) clamped++;
+            if (raw < 0) {
+                unreachable++;
+                raw = 0;
+            }
+            appendAdcBurst(trace, pinFor((Sensor)s), raw);
+        }
+
+        uint32_t tag = colNumber >= 0 ? (uint32_t)strtoul(f[colNumber].c_str(), nullptr, 10) : rows + 1;
+        writeTrace(out, tag, trace);
+        rows++;
+    }
+    fclose(in);
+    fclose(out);
+
+    fprintf(stderr, "%lu filas → %s", rows, outPath);
+    if (unreachable) fprintf(stderr, " (%lu valores sin entrada equivalente: quedan inválidos)", unreachable);
+    if (clamped > unreachable) fprintf(stderr, " (%lu valores fuera del alcance del sensor: se usó el más cercano)", clamped - unreachable);
+    fprintf(stderr, "\n");
+    return 0;
+}
+
+// ——— Punto de entrada ———
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "Uso: %s ARCHIVO.trace [--csv SALIDA.csv]\n"
+            "     %s --import datos_calidad_agua.csv --out ARCHIVO.trace\n",
+            program, program);
+}
+
+int main(int argc, char** argv) {
+    const char* tracePath = nullptr;
+    const char* csvPath = nullptr;
+    const char* importPath = nullptr;
+    const char* outPath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) csvPath = argv[++i];
+        else if (strcmp(argv[i], "--import") == 0 && i + 1 < argc) importPath = argv[++i];
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) outPath = argv[++i];
+        else if (argv[i][0] != '-' && !tracePath) tracePath = argv[i];
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (importPath) {
+        if (!outPath) {
+            usage(argv[0]);
+            return 2;
+        }
+        return importCsv(importPath, outPath);
+    }
+    if (!tracePath) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE* csv = stdout;
+    if (csvPath && !(csv = fopen(csvPath, "w"))) {
+        perror(csvPath);
+        return 1;
+    }
+    int result = replayFile(tracePath, csv);
+    if (csv != stdout) fclose(csv);
+    return result;
+}
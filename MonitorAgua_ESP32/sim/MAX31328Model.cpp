@@ -0,0 +1,198 @@
+/**
+ * @file MAX31328Model.cpp
+ * @brief Implementación del modelo del MAX31328.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include "MAX31328Model.h"
+
+#define SIM_RTC_POWERUP_CONTROL 0x1C  // INTCN | RS2 | RS1 (valor de encendido del chip)
+#define SIM_RTC_POWERUP_STATUS  0x88  // OSF | EN32kHz
+#define SIM_RTC_STATUS_FLAGS    0x83  // OSF, A2F, A1F: solo se borran escribiendo 0
+#define SIM_RTC_STATUS_EN32KHZ  0x08
+#define SIM_RTC_EPOCH_2000      946684800UL
+
+static uint8_t toBcd(int value) {
+    return (uint8_t)(((value / 10) << 4) | (value % 10));
+}
+
+static int fromBcd(uint8_t value) {
+    return (value >> 4) * 10 + (value & 0x0F);
+}
+
+MAX31328Model::MAX31328Model(double errorPpm) : _pointer(0), _errorPpm(errorPpm) {
+    memset(_regs, 0, sizeof(_regs));
+    _regs[MAX31328_REG_CONTROL] = SIM_RTC_POWERUP_CONTROL;
+    _regs[MAX31328_REG_STATUS] = SIM_RTC_POWERUP_STATUS;
+    _regs[MAX31328_REG_TEMP_MSB] = SIM_RTC_TEMP_C;
+    _anchorTrueUs = HAL::Native::trueEpochUs();
+    _anchorWallUs = (uint64_t)SIM_RTC_EPOCH_2000 * 1000000ULL;
+}
+
+// ——— Reloj ———
+
+/**
+ * @brief Error efectivo: un aging offset positivo frena el oscilador
+ */
+double MAX31328Model::effectivePpm() const {
+    return _errorPpm - (int8_t)_regs[MAX31328_REG_AGING] * SIM_RTC_AGING_PPM_PER_LSB;
+}
+
+uint64_t MAX31328Model::wallUs() {
+    uint64_t elapsed = HAL::Native::trueEpochUs() - _anchorTrueUs;
+    return _anchorWallUs + (uint64_t)((double)elapsed * (1.0 + effectivePpm() * 1e-6));
+}
+
+/**
+ * @brief Fija el punto de referencia en el instante actual (antes de cambiar el ppm)
+ */
+void MAX31328Model::reanchor() {
+    _anchorWallUs = wallUs();
+    _anchorTrueUs = HAL::Native::trueEpochUs();
+}
+
+/**
+ * @brief Copia la hora actual a los registros 0x00..0x06
+ */
+void MAX31328Model::materializeTime() {
+    time_t now = (time_t)(wallUs() / 1000000ULL);
+    struct tm t;
+    gmtime_r(&now, &t);
+    _regs[MAX31328_REG_SECONDS] = toBcd(t.tm_sec);
+    _regs[MAX31328_REG_MINUTES] = toBcd(t.tm_min);
+    _regs[MAX31328_REG_HOURS] = toBcd(t.tm_hour);
+    _regs[MAX31328_REG_WEEKDAY] = (uint8_t)(t.tm_wday + 1);
+    _regs[MAX31328_REG_DAY] = toBcd(t.tm_mday);
+    _regs[MAX31328_REG_MONTH] = toBcd(t.tm_mon + 1);
+    _regs[MAX31328_REG_YEAR] = toBcd((t.tm_year + 1900 - 2000) % 100);
+}
+
+void MAX31328Model::setTime(uint32_t wallEpoch) {
+    _anchorWallUs = (uint64_t)wallEpoch * 1000000ULL;
+    _anchorTrueUs = HAL::Native::trueEpochUs();
+    _regs[MAX31328_REG_STATUS] &= ~MAX31328_STAT_OSF;
+}
+
+// ——— Bus I2C ———
+
+bool MAX31328Model::write(const uint8_t* data, size_t length) {
+    if (length == 0) return true;
+    _pointer = data[0] % MAX31328_SNAPSHOT_LEN;
+
+    reanchor();  // El aging offset puede cambiar: la hora transcurrida se fija con el valor anterior
+    materializeTime();
+
+    bool timeWritten = false;
+    for (size_t i = 1; i < length; i++) {
+        uint8_t reg = _pointer;
+        uint8_t value = data[i];
+
+        if (reg <= MAX31328_REG_YEAR) {
+            _regs[reg] = value;
+            timeWritten = true;
+        } else if (reg == MAX31328_REG_STATUS) {
+            uint8_t old = _regs[reg];
+            _regs[reg] = (old & value & SIM_RTC_STATUS_FLAGS) | (value & SIM_RTC_STATUS_EN32KHZ);
+        } else if (reg == MAX31328_REG_CONTROL) {
+            _regs[reg] = value & ~MAX31328_CTRL_CONV;  // La conversión termina en el acto
+        } else if (reg < MAX31328_REG_TEMP_MSB) {
+            _regs[reg] = value;  // Alarmas y aging; la temperatura es de solo lectura
+        }
+        _pointer = (uint8_t)((_pointer + 1) % MAX31328_SNAPSHOT_LEN);
+    }
+
+    if (timeWritten) {
+        // Escribir los segundos reinicia la cadena de división: el segundo empieza ahora
+        _anchorWallUs = (uint64_t)MAX31328RTC::toEpoch(
+                            2000 + fromBcd(_regs[MAX31328_REG_YEAR]),
+                            fromBcd(_regs[MAX31328_REG_MONTH] & 0x1F),
+                            fromBcd(_regs[MAX31328_REG_DAY] & 0x3F),
+                            fromBcd(_regs[MAX31328_REG_HOURS] & 0x3F),
+                            fromBcd(_regs[MAX31328_REG_MINUTES] & 0x7F),
+                            fromBcd(_regs[MAX31328_REG_SECONDS] & 0x7F)) * 1000000ULL;
+        _anchorTrueUs = HAL::Native::trueEpochUs();
+    }
+    return true;
+}
+
+size_t MAX31328Model::read(uint8_t* data, size_t length) {
+    materializeTime();
+    for (size_t i = 0; i < length; i++) {
+        data[i] = _regs[_pointer];
+        _pointer = (uint8_t)((_pointer + 1) % MAX31328_SNAPSHOT_LEN);
+    }
+    return length;
+}
+
+// ——— Alarma 1 ———
+
+/**
+ * @brief Próximo instante (hora de pared) que coincide con la alarma 1
+ * @details Solo el modo que programa lib/RTC: A1M1..A1M4 = 0 y DY/DT = 0
+ *          (día del mes, hora, minuto y segundo).
+ * @return 0 si el modo no es ese o la fecha no existe en el próximo año
+ */
+uint32_t MAX31328Model::alarmTarget(uint32_t nowWall) const {
+    const uint8_t* a = &_regs[MAX31328_REG_ALARM1];
+    if ((a[0] | a[1] | a[2] | a[3]) & MAX31328_ALARM_MASK) return 0;
+    if (a[3] & 0x40) return 0;  // DY/DT = 1: día de la semana
+
+    int second = fromBcd(a[0] & 0x7F);
+    int minute = fromBcd(a[1] & 0x7F);
+    int hour = fromBcd(a[2] & 0x3F);
+    int day = fromBcd(a[3] & 0x3F);
+
+    time_t now = (time_t)nowWall;
+    struct tm t;
+    gmtime_r(&now, &t);
+    int year = t.tm_year + 1900;
+    int month = t.tm_mon + 1;
+
+    for (int k = 0; k <= 12; k++) {
+        static const int DAYS[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+        int days = DAYS[month - 1] + ((month == 2 && leap) ? 1 : 0);
+        if (day >= 1 && day <= days) {
+            uint32_t target = MAX31328RTC::toEpoch(year, month, day, hour, minute, second);
+            if (target > nowWall) return target;
+        }
+        if (++month > 12) {
+            month = 1;
+            year++;
+        }
+    }
+    return 0;
+}
+
+bool MAX31328Model::timeToAlarm(uint64_t& us) {
+    uint8_t control = _regs[MAX31328_REG_CONTROL];
+    if (!(control & MAX31328_CTRL_INTCN) || !(control & MAX31328_CTRL_A1IE)) return false;
+
+    if (_regs[MAX31328_REG_STATUS] & MAX31328_STAT_A1F) {
+        us = 0;  // INT ya está en bajo
+        return true;
+    }
+
+    uint64_t now = wallUs();
+    uint32_t target = alarmTarget((uint32_t)(now / 1000000ULL));
+    if (target == 0) return false;
+
+    // Tiempo de pared → tiempo verdadero con el error del cristal
+    double wallDelta = (double)((uint64_t)target * 1000000ULL - now);
+    us = (uint64_t)(wallDelta / (1.0 + effectivePpm() * 1e-6)) + 1;
+    return true;
+}
+
+void MAX31328Model::fireAlarm() {
+    _regs[MAX31328_REG_STATUS] |= MAX31328_STAT_A1F;
+}
+
+bool MAX31328Model::interruptAsserted() const {
+    uint8_t control = _regs[MAX31328_REG_CONTROL];
+    uint8_t status = _regs[MAX31328_REG_STATUS];
+    if (!(control & MAX31328_CTRL_INTCN)) return false;
+    return ((status & MAX31328_STAT_A1F) && (control & MAX31328_CTRL_A1IE)) ||
+           ((status & MAX31328_STAT_A2F) && (control & MAX31328_CTRL_A2IE));
+}
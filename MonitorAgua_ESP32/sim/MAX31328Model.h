@@ -0,0 +1,81 @@
+/**
+ * @file MAX31328Model.h
+ * @brief Modelo I2C del RTC MAX31328 para el simulador de ciclos.
+ * @details Mapa de registros 0x00..0x12 con la semántica que usa lib/RTC:
+ *          hora BCD, alarma 1 por coincidencia de fecha, control (EOSC, CONV,
+ *          INTCN, A1IE), status (OSF, A1F con borrado por escritura de 0) y aging
+ *          offset. El cristal tiene un error fijo en ppm que el aging offset
+ *          corrige a razón de 0.1 ppm/LSB, como en el chip.
+ *
+ *          Tiene batería propia: vive en memoria compartida (crear con
+ *          sharedNew()) y no pierde la hora en los cortes del ESP32.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef SIM_MAX31328_MODEL_H
+#define SIM_MAX31328_MODEL_H
+
+#include "HALNative.h"
+#include "RTC.h"
+
+#define SIM_RTC_AGING_PPM_PER_LSB 0.1    // Corrección por LSB del aging offset
+#define SIM_RTC_TEMP_C            25     // Temperatura reportada por el TCXO
+
+/**
+ * @class MAX31328Model
+ * @brief Esclavo I2C en MAX31328_I2C_ADDRESS
+ */
+class MAX31328Model : public HAL::Native::I2CDevice {
+public:
+    /**
+     * @param errorPpm Error del cristal (positivo: adelanta)
+     */
+    explicit MAX31328Model(double errorPpm);
+
+    bool write(const uint8_t* data, size_t length) override;
+    size_t read(uint8_t* data, size_t length) override;
+
+    /**
+     * @brief Fija la hora como si el chip ya estuviera en servicio (OSF = 0)
+     * @param wallEpoch Hora de pared (la escala de getUnixTimestamp())
+     */
+    void setTime(uint32_t wallEpoch);
+
+    /**
+     * @brief Hora de pared actual del chip (µs)
+     */
+    uint64_t wallUs();
+
+    /**
+     * @brief Tiempo virtual hasta que la alarma 1 baje INT
+     * @param us Destino
+     * @return false si la alarma no está habilitada como interrupción
+     */
+    bool timeToAlarm(uint64_t& us);
+
+    /**
+     * @brief Dispara la alarma 1 (A1F = 1, INT en bajo si A1IE)
+     */
+    void fireAlarm();
+
+    /**
+     * @brief INT/SQW en bajo (alarma pendiente con interrupción habilitada)
+     */
+    bool interruptAsserted() const;
+
+private:
+    uint8_t _regs[MAX31328_SNAPSHOT_LEN];
+    uint8_t _pointer;          ///< Registro de la próxima transferencia
+    double _errorPpm;          ///< Error del cristal sin corregir
+    uint64_t _anchorTrueUs;    ///< Instante (trueEpochUs) del último ajuste
+    uint64_t _anchorWallUs;    ///< Hora de pared en ese instante
+
+    double effectivePpm() const;
+    void reanchor();
+    void materializeTime();
+    uint32_t alarmTarget(uint32_t nowWall) const;
+};
+
+#endif // SIM_MAX31328_MODEL_H
@@ -0,0 +1,454 @@
+/**
+ * @file Simulation.cpp
+ * @brief Simulación de un equipo: estímulos, ciclos y contabilidad de lecturas.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include "Simulation.h"
+#include "HALNative.h"
+#include "RTCMemory.h"
+#include "MAX31328Model.h"
+#include "StandInServer.h"
+#include <algorithm>
+#include <deque>
+#include <unistd.h>
+
+// ——— Configuración ———
+
+// Pines de src/main.cpp
+#define SIM_TEMPERATURE_PIN   17
+#define SIM_TDS_PIN           7
+#define SIM_TURBIDITY_PIN     5
+#define SIM_PH_PIN            1
+#define SIM_RTC_INT_PIN       10
+
+#define SIM_WALL_OFFSET_S     (-5 * 3600)  // rtcDrift.syncWithNTP(..., -5): el MAX31328 guarda hora local
+#define SIM_ADC_NOISE_LSB     4.0f         // Ruido típico del SAR del ESP32-S2
+
+extern RTCMemoryManager rtcMemory;  // Instancia de src/main.cpp (lee la RAM persistente cargada)
+
+namespace Sim {
+
+    // ——— Escenario ———
+
+    void defaultScenario(Scenario& sc) {
+        memset(&sc, 0, sizeof(sc));
+        sc.days = 30.0;
+        sc.epoch = HAL_NATIVE_DEFAULT_EPOCH;
+        sc.seed = 1;
+        sc.devices = 1;
+        sc.jobs = (unsigned)sysconf(_SC_NPROCESSORS_ONLN);
+        sc.outage_mean_h = 2.0;
+        sc.brownout_off_s = 5.0;
+        sc.request_probability = 1.0f;
+        sc.rtc_present = true;
+        sc.rtc_ppm = 2.0;
+        sc.i_active_ma = 40.0;
+        sc.i_radio_ma = 80.0;
+        sc.i_sleep_ua = 25.0;
+    }
+
+    // ——— Generador ———
+
+    static uint32_t rng_state = 1;
+
+    static double random01() {
+        rng_state ^= rng_state << 13;
+        rng_state ^= rng_state >> 17;
+        rng_state ^= rng_state << 5;
+        return (rng_state >> 8) / 16777216.0;
+    }
+
+    /**
+     * @brief Espera exponencial (proceso de Poisson) con la tasa dada por hora
+     */
+    static double exponentialHours(double ratePerHour) {
+        return -log(1.0 - random01()) / ratePerHour;
+    }
+
+    // ——— Contabilidad de lecturas ———
+
+    /**
+     * @class ReadingLedger
+     * @brief Sigue cada lectura desde que entra al anillo hasta que se entrega o se pierde
+     */
+    class ReadingLedger {
+    public:
+        explicit ReadingLedger(Metrics& m) : _m(m), _last(0) {}
+
+        /**
+         * @brief Estado del anillo tras un ciclo
+         * @param total RTCMemoryManager::getTotalReadings()
+         */
+        void observe(uint16_t total) {
+            if (total < _last) drop(_m.lost_reinit);  // RTCMemory se reinicializó sin corte
+
+            for (uint32_t n = _last + 1; n <= total; n++) {
+                _pending.push_back({(uint16_t)n, false});
+                _m.produced++;
+            }
+            _last = total;
+
+            // El anillo retiene las últimas MAX_READINGS: lo anterior fue sobrescrito
+            uint32_t retained = std::min<uint32_t>(total, RTCMemoryManager::MAX_READINGS);
+            uint32_t oldest = total - retained + 1;
+            while (!_pending.empty() && _pending.front().number < oldest) {
+                if (!_pending.front().delivered) _m.lost_overwrite++;
+                _pending.pop_front();
+            }
+        }
+
+        void deliver(uint16_t number) {
+            if (_pending.empty() || number < _pending.front().number ||
+                number > _pending.back().number) {
+                return;
+            }
+            Entry& e = _pending[number - _pending.front().number];
+            if (e.delivered) {
+                _m.duplicates++;
+            } else {
+                e.delivered = true;
+                _m.delivered++;
+            }
+        }
+
+        /**
+         * @brief La RAM persistente se perdió (corte) o el firmware la reinicializó
+         * @param lost Contador donde se anotan las no entregadas
+         */
+        void drop(unsigned long& lost) {
+            for (const Entry& e : _pending) {
+                if (!e.delivered) lost++;
+            }
+            _pending.clear();
+            _last = 0;
+        }
+
+        unsigned long pending() const {
+            unsigned long n = 0;
+            for (const Entry& e : _pending) n += e.delivered ? 0 : 1;
+            return n;
+        }
+
+    private:
+        typedef struct {
+            uint16_t number;
+            bool delivered;
+        } Entry;
+
+        Metrics& _m;
+        std::deque<Entry> _pending;
+        uint32_t _last;
+    };
+
+    // ——— Estímulos ———
+
+    static bool inWindow(const Window& w, double hours) {
+        return hours >= w.start_h && hours < w.end_h;
+    }
+
+    /**
+     * @brief Agua sintética: ciclo diario de temperatura y deriva lenta del resto
+     * @details Los voltajes son los que entregan las tarjetas de los sensores para
+     *          ~7.2 pH, ~300 ppm y agua clara según la calibración por defecto. Lo
+     *          que reporta el firmware depende además de su conversión del ADC (hoy
+     *          caracteriza a 13 bits y muestrea a 12: ve la mitad del voltaje).
+     */
+    static void applyWater(const Scenario& sc, double hours) {
+        double day = sin(2.0 * M_PI * (hours - 9.0) / 24.0);
+        double noise = random01() - 0.5;
+
+        bool faulted[4] = {false, false, false, false};
+        for (int i = 0; i < sc.fault_count; i++) {
+            if (inWindow(sc.faults[i].when, hours)) faulted[sc.faults[i].sensor] = true;
+        }
+
+        // Excursión: +8 °C, agua más ácida, más sales disueltas, agua turbia
+        static const double EXCURSION[4] = {8.0, 300.0, 300.0, -1000.0};
+        double shift[4] = {0.0, 0.0, 0.0, 0.0};
+        for (int i = 0; i < sc.excursion_count; i++) {
+            if (inWindow(sc.excursions[i].when, hours)) shift[sc.excursions[i].sensor] = EXCURSION[sc.excursions[i].sensor];
+        }
+
+        HAL::Native::setOneWireTemperature(SIM_TEMPERATURE_PIN,
+            faulted[FAULT_TEMPERATURE] ? NAN : (float)(22.0 + 3.0 * day + 0.2 * noise + shift[FAULT_TEMPERATURE]));
+        HAL::Native::setAnalogMilliVolts(SIM_PH_PIN,
+            faulted[FAULT_PH] ? 0.0f : (float)(1680.0 + 20.0 * day + 5.0 * noise + shift[FAULT_PH]));
+        HAL::Native::setAnalogMilliVolts(SIM_TDS_PIN,
+            faulted[FAULT_TDS] ? 0.0f : (float)(560.0 + 20.0 * day + 5.0 * noise + shift[FAULT_TDS]));
+        HAL::Native::setAnalogMilliVolts(SIM_TURBIDITY_PIN,
+            faulted[FAULT_TURBIDITY] ? 0.0f : (float)(2450.0 + 10.0 * noise + shift[FAULT_TURBIDITY]));
+    }
+
+    // ——— Un equipo ———
+
+    static const char* endName(HAL::Native::CycleEnd end) {
+        switch (end) {
+            case HAL::Native::CYCLE_DEEP_SLEEP: return "sleep";
+            case HAL::Native::CYCLE_RESTART:    return "restart";
+            case HAL::Native::CYCLE_BROWNOUT:   return "brownout";
+            default:                            return "crash";
+        }
+    }
+
+    bool simulateDevice(const Scenario& sc, unsigned device, Metrics& m) {
+        memset(&m, 0, sizeof(m));
+        rng_state = sc.seed * 2654435761u + device * 40503u + 1;
+
+        HAL::Native::init();
+        HAL::Native::setStartEpoch(sc.epoch);
+        HAL::Native::setAnalogNoise(SIM_ADC_NOISE_LSB);
+
+        MAX31328Model* rtc = nullptr;
+        if (sc.rtc_present) {
+            double ppm = sc.rtc_ppm + sc.rtc_ppm_spread * (2.0 * random01() - 1.0);
+            rtc = HAL::Native::sharedNew<MAX31328Model>(ppm);
+            if (!sc.rtc_unset) rtc->setTime((uint32_t)((int64_t)sc.epoch + SIM_WALL_OFFSET_S));
+            HAL::Native::attachI2CDevice(MAX31328_I2C_ADDRESS, rtc);
+        }
+        StandInServer* server = HAL::Native::sharedNew<StandInServer>(rng_state ^ 0xA5A5A5A5u);
+        server->setRequestProbability(sc.request_probability);
+        HAL::Native::attachWebSocketPeer(server);
+
+        // Caídas aleatorias de WiFi y cortes: próximos eventos en horas
+        double horizon_h = sc.cycles ? 1e12 : sc.days * 24.0;
+        double next_outage_h = sc.outages_per_day > 0 ? exponentialHours(sc.outages_per_day / 24.0) : 1e12;
+        double outage_end_h = -1.0;
+        double next_brownout_h = sc.brownouts_per_day > 0 ? exponentialHours(sc.brownouts_per_day / 24.0) : 1e12;
+
+        FILE* csv = nullptr;
+        if (sc.csv_path) {
+            csv = fopen(sc.csv_path, "w");
+            if (csv) {
+                fprintf(csv, "cycle,epoch,end,wake,awake_s,sleep_s,radio_s,bytes_sent,bytes_received,"
+                             "total_readings,delivered,lost_overwrite,lost_power,lost_reinit,alerts,charge_mah\n");
+            }
+        }
+
+        ReadingLedger ledger(m);
+        uint64_t start_us = HAL::Native::trueEpochUs();
+        const char* wake = "poweron";
+        bool ok = true;
+
+        for (;;) {
+            double hours = (HAL::Native::trueEpochUs() - start_us) / 3.6e9;
+            if (sc.cycles ? m.cycles >= sc.cycles : hours >= horizon_h) break;
+
+            // Escenario en este instante
+            if (hours >= next_outage_h) {
+                outage_end_h = hours + exponentialHours(1.0 / sc.outage_mean_h);
+                next_outage_h = outage_end_h + exponentialHours(sc.outages_per_day / 24.0);
+            }
+            bool wifiUp = hours >= outage_end_h;
+            for (int i = 0; i < sc.outage_count; i++) {
+                if (inWindow(sc.outages[i], hours)) wifiUp = false;
+            }
+            HAL::Native::setWiFi(wifiUp);
+            applyWater(sc, hours);
+
+            uint64_t to_brownout_us = (uint64_t)((next_brownout_h - hours) * 3.6e9);
+            if (next_brownout_h < 1e11) HAL::Native::scheduleBrownout(to_brownout_us);
+
+            HAL::Native::CycleResult r = HAL::Native::runCycle();
+            m.cycles++;
+            m.awake_us += r.awake_us;
+            m.awake_max_us = std::max(m.awake_max_us, r.awake_us);
+            m.awake_hist[std::min<uint64_t>(r.awake_us / 1000000ULL, 63)]++;
+            m.radio_us += r.radio_on_us;
+            m.bytes_sent += r.bytes_sent;
+            m.bytes_received += r.bytes_received;
+            if (r.radio_on_us > 0) m.connections++;
+            double charge = r.awake_us / 1e6 * sc.i_active_ma + r.radio_on_us / 1e6 * sc.i_radio_ma;
+
+            // Lecturas: primero lo guardado en el ciclo, luego lo que llegó al servidor
+            if (r.end != HAL::Native::CYCLE_BROWNOUT && HAL::Native::loadPersistent()) {
+                ledger.observe(rtcMemory.getTotalReadings());
+            }
+            uint16_t numbers[SIM_SERVER_DELIVERIES];
+            size_t count = server->takeDeliveries(numbers, SIM_SERVER_DELIVERIES);
+            for (size_t i = 0; i < count; i++) ledger.deliver(numbers[i]);
+            m.alerts = server->alerts();
+
+            // Próximo despertar
+            uint64_t sleep_us = 0;
+            esp_sleep_wakeup_cause_t cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+            uint64_t ext1 = 0;
+            bool alarm = false;
+            bool power_lost = false;
+
+            switch (r.end) {
+                case HAL::Native::CYCLE_DEEP_SLEEP: {
+                    sleep_us = r.sleep_us ? r.sleep_us : UINT64_MAX;
+                    cause = ESP_SLEEP_WAKEUP_TIMER;
+
+                    // INT del MAX31328 (activo en bajo) armado como ext1 "todos en bajo"
+                    uint64_t to_alarm;
+                    if (rtc && (r.ext1_mask & (1ULL << SIM_RTC_INT_PIN)) && !r.ext1_any_high &&
+                        rtc->timeToAlarm(to_alarm) && to_alarm < sleep_us) {
+                        sleep_us = to_alarm;
+                        cause = ESP_SLEEP_WAKEUP_EXT1;
+                        ext1 = 1ULL << SIM_RTC_INT_PIN;
+                        alarm = true;
+                    }
+                    if (sleep_us == UINT64_MAX) {
+                        fprintf(stderr, "[SIM] equipo %u, ciclo %lu: deep sleep sin fuente de despertar\n",
+                                device, m.cycles);
+                        ok = false;
+                    }
+                    break;
+                }
+                case HAL::Native::CYCLE_RESTART:
+                    m.restarts++;
+                    break;
+                case HAL::Native::CYCLE_BROWNOUT:
+                    power_lost = true;
+                    break;
+                default:
+                    m.crashes++;
+                    power_lost = true;  // Reinicio por pánico: se trata como arranque en frío
+                    break;
+            }
+            if (!ok) break;
+
+            // Corte mientras duerme
+            double sleep_end_h = (HAL::Native::trueEpochUs() - start_us + (double)sleep_us) / 3.6e9;
+            if (!power_lost && r.end == HAL::Native::CYCLE_DEEP_SLEEP && next_brownout_h < sleep_end_h) {
+                uint64_t now_us = HAL::Native::trueEpochUs() - start_us;
+                sleep_us = (uint64_t)(next_brownout_h * 3.6e9) - std::min<uint64_t>(now_us, (uint64_t)(next_brownout_h * 3.6e9));
+                power_lost = true;
+            }
+
+            if (power_lost) {
+                if (sleep_us > 0) {
+                    HAL::Native::advanceUs(sleep_us);
+                    charge += sleep_us / 1e6 * sc.i_sleep_ua / 1000.0;
+                    m.sleep_us += sleep_us;
+                }
+                if (r.end != HAL::Native::CYCLE_CRASH) {
+                    m.brownouts++;
+                    uint64_t off_us = (uint64_t)(sc.brownout_off_s * 1e6);
+                    HAL::Native::advanceUs(off_us);
+                    m.off_us += off_us;
+                    double now_h = (HAL::Native::trueEpochUs() - start_us) / 3.6e9;
+                    next_brownout_h = now_h + exponentialHours(sc.brownouts_per_day / 24.0);
+                }
+                HAL::Native::powerCycle();
+                ledger.drop(m.lost_power);
+                wake = "poweron";
+            } else if (r.end == HAL::Native::CYCLE_DEEP_SLEEP) {
+                HAL::Native::wake(sleep_us, cause, ext1);
+                if (alarm) {
+                    rtc->fireAlarm();
+                    m.alarm_wakes++;
+                    wake = "alarm";
+                } else {
+                    m.timer_wakes++;
+                    wake = "timer";
+                }
+                charge += sleep_us / 1e6 * sc.i_sleep_ua / 1000.0;
+                m.sleep_us += sleep_us;
+            } else {
+                HAL::Native::wake(0, ESP_SLEEP_WAKEUP_UNDEFINED);
+                wake = "restart";
+            }
+            m.charge_mas += charge;
+
+            if (csv) {
+                fprintf(csv, "%lu,%llu,%s,%s,%.3f,%.3f,%.3f,%u,%u,%u,%lu,%lu,%lu,%lu,%lu,%.6f\n",
+                        m.cycles, (unsigned long long)(HAL::Native::trueEpochUs() / 1000000ULL),
+                        endName(r.end), wake, r.awake_us / 1e6, sleep_us / 1e6, r.radio_on_us / 1e6,
+                        (unsigned)r.bytes_sent, (unsigned)r.bytes_received,
+                        (unsigned)rtcMemory.getTotalReadings(), m.delivered, m.lost_overwrite,
+                        m.lost_power, m.lost_reinit, m.alerts, m.charge_mas / 3600.0);
+            }
+        }
+
+        m.pending = ledger.pending();
+        m.simulated_s = (HAL::Native::trueEpochUs() - start_us) / 1e6;
+        if (csv) fclose(csv);
+        return ok;
+    }
+
+    // ——— Resumen ———
+
+    void add(Metrics& total, const Metrics& m) {
+        total.cycles += m.cycles;
+        total.timer_wakes += m.timer_wakes;
+        total.alarm_wakes += m.alarm_wakes;
+        total.restarts += m.restarts;
+        total.brownouts += m.brownouts;
+        total.crashes += m.crashes;
+        total.connections += m.connections;
+        total.awake_us += m.awake_us;
+        total.awake_max_us = std::max(total.awake_max_us, m.awake_max_us);
+        total.sleep_us += m.sleep_us;
+        total.off_us += m.off_us;
+        total.radio_us += m.radio_us;
+        total.bytes_sent += m.bytes_sent;
+        total.bytes_received += m.bytes_received;
+        total.produced += m.produced;
+        total.delivered += m.delivered;
+        total.duplicates += m.duplicates;
+        total.lost_overwrite += m.lost_overwrite;
+        total.lost_power += m.lost_power;
+        total.lost_reinit += m.lost_reinit;
+        total.pending += m.pending;
+        total.alerts += m.alerts;
+        total.charge_mas += m.charge_mas;
+        total.simulated_s += m.simulated_s;
+        for (int i = 0; i < 64; i++) total.awake_hist[i] += m.awake_hist[i];
+    }
+
+    unsigned awakePercentile(const Metrics& m, double p) {
+        uint64_t target = (uint64_t)ceil(m.cycles * p);
+        uint64_t seen = 0;
+        for (unsigned i = 0; i < 64; i++) {
+            seen += m.awake_hist[i];
+            if (seen >= target && seen > 0) return i + 1;
+        }
+        return 64;
+    }
+
+    void summarize(const Metrics& m, Summary& s) {
+        double cycles = m.cycles ? (double)m.cycles : 1.0;
+        double lost = (double)(m.lost_overwrite + m.lost_power + m.lost_reinit);
+        s.awake_mean_s = m.awake_us / 1e6 / cycles;
+        s.awake_p95_s = awakePercentile(m, 0.95);
+        s.awake_max_s = m.awake_max_us / 1e6;
+        s.radio_s_per_connection = m.connections ? m.radio_us / 1e6 / m.connections : 0.0;
+        s.bytes_sent_per_delivered = m.delivered ? (double)m.bytes_sent / m.delivered : 0.0;
+        s.bytes_sent_per_cycle = m.bytes_sent / cycles;
+        s.lost_readings_pct = m.produced ? 100.0 * lost / m.produced : 0.0;
+        s.crashes = m.crashes;
+        s.alerts = m.alerts;
+        s.avg_current_ma = m.simulated_s > 0 ? m.charge_mas / m.simulated_s : 0.0;
+    }
+
+    bool summaryValue(const Summary& s, const char* key, double& value) {
+        static const struct {
+            const char* key;
+            double Summary::*field;
+        } KEYS[] = {
+            {"awake_mean_s", &Summary::awake_mean_s},
+            {"awake_p95_s", &Summary::awake_p95_s},
+            {"awake_max_s", &Summary::awake_max_s},
+            {"radio_s_per_connection", &Summary::radio_s_per_connection},
+            {"bytes_sent_per_delivered", &Summary::bytes_sent_per_delivered},
+            {"bytes_sent_per_cycle", &Summary::bytes_sent_per_cycle},
+            {"lost_readings_pct", &Summary::lost_readings_pct},
+            {"crashes", &Summary::crashes},
+            {"alerts", &Summary::alerts},
+            {"avg_current_ma", &Summary::avg_current_ma},
+        };
+        for (const auto& k : KEYS) {
+            if (strcmp(k.key, key) == 0) {
+                value = s.*k.field;
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace Sim
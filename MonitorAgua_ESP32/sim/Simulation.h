@@ -0,0 +1,169 @@
+/**
+ * @file Simulation.h
+ * @brief Escenario, métricas y simulación de un equipo (sin línea de comandos).
+ * @details simulateDevice() ejecuta el setup() de src/main.cpp ciclo a ciclo
+ *          sobre la HAL nativa y acumula las métricas; summarize() las reduce a
+ *          las claves de la sección [sim] de perf_budgets.ini. Lo usan
+ *          sim/main.cpp (reporte y --json) y la suite test_sim_budgets.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef SIM_SIMULATION_H
+#define SIM_SIMULATION_H
+
+#include <Arduino.h>
+
+#define SIM_MAX_WINDOWS       32           // Ventanas de caída/falla por escenario
+
+namespace Sim {
+
+    // ——— Escenario ———
+
+    /**
+     * @brief Intervalo [start, end) en horas desde el inicio de la simulación
+     */
+    typedef struct {
+        double start_h;
+        double end_h;
+    } Window;
+
+    /**
+     * @brief Sensor que falla
+     */
+    typedef enum : uint8_t {
+        FAULT_TEMPERATURE,   ///< DS18B20 desconectado (-127 °C)
+        FAULT_PH,            ///< Entrada analógica abierta (0 mV)
+        FAULT_TDS,
+        FAULT_TURBIDITY
+    } FaultSensor;
+
+    typedef struct {
+        FaultSensor sensor;
+        Window when;
+    } Fault;
+
+    /**
+     * @brief Parámetros de una corrida
+     */
+    typedef struct {
+        double days;
+        unsigned long cycles;          ///< Si > 0 manda sobre days
+        uint32_t epoch;                ///< Hora Unix (UTC) de inicio
+        uint32_t seed;
+        unsigned devices;
+        unsigned jobs;
+
+        Window outages[SIM_MAX_WINDOWS];
+        int outage_count;
+        double outages_per_day;        ///< Caídas aleatorias de WiFi
+        double outage_mean_h;
+
+        Fault faults[SIM_MAX_WINDOWS];
+        int fault_count;
+
+        Fault excursions[SIM_MAX_WINDOWS];  ///< Agua fuera de lo normal (sensor sano)
+        int excursion_count;
+
+        double brownouts_per_day;      ///< Cortes de alimentación aleatorios
+        double brownout_off_s;
+
+        float request_probability;     ///< El usuario pide los datos en esa fracción de sesiones
+        bool rtc_present;
+        bool rtc_unset;                ///< MAX31328 recién alimentado (OSF, año 2000)
+        double rtc_ppm;                ///< Error del cristal (por equipo: ± rtc_ppm_spread)
+        double rtc_ppm_spread;
+
+        double i_active_ma;
+        double i_radio_ma;             ///< Adicional a i_active con la radio encendida
+        double i_sleep_ua;
+        double battery_mah;
+
+        const char* csv_path;
+        const char* json_path;         ///< Resumen para tools/perf_budget.py
+    } Scenario;
+
+    /**
+     * @brief Métricas acumuladas de un equipo (se suman para la flota)
+     */
+    typedef struct {
+        unsigned long cycles;
+        unsigned long timer_wakes;
+        unsigned long alarm_wakes;
+        unsigned long restarts;
+        unsigned long brownouts;
+        unsigned long crashes;
+        unsigned long connections;     ///< Ciclos con la radio encendida
+        uint64_t awake_us;
+        uint64_t awake_max_us;
+        uint64_t sleep_us;
+        uint64_t off_us;
+        uint64_t radio_us;
+        uint64_t bytes_sent;
+        uint64_t bytes_received;
+        unsigned long produced;        ///< Lecturas guardadas en RTCMemory
+        unsigned long delivered;       ///< Entregadas al servidor (sin repetir)
+        unsigned long duplicates;      ///< Reenvíos de lecturas ya entregadas
+        unsigned long lost_overwrite;  ///< Sobrescritas en el anillo sin haberse enviado
+        unsigned long lost_power;      ///< Borradas por un corte sin haberse enviado
+        unsigned long lost_reinit;     ///< Borradas al reinicializar RTCMemory (validación fallida)
+        unsigned long pending;         ///< Sin entregar al final (aún en el anillo)
+        unsigned long alerts;          ///< Alertas de anomalía recibidas por el servidor
+        double charge_mas;             ///< Carga consumida (mA·s)
+        double simulated_s;
+        uint32_t awake_hist[64];       ///< Histograma del tiempo despierto (s)
+    } Metrics;
+
+    /**
+     * @brief Resumen de una corrida: claves de la sección [sim] de perf_budgets.ini
+     */
+    typedef struct {
+        double awake_mean_s;
+        double awake_p95_s;            ///< Resolución de 1 s (histograma)
+        double awake_max_s;
+        double radio_s_per_connection;
+        double bytes_sent_per_delivered;
+        double bytes_sent_per_cycle;
+        double lost_readings_pct;
+        double crashes;
+        double alerts;
+        double avg_current_ma;
+    } Summary;
+
+    /**
+     * @brief Escenario por defecto (30 días, un equipo, sin fallas)
+     */
+    void defaultScenario(Scenario& sc);
+
+    /**
+     * @brief Simula un equipo completo
+     * @param device Índice en la flota (deriva la semilla)
+     * @return false si el firmware quedó sin fuente de despertar
+     */
+    bool simulateDevice(const Scenario& sc, unsigned device, Metrics& m);
+
+    /**
+     * @brief Suma las métricas de un equipo al total de la flota
+     */
+    void add(Metrics& total, const Metrics& m);
+
+    /**
+     * @brief Percentil del tiempo despierto (resolución de 1 s)
+     */
+    unsigned awakePercentile(const Metrics& m, double p);
+
+    /**
+     * @brief Reduce las métricas a las claves de [sim]
+     */
+    void summarize(const Metrics& m, Summary& s);
+
+    /**
+     * @brief Valor de una clave de [sim] en el resumen
+     * @return false si la clave no existe
+     */
+    bool summaryValue(const Summary& s, const char* key, double& value);
+
+} // namespace Sim
+
+#endif // SIM_SIMULATION_H
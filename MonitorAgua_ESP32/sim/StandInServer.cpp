@@ -0,0 +1,93 @@
+/**
+ * @file StandInServer.cpp
+ * @brief Implementación del servidor WebSocket simulado.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include "StandInServer.h"
+
+StandInServer::StandInServer(uint32_t seed)
+    : _outboxNext(0), _rng(seed ? seed : 1), _requestProbability(1.0f), _sessions(0), _requests(0), _alerts(0) {
+    _outbox.clear();
+    _delivered.clear();
+}
+
+/**
+ * @brief Generador xorshift32 (determinista con la semilla)
+ */
+float StandInServer::random01() {
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    return (_rng >> 8) / 16777216.0f;
+}
+
+void StandInServer::enqueue(const char* text) {
+    Message m;
+    m.length = (uint8_t)snprintf(m.text, sizeof(m.text), "%s", text);
+    _outbox.push_back(m);  // Cola llena: se descarta, como un mensaje que no llegó a tiempo
+}
+
+bool StandInServer::onOpen() {
+    _sessions++;
+    _outbox.clear();
+    _outboxNext = 0;
+
+    // Mismo saludo y pedido que servidor.py (el pedido lo dispara el usuario)
+    enqueue("{\"status\":\"conectado\",\"mensaje\":\"Servidor listo para recibir datos\"}");
+    if (random01() < _requestProbability) {
+        _requests++;
+        enqueue("{\"action\":\"request_all_data\"}");
+    }
+    return true;
+}
+
+void StandInServer::onText(const char* payload, size_t length) {
+    static const char KEY[] = "\"reading_number\":";
+    static const char ALERT[] = "\"action\":\"alert\"";
+    if (memmem(payload, length, ALERT, sizeof(ALERT) - 1)) {
+        _alerts++;  // servidor.py no responde a las alertas
+        return;
+    }
+
+    const char* end = payload + length;
+    const char* found = (const char*)memmem(payload, length, KEY, sizeof(KEY) - 1);
+    if (!found) return;
+
+    const char* digits = found + sizeof(KEY) - 1;
+    uint32_t number = 0;
+    while (digits < end && *digits >= '0' && *digits <= '9') {
+        number = number * 10 + (uint32_t)(*digits++ - '0');
+    }
+    _delivered.push_back((uint16_t)number);
+
+    char ack[SIM_SERVER_MESSAGE_LEN];
+    snprintf(ack, sizeof(ack), "{\"status\":\"received\",\"reading_number\":%u}", (unsigned)number);
+    if (_outboxNext >= _outbox.size()) {  // Cola consumida: reutilizarla
+        _outbox.clear();
+        _outboxNext = 0;
+    }
+    enqueue(ack);
+}
+
+size_t StandInServer::poll(char* buffer, size_t capacity) {
+    if (_outboxNext >= _outbox.size() || capacity == 0) return 0;
+    const Message& m = _outbox[_outboxNext++];
+    size_t length = (m.length < capacity) ? m.length : capacity - 1;
+    memcpy(buffer, m.text, length);
+    return length;
+}
+
+void StandInServer::onClose() {
+    _outbox.clear();
+    _outboxNext = 0;
+}
+
+size_t StandInServer::takeDeliveries(uint16_t* out, size_t capacity) {
+    size_t n = (_delivered.size() < capacity) ? _delivered.size() : capacity;
+    memcpy(out, _delivered.data(), n * sizeof(uint16_t));
+    _delivered.clear();
+    return n;
+}
@@ -0,0 +1,76 @@
+/**
+ * @file StandInServer.h
+ * @brief Servidor WebSocket simulado con el protocolo de servidor.py.
+ * @details Al abrirse la sesión saluda y, con probabilidad configurable, pide
+ *          los datos ("request_all_data") como lo haría un usuario desde la
+ *          página. Confirma cada lectura con {"status":"received"} y anota su
+ *          reading_number para que el simulador cuente entregas y duplicados.
+ *
+ *          Vive en memoria compartida (sharedNew()): lo que recibe durante un
+ *          ciclo lo lee después el ejecutor.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#ifndef SIM_STAND_IN_SERVER_H
+#define SIM_STAND_IN_SERVER_H
+
+#include "HALNative.h"
+#include "StaticVector.h"
+
+#define SIM_SERVER_QUEUE        128   // Mensajes pendientes hacia el firmware (un envío completo)
+#define SIM_SERVER_MESSAGE_LEN  96    // Tamaño máximo de un mensaje del servidor
+#define SIM_SERVER_DELIVERIES   512   // Lecturas anotadas entre dos takeDeliveries()
+
+/**
+ * @class StandInServer
+ * @brief Implementación de HAL::Native::WebSocketPeer
+ */
+class StandInServer : public HAL::Native::WebSocketPeer {
+public:
+    /**
+     * @param seed Semilla del generador (decisión de pedir datos)
+     */
+    explicit StandInServer(uint32_t seed);
+
+    /**
+     * @brief Probabilidad de pedir los datos en cada sesión (0..1)
+     */
+    void setRequestProbability(float probability) { _requestProbability = probability; }
+
+    bool onOpen() override;
+    void onText(const char* payload, size_t length) override;
+    size_t poll(char* buffer, size_t capacity) override;
+    void onClose() override;
+
+    /**
+     * @brief Entrega al ejecutor los reading_number recibidos desde la última llamada
+     * @return Cantidad copiada (las que no caben se pierden para la estadística)
+     */
+    size_t takeDeliveries(uint16_t* out, size_t capacity);
+
+    uint32_t sessions() const { return _sessions; }   ///< Sesiones abiertas
+    uint32_t requests() const { return _requests; }   ///< Sesiones con pedido de datos
+    uint32_t alerts() const { return _alerts; }       ///< Alertas de anomalía recibidas
+
+private:
+    typedef struct {
+        uint8_t length;
+        char text[SIM_SERVER_MESSAGE_LEN];
+    } Message;
+
+    StaticVector<Message, SIM_SERVER_QUEUE> _outbox;
+    size_t _outboxNext;                                   ///< Próximo mensaje a entregar
+    StaticVector<uint16_t, SIM_SERVER_DELIVERIES> _delivered;
+    uint32_t _rng;
+    float _requestProbability;
+    uint32_t _sessions;
+    uint32_t _requests;
+    uint32_t _alerts;
+
+    void enqueue(const char* text);
+    float random01();
+};
+
+#endif // SIM_STAND_IN_SERVER_H
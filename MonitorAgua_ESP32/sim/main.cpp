@@ -0,0 +1,278 @@
+/**
+ * @file main.cpp
+ * @brief Simulador determinista de ciclos completos en tiempo virtual.
+ * @details Ejecuta el setup() real de src/main.cpp sobre la HAL nativa: cada
+ *          despertar es un proceso nuevo que solo conserva la RAM persistente,
+ *          delay(), millis() y el deep sleep avanzan un reloj virtual, y el
+ *          firmware ve un MAX31328 (modelo I2C con deriva), sensores sintéticos y
+ *          un servidor WebSocket simulado con el protocolo de servidor.py. Meses
+ *          de ciclos de 80 s corren en segundos.
+ *
+ *          Escenario: caídas de WiFi, cortes de alimentación (también durmiendo),
+ *          fallas de sensores y excursiones de calidad del agua (para las alertas
+ *          de AnomalyDetector), en ventanas fijas o aleatorias con semilla. Con
+ *          --devices N se simula una flota (un proceso por equipo, semillas
+ *          distintas) y se reporta el agregado.
+ *
+ *          Reporte: tiempo despierto por ciclo, tiempo de radio, bytes enviados,
+ *          lecturas entregadas, duplicadas y perdidas (sobrescritas en el anillo
+ *          de RTCMemory antes de enviarse o borradas por un corte) y energía.
+ *
+ *              pio run -e sim
+ *              .pio/build/sim/program --days 90 --outage 240:300 --brownouts-per-day 0.2
+ *              .pio/build/sim/program --days 30 --devices 50 --request-prob 0.3
+ *
+ *          Comparar el reporte antes y después de tocar la planificación o el
+ *          almacenamiento permite evaluar el cambio sin flashear.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <Arduino.h>
+#include "Simulation.h"
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ——— Configuración ———
+
+#define SIM_SUPPLY_V          3.3          // Tensión para convertir carga en energía
+#define SIM_MAX_DEVICES       1000
+
+// ——— Reporte ———
+
+static void report(const Sim::Scenario& sc, const Sim::Metrics& m, unsigned devices, double realSeconds) {
+    double days = m.simulated_s / 86400.0 / devices;
+    double cycles = m.cycles ? (double)m.cycles : 1.0;
+    double charge_mah = m.charge_mas / 3600.0 / devices;
+    double avg_ma = m.simulated_s > 0 ? m.charge_mas / m.simulated_s : 0.0;
+
+    printf("\n=== SIMULACIÓN ===\n");
+    printf("Equipos: %u | días simulados: %.1f | ciclos: %lu | tiempo real: %.1f s\n",
+           devices, days, m.cycles, realSeconds);
+    printf("Despierto por ciclo: media %.2f s | p50 ≤%u s | p95 ≤%u s | máx %.2f s | duty %.1f%%\n",
+           m.awake_us / 1e6 / cycles, Sim::awakePercentile(m, 0.50), Sim::awakePercentile(m, 0.95),
+           m.awake_max_us / 1e6, 100.0 * m.awake_us / 1e6 / (m.simulated_s > 0 ? m.simulated_s : 1.0));
+    printf("Despertares: temporizador %lu | alarma RTC %lu | reinicios %lu | cortes %lu | fallos %lu\n",
+           m.timer_wakes, m.alarm_wakes, m.restarts, m.brownouts, m.crashes);
+    printf("Radio: %.1f s en total | %lu conexiones | %.2f s por conexión\n",
+           m.radio_us / 1e6, m.connections,
+           m.connections ? m.radio_us / 1e6 / m.connections : 0.0);
+    printf("Tráfico: %llu B enviados | %llu B recibidos | %.0f B enviados por lectura entregada\n",
+           (unsigned long long)m.bytes_sent, (unsigned long long)m.bytes_received,
+           m.delivered ? (double)m.bytes_sent / m.delivered : 0.0);
+    printf("Lecturas: %lu guardadas | %lu entregadas | %lu reenvíos | %lu sobrescritas sin enviar | "
+           "%lu perdidas por cortes | %lu por reinicio de RTCMemory | %lu pendientes\n",
+           m.produced, m.delivered, m.duplicates, m.lost_overwrite, m.lost_power, m.lost_reinit,
+           m.pending);
+    printf("Alertas de anomalía: %lu\n", m.alerts);
+    printf("Energía: %.1f mAh (%.1f mWh) por equipo | corriente media %.3f mA",
+           charge_mah, charge_mah * SIM_SUPPLY_V, avg_ma);
+    if (sc.battery_mah > 0 && avg_ma > 0) {
+        printf(" | autonomía con %.0f mAh: %.1f días", sc.battery_mah, sc.battery_mah / avg_ma / 24.0);
+    }
+    printf("\n");
+}
+
+/**
+ * @brief Resumen en JSON plano (claves de la sección [sim] de perf_budgets.ini)
+ */
+static bool writeJson(const char* path, const Sim::Metrics& m, unsigned devices) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+    Sim::Summary s;
+    Sim::summarize(m, s);
+    fprintf(f, "{\n  \"devices\": %u,\n  \"cycles\": %lu,\n", devices, m.cycles);
+    fprintf(f, "  \"awake_mean_s\": %.4f,\n  \"awake_p95_s\": %.0f,\n  \"awake_max_s\": %.4f,\n",
+            s.awake_mean_s, s.awake_p95_s, s.awake_max_s);
+    fprintf(f, "  \"radio_s_per_connection\": %.4f,\n", s.radio_s_per_connection);
+    fprintf(f, "  \"bytes_sent_per_delivered\": %.1f,\n  \"bytes_sent_per_cycle\": %.1f,\n",
+            s.bytes_sent_per_delivered, s.bytes_sent_per_cycle);
+    fprintf(f, "  \"lost_readings_pct\": %.4f,\n  \"crashes\": %.0f,\n  \"alerts\": %.0f,\n",
+            s.lost_readings_pct, s.crashes, s.alerts);
+    fprintf(f, "  \"avg_current_ma\": %.4f\n}\n", s.avg_current_ma);
+    fclose(f);
+    return true;
+}
+
+// ——— Línea de comandos ———
+
+static bool parseWindow(const char* text, Sim::Window& w) {
+    return sscanf(text, "%lf:%lf", &w.start_h, &w.end_h) == 2 && w.end_h > w.start_h;
+}
+
+static bool parseFault(const char* text, Sim::Fault& f) {
+    static const char* NAMES[] = {"temp", "ph", "tds", "turb"};
+    const char* colon = strchr(text, ':');
+    if (!colon) return false;
+    for (int i = 0; i < 4; i++) {
+        if (strlen(NAMES[i]) == (size_t)(colon - text) && strncmp(text, NAMES[i], colon - text) == 0) {
+            f.sensor = (Sim::FaultSensor)i;
+            return parseWindow(colon + 1, f.when);
+        }
+    }
+    return false;
+}
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "Uso: %s [opciones]\n"
+            "  --days D               días simulados (30)\n"
+            "  --cycles N             en lugar de --days\n"
+            "  --epoch E              hora Unix UTC de inicio\n"
+            "  --seed S               semilla (1)\n"
+            "  --devices N            equipos de la flota (1)\n"
+            "  --jobs J               equipos en paralelo (núcleos)\n"
+            "  --outage H0:H1         WiFi caído entre esas horas (repetible)\n"
+            "  --outages-per-day R    caídas aleatorias de WiFi\n"
+            "  --outage-mean-h H      duración media de esas caídas (2)\n"
+            "  --fault S:H0:H1        falla de sensor temp|ph|tds|turb (repetible)\n"
+            "  --excursion S:H0:H1    agua fuera de lo normal en ese sensor (repetible)\n"
+            "  --brownouts-per-day R  cortes de alimentación aleatorios\n"
+            "  --brownout-off S       segundos sin alimentación por corte (5)\n"
+            "  --request-prob P       fracción de sesiones en que se piden los datos (1)\n"
+            "  --no-rtc               sin MAX31328\n"
+            "  --rtc-unset            MAX31328 recién alimentado (sin hora)\n"
+            "  --rtc-ppm P            error del cristal (2), --rtc-ppm-spread P (0)\n"
+            "  --i-active MA          corriente despierto (40)\n"
+            "  --i-radio MA           corriente extra con radio (80)\n"
+            "  --i-sleep UA           corriente en deep sleep (25)\n"
+            "  --battery MAH          capacidad para estimar autonomía (0 = no)\n"
+            "  --csv ARCHIVO          métricas por ciclo (solo con un equipo)\n"
+            "  --json ARCHIVO         resumen para tools/perf_budget.py\n",
+            program);
+}
+
+static bool parseArgs(int argc, char** argv, Sim::Scenario& sc) {
+    Sim::defaultScenario(sc);
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool used = true;
+
+        if (strcmp(a, "--no-rtc") == 0) { sc.rtc_present = false; used = false; }
+        else if (strcmp(a, "--rtc-unset") == 0) { sc.rtc_unset = true; used = false; }
+        else if (!v) { usage(argv[0]); return false; }
+        else if (strcmp(a, "--days") == 0) sc.days = atof(v);
+        else if (strcmp(a, "--cycles") == 0) sc.cycles = strtoul(v, nullptr, 10);
+        else if (strcmp(a, "--epoch") == 0) sc.epoch = (uint32_t)strtoul(v, nullptr, 10);
+        else if (strcmp(a, "--seed") == 0) sc.seed = (uint32_t)strtoul(v, nullptr, 10);
+        else if (strcmp(a, "--devices") == 0) sc.devices = (unsigned)atoi(v);
+        else if (strcmp(a, "--jobs") == 0) sc.jobs = (unsigned)atoi(v);
+        else if (strcmp(a, "--outages-per-day") == 0) sc.outages_per_day = atof(v);
+        else if (strcmp(a, "--outage-mean-h") == 0) sc.outage_mean_h = atof(v);
+        else if (strcmp(a, "--brownouts-per-day") == 0) sc.brownouts_per_day = atof(v);
+        else if (strcmp(a, "--brownout-off") == 0) sc.brownout_off_s = atof(v);
+        else if (strcmp(a, "--request-prob") == 0) sc.request_probability = (float)atof(v);
+        else if (strcmp(a, "--rtc-ppm") == 0) sc.rtc_ppm = atof(v);
+        else if (strcmp(a, "--rtc-ppm-spread") == 0) sc.rtc_ppm_spread = atof(v);
+        else if (strcmp(a, "--i-active") == 0) sc.i_active_ma = atof(v);
+        else if (strcmp(a, "--i-radio") == 0) sc.i_radio_ma = atof(v);
+        else if (strcmp(a, "--i-sleep") == 0) sc.i_sleep_ua = atof(v);
+        else if (strcmp(a, "--battery") == 0) sc.battery_mah = atof(v);
+        else if (strcmp(a, "--csv") == 0) sc.csv_path = v;
+        else if (strcmp(a, "--json") == 0) sc.json_path = v;
+        else if (strcmp(a, "--outage") == 0) {
+            if (sc.outage_count >= SIM_MAX_WINDOWS || !parseWindow(v, sc.outages[sc.outage_count++])) {
+                fprintf(stderr, "Ventana inválida: %s\n", v);
+                return false;
+            }
+        } else if (strcmp(a, "--fault") == 0) {
+            if (sc.fault_count >= SIM_MAX_WINDOWS || !parseFault(v, sc.faults[sc.fault_count++])) {
+                fprintf(stderr, "Falla inválida: %s\n", v);
+                return false;
+            }
+        } else if (strcmp(a, "--excursion") == 0) {
+            if (sc.excursion_count >= SIM_MAX_WINDOWS || !parseFault(v, sc.excursions[sc.excursion_count++])) {
+                fprintf(stderr, "Excursión inválida: %s\n", v);
+                return false;
+            }
+        } else {
+            usage(argv[0]);
+            return false;
+        }
+        if (used) i++;
+    }
+
+    if (sc.devices < 1 || sc.devices > SIM_MAX_DEVICES || sc.jobs < 1 || sc.outage_mean_h <= 0) {
+        usage(argv[0]);
+        return false;
+    }
+    if (sc.csv_path && sc.devices > 1) {
+        fprintf(stderr, "--csv solo con un equipo\n");
+        return false;
+    }
+    return true;
+}
+
+// ——— Punto de entrada ———
+
+int main(int argc, char** argv) {
+    Sim::Scenario sc;
+    if (!parseArgs(argc, argv, sc)) return 2;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    Sim::Metrics total;
+    memset(&total, 0, sizeof(total));
+    bool ok = true;
+
+    if (sc.devices == 1) {
+        ok = Sim::simulateDevice(sc, 0, total);
+    } else {
+        // Un proceso por equipo: cada uno con su propio estado de HAL; métricas por pipe
+        unsigned next = 0, running = 0;
+        std::vector<int> pipes(sc.devices, -1);
+        std::vector<pid_t> pids(sc.devices, -1);
+
+        while (next < sc.devices || running > 0) {
+            while (next < sc.devices && running < sc.jobs) {
+                int fds[2];
+                if (pipe(fds) != 0) return 1;
+                fflush(stdout);
+                pid_t pid = fork();
+                if (pid == 0) {
+                    close(fds[0]);
+                    Sim::Metrics m;
+                    bool deviceOk = Sim::simulateDevice(sc, next, m);
+                    ssize_t written = write(fds[1], &m, sizeof(m));
+                    _exit((deviceOk && written == (ssize_t)sizeof(m)) ? 0 : 1);
+                }
+                close(fds[1]);
+                pipes[next] = fds[0];
+                pids[next] = pid;
+                next++;
+                running++;
+            }
+
+            int status = 0;
+            pid_t done = wait(&status);
+            if (done < 0) break;
+            for (unsigned d = 0; d < sc.devices; d++) {
+                if (pids[d] != done) continue;
+                Sim::Metrics m;
+                if (read(pipes[d], &m, sizeof(m)) == (ssize_t)sizeof(m)) {
+                    Sim::add(total, m);
+                } else {
+                    ok = false;
+                }
+                if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = false;
+                close(pipes[d]);
+                pids[d] = -1;
+                running--;
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double real = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    report(sc, total, sc.devices, real);
+    if (sc.json_path && !writeJson(sc.json_path, total, sc.devices)) ok = false;
+    return ok ? 0 : 1;
+}
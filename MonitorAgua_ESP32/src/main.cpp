@@ -31,8 +31,16 @@
 #include "Turbidez.h"
 #include "WifiManager.h"
 #include "RTC.h"
+#include "TimeKeeper.h"
 #include "pH.h"
 #include "CalibrationManager.h"
+#include "Logger.h"
+#include "Trace.h"
+#include "SensorBreaker.h"
+#include "DeltaReport.h"
+#include "AnomalyDetector.h"
+
+static const char TAG[] = "MAIN"; ///< Etiqueta de log del programa principal
 
 // ——— Configuración del Sistema ———
 
@@ -54,6 +62,15 @@
  */
 #define ACTIVE_TIME_SECONDS 40
 
+/**
+ * @def ALERT_SLEEP_SECONDS
+ * @brief Sueño entre ciclos mientras algún sensor está en alarma de anomalía
+ * @details Para seguir la excursión de cerca (ver AnomalyDetector.h) se duerme este
+ *          tiempo desde el fin del ciclo, sin alinear a múltiplos de
+ *          SLEEP_INTERVAL_SECONDS: ~60 s por ciclo en lugar de 80 s.
+ */
+#define ALERT_SLEEP_SECONDS 10
+
 /**
  * @def WIFI_CHECK_INTERVAL
  * @brief Número de ciclos de medición entre verificaciones WiFi
@@ -72,6 +89,17 @@
  */
 #define MANUAL_WAIT_TIMEOUT 60000
 
+/**
+ * @def DELTA_REPORTING
+ * @brief Modo de reporte por banda muerta: 1 = almacenar solo lecturas con cambios
+ * @details Ver DeltaReport.h y DELTA_CONFIG. Con agua estable reduce lecturas
+ *          almacenadas, conexiones WiFi y bytes enviados. Se puede activar desde
+ *          build_flags con -D DELTA_REPORTING=1.
+ */
+#ifndef DELTA_REPORTING
+#define DELTA_REPORTING 0
+#endif
+
 // ---Intervalos de muestreo para cada sensor (en milisegundos)---
 
 /**
@@ -153,6 +181,19 @@
  */
 #define RTC_SCL_PIN 9
 
+/**
+ * @def RTC_INT_PIN
+ * @brief GPIO RTC conectado a INT/SQW del MAX31328 (colector abierto, activo en bajo)
+ * @note Despierta por ext1; ext0 queda reservado al botón.
+ */
+#define RTC_INT_PIN 10
+
+/**
+ * @def RTC_ALARM_MIN_SLEEP_S
+ * @brief Sueño mínimo hasta la alarma; si el próximo instante está más cerca se salta al siguiente
+ */
+#define RTC_ALARM_MIN_SLEEP_S 10
+
 // ——— Configuración WiFi ———
 const WiFiManager::wifi_config_t WIFI_CONFIG = {
     .ssid = "RED_MONITOREO",        ///< SSID de la red WiFi
@@ -163,6 +204,24 @@ const WiFiManager::wifi_config_t WIFI_CONFIG = {
     .websocket_timeout_ms = 10000,  ///< Timeout conexión WebSocket (10 segundos)
     .max_retry_attempts = 3};       ///< Intentos de reconexión (no usado actualmente)
 
+// ——— Configuración del reporte por banda muerta ———
+const DeltaReport::config_t DELTA_CONFIG = {
+    .enabled = DELTA_REPORTING,     ///< Ver DELTA_REPORTING
+    .temperature = 0.2f,            ///< °C (resolución DS18B20: 0.0625 °C)
+    .ph = 0.05f,                    ///< Unidades de pH
+    .turbidity = 2.0f,              ///< NTU
+    .tds = 10.0f,                   ///< ppm
+    .max_silent_cycles = 15,        ///< Al menos una lectura cada 20 min con ciclos de 80 s
+    .cycle_seconds = SLEEP_INTERVAL_SECONDS};
+
+// ——— Umbrales fijos de anomalía (orden SensorBreaker::Sensor) ———
+// {min, max, σ mínima, tendencia máxima por hora}
+const AnomalyDetector::limits_t ANOMALY_LIMITS[SensorBreaker::SENSOR_COUNT] = {
+    {0.0f, 35.0f, 0.1f, 1.5f},     ///< Temperatura °C (σ mínima ≈ resolución del DS18B20)
+    {NAN, 1000.0f, 5.0f, 50.0f},   ///< TDS ppm
+    {NAN, 100.0f, 1.0f, 20.0f},    ///< Turbidez NTU
+    {6.0f, 9.5f, 0.05f, 0.2f}};    ///< pH
+
 // ——— Instancias globales ———
 
 /**
@@ -199,6 +258,20 @@ WiFiManager wifiManager(true);
  * @note Proporciona timestamps Unix precisos y sincronización NTP.
  */
 MAX31328RTC rtcExterno;
+
+/**
+ * @var timeKeeper
+ * @brief Base de tiempo sobre el temporizador RTC interno
+ * @note El RTC externo solo se lee cuando timeKeeper.needsDiscipline() lo pide.
+ */
+TimeKeeper timeKeeper;
+
+/**
+ * @var rtcDrift
+ * @brief Estimador de deriva del MAX31328 (aging offset persistido en NVS)
+ * @note Decide cuándo hace falta una referencia NTP y corrige la deriva residual.
+ */
+RTCDriftEstimator rtcDrift;
 /**
  * @var calibManager
  * @brief Instancia global del gestor de calibración de sensores
@@ -270,6 +343,28 @@ TurbidityReading turbidityReading;
  */
 pHReading phReading;
 
+/**
+ * @brief Próximo instante de muestreo en la grilla de SLEEP_INTERVAL_SECONDS.
+ * @details Con alarmas activas el ciclo corto (ALERT_SLEEP_SECONDS) no sigue la grilla.
+ *          Si el instante queda a menos de RTC_ALARM_MIN_SLEEP_S se salta al siguiente.
+ * @param now Hora Unix actual (RTC externo o TimeKeeper)
+ * @param alarmsActive Hay alarmas de calidad sin aceptar
+ * @return Hora Unix del próximo despertar
+ */
+static uint32_t nextSampleInstant(uint32_t now, bool alarmsActive)
+{
+    if (alarmsActive)
+    {
+        return now + (ALERT_SLEEP_SECONDS > RTC_ALARM_MIN_SLEEP_S ? ALERT_SLEEP_SECONDS : RTC_ALARM_MIN_SLEEP_S);
+    }
+    uint32_t next = (now / SLEEP_INTERVAL_SECONDS + 1) * SLEEP_INTERVAL_SECONDS;
+    if (next - now < RTC_ALARM_MIN_SLEEP_S)
+    {
+        next += SLEEP_INTERVAL_SECONDS;
+    }
+    return next;
+}
+
 /**
  * @brief Función setup() - Punto de entrada del programa después de boot/wake
  * @details Secuencia completa de inicialización y operación:
@@ -278,7 +373,7 @@ pHReading phReading;
  *          3. Valida integridad de RTC Memory
  *          4. Inicializa RTC externo MAX31328
  *          5. Realiza health check del sistema
- *          6. Inicializa todos los sensores (temperatura, TDS, turbidez, pH)
+ *          6. Inicializa los sensores cuyo interruptor (SensorBreaker) está cerrado
  *          7. Loop de medición no bloqueante durante ACTIVE_TIME_SECONDS
  *          8. Obtiene timestamp del RTC externo
  *          9. Almacena lecturas en RTC Memory
@@ -294,10 +389,10 @@ pHReading phReading;
 void setup()
 {
     Serial.begin(115200);
-    delay(100);
+    Logger::begin();
 
-    Serial.println("\n=== SISTEMA DE MONITOREO DE CALIDAD DEL AGUA ===");
-    Serial.println("================================================\n");
+    LOG_I(TAG, "\n=== SISTEMA DE MONITOREO DE CALIDAD DEL AGUA ===");
+    LOG_I(TAG, "================================================\n");
 
     pinMode(led, OUTPUT);
     digitalWrite(led, HIGH);
@@ -311,7 +406,8 @@ void setup()
 
     // ——— 2. VERIFICAR/INICIALIZAR RTC MEMORY ———
     rtcMemory.begin();
-    if (!rtcMemory.validateIntegrity())
+    bool rtcReset = !rtcMemory.validateIntegrity();
+    if (rtcReset)
     {
         // Serial.println(" Datos RTC Memory corruptos - Inicializando");
         rtcMemory.initialize();
@@ -320,47 +416,67 @@ void setup()
     }
     else
     {
-        Serial.println(" Datos RTC Memory válidos");
+        LOG_I(TAG, " Datos RTC Memory válidos");
 
         // Mostrar información del sistema
         deepSleep.begin();
         deepSleep.printWakeupReason();
+        if (deepSleep.isAlarmWakeup(RTC_INT_PIN))
+        {
+            LOG_I(TAG, " Despertar por alarma del RTC externo");
+        }
         watchdog.displaySystemHealth();
 
         if (watchdog.getHealthScore() < 20)
         {
-            Serial.println("Salud muy baja - Intentando recovery");
+            LOG_W(TAG, "Salud muy baja - Intentando recovery");
             watchdog.attemptRecovery();
         }
     }
 
+    DeltaReport::begin(DELTA_CONFIG, rtcReset);
+    AnomalyDetector::begin(ANOMALY_LIMITS, SLEEP_INTERVAL_SECONDS, rtcReset);
     watchdog.feedWatchdog();
 
-    // ——— 3. INICIALIZAR RTC EXTERNO MAX31328 ———
-    Serial.println("\n === INICIALIZANDO RTC MAX31328 ===");
+    // ——— 3. BASE DE TIEMPO / RTC EXTERNO MAX31328 ———
+    // La hora la mantiene el temporizador interno; el MAX31328 solo se lee para disciplinarlo
+    timeKeeper.begin();
+    timeKeeper.setDriftEstimator(&rtcDrift); // Lecturas del MAX31328 corregidas por deriva residual
     bool rtcAvailable = false;
 
-    // Serial.printf("Inicializando MAX31328 (SDA=%d, SCL=%d)...\n", RTC_SDA_PIN, RTC_SCL_PIN);
-
-    if (!rtcExterno.begin(RTC_SDA_PIN, RTC_SCL_PIN))
+    if (!timeKeeper.needsDiscipline() && !deepSleep.isFirstBoot())
     {
-        Serial.println(" Error inicializando RTC MAX31328");
-
-        watchdog.logError(WatchdogManager::ERROR_SENSOR_INIT_FAIL,
-                            WatchdogManager::SEVERITY_WARNING, 0x31328);
+        LOG_I(TAG, " Hora interna válida (±%u ms) - RTC externo no requerido",
+                    timeKeeper.getEstimatedErrorMs());
     }
     else
     {
-        Serial.println(" RTC MAX31328 inicializado correctamente");
-        rtcAvailable = true;
+        LOG_I(TAG, "\n === INICIALIZANDO RTC MAX31328 ===");
+
+        // Serial.printf("Inicializando MAX31328 (SDA=%d, SCL=%d)...\n", RTC_SDA_PIN, RTC_SCL_PIN);
 
-        rtcExterno.printDebugInfo();
-        if (deepSleep.isFirstBoot() || rtcExterno.hasLostTime())
+        if (!rtcExterno.begin(RTC_SDA_PIN, RTC_SCL_PIN))
         {
-            Serial.println(" RTC necesita sincronización");
+            LOG_E(TAG, " Error inicializando RTC MAX31328");
+
+            watchdog.logError(WatchdogManager::ERROR_SENSOR_INIT_FAIL,
+                                WatchdogManager::SEVERITY_WARNING, 0x31328);
         }
+        else
+        {
+            LOG_I(TAG, " RTC MAX31328 inicializado correctamente");
+            rtcAvailable = true;
 
-        watchdog.recordSuccess();
+            rtcExterno.printDebugInfo();
+            if (deepSleep.isFirstBoot() || rtcExterno.hasLostTime())
+            {
+                LOG_W(TAG, " RTC necesita sincronización");
+            }
+
+            rtcDrift.begin(rtcExterno);
+            timeKeeper.discipline(rtcExterno);
+            watchdog.recordSuccess();
+        }
     }
 
     watchdog.feedWatchdog();
@@ -369,7 +485,7 @@ void setup()
     bool health_ok = watchdog.performHealthCheck();
     if (!health_ok && watchdog.getConsecutiveFailures() >= 5)
     {
-        Serial.println(" Sistema en falla crítica");
+        LOG_E(TAG, " Sistema en falla crítica");
         watchdog.attemptRecovery();
     }
 
@@ -381,20 +497,28 @@ void setup()
                             context);
     };
 
+    // ——— 5.5. INTERRUPTORES DE SENSORES ———
+    // Un sensor con el interruptor abierto no se inicializa ni se muestrea este ciclo
+    SensorBreaker::beginCycle(rtcReset);
+
     // ——— 6. INICIALIZAR SENSOR DE TEMPERATURA ———
     // Serial.println("\n Inicializando sensor de temperatura...");
     TemperatureSensor::setErrorLogger(errorLogger);
 
-    if (!TemperatureSensor::initialize(TEMPERATURE_PIN))
+    if (!SensorBreaker::isActive(SensorBreaker::SENSOR_TEMPERATURE))
     {
-        Serial.println(" Error inicializando sensor temperatura");
+        LOG_W(TAG, " Sensor temperatura omitido por el interruptor");
+    }
+    else if (!TemperatureSensor::initialize(TEMPERATURE_PIN))
+    {
+        LOG_E(TAG, " Error inicializando sensor temperatura");
         watchdog.logError(WatchdogManager::ERROR_SENSOR_INIT_FAIL,
                             WatchdogManager::SEVERITY_CRITICAL, TEMPERATURE_PIN);
         watchdog.recordFailure();
     }
     else
     {
-        Serial.println(" Sensor temperatura inicializado");
+        LOG_I(TAG, " Sensor temperatura inicializado");
         watchdog.recordSuccess();
     }
 
@@ -404,16 +528,20 @@ void setup()
     // Serial.println("\n Inicializando sensor TDS...");
     TDSSensor::setErrorLogger(errorLogger);
 
-    if (!TDSSensor::initialize(TDS_PIN))
+    if (!SensorBreaker::isActive(SensorBreaker::SENSOR_TDS))
+    {
+        LOG_W(TAG, " Sensor TDS omitido por el interruptor");
+    }
+    else if (!TDSSensor::initialize(TDS_PIN))
     {
-        Serial.println(" Error inicializando sensor TDS");
+        LOG_E(TAG, " Error inicializando sensor TDS");
         watchdog.logError(WatchdogManager::ERROR_SENSOR_INIT_FAIL,
                             WatchdogManager::SEVERITY_CRITICAL, TDS_PIN);
         watchdog.recordFailure();
     }
     else
     {
-        Serial.println(" Sensor TDS inicializado");
+        LOG_I(TAG, " Sensor TDS inicializado");
 
         float kValue, vOffset;
         TDSSensor::getCalibration(kValue, vOffset);
@@ -427,16 +555,20 @@ void setup()
     // Serial.println("\n Inicializando sensor de turbidez...");
     TurbiditySensor::setErrorLogger(errorLogger);
 
-    if (!TurbiditySensor::initialize(TURBIDITY_PIN))
+    if (!SensorBreaker::isActive(SensorBreaker::SENSOR_TURBIDITY))
     {
-        Serial.println(" Error inicializando sensor turbidez");
+        LOG_W(TAG, " Sensor turbidez omitido por el interruptor");
+    }
+    else if (!TurbiditySensor::initialize(TURBIDITY_PIN))
+    {
+        LOG_E(TAG, " Error inicializando sensor turbidez");
         watchdog.logError(WatchdogManager::ERROR_SENSOR_INIT_FAIL,
                             WatchdogManager::SEVERITY_CRITICAL, TURBIDITY_PIN);
         watchdog.recordFailure();
     }
     else
     {
-        Serial.println(" Sensor turbidez inicializado");
+        LOG_I(TAG, " Sensor turbidez inicializado");
         watchdog.recordSuccess();
     }
 
@@ -446,16 +578,20 @@ void setup()
     // Serial.println("\n Inicializando sensor pH...");
     pHSensor::setErrorLogger(errorLogger);
 
-    if (!pHSensor::initialize(PH_PIN))
+    if (!SensorBreaker::isActive(SensorBreaker::SENSOR_PH))
     {
-        Serial.println(" Error inicializando sensor pH");
+        LOG_W(TAG, " Sensor pH omitido por el interruptor");
+    }
+    else if (!pHSensor::initialize(PH_PIN))
+    {
+        LOG_E(TAG, " Error inicializando sensor pH");
         watchdog.logError(WatchdogManager::ERROR_SENSOR_INIT_FAIL,
                             WatchdogManager::SEVERITY_CRITICAL, PH_PIN);
         watchdog.recordFailure();
     }
     else
     {
-        Serial.println(" Sensor pH inicializado");
+        LOG_I(TAG, " Sensor pH inicializado");
 
         float phOffset, phSlope;
         pHSensor::getCalibration(phOffset, phSlope);
@@ -466,21 +602,24 @@ void setup()
     watchdog.feedWatchdog();
 
     // ——— 10. TOMAR LECTURAS DE SENSORES ———
-    Serial.println("\n === TOMANDO LECTURAS DE SENSORES ===");
+    LOG_I(TAG, "\n === TOMANDO LECTURAS DE SENSORES ===");
+    HAL::Trace::start(rtcMemory.getTotalReadings() + 1); // Muestras crudas del ciclo (solo con -D HAL_TRACE)
 
     unsigned long startActive = millis(); // >>> Esta es la línea que se añadió
+    bool tempOk = false, tdsOk = false, turbidityOk = false, phOk = false; // Alguna lectura válida en el ciclo
 
     while ((millis() - startActive) < (ACTIVE_TIME_SECONDS * 1000))
     {                                           // >>> Esta es la línea que se añadió
         unsigned long currentMillis = millis(); // >>> Esta es la línea que se añadió
 
     // Serial.println(" Leyendo temperatura...");
-        if (currentMillis - lastTempRead >= TEMP_INTERVAL)
+        if (SensorBreaker::isActive(SensorBreaker::SENSOR_TEMPERATURE) && currentMillis - lastTempRead >= TEMP_INTERVAL)
         {                                                              // >>> Esta es la línea que se añadió
             tempReading = TemperatureSensor::takeReadingWithTimeout(); // >>> Esta es la línea que se añadió
             if (tempReading.valid)
             {
-                Serial.printf("Temperatura: %.2f °C\n", tempReading.temperature); // >>> Esta es la línea que se añadió
+                tempOk = true;
+                LOG_I(TAG, "Temperatura: %.2f °C", tempReading.temperature); // >>> Esta es la línea que se añadió
             }
             lastTempRead = currentMillis; // >>> Esta es la línea que se añadió
         }
@@ -488,36 +627,39 @@ void setup()
     watchdog.feedWatchdog();
 
     // Serial.println(" Leyendo TDS...");
-        if (currentMillis - lastTDSRead >= TDS_INTERVAL)
+        if (SensorBreaker::isActive(SensorBreaker::SENSOR_TDS) && currentMillis - lastTDSRead >= TDS_INTERVAL)
         {                                                         // >>> Esta es la línea que se añadió
             tdsReading = TDSSensor::takeReadingWithTimeout(25.0); // >>> Esta es la línea que se añadió
             if (tdsReading.valid)
             {
-                Serial.printf("TDS: %.1f ppm | EC: %.1f µS/cm\n", tdsReading.tds_value, tdsReading.ec_value); // >>> Esta es la línea que se añadió
+                tdsOk = true;
+                LOG_I(TAG, "TDS: %.1f ppm | EC: %.1f µS/cm", tdsReading.tds_value, tdsReading.ec_value); // >>> Esta es la línea que se añadió
             }
             lastTDSRead = currentMillis; // >>> Esta es la línea que se añadió
         }
     watchdog.feedWatchdog();
 
     // Serial.println(" Leyendo turbidez...");
-        if (currentMillis - lastTurbidityRead >= TURBIDITY_INTERVAL)
+        if (SensorBreaker::isActive(SensorBreaker::SENSOR_TURBIDITY) && currentMillis - lastTurbidityRead >= TURBIDITY_INTERVAL)
         {                                                                 // >>> Esta es la línea que se añadió
             turbidityReading = TurbiditySensor::takeReadingWithTimeout(); // >>> Esta es la línea que se añadió
             if (turbidityReading.valid)
             {
-                Serial.printf("Turbidez: %.1f NTU\n", turbidityReading.turbidity_ntu); // >>> Esta es la línea que se añadió
+                turbidityOk = true;
+                LOG_I(TAG, "Turbidez: %.1f NTU", turbidityReading.turbidity_ntu); // >>> Esta es la línea que se añadió
             }
             lastTurbidityRead = currentMillis; // >>> Esta es la línea que se añadió
         }
     watchdog.feedWatchdog();
 
     // Serial.println(" Leyendo pH...");
-        if (currentMillis - lastPHRead >= PH_INTERVAL)
+        if (SensorBreaker::isActive(SensorBreaker::SENSOR_PH) && currentMillis - lastPHRead >= PH_INTERVAL)
         {                                                       // >>> Esta es la línea que se añadió
             phReading = pHSensor::takeReadingWithTimeout(25.0); // >>> Esta es la línea que se añadió
             if (phReading.valid)
             {
-                Serial.printf("pH: %.2f\n", phReading.ph_value); // >>> Esta es la línea que se añadió
+                phOk = true;
+                LOG_I(TAG, "pH: %.2f", phReading.ph_value); // >>> Esta es la línea que se añadió
             }
             lastPHRead = currentMillis; // >>> Esta es la línea que se añadió
         }
@@ -526,33 +668,66 @@ void setup()
     }
     watchdog.feedWatchdog();
 
-    // ——— 11. OBTENER TIMESTAMP DEL RTC MAX31328 ———
+    // Resultado del ciclo por sensor: sin ninguna lectura válida cuenta como falla
+    const struct { SensorBreaker::Sensor sensor; bool ok; uint8_t pin; } cycleResults[] = {
+        {SensorBreaker::SENSOR_TEMPERATURE, tempOk, TEMPERATURE_PIN},
+        {SensorBreaker::SENSOR_TDS, tdsOk, TDS_PIN},
+        {SensorBreaker::SENSOR_TURBIDITY, turbidityOk, TURBIDITY_PIN},
+        {SensorBreaker::SENSOR_PH, phOk, PH_PIN}};
+    for (const auto &r : cycleResults)
+    {
+        if (SensorBreaker::recordResult(r.sensor, r.ok))
+        {
+            watchdog.logError(WatchdogManager::ERROR_SENSOR_INVALID_READING,
+                                WatchdogManager::SEVERITY_WARNING, r.pin);
+        }
+    }
+
+    // Detectores de anomalías con el último valor válido de cada sensor
+    AnomalyDetector::update(SensorBreaker::SENSOR_TEMPERATURE, tempReading.temperature, tempReading.valid);
+    AnomalyDetector::update(SensorBreaker::SENSOR_TDS, tdsReading.tds_value, tdsReading.valid);
+    AnomalyDetector::update(SensorBreaker::SENSOR_TURBIDITY, turbidityReading.turbidity_ntu, turbidityReading.valid);
+    AnomalyDetector::update(SensorBreaker::SENSOR_PH, phReading.ph_value, phReading.valid);
+    bool alarmsActive = AnomalyDetector::followMask() != 0; // Alarmas aún no aceptadas: ciclo corto
+
+    // ——— 11. OBTENER TIMESTAMP (BASE DE TIEMPO INTERNA / RTC MAX31328) ———
     uint32_t rtcTimestamp = 0;
-    String rtcDateTime = "No disponible";
+    char rtcDateTime[RTC_DATETIME_LEN] = "No disponible";
 
-    if (rtcAvailable && rtcExterno.isPresent())
+    if (timeKeeper.isValid())
+    {
+        rtcTimestamp = timeKeeper.now(); // Sin transacción I2C
+        timeKeeper.getFormattedDateTime(rtcDateTime, sizeof(rtcDateTime));
+        LOG_I(TAG, " Timestamp: %u (%s, ±%u ms)", rtcTimestamp, rtcDateTime,
+                    timeKeeper.getEstimatedErrorMs());
+    }
+    else if (rtcAvailable && rtcExterno.isPresent())
     {
         rtcTimestamp = rtcExterno.getUnixTimestamp();
-        rtcDateTime = rtcExterno.getFormattedDateTime();
+        rtcExterno.getFormattedDateTime(rtcDateTime, sizeof(rtcDateTime));
 
         if (rtcTimestamp < 1609459200)
         {
-            Serial.println(" Timestamp RTC inválido - usando tiempo relativo");
+            LOG_W(TAG, " Timestamp RTC inválido - usando tiempo relativo");
             rtcTimestamp = millis() / 1000; // Segundos desde boot
         }
         else
         {
-            Serial.printf(" Timestamp RTC: %u (%s)\n", rtcTimestamp, rtcDateTime.c_str());
+            LOG_I(TAG, " Timestamp RTC: %u (%s)", rtcTimestamp, rtcDateTime);
         }
     }
     else
     {
-        Serial.println(" RTC no disponible - usando timestamp relativo");
+        LOG_W(TAG, " RTC no disponible - usando timestamp relativo");
         rtcTimestamp = millis() / 1000;
     }
 
+    HAL::Trace::stop();
+
     // ——— 12. ALMACENAR EN RTC MEMORY ———
     bool readingStored = false;
+    bool readingSuppressed = false; // Omitida por la banda muerta (DELTA_REPORTING)
+    bool alertPending = false;      // Alarma nueva: enviar alerta aunque no toque WiFi
 
     if (tempReading.valid || tdsReading.valid || turbidityReading.valid || phReading.valid)
     {
@@ -563,50 +738,64 @@ void setup()
             turbidityReading.valid ? turbidityReading.turbidity_ntu : 0.0f,
             tdsReading.valid ? tdsReading.tds_value : 0.0f,
             tdsReading.valid ? tdsReading.ec_value : 0.0f,
-            (tempReading.sensor_status << 0) |
+            SensorBreaker::markSkipped(
+                (tempReading.sensor_status << 0) |
                 (tdsReading.sensor_status << 2) |
                 (turbidityReading.sensor_status << 4) |
-                (phReading.sensor_status << 6));
+                (phReading.sensor_status << 6)));
 
         reading.rtc_timestamp = rtcTimestamp;
 
         reading.valid = (tempReading.valid || tdsReading.valid || turbidityReading.valid || phReading.valid);
+        reading.alarms = AnomalyDetector::cycleMask();
+
+        if (AnomalyDetector::newAlarms())
+        {
+            wifiManager.queueAlert(reading);
+            alertPending = true;
+        }
 
-        if (rtcMemory.storeReading(reading))
+        if (!DeltaReport::shouldStore(reading, rtcMemory))
+        {
+            // Sin cambios significativos: el servidor mantiene el valor anterior
+            readingSuppressed = true;
+            watchdog.recordSuccess();
+        }
+        else if (rtcMemory.storeReading(reading))
         {
-            Serial.println("\n === LECTURA ALMACENADA ===");
-            Serial.printf(" Lectura #%d guardada exitosamente\n", rtcMemory.getTotalReadings());
-            Serial.printf(" Timestamp: %s (Unix: %u)\n", rtcDateTime.c_str(), rtcTimestamp);
+            LOG_I(TAG, "\n === LECTURA ALMACENADA ===");
+            LOG_I(TAG, " Lectura #%d guardada exitosamente", rtcMemory.getTotalReadings());
+            LOG_I(TAG, " Timestamp: %s (Unix: %u)", rtcDateTime, rtcTimestamp);
 
             if (tempReading.valid)
             {
-                Serial.printf(" Temperatura: %.2f°C\n", tempReading.temperature);
+                LOG_I(TAG, " Temperatura: %.2f°C", tempReading.temperature);
             }
             if (tdsReading.valid)
             {
-                Serial.printf(" TDS: %.1f ppm (EC: %.1f µS/cm)\n",
+                LOG_I(TAG, " TDS: %.1f ppm (EC: %.1f µS/cm)",
                                 tdsReading.tds_value, tdsReading.ec_value);
             }
             if (turbidityReading.valid)
             {
-                Serial.printf(" Turbidez: %.1f NTU (%s)\n",
+                LOG_I(TAG, " Turbidez: %.1f NTU (%s)",
                                 turbidityReading.turbidity_ntu,
-                                TurbiditySensor::getWaterQuality(turbidityReading.turbidity_ntu).c_str());
+                                TurbiditySensor::getWaterQuality(turbidityReading.turbidity_ntu));
             }
             if (phReading.valid)
             {
-                Serial.printf(" pH: %.2f (%s)\n",
+                LOG_I(TAG, " pH: %.2f (%s)",
                                 phReading.ph_value,
-                                pHSensor::getWaterType(phReading.ph_value).c_str());
+                                pHSensor::getWaterType(phReading.ph_value));
             }
-            Serial.println("==========================");
+            LOG_I(TAG, "==========================");
 
             watchdog.recordSuccess();
             readingStored = true;
         }
         else
         {
-            Serial.println(" Error almacenando lecturas");
+            LOG_E(TAG, " Error almacenando lecturas");
             watchdog.logError(WatchdogManager::ERROR_RTC_WRITE_FAIL,
                                 WatchdogManager::SEVERITY_CRITICAL, 0);
             watchdog.recordFailure();
@@ -614,27 +803,28 @@ void setup()
     }
     else
     {
-        Serial.println(" Todas las lecturas inválidas - no se almacena");
+        LOG_W(TAG, " Todas las lecturas inválidas - no se almacena");
         watchdog.recordFailure();
     }
 
     // ——— 13. VERIFICAR SI ES MOMENTO DE CONECTAR WIFI ———
-    bool shouldCheckWiFi = (rtcMemory.getTotalReadings() % WIFI_CHECK_INTERVAL == 0) && (rtcMemory.getTotalReadings() > 0);
+    bool shouldCheckWiFi = !readingSuppressed && (rtcMemory.getTotalReadings() % WIFI_CHECK_INTERVAL == 0) && (rtcMemory.getTotalReadings() > 0);
 
     if (deepSleep.getWakeupCause() == ESP_SLEEP_WAKEUP_EXT0)
     {
-        Serial.println(" Despertar por botón - Forzando verificación WiFi");
+        LOG_I(TAG, " Despertar por botón - Forzando verificación WiFi");
         forceManualCheck = true;
     }
 
     if (shouldCheckWiFi || forceManualCheck)
     {
-        Serial.println("\n === VERIFICACIÓN WIFI PROGRAMADA ===");
-        Serial.printf(" Datos almacenados: %d lecturas\n", rtcMemory.getTotalReadings());
+        LOG_I(TAG, "\n === VERIFICACIÓN WIFI PROGRAMADA ===");
+        LOG_I(TAG, " Datos almacenados: %d lecturas", rtcMemory.getTotalReadings());
         // Serial.println(" Conectando para verificar si hay solicitud de descarga...");
 
         wifiManager.begin(WIFI_CONFIG);
         wifiManager.setManagers(&rtcMemory, &watchdog);
+        wifiManager.setCalibrationManager(&calibManager); // Atiende comandos de calibración del servidor
         wifiManager.setManualMode(true);
 
         wifiManager.setErrorCallback([](WatchdogManager::error_code_t code,
@@ -648,58 +838,82 @@ void setup()
 
         if (wifiSuccess)
         {
-            Serial.println(" Proceso WiFi completado");
+            LOG_I(TAG, " Proceso WiFi completado");
+
+            // Referencia NTP: si el RTC perdió la hora o la deriva acumulada estimada lo exige
+            bool ntpDue = deepSleep.isFirstBoot() || !timeKeeper.isValid() ||
+                          rtcDrift.isSyncDue(timeKeeper.now());
+            if (ntpDue && !rtcAvailable && wifiManager.isWiFiConnected())
+            {
+                rtcAvailable = rtcExterno.begin(RTC_SDA_PIN, RTC_SCL_PIN);
+            }
 
             if (rtcAvailable && wifiManager.isWiFiConnected())
             {
-                if (rtcExterno.hasLostTime() || deepSleep.isFirstBoot())
+                if (ntpDue || rtcExterno.hasLostTime())
                 {
-                    Serial.println("\n Sincronizando RTC con servidor NTP...");
-                    if (rtcExterno.syncWithNTP("co.pool.ntp.org", -5))
+                    LOG_I(TAG, "\n Sincronizando RTC con servidor NTP...");
+                    if (rtcDrift.syncWithNTP(rtcExterno, "co.pool.ntp.org", -5))
                     {
-                        Serial.println(" RTC sincronizado correctamente con NTP");
-                        Serial.printf(" Nueva fecha/hora: %s\n", rtcExterno.getFormattedDateTime().c_str());
+                        LOG_I(TAG, " RTC sincronizado correctamente con NTP");
+                        timeKeeper.discipline(rtcExterno);
+                        rtcExterno.getFormattedDateTime(rtcDateTime, sizeof(rtcDateTime));
+                        LOG_I(TAG, " Nueva fecha/hora: %s", rtcDateTime);
                     }
                     else
                     {
-                        Serial.println(" No se pudo sincronizar RTC con NTP");
+                        LOG_W(TAG, " No se pudo sincronizar RTC con NTP");
                     }
                 }
             }
 
-            String stats = wifiManager.getTransmissionStats();
-            if (stats.indexOf("Datos enviados: 0") == -1)
+            if (wifiManager.getTotalDataSent() > 0)
             {
-                Serial.println(" Datos descargados exitosamente por el usuario");
+                LOG_I(TAG, " Datos descargados exitosamente por el usuario");
             }
             else
             {
-                Serial.println(" No hubo solicitud de descarga");
+                LOG_I(TAG, " No hubo solicitud de descarga");
             }
 
             watchdog.recordSuccess();
         }
         else
         {
-            Serial.println(" Falló conexión WiFi");
+            LOG_E(TAG, " Falló conexión WiFi");
             watchdog.logError(WatchdogManager::ERROR_WIFI_FAIL,
                                 WatchdogManager::SEVERITY_WARNING, 0);
             watchdog.recordFailure();
         }
 
         // Mostrar estadísticas
-        Serial.println(wifiManager.getTransmissionStats());
+        char stats[256];
+        wifiManager.getTransmissionStats(stats, sizeof(stats));
+        LOG_I(TAG, "%s", stats);
 
         watchdog.feedWatchdog();
         forceManualCheck = false;
     }
+    else if (alertPending)
+    {
+        // Alerta fuera de programa: solo el aviso, las lecturas esperan a la verificación programada
+        LOG_W(TAG, "\n === ALARMA DE ANOMALÍA - ENVIANDO ALERTA ===");
+        wifiManager.begin(WIFI_CONFIG);
+        wifiManager.setManagers(&rtcMemory, &watchdog);
+        if (!wifiManager.sendAlert())
+        {
+            watchdog.logError(WatchdogManager::ERROR_WIFI_FAIL,
+                                WatchdogManager::SEVERITY_WARNING, 0);
+        }
+        watchdog.feedWatchdog();
+    }
     else
     {
-        Serial.printf(" Lecturas: %d/%d (WiFi check en %d lecturas)\n",
+        LOG_I(TAG, " Lecturas: %d/%d (WiFi check en %d lecturas)",
                         rtcMemory.getTotalReadings() % WIFI_CHECK_INTERVAL,
                         WIFI_CHECK_INTERVAL,
                         WIFI_CHECK_INTERVAL - (rtcMemory.getTotalReadings() % WIFI_CHECK_INTERVAL));
-        Serial.println(" Sin verificación WiFi programada");
+        LOG_I(TAG, " Sin verificación WiFi programada");
     }
 
     // ——— 14. MOSTRAR DATOS Y ERRORES ———
@@ -709,7 +923,7 @@ void setup()
     // ——— 15. VERIFICAR EMERGENCIA ———
     if (watchdog.getConsecutiveFailures() >= 10)
     {
-        Serial.println(" DEMASIADOS FALLOS - MODO EMERGENCIA");
+        LOG_E(TAG, " DEMASIADOS FALLOS - MODO EMERGENCIA");
         watchdog.handleEmergency();
         deepSleep.goToSleepFor(300, true);
     }
@@ -717,96 +931,157 @@ void setup()
     watchdog.feedWatchdog();
 
     // ——— 16. RESUMEN FINAL ———
-    Serial.println("\n === RESUMEN DEL CICLO ===");
+    LOG_I(TAG, "\n === RESUMEN DEL CICLO ===");
 
-    Serial.println(" Lecturas de sensores:");
+    LOG_I(TAG, " Lecturas de sensores:");
     if (tempReading.valid)
     {
-        Serial.printf("    Temperatura: %.2f°C (VÁLIDA)\n", tempReading.temperature);
+        LOG_I(TAG, "    Temperatura: %.2f°C (VÁLIDA)", tempReading.temperature);
     }
     else
     {
-        Serial.println("    Temperatura: --- (INVÁLIDA)");
+        LOG_W(TAG, "    Temperatura: --- (INVÁLIDA)");
     }
 
     if (tdsReading.valid)
     {
-        Serial.printf("    TDS: %.1f ppm | EC: %.1f µS/cm (VÁLIDA)\n",
+        LOG_I(TAG, "    TDS: %.1f ppm | EC: %.1f µS/cm (VÁLIDA)",
                         tdsReading.tds_value, tdsReading.ec_value);
     }
     else
     {
-        Serial.println("    TDS: --- ppm (INVÁLIDA)");
+        LOG_W(TAG, "    TDS: --- ppm (INVÁLIDA)");
     }
 
     if (turbidityReading.valid)
     {
-        Serial.printf("    Turbidez: %.1f NTU | %s (VÁLIDA)\n",
+        LOG_I(TAG, "    Turbidez: %.1f NTU | %s (VÁLIDA)",
                         turbidityReading.turbidity_ntu,
-                        TurbiditySensor::getWaterQuality(turbidityReading.turbidity_ntu).c_str());
+                        TurbiditySensor::getWaterQuality(turbidityReading.turbidity_ntu));
     }
     else
     {
-        Serial.println("    Turbidez: --- NTU (INVÁLIDA)");
+        LOG_W(TAG, "    Turbidez: --- NTU (INVÁLIDA)");
     }
 
     if (phReading.valid)
     {
-        Serial.printf("    pH: %.2f | %s (VÁLIDA)\n",
+        LOG_I(TAG, "    pH: %.2f | %s (VÁLIDA)",
                         phReading.ph_value,
-                        pHSensor::getWaterType(phReading.ph_value).c_str());
+                        pHSensor::getWaterType(phReading.ph_value));
     }
     else
     {
-        Serial.println("    pH: -.-- (INVÁLIDA)");
+        LOG_W(TAG, "    pH: -.-- (INVÁLIDA)");
     }
 
-    Serial.println("\n === ESTADO RTC MAX31328 ===");
+    LOG_I(TAG, "\n === ESTADO RTC MAX31328 ===");
     if (rtcAvailable && rtcExterno.isPresent())
     {
-        Serial.printf("Hora actual: %s\n", rtcExterno.getFormattedDateTime().c_str());
-        Serial.printf("Unix timestamp: %u\n", rtcExterno.getUnixTimestamp());
-        Serial.printf("Funcionando: %s\n", rtcExterno.isRunning() ? "Sí" : "No");
+        char nowDateTime[RTC_DATETIME_LEN];
+        rtcExterno.getFormattedDateTime(nowDateTime, sizeof(nowDateTime));
+        LOG_I(TAG, "Hora actual: %s", nowDateTime);
+        LOG_I(TAG, "Unix timestamp: %u", rtcExterno.getUnixTimestamp());
+        LOG_I(TAG, "Funcionando: %s", rtcExterno.isRunning() ? "Sí" : "No");
 
         if (rtcExterno.hasLostTime())
         {
-            Serial.println(" RTC perdió la hora - Se sincronizará en próxima conexión WiFi");
+            LOG_I(TAG, " RTC perdió la hora - Se sincronizará en próxima conexión WiFi");
         }
     }
-    else
+    else if (!timeKeeper.isValid())
     {
-        Serial.println(" RTC no disponible - usando timestamps relativos");
+        LOG_W(TAG, " RTC no disponible - usando timestamps relativos");
     }
-    Serial.println("==========================");
 
-    Serial.printf("\n Total lecturas almacenadas: %d\n", rtcMemory.getTotalReadings());
-    Serial.printf(" Salud sistema: %d%%\n", watchdog.getHealthScore());
-    Serial.printf(" Fallos consecutivos: %d\n", watchdog.getConsecutiveFailures());
-    Serial.printf(" Próximo check WiFi en: %d lecturas\n",
+    char timeStatus[256];
+    timeKeeper.getStatus(timeStatus, sizeof(timeStatus));
+    LOG_I(TAG, "%s", timeStatus);
+    LOG_I(TAG, "==========================");
+
+    LOG_I(TAG, "\n Total lecturas almacenadas: %d", rtcMemory.getTotalReadings());
+    LOG_I(TAG, " Salud sistema: %d%%", watchdog.getHealthScore());
+    LOG_I(TAG, " Fallos consecutivos: %d", watchdog.getConsecutiveFailures());
+    LOG_I(TAG, " Próximo check WiFi en: %d lecturas",
                     WIFI_CHECK_INTERVAL - (rtcMemory.getTotalReadings() % WIFI_CHECK_INTERVAL));
 
     uint64_t totalCycle, activeTime, sleepTime;
     deepSleep.getCycleInfo(totalCycle, activeTime, sleepTime);
-    Serial.printf(" Duty Cycle: %.1f%% (%llu/%llu seg)\n",
+    LOG_I(TAG, " Duty Cycle: %.1f%% (%llu/%llu seg)",
                   (activeTime * 100.0) / totalCycle, activeTime, totalCycle);
+    if (Logger::getDroppedCount() > 0) {
+        LOG_W(TAG, " Logs descartados (buffer lleno): %u", (unsigned)Logger::getDroppedCount());
+    }
 
-    Serial.println("============================");
+    LOG_I(TAG, "============================");
 
     // ——— 17. ENTRAR EN DEEP SLEEP ———
-    Serial.printf("\n Entrando en Deep Sleep por %llu segundos\n",
+    // El instante de muestreo es la grilla de SLEEP_INTERVAL_SECONDS. La alarma del MAX31328
+    // solo se programa en los despertares que ya leyeron el RTC (disciplina, primer arranque,
+    // NTP): la alarma de fecha es de un solo disparo y reprogramarla en cada ciclo devolvería
+    // el acceso I2C que TimeKeeper evita. En los demás el temporizador interno apunta a la
+    // misma grilla con timeKeeper.now(): el instante se desvía hasta 1 s (resolución de now())
+    // más el error de TimeKeeper, acotado por TIMEKEEPER_MAX_ERROR_MS; pasada esa cota
+    // needsDiscipline() fuerza una lectura del RTC y la alarma vuelve a armarse
+
+    // Con alarmas sin aceptar el ciclo se acorta para seguir la excursión
+    if (alarmsActive)
+    {
+        LOG_W(TAG, " Alarmas activas (0x%02X) - próximo ciclo en %u s",
+                    AnomalyDetector::cycleMask(), (unsigned)ALERT_SLEEP_SECONDS);
+        deepSleep.setSleepInterval(ACTIVE_TIME_SECONDS + ALERT_SLEEP_SECONDS);
+    }
+
+    uint32_t alarmSeconds = 0;
+    if (rtcAvailable && rtcExterno.refresh() && !rtcExterno.hasLostTime())
+    {
+        uint32_t rtcNow = rtcExterno.getUnixTimestamp();
+        uint32_t nextWake = nextSampleInstant(rtcNow, alarmsActive);
+        if (rtcExterno.setAlarm(1, nextWake))
+        {
+            alarmSeconds = nextWake - rtcNow;
+        }
+        else
+        {
+            LOG_W(TAG, " No se pudo programar la alarma del RTC - se usa el temporizador interno");
+        }
+    }
+    else if (deepSleep.isAlarmWakeup(RTC_INT_PIN) && rtcExterno.begin(RTC_SDA_PIN, RTC_SCL_PIN))
+    {
+        // A1F mantiene INT en bajo (consumo por el pull-up) hasta limpiarla: solo tras su despertar
+        rtcExterno.disableAlarms();
+    }
+
+    if (alarmSeconds > 0)
+    {
+        LOG_I(TAG, "\n Entrando en Deep Sleep hasta alarma RTC en %u segundos", alarmSeconds);
+        LOG_I(TAG, "==========================================\n");
+        deepSleep.goToSleepUntilAlarm(RTC_INT_PIN, alarmSeconds, true);
+    }
+
+    if (timeKeeper.isValid())
+    {
+        uint32_t now = timeKeeper.now();
+        uint32_t sleepSeconds = nextSampleInstant(now, alarmsActive) - now;
+        LOG_I(TAG, "\n Entrando en Deep Sleep por %u segundos (grilla por hora interna, ±%u ms)",
+                    sleepSeconds, timeKeeper.getEstimatedErrorMs());
+        LOG_I(TAG, "==========================================\n");
+        deepSleep.goToSleepFor(sleepSeconds, true);
+    }
+
+    LOG_I(TAG, "\n Entrando en Deep Sleep por %llu segundos",
                     deepSleep.calculateSleepTime());
-    Serial.printf(" Próximo despertar en %.1f minutos\n",
+    LOG_I(TAG, " Próximo despertar en %.1f minutos",
                     deepSleep.calculateSleepTime() / 60.0);
-    Serial.println("==========================================\n");
+    LOG_I(TAG, "==========================================\n");
 
-    delay(500);
-    deepSleep.goToSleep(true);
+    deepSleep.goToSleep(true);  // Vacía el log con plazo acotado antes de dormir
 }
 
 void loop()
 {
     // No se ejecuta con Deep Sleep
-    Serial.println(" ERROR: No entró en Deep Sleep");
+    LOG_E(TAG, " ERROR: No entró en Deep Sleep");
     delay(5000);
     ESP.restart();
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+/**
+ * @file test_main.cpp
+ * @brief Presupuestos de rendimiento de perf_budgets.ini en el ESP32-S2.
+ * @details Mide cada caso de bench/FirmwareBenchmark.cpp con Benchmark::run() y
+ *          falla si las asignaciones por iteración pasan [bench.allocs] o los
+ *          ciclos pasan [bench.cycles]. Necesita que la HAL cuente asignaciones
+ *          (env:bench, -D HAL_COUNT_ALLOCATIONS): env:esp32-s2-kaluga-1 no la
+ *          corre (test_ignore). Un caso sin ningún límite se informa como ignorado.
+ *
+ *              pio test -e bench -f test_embedded/test_perf_budgets
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "HAL.h"
+#include "Benchmark.h"
+#include "PerfBudgets.h"
+#include "../../../bench/FirmwareBenchmark.h"
+
+static const char* currentCase;  ///< Caso que mide test_case_within_budget()
+
+void setUp() {}
+void tearDown() {}
+
+// ——— Casos ———
+
+void test_case_within_budget() {
+    double limitCycles = 0, limitAllocs = 0;
+    bool hasCycles = PerfBudgets::lookup(PerfBudgets::CYCLES, currentCase, limitCycles);
+    bool hasAllocs = PerfBudgets::lookup(PerfBudgets::ALLOCS, currentCase, limitAllocs);
+    if (!hasCycles && !hasAllocs) TEST_IGNORE_MESSAGE("Sin límite en perf_budgets.ini");
+
+    Benchmark::Result result;
+    Benchmark::run(Benchmark::find(currentCase), result);
+
+    char message[96];
+    if (hasCycles) {
+        snprintf(message, sizeof(message), "%.1f ciclos por iteración, límite %.0f",
+                 result.cycles, limitCycles);
+        TEST_ASSERT_TRUE_MESSAGE(result.cycles <= limitCycles, message);
+    }
+    if (hasAllocs) {
+        snprintf(message, sizeof(message), "%.3f asignaciones por iteración, límite %.3f",
+                 result.allocs, limitAllocs);
+        TEST_ASSERT_TRUE_MESSAGE(result.allocs <= limitAllocs, message);
+    }
+}
+
+// ——— Archivo de límites ———
+
+/**
+ * @brief Falla con el primer caso presupuestado que no está registrado
+ */
+static void checkRegistered(const PerfBudgets::Budget* table) {
+    for (; table->name; table++) {
+        TEST_ASSERT_NOT_NULL_MESSAGE(Benchmark::find(table->name), table->name);
+    }
+}
+
+void test_budgeted_cases_are_registered() {
+    checkRegistered(PerfBudgets::CYCLES);
+    checkRegistered(PerfBudgets::ALLOCS);
+}
+
+void test_allocations_are_counted() {
+    // Sin el contador cada caso mediría 0 asignaciones y pasaría [bench.allocs]
+    TEST_ASSERT_TRUE_MESSAGE(HAL::heapAllocationsCounted(),
+                             "Compilar con env:bench (-D HAL_COUNT_ALLOCATIONS)");
+}
+
+void setup() {
+    delay(2000);  // Tiempo para abrir el monitor serie
+
+    FirmwareBench::setup();
+    FirmwareBench::registerAll();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_budgeted_cases_are_registered);
+    RUN_TEST(test_allocations_are_counted);
+    for (int i = 0; i < Benchmark::count(); i++) {
+        currentCase = Benchmark::name(i);
+        UnityDefaultTestRun(test_case_within_budget, currentCase, __LINE__);
+    }
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
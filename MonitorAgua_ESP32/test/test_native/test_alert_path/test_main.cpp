@@ -0,0 +1,135 @@
+/**
+ * @file test_main.cpp
+ * @brief Pruebas de la conexión de alerta fuera de programa (WiFiManager::sendAlert).
+ * @details Una alerta debe salir en cuanto hay WiFi y WebSocket: sin esperar una
+ *          respuesta NTP y sin escribir el MAX31328. La referencia NTP la toma
+ *          solo main.cpp a través de RTCDriftEstimator; una escritura por fuera
+ *          desplaza su ref_epoch y subestima la deriva.
+ *
+ *              pio test -e native -f test_native/test_alert_path
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "HALNative.h"
+#include "WifiManager.h"
+#include "../../../sim/MAX31328Model.h"
+
+/**
+ * @class CountingModel
+ * @brief Modelo del MAX31328 que cuenta escrituras de registros
+ */
+class CountingModel : public MAX31328Model {
+public:
+    uint32_t registerWrites = 0;
+
+    CountingModel() : MAX31328Model(0.0) {}
+
+    bool write(const uint8_t* data, size_t length) override {
+        if (length > 1) registerWrites++;  // length 1: solo fija el puntero de lectura
+        return MAX31328Model::write(data, length);
+    }
+};
+
+/**
+ * @class AlertPeer
+ * @brief Servidor en proceso que guarda lo que recibe y no responde
+ */
+class AlertPeer : public HAL::Native::WebSocketPeer {
+public:
+    uint32_t sessions = 0;
+    uint32_t messages = 0;
+    char last[256] = {0};
+
+    bool onOpen() override {
+        sessions++;
+        return true;
+    }
+
+    void onText(const char* payload, size_t length) override {
+        messages++;
+        snprintf(last, sizeof(last), "%.*s", (int)length, payload);
+    }
+
+    size_t poll(char* buffer, size_t capacity) override {
+        return 0;
+    }
+};
+
+static const WiFiManager::wifi_config_t CONFIG = {
+    "red", "clave", "127.0.0.1", 8080, 10000, 10000, 3
+};
+
+static CountingModel* model;
+static AlertPeer* peer;
+static WiFiManager wifiManager(false);
+
+// 2025-01-31 23:59:50 UTC
+static const uint32_t JAN31_235950 = 1738367990UL;
+
+void setUp() {
+    model = HAL::Native::sharedNew<CountingModel>();
+    HAL::Native::attachI2CDevice(MAX31328_I2C_ADDRESS, model);
+    model->setTime(JAN31_235950);
+
+    peer = HAL::Native::sharedNew<AlertPeer>();
+    HAL::Native::attachWebSocketPeer(peer);
+    HAL::Native::setWiFi(true);
+}
+
+void tearDown() {
+    HAL::Native::attachWebSocketPeer(nullptr);
+    HAL::Native::attachI2CDevice(MAX31328_I2C_ADDRESS, nullptr);
+}
+
+static RTCMemoryManager::SensorReading alarmReading() {
+    RTCMemoryManager::SensorReading reading = {};
+    reading.rtc_timestamp = JAN31_235950;
+    reading.temperature = 24.5f;
+    reading.ph = 4.1f;
+    reading.turbidity = 3.0f;
+    reading.tds = 310.0f;
+    reading.valid = true;
+    reading.alarms = 0x02;
+    return reading;
+}
+
+// ——— Alerta ———
+
+void test_alert_does_no_ntp_or_rtc_write() {
+    uint32_t sntpBefore = HAL::Native::sntpRequests();
+    wifiManager.queueAlert(alarmReading());
+
+    TEST_ASSERT_TRUE(wifiManager.sendAlert());
+
+    TEST_ASSERT_EQUAL(1, peer->sessions);
+    TEST_ASSERT_EQUAL(1, peer->messages);
+    TEST_ASSERT_NOT_NULL(strstr(peer->last, "\"action\":\"alert\""));
+    TEST_ASSERT_NOT_NULL(strstr(peer->last, "\"alarms\":2"));
+
+    TEST_ASSERT_EQUAL_UINT32(sntpBefore, HAL::Native::sntpRequests());
+    TEST_ASSERT_EQUAL_UINT32(0, model->registerWrites);
+}
+
+void test_no_pending_alert_opens_no_connection() {
+    uint32_t sntpBefore = HAL::Native::sntpRequests();
+
+    TEST_ASSERT_TRUE(wifiManager.sendAlert());
+
+    TEST_ASSERT_EQUAL(0, peer->sessions);
+    TEST_ASSERT_EQUAL_UINT32(sntpBefore, HAL::Native::sntpRequests());
+    TEST_ASSERT_EQUAL_UINT32(0, model->registerWrites);
+}
+
+int main(int argc, char** argv) {
+    HAL::Native::init();
+    wifiManager.begin(CONFIG);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_alert_does_no_ntp_or_rtc_write);
+    RUN_TEST(test_no_pending_alert_opens_no_connection);
+    return UNITY_END();
+}
@@ -0,0 +1,195 @@
+/**
+ * @file test_main.cpp
+ * @brief Pruebas de lib/Containers: RingBuffer, StaticVector y SpscQueue.
+ * @details RingBuffer se prueba con una capacidad que no es potencia de 2 (la
+ *          que usa RTCMemory) y con una que sí, porque el índice se envuelve por
+ *          caminos distintos. SpscQueue se prueba además con un productor y un
+ *          consumidor en hilos separados.
+ *
+ *              pio test -e native -f test_native/test_containers
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <unity.h>
+#include <thread>
+#include "RingBuffer.h"
+#include "StaticVector.h"
+#include "SpscQueue.h"
+
+void setUp() {}
+void tearDown() {}
+
+// ——— RingBuffer ———
+
+/**
+ * @brief Llena con 1..pushes y verifica orden cronológico, recientes y envoltura
+ */
+template <size_t N>
+static void checkOverwriteOldest(uint32_t pushes) {
+    static RingBuffer<uint32_t, N> ring;
+    ring.clear();
+    for (uint32_t v = 1; v <= pushes; v++) ring.push(v);
+
+    size_t expected = pushes < N ? pushes : N;
+    TEST_ASSERT_EQUAL(expected, ring.size());
+    TEST_ASSERT_EQUAL(pushes >= N, ring.full());
+    TEST_ASSERT_TRUE(ring.isValid());
+    TEST_ASSERT_EQUAL(pushes % N, ring.head);
+
+    uint32_t oldest = pushes - (uint32_t)expected + 1;
+    for (size_t i = 0; i < expected; i++) {
+        TEST_ASSERT_EQUAL_UINT32(oldest + i, ring[i]);       // 0 = más antiguo
+        TEST_ASSERT_EQUAL_UINT32(pushes - i, ring.recent(i)); // 0 = último
+        TEST_ASSERT_LESS_THAN(N, ring.recentIndex(i));
+    }
+}
+
+void test_ring_non_power_of_two_wraps() {
+    TEST_ASSERT_FALSE((RingBuffer<uint32_t, 5>::isPowerOfTwo()));
+    checkOverwriteOldest<5>(3);    // Sin llenar
+    checkOverwriteOldest<5>(5);    // Justo lleno, head vuelve a 0
+    checkOverwriteOldest<5>(7);    // Sobrescribe los 2 más antiguos
+    checkOverwriteOldest<5>(53);   // Muchas vueltas
+    checkOverwriteOldest<160>(161);
+    checkOverwriteOldest<160>(1000);
+}
+
+void test_ring_power_of_two_wraps() {
+    TEST_ASSERT_TRUE((RingBuffer<uint32_t, 8>::isPowerOfTwo()));
+    checkOverwriteOldest<8>(8);
+    checkOverwriteOldest<8>(13);
+    checkOverwriteOldest<1>(4);
+}
+
+void test_ring_empty_and_clear() {
+    static RingBuffer<uint32_t, 6> ring;
+    ring.clear();
+    TEST_ASSERT_TRUE(ring.empty());
+    TEST_ASSERT_FALSE(ring.full());
+    TEST_ASSERT_EQUAL(0, ring.size());
+
+    for (uint32_t v = 0; v < 9; v++) ring.push(v);
+    ring.clear();
+    TEST_ASSERT_TRUE(ring.empty());
+    ring.push(42);
+    TEST_ASSERT_EQUAL(1, ring.size());
+    TEST_ASSERT_EQUAL_UINT32(42, ring[0]);
+    TEST_ASSERT_EQUAL_UINT32(42, ring.recent(0));
+}
+
+void test_ring_slot_commit_in_place() {
+    static RingBuffer<uint32_t, 3> ring;
+    ring.clear();
+    for (uint32_t v = 1; v <= 4; v++) {
+        ring.slot() = v * 10;
+        TEST_ASSERT_EQUAL(v - 1 < 3 ? v - 1 : 3, ring.size());  // Sin commit no cuenta
+        ring.commit();
+    }
+    TEST_ASSERT_EQUAL_UINT32(20, ring[0]);
+    TEST_ASSERT_EQUAL_UINT32(40, ring.recent(0));
+}
+
+void test_ring_detects_corrupt_indices() {
+    static RingBuffer<uint32_t, 5> ring;
+    ring.clear();
+    ring.head = 5;
+    TEST_ASSERT_FALSE(ring.isValid());
+    ring.head = 0;
+    ring.count = 6;
+    TEST_ASSERT_FALSE(ring.isValid());
+}
+
+// ——— StaticVector ———
+
+void test_vector_full_and_empty() {
+    static StaticVector<uint16_t, 3> vec;
+    vec.clear();
+    TEST_ASSERT_TRUE(vec.empty());
+    vec.pop_back();  // Sin efecto si está vacío
+    TEST_ASSERT_EQUAL(0, vec.size());
+
+    TEST_ASSERT_TRUE(vec.push_back(1));
+    TEST_ASSERT_TRUE(vec.push_back(2));
+    TEST_ASSERT_TRUE(vec.push_back(3));
+    TEST_ASSERT_TRUE(vec.full());
+    TEST_ASSERT_FALSE(vec.push_back(4));  // Se descarta, no sobrescribe
+    TEST_ASSERT_EQUAL(3, vec.size());
+    TEST_ASSERT_EQUAL_UINT16(3, vec.back());
+
+    uint32_t sum = 0;
+    for (uint16_t v : vec) sum += v;
+    TEST_ASSERT_EQUAL_UINT32(6, sum);
+
+    vec.pop_back();
+    TEST_ASSERT_FALSE(vec.full());
+    TEST_ASSERT_EQUAL_UINT16(2, vec.back());
+    TEST_ASSERT_TRUE(vec.isValid());
+    vec.count = 4;
+    TEST_ASSERT_FALSE(vec.isValid());
+}
+
+// ——— SpscQueue ———
+
+void test_spsc_full_empty_and_fifo() {
+    static SpscQueue<uint32_t, 4> queue;
+    uint32_t value = 0;
+    TEST_ASSERT_TRUE(queue.empty());
+    TEST_ASSERT_FALSE(queue.pop(value));
+
+    // Muchas vueltas de los contadores sobre las 4 posiciones
+    uint32_t next = 0, expected = 0;
+    for (int round = 0; round < 50; round++) {
+        while (queue.push(next)) next++;
+        TEST_ASSERT_EQUAL(4, queue.size());  // Caben exactamente N
+        for (int i = 0; i < 3; i++) {
+            TEST_ASSERT_TRUE(queue.pop(value));
+            TEST_ASSERT_EQUAL_UINT32(expected++, value);
+        }
+    }
+    while (queue.pop(value)) TEST_ASSERT_EQUAL_UINT32(expected++, value);
+    TEST_ASSERT_EQUAL_UINT32(next, expected);
+    TEST_ASSERT_TRUE(queue.empty());
+}
+
+void test_spsc_threads_preserve_order() {
+    static SpscQueue<uint32_t, 16> queue;
+    const uint32_t total = 200000;
+
+    std::thread producer([&]() {
+        for (uint32_t v = 0; v < total;) {
+            if (queue.push(v)) v++;
+            else std::this_thread::yield();
+        }
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < total) {
+        uint32_t value;
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (value != expected) ordered = false;
+        expected++;
+    }
+    producer.join();
+
+    TEST_ASSERT_TRUE_MESSAGE(ordered, "El consumidor vio elementos fuera de orden");
+    TEST_ASSERT_TRUE(queue.empty());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_non_power_of_two_wraps);
+    RUN_TEST(test_ring_power_of_two_wraps);
+    RUN_TEST(test_ring_empty_and_clear);
+    RUN_TEST(test_ring_slot_commit_in_place);
+    RUN_TEST(test_ring_detects_corrupt_indices);
+    RUN_TEST(test_vector_full_and_empty);
+    RUN_TEST(test_spsc_full_empty_and_fifo);
+    RUN_TEST(test_spsc_threads_preserve_order);
+    return UNITY_END();
+}
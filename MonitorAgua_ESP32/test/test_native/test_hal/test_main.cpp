@@ -0,0 +1,241 @@
+/**
+ * @file test_main.cpp
+ * @brief Pruebas del backend Linux de la HAL (lib/HAL, -D HAL_NATIVE).
+ * @details Fijan el comportamiento del que dependen el resto de las suites, el
+ *          simulador y los benchmarks: CRC con la semántica de la ROM, reloj
+ *          virtual, modelo del ADC, NVS, bus I2C con modelos y la RAM persistente
+ *          que el ejecutor conserva entre ciclos.
+ *
+ *              pio test -e native -f test_native/test_hal
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include <Preferences.h>
+#include <Wire.h>
+#include "HAL.h"
+#include "HALNative.h"
+
+// ——— Fixtures ———
+
+HAL_PERSISTENT uint32_t persistentBoots;  ///< Sobrevive entre ciclos de runCycle()
+static uint32_t volatileBoots;            ///< Arranca en cero en cada ciclo
+
+/**
+ * @brief Ciclo mínimo para el ejecutor: cuenta arranques y duerme 1 s
+ */
+void setup() {
+    persistentBoots++;
+    volatileBoots++;
+    HAL::sleepEnableTimer(1000000ULL);
+    HAL::deepSleep();
+}
+
+/**
+ * @class RegisterDevice
+ * @brief Esclavo I2C de 16 registros con puntero autoincremental
+ */
+class RegisterDevice : public HAL::Native::I2CDevice {
+public:
+    uint8_t regs[16] = {0};
+    uint8_t pointer = 0;
+
+    bool write(const uint8_t* data, size_t length) override {
+        if (length == 0) return true;
+        if (data[0] >= sizeof(regs)) return false;
+        pointer = data[0];
+        for (size_t i = 1; i < length; i++) regs[(pointer++) & 0x0F] = data[i];
+        return true;
+    }
+
+    size_t read(uint8_t* data, size_t length) override {
+        for (size_t i = 0; i < length; i++) data[i] = regs[(pointer++) & 0x0F];
+        return length;
+    }
+};
+
+static const uint8_t DEVICE_ADDRESS = 0x42;
+
+void setUp() {}
+
+void tearDown() {
+    HAL::Native::attachI2CDevice(DEVICE_ADDRESS, nullptr);
+    HAL::Native::nvsClear("test");
+}
+
+// ——— CRC ———
+
+void test_crc32_matches_rom_semantics() {
+    static const uint8_t check[] = "123456789";
+    // Vector de verificación de CRC-32/ISO-HDLC; la ROM parte de 0 con complemento interno
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926u, HAL::crc32(0, check, 9));
+    TEST_ASSERT_EQUAL_HEX32(0u, HAL::crc32(0, check, 0));
+
+    // Acumulable por tramos, como lo usa RTCMemory
+    uint32_t split = HAL::crc32(0, check, 4);
+    split = HAL::crc32(split, check + 4, 5);
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926u, split);
+}
+
+// ——— Reloj virtual ———
+
+void test_clock_advances_only_virtually() {
+    uint64_t rtc0 = HAL::rtcTimeUs();
+    unsigned long us0 = micros();
+    HAL::Native::advanceUs(250000);
+    unsigned long us1 = micros();
+    uint64_t rtc1 = HAL::rtcTimeUs();
+
+    // Cada lectura adelanta HAL_NATIVE_CLOCK_READ_US para que los sondeos terminen
+    TEST_ASSERT_GREATER_OR_EQUAL(250000, (long long)(us1 - us0));
+    TEST_ASSERT_LESS_OR_EQUAL(250000 + 4 * HAL_NATIVE_CLOCK_READ_US, (long long)(us1 - us0));
+    TEST_ASSERT_GREATER_OR_EQUAL(250000, (long long)(rtc1 - rtc0));
+
+    unsigned long ms0 = millis();
+    delay(1500);
+    TEST_ASSERT_GREATER_OR_EQUAL(1500, (long long)(millis() - ms0));
+}
+
+void test_time_of_day_follows_virtual_clock() {
+    struct timeval tv = {1760000000, 0};
+    HAL::setTimeOfDay(&tv);
+    HAL::Native::advanceUs(2000000);
+
+    struct timeval now;
+    HAL::getTimeOfDay(&now);
+    TEST_ASSERT_EQUAL(1760000002, now.tv_sec);
+}
+
+// ——— ADC ———
+
+void test_adc_round_trips_injected_voltage() {
+    const uint8_t pin = 5;
+    HAL::Native::setAnalogNoise(0);
+    HAL::adcConfigure(pin, 12, HAL::AdcAtten::DB_12);
+    HAL::AdcCalibration cal;
+    HAL::adcCalibrate(&cal, HAL::AdcAtten::DB_12, 12, 1100);
+
+    HAL::Native::setAnalogMilliVolts(pin, 1000.0f);
+    uint32_t mv = HAL::adcToMilliVolts(HAL::adcRead(pin), &cal);
+    TEST_ASSERT_UINT32_WITHIN(3, 1000, mv);
+
+    // Fuera de rango satura al fondo de escala de 12 bits
+    HAL::Native::setAnalogMilliVolts(pin, 5000.0f);
+    TEST_ASSERT_EQUAL(4095, HAL::adcRead(pin));
+}
+
+// ——— NVS ———
+
+void test_preferences_round_trip() {
+    const uint8_t blob[] = {1, 2, 3, 4, 5};
+    uint8_t out[8] = {0};
+
+    Preferences prefs;
+    TEST_ASSERT_TRUE(prefs.begin("test", false));
+    TEST_ASSERT_EQUAL(sizeof(blob), prefs.putBytes("blob", blob, sizeof(blob)));
+    prefs.end();
+
+    TEST_ASSERT_TRUE(prefs.begin("test", true));
+    TEST_ASSERT_TRUE(prefs.isKey("blob"));
+    TEST_ASSERT_EQUAL(sizeof(blob), prefs.getBytesLength("blob"));
+    TEST_ASSERT_EQUAL(sizeof(blob), prefs.getBytes("blob", out, sizeof(out)));
+    TEST_ASSERT_EQUAL_MEMORY(blob, out, sizeof(blob));
+
+    // Solo lectura: no escribe; búfer corto: sin lecturas parciales
+    TEST_ASSERT_EQUAL(0, prefs.putBytes("other", blob, sizeof(blob)));
+    TEST_ASSERT_EQUAL(0, prefs.getBytes("blob", out, 2));
+    prefs.end();
+}
+
+// ——— I2C ———
+
+void test_i2c_without_device_nacks_address() {
+    Wire.begin();
+    Wire.beginTransmission(DEVICE_ADDRESS);
+    Wire.write((uint8_t)0x00);
+    TEST_ASSERT_EQUAL(2, Wire.endTransmission());
+    TEST_ASSERT_EQUAL(0, Wire.requestFrom(DEVICE_ADDRESS, (uint8_t)1));
+}
+
+void test_i2c_register_write_then_read() {
+    RegisterDevice* device = HAL::Native::sharedNew<RegisterDevice>();
+    TEST_ASSERT_NOT_NULL(device);
+    HAL::Native::attachI2CDevice(DEVICE_ADDRESS, device);
+
+    Wire.begin();
+    Wire.beginTransmission(DEVICE_ADDRESS);
+    Wire.write((uint8_t)0x03);
+    Wire.write((uint8_t)0xA5);
+    Wire.write((uint8_t)0x5A);
+    TEST_ASSERT_EQUAL(0, Wire.endTransmission());
+    TEST_ASSERT_EQUAL_HEX8(0xA5, device->regs[3]);
+    TEST_ASSERT_EQUAL_HEX8(0x5A, device->regs[4]);
+
+    Wire.beginTransmission(DEVICE_ADDRESS);
+    Wire.write((uint8_t)0x03);
+    TEST_ASSERT_EQUAL(0, Wire.endTransmission(false));
+    TEST_ASSERT_EQUAL(2, Wire.requestFrom(DEVICE_ADDRESS, (uint8_t)2));
+    TEST_ASSERT_EQUAL_HEX8(0xA5, Wire.read());
+    TEST_ASSERT_EQUAL_HEX8(0x5A, Wire.read());
+    TEST_ASSERT_EQUAL(-1, Wire.read());
+
+    // Registro inexistente: NACK de datos
+    Wire.beginTransmission(DEVICE_ADDRESS);
+    Wire.write((uint8_t)0x20);
+    TEST_ASSERT_EQUAL(3, Wire.endTransmission());
+}
+
+// ——— Heap ———
+
+void test_heap_allocations_are_counted() {
+    TEST_ASSERT_TRUE(HAL::heapAllocationsCounted());
+    uint32_t before = HAL::heapAllocations();
+    void* volatile p = malloc(32);  // volatile: el par malloc/free no se elimina
+    TEST_ASSERT_NOT_NULL(p);
+    free(p);
+    TEST_ASSERT_EQUAL(before + 1, HAL::heapAllocations());
+}
+
+// ——— Ejecutor y RAM persistente ———
+
+void test_persistent_ram_survives_deep_sleep_only() {
+    HAL::Native::powerCycle();
+
+    HAL::Native::CycleResult r = HAL::Native::runCycle();
+    TEST_ASSERT_EQUAL(HAL::Native::CYCLE_DEEP_SLEEP, r.end);
+    TEST_ASSERT_EQUAL(1000000ULL, r.sleep_us);
+    HAL::Native::wake(r.sleep_us, ESP_SLEEP_WAKEUP_TIMER);
+    r = HAL::Native::runCycle();
+    TEST_ASSERT_EQUAL(HAL::Native::CYCLE_DEEP_SLEEP, r.end);
+
+    TEST_ASSERT_TRUE(HAL::Native::loadPersistent());
+    TEST_ASSERT_EQUAL_UINT32(2, persistentBoots);
+    TEST_ASSERT_EQUAL_UINT32(0, volatileBoots);  // setup() corrió en el proceso del ciclo
+
+    // Un corte de alimentación pierde la sección persistente
+    HAL::Native::powerCycle();
+    TEST_ASSERT_FALSE(HAL::Native::loadPersistent());
+    r = HAL::Native::runCycle();
+    TEST_ASSERT_EQUAL(HAL::Native::CYCLE_DEEP_SLEEP, r.end);
+    TEST_ASSERT_TRUE(HAL::Native::loadPersistent());
+    TEST_ASSERT_EQUAL_UINT32(1, persistentBoots);
+}
+
+int main(int argc, char** argv) {
+    HAL::Native::init();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32_matches_rom_semantics);
+    RUN_TEST(test_clock_advances_only_virtually);
+    RUN_TEST(test_time_of_day_follows_virtual_clock);
+    RUN_TEST(test_adc_round_trips_injected_voltage);
+    RUN_TEST(test_preferences_round_trip);
+    RUN_TEST(test_i2c_without_device_nacks_address);
+    RUN_TEST(test_i2c_register_write_then_read);
+    RUN_TEST(test_heap_allocations_are_counted);
+    RUN_TEST(test_persistent_ram_survives_deep_sleep_only);
+    return UNITY_END();
+}
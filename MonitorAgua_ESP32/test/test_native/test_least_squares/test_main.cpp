@@ -0,0 +1,207 @@
+/**
+ * @file test_main.cpp
+ * @brief Pruebas de lib/LeastSquares y de la calibración multipunto de CalibrationManager.
+ * @details El solucionador se compara con ajustes de solución cerrada (exactos y
+ *          con residuos conocidos) y con sus casos de rechazo. La calibración se
+ *          prueba de punta a punta con los comandos JSON que envía la interfaz:
+ *          calib_point, calib_fit y calib_clear.
+ *
+ *              pio test -e native -f test_native/test_least_squares
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "HALNative.h"
+#include "LeastSquares.h"
+#include "CalibrationManager.h"
+
+using namespace LeastSquares;
+
+static CalibrationManager calibrationManager(false);
+
+void setUp() {
+    calibrationManager.clearCalibrationPoints(CalibrationManager::SENSOR_COUNT);
+}
+
+void tearDown() {}
+
+/**
+ * @brief Ejecuta un comando de calibración como lo recibe WiFiManager
+ */
+static CalibrationManager::CalibrationResult command(const char* json) {
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer), "%s", json);
+    return calibrationManager.processCalibrationCommand(buffer, strlen(buffer));
+}
+
+// ——— LeastSquares ———
+
+void test_linear_fit_exact() {
+    const float x[] = {0.5f, 1.0f, 1.5f, 2.0f, 2.5f};
+    float y[5];
+    for (int i = 0; i < 5; i++) y[i] = 1.33f + 3.5f * x[i];
+
+    float c[2];
+    float r[5];
+    FitStats s;
+    TEST_ASSERT_EQUAL(LSQ_OK, fitPolynomial(x, y, 5, 1, c, r, &s));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.33f, c[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 3.5f, c[1]);
+    TEST_ASSERT_EQUAL(5, s.n);
+    TEST_ASSERT_EQUAL(2, s.terms);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, s.rmse);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.0f, s.r2);
+}
+
+void test_linear_fit_known_residuals() {
+    // Solución cerrada: pendiente Sxy/Sxx = 3/5, intercepto 1 - 0.6·1.5
+    const float x[] = {0, 1, 2, 3};
+    const float y[] = {0, 1, 1, 2};
+
+    float c[2];
+    float r[4];
+    FitStats s;
+    TEST_ASSERT_EQUAL(LSQ_OK, fitPolynomial(x, y, 4, 1, c, r, &s));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.1f, c[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.6f, c[1]);
+
+    const float expected[] = {-0.1f, 0.3f, -0.3f, 0.1f};
+    for (int i = 0; i < 4; i++) TEST_ASSERT_FLOAT_WITHIN(1e-6f, expected[i], r[i]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.3f, s.maxAbsResidual);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, sqrtf(0.05f), s.rmse);  // √(SSres / n)
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.9f, s.r2);            // 1 - 0.2 / 2
+}
+
+void test_cubic_fit_recovers_turbidity_model() {
+    // Coeficientes de fábrica de la turbidez en el rango real del sensor
+    const double a = -1120.4, b = 5742.3, cc = -4352.9, d = -2500.0;
+    float x[8];
+    float y[8];
+    for (int i = 0; i < 8; i++) {
+        x[i] = 1.0f + 0.2f * i;
+        double v = x[i];
+        y[i] = (float)(((a * v + b) * v + cc) * v + d);
+    }
+
+    float c[4];
+    FitStats s;
+    TEST_ASSERT_EQUAL(LSQ_OK, fitPolynomial(x, y, 8, 3, c, nullptr, &s));
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, d, c[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, cc, c[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, b, c[2]);
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, a, c[3]);
+    TEST_ASSERT_LESS_THAN(0.01f, s.rmse);
+}
+
+void test_scale_fit() {
+    const float f[] = {100.0f, 250.0f, 700.0f};
+    const float y[] = {160.0f, 400.0f, 1120.0f};
+
+    float k = 0;
+    FitStats s;
+    TEST_ASSERT_EQUAL(LSQ_OK, fitScale(f, y, 3, &k, nullptr, &s));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 1.6f, k);
+    TEST_ASSERT_EQUAL(1, s.terms);
+}
+
+void test_rejects_bad_input() {
+    const float x[] = {1, 2, 3};
+    const float y[] = {1, 2, 3};
+    const float same[] = {1.5f, 1.5f, 1.5f};
+    const float bad[] = {1, NAN, 3};
+    float c[4];
+
+    TEST_ASSERT_EQUAL(LSQ_INSUFFICIENT_POINTS, fitPolynomial(x, y, 3, 3, c, nullptr, nullptr));
+    TEST_ASSERT_EQUAL(LSQ_ILL_CONDITIONED, fitPolynomial(same, y, 3, 1, c, nullptr, nullptr));
+    TEST_ASSERT_EQUAL(LSQ_INVALID_INPUT, fitPolynomial(bad, y, 3, 1, c, nullptr, nullptr));
+    TEST_ASSERT_EQUAL(LSQ_INVALID_INPUT, fitPolynomial(x, y, 3, LSQ_MAX_TERMS, c, nullptr, nullptr));
+    TEST_ASSERT_EQUAL_STRING("ill_conditioned", statusName(LSQ_ILL_CONDITIONED));
+}
+
+// ——— Calibración multipunto ———
+
+void test_ph_points_fit_and_apply() {
+    // pH = 3.2·V + 0.9 medido en tres soluciones patrón
+    TEST_ASSERT_EQUAL(CalibrationManager::CALIB_SUCCESS,
+                      command("{\"action\":\"calib_point\",\"sensor\":\"ph\",\"reference\":4.0,\"voltage\":0.96875}"));
+    TEST_ASSERT_EQUAL(CalibrationManager::CALIB_SUCCESS,
+                      command("{\"action\":\"calib_point\",\"sensor\":\"ph\",\"reference\":7.0,\"voltage\":1.90625}"));
+    TEST_ASSERT_EQUAL(CalibrationManager::CALIB_SUCCESS,
+                      command("{\"action\":\"calib_point\",\"sensor\":\"ph\",\"reference\":10.0,\"voltage\":2.84375}"));
+    TEST_ASSERT_EQUAL(3, calibrationManager.getCalibrationPointCount(CalibrationManager::SENSOR_PH));
+
+    TEST_ASSERT_EQUAL(CalibrationManager::CALIB_SUCCESS,
+                      command("{\"action\":\"calib_fit\",\"sensor\":\"ph\"}"));
+
+    const CalibrationManager::FitReport& fit = calibrationManager.getLastFit();
+    TEST_ASSERT_TRUE(fit.applied);
+    TEST_ASSERT_EQUAL(3, fit.stats.n);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.9f, fit.coeffs[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 3.2f, fit.coeffs[1]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 1.0f, fit.stats.r2);
+
+    CalibrationManager::CalibrationData data = calibrationManager.getCalibrationData();
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.9f, data.ph_offset);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 3.2f, data.ph_slope);
+    TEST_ASSERT_TRUE(calibrationManager.validateIntegrity());
+
+    char json[256];
+    calibrationManager.getFitReportJSON(json, sizeof(json));
+    TEST_ASSERT_NOT_NULL(strstr(json, "\"applied\":true"));
+}
+
+void test_fit_without_apply_keeps_calibration() {
+    CalibrationManager::CalibrationData before = calibrationManager.getCalibrationData();
+    calibrationManager.addCalibrationPoint(CalibrationManager::SENSOR_PH, 4.0f, 1.0f);
+    calibrationManager.addCalibrationPoint(CalibrationManager::SENSOR_PH, 9.0f, 2.5f);
+
+    TEST_ASSERT_EQUAL(CalibrationManager::CALIB_SUCCESS,
+                      command("{\"action\":\"calib_fit\",\"sensor\":\"ph\",\"apply\":false}"));
+    TEST_ASSERT_FALSE(calibrationManager.getLastFit().applied);
+    TEST_ASSERT_EQUAL_FLOAT(before.ph_slope, calibrationManager.getCalibrationData().ph_slope);
+}
+
+void test_turbidity_needs_four_points() {
+    CalibrationManager::CalibrationData before = calibrationManager.getCalibrationData();
+    for (int i = 0; i < 3; i++) {
+        calibrationManager.addCalibrationPoint(CalibrationManager::SENSOR_TURBIDITY, 10.0f * i, 1.0f + 0.5f * i);
+    }
+    TEST_ASSERT_EQUAL(CalibrationManager::CALIB_ERROR_INSUFFICIENT_POINTS,
+                      calibrationManager.fitCalibration(CalibrationManager::SENSOR_TURBIDITY));
+    TEST_ASSERT_EQUAL_FLOAT(before.turb_coeff_a, calibrationManager.getCalibrationData().turb_coeff_a);
+}
+
+void test_point_capacity_and_clear() {
+    for (uint8_t i = 0; i < CalibrationManager::MAX_CALIBRATION_POINTS; i++) {
+        TEST_ASSERT_EQUAL(CalibrationManager::CALIB_SUCCESS,
+                          calibrationManager.addCalibrationPoint(CalibrationManager::SENSOR_TDS, 100.0f * i, 0.1f * i));
+    }
+    TEST_ASSERT_EQUAL(CalibrationManager::CALIB_ERROR_WRITE_FAILED,
+                      calibrationManager.addCalibrationPoint(CalibrationManager::SENSOR_TDS, 1.0f, 1.0f));
+
+    TEST_ASSERT_EQUAL(CalibrationManager::CALIB_SUCCESS,
+                      command("{\"action\":\"calib_clear\",\"sensor\":\"tds\"}"));
+    TEST_ASSERT_EQUAL(0, calibrationManager.getCalibrationPointCount(CalibrationManager::SENSOR_TDS));
+    TEST_ASSERT_EQUAL(CalibrationManager::CALIB_ERROR_INVALID_VALUE,
+                      command("{\"action\":\"calib_clear\",\"sensor\":\"orp\"}"));
+}
+
+int main(int argc, char** argv) {
+    HAL::Native::init();
+    calibrationManager.begin();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_linear_fit_exact);
+    RUN_TEST(test_linear_fit_known_residuals);
+    RUN_TEST(test_cubic_fit_recovers_turbidity_model);
+    RUN_TEST(test_scale_fit);
+    RUN_TEST(test_rejects_bad_input);
+    RUN_TEST(test_ph_points_fit_and_apply);
+    RUN_TEST(test_fit_without_apply_keeps_calibration);
+    RUN_TEST(test_turbidity_needs_four_points);
+    RUN_TEST(test_point_capacity_and_clear);
+    return UNITY_END();
+}
@@ -0,0 +1,11 @@
+/**
+ * @file FirmwareBenchmark.cpp
+ * @brief Compila los casos de microbenchmark (bench/) dentro de esta suite.
+ * @details Los entornos de prueba no incluyen bench/ en la compilación; así la
+ *          suite mide exactamente los mismos casos que native_bench y bench.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include "../../../bench/FirmwareBenchmark.cpp"
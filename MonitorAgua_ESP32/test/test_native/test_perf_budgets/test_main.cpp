@@ -0,0 +1,94 @@
+/**
+ * @file test_main.cpp
+ * @brief Presupuestos de rendimiento de perf_budgets.ini en el anfitrión.
+ * @details Mide cada caso de bench/FirmwareBenchmark.cpp con Benchmark::run() y
+ *          falla si las asignaciones por iteración pasan [bench.allocs]: no
+ *          dependen de la máquina. La mediana se compara con [bench.native_ns]
+ *          solo con -D PERF_BUDGETS_NS, en la máquina donde se derivaron esos
+ *          límites (en otra, o en CI, el tiempo es ruido). Los límites llegan en
+ *          PerfBudgets.h, que genera tools/perf_budgets_header.py al compilar.
+ *          Un caso sin límite aplicable se informa como ignorado.
+ *
+ *              pio test -e native -f test_native/test_perf_budgets
+ *              PLATFORMIO_BUILD_FLAGS="-D PERF_BUDGETS_NS" pio test -e native -f test_native/test_perf_budgets
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "HAL.h"
+#include "HALNative.h"
+#include "Benchmark.h"
+#include "PerfBudgets.h"
+#include "../../../bench/FirmwareBenchmark.h"
+
+static const char* currentCase;  ///< Caso que mide test_case_within_budget()
+
+void setUp() {}
+void tearDown() {}
+
+// ——— Casos ———
+
+void test_case_within_budget() {
+    double limitNs = 0, limitAllocs = 0;
+#ifdef PERF_BUDGETS_NS
+    bool hasNs = PerfBudgets::lookup(PerfBudgets::NATIVE_NS, currentCase, limitNs);
+#else
+    bool hasNs = false;
+#endif
+    bool hasAllocs = PerfBudgets::lookup(PerfBudgets::ALLOCS, currentCase, limitAllocs);
+    if (!hasNs && !hasAllocs) {
+        if (PerfBudgets::lookup(PerfBudgets::NATIVE_NS, currentCase, limitNs)) {
+            TEST_IGNORE_MESSAGE("Solo límite en ns: compilar con -D PERF_BUDGETS_NS");
+        }
+        TEST_IGNORE_MESSAGE("Sin límite en perf_budgets.ini");
+    }
+
+    Benchmark::Result result;
+    Benchmark::run(Benchmark::find(currentCase), result);
+
+    char message[96];
+    if (hasNs) {
+        snprintf(message, sizeof(message), "%.1f ns por iteración, límite %.0f",
+                 result.median_ns, limitNs);
+        TEST_ASSERT_TRUE_MESSAGE(result.median_ns <= limitNs, message);
+    }
+    if (hasAllocs) {
+        snprintf(message, sizeof(message), "%.3f asignaciones por iteración, límite %.3f",
+                 result.allocs, limitAllocs);
+        TEST_ASSERT_TRUE_MESSAGE(result.allocs <= limitAllocs, message);
+    }
+}
+
+// ——— Archivo de límites ———
+
+/**
+ * @brief Falla con el primer caso presupuestado que no está registrado
+ */
+static void checkRegistered(const PerfBudgets::Budget* table) {
+    for (; table->name; table++) {
+        TEST_ASSERT_NOT_NULL_MESSAGE(Benchmark::find(table->name), table->name);
+    }
+}
+
+void test_budgeted_cases_are_registered() {
+    // Un caso borrado o renombrado sin actualizar perf_budgets.ini
+    checkRegistered(PerfBudgets::NATIVE_NS);
+    checkRegistered(PerfBudgets::ALLOCS);
+}
+
+int main(int argc, char** argv) {
+    HAL::Native::init();
+    FirmwareBench::setup();
+    FirmwareBench::registerAll();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_budgeted_cases_are_registered);
+    for (int i = 0; i < Benchmark::count(); i++) {
+        currentCase = Benchmark::name(i);
+        UnityDefaultTestRun(test_case_within_budget, currentCase, __LINE__);
+    }
+    return UNITY_END();
+}
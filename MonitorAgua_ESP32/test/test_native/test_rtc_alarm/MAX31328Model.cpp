@@ -0,0 +1,11 @@
+/**
+ * @file MAX31328Model.cpp
+ * @brief Compila el modelo del simulador (sim/) dentro de esta suite.
+ * @details env:native no incluye sim/ en la compilación; así la suite usa el
+ *          mismo mapa de registros que el simulador de ciclos.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include "../../../sim/MAX31328Model.cpp"
@@ -0,0 +1,240 @@
+/**
+ * @file test_main.cpp
+ * @brief Pruebas de las alarmas de MAX31328RTC contra el modelo de registros de sim/.
+ * @details Verifican lo que el chip exige y un error no mostraría hasta el campo:
+ *          bits A1M/A2M y DY/DT en cero (coincidencia de fecha completa), la
+ *          bandera borrada antes de habilitar INTCN/AxIE (si no, INT queda en bajo
+ *          y el equipo despierta en el acto) y el paso de día, mes y año.
+ *
+ *              pio test -e native -f test_native/test_rtc_alarm
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "HALNative.h"
+#include "RTC.h"
+#include "../../../sim/MAX31328Model.h"
+
+#define LOG_WRITES 16
+
+/**
+ * @class RecordingModel
+ * @brief Modelo que registra el primer registro de cada escritura, en orden
+ */
+class RecordingModel : public MAX31328Model {
+public:
+    uint8_t writes[LOG_WRITES];
+    uint8_t writeCount = 0;
+
+    RecordingModel() : MAX31328Model(0.0) {}
+
+    bool write(const uint8_t* data, size_t length) override {
+        if (length > 1 && writeCount < LOG_WRITES) writes[writeCount++] = data[0];
+        return MAX31328Model::write(data, length);
+    }
+
+    /**
+     * @brief Lee registros sin pasar por el registro de escrituras
+     */
+    void peek(uint8_t reg, uint8_t* out, size_t length) {
+        MAX31328Model::write(&reg, 1);
+        read(out, length);
+    }
+
+    uint8_t reg(uint8_t address) {
+        uint8_t value = 0;
+        peek(address, &value, 1);
+        return value;
+    }
+
+    /**
+     * @brief Posición de la primera escritura a un registro (-1 si no hubo)
+     */
+    int firstWriteTo(uint8_t address) const {
+        for (uint8_t i = 0; i < writeCount; i++) {
+            if (writes[i] == address) return i;
+        }
+        return -1;
+    }
+};
+
+static RecordingModel* model;
+static MAX31328RTC rtc;
+
+// 2025-01-31 23:59:50 UTC
+static const uint32_t JAN31_235950 = 1738367990UL;
+
+static uint8_t bcd(int value) {
+    return (uint8_t)(((value / 10) << 4) | (value % 10));
+}
+
+void setUp() {
+    model = HAL::Native::sharedNew<RecordingModel>();
+    HAL::Native::attachI2CDevice(MAX31328_I2C_ADDRESS, model);
+    model->setTime(JAN31_235950);
+    TEST_ASSERT_TRUE(rtc.begin());
+    model->writeCount = 0;
+}
+
+void tearDown() {
+    HAL::Native::attachI2CDevice(MAX31328_I2C_ADDRESS, nullptr);
+}
+
+// ——— Alarma 1 ———
+
+void test_alarm1_registers_match_full_date() {
+    uint32_t target = MAX31328RTC::toEpoch(2025, 3, 14, 15, 9, 26);
+    TEST_ASSERT_TRUE(rtc.setAlarm(1, target));
+
+    uint8_t a[4];
+    model->peek(MAX31328_REG_ALARM1, a, sizeof(a));
+    TEST_ASSERT_EQUAL_HEX8(bcd(26), a[0]);
+    TEST_ASSERT_EQUAL_HEX8(bcd(9), a[1]);
+    TEST_ASSERT_EQUAL_HEX8(bcd(15), a[2]);  // Bit 6 = 0: 24 h
+    TEST_ASSERT_EQUAL_HEX8(bcd(14), a[3]);  // Bit 6 = 0: DY/DT = día del mes
+
+    // A1M1..A1M4 = 0: todos los campos participan
+    for (int i = 0; i < 4; i++) TEST_ASSERT_BITS_LOW(MAX31328_ALARM_MASK, a[i]);
+
+    uint8_t control = model->reg(MAX31328_REG_CONTROL);
+    TEST_ASSERT_BITS_HIGH(MAX31328_CTRL_INTCN | MAX31328_CTRL_A1IE, control);
+    TEST_ASSERT_BITS_LOW(MAX31328_CTRL_EOSC, control);
+}
+
+void test_alarm1_clears_flag_before_enabling_interrupt() {
+    // Alarma anterior disparada con la interrupción apagada: A1F sigue en 1
+    model->fireAlarm();
+    TEST_ASSERT_TRUE(rtc.disableAlarms());
+    model->fireAlarm();
+    model->writeCount = 0;
+
+    TEST_ASSERT_TRUE(rtc.setAlarm(1, JAN31_235950 + 80));
+
+    int statusWrite = model->firstWriteTo(MAX31328_REG_STATUS);
+    int controlWrite = model->firstWriteTo(MAX31328_REG_CONTROL);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, statusWrite);
+    TEST_ASSERT_GREATER_OR_EQUAL(0, controlWrite);
+    TEST_ASSERT_LESS_THAN(controlWrite, statusWrite);
+
+    TEST_ASSERT_BITS_LOW(MAX31328_STAT_A1F, model->reg(MAX31328_REG_STATUS));
+    TEST_ASSERT_FALSE(model->interruptAsserted());
+}
+
+void test_alarm1_fires_at_target() {
+    TEST_ASSERT_TRUE(rtc.setAlarm(1, JAN31_235950 + 80));
+
+    uint64_t us = 0;
+    TEST_ASSERT_TRUE(model->timeToAlarm(us));
+    TEST_ASSERT_UINT32_WITHIN(1000000, 80000000, (uint32_t)us);
+}
+
+// ——— Paso de día, mes y año ———
+
+void test_alarm_rolls_over_day_and_month() {
+    // 23:59:50 + 80 s = 1 de febrero 00:01:10
+    TEST_ASSERT_TRUE(rtc.setAlarm(1, JAN31_235950 + 80));
+
+    uint8_t a[4];
+    model->peek(MAX31328_REG_ALARM1, a, sizeof(a));
+    TEST_ASSERT_EQUAL_HEX8(0x10, a[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, a[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, a[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, a[3]);
+}
+
+void test_alarm_rolls_over_year_and_leap_day() {
+    uint8_t a[4];
+
+    // 2025-12-31 23:59:30 + 80 s = 2026-01-01 00:00:50
+    model->setTime(MAX31328RTC::toEpoch(2025, 12, 31, 23, 59, 30));
+    TEST_ASSERT_TRUE(rtc.setAlarm(1, MAX31328RTC::toEpoch(2025, 12, 31, 23, 59, 30) + 80));
+    model->peek(MAX31328_REG_ALARM1, a, sizeof(a));
+    TEST_ASSERT_EQUAL_HEX8(0x50, a[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, a[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, a[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, a[3]);
+    uint64_t us = 0;
+    TEST_ASSERT_TRUE(model->timeToAlarm(us));
+    TEST_ASSERT_UINT32_WITHIN(1000000, 80000000, (uint32_t)us);
+
+    // 2028 es bisiesto: 28 de febrero 23:59:00 + 80 s = 29 de febrero
+    uint32_t feb28 = MAX31328RTC::toEpoch(2028, 2, 28, 23, 59, 0);
+    model->setTime(feb28);
+    TEST_ASSERT_TRUE(rtc.setAlarm(1, feb28 + 80));
+    model->peek(MAX31328_REG_ALARM1, a, sizeof(a));
+    TEST_ASSERT_EQUAL_HEX8(0x20, a[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, a[1]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, a[2]);
+    TEST_ASSERT_EQUAL_HEX8(0x29, a[3]);
+    TEST_ASSERT_TRUE(model->timeToAlarm(us));
+    TEST_ASSERT_UINT32_WITHIN(1000000, 80000000, (uint32_t)us);
+}
+
+// ——— Alarma 2 ———
+
+void test_alarm2_has_no_seconds_register() {
+    uint32_t target = MAX31328RTC::toEpoch(2025, 2, 1, 6, 30, 0);
+    TEST_ASSERT_TRUE(rtc.setAlarm(2, target));
+
+    uint8_t a[3];
+    model->peek(MAX31328_REG_ALARM2, a, sizeof(a));
+    TEST_ASSERT_EQUAL_HEX8(bcd(30), a[0]);
+    TEST_ASSERT_EQUAL_HEX8(bcd(6), a[1]);
+    TEST_ASSERT_EQUAL_HEX8(bcd(1), a[2]);
+    for (int i = 0; i < 3; i++) TEST_ASSERT_BITS_LOW(MAX31328_ALARM_MASK, a[i]);
+
+    uint8_t control = model->reg(MAX31328_REG_CONTROL);
+    TEST_ASSERT_BITS_HIGH(MAX31328_CTRL_INTCN | MAX31328_CTRL_A2IE, control);
+    TEST_ASSERT_BITS_LOW(MAX31328_CTRL_A1IE, control);
+    TEST_ASSERT_EQUAL(MAX31328_REG_ALARM2, model->writes[0]);
+}
+
+void test_invalid_alarm_number_writes_nothing() {
+    TEST_ASSERT_FALSE(rtc.setAlarm(0, JAN31_235950 + 80));
+    TEST_ASSERT_FALSE(rtc.setAlarm(3, JAN31_235950 + 80));
+    TEST_ASSERT_EQUAL(0, model->writeCount);
+}
+
+// ——— Banderas y deshabilitación ———
+
+void test_flags_and_disable() {
+    uint8_t flags = 0xFF;
+    TEST_ASSERT_TRUE(rtc.setAlarm(1, JAN31_235950 + 80));
+    TEST_ASSERT_TRUE(rtc.refresh());
+    TEST_ASSERT_TRUE(rtc.getAlarmFlags(flags));
+    TEST_ASSERT_EQUAL_HEX8(0, flags);
+
+    model->fireAlarm();
+    TEST_ASSERT_TRUE(model->interruptAsserted());
+    TEST_ASSERT_TRUE(rtc.refresh());
+    TEST_ASSERT_TRUE(rtc.getAlarmFlags(flags));
+    TEST_ASSERT_EQUAL_HEX8(MAX31328_STAT_A1F, flags);
+
+    TEST_ASSERT_TRUE(rtc.disableAlarms());
+    TEST_ASSERT_FALSE(model->interruptAsserted());
+    TEST_ASSERT_BITS_LOW(MAX31328_CTRL_A1IE | MAX31328_CTRL_A2IE, model->reg(MAX31328_REG_CONTROL));
+    TEST_ASSERT_TRUE(rtc.refresh());
+    TEST_ASSERT_TRUE(rtc.getAlarmFlags(flags));
+    TEST_ASSERT_EQUAL_HEX8(0, flags);
+
+    uint64_t us = 0;
+    TEST_ASSERT_FALSE(model->timeToAlarm(us));  // Sin A1IE no hay despertar
+}
+
+int main(int argc, char** argv) {
+    HAL::Native::init();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_alarm1_registers_match_full_date);
+    RUN_TEST(test_alarm1_clears_flag_before_enabling_interrupt);
+    RUN_TEST(test_alarm1_fires_at_target);
+    RUN_TEST(test_alarm_rolls_over_day_and_month);
+    RUN_TEST(test_alarm_rolls_over_year_and_leap_day);
+    RUN_TEST(test_alarm2_has_no_seconds_register);
+    RUN_TEST(test_invalid_alarm_number_writes_nothing);
+    RUN_TEST(test_flags_and_disable);
+    return UNITY_END();
+}
@@ -0,0 +1,11 @@
+/**
+ * @file StandInServer.cpp
+ * @brief Compila el servidor WebSocket simulado (sim/) dentro de esta suite.
+ * @details env:native no incluye sim/ en la compilación; así la suite corre el
+ *          mismo escenario que .pio/build/sim/program.
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include "../../../sim/StandInServer.cpp"
@@ -0,0 +1,11 @@
+/**
+ * @file firmware.cpp
+ * @brief Compila src/main.cpp (setup() y loop() del firmware) dentro de esta suite.
+ * @details pio test no compila src/ (test_build_src = no): cada ciclo simulado
+ *          ejecuta este setup() a través de HAL::Native::runCycle().
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include "../../../src/main.cpp"
@@ -0,0 +1,97 @@
+/**
+ * @file test_main.cpp
+ * @brief Presupuestos de la sección [sim] de perf_budgets.ini sobre el simulador.
+ * @details Corre el escenario de referencia de perf_budgets.ini (un equipo,
+ *          --days 2 --seed 1, sin fallas) con Sim::simulateDevice() y compara
+ *          cada clave de [sim] con su límite: tiempo despierto, radio, bytes
+ *          enviados por lectura entregada, pérdidas y corriente media. Son
+ *          medidas en tiempo virtual: no dependen de la máquina que compila.
+ *
+ *              pio test -e native -f test_native/test_sim_budgets
+ * @author Daniel Acosta - Santiago Erazo
+ * @date 01/10/2025
+ * @version 1.0
+ */
+
+#include <unity.h>
+#include <Arduino.h>
+#include "PerfBudgets.h"
+#include "../../../sim/Simulation.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+// Escenario de perf_budgets.ini: .pio/build/sim/program --days 2 --seed 1
+#define SIM_BUDGET_DAYS   2.0
+#define SIM_BUDGET_SEED   1
+
+static Sim::Summary summary;
+static bool deviceOk;
+static const char* currentKey;  ///< Clave que verifica test_key_within_budget()
+
+void setUp() {}
+void tearDown() {}
+
+/**
+ * @brief Corre el escenario sin la salida del firmware (LOG_LEVEL=3 en env:native)
+ */
+static void simulate() {
+    Sim::Scenario sc;
+    Sim::defaultScenario(sc);
+    sc.days = SIM_BUDGET_DAYS;
+    sc.seed = SIM_BUDGET_SEED;
+
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    int null = open("/dev/null", O_WRONLY);
+    if (null >= 0) dup2(null, STDOUT_FILENO);
+
+    Sim::Metrics m;
+    deviceOk = Sim::simulateDevice(sc, 0, m);
+
+    fflush(stdout);
+    if (saved >= 0) dup2(saved, STDOUT_FILENO);
+    if (null >= 0) close(null);
+    if (saved >= 0) close(saved);
+
+    Sim::summarize(m, summary);
+}
+
+// ——— Escenario ———
+
+void test_device_keeps_a_wake_source() {
+    TEST_ASSERT_TRUE_MESSAGE(deviceOk, "Deep sleep sin fuente de despertar");
+}
+
+void test_awake_and_bytes_are_budgeted() {
+    // Borrarlas de perf_budgets.ini dejaría pasar la suite sin verificar el ciclo
+    double limit = 0;
+    TEST_ASSERT_TRUE(PerfBudgets::lookup(PerfBudgets::SIM, "awake_mean_s", limit));
+    TEST_ASSERT_TRUE(PerfBudgets::lookup(PerfBudgets::SIM, "awake_max_s", limit));
+    TEST_ASSERT_TRUE(PerfBudgets::lookup(PerfBudgets::SIM, "bytes_sent_per_delivered", limit));
+}
+
+// ——— Claves ———
+
+void test_key_within_budget() {
+    double limit = 0, value = 0;
+    PerfBudgets::lookup(PerfBudgets::SIM, currentKey, limit);
+    TEST_ASSERT_TRUE_MESSAGE(Sim::summaryValue(summary, currentKey, value),
+                             "Clave de [sim] que el simulador no reporta");
+
+    char message[96];
+    snprintf(message, sizeof(message), "%.4g, límite %.4g", value, limit);
+    TEST_ASSERT_TRUE_MESSAGE(value <= limit, message);
+}
+
+int main(int argc, char** argv) {
+    simulate();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_device_keeps_a_wake_source);
+    RUN_TEST(test_awake_and_bytes_are_budgeted);
+    for (const PerfBudgets::Budget* b = PerfBudgets::SIM; b->name; b++) {
+        currentKey = b->name;
+        UnityDefaultTestRun(test_key_within_budget, currentKey, __LINE__);
+    }
+    return UNITY_END();
+}
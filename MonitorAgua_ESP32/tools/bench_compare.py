@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""
+@file bench_compare.py
+@brief Compara dos corridas de la suite de microbenchmarks (bench/main.cpp).
+@details Lee los JSON (esquema de Google Benchmark) de dos commits y muestra, por
+         caso, la mediana base, la nueva y la variación. En el equipo se compara en
+         ciclos si ambas corridas los tienen; en native, en ns.
+
+         Uso:
+             python tools/bench_compare.py base.json nuevo.json
+             python tools/bench_compare.py base.json nuevo.json --fail-above 5
+
+         Con --fail-above el código de salida es 1 si algún caso empeora más que
+         ese porcentaje (útil para bloquear regresiones).
+
+@author Daniel Acosta - Santiago Erazo
+@date 01/10/2025
+@version 1.0
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    """Devuelve (contexto, {nombre: caso}) de una corrida."""
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    # La captura del puerto serie puede traer líneas antes del JSON
+    start = text.find("{")
+    if start < 0:
+        sys.exit(f"{path}: no contiene JSON")
+    data = json.loads(text[start:text.rfind("}") + 1])
+    return data.get("context", {}), {b["name"]: b for b in data.get("benchmarks", [])}
+
+
+def metric(case, use_cycles):
+    return case.get("cycles_per_iteration", 0.0) if use_cycles else case["real_time"]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compara dos corridas de microbenchmarks")
+    parser.add_argument("base", help="JSON de referencia")
+    parser.add_argument("new", help="JSON a comparar")
+    parser.add_argument("--fail-above", type=float, metavar="PCT",
+                        help="salir con 1 si algún caso empeora más de PCT %%")
+    args = parser.parse_args()
+
+    base_ctx, base = load(args.base)
+    new_ctx, new = load(args.new)
+    if base_ctx.get("platform") != new_ctx.get("platform"):
+        print(f"Aviso: plataformas distintas ({base_ctx.get('platform')} vs {new_ctx.get('platform')})")
+
+    use_cycles = base_ctx.get("cpu_mhz", 0) > 0 and new_ctx.get("cpu_mhz", 0) > 0
+    unit = "ciclos" if use_cycles else "ns"
+
+    width = max((len(n) for n in base), default=10)
+    print(f"{'caso':<{width}}  {'base':>12}  {'nuevo':>12}  {'cambio':>8}   ({unit}/iteración)")
+
+    worst = 0.0
+    for name, b in base.items():
+        if name not in new:
+            print(f"{name:<{width}}  {metric(b, use_cycles):>12.1f}  {'-':>12}  {'-':>8}")
+            continue
+        before = metric(b, use_cycles)
+        after = metric(new[name], use_cycles)
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+        worst = max(worst, change)
+        print(f"{name:<{width}}  {before:>12.1f}  {after:>12.1f}  {change:>+7.1f}%")
+
+    for name in new:
+        if name not in base:
+            print(f"{name:<{width}}  {'-':>12}  {metric(new[name], use_cycles):>12.1f}  {'nuevo':>8}")
+
+    if args.fail_above is not None and worst > args.fail_above:
+        print(f"\nRegresión: {worst:+.1f}% > {args.fail_above}%")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
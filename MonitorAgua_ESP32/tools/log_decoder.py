@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""
+@file log_decoder.py
+@brief Decodificador en host del logging binario diferido (LOG_MODE_BINARY).
+@details Lee una captura cruda del puerto serie (archivo o puerto) y reconstruye
+         las líneas de texto. Las direcciones de formato y etiqueta se resuelven
+         contra el ELF del firmware (.pio/build/<env>/firmware.elf).
+
+         Formato de registro (ver lib/Logger/Logger.cpp):
+         | 0xA5 | nivel | len | t_ms u32 | tag u32 | fmt u32 | args[len] | suma u8 |
+
+         Uso:
+             python tools/log_decoder.py firmware.elf captura.bin
+             python tools/log_decoder.py firmware.elf /dev/ttyUSB0 --baud 115200
+
+@author Daniel Acosta - Santiago Erazo
+@date 01/10/2025
+@version 1.0
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+try:
+    from elftools.elf.elffile import ELFFile
+except ImportError:
+    sys.exit("Se requiere pyelftools: pip install pyelftools")
+
+SYNC = 0xA5
+HEADER = 15
+LEVELS = {1: "E", 2: "W", 3: "I", 4: "D"}
+
+# Especificador printf: flags, ancho, precisión, longitud, conversión
+SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?([diuxXocfFeEgGaAsp%])")
+
+
+class StringTable:
+    """Resuelve direcciones de literales usando las secciones cargables del ELF."""
+
+    def __init__(self, elf_path):
+        self.sections = []
+        with open(elf_path, "rb") as f:
+            elf = ELFFile(f)
+            for sec in elf.iter_sections():
+                if sec["sh_addr"] and sec["sh_type"] == "SHT_PROGBITS":
+                    self.sections.append((sec["sh_addr"], sec.data()))
+        self.cache = {}
+
+    def get(self, addr):
+        if addr in self.cache:
+            return self.cache[addr]
+        for base, data in self.sections:
+            if base <= addr < base + len(data):
+                off = addr - base
+                end = data.find(b"\0", off)
+                text = data[off:end if end >= 0 else len(data)].decode("utf-8", "replace")
+                self.cache[addr] = text
+                return text
+        return None
+
+
+def decode_args(fmt, payload):
+    """Aplica las mismas reglas de tipo que Logger::encodeArgs()."""
+    values = []
+    pos = 0
+    py_fmt = []
+    last = 0
+
+    for m in SPEC.finditer(fmt):
+        flags, width, prec, length, conv = m.groups()
+        py_fmt.append(fmt[last:m.start()].replace("%", "%%"))
+        last = m.end()
+        if conv == "%":
+            py_fmt.append("%%")
+            continue
+
+        for star in (width, prec):
+            if star == "*":
+                values.append(struct.unpack_from("<i", payload, pos)[0])
+                pos += 4
+
+        if conv in "diuxXoc":
+            if length in ("ll", "j"):
+                raw = struct.unpack_from("<Q", payload, pos)[0]
+                pos += 8
+                bits = 64
+            else:
+                raw = struct.unpack_from("<I", payload, pos)[0]
+                pos += 4
+                bits = 32
+            if conv in "di" and raw >= 1 << (bits - 1):
+                raw -= 1 << bits
+            values.append(raw)
+            conv = "d" if conv in "iu" else conv
+        elif conv in "fFeEgGaA":
+            values.append(struct.unpack_from("<f", payload, pos)[0])
+            pos += 4
+            conv = "f" if conv in "aA" else conv
+        elif conv == "p":
+            values.append(struct.unpack_from("<I", payload, pos)[0])
+            pos += 4
+            py_fmt.append("0x")
+            conv = "x"
+        elif conv == "s":
+            n = payload[pos]
+            values.append(payload[pos + 1:pos + 1 + n].decode("utf-8", "replace"))
+            pos += 1 + n
+
+        spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "") + conv
+        py_fmt.append(spec)
+
+    py_fmt.append(fmt[last:].replace("%", "%%"))
+    return "".join(py_fmt) % tuple(values)
+
+
+def records(stream, follow=False):
+    """Genera registros válidos resincronizando con el byte 0xA5 y la suma."""
+    buf = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            if follow:
+                continue
+            break
+        buf.extend(chunk)
+        while True:
+            start = buf.find(bytes([SYNC]))
+            if start < 0:
+                buf.clear()
+                break
+            del buf[:start]
+            if len(buf) < HEADER:
+                break
+            length = buf[2]
+            total = HEADER + length + 1
+            if len(buf) < total:
+                break
+            if (sum(buf[1:total - 1]) & 0xFF) != buf[total - 1]:
+                del buf[0]
+                continue
+            yield bytes(buf[:total])
+            del buf[:total]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decodificador de logs binarios MonitorAgua")
+    parser.add_argument("elf", help="firmware.elf del build que generó la captura")
+    parser.add_argument("source", help="archivo de captura o puerto serie")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    table = StringTable(args.elf)
+
+    follow = args.source.startswith("/dev/") or args.source.upper().startswith("COM")
+    if follow:
+        import serial
+        stream = serial.Serial(args.source, args.baud, timeout=1)
+    else:
+        stream = open(args.source, "rb")
+
+    for rec in records(stream, follow):
+        level, length = rec[1], rec[2]
+        t_ms, tag_addr, fmt_addr = struct.unpack_from("<III", rec, 3)
+        payload = rec[HEADER:HEADER + length]
+        tag = table.get(tag_addr) or "0x%08X" % tag_addr
+        fmt = table.get(fmt_addr)
+        if fmt is None:
+            text = "<formato desconocido 0x%08X> %s" % (fmt_addr, payload.hex())
+        else:
+            try:
+                text = decode_args(fmt, payload)
+            except (struct.error, IndexError, TypeError, ValueError):
+                text = "<argumentos truncados> " + fmt
+        print("%10u [%s][%s]%s" % (t_ms, LEVELS.get(level, "?"), tag, text))
+
+
+if __name__ == "__main__":
+    main()
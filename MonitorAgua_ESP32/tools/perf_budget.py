@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""
+@file perf_budget.py
+@brief Verifica los presupuestos de rendimiento de perf_budgets.ini.
+@details Lee el JSON de la suite de microbenchmarks (bench/main.cpp) y/o el
+         resumen del simulador (sim/main.cpp --json) y los compara con los límites.
+         Cada límite es un máximo; un caso presupuestado que falta en la corrida
+         también falla (se borró o se renombró sin actualizar el archivo).
+
+         Uso:
+             python tools/perf_budget.py --bench bench.json --sim sim.json
+             python tools/perf_budget.py --bench captura_serie.txt
+
+         El código de salida es 1 si se pasa algún límite.
+
+@author Daniel Acosta - Santiago Erazo
+@date 01/10/2025
+@version 1.0
+"""
+
+import argparse
+import configparser
+import json
+import pathlib
+import sys
+
+DEFAULT_BUDGETS = pathlib.Path(__file__).resolve().parent.parent / "perf_budgets.ini"
+
+
+def load_budgets(path):
+    parser = configparser.ConfigParser(inline_comment_prefixes=(";",))
+    parser.optionxform = str  # Los nombres de caso distinguen mayúsculas
+    if not parser.read(path, encoding="utf-8"):
+        sys.exit(f"{path}: no se pudo leer")
+    return {section: {k: float(v) for k, v in parser[section].items()} for section in parser.sections()}
+
+
+def load_json(path):
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    # La captura del puerto serie puede traer líneas antes del JSON
+    start = text.find("{")
+    if start < 0:
+        sys.exit(f"{path}: no contiene JSON")
+    return json.loads(text[start:text.rfind("}") + 1])
+
+
+def check(rows, section, limits, measured):
+    """Agrega una fila por límite: (sección, clave, medido, límite, ok)."""
+    for key, limit in limits.items():
+        value = measured.get(key)
+        rows.append((section, key, value, limit, value is not None and value <= limit))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Verifica los presupuestos de rendimiento")
+    parser.add_argument("--budgets", default=DEFAULT_BUDGETS, help="archivo de límites (perf_budgets.ini)")
+    parser.add_argument("--bench", help="JSON de bench/ (native_bench o capturado del equipo)")
+    parser.add_argument("--sim", help="resumen de sim/ (--json)")
+    args = parser.parse_args()
+    if not args.bench and not args.sim:
+        parser.error("indicar --bench y/o --sim")
+
+    budgets = load_budgets(args.budgets)
+    rows = []
+
+    if args.bench:
+        data = load_json(args.bench)
+        on_target = data.get("context", {}).get("cpu_mhz", 0) > 0
+        cases = {b["name"]: b for b in data.get("benchmarks", [])}
+        if on_target:
+            check(rows, "bench.cycles", budgets.get("bench.cycles", {}),
+                  {n: c.get("cycles_per_iteration") for n, c in cases.items()})
+        else:
+            check(rows, "bench.native_ns", budgets.get("bench.native_ns", {}),
+                  {n: c.get("real_time") for n, c in cases.items()})
+        check(rows, "bench.allocs", budgets.get("bench.allocs", {}),
+              {n: c.get("allocs_per_iteration") for n, c in cases.items()})
+
+    if args.sim:
+        check(rows, "sim", budgets.get("sim", {}), load_json(args.sim))
+
+    width = max((len(key) for _, key, _, _, _ in rows), default=10)
+    failures = [r for r in rows if not r[4]]
+    current = None
+    for section, key, value, limit, ok in rows:
+        if section != current:
+            print(f"\n[{section}]")
+            current = section
+        shown = "sin medición" if value is None else f"{value:.4g}"
+        print(f"  {key:<{width}}  {shown:>12}  ≤ {limit:<10.4g}  {'ok' if ok else 'EXCEDIDO'}")
+
+    if failures:
+        print(f"\n*** {len(failures)} PRESUPUESTO(S) EXCEDIDO(S) ***")
+        for section, key, value, limit, _ in failures:
+            shown = "sin medición" if value is None else f"{value:.4g}"
+            print(f"  [{section}] {key}: {shown} > {limit:.4g}")
+        return 1
+    print(f"\n{len(rows)} presupuestos cumplidos")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
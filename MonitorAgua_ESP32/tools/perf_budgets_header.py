@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""
+@file perf_budgets_header.py
+@brief Genera PerfBudgets.h a partir de perf_budgets.ini.
+@details Script previo de PlatformIO (extra_scripts = pre:...): escribe el
+         encabezado en $BUILD_DIR/generated y agrega ese directorio a CPPPATH,
+         para que las suites test_perf_budgets y test_sim_budgets comparen contra
+         los mismos límites que tools/perf_budget.py sin copiarlos a mano. Solo
+         reescribe el archivo si el contenido cambió (no fuerza recompilaciones).
+
+         También se puede ejecutar suelto:
+             python tools/perf_budgets_header.py [perf_budgets.ini] [SALIDA.h]
+
+@author Daniel Acosta - Santiago Erazo
+@date 01/10/2025
+@version 1.0
+"""
+
+import configparser
+import os
+import sys
+
+# Sección del .ini -> tabla del encabezado
+TABLES = (
+    ("bench.native_ns", "NATIVE_NS"),
+    ("bench.cycles", "CYCLES"),
+    ("bench.allocs", "ALLOCS"),
+    ("sim", "SIM"),
+)
+
+
+def load(path):
+    parser = configparser.ConfigParser(inline_comment_prefixes=(";",))
+    parser.optionxform = str  # Los nombres de caso distinguen mayúsculas
+    if not parser.read(path, encoding="utf-8"):
+        raise SystemExit(f"{path}: no se pudo leer")
+    return parser
+
+
+def render(parser):
+    out = [
+        "// Generado por tools/perf_budgets_header.py desde perf_budgets.ini: no editar",
+        "#ifndef PERF_BUDGETS_H",
+        "#define PERF_BUDGETS_H",
+        "",
+        "#include <string.h>",
+        "",
+        "namespace PerfBudgets {",
+        "",
+        "    typedef struct {",
+        "        const char* name;",
+        "        double limit;",
+        "    } Budget;",
+        "",
+    ]
+    for section, table in TABLES:
+        out.append(f"    // [{section}]")
+        out.append(f"    static const Budget {table}[] = {{")
+        if parser.has_section(section):
+            for name, value in parser[section].items():
+                out.append(f"        {{\"{name}\", {float(value)!r}}},")
+        out.append("        {nullptr, 0}")
+        out.append("    };")
+        out.append("")
+    out += [
+        "    /**",
+        "     * @brief Límite de un caso en una tabla",
+        "     * @return false si el caso no tiene límite",
+        "     */",
+        "    inline bool lookup(const Budget* table, const char* name, double& limit) {",
+        "        for (; table->name; table++) {",
+        "            if (strcmp(table->name, name) == 0) {",
+        "                limit = table->limit;",
+        "                return true;",
+        "            }",
+        "        }",
+        "        return false;",
+        "    }",
+        "",
+        "} // namespace PerfBudgets",
+        "",
+        "#endif // PERF_BUDGETS_H",
+        "",
+    ]
+    return "\n".join(out)
+
+
+def write_if_changed(path, text):
+    try:
+        with open(path, encoding="utf-8") as f:
+            if f.read() == text:
+                return
+    except OSError:
+        pass
+    os.makedirs(os.path.dirname(path) or ".", exist_ok=True)
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(text)
+
+
+try:
+    Import("env")  # noqa: F821 (lo define SCons)
+except NameError:
+    env = None
+
+if env is not None:
+    # Bajo SCons no existe __file__: las rutas salen del proyecto
+    source = os.path.join(env.subst("$PROJECT_DIR"), "perf_budgets.ini")
+    generated = os.path.join(env.subst("$BUILD_DIR"), "generated")
+    write_if_changed(os.path.join(generated, "PerfBudgets.h"), render(load(source)))
+    env.Append(CPPPATH=[generated])
+elif __name__ == "__main__":
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    source = sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, "perf_budgets.ini")
+    target = sys.argv[2] if len(sys.argv) > 2 else "PerfBudgets.h"
+    write_if_changed(target, render(load(source)))
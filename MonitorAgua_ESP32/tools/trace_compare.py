@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""
+@file trace_compare.py
+@brief Compara dos reproducciones de las mismas trazas de sensores (replay/main.cpp).
+@details Une las lecturas por (traza, sensor, índice) y muestra, por sensor, la
+         diferencia media y máxima del valor, cuántas lecturas cambiaron de válida a
+         inválida (o al revés) y el tiempo de CPU medio de cada corrida. El tiempo es
+         del anfitrión: sirve para comparar dos versiones, no como tiempo del ESP32.
+
+         Uso:
+             python tools/trace_compare.py base.csv nuevo.csv
+             python tools/trace_compare.py base.csv nuevo.csv --max-delta ph=0.05 tds=2
+
+         Con --max-delta el código de salida es 1 si la diferencia máxima de algún
+         sensor supera su tolerancia o si alguna lectura cambió de validez.
+
+@author Daniel Acosta - Santiago Erazo
+@date 01/10/2025
+@version 1.0
+"""
+
+import argparse
+import csv
+import sys
+
+
+def load(path):
+    """Devuelve {(tag, sensor, índice): fila} de una reproducción."""
+    with open(path, newline="", encoding="utf-8") as f:
+        return {(row["tag"], row["sensor"], row["index"]): row for row in csv.DictReader(f)}
+
+
+def parse_limits(items):
+    limits = {}
+    for item in items or []:
+        sensor, _, value = item.partition("=")
+        if not value:
+            sys.exit(f"--max-delta: se esperaba sensor=valor, no '{item}'")
+        limits[sensor] = float(value)
+    return limits
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compara dos reproducciones de trazas")
+    parser.add_argument("base", help="CSV de referencia")
+    parser.add_argument("new", help="CSV a comparar")
+    parser.add_argument("--max-delta", nargs="+", metavar="SENSOR=VALOR",
+                        help="salir con 1 si la diferencia máxima de un sensor supera VALOR")
+    args = parser.parse_args()
+    limits = parse_limits(args.max_delta)
+
+    base = load(args.base)
+    new = load(args.new)
+
+    stats = {}
+    for key, b in base.items():
+        n = new.get(key)
+        if n is None:
+            continue
+        s = stats.setdefault(key[1], {"count": 0, "delta_sum": 0.0, "delta_max": 0.0, "compared": 0,
+                                      "flips": 0, "cpu_base": 0.0, "cpu_new": 0.0})
+        s["count"] += 1
+        s["cpu_base"] += float(b["cpu_us"])
+        s["cpu_new"] += float(n["cpu_us"])
+        if b["valid"] != n["valid"]:
+            s["flips"] += 1
+        elif b["valid"] == "1":
+            delta = abs(float(n["value"]) - float(b["value"]))
+            s["compared"] += 1
+            s["delta_sum"] += delta
+            s["delta_max"] = max(s["delta_max"], delta)
+
+    missing = len(base.keys() - new.keys()) + len(new.keys() - base.keys())
+    if missing:
+        print(f"Aviso: {missing} lecturas están en una sola corrida (¿trazas distintas?)")
+
+    print(f"{'sensor':<12}  {'lecturas':>8}  {'|Δ| medio':>10}  {'|Δ| máx':>10}  {'validez':>7}"
+          f"  {'CPU base':>9}  {'CPU nuevo':>9}  {'cambio':>8}   (µs/lectura)")
+
+    failed = False
+    for sensor, s in stats.items():
+        mean = s["delta_sum"] / s["compared"] if s["compared"] else 0.0
+        before = s["cpu_base"] / s["count"]
+        after = s["cpu_new"] / s["count"]
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+        print(f"{sensor:<12}  {s['count']:>8}  {mean:>10.4g}  {s['delta_max']:>10.4g}  {s['flips']:>7}"
+              f"  {before:>9.1f}  {after:>9.1f}  {change:>+7.1f}%")
+        if args.max_delta is not None and (s["flips"] or s["delta_max"] > limits.get(sensor, float("inf"))):
+            failed = True
+
+    if failed:
+        print("\nFuera de tolerancia")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
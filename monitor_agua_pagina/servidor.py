@@ -10,9 +10,16 @@ import datetime as dt
 import socket
 import csv
 import os
+import io
+import base64
+import struct
+import sqlite3
 from pathlib import Path
+from urllib.parse import urlparse, parse_qs
 from http.server import HTTPServer, SimpleHTTPRequestHandler
 import threading
+import queue
+import time
 import webbrowser
 from collections import deque
 
@@ -20,9 +27,234 @@ from collections import deque
 WEBSOCKET_PORT = 8765
 HTTP_PORT = 8080
 CSV_FILENAME = "datos_calidad_agua.csv"
+CSV_FIELDS = [
+    'timestamp_recepcion', 'device_id', 'timestamp_esp32', 
+    'rtc_timestamp', 'datetime_rtc', 'rtc_datetime_esp32',
+    'reading_number', 'sequence', 'temperature', 'ph', 
+    'turbidity', 'tds', 'ec', 'sensor_status', 'valid', 
+    'health_score', 'rssi', 'free_heap'
+]
+CSV_FLUSH_ROWS = 256      # Filas acumuladas que fuerzan escritura a disco
+CSV_FLUSH_SECONDS = 2.0   # Tiempo máximo que una fila espera en el búfer
+SUMMARY_PUSH_EVERY = 10   # Lecturas entre envíos del resumen en vivo al navegador
+SESSION_PAGE_SIZE = 200   # Lecturas por página de request_session_data
+SESSION_PAGE_MAX = 2000   # Tope de page_size que puede pedir el navegador
+
+# Sensor -> condición de lectura válida para el resumen de sesión
+SUMMARY_FILTERS = {
+    'temperature': lambda v: bool(v),
+    'ph': lambda v: v > 0,
+    'turbidity': lambda v: v >= 0,
+    'tds': lambda v: v >= 0,
+}
+TRACE_MAGIC = 0x31545157  # "WQT1": cabecera de cada traza (HAL_TRACE_FILE_MAGIC en Trace.h)
 
 SCRIPT_DIR = Path(__file__).parent.absolute()  # Directorio donde está servidor.py
 WEB_DIR = SCRIPT_DIR / "web_interface"  # web_interface junto a servidor.py
+TRACES_DIR = SCRIPT_DIR / "traces"  # Trazas de sensores (firmware con -D HAL_TRACE)
+DB_PATH = SCRIPT_DIR / "mediciones.db"  # Serie temporal indexada (SQLite)
+
+class EscritorCSV:
+    """Escritor CSV de larga vida en un hilo propio.
+
+    El bucle asyncio solo encola filas; el hilo mantiene el archivo abierto
+    y vuelca a disco por tamaño (CSV_FLUSH_ROWS) o por tiempo
+    (CSV_FLUSH_SECONDS), de modo que la ingesta no bloquea los WebSockets.
+    """
+
+    _VACIAR = object()
+    _CERRAR = object()
+
+    def __init__(self, ruta):
+        self.ruta = ruta
+        self.cola = queue.Queue()
+        self.filas_escritas = 0
+        self.hilo = threading.Thread(target=self._ejecutar, name="escritor-csv", daemon=True)
+        self.hilo.start()
+
+    def escribir(self, fila):
+        """Encolar una fila (no bloquea)"""
+        self.cola.put(fila)
+
+    def vaciar(self):
+        """Pedir un volcado inmediato (p. ej. al terminar una descarga)"""
+        self.cola.put(self._VACIAR)
+
+    def cerrar(self, timeout=5.0):
+        """Volcar lo pendiente y cerrar el archivo"""
+        if self.hilo.is_alive():
+            self.cola.put(self._CERRAR)
+            self.hilo.join(timeout)
+
+    def _ejecutar(self):
+        pendientes = 0
+        limite = None
+        try:
+            with open(self.ruta, 'a', newline='', encoding='utf-8') as csvfile:
+                writer = csv.DictWriter(csvfile, fieldnames=CSV_FIELDS)
+                if csvfile.tell() == 0:
+                    writer.writeheader()
+                while True:
+                    espera = None if limite is None else max(0.0, limite - time.monotonic())
+                    try:
+                        item = self.cola.get(timeout=espera)
+                    except queue.Empty:
+                        item = self._VACIAR  # Venció CSV_FLUSH_SECONDS
+                    if item is self._CERRAR:
+                        break
+                    if item is not self._VACIAR:
+                        writer.writerow(item)
+                        pendientes += 1
+                        if limite is None:
+                            limite = time.monotonic() + CSV_FLUSH_SECONDS
+                        if pendientes < CSV_FLUSH_ROWS:
+                            continue
+                    if pendientes:
+                        csvfile.flush()
+                        self.filas_escritas += pendientes
+                        pendientes = 0
+                    limite = None
+                self.filas_escritas += pendientes
+        except Exception as e:
+            print(f" Error en escritor CSV: {e}")
+
+class AlmacenSeries:
+    """Serie temporal de lecturas en SQLite (WAL).
+
+    Clave única (device_id, sequence, reading_number): reenviar una descarga
+    actualiza las filas en lugar de duplicarlas. El índice
+    (device_id, rtc_timestamp) resuelve rangos de tiempo sin recorrer toda
+    la tabla. Escribe un solo hilo a la vez (candado); las consultas abren
+    su propia conexión y leen en paralelo gracias a WAL.
+    """
+
+    # Columna -> condición de lectura válida (mismos criterios que get_session_summary)
+    SENSORES = {
+        'temperature': 'temperature IS NOT NULL',
+        'ph': 'ph > 0',
+        'turbidity': 'turbidity >= 0',
+        'tds': 'tds >= 0',
+        'ec': 'ec >= 0',
+    }
+    COLUMNAS = ('device_id', 'sequence', 'reading_number', 'rtc_timestamp',
+                'temperature', 'ph', 'turbidity', 'tds', 'ec',
+                'sensor_status', 'valid', 'alarms', 'timestamp_recepcion')
+
+    def __init__(self, ruta):
+        self.ruta = ruta
+        self.lock = threading.Lock()
+        self.conexion = self.conectar()
+        self.conexion.executescript('''
+            CREATE TABLE IF NOT EXISTS lecturas (
+                device_id TEXT NOT NULL,
+                sequence INTEGER NOT NULL,
+                reading_number INTEGER NOT NULL,
+                rtc_timestamp INTEGER,
+                temperature REAL, ph REAL, turbidity REAL, tds REAL, ec REAL,
+                sensor_status INTEGER, valid INTEGER, alarms INTEGER,
+                timestamp_recepcion TEXT,
+                PRIMARY KEY (device_id, sequence, reading_number)
+            );
+            CREATE INDEX IF NOT EXISTS idx_lecturas_device_ts
+                ON lecturas (device_id, rtc_timestamp);
+        ''')
+
+    def conectar(self):
+        conexion = sqlite3.connect(self.ruta, check_same_thread=False, timeout=10)
+        conexion.execute('PRAGMA journal_mode=WAL')
+        conexion.execute('PRAGMA synchronous=NORMAL')
+        return conexion
+
+    @classmethod
+    def fila(cls, datos):
+        """Tupla de inserción a partir del JSON de una lectura"""
+        return (datos.get('device_id', 'Unknown'), datos.get('sequence', 0),
+                datos.get('reading_number', 0), datos.get('rtc_timestamp', 0),
+                datos.get('temperature'), datos.get('ph'), datos.get('turbidity'),
+                datos.get('tds'), datos.get('ec'), datos.get('sensor_status', 0),
+                int(bool(datos.get('valid', False))), datos.get('alarms', 0),
+                dt.datetime.now().isoformat())
+
+    def insertar_lote(self, filas):
+        """Upsert de un lote completo en una sola transacción"""
+        if not filas:
+            return 0
+        actualizar = ', '.join(f'{c}=excluded.{c}' for c in self.COLUMNAS[3:])
+        with self.lock, self.conexion:
+            self.conexion.executemany(
+                f'INSERT INTO lecturas ({", ".join(self.COLUMNAS)}) '
+                f'VALUES ({", ".join("?" * len(self.COLUMNAS))}) '
+                f'ON CONFLICT (device_id, sequence, reading_number) DO UPDATE SET {actualizar}',
+                filas)
+        return len(filas)
+
+    def consultar_rango(self, device_id, desde, hasta, limite=10000):
+        """Lecturas de un dispositivo con desde <= rtc_timestamp <= hasta"""
+        conexion = self.conectar()
+        try:
+            conexion.row_factory = sqlite3.Row
+            filas = conexion.execute(
+                f'SELECT {", ".join(self.COLUMNAS)} FROM lecturas '
+                'WHERE device_id = ? AND rtc_timestamp BETWEEN ? AND ? '
+                'ORDER BY rtc_timestamp LIMIT ?',
+                (device_id, desde, hasta, limite)).fetchall()
+            return [dict(f) for f in filas]
+        finally:
+            conexion.close()
+
+    def consultar_buckets(self, device_id, sensor, desde, hasta, bucket):
+        """Submuestreo en el servidor: min/max/avg de un sensor por intervalo de bucket segundos"""
+        if sensor not in self.SENSORES:
+            raise ValueError(f"Sensor desconocido: {sensor}")
+        bucket = max(1, int(bucket))
+        conexion = self.conectar()
+        try:
+            filas = conexion.execute(
+                f'SELECT (rtc_timestamp / ?) * ? AS t, COUNT(*), MIN({sensor}), MAX({sensor}), AVG({sensor}) '
+                f'FROM lecturas WHERE device_id = ? AND rtc_timestamp BETWEEN ? AND ? '
+                f'AND {self.SENSORES[sensor]} GROUP BY t ORDER BY t',
+                (bucket, bucket, device_id, desde, hasta)).fetchall()
+            return [{'t': t, 'count': n, 'min': mn, 'max': mx, 'avg': avg}
+                    for t, n, mn, mx, avg in filas]
+        finally:
+            conexion.close()
+
+    def cerrar(self):
+        with self.lock:
+            self.conexion.close()
+
+class AcumuladorSensor:
+    """Estadística incremental de un sensor: count, sum, min, max y varianza (Welford)"""
+
+    __slots__ = ('count', 'total', 'min', 'max', 'media', 'm2')
+
+    def __init__(self):
+        self.count = 0
+        self.total = 0.0
+        self.min = None
+        self.max = None
+        self.media = 0.0
+        self.m2 = 0.0
+
+    def agregar(self, valor):
+        self.count += 1
+        self.total += valor
+        self.min = valor if self.min is None or valor < self.min else self.min
+        self.max = valor if self.max is None or valor > self.max else self.max
+        delta = valor - self.media
+        self.media += delta / self.count
+        self.m2 += delta * (valor - self.media)
+
+    def resumen(self):
+        if not self.count:
+            return {"avg": 0, "min": 0, "max": 0, "std": 0, "count": 0}
+        return {
+            "avg": self.total / self.count,
+            "min": self.min,
+            "max": self.max,
+            "std": (self.m2 / (self.count - 1)) ** 0.5 if self.count > 1 else 0.0,
+            "count": self.count
+        }
 
 class ServidorMonitorAgua:
     def __init__(self):
@@ -34,27 +266,210 @@ class ServidorMonitorAgua:
         self.esperando_datos = False
         self.datos_solicitados = False
         self.ultima_lectura = None
+        self.reporte = None  # Metadatos del modo por banda muerta ("report" de sending_data)
+        self.ultima_real = {}  # device_id -> última lectura recibida (para reconstruir escalones)
         
         self.session_data = []  # Datos de la sesión actual
         self.session_start_time = None
-        self.sessions_file = WEB_DIR / "sessions_history.json"
+        self.reiniciar_resumen()
+        self.sessions_file = WEB_DIR / "sessions_history.json"  # Formato antiguo (se migra)
+        self.sessions_log = WEB_DIR / "sessions_log.jsonl"
+        self.sessions_index_file = WEB_DIR / "sessions_index.json"
         self.load_sessions_history()
 
         self.verificar_archivos_web()
         self.inicializar_csv()
+        self.almacen = AlmacenSeries(DB_PATH)
+        self.lote_sqlite = []  # Filas de la descarga en curso (se insertan en bloque)
+
+    # ——— Historial de sesiones (registro append-only + índice) ———
+    #
+    # sessions_log.jsonl guarda una sesión completa por línea y solo crece:
+    # guardar una sesión cuesta O(tamaño de la sesión). sessions_index.json
+    # guarda los metadatos (sin lecturas) y la posición de cada sesión en el
+    # registro; es lo único que se carga al arrancar. Eliminar escribe una
+    # lápida y la compactación en segundo plano recupera el espacio.
 
     def load_sessions_history(self):
-        """Cargar historial de sesiones desde archivo"""
+        """Cargar el índice del historial (las lecturas se leen bajo demanda)"""
+        self.historial_lock = threading.Lock()
+        self.compactando = False
+        self.sessions_index = []
+        self.sesion_cache = (None, None)  # Última sesión leída: (session_id, sesión)
+        self.log_bytes = 0
+        self.dead_bytes = 0
         try:
-            if self.sessions_file.exists():
-                with open(self.sessions_file, 'r', encoding='utf-8') as f:
-                    self.sessions_history = json.load(f)
-            else:
-                self.sessions_history = []
-            print(f" Cargadas {len(self.sessions_history)} sesiones del historial")
+            if self.sessions_index_file.exists():
+                with open(self.sessions_index_file, 'r', encoding='utf-8') as f:
+                    indice = json.load(f)
+                self.sessions_index = indice.get('sessions', [])
+                self.log_bytes = indice.get('log_bytes', 0)
+                self.dead_bytes = indice.get('dead_bytes', 0)
+                # Sesiones añadidas al registro tras el último índice (cierre abrupto)
+                if self.sessions_log.exists() and self.sessions_log.stat().st_size > self.log_bytes:
+                    self.escanear_registro(self.log_bytes)
+                    self.escribir_indice()
+            elif self.sessions_log.exists():
+                print(" Índice de sesiones ausente: reconstruyendo desde el registro")
+                self.escanear_registro(0)
+                self.escribir_indice()
+            elif self.sessions_file.exists():
+                self.migrar_historial_json()
+            print(f" Cargadas {len(self.sessions_index)} sesiones del historial")
         except Exception as e:
             print(f" Error cargando historial: {e}")
-            self.sessions_history = []
+            self.sessions_index = []
+
+    def escanear_registro(self, desde):
+        """Recorrer el registro desde un offset aplicando sesiones y lápidas"""
+        with open(self.sessions_log, 'rb') as f:
+            f.seek(desde)
+            offset = desde
+            for linea in f:
+                if not linea.endswith(b'\n'):
+                    break  # Línea truncada: se sobrescribe en el próximo guardado
+                try:
+                    registro = json.loads(linea)
+                except ValueError:
+                    registro = None
+                if registro is None:
+                    self.dead_bytes += len(linea)
+                elif 'tombstone' in registro:
+                    self.aplicar_lapida(registro['tombstone'])
+                    self.dead_bytes += len(linea)
+                else:
+                    self.sessions_index.append(self.entrada_indice(registro, offset, len(linea)))
+                offset += len(linea)
+            self.log_bytes = offset
+
+    def migrar_historial_json(self):
+        """Convertir el sessions_history.json monolítico al registro append-only"""
+        with open(self.sessions_file, 'r', encoding='utf-8') as f:
+            sesiones = json.load(f)
+        for session in sesiones:
+            self.anexar_sesion(session, indexar=False)
+        self.escribir_indice()
+        self.sessions_file.rename(self.sessions_file.with_suffix('.json.migrado'))
+        print(f" Historial migrado: {len(sesiones)} sesiones → {self.sessions_log.name}")
+
+    @staticmethod
+    def entrada_indice(session, offset, length):
+        """Metadatos de una sesión tal como se guardan en el índice"""
+        return {
+            "session_id": session.get('session_id'),
+            "start_time": session.get('start_time'),
+            "end_time": session.get('end_time'),
+            "total_readings": session.get('total_readings', 0),
+            "summary": session.get('summary', {}),
+            "offset": offset,
+            "length": length
+        }
+
+    def anexar_linea(self, registro):
+        """Añadir un registro al final del log; devuelve (offset, longitud)"""
+        linea = (json.dumps(registro, ensure_ascii=False, separators=(',', ':')) + '\n').encode('utf-8')
+        self.sessions_log.parent.mkdir(parents=True, exist_ok=True)
+        with open(self.sessions_log, 'ab') as f:
+            if f.tell() > self.log_bytes:
+                f.truncate(self.log_bytes)  # Descarta una línea a medias de un cierre abrupto
+                f.seek(self.log_bytes)
+            offset = f.tell()
+            f.write(linea)
+            f.flush()
+            os.fsync(f.fileno())
+        self.log_bytes = offset + len(linea)
+        return offset, len(linea)
+
+    def anexar_sesion(self, session, indexar=True):
+        """Añadir una sesión completa al registro y al índice"""
+        with self.historial_lock:
+            offset, length = self.anexar_linea(session)
+            self.sessions_index.append(self.entrada_indice(session, offset, length))
+            if indexar:
+                self.escribir_indice()
+
+    def escribir_indice(self):
+        """Reemplazar el índice de forma atómica (tmp + os.replace)"""
+        tmp = self.sessions_index_file.with_suffix('.tmp')
+        with open(tmp, 'w', encoding='utf-8') as f:
+            json.dump({
+                "log_bytes": self.log_bytes,
+                "dead_bytes": self.dead_bytes,
+                "sessions": self.sessions_index
+            }, f, ensure_ascii=False)
+        os.replace(tmp, self.sessions_index_file)
+
+    def aplicar_lapida(self, session_id):
+        """Quitar una sesión del índice contando sus bytes como espacio muerto"""
+        for i, entrada in enumerate(self.sessions_index):
+            if entrada['session_id'] == session_id:
+                self.dead_bytes += entrada['length']
+                return self.sessions_index.pop(i)
+        return None
+
+    def leer_sesion(self, session_id):
+        """Leer una sesión completa del registro (None si no existe)
+
+        La entrada del índice se resuelve bajo el candado, en el mismo paso que
+        la lectura: la compactación puede cambiar offsets entre dos llamadas.
+        """
+        with self.historial_lock:
+            entrada = next((e for e in self.sessions_index if e['session_id'] == session_id), None)
+            if entrada is None:
+                return None
+            with open(self.sessions_log, 'rb') as f:
+                f.seek(entrada['offset'])
+                return json.loads(f.read(entrada['length']))
+
+    def compactar_si_necesario(self):
+        """Lanzar la compactación cuando la mitad del registro es espacio muerto"""
+        if self.compactando or self.dead_bytes < 1024 * 1024 or self.dead_bytes * 2 < self.log_bytes:
+            return
+        self.compactando = True
+        threading.Thread(target=self.compactar_historial, daemon=True).start()
+
+    def compactar_historial(self):
+        """Reescribir el registro solo con las sesiones vivas (hilo en segundo plano)"""
+        tmp = self.sessions_log.with_suffix('.compactando')
+        try:
+            with self.historial_lock:
+                copia = list(self.sessions_index)
+            nuevas = {}
+            # Los offsets antiguos siguen siendo válidos: el registro solo crece
+            with open(self.sessions_log, 'rb') as origen, open(tmp, 'wb') as destino:
+                for entrada in copia:
+                    origen.seek(entrada['offset'])
+                    nuevas[entrada['session_id']] = (destino.tell(), entrada['length'])
+                    destino.write(origen.read(entrada['length']))
+
+                # Fase final bajo el candado: sesiones y lápidas llegadas mientras tanto
+                with self.historial_lock:
+                    vivas = {entrada['session_id'] for entrada in self.sessions_index}
+                    for session_id in nuevas.keys() - vivas:
+                        destino.write((json.dumps({"tombstone": session_id}) + '\n').encode('utf-8'))
+                    indice = []
+                    for entrada in self.sessions_index:
+                        if entrada['session_id'] in nuevas:
+                            offset, length = nuevas[entrada['session_id']]
+                        else:
+                            origen.seek(entrada['offset'])
+                            offset, length = destino.tell(), entrada['length']
+                            destino.write(origen.read(length))
+                        indice.append(dict(entrada, offset=offset, length=length))
+                    destino.flush()
+                    os.fsync(destino.fileno())
+                    antes = self.log_bytes
+                    os.replace(tmp, self.sessions_log)
+                    self.log_bytes = destino.tell()
+                    self.dead_bytes = sum(nuevas[s][1] for s in nuevas.keys() - vivas)
+                    self.sessions_index = indice
+                    self.escribir_indice()
+            print(f" Historial compactado: {antes} → {self.log_bytes} bytes")
+        except Exception as e:
+            print(f" Error compactando historial: {e}")
+            tmp.unlink(missing_ok=True)
+        finally:
+            self.compactando = False
     
     def save_session_to_history(self):
         """Guardar sesión actual al historial"""
@@ -67,86 +482,35 @@ class ServidorMonitorAgua:
             return
 
         print(f" Sesión válida con {len(self.session_data)} lecturas")
-        print(f" Sesiones existentes antes: {len(self.sessions_history)}")
+        print(f" Sesiones existentes antes: {len(self.sessions_index)}")
         
         
-        print(f" VERIFICANDO DATOS COMPLETOS:")
-        print(f"   - Primeras 5 lecturas: {[item.get('reading_number', '?') for item in self.session_data[:5]]}")
-        print(f"   - Últimas 5 lecturas: {[item.get('reading_number', '?') for item in self.session_data[-5:]]}")
-        print(f"   - Total items en session_data: {len(self.session_data)}")
-        
-        session_data_copy = []
-        for item in self.session_data:
-            session_data_copy.append(item.copy())  
-        
-        print(f"🔍 DESPUÉS DE COPIAR:")
-        print(f"   - Items copiados: {len(session_data_copy)}")
-        print(f"   - Primeras 3 copias: {[item.get('reading_number', '?') for item in session_data_copy[:3]]}")
-
-        # Crear nueva sesión
+        # Crear nueva sesión (session_data se reemplaza, no se muta, al iniciar otra)
         session = {
             "session_id": f"session_{int(dt.datetime.now().timestamp())}",
             "start_time": self.session_start_time,
             "end_time": dt.datetime.now().isoformat(),
-            "total_readings": len(session_data_copy), 
-            "data": session_data_copy,  
+            "total_readings": len(self.session_data), 
+            "report": self.reporte,
+            "data": self.session_data,  
             "summary": self.get_session_summary()
         }
 
         print(f" Session ID: {session['session_id']}")
         print(f" Período: {session['start_time']} → {session['end_time']}")
         print(f" Total lecturas en sesión: {session['total_readings']}")
-        print(f" Items reales en session['data']: {len(session['data'])}")
-        
-        # VERIFICAR QUE LOS DATOS ESTÉN COMPLETOS ANTES DE GUARDAR 
-        if len(session['data']) != len(self.session_data):
-            print(f" ERROR: Pérdida de datos en la copia!")
-            print(f"   Original: {len(self.session_data)} items")
-            print(f"   Copia: {len(session['data'])} items")
-            # Intentar recuperar
-            session['data'] = [item.copy() for item in self.session_data]
-            session['total_readings'] = len(session['data'])
-            print(f" Recuperación: {len(session['data'])} items")
-
-        # Agregar al historial
-        self.sessions_history.append(session)
-        print(f"✅ Sesión agregada al array. Total sesiones: {len(self.sessions_history)}")
-
-        # Guardar en archivo
+
+        # Añadir al registro (solo se escribe esta sesión y el índice)
         try:
-            # Verificar que el directorio existe
-            self.sessions_file.parent.mkdir(parents=True, exist_ok=True)
-            print(f"📁 Guardando en archivo: {self.sessions_file}")
-            
-            with open(self.sessions_file, 'w', encoding='utf-8') as f:
-                json.dump(self.sessions_history, f, indent=2, ensure_ascii=False)
-            
-            # Verificar que se guardó correctamente
-            if self.sessions_file.exists():
-                file_size = self.sessions_file.stat().st_size
-                print(f" Archivo guardado exitosamente ({file_size} bytes)")
-                
-                # VERIFICAR EL CONTENIDO DEL ARCHIVO 
-                try:
-                    with open(self.sessions_file, 'r', encoding='utf-8') as f:
-                        saved_data = json.load(f)
-                        last_session = saved_data[-1]
-                        print(f"VERIFICACIÓN DEL ARCHIVO:")
-                        print(f"   - Sesiones en archivo: {len(saved_data)}")
-                        print(f"   - Datos en última sesión: {len(last_session.get('data', []))}")
-                        print(f"   - Total_readings: {last_session.get('total_readings', 0)}")
-                except Exception as e:
-                    print(f" Error verificando archivo: {e}")
-            else:
-                print(f" El archivo no se creó correctamente")
-                
+            self.anexar_sesion(session)
+            print(f"✅ Sesión añadida a {self.sessions_log.name} ({self.log_bytes} bytes). Total sesiones: {len(self.sessions_index)}")
             print(f" SESIÓN GUARDADA COMPLETAMENTE")
             
             # Notificar a los navegadores conectados
             asyncio.create_task(self.broadcast_navegadores({
                 'type': 'session_saved',
                 'session_id': session['session_id'],
-                'total_sessions': len(self.sessions_history)
+                'total_sessions': len(self.sessions_index)
             }))
             
         except Exception as e:
@@ -156,46 +520,22 @@ class ServidorMonitorAgua:
 
         print(f"=== FIN GUARDADO DE SESIÓN ===\n")
     
+    def reiniciar_resumen(self):
+        """Acumuladores vacíos para una nueva sesión"""
+        self.acumuladores = {sensor: AcumuladorSensor() for sensor in SUMMARY_FILTERS}
+
+    def acumular_lectura(self, datos):
+        """Actualizar el resumen con una lectura (O(1), en procesar_datos_sensor)"""
+        for sensor, valido in SUMMARY_FILTERS.items():
+            valor = datos.get(sensor, 0)
+            if isinstance(valor, (int, float)) and valido(valor):
+                self.acumuladores[sensor].agregar(valor)
+
     def get_session_summary(self):
-        """Obtener resumen de la sesión actual"""
-        print(f" Calculando resumen para {len(self.session_data)} lecturas")
-    
+        """Obtener resumen de la sesión actual (desde los acumuladores)"""
         if not self.session_data:
-            print(" No hay datos para calcular resumen")
             return {}
-    
-        temps = [d.get('temperature', 0) for d in self.session_data if d.get('temperature')]
-        phs = [d.get('ph', 0) for d in self.session_data if d.get('ph', 0) > 0]
-        turbs = [d.get('turbidity', 0) for d in self.session_data if d.get('turbidity', 0) >= 0]
-        tds_vals = [d.get('tds', 0) for d in self.session_data if d.get('tds', 0) >= 0]
-    
-        print(f"    Datos válidos: Temp={len(temps)}, pH={len(phs)}, Turb={len(turbs)}, TDS={len(tds_vals)}")
-    
-        summary = {
-            "temperature": {
-                "avg": sum(temps) / len(temps) if temps else 0,
-                "min": min(temps) if temps else 0,
-                "max": max(temps) if temps else 0
-            },
-            "ph": {
-                "avg": sum(phs) / len(phs) if phs else 0,
-                "min": min(phs) if phs else 0,
-                "max": max(phs) if phs else 0
-            },
-            "turbidity": {
-                "avg": sum(turbs) / len(turbs) if turbs else 0,
-                "min": min(turbs) if turbs else 0,
-                "max": max(turbs) if turbs else 0
-            },
-            "tds": {
-                "avg": sum(tds_vals) / len(tds_vals) if tds_vals else 0,
-                "min": min(tds_vals) if tds_vals else 0,
-                "max": max(tds_vals) if tds_vals else 0
-            }
-        }
-    
-        print(f" Resumen calculado correctamente")
-        return summary    
+        return {sensor: acumulador.resumen() for sensor, acumulador in self.acumuladores.items()}
     
     def obtener_ip(self):
         """Obtiene la IP del PC"""
@@ -283,20 +623,14 @@ class ServidorMonitorAgua:
             print(f" Creando archivo CSV: {self.archivo_csv}")
             try:
                 with open(self.archivo_csv, 'w', newline='', encoding='utf-8') as csvfile:
-                    fieldnames = [
-                        'timestamp_recepcion', 'device_id', 'timestamp_esp32', 
-                        'rtc_timestamp', 'datetime_rtc', 'rtc_datetime_esp32',
-                        'reading_number', 'sequence', 'temperature', 'ph', 
-                        'turbidity', 'tds', 'ec', 'sensor_status', 'valid', 
-                        'health_score', 'rssi', 'free_heap'
-                    ]
-                    writer = csv.DictWriter(csvfile, fieldnames=fieldnames)
+                    writer = csv.DictWriter(csvfile, fieldnames=CSV_FIELDS)
                     writer.writeheader()
                 print(" Archivo CSV inicializado")
             except Exception as e:
                 print(f" Error creando CSV: {e}")
         else:
             print(f" Archivo CSV existente: {self.archivo_csv}")
+        self.escritor_csv = EscritorCSV(self.archivo_csv)
     
     async def manejar_conexion(self, websocket):
         """Maneja todas las conexiones WebSocket"""
@@ -322,9 +656,11 @@ class ServidorMonitorAgua:
 
         self.session_data = []  # Nueva sesión
         self.session_start_time = dt.datetime.now().isoformat()  
+        self.reiniciar_resumen()
+        self.reporte = None
 
         print(f"🔄 Nueva sesión iniciada: {self.session_start_time}")
-        print(f"📊 Sesiones totales antes: {len(self.sessions_history)}")
+        print(f"📊 Sesiones totales antes: {len(self.sessions_index)}")
         
         print(f"🌊 ESP32 CONECTADO desde: {client_ip}")
         print(f"⏰ Hora: {dt.datetime.now().strftime('%H:%M:%S')}")
@@ -345,8 +681,16 @@ class ServidorMonitorAgua:
 
                     if datos.get('action') in ['calibrate', 'get_calibration']:
                         await self.procesar_comando_calibracion(datos, websocket)
+                    elif 'calibration' in datos and 'status' in datos:
+                        # Respuesta del ESP32 a un comando de calibración
+                        await self.broadcast_navegadores(datos)
                     elif datos.get('action') == 'sending_data':
+                        self.reporte = datos.get('report')
                         await self.iniciar_descarga()
+                    elif datos.get('action') == 'sensor_trace':
+                        self.guardar_traza(datos)
+                    elif datos.get('action') == 'alert':
+                        await self.procesar_alerta(datos)
                     elif datos.get('device_id') == 'ESP32_WaterMonitor':
                         await self.procesar_datos_sensor(datos, websocket)
                     elif datos.get('action') == 'data_complete':
@@ -361,6 +705,7 @@ class ServidorMonitorAgua:
         except Exception as e:
             print(f" Error en ESP32: {e}")
         finally:
+            await self.guardar_lote_sqlite()
             self.save_session_to_history()
             self.conexion_esp32 = None
             await self.notificar_estado_esp32(False)
@@ -413,9 +758,22 @@ class ServidorMonitorAgua:
                         await self.solicitar_datos_esp32()
                     elif data.get('type') == 'request_sessions_history':
                         await self.enviar_historial_sesiones(websocket)
+                    elif data.get('type') == 'request_session_data':
+                        await self.enviar_pagina_sesion(websocket, data.get('session_id'),
+                                                        data.get('offset', 0),
+                                                        data.get('limit', SESSION_PAGE_SIZE),
+                                                        data.get('request_id'))
                     elif data.get('type') == 'delete_session':
                         await self.eliminar_sesion(websocket, data.get('session_id'))
-                    elif data.get('action') in ['calibrate', 'get_calibration']:
+                    elif data.get('type') == 'query_series':
+                        try:
+                            loop = asyncio.get_running_loop()
+                            respuesta = await loop.run_in_executor(None, self.consulta_series, data)
+                        except (ValueError, sqlite3.Error) as e:
+                            respuesta = {'type': 'series', 'error': str(e)}
+                        await websocket.send(json.dumps(respuesta))
+                    elif data.get('action') in ['calibrate', 'get_calibration',
+                                                'calib_point', 'calib_fit', 'calib_clear']:
                         # Reenviar comando de calibración al ESP32
                         if self.conexion_esp32:
                             print(f"📡 Reenviando comando de calibración al ESP32")
@@ -438,40 +796,79 @@ class ServidorMonitorAgua:
 
 
     async def enviar_historial_sesiones(self, websocket):
-        """Enviar historial de sesiones al navegador"""
+        """Enviar al navegador el índice de sesiones (sin lecturas)"""
         try:
+            sesiones = [{k: v for k, v in entrada.items() if k not in ('offset', 'length')}
+                        for entrada in self.sessions_index]
             await websocket.send(json.dumps({
                 'type': 'sessions_history',
-                'sessions': self.sessions_history
+                'sessions': sesiones
             }))
-            print(f" Enviado historial: {len(self.sessions_history)} sesiones")
+            print(f" Enviado índice de historial: {len(sesiones)} sesiones")
         except Exception as e:
             print(f" Error enviando historial: {e}")
+
+    async def enviar_pagina_sesion(self, websocket, session_id, offset=0, limit=SESSION_PAGE_SIZE,
+                                   request_id=None):
+        """Enviar una página de lecturas de una sesión (data[offset:offset+limit])
+
+        request_id se devuelve tal cual para que el navegador distinga las
+        respuestas de la vista de las de una exportación en curso.
+        """
+        try:
+            cache_id, session = self.sesion_cache
+            if cache_id != session_id:
+                # Las páginas siguientes (exportación) reutilizan la sesión ya leída
+                loop = asyncio.get_running_loop()
+                session = await loop.run_in_executor(None, self.leer_sesion, session_id)
+                if session is None:
+                    raise ValueError('Sesión no encontrada')
+                self.sesion_cache = (session_id, session)
+
+            datos = session.get('data', [])
+            offset = max(0, int(offset))
+            limit = max(1, min(int(limit), SESSION_PAGE_MAX))
+            await websocket.send(json.dumps({
+                'type': 'session_data',
+                'request_id': request_id,
+                'session_id': session_id,
+                'offset': offset,
+                'total': len(datos),
+                'readings': datos[offset:offset + limit]
+            }))
+        except Exception as e:
+            print(f" Error enviando página de sesión: {e}")
+            await websocket.send(json.dumps({
+                'type': 'session_data',
+                'request_id': request_id,
+                'session_id': session_id,
+                'error': str(e)
+            }))
     
     async def eliminar_sesion(self, websocket, session_id):
-        """Eliminar una sesión específica del historial"""
+        """Eliminar una sesión específica del historial (lápida + compactación)"""
         try:
-            # Buscar y eliminar la sesión
             sesion_encontrada = None
-            for i, session in enumerate(self.sessions_history):
-                if session.get('session_id') == session_id:
-                    sesion_encontrada = self.sessions_history.pop(i)
-                    break
+            with self.historial_lock:
+                if any(entrada['session_id'] == session_id for entrada in self.sessions_index):
+                    _, length = self.anexar_linea({"tombstone": session_id})
+                    sesion_encontrada = self.aplicar_lapida(session_id)
+                    if self.sesion_cache[0] == session_id:
+                        self.sesion_cache = (None, None)
+                    self.dead_bytes += length
+                    self.escribir_indice()
             
             if sesion_encontrada:
-                # Guardar historial actualizado
-                with open(self.sessions_file, 'w', encoding='utf-8') as f:
-                    json.dump(self.sessions_history, f, indent=2, ensure_ascii=False)
-                
                 print(f"🗑️ Sesión eliminada: {session_id}")
-                print(f"📊 Sesiones restantes: {len(self.sessions_history)}")
+                print(f"📊 Sesiones restantes: {len(self.sessions_index)}")
+                self.compactar_si_necesario()
                 
                 # Notificar éxito
                 await websocket.send(json.dumps({
                     'type': 'session_deleted',
                     'success': True,
                     'session_id': session_id,
-                    'total_sessions': len(self.sessions_history)
+                    'total_sessions': len(self.sessions_index)
                 }))
                 
                 # Enviar historial actualizado
@@ -529,13 +926,61 @@ class ServidorMonitorAgua:
         })
         print(" Iniciando recepción de datos...")
     
+    def reconstruir_escalones(self, datos):
+        """Lecturas sostenidas entre la anterior recibida y `datos` (modo banda muerta)
+
+        Con report.mode == "delta" el ESP32 omite las lecturas que no salen de la
+        banda muerta: el valor se mantiene hasta la siguiente lectura recibida. Se
+        agrega un paso por ciclo (cycle_s) copiando la anterior, marcado con
+        'reconstruida'. Un hueco de más de max_silent_cycles ciclos no es un valor
+        sostenido sino una pérdida de datos, y no se rellena. Al CSV solo van las
+        lecturas reales.
+        """
+        if not self.reporte or self.reporte.get('mode') != 'delta':
+            return []
+
+        t = datos.get('rtc_timestamp', 0)
+        if t <= 1609459200:  # Sin hora real no hay eje de tiempo que rellenar
+            return []
+
+        dispositivo = datos.get('device_id', 'Unknown')
+        anterior = self.ultima_real.get(dispositivo)
+        if anterior is not None and t <= anterior['rtc_timestamp']:
+            return []  # Reenvío de una lectura ya recibida
+        self.ultima_real[dispositivo] = datos
+        if anterior is None:
+            return []
+
+        ciclo = self.reporte.get('cycle_s', 0)
+        intervalos = round((t - anterior['rtc_timestamp']) / ciclo) if ciclo > 0 else 0
+        if intervalos < 2 or intervalos > self.reporte.get('max_silent_cycles', 0):
+            return []
+
+        pasos = []
+        for k in range(1, intervalos):
+            ts = anterior['rtc_timestamp'] + k * ciclo
+            fecha = dt.datetime.fromtimestamp(ts)
+            paso = dict(anterior, rtc_timestamp=ts, reconstruida=True,
+                        rtc_datetime=fecha.strftime('%Y-%m-%d %H:%M:%S'),
+                        rtc_date=fecha.strftime('%Y-%m-%d'),
+                        rtc_time=fecha.strftime('%H:%M:%S'))
+            pasos.append(paso)
+        return pasos
+
     async def procesar_datos_sensor(self, datos, websocket_esp32):
         """Procesa datos de sensores recibidos con RTC"""
+        for paso in self.reconstruir_escalones(datos):
+            self.session_data.append(paso)
+            self.acumular_lectura(paso)
+            await self.broadcast_navegadores(paso)
+
         self.datos_recibidos.append(datos)
         self.session_data.append(datos)
+        self.acumular_lectura(datos)
         self.total_mensajes += 1
     
         self.guardar_en_csv(datos)
+        self.lote_sqlite.append(AlmacenSeries.fila(datos))
     
         reading_num = datos.get('reading_number', '?')
         temp = datos.get('temperature', 0)
@@ -550,6 +995,8 @@ class ServidorMonitorAgua:
             print(f"   Lectura #{reading_num}: {temp:.1f}°C")
     
         await self.broadcast_navegadores(datos)
+        if self.total_mensajes % SUMMARY_PUSH_EVERY == 0:
+            await self.enviar_resumen_sesion()
     
         if self.esperando_datos:
             confirmacion = {
@@ -564,6 +1011,9 @@ class ServidorMonitorAgua:
         self.datos_solicitados = False
         
         print(f" Descarga completa: {total} lecturas recibidas")
+        self.escritor_csv.vaciar()
+        await self.guardar_lote_sqlite()
+        await self.enviar_resumen_sesion()
         
         await self.broadcast_navegadores({
             'type': 'download_complete',
@@ -571,6 +1021,47 @@ class ServidorMonitorAgua:
             'timestamp': dt.datetime.now().isoformat()  
         })
     
+    async def enviar_resumen_sesion(self):
+        """Enviar a los navegadores el resumen en vivo de la sesión"""
+        await self.broadcast_navegadores({
+            'type': 'session_summary',
+            'total_readings': len(self.session_data),
+            'summary': self.get_session_summary()
+        })
+
+    async def guardar_lote_sqlite(self):
+        """Insertar en SQLite las lecturas de la descarga (fuera del bucle asyncio)"""
+        lote, self.lote_sqlite = self.lote_sqlite, []
+        if not lote:
+            return
+        try:
+            loop = asyncio.get_running_loop()
+            n = await loop.run_in_executor(None, self.almacen.insertar_lote, lote)
+            print(f" SQLite: {n} lecturas guardadas en {DB_PATH.name}")
+        except Exception as e:
+            print(f" Error guardando en SQLite: {e}")
+
+    def consulta_series(self, params):
+        """Resolver una consulta de rango o de buckets (HTTP y WebSocket)"""
+        device_id = params.get('device_id', 'ESP32_WaterMonitor')
+        desde = int(params.get('desde', 0))
+        hasta = int(params.get('hasta', 2**31 - 1))
+        if params.get('bucket'):
+            return {
+                'type': 'series',
+                'device_id': device_id,
+                'sensor': params.get('sensor', 'ph'),
+                'bucket': int(params['bucket']),
+                'points': self.almacen.consultar_buckets(device_id, params.get('sensor', 'ph'),
+                                                         desde, hasta, params['bucket'])
+            }
+        return {
+            'type': 'readings',
+            'device_id': device_id,
+            'readings': self.almacen.consultar_rango(device_id, desde, hasta,
+                                                     int(params.get('limite', 10000)))
+        }
+
     async def notificar_estado_esp32(self, conectado):
         """Notifica a navegadores el estado del ESP32"""
         await self.broadcast_navegadores({
@@ -596,59 +1087,91 @@ class ServidorMonitorAgua:
             self.conexiones_web.discard(ws)
     
     def guardar_en_csv(self, datos):
-        """Guarda datos en CSV con timestamp RTC corregido"""
+        """Encola una fila CSV con timestamp RTC corregido (la escribe EscritorCSV)"""
         try:
-            with open(self.archivo_csv, 'a', newline='', encoding='utf-8') as csvfile:
-                fieldnames = [
-                    'timestamp_recepcion', 'device_id', 'timestamp_esp32', 
-                    'rtc_timestamp', 'datetime_rtc', 'rtc_datetime_esp32',
-                    'reading_number', 'sequence', 'temperature', 'ph', 
-                    'turbidity', 'tds', 'ec', 'sensor_status', 'valid', 
-                    'health_score', 'rssi', 'free_heap'
-                ]
-                writer = csv.DictWriter(csvfile, fieldnames=fieldnames)
-            
-                # Solo escribir headers si el archivo está vacío
-                csvfile.seek(0, 2)  
-                if csvfile.tell() == 0:
-                    writer.writeheader()
-            
-                rtc_timestamp = datos.get('rtc_timestamp', 0)
-                datetime_rtc = ""
-                
-                # CORRECCIÓN: El timestamp ya viene en hora local de Colombia
-                if rtc_timestamp > 1609459200:  # Timestamp válido
-                    # Usar directamente el timestamp (ya está en hora local)
-                    datetime_rtc = dt.datetime.fromtimestamp(rtc_timestamp).strftime('%Y-%m-%d %H:%M:%S')
-            
-                datos_csv = {
-                    'timestamp_recepcion': dt.datetime.now().isoformat(),
-                    'device_id': datos.get('device_id', 'Unknown'),
-                    'timestamp_esp32': datos.get('timestamp', 0),
-                    'rtc_timestamp': rtc_timestamp,
-                    'datetime_rtc': datetime_rtc,
-                    'rtc_datetime_esp32': datos.get('rtc_datetime', 'No disponible'),
-                    'reading_number': datos.get('reading_number', 0),
-                    'sequence': datos.get('sequence', 0),
-                    'temperature': datos.get('temperature', 0),
-                    'ph': datos.get('ph', 0),
-                    'turbidity': datos.get('turbidity', 0),
-                    'tds': datos.get('tds', 0),
-                    'ec': datos.get('ec', 0),
-                    'sensor_status': datos.get('sensor_status', 0),
-                    'valid': datos.get('valid', False),
-                    'health_score': datos.get('health_score', 0),
-                    'rssi': datos.get('rssi', 0),
-                    'free_heap': datos.get('free_heap', 0)
-                }
-            
-                writer.writerow(datos_csv)
+            rtc_timestamp = datos.get('rtc_timestamp', 0)
+            datetime_rtc = ""
             
+            # CORRECCIÓN: El timestamp ya viene en hora local de Colombia
+            if rtc_timestamp > 1609459200:  # Timestamp válido
+                # Usar directamente el timestamp (ya está en hora local)
+                datetime_rtc = dt.datetime.fromtimestamp(rtc_timestamp).strftime('%Y-%m-%d %H:%M:%S')
+        
+            datos_csv = {
+                'timestamp_recepcion': dt.datetime.now().isoformat(),
+                'device_id': datos.get('device_id', 'Unknown'),
+                'timestamp_esp32': datos.get('timestamp', 0),
+                'rtc_timestamp': rtc_timestamp,
+                'datetime_rtc': datetime_rtc,
+                'rtc_datetime_esp32': datos.get('rtc_datetime', 'No disponible'),
+                'reading_number': datos.get('reading_number', 0),
+                'sequence': datos.get('sequence', 0),
+                'temperature': datos.get('temperature', 0),
+                'ph': datos.get('ph', 0),
+                'turbidity': datos.get('turbidity', 0),
+                'tds': datos.get('tds', 0),
+                'ec': datos.get('ec', 0),
+                'sensor_status': datos.get('sensor_status', 0),
+                'valid': datos.get('valid', False),
+                'health_score': datos.get('health_score', 0),
+                'rssi': datos.get('rssi', 0),
+                'free_heap': datos.get('free_heap', 0)
+            }
+        
+            self.escritor_csv.escribir(datos_csv)
+        
         except Exception as e:
             print(f" Error guardando CSV: {e}")
     
+    async def procesar_alerta(self, datos):
+        """Reenvía a los navegadores una alerta de anomalía fuera de programa
+
+        La alerta no es una lectura de la sesión: la lectura con la misma alarma
+        llega con el resto en la próxima descarga (campo "alarms").
+        """
+        mascara = int(datos.get('alarms', 0))
+        nombres = ['temperatura', 'tds', 'turbidez', 'ph']
+        sensores = [n for i, n in enumerate(nombres) if mascara & (1 << i)]
+        ts = datos.get('rtc_timestamp', 0)
+        hora = dt.datetime.fromtimestamp(ts).strftime('%Y-%m-%d %H:%M:%S') if ts > 1609459200 else 'No disponible'
+        print(f"🚨 Alerta de anomalía ({', '.join(sensores) or 'sin sensor'}) a las {hora}")
+
+        await self.broadcast_navegadores({
+            'type': 'device_alert',
+            'alarms': mascara,
+            'sensors': sensores,
+            'rtc_timestamp': ts,
+            'rtc_datetime': hora,
+            'temperature': datos.get('temperature'),
+            'ph': datos.get('ph'),
+            'turbidity': datos.get('turbidity'),
+            'tds': datos.get('tds'),
+            'received_at': dt.datetime.now().isoformat()
+        })
+
+    def guardar_traza(self, datos):
+        """Agrega una traza de muestras crudas a traces/<device_id>.trace
+
+        Cada traza va precedida de la cabecera de Trace.h (magic, tag, longitud,
+        uint32 little-endian); replay/main.cpp del firmware las lee en orden.
+        """
+        try:
+            crudo = base64.b64decode(datos.get('data', ''))
+            tag = int(datos.get('tag', 0))
+            TRACES_DIR.mkdir(exist_ok=True)
+            archivo = TRACES_DIR / f"{datos.get('device_id', 'Unknown')}.trace"
+            with open(archivo, 'ab') as f:
+                f.write(struct.pack('<III', TRACE_MAGIC, tag, len(crudo)))
+                f.write(crudo)
+            aviso = " (truncada)" if datos.get('truncated') else ""
+            print(f"   Traza de sensores #{tag}: {len(crudo)} bytes{aviso} -> {archivo.name}")
+        except Exception as e:
+            print(f" Error guardando traza: {e}")
+
     def iniciar_servidor_http(self):
         """Inicia servidor HTTP que RESPETA archivos existentes"""
+        servidor = self
+
         class RespectfulHTTPRequestHandler(SimpleHTTPRequestHandler):
             def __init__(self, *args, **kwargs):
     
@@ -664,10 +1187,42 @@ class ServidorMonitorAgua:
             def do_GET(self):
                 if self.path == '/' or self.path == '':
                     self.path = '/index.html'
+                if self.path.startswith('/api/'):
+                    return self.responder_api()
                 
                 print(f" Sirviendo: {self.path}")
                 return super().do_GET()
         
+            def responder_api(self):
+                """/api/lecturas?device_id=&desde=&hasta=[&limite=][&formato=csv]
+                   /api/series?device_id=&sensor=&desde=&hasta=&bucket="""
+                url = urlparse(self.path)
+                params = {k: v[0] for k, v in parse_qs(url.query).items()}
+                if url.path == '/api/series' and not params.get('bucket'):
+                    params['bucket'] = 3600
+                elif url.path == '/api/lecturas':
+                    params.pop('bucket', None)
+                elif url.path != '/api/series':
+                    return self.send_error(404)
+                try:
+                    resultado = servidor.consulta_series(params)
+                except (ValueError, sqlite3.Error) as e:
+                    return self.send_error(400, str(e))
+
+                if params.get('formato') == 'csv' and 'readings' in resultado:
+                    salida = io.StringIO()
+                    writer = csv.DictWriter(salida, fieldnames=AlmacenSeries.COLUMNAS)
+                    writer.writeheader()
+                    writer.writerows(resultado['readings'])
+                    cuerpo, tipo = salida.getvalue().encode('utf-8'), 'text/csv; charset=utf-8'
+                else:
+                    cuerpo, tipo = json.dumps(resultado).encode('utf-8'), 'application/json'
+                self.send_response(200)
+                self.send_header('Content-Type', tipo)
+                self.send_header('Content-Length', str(len(cuerpo)))
+                self.end_headers()
+                self.wfile.write(cuerpo)
+
             def log_message(self, format, *args):
                 pass  # Suprimir logs HTTP normales
     
@@ -784,6 +1339,10 @@ async def main():
         print("\n\n Servidor detenido")
     except Exception as e:
         print(f"\n Error: {e}")
+    finally:
+        servidor.escritor_csv.cerrar()  # Volcar filas pendientes del búfer CSV
+        servidor.almacen.cerrar()
+        print(f" CSV cerrado ({servidor.escritor_csv.filas_escritas} filas escritas)")
 
 if __name__ == "__main__":
     try:
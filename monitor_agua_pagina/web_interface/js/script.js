@@ -9,13 +9,20 @@ class WaterMonitor {
         this.downloadInProgress = false;
         this.activeTab = 'temperature'; 
         this.tdsDisplayMode = 'tds';
-        this.sessionsHistory = [];
+        this.sessionsHistory = []; // Índice de sesiones (sin lecturas)
         this.currentSession = null;
+        this.sessionExport = null; // Exportación en curso: páginas acumuladas de la sesión
+        this.sessionRequests = new Map(); // request_id -> 'view' | 'export' (el servidor lo devuelve)
+        this.sessionRequestSeq = 0;
+        this.sessionPageSize = 200; // SESSION_PAGE_SIZE en servidor.py
+        this.sessionExportPageSize = 2000; // SESSION_PAGE_MAX en servidor.py
         this.sidebarOpen = false;
         // ═══════ AGREGAR ═══════
         this.currentCalibration = null;
         this.calibrationTabActive = false;
         // ═══════ FIN NUEVO ═══════
+        this.deviceAlerts = []; // Alertas de anomalía fuera de programa (device_alert)
+        this.liveSummary = null; // Resumen incremental enviado por el servidor (session_summary)
         this.init();
     }
     
@@ -183,6 +190,7 @@ class WaterMonitor {
         else if (data.type === 'download_start') {
             this.downloadInProgress = true;
             this.data = [];
+            this.liveSummary = null;
             this.updateDownloadStatus('Descargando datos...', 'loading');
         }
         else if (data.device_id === 'ESP32_WaterMonitor' && data.temperature !== undefined) {
@@ -196,6 +204,16 @@ class WaterMonitor {
             );
             this.finalizeDataDisplay();
         }
+        else if (data.type === 'session_summary') {
+            this.liveSummary = data.summary;
+            this.updateAllSensorSummaries();
+        }
+        else if (data.type === 'device_alert') {
+            const sensores = data.sensors && data.sensors.length ? data.sensors.join(', ') : 'sensor desconocido';
+            this.deviceAlerts.push(`🚨 ${data.rtc_datetime}: Anomalía detectada en ${sensores}`);
+            this.deviceAlerts = this.deviceAlerts.slice(-5);
+            this.checkAllAlerts();
+        }
         else if (data.type === 'download_error') {
             this.downloadInProgress = false;
             this.updateDownloadStatus(
@@ -207,6 +225,9 @@ class WaterMonitor {
             this.sessionsHistory = data.sessions;
             this.updateSessionsList();
         }
+        else if (data.type === 'session_data') {
+            this.handleSessionData(data);
+        }
         else if (data.type === 'session_deleted') {
             this.handleSessionDeleted(data);
         }
@@ -285,27 +306,79 @@ class WaterMonitor {
     
     showSessionDetail(sessionIndex) {
         console.log(' showSessionDetail llamado con índice:', sessionIndex);
-        console.log(' Total sesiones:', this.sessionsHistory.length);
-        console.log(' Sesiones disponibles:', this.sessionsHistory);
         
         if (sessionIndex < 0 || sessionIndex >= this.sessionsHistory.length) {
             console.error(' Índice fuera de rango');
             return;
         }
         
-        this.currentSession = this.sessionsHistory[sessionIndex];
-        console.log(' Sesión seleccionada:', this.currentSession);
+        // Las lecturas se piden al abrir la sesión: solo la última página
+        this.currentSession = { ...this.sessionsHistory[sessionIndex], data: null, dataOffset: 0 };
+        this.sessionExport = null;
+        this.sessionRequests.clear();
+        console.log(' Sesión seleccionada:', this.currentSession.session_id);
         
-
-        if (!this.currentSession || !this.currentSession.data) {
-            console.error(' Sesión sin datos');
-            alert('Esta sesión no tiene datos disponibles');
+        document.querySelector('.sessions-list').classList.add('hidden');
+        document.getElementById('session-detail').classList.remove('hidden');
+        
+        this.renderSessionDetail();
+        this.requestSessionPage(
+            Math.max(0, this.currentSession.total_readings - this.sessionPageSize), 
+            this.sessionPageSize,
+            'view'
+        );
+    }
+    
+    requestSessionPage(offset, limit, purpose) {
+        if (this.ws && this.ws.readyState === WebSocket.OPEN && this.currentSession) {
+            const requestId = ++this.sessionRequestSeq;
+            this.sessionRequests.set(requestId, purpose);
+            this.ws.send(JSON.stringify({
+                type: 'request_session_data',
+                request_id: requestId,
+                session_id: this.currentSession.session_id,
+                offset: offset,
+                limit: limit
+            }));
+        }
+    }
+    
+    handleSessionData(data) {
+        // El propósito sale del request_id devuelto, no del estado actual: una página
+        // de la vista aún en vuelo no debe mezclarse con una exportación iniciada después
+        const purpose = this.sessionRequests.get(data.request_id);
+        this.sessionRequests.delete(data.request_id);
+        if (!purpose || !this.currentSession || data.session_id !== this.currentSession.session_id) {
+            return; // Respuesta de una sesión que ya no está abierta
+        }
+        if (data.error) {
+            console.error(' Error cargando sesión:', data.error);
+            if (purpose === 'export') {
+                this.sessionExport = null;
+                document.getElementById('export-session-btn').textContent = '💾 Exportar Sesión';
+            }
+            document.getElementById('session-data-table').innerHTML = 
+                `<p style="color: #e74c3c;">Error cargando lecturas: ${data.error}</p>`;
             return;
         }
         
-        document.querySelector('.sessions-list').classList.add('hidden');
-        document.getElementById('session-detail').classList.remove('hidden');
+        if (purpose === 'export') {
+            if (!this.sessionExport) return;
+            // Exportación: pedir páginas hasta completar la sesión
+            this.sessionExport.push(...data.readings);
+            if (this.sessionExport.length < data.total && data.readings.length > 0) {
+                this.requestSessionPage(this.sessionExport.length, this.sessionExportPageSize, 'export');
+            } else {
+                const readings = this.sessionExport;
+                this.sessionExport = null;
+                this.writeSessionCSV(readings);
+            }
+            return;
+        }
         
+        this.currentSession.data = data.readings;
+        this.currentSession.dataOffset = data.offset;
+        this.currentSession.total_readings = data.total;
         this.renderSessionDetail();
     }
     
@@ -315,7 +388,7 @@ class WaterMonitor {
     }
     
     renderSessionDetail() {
-        if (!this.currentSession || !this.currentSession.data) {
+        if (!this.currentSession) {
             console.error('No hay sesión actual para mostrar');
             return;
         }
@@ -376,8 +449,19 @@ class WaterMonitor {
             </div>
         `;
         
-        const maxRecords = Math.min(200, this.currentSession.data.length);
-        const displayData = [...this.currentSession.data].reverse().slice(0, maxRecords);
+        if (!this.currentSession.data) {
+            sessionDataTable.innerHTML = `
+                <h4>📋 Datos Detallados de la Sesión</h4>
+                <p style="font-style: italic; color: #666;">⏳ Cargando lecturas...</p>
+            `;
+            return;
+        }
+        
+        // data es la última página de la sesión (dataOffset = índice de su primera lectura)
+        const totalReadings = this.currentSession.total_readings;
+        const pageEnd = this.currentSession.dataOffset + this.currentSession.data.length;
+        const maxRecords = this.currentSession.data.length;
+        const displayData = [...this.currentSession.data].reverse();
         
         // Tabla de datos
         const tableHtml = `
@@ -399,7 +483,7 @@ class WaterMonitor {
                     <tbody>
                         ${displayData.map((item, idx) => `
                             <tr>
-                                <td>${item.reading_number || (this.currentSession.data.length - idx)}</td>
+                                <td>${item.reading_number || (pageEnd - idx)}</td>
                                 <td>${this.formatDateTime(item)}</td>
                                 <td>${item.temperature?.toFixed(1) || '-'}</td>
                                 <td>${item.ph > 0 ? item.ph.toFixed(2) : '-'}</td>
@@ -409,10 +493,10 @@ class WaterMonitor {
                                 <td>${item.valid ? 'SI' : 'NO'}</td>
                             </tr>
                         `).join('')}
-                        ${this.currentSession.data.length > maxRecords ? `
+                        ${totalReadings > maxRecords ? `
                             <tr>
                                 <td colspan="8" style="text-align: center; font-style: italic; color: #666; padding: 15px; background: #f8f9fa;">
-                                    📊 Mostrando los últimos ${maxRecords} de ${this.currentSession.data.length} registros totales
+                                    📊 Mostrando los últimos ${maxRecords} de ${totalReadings} registros totales
                                 </td>
                             </tr>
                         ` : ''}
@@ -452,13 +536,27 @@ class WaterMonitor {
     }
 
     exportCurrentSession() {
-        if (!this.currentSession || !this.currentSession.data) {
+        if (!this.currentSession) {
             alert('No hay sesión seleccionada para exportar');
             return;
         }
         
         console.log('🔄 Exportando sesión:', this.currentSession.session_id);
         
+        const data = this.currentSession.data;
+        if (data && this.currentSession.dataOffset === 0 && data.length >= this.currentSession.total_readings) {
+            this.writeSessionCSV(data); // La sesión completa ya está cargada
+            return;
+        }
+        
+        // Pedir todas las páginas; handleSessionData llama a writeSessionCSV al terminar
+        document.getElementById('export-session-btn').textContent = '⏳ Descargando...';
+        if (this.sessionExport) return; // Ya hay una exportación en curso
+        this.sessionExport = [];
+        this.requestSessionPage(0, this.sessionExportPageSize, 'export');
+    }
+    
+    writeSessionCSV(readings) {        
         // Crear contenido CSV
         const headers = [
             'Numero_Lectura',
@@ -478,7 +576,7 @@ class WaterMonitor {
         let csvContent = headers.join(',') + '\n';
         
         // Agregar datos de la sesión
-        this.currentSession.data.forEach(item => {
+        readings.forEach(item => {
             const row = [
                 item.reading_number || '',
                 this.formatDateTimeForCSV(item),
@@ -515,10 +613,9 @@ class WaterMonitor {
             console.log(' Sesión exportada como:', fileName);
             
             // Mostrar mensaje de éxito
-            const originalText = document.getElementById('export-session-btn').textContent;
             document.getElementById('export-session-btn').textContent = 'Exportado';
             setTimeout(() => {
-                document.getElementById('export-session-btn').textContent = originalText;
+                document.getElementById('export-session-btn').textContent = '💾 Exportar Sesión';
             }, 2000);
         } else {
             alert('Tu navegador no soporta la descarga automática de archivos');
@@ -667,7 +764,7 @@ class WaterMonitor {
             row.innerHTML = `
                 <td class="rtc-timestamp">${rtcDateTimeStr}</td>
                 <td>${webTimeStr}</td>
-                <td>#${item.reading_number || '-'}</td>
+                <td>#${item.reading_number || '-'}${item.reconstruida ? ' (sostenida)' : ''}</td>
                 <td>${item.temperature.toFixed(1)}</td>
                 <td>${item.ph > 0 ? item.ph.toFixed(2) : '-'}</td>
                 <td>${item.turbidity >= 0 ? item.turbidity.toFixed(1) : '-'}</td>
@@ -1238,9 +1335,11 @@ class WaterMonitor {
         }
         
         const lastValue = values[values.length - 1];
-        const average = values.reduce((a, b) => a + b, 0) / values.length;
-        const min = Math.min(...values);
-        const max = Math.max(...values);
+        // Promedio y rango del servidor (O(1)); si aún no llegó, se calculan aquí
+        const live = this.liveSummary && this.liveSummary[sensor];
+        const average = live && live.count ? live.avg : values.reduce((a, b) => a + b, 0) / values.length;
+        const min = live && live.count ? live.min : Math.min(...values);
+        const max = live && live.count ? live.max : Math.max(...values);
         
         const precision = sensor === 'tds' ? 0 : (sensor === 'ph' ? 2 : 1);
         
@@ -1281,6 +1380,11 @@ class WaterMonitor {
                 alerts.push(` Lectura #${data.reading_number}: pH fuera de rango (${data.ph.toFixed(2)})`);
             }
             
+            if (data.alarms & 0x0F) {
+                const nombres = ['temperatura', 'TDS', 'turbidez', 'pH'].filter((n, i) => data.alarms & (1 << i));
+                alerts.push(` Lectura #${data.reading_number}: Anomalía en ${nombres.join(', ')}`);
+            }
+            
             if (data.health_score && data.health_score < 70) {
                 alerts.push(` Lectura #${data.reading_number}: Salud del sistema baja (${data.health_score}%)`);
             }
@@ -1292,7 +1396,7 @@ class WaterMonitor {
             }
         });
         
-        this.updateAlerts(alerts.slice(-5));
+        this.updateAlerts(this.deviceAlerts.concat(alerts.slice(-5)).slice(0, 5)); // Alertas del equipo primero
     }
     
     updateAlerts(alerts) {